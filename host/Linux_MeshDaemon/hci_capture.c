@@ -0,0 +1,143 @@
+/*
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+*
+* HCI capture file used to record the traffic of the daemon and to replay it with hci_replay
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "mesh_daemon.h"
+
+static FILE     *capture_fp = NULL;
+static uint64_t  capture_start_us;
+
+static uint64_t hci_capture_now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int hci_capture_start(const char *path)
+{
+    if ((capture_fp = fopen(path, "wb")) == NULL)
+        return 0;
+
+    if (fwrite(HCI_CAPTURE_MAGIC, 1, HCI_CAPTURE_MAGIC_LEN, capture_fp) != HCI_CAPTURE_MAGIC_LEN)
+    {
+        fclose(capture_fp);
+        capture_fp = NULL;
+        return 0;
+    }
+    capture_start_us = hci_capture_now_us();
+    return 1;
+}
+
+void hci_capture_write(uint8_t direction, const uint8_t *p_packet, uint32_t len)
+{
+    uint8_t  header[HCI_CAPTURE_RECORD_HEADER_LEN];
+    uint64_t time_us;
+    int      i;
+
+    if (capture_fp == NULL)
+        return;
+
+    time_us = hci_capture_now_us() - capture_start_us;
+    for (i = 0; i < 8; i++)
+        header[i] = (uint8_t)(time_us >> (8 * i));
+    header[8] = direction;
+    for (i = 0; i < 4; i++)
+        header[9 + i] = (uint8_t)(len >> (8 * i));
+
+    // stdio buffering keeps the capture cheap, the file is flushed when the network is closed
+    if ((fwrite(header, 1, sizeof(header), capture_fp) != sizeof(header)) || (fwrite(p_packet, 1, len, capture_fp) != len))
+    {
+        Log("HCI capture write failed, capture stopped");
+        hci_capture_stop();
+    }
+}
+
+void hci_capture_flush(void)
+{
+    if (capture_fp != NULL)
+        fflush(capture_fp);
+}
+
+void hci_capture_stop(void)
+{
+    if (capture_fp == NULL)
+        return;
+
+    fclose(capture_fp);
+    capture_fp = NULL;
+}
+
+FILE *hci_capture_open(const char *path)
+{
+    char  magic[HCI_CAPTURE_MAGIC_LEN];
+    FILE *fp;
+
+    if ((fp = fopen(path, "rb")) == NULL)
+        return NULL;
+
+    if ((fread(magic, 1, sizeof(magic), fp) != sizeof(magic)) || (memcmp(magic, HCI_CAPTURE_MAGIC, sizeof(magic)) != 0))
+    {
+        fclose(fp);
+        return NULL;
+    }
+    return fp;
+}
+
+int hci_capture_read(FILE *fp, hci_capture_record_t *p_record, uint8_t *p_packet, uint32_t max_len)
+{
+    uint8_t header[HCI_CAPTURE_RECORD_HEADER_LEN];
+    int     i;
+
+    if (fread(header, 1, sizeof(header), fp) != sizeof(header))
+        return 0;
+
+    p_record->time_us = 0;
+    for (i = 7; i >= 0; i--)
+        p_record->time_us = (p_record->time_us << 8) | header[i];
+    p_record->direction = header[8];
+    p_record->len = header[9] | (header[10] << 8) | (header[11] << 16) | ((uint32_t)header[12] << 24);
+
+    if ((p_record->len > max_len) || (fread(p_packet, 1, p_record->len, fp) != p_record->len))
+        return 0;
+    return 1;
+}
@@ -0,0 +1,681 @@
+/*
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+*
+* Check and benchmark of the table driven HCI command encoder of the client library. Every command
+* described by the encoder tables is sent with a fixed request and the bytes passed to the transport are
+* compared with the bytes the hand written serializers sent before, together with the ownership of the mesh
+* event. The tool then times a few commands through the library and through copies of the hand written
+* serializers they replaced.
+*/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "wiced_bt_ble.h"
+#include "wiced_mesh_client.h"
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_mesh_provision.h"
+#include "hci_control_api.h"
+#include "mesh_daemon.h"
+
+#define BENCH_DEFAULT_CYCLES        10000
+#define BENCH_RUNS                  200
+#define BENCH_DST                   0x1234
+#define BENCH_APP_KEY_IDX           0x0123
+#define BENCH_MAX_COMMAND_LEN       64
+
+uint8_t *wiced_bt_mesh_hci_header_from_event(wiced_bt_mesh_event_t *p_event, uint8_t *p_buffer, uint16_t len);
+wiced_bt_mesh_event_t *wiced_bt_mesh_create_event(uint8_t element_idx, uint16_t company_id, uint16_t model_id, uint16_t dst, uint16_t app_key_idx);
+void wiced_bt_mesh_release_event(wiced_bt_mesh_event_t *p_event);
+
+typedef struct
+{
+    const char *name;
+    void      (*send)(wiced_bt_mesh_event_t *p_event, void *p_data);
+    uint16_t    opcode;
+    uint8_t     releases_event;                 /* the API releases the mesh event */
+    uint8_t     len;
+    uint8_t     bytes[BENCH_MAX_COMMAND_LEN];   /* HCI header followed by the fields */
+} bench_command_t;
+
+static uint8_t  bench_request[256];
+static uint8_t  bench_sent[BENCH_MAX_COMMAND_LEN];
+static uint16_t bench_sent_opcode;
+static uint16_t bench_sent_len;
+static int      verbose = 0;
+
+void Log(char *fmt, ...)
+{
+    va_list args;
+
+    if (!verbose)
+        return;
+
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+void ods(char *fmt, ...)
+{
+}
+
+uint8_t wiced_hci_send(uint16_t opcode, uint8_t *p_buffer, uint16_t length)
+{
+    bench_sent_opcode = opcode;
+    bench_sent_len = (length < sizeof(bench_sent)) ? length : sizeof(bench_sent);
+    memcpy(bench_sent, p_buffer, bench_sent_len);
+    return 1;
+}
+
+void wiced_bt_mesh_gatt_client_connection_state_changed(uint16_t conn_id, uint16_t mtu)
+{
+}
+
+void wiced_bt_mesh_remote_provisioning_connection_state_changed(uint16_t conn_id, uint16_t reason)
+{
+}
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// event with every header field set, so that the header bytes are checked too
+static wiced_bt_mesh_event_t *bench_create_event(void)
+{
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_create_event(1, MESH_COMPANY_ID_BT_SIG, 0x1001, BENCH_DST, BENCH_APP_KEY_IDX);
+
+    if (p_event != NULL)
+    {
+        p_event->reply = 1;
+        p_event->send_segmented = 1;
+        p_event->ttl = 5;
+        p_event->retrans_cnt = 2;
+        p_event->retrans_time = 3;
+        p_event->reply_timeout = 4;
+    }
+    return p_event;
+}
+
+static uint32_t bench_events_in_use(void)
+{
+    mesh_client_event_pool_stats_t stats;
+
+    mesh_client_event_pool_stats_get(&stats);
+    return stats.in_use;
+}
+
+/******************************************************
+ *          Commands and the bytes they must produce
+ ******************************************************/
+#define ENCODE_SEND(func, type) \
+    static void send_##func(wiced_bt_mesh_event_t *p_event, void *p_data) { func(p_event, (type *)p_data); }
+#define ENCODE_SEND_NO_PARAMS(func) \
+    static void send_##func(wiced_bt_mesh_event_t *p_event, void *p_data) { func(p_event); }
+
+ENCODE_SEND(wiced_bt_mesh_config_model_publication_set, wiced_bt_mesh_config_model_publication_set_data_t)
+ENCODE_SEND(wiced_bt_mesh_config_network_transmit_params_set, wiced_bt_mesh_config_network_transmit_set_data_t)
+ENCODE_SEND(wiced_bt_mesh_config_default_ttl_set, wiced_bt_mesh_config_default_ttl_set_data_t)
+ENCODE_SEND(wiced_bt_mesh_config_relay_set, wiced_bt_mesh_config_relay_set_data_t)
+ENCODE_SEND(wiced_bt_mesh_config_friend_set, wiced_bt_mesh_config_friend_set_data_t)
+ENCODE_SEND(wiced_bt_mesh_config_gatt_proxy_set, wiced_bt_mesh_config_gatt_proxy_set_data_t)
+ENCODE_SEND(wiced_bt_mesh_config_beacon_set, wiced_bt_mesh_config_beacon_set_data_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_config_node_reset)
+ENCODE_SEND(wiced_bt_mesh_health_attention_set, wiced_bt_mesh_health_attention_set_data_t)
+ENCODE_SEND(wiced_bt_mesh_config_node_identity_set, wiced_bt_mesh_config_node_identity_set_data_t)
+ENCODE_SEND(wiced_bt_mesh_lpn_poll_timeout_get, wiced_bt_mesh_lpn_poll_timeout_get_data_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_provision_scan_capabilities_get)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_provision_scan_get)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_provision_scan_stop)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_onoff_client_send_get)
+ENCODE_SEND(wiced_bt_mesh_model_onoff_client_send_set, wiced_bt_mesh_onoff_set_data_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_battery_client_send_get)
+ENCODE_SEND(wiced_bt_mesh_model_property_client_send_properties_get, wiced_bt_mesh_properties_get_data_t)
+ENCODE_SEND(wiced_bt_mesh_model_property_client_send_property_get, wiced_bt_mesh_property_get_data_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_light_lc_client_send_mode_get)
+ENCODE_SEND(wiced_bt_mesh_model_light_lc_client_send_mode_set, wiced_bt_mesh_light_lc_mode_set_data_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_light_lc_client_send_occupancy_mode_get)
+ENCODE_SEND(wiced_bt_mesh_model_light_lc_client_send_occupancy_mode_set, wiced_bt_mesh_light_lc_occupancy_mode_set_data_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_light_lc_client_send_light_onoff_get)
+ENCODE_SEND(wiced_bt_mesh_model_light_lc_client_send_light_onoff_set, wiced_bt_mesh_light_lc_light_onoff_set_data_t)
+ENCODE_SEND(wiced_bt_mesh_model_light_lc_client_send_property_get, wiced_bt_mesh_light_lc_property_get_data_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_light_xyl_client_send_get)
+ENCODE_SEND(wiced_bt_mesh_model_light_xyl_client_send_set, wiced_bt_mesh_light_xyl_set_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_light_xyl_client_send_target_get)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_light_xyl_client_send_range_get)
+ENCODE_SEND(wiced_bt_mesh_model_light_xyl_client_send_range_set, wiced_bt_mesh_light_xyl_range_set_data_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_light_xyl_client_send_default_get)
+ENCODE_SEND(wiced_bt_mesh_model_light_xyl_client_send_default_set, wiced_bt_mesh_light_xyl_default_data_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_location_client_send_global_get)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_location_client_send_local_get)
+ENCODE_SEND(wiced_bt_mesh_model_location_client_send_global_set, wiced_bt_mesh_location_global_data_t)
+ENCODE_SEND(wiced_bt_mesh_model_location_client_send_local_set, wiced_bt_mesh_location_local_data_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_power_level_client_send_get)
+ENCODE_SEND(wiced_bt_mesh_model_power_level_client_send_set, wiced_bt_mesh_power_level_set_level_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_power_level_client_send_last_get)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_power_level_client_send_default_get)
+ENCODE_SEND(wiced_bt_mesh_model_power_level_client_send_default_set, wiced_bt_mesh_power_default_data_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_power_level_client_send_range_get)
+ENCODE_SEND(wiced_bt_mesh_model_power_level_client_send_range_set, wiced_bt_mesh_power_level_range_set_data_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_power_onoff_client_send_onpowerup_get)
+ENCODE_SEND(wiced_bt_mesh_model_power_onoff_client_send_onpowerup_set, wiced_bt_mesh_power_onoff_data_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_scheduler_client_send_get)
+ENCODE_SEND(wiced_bt_mesh_model_scheduler_client_send_action_get, wiced_bt_mesh_scheduler_action_get_t)
+ENCODE_SEND(wiced_bt_mesh_model_scheduler_client_send_action_set, wiced_bt_mesh_scheduler_action_data_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_time_client_time_get_send)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_time_client_time_zone_get_send)
+ENCODE_SEND(wiced_bt_mesh_model_time_client_time_zone_set_send, wiced_bt_mesh_time_zone_set_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_time_client_tai_utc_delta_get_send)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_time_client_time_role_get_send)
+ENCODE_SEND(wiced_bt_mesh_model_time_client_time_role_set_send, wiced_bt_mesh_time_role_msg_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_level_client_send_get)
+ENCODE_SEND(wiced_bt_mesh_model_level_client_send_set, wiced_bt_mesh_level_set_level_t)
+ENCODE_SEND(wiced_bt_mesh_model_level_client_send_delta_set, wiced_bt_mesh_level_set_delta_t)
+ENCODE_SEND(wiced_bt_mesh_model_level_client_send_move_set, wiced_bt_mesh_level_set_move_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_light_lightness_client_send_get)
+ENCODE_SEND(wiced_bt_mesh_model_light_lightness_client_send_set, wiced_bt_mesh_light_lightness_actual_set_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_light_hsl_client_send_get)
+ENCODE_SEND(wiced_bt_mesh_model_light_hsl_client_send_set, wiced_bt_mesh_light_hsl_set_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_light_hsl_client_send_hue_get)
+ENCODE_SEND(wiced_bt_mesh_model_light_hsl_client_send_hue_set, wiced_bt_mesh_light_hsl_hue_set_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_light_hsl_client_send_saturation_get)
+ENCODE_SEND(wiced_bt_mesh_model_light_hsl_client_send_saturation_set, wiced_bt_mesh_light_hsl_saturation_set_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_light_hsl_client_send_target_get)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_light_hsl_client_send_default_get)
+ENCODE_SEND(wiced_bt_mesh_model_light_hsl_client_send_default_set, wiced_bt_mesh_light_hsl_default_data_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_light_hsl_client_send_range_get)
+ENCODE_SEND(wiced_bt_mesh_model_light_hsl_client_send_range_set, wiced_bt_mesh_light_hsl_range_set_data_t)
+ENCODE_SEND_NO_PARAMS(wiced_bt_mesh_model_light_ctl_client_send_get)
+ENCODE_SEND(wiced_bt_mesh_model_light_ctl_client_send_set, wiced_bt_mesh_light_ctl_set_t)
+ENCODE_SEND(wiced_bt_mesh_model_sensor_client_sensor_setting_send_get, wiced_bt_mesh_sensor_setting_get_data_t)
+ENCODE_SEND(wiced_bt_mesh_model_sensor_client_sensor_settings_send_get, wiced_bt_mesh_sensor_get_t)
+ENCODE_SEND(wiced_bt_mesh_model_sensor_client_sensor_cadence_send_get, wiced_bt_mesh_sensor_get_t)
+ENCODE_SEND(wiced_bt_mesh_model_sensor_client_sensor_cadence_send_set, wiced_bt_mesh_sensor_cadence_set_data_t)
+
+// HCI header of the event made by bench_create_event
+#define ENCODE_HEADER   0x34, 0x12, 0x23, 0x01, 0x01, 0x01, 0x01, 0x05, 0x02, 0x03, 0x04
+
+// The expected bytes are the bytes the hand written serializers sent for the request filled by bench_fill_request,
+// except for light hsl range set which sent the high byte of saturation_min where saturation_max belonged.
+// The private proxy commands are not built on this host.
+#define ENCODE_COMMAND(func, opcode, releases_event, ...) \
+    { #func, send_##func, opcode, releases_event, (uint8_t)sizeof((uint8_t[]){ __VA_ARGS__ }), { __VA_ARGS__ } }
+
+static const bench_command_t bench_commands[] =
+{
+    ENCODE_COMMAND(wiced_bt_mesh_config_model_publication_set, HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_PUBLICATION_SET, 0,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x4b, 0x68, 0x85, 0xa2, 0xbf, 0xdc, 0xf9, 0x16, 0x33, 0x50, 0x6d, 0x8a, 0xa7, 0xc4, 0xe1, 0xfe, 0x1b, 0x38, 0x55, 0x72, 0x8f, 0xac, 0xc9, 0xe6, 0x03, 0x20, 0x3d, 0x5a, 0x77, 0x94, 0xb1),
+    ENCODE_COMMAND(wiced_bt_mesh_config_network_transmit_params_set, HCI_CONTROL_MESH_COMMAND_CONFIG_NETWORK_TRANSMIT_SET, 0,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x4b),
+    ENCODE_COMMAND(wiced_bt_mesh_config_default_ttl_set, HCI_CONTROL_MESH_COMMAND_CONFIG_DEFAULT_TTL_SET, 0,
+                   ENCODE_HEADER,
+                   0x11),
+    ENCODE_COMMAND(wiced_bt_mesh_config_relay_set, HCI_CONTROL_MESH_COMMAND_CONFIG_RELAY_SET, 0,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x4b, 0x68),
+    ENCODE_COMMAND(wiced_bt_mesh_config_friend_set, HCI_CONTROL_MESH_COMMAND_CONFIG_FRIEND_SET, 0,
+                   ENCODE_HEADER,
+                   0x11),
+    ENCODE_COMMAND(wiced_bt_mesh_config_gatt_proxy_set, HCI_CONTROL_MESH_COMMAND_CONFIG_GATT_PROXY_SET, 0,
+                   ENCODE_HEADER,
+                   0x11),
+    ENCODE_COMMAND(wiced_bt_mesh_config_beacon_set, HCI_CONTROL_MESH_COMMAND_CONFIG_BEACON_SET, 0,
+                   ENCODE_HEADER,
+                   0x11),
+    ENCODE_COMMAND(wiced_bt_mesh_config_node_reset, HCI_CONTROL_MESH_COMMAND_CONFIG_NODE_RESET, 0, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_health_attention_set, HCI_CONTROL_MESH_COMMAND_HEALTH_ATTENTION_SET, 1,
+                   ENCODE_HEADER,
+                   0x11),
+    ENCODE_COMMAND(wiced_bt_mesh_config_node_identity_set, HCI_CONTROL_MESH_COMMAND_CONFIG_NODE_IDENTITY_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x4b),
+    ENCODE_COMMAND(wiced_bt_mesh_lpn_poll_timeout_get, HCI_CONTROL_MESH_COMMAND_CONFIG_LPN_POLL_TIMEOUT_GET, 0,
+                   ENCODE_HEADER,
+                   0x11, 0x2e),
+    ENCODE_COMMAND(wiced_bt_mesh_provision_scan_capabilities_get, HCI_CONTROL_MESH_COMMAND_PROVISION_SCAN_CAPABILITIES_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_provision_scan_get, HCI_CONTROL_MESH_COMMAND_PROVISION_SCAN_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_provision_scan_stop, HCI_CONTROL_MESH_COMMAND_PROVISION_SCAN_STOP, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_onoff_client_send_get, HCI_CONTROL_MESH_COMMAND_ONOFF_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_onoff_client_send_set, HCI_CONTROL_MESH_COMMAND_ONOFF_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x85, 0xa2, 0xbf, 0xdc, 0xf9, 0x16),
+    ENCODE_COMMAND(wiced_bt_mesh_battery_client_send_get, HCI_CONTROL_MESH_COMMAND_BATTERY_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_property_client_send_properties_get, HCI_CONTROL_MESH_COMMAND_PROPERTIES_GET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x4b, 0x68),
+    ENCODE_COMMAND(wiced_bt_mesh_model_property_client_send_property_get, HCI_CONTROL_MESH_COMMAND_PROPERTY_GET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x4b, 0x68),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_lc_client_send_mode_get, HCI_CONTROL_MESH_COMMAND_LIGHT_LC_MODE_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_lc_client_send_mode_set, HCI_CONTROL_MESH_COMMAND_LIGHT_LC_MODE_SET, 1,
+                   ENCODE_HEADER,
+                   0x11),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_lc_client_send_occupancy_mode_get, HCI_CONTROL_MESH_COMMAND_LIGHT_LC_OCCUPANCY_MODE_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_lc_client_send_occupancy_mode_set, HCI_CONTROL_MESH_COMMAND_LIGHT_LC_OCCUPANCY_MODE_SET, 1,
+                   ENCODE_HEADER,
+                   0x11),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_lc_client_send_light_onoff_get, HCI_CONTROL_MESH_COMMAND_LIGHT_LC_ONOFF_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_lc_client_send_light_onoff_set, HCI_CONTROL_MESH_COMMAND_LIGHT_LC_ONOFF_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x85, 0xa2, 0xbf, 0xdc, 0xf9, 0x16),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_lc_client_send_property_get, HCI_CONTROL_MESH_COMMAND_LIGHT_LC_PROPERTY_GET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_xyl_client_send_get, HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_xyl_client_send_set, HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x4b, 0x68, 0x85, 0xa2, 0xf9, 0x16, 0x33, 0x50, 0x6d, 0x8a),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_xyl_client_send_target_get, HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_TARGET_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_xyl_client_send_range_get, HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_RANGE_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_xyl_client_send_range_set, HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_RANGE_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x4b, 0x68, 0x85, 0xa2, 0xbf, 0xdc),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_xyl_client_send_default_get, HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_DEFAULT_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_xyl_client_send_default_set, HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_DEFAULT_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x4b, 0x68, 0x85, 0xa2),
+    ENCODE_COMMAND(wiced_bt_mesh_model_location_client_send_global_get, HCI_CONTROL_MESH_COMMAND_LOCATION_GLOBAL_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_location_client_send_local_get, HCI_CONTROL_MESH_COMMAND_LOCATION_LOCAL_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_location_client_send_global_set, HCI_CONTROL_MESH_COMMAND_LOCATION_GLOBAL_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x4b, 0x68, 0x85, 0xa2, 0xbf, 0xdc, 0xf9, 0x16),
+    ENCODE_COMMAND(wiced_bt_mesh_model_location_client_send_local_set, HCI_CONTROL_MESH_COMMAND_LOCATION_LOCAL_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x4b, 0x68, 0x85, 0xa2, 0xbf, 0xdc, 0xf9, 0x16),
+    ENCODE_COMMAND(wiced_bt_mesh_model_power_level_client_send_get, HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_power_level_client_send_set, HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x85, 0xa2, 0xbf, 0xdc, 0xf9, 0x16),
+    ENCODE_COMMAND(wiced_bt_mesh_model_power_level_client_send_last_get, HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_LAST_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_power_level_client_send_default_get, HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_DEFAULT_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_power_level_client_send_default_set, HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_DEFAULT_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e),
+    ENCODE_COMMAND(wiced_bt_mesh_model_power_level_client_send_range_get, HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_RANGE_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_power_level_client_send_range_set, HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_RANGE_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x4b, 0x68),
+    ENCODE_COMMAND(wiced_bt_mesh_model_power_onoff_client_send_onpowerup_get, HCI_CONTROL_MESH_COMMAND_ONPOWERUP_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_power_onoff_client_send_onpowerup_set, HCI_CONTROL_MESH_COMMAND_ONPOWERUP_SET, 1,
+                   ENCODE_HEADER,
+                   0x11),
+    ENCODE_COMMAND(wiced_bt_mesh_model_scheduler_client_send_get, HCI_CONTROL_MESH_COMMAND_SCHEDULER_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_scheduler_client_send_action_get, HCI_CONTROL_MESH_COMMAND_SCHEDULER_ACTION_GET, 1,
+                   ENCODE_HEADER,
+                   0x11),
+    ENCODE_COMMAND(wiced_bt_mesh_model_scheduler_client_send_action_set, HCI_CONTROL_MESH_COMMAND_SCHEDULER_ACTION_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x4b, 0x68, 0x85, 0xa2, 0xbf, 0xdc, 0xf9, 0x16, 0x6d, 0x8a, 0xa7, 0xc4, 0xe1, 0xfe),
+    ENCODE_COMMAND(wiced_bt_mesh_model_time_client_time_get_send, HCI_CONTROL_MESH_COMMAND_TIME_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_time_client_time_zone_get_send, HCI_CONTROL_MESH_COMMAND_TIME_ZONE_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_time_client_time_zone_set_send, HCI_CONTROL_MESH_COMMAND_TIME_ZONE_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0xf9, 0x16, 0x33, 0x50, 0x6d),
+    ENCODE_COMMAND(wiced_bt_mesh_model_time_client_tai_utc_delta_get_send, HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_time_client_time_role_get_send, HCI_CONTROL_MESH_COMMAND_TIME_ROLE_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_time_client_time_role_set_send, HCI_CONTROL_MESH_COMMAND_TIME_ROLE_SET, 1,
+                   ENCODE_HEADER,
+                   0x11),
+    ENCODE_COMMAND(wiced_bt_mesh_model_level_client_send_get, HCI_CONTROL_MESH_COMMAND_LEVEL_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_level_client_send_set, HCI_CONTROL_MESH_COMMAND_LEVEL_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x85, 0xa2, 0xbf, 0xdc, 0xf9, 0x16),
+    ENCODE_COMMAND(wiced_bt_mesh_model_level_client_send_delta_set, HCI_CONTROL_MESH_COMMAND_LEVEL_DELTA_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x4b, 0x68, 0x33, 0x85, 0xa2, 0xbf, 0xdc, 0xf9, 0x16),
+    ENCODE_COMMAND(wiced_bt_mesh_model_level_client_send_move_set, HCI_CONTROL_MESH_COMMAND_LEVEL_MOVE_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x33, 0x85, 0xa2, 0xbf, 0xdc, 0xf9, 0x16),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_lightness_client_send_get, HCI_CONTROL_MESH_COMMAND_LIGHT_LIGHTNESS_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_lightness_client_send_set, HCI_CONTROL_MESH_COMMAND_LIGHT_LIGHTNESS_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x85, 0xa2, 0xbf, 0xdc, 0xf9, 0x16),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_hsl_client_send_get, HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_hsl_client_send_set, HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x4b, 0x68, 0x85, 0xa2, 0xf9, 0x16, 0x33, 0x50, 0x6d, 0x8a),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_hsl_client_send_hue_get, HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_HUE_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_hsl_client_send_hue_set, HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_HUE_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x85, 0xa2, 0xbf, 0xdc, 0xf9, 0x16),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_hsl_client_send_saturation_get, HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_SATURATION_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_hsl_client_send_saturation_set, HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_SATURATION_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x85, 0xa2, 0xbf, 0xdc, 0xf9, 0x16),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_hsl_client_send_target_get, HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_TARGET_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_hsl_client_send_default_get, HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_DEFAULT_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_hsl_client_send_default_set, HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_DEFAULT_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x4b, 0x68, 0x85, 0xa2),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_hsl_client_send_range_get, HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_RANGE_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_hsl_client_send_range_set, HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_RANGE_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x4b, 0x68, 0x85, 0xa2, 0xbf, 0xdc),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_ctl_client_send_get, HCI_CONTROL_MESH_COMMAND_LIGHT_CTL_GET, 1, ENCODE_HEADER),
+    ENCODE_COMMAND(wiced_bt_mesh_model_light_ctl_client_send_set, HCI_CONTROL_MESH_COMMAND_LIGHT_CTL_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x4b, 0x68, 0x85, 0xa2, 0xf9, 0x16, 0x33, 0x50, 0x6d, 0x8a),
+    ENCODE_COMMAND(wiced_bt_mesh_model_sensor_client_sensor_setting_send_get, HCI_CONTROL_MESH_COMMAND_SENSOR_SETTING_GET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x4b, 0x68),
+    ENCODE_COMMAND(wiced_bt_mesh_model_sensor_client_sensor_settings_send_get, HCI_CONTROL_MESH_COMMAND_SENSOR_SETTINGS_GET, 0,
+                   ENCODE_HEADER,
+                   0x11, 0x2e),
+    ENCODE_COMMAND(wiced_bt_mesh_model_sensor_client_sensor_cadence_send_get, HCI_CONTROL_MESH_COMMAND_SENSOR_CADENCE_GET, 0,
+                   ENCODE_HEADER,
+                   0x11, 0x2e),
+    ENCODE_COMMAND(wiced_bt_mesh_model_sensor_client_sensor_cadence_send_set, HCI_CONTROL_MESH_COMMAND_SENSOR_CADENCE_SET, 1,
+                   ENCODE_HEADER,
+                   0x11, 0x2e, 0x4b, 0x85, 0xa2, 0xf9, 0x6d, 0x8a, 0xa7, 0xc4, 0xe1, 0xfe, 0x1b, 0x38, 0x55, 0x72, 0x8f, 0xac, 0xc9, 0xe6, 0x03, 0x20, 0x3d, 0x5a, 0x77, 0x94),
+};
+
+/******************************************************
+ *          Hand written serializers the table replaced
+ ******************************************************/
+static void ref_node_reset(wiced_bt_mesh_event_t *p_event, void *p_request)
+{
+    uint8_t buffer[128];
+    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+
+    if (p == NULL)
+        return;
+
+    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_NODE_RESET, buffer, (uint16_t)(p - buffer));
+}
+
+static void ref_network_transmit_set(wiced_bt_mesh_event_t *p_event, void *p_request)
+{
+    wiced_bt_mesh_config_network_transmit_set_data_t *p_data = (wiced_bt_mesh_config_network_transmit_set_data_t *)p_request;
+    uint8_t buffer[128];
+    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+
+    if (p == NULL)
+        return;
+
+    *p++ = p_data->count;
+    *p++ = p_data->interval & 0xff;
+    *p++ = (p_data->interval >> 8) & 0xff;
+
+    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_NETWORK_TRANSMIT_SET, buffer, (uint16_t)(p - buffer));
+}
+
+static void ref_relay_set(wiced_bt_mesh_event_t *p_event, void *p_request)
+{
+    wiced_bt_mesh_config_relay_set_data_t *p_data = (wiced_bt_mesh_config_relay_set_data_t *)p_request;
+    uint8_t buffer[128];
+    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+
+    if (p == NULL)
+        return;
+
+    *p++ = p_data->state;
+    *p++ = p_data->retransmit_count;
+    *p++ = p_data->retransmit_interval & 0xff;
+    *p++ = (p_data->retransmit_interval >> 8) & 0xff;
+
+    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_RELAY_SET, buffer, (uint16_t)(p - buffer));
+}
+
+static void ref_model_publication_set(wiced_bt_mesh_event_t *p_event, void *p_request)
+{
+    wiced_bt_mesh_config_model_publication_set_data_t *p_set = (wiced_bt_mesh_config_model_publication_set_data_t *)p_request;
+    uint8_t buffer[128];
+    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+
+    if (p == NULL)
+        return;
+
+    *p++ = p_set->element_addr & 0xff;
+    *p++ = (p_set->element_addr >> 8) & 0xff;
+    *p++ = p_set->company_id & 0xff;
+    *p++ = (p_set->company_id >> 8) & 0xff;
+    *p++ = p_set->model_id & 0xff;
+    *p++ = (p_set->model_id >> 8) & 0xff;
+    memcpy(p, p_set->publish_addr, 16);
+    p += 16;
+    *p++ = p_set->app_key_idx & 0xff;
+    *p++ = (p_set->app_key_idx >> 8) & 0xff;
+    *p++ = p_set->credential_flag;
+    *p++ = p_set->publish_ttl;
+    *p++ = p_set->publish_period & 0xff;
+    *p++ = (p_set->publish_period >> 8) & 0xff;
+    *p++ = (p_set->publish_period >> 16) & 0xff;
+    *p++ = (p_set->publish_period >> 24) & 0xff;
+    *p++ = p_set->publish_retransmit_count;
+    *p++ = p_set->publish_retransmit_interval & 0xff;
+    *p++ = (p_set->publish_retransmit_interval >> 8) & 0xff;
+
+    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_PUBLICATION_SET, buffer, (uint16_t)(p - buffer));
+}
+
+static void ref_sensor_settings_get(wiced_bt_mesh_event_t *p_event, void *p_request)
+{
+    wiced_bt_mesh_sensor_get_t *settings_data = (wiced_bt_mesh_sensor_get_t *)p_request;
+    uint8_t buffer[128];
+    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+
+    if (p == NULL)
+        return;
+
+    *p++ = settings_data->property_id & 0xff;
+    *p++ = (settings_data->property_id >> 8) & 0xff;
+
+    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_SENSOR_SETTINGS_GET, buffer, (uint16_t)(p - buffer));
+}
+
+typedef struct
+{
+    const char *name;
+    void      (*send)(wiced_bt_mesh_event_t *p_event, void *p_data);
+    void      (*send_ref)(wiced_bt_mesh_event_t *p_event, void *p_data);
+} bench_pair_t;
+
+// Commands which keep the mesh event, so that one event is used for all and the event pool stays out of the
+// measurement. The first pair has no fields, its time is subtracted from the others to get the time spent on
+// the fields.
+static const bench_pair_t bench_pairs[] =
+{
+    { "node reset",             send_wiced_bt_mesh_config_node_reset,                           ref_node_reset },
+    { "network transmit set",   send_wiced_bt_mesh_config_network_transmit_params_set,          ref_network_transmit_set },
+    { "relay set",              send_wiced_bt_mesh_config_relay_set,                            ref_relay_set },
+    { "model publication set",  send_wiced_bt_mesh_config_model_publication_set,                ref_model_publication_set },
+    { "sensor settings get",    send_wiced_bt_mesh_model_sensor_client_sensor_settings_send_get, ref_sensor_settings_get },
+};
+
+/******************************************************
+ *          Check and benchmark
+ ******************************************************/
+static void bench_fill_request(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < sizeof(bench_request); i++)
+        bench_request[i] = (uint8_t)(0x11 + i * 0x1d);
+}
+
+// Sends every command once, returns number of commands which did not produce the expected bytes
+static int bench_check(int dump)
+{
+    const bench_command_t *p_cmd;
+    wiced_bt_mesh_event_t *p_event;
+    uint32_t               in_use;
+    uint8_t                released;
+    int                    failed = 0;
+    int                    i;
+
+    for (p_cmd = bench_commands; p_cmd < &bench_commands[sizeof(bench_commands) / sizeof(bench_commands[0])]; p_cmd++)
+    {
+        bench_fill_request();
+        bench_sent_opcode = 0;
+        bench_sent_len = 0;
+        in_use = bench_events_in_use();
+        if ((p_event = bench_create_event()) == NULL)
+        {
+            printf("FAIL: no mesh event\n");
+            return 1;
+        }
+        p_cmd->send(p_event, bench_request);
+        released = (bench_events_in_use() == in_use);
+        if (!released)
+            wiced_bt_mesh_release_event(p_event);
+
+        if (dump)
+        {
+            printf("%s opcode:%04x releases:%d len:%d ", p_cmd->name, bench_sent_opcode, released, bench_sent_len);
+            for (i = 0; i < bench_sent_len; i++)
+                printf("%02x", bench_sent[i]);
+            printf("\n");
+            continue;
+        }
+        if ((bench_sent_opcode != p_cmd->opcode) || (released != p_cmd->releases_event) ||
+            (bench_sent_len != p_cmd->len) || (memcmp(bench_sent, p_cmd->bytes, p_cmd->len) != 0))
+        {
+            printf("FAIL: %s opcode:%04x/%04x releases event:%d/%d len:%d/%d\n  sent:    ", p_cmd->name,
+                   bench_sent_opcode, p_cmd->opcode, released, p_cmd->releases_event, bench_sent_len, p_cmd->len);
+            for (i = 0; i < bench_sent_len; i++)
+                printf("%02x", bench_sent[i]);
+            printf("\n  expected:");
+            for (i = 0; i < p_cmd->len; i++)
+                printf("%02x", p_cmd->bytes[i]);
+            printf("\n");
+            failed++;
+        }
+    }
+    return failed;
+}
+
+// Returns the lowest of a few runs of the average time per command
+static double bench_run(void (*send)(wiced_bt_mesh_event_t *p_event, void *p_data), wiced_bt_mesh_event_t *p_event, uint32_t cycles)
+{
+    uint64_t start, elapsed, best = ~0ULL;
+    uint32_t i;
+    int      run;
+
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+        start = bench_now_ns();
+        for (i = 0; i < cycles; i++)
+            send(p_event, bench_request);
+        elapsed = bench_now_ns() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+    return (double)best / cycles;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -n <cycles>     commands sent per measurement (default %d)\n"
+            "  -c              check the encoded bytes only\n"
+            "  -d              print the bytes sent for every command\n"
+            "  -v              trace library logs\n"
+            "  -h              this help\n",
+            prog, BENCH_DEFAULT_CYCLES);
+}
+
+int main(int argc, char **argv)
+{
+    wiced_bt_mesh_event_t *p_event;
+    uint32_t cycles = BENCH_DEFAULT_CYCLES;
+    int      check_only = 0;
+    int      dump = 0;
+    double   ns_table, ns_ref, base_table = 0, base_ref = 0;
+    int      failed, opt, i;
+
+    while ((opt = getopt(argc, argv, "n:cdvh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n': cycles = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'c': check_only = 1; break;
+        case 'd': dump = 1; break;
+        case 'v': verbose = 1; break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (cycles == 0)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    failed = bench_check(dump);
+    if (dump)
+        return 0;
+    if (failed != 0)
+    {
+        printf("check: %d of %d commands failed\n", failed, (int)(sizeof(bench_commands) / sizeof(bench_commands[0])));
+        return 1;
+    }
+    printf("check: %d commands sent the expected bytes\n", (int)(sizeof(bench_commands) / sizeof(bench_commands[0])));
+    if (check_only)
+        return 0;
+
+    bench_fill_request();
+    if ((p_event = bench_create_event()) == NULL)
+        return 1;
+    printf("%u commands per measurement, ns per command (fields only)\n", cycles);
+    for (i = 0; i < (int)(sizeof(bench_pairs) / sizeof(bench_pairs[0])); i++)
+    {
+        ns_table = bench_run(bench_pairs[i].send, p_event, cycles);
+        ns_ref   = bench_run(bench_pairs[i].send_ref, p_event, cycles);
+        if (i == 0)
+        {
+            base_table = ns_table;
+            base_ref   = ns_ref;
+        }
+        printf("  %-22s  table %6.1f (%5.1f)  hand written %6.1f (%5.1f)\n", bench_pairs[i].name,
+               ns_table, ns_table - base_table, ns_ref, ns_ref - base_ref);
+    }
+    wiced_bt_mesh_release_event(p_event);
+    return 0;
+}
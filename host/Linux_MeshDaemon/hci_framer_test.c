@@ -0,0 +1,479 @@
+/*
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+*
+* Replay test of the HCI packet framer in mesh_client_lib/hci_framer.c, used by the daemon and the serial
+* readers of the Qt and Windows client controls. A stream of random event, ACL and WICED packets, or the packets
+* received from the device in a capture recorded by mesh_daemon -r, is written to a temporary file and fed to
+* the framer through a port that reads 1, 7 or 64 bytes of the file per system call, or everything the reader
+* asks for. Every packet must come out intact, and the tool reports the port reads and the time per packet
+* next to the reader which read the type, the header and the payload of every packet separately. The tool also
+* checks that a packet longer than the buffer is truncated but consumed, and that a payload over the limit is
+* reported as a bad packet.
+*/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <getopt.h>
+#include <unistd.h>
+
+#include "hci_control_api.h"
+#include "hci_framer.h"
+#include "mesh_daemon.h"
+
+#define FRAMER_DEFAULT_PACKETS      20000
+#define FRAMER_MAX_PAYLOAD          1024
+
+// same ring as the Qt reader, a power of 2 that holds the largest packet accepted (5 + 1024)
+#define FRAMER_RING_SIZE            4096
+
+typedef uint8_t  BYTE;
+typedef uint32_t DWORD;
+
+typedef struct
+{
+    uint32_t offset;        /* position of the packet in the stream */
+    uint16_t len;           /* packet type, header and payload */
+} framer_packet_t;
+
+static uint8_t         *framer_stream;
+static uint32_t         framer_stream_len;
+static framer_packet_t *framer_packets;
+static uint32_t         framer_num_packets;
+static uint64_t         framer_random_state = 0x853c49e6748fea9bULL;
+
+// simulated port, returns up to port_read_size bytes of the stream file per read, 0 for as many as asked
+static int              port_fd = -1;
+static uint32_t         port_pos;
+static uint32_t         port_read_size;
+static uint64_t         port_reads;
+
+// receive ring of the reader
+static uint8_t          framer_ring[FRAMER_RING_SIZE];
+static hci_framer_t     framer;
+
+void Log(char *fmt, ...)
+{
+    va_list args;
+
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+static uint64_t framer_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint32_t framer_random(void)
+{
+    framer_random_state ^= framer_random_state >> 12;
+    framer_random_state ^= framer_random_state << 25;
+    framer_random_state ^= framer_random_state >> 27;
+    return (uint32_t)((framer_random_state * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+static int framer_add_packet(const uint8_t *p_packet, uint32_t len)
+{
+    static uint32_t stream_size = 0, packets_size = 0;
+
+    if (framer_stream_len + len > stream_size)
+    {
+        stream_size = (stream_size == 0) ? 0x100000 : 2 * stream_size;
+        while (stream_size < framer_stream_len + len)
+            stream_size *= 2;
+        if ((framer_stream = realloc(framer_stream, stream_size)) == NULL)
+            return 0;
+    }
+    if (framer_num_packets == packets_size)
+    {
+        packets_size = (packets_size == 0) ? 0x10000 : 2 * packets_size;
+        if ((framer_packets = realloc(framer_packets, packets_size * sizeof(framer_packet_t))) == NULL)
+            return 0;
+    }
+    framer_packets[framer_num_packets].offset = framer_stream_len;
+    framer_packets[framer_num_packets].len = (uint16_t)len;
+    framer_num_packets++;
+
+    memcpy(&framer_stream[framer_stream_len], p_packet, len);
+    framer_stream_len += len;
+    return 1;
+}
+
+// Mostly short WICED packets with mesh events, some HCI events and ACL data of all sizes
+static int framer_generate(uint32_t num_packets)
+{
+    uint8_t  packet[5 + FRAMER_MAX_PAYLOAD];
+    uint32_t i, j, len, offset;
+
+    for (i = 0; i < num_packets; i++)
+    {
+        len = (framer_random() % 8 == 0) ? framer_random() % (FRAMER_MAX_PAYLOAD + 1) : framer_random() % 64;
+        switch (framer_random() % 4)
+        {
+        case 0:
+            len &= 0xff;
+            packet[0] = HCI_EVENT_PKT;
+            packet[1] = (uint8_t)framer_random();
+            packet[2] = (uint8_t)len;
+            offset = 3;
+            break;
+
+        case 1:
+            packet[0] = HCI_ACL_DATA_PKT;
+            offset = 5;
+            break;
+
+        default:
+            packet[0] = HCI_WICED_PKT;
+            offset = 5;
+            break;
+        }
+        if (offset == 5)
+        {
+            packet[1] = (uint8_t)framer_random();
+            packet[2] = (uint8_t)framer_random();
+            packet[3] = (uint8_t)len;
+            packet[4] = (uint8_t)(len >> 8);
+        }
+        for (j = 0; j < len; j++)
+            packet[offset + j] = (uint8_t)framer_random();
+
+        if (!framer_add_packet(packet, offset + len))
+            return 0;
+    }
+    return 1;
+}
+
+// Packets received from the device in the capture, the capture stores them with the packet type
+static int framer_load_capture(const char *path)
+{
+    static uint8_t       packet[5 + 0xffff];
+    hci_capture_record_t record;
+    FILE                *fp;
+
+    if ((fp = hci_capture_open(path)) == NULL)
+    {
+        fprintf(stderr, "cannot open capture %s\n", path);
+        return 0;
+    }
+    while (hci_capture_read(fp, &record, packet, sizeof(packet)))
+    {
+        if ((record.direction == HCI_CAPTURE_DIR_DEVICE_TO_HOST) && (record.len != 0) && !framer_add_packet(packet, record.len))
+        {
+            fclose(fp);
+            return 0;
+        }
+    }
+    fclose(fp);
+    return 1;
+}
+
+static void port_reset(uint32_t read_size)
+{
+    port_pos = 0;
+    port_read_size = read_size;
+    port_reads = 0;
+    hci_framer_init(&framer, framer_ring, sizeof(framer_ring), FRAMER_MAX_PAYLOAD);
+}
+
+// Worker::ReadPortAvailable, returns what the port has, 0 at the end of the stream
+static DWORD ReadPortAvailable(BYTE *lpBytes, DWORD dwMax)
+{
+    DWORD len = framer_stream_len - port_pos;
+
+    if (len > dwMax)
+        len = dwMax;
+    if ((port_read_size != 0) && (len > port_read_size))
+        len = port_read_size;
+    if ((len == 0) || (pread(port_fd, lpBytes, len, port_pos) != (ssize_t)len))
+        return 0;
+
+    port_pos += len;
+    port_reads++;
+    return len;
+}
+
+// Worker::ReadPort, reads exactly dwLen bytes
+static DWORD ReadPort(BYTE *lpBytes, DWORD dwLen)
+{
+    DWORD total = 0, len;
+
+    while (total < dwLen)
+    {
+        if ((len = ReadPortAvailable(lpBytes + total, dwLen - total)) == 0)
+            break;
+        total += len;
+    }
+    return total;
+}
+
+/******************************************************
+ *          Reader with the ring
+ ******************************************************/
+// Worker::ReadNewHciPacket, serves packets already in the ring, goes to the port only when the next one is incomplete
+static DWORD ReadNewHciPacket(BYTE * pu8Buffer, int bufLen, int * pOffset)
+{
+    uint32_t offset = 0, len = 0, space;
+    uint8_t *p_space;
+    DWORD    dwLen;
+    int      framed;
+
+    while ((framed = hci_framer_frame(&framer, pu8Buffer, (uint32_t)bufLen, &offset, &len)) == HCI_FRAMER_INCOMPLETE)
+    {
+        p_space = hci_framer_space(&framer, &space);
+        if ((dwLen = ReadPortAvailable(p_space, space)) == 0)
+            return (-1);
+        hci_framer_commit(&framer, dwLen);
+    }
+    if (framed != HCI_FRAMER_PACKET)
+        return (-1);
+
+    *pOffset = (int)offset;
+    return len;
+}
+
+/******************************************************
+ *          Reader before the ring
+ ******************************************************/
+// Reads the type, the header and the payload of the packet with separate reads
+static DWORD ReadNewHciPacketUnbuffered(BYTE * pu8Buffer, int bufLen, int * pOffset)
+{
+    DWORD len = 0;
+
+    if (ReadPort(pu8Buffer, 1) != 1)
+        return (-1);
+
+    switch (pu8Buffer[0])
+    {
+    case HCI_EVENT_PKT:
+        if (ReadPort(&pu8Buffer[1], 2) != 2)
+            return (-1);
+        len = pu8Buffer[2];
+        *pOffset = 3;
+        break;
+
+    case HCI_ACL_DATA_PKT:
+    case HCI_WICED_PKT:
+        if (ReadPort(&pu8Buffer[1], 4) != 4)
+            return (-1);
+        len = pu8Buffer[3] | (pu8Buffer[4] << 8);
+        *pOffset = 5;
+        break;
+
+    default:
+        *pOffset = 1;
+        return 0;
+    }
+
+    if ((len > FRAMER_MAX_PAYLOAD) || ((int)(*pOffset + len) > bufLen))
+        return (-1);
+
+    if ((len != 0) && (ReadPort(&pu8Buffer[*pOffset], len) != len))
+        return (-1);
+
+    return len;
+}
+
+/******************************************************
+ *          Check and benchmark
+ ******************************************************/
+// A packet in two parts and longer than the buffer, followed by an event, then a payload over the limit
+static int framer_check_edges(void)
+{
+    static const uint8_t event[] = { HCI_EVENT_PKT, 0x0e, 0x01, 0x55 };
+    static const uint8_t bad[]   = { HCI_ACL_DATA_PKT, 0x01, 0x00, 0x01, 0x04 };
+    uint8_t  packet[5 + 100], buffer[20];
+    uint8_t *p_space;
+    uint32_t space, offset, len, i;
+
+    packet[0] = HCI_WICED_PKT;
+    packet[1] = 0x01;
+    packet[2] = 0x2f;
+    packet[3] = 100;
+    packet[4] = 0;
+    for (i = 5; i < sizeof(packet); i++)
+        packet[i] = (uint8_t)i;
+
+    hci_framer_init(&framer, framer_ring, sizeof(framer_ring), FRAMER_MAX_PAYLOAD);
+    p_space = hci_framer_space(&framer, &space);
+    memcpy(p_space, packet, 50);
+    hci_framer_commit(&framer, 50);
+    if (hci_framer_frame(&framer, buffer, sizeof(buffer), &offset, &len) != HCI_FRAMER_INCOMPLETE)
+    {
+        printf("FAIL: partial packet framed\n");
+        return 0;
+    }
+    p_space = hci_framer_space(&framer, &space);
+    memcpy(p_space, &packet[50], sizeof(packet) - 50);
+    memcpy(p_space + sizeof(packet) - 50, event, sizeof(event));
+    hci_framer_commit(&framer, sizeof(packet) - 50 + sizeof(event));
+    if ((hci_framer_frame(&framer, buffer, sizeof(buffer), &offset, &len) != HCI_FRAMER_PACKET) ||
+        (offset != 5) || (len != 100) || (memcmp(buffer, packet, sizeof(buffer)) != 0))
+    {
+        printf("FAIL: packet longer than the buffer not truncated\n");
+        return 0;
+    }
+    if ((hci_framer_frame(&framer, buffer, sizeof(buffer), &offset, &len) != HCI_FRAMER_PACKET) ||
+        (offset != 3) || (len != 1) || (memcmp(buffer, event, sizeof(event)) != 0))
+    {
+        printf("FAIL: packet after the truncated packet not framed\n");
+        return 0;
+    }
+    p_space = hci_framer_space(&framer, &space);
+    memcpy(p_space, bad, sizeof(bad));
+    hci_framer_commit(&framer, sizeof(bad));
+    if (hci_framer_frame(&framer, buffer, sizeof(buffer), &offset, &len) != HCI_FRAMER_BAD_PACKET)
+    {
+        printf("FAIL: payload over the limit not reported\n");
+        return 0;
+    }
+    return 1;
+}
+
+// Reads the stream with the reader, returns the time in ns or 0 if a packet was not received intact
+static uint64_t framer_run(DWORD (*read_packet)(BYTE *, int, int *), uint32_t read_size, const char *name)
+{
+    BYTE     buffer[FRAMER_MAX_PAYLOAD + 6];
+    uint64_t start;
+    uint32_t i;
+    DWORD    len;
+    int      offset;
+
+    port_reset(read_size);
+    start = framer_now_ns();
+    for (i = 0; i < framer_num_packets; i++)
+    {
+        offset = 0;
+        len = read_packet(buffer, sizeof(buffer), &offset);
+        if ((len == (DWORD)-1) || (offset + len != framer_packets[i].len) ||
+            (memcmp(buffer, &framer_stream[framer_packets[i].offset], offset + len) != 0))
+        {
+            printf("FAIL: %s reads of %u bytes, packet %u at offset %u not received intact\n",
+                   name, read_size, i, framer_packets[i].offset);
+            return 0;
+        }
+    }
+    if (port_pos != framer_stream_len)
+    {
+        printf("FAIL: %s reads of %u bytes, %u bytes left after the last packet\n", name, read_size, framer_stream_len - port_pos);
+        return 0;
+    }
+    return framer_now_ns() - start + 1;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options] [capture file]\n"
+            "  -n <packets>    random packets if no capture is given (default %d)\n"
+            "  -s <seed>       random seed\n"
+            "  -h              this help\n",
+            prog, FRAMER_DEFAULT_PACKETS);
+}
+
+int main(int argc, char **argv)
+{
+    static const uint32_t read_sizes[] = { 1, 7, 64, 0 };
+    uint32_t num_packets = FRAMER_DEFAULT_PACKETS;
+    uint64_t ns_ring, ns_unbuffered, reads_ring, reads_unbuffered;
+    char     size_name[16];
+    FILE    *fp;
+    int      opt, i;
+
+    while ((opt = getopt(argc, argv, "n:s:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n': num_packets = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 's': framer_random_state = strtoull(optarg, NULL, 0) | 1; break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (optind < argc ? !framer_load_capture(argv[optind]) : ((num_packets == 0) || !framer_generate(num_packets)))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+    if (framer_num_packets == 0)
+    {
+        fprintf(stderr, "no packets received from the device in the capture\n");
+        return 1;
+    }
+    if ((fp = tmpfile()) == NULL || (fwrite(framer_stream, 1, framer_stream_len, fp) != framer_stream_len) || (fflush(fp) != 0))
+    {
+        fprintf(stderr, "cannot write the stream file\n");
+        return 1;
+    }
+    port_fd = fileno(fp);
+
+    if (!framer_check_edges())
+        return 1;
+
+    printf("%u packets, %u bytes\n", framer_num_packets, framer_stream_len);
+    printf("  read size        ring reads    ns/packet   unbuffered reads    ns/packet\n");
+    for (i = 0; i < (int)(sizeof(read_sizes) / sizeof(read_sizes[0])); i++)
+    {
+        if ((ns_ring = framer_run(ReadNewHciPacket, read_sizes[i], "ring")) == 0)
+            return 1;
+        reads_ring = port_reads;
+        if ((ns_unbuffered = framer_run(ReadNewHciPacketUnbuffered, read_sizes[i], "unbuffered")) == 0)
+            return 1;
+        reads_unbuffered = port_reads;
+
+        if (read_sizes[i] != 0)
+            snprintf(size_name, sizeof(size_name), "%u", read_sizes[i]);
+        else
+            snprintf(size_name, sizeof(size_name), "bulk");
+        printf("  %-10s %16llu %12.1f %18llu %12.1f\n", size_name,
+               (unsigned long long)reads_ring, (double)ns_ring / framer_num_packets,
+               (unsigned long long)reads_unbuffered, (double)ns_unbuffered / framer_num_packets);
+    }
+    printf("check: every packet received intact\n");
+    fclose(fp);
+    return 0;
+}
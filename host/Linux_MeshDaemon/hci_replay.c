@@ -0,0 +1,356 @@
+/*
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+*
+* Offline replay of an HCI capture recorded by mesh_daemon -r. Events received from the device are fed
+* through wiced_hci_process_data, either at the recorded speed or as fast as possible, and the tool reports
+* the event rate, CPU time and number of allocations per event opcode. Commands the library sends while
+* processing the events are counted and dropped. If the capture was taken with an open network, a copy of
+* the network database taken before the capture should be in the current directory and opened with -n.
+*/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+
+#include "wiced_bt_ble.h"
+#include "wiced_timer.h"
+#include "wiced_mesh_client.h"
+#include "hci_control_api.h"
+#include "mesh_daemon.h"
+
+#define REPLAY_DEFAULT_PROVISIONER  "mesh_daemon"
+#define REPLAY_DEFAULT_UUID         "00000000000000000000000000000000"
+
+extern void wiced_hci_process_data(uint16_t opcode, uint8_t *p_buffer, uint16_t len);
+
+typedef struct
+{
+    uint32_t count;
+    uint64_t bytes;
+    uint64_t cpu_ns;
+    uint64_t max_cpu_ns;
+    uint64_t allocs;
+} replay_opcode_stats_t;
+
+static replay_opcode_stats_t replay_stats[0x10000];
+static uint8_t               replay_packet[5 + 0xffff];
+static int                   verbose = 0;
+static int                   timer_fd = -1;
+
+// allocations are counted through the linker --wrap option
+static uint64_t              replay_allocs = 0;
+static uint64_t              replay_alloc_bytes = 0;
+static uint64_t              replay_frees = 0;
+static uint64_t              replay_commands = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t num, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+void *__wrap_malloc(size_t size)
+{
+    replay_allocs++;
+    replay_alloc_bytes += size;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t num, size_t size)
+{
+    replay_allocs++;
+    replay_alloc_bytes += num * size;
+    return __real_calloc(num, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    replay_allocs++;
+    replay_alloc_bytes += size;
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void *ptr)
+{
+    if (ptr != NULL)
+        replay_frees++;
+    __real_free(ptr);
+}
+
+static void replay_trace(const char *fmt, va_list args)
+{
+    vfprintf(stderr, fmt, args);
+    if ((fmt[0] == 0) || (fmt[strlen(fmt) - 1] != '\n'))
+        fputc('\n', stderr);
+}
+
+void Log(char *fmt, ...)
+{
+    va_list args;
+
+    if (!verbose)
+        return;
+
+    va_start(args, fmt);
+    replay_trace(fmt, args);
+    va_end(args);
+}
+
+void ods(char *fmt, ...)
+{
+    va_list args;
+
+    if (verbose < 2)
+        return;
+
+    va_start(args, fmt);
+    replay_trace(fmt, args);
+    va_end(args);
+}
+
+uint8_t wiced_hci_send(uint16_t opcode, uint8_t *p_buffer, uint16_t length)
+{
+    replay_commands++;
+    return 1;
+}
+
+void wiced_bt_mesh_gatt_client_connection_state_changed(uint16_t conn_id, uint16_t mtu)
+{
+}
+
+void wiced_bt_mesh_remote_provisioning_connection_state_changed(uint16_t conn_id, uint16_t reason)
+{
+}
+
+static void network_opened(uint8_t status)
+{
+    Log("network opened status:%d", status);
+}
+
+static mesh_client_init_t replay_init_callbacks;
+
+static uint64_t replay_time_ns(clockid_t clock)
+{
+    struct timespec ts;
+
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Execute the library timers that expire before the deadline, or only those already expired if timeout_ms is 0
+static void replay_wait(int timeout_ms)
+{
+    struct pollfd pfd;
+    uint64_t      deadline = linux_timer_now_ms() + timeout_ms;
+    int           remaining = timeout_ms;
+
+    pfd.fd     = timer_fd;
+    pfd.events = POLLIN;
+    do
+    {
+        if (poll(&pfd, 1, remaining) > 0)
+            linux_timer_process();
+        remaining = (int)(deadline - linux_timer_now_ms());
+    } while (remaining > 0);
+}
+
+static void replay_event(uint8_t *p_packet, uint32_t len)
+{
+    replay_opcode_stats_t *p_stats;
+    uint16_t               opcode, data_len;
+    uint64_t               start_ns, cpu_ns, allocs;
+
+    if ((len < 5) || (p_packet[0] != HCI_WICED_PKT))
+        return;
+
+    opcode   = p_packet[1] | (p_packet[2] << 8);
+    data_len = p_packet[3] | (p_packet[4] << 8);
+    if ((opcode == HCI_CONTROL_EVENT_WICED_TRACE) || (opcode == HCI_CONTROL_EVENT_HCI_TRACE) || (data_len > len - 5))
+        return;
+
+    p_stats  = &replay_stats[opcode];
+    allocs   = replay_allocs;
+    start_ns = replay_time_ns(CLOCK_THREAD_CPUTIME_ID);
+
+    wiced_hci_process_data(opcode, &p_packet[5], data_len);
+
+    cpu_ns = replay_time_ns(CLOCK_THREAD_CPUTIME_ID) - start_ns;
+    p_stats->count++;
+    p_stats->bytes  += data_len;
+    p_stats->cpu_ns += cpu_ns;
+    p_stats->allocs += replay_allocs - allocs;
+    if (cpu_ns > p_stats->max_cpu_ns)
+        p_stats->max_cpu_ns = cpu_ns;
+}
+
+static void replay_report(uint64_t records, uint64_t recorded_commands, uint64_t elapsed_ns, uint64_t cpu_ns)
+{
+    replay_opcode_stats_t *p_stats;
+    uint64_t               events = 0;
+    int                    opcode;
+
+    for (opcode = 0; opcode < 0x10000; opcode++)
+        events += replay_stats[opcode].count;
+
+    printf("records:%llu events:%llu recorded commands:%llu commands sent by the library:%llu\n",
+           (unsigned long long)records, (unsigned long long)events, (unsigned long long)recorded_commands, (unsigned long long)replay_commands);
+    printf("elapsed:%.3f s cpu:%.3f s events/s:%.0f\n", elapsed_ns / 1e9, cpu_ns / 1e9,
+           (elapsed_ns != 0) ? events * 1e9 / elapsed_ns : 0.0);
+    printf("allocations:%llu bytes:%llu frees:%llu\n",
+           (unsigned long long)replay_allocs, (unsigned long long)replay_alloc_bytes, (unsigned long long)replay_frees);
+
+    printf("%-8s %10s %12s %12s %10s %10s %12s\n", "opcode", "count", "bytes", "cpu_us", "avg_ns", "max_ns", "allocs");
+    for (opcode = 0; opcode < 0x10000; opcode++)
+    {
+        p_stats = &replay_stats[opcode];
+        if (p_stats->count == 0)
+            continue;
+        printf("0x%04x   %10u %12llu %12llu %10llu %10llu %12llu\n", opcode, p_stats->count, (unsigned long long)p_stats->bytes,
+               (unsigned long long)(p_stats->cpu_ns / 1000), (unsigned long long)(p_stats->cpu_ns / p_stats->count),
+               (unsigned long long)p_stats->max_cpu_ns, (unsigned long long)p_stats->allocs);
+    }
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [options] <capture file>\n"
+                    "  -f              replay as fast as possible instead of the recorded speed\n"
+                    "  -i <count>      replay the capture count times, default 1\n"
+                    "  -n <mesh name>  open the network from the current directory before the replay\n"
+                    "  -p <name>       provisioner name, default %s\n"
+                    "  -u <uuid>       provisioner UUID, 32 hex digits\n"
+                    "  -v              library traces, twice for verbose traces\n",
+            prog, REPLAY_DEFAULT_PROVISIONER);
+}
+
+int main(int argc, char **argv)
+{
+    hci_capture_record_t record;
+    FILE                *fp;
+    const char          *mesh_name = NULL;
+    const char          *provisioner_name = REPLAY_DEFAULT_PROVISIONER;
+    char                 provisioner_uuid[33] = REPLAY_DEFAULT_UUID;
+    uint64_t             records = 0, recorded_commands = 0;
+    uint64_t             start_ns, start_cpu_ns, now_ns;
+    int                  fast = 0, iterations = 1, iteration, opt;
+
+    while ((opt = getopt(argc, argv, "fi:n:p:u:vh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'f': fast = 1;                         break;
+        case 'i': iterations = atoi(optarg);        break;
+        case 'n': mesh_name = optarg;               break;
+        case 'p': provisioner_name = optarg;        break;
+        case 'u':
+            if (strlen(optarg) != 32)
+            {
+                fprintf(stderr, "UUID shall be 32 hex digits\n");
+                return 1;
+            }
+            strcpy(provisioner_uuid, optarg);
+            break;
+        case 'v': verbose++;                        break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if ((optind != argc - 1) || (iterations < 1))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+    if ((timer_fd = linux_timer_init()) < 0)
+        return 1;
+
+    mesh_client_init(&replay_init_callbacks);
+
+    if (mesh_name != NULL)
+    {
+        if (mesh_client_network_open(provisioner_name, provisioner_uuid, (char *)mesh_name, network_opened) != MESH_CLIENT_SUCCESS)
+        {
+            fprintf(stderr, "Failed to open network %s\n", mesh_name);
+            return 1;
+        }
+        replay_wait(0);
+    }
+
+    // statistics only cover the replay
+    replay_allocs = replay_alloc_bytes = replay_frees = replay_commands = 0;
+    start_cpu_ns = replay_time_ns(CLOCK_PROCESS_CPUTIME_ID);
+    start_ns = replay_time_ns(CLOCK_MONOTONIC);
+
+    for (iteration = 0; iteration < iterations; iteration++)
+    {
+        uint64_t iteration_start_ns = replay_time_ns(CLOCK_MONOTONIC);
+
+        if ((fp = hci_capture_open(argv[optind])) == NULL)
+        {
+            fprintf(stderr, "%s is not an HCI capture\n", argv[optind]);
+            return 1;
+        }
+        while (hci_capture_read(fp, &record, replay_packet, sizeof(replay_packet)))
+        {
+            records++;
+            if (fast)
+            {
+                replay_wait(0);
+            }
+            else
+            {
+                now_ns = replay_time_ns(CLOCK_MONOTONIC) - iteration_start_ns;
+                replay_wait((record.time_us * 1000 > now_ns) ? (int)((record.time_us * 1000 - now_ns) / 1000000) : 0);
+            }
+            if (record.direction == HCI_CAPTURE_DIR_DEVICE_TO_HOST)
+                replay_event(replay_packet, record.len);
+            else
+                recorded_commands++;
+        }
+        fclose(fp);
+    }
+    now_ns = replay_time_ns(CLOCK_MONOTONIC);
+    replay_report(records, recorded_commands, now_ns - start_ns, replay_time_ns(CLOCK_PROCESS_CPUTIME_ID) - start_cpu_ns);
+
+    if (mesh_name != NULL)
+        mesh_client_network_close();
+    return 0;
+}
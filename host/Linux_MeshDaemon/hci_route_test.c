@@ -0,0 +1,356 @@
+/*
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+*
+* Test of the HCI transport selection of the client library. Two additional transports are added and get
+* device addresses the way the library configures them when the network is opened. The test checks which
+* transport every command is sent over: the configuration of a transport's own device, the commands pinned
+* while the device is set up, model commands spread between idle transports and routed by the RSSI of the
+* node, and the route dropped on a failed transmission. It also checks how the SEQ Changed events of the
+* additional transports are mapped to the addresses of their devices before they are stored. The tool is
+* linked with mesh_provision_process_event wrapped, so the events the library reports are seen by the test.
+* The tool exits with 1 if any check fails.
+*/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <getopt.h>
+
+#include "wiced_bt_ble.h"
+#include "wiced_mesh_client.h"
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_mesh_provision.h"
+#include "wiced_bt_mesh_core.h"
+#include "hci_control_api.h"
+#include "mesh_daemon.h"
+
+#define ROUTE_ADDR_0        0x0001      /* device of the first transport */
+#define ROUTE_ADDR_1        0x0010
+#define ROUTE_ADDR_2        0x0020
+#define ROUTE_NODE          0x0100
+#define ROUTE_OTHER_NODE    0x0200
+#define ROUTE_GROUP         0xC000
+
+wiced_bt_mesh_event_t *wiced_bt_mesh_create_event(uint8_t element_idx, uint16_t company_id, uint16_t model_id, uint16_t dst, uint16_t app_key_idx);
+void wiced_bt_mesh_release_event(wiced_bt_mesh_event_t *p_event);
+wiced_bool_t wiced_bt_mesh_core_set_seq(uint16_t addr, uint32_t seq, wiced_bool_t prev_iv_idx);
+void mesh_hci_transport_local_addr_set(uint8_t transport, uint16_t addr);
+void mesh_hci_transport_pin(int transport);
+void __real_mesh_provision_process_event(uint16_t event, wiced_bt_mesh_event_t *p_event, void *p_data);
+
+static int      route_last_transport = -1;  /* transport of the last command sent */
+static uint16_t route_last_opcode;
+static int      route_seq_events = 0;
+static uint16_t route_seq_addr;
+static uint32_t route_seq;
+static int      route_failed = 0;
+static int      verbose = 0;
+
+void Log(char *fmt, ...)
+{
+    va_list args;
+
+    if (!verbose)
+        return;
+
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+void ods(char *fmt, ...)
+{
+}
+
+uint8_t wiced_hci_send(uint16_t opcode, uint8_t *p_buffer, uint16_t length)
+{
+    route_last_transport = 0;
+    route_last_opcode = opcode;
+    return 1;
+}
+
+static uint8_t route_transport_send(uint8_t transport, uint16_t opcode, uint8_t *p_data, uint16_t len)
+{
+    route_last_transport = transport;
+    route_last_opcode = opcode;
+    return 1;
+}
+
+void wiced_bt_mesh_gatt_client_connection_state_changed(uint16_t conn_id, uint16_t mtu)
+{
+}
+
+void wiced_bt_mesh_remote_provisioning_connection_state_changed(uint16_t conn_id, uint16_t reason)
+{
+}
+
+// the library has no network open, keep the SEQ Changed events and release the rest
+void __wrap_mesh_provision_process_event(uint16_t event, wiced_bt_mesh_event_t *p_event, void *p_data)
+{
+    wiced_bt_mesh_core_state_seq_t *p_seq = (wiced_bt_mesh_core_state_seq_t *)p_data;
+
+    if (event == WICED_BT_MESH_SEQ_CHANGED)
+    {
+        route_seq_events++;
+        route_seq_addr = p_seq->addr;
+        route_seq = p_seq->seq;
+        return;
+    }
+    if (p_event != NULL)
+        wiced_bt_mesh_release_event(p_event);
+}
+
+static void route_check(const char *what, int value, int expected)
+{
+    if (value == expected)
+    {
+        if (verbose)
+            printf("  %-52s %d\n", what, value);
+        return;
+    }
+    printf("FAIL: %s is %d, expected %d\n", what, value, expected);
+    route_failed++;
+}
+
+// transport the OnOff Get to dst is sent over
+static int route_onoff_get(uint16_t dst)
+{
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_GENERIC_ONOFF_CLNT, dst, 0);
+
+    route_last_transport = -1;
+    if (p_event != NULL)
+        wiced_bt_mesh_model_onoff_client_send_get(p_event);
+    return route_last_transport;
+}
+
+// transport the Default TTL Set to dst is sent over, the configuration commands leave the event to the caller
+static int route_config_set(uint16_t dst)
+{
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, dst, 0xFFFF);
+    wiced_bt_mesh_config_default_ttl_set_data_t set = { 7 };
+
+    route_last_transport = -1;
+    if (p_event != NULL)
+    {
+        wiced_bt_mesh_config_default_ttl_set(p_event, &set);
+        wiced_bt_mesh_release_event(p_event);
+    }
+    return route_last_transport;
+}
+
+// OnOff Status from the node received over the transport with the RSSI
+static void route_onoff_status(uint8_t transport, uint16_t src, uint16_t dst, int8_t rssi)
+{
+    uint8_t status[13 + 6];
+
+    memset(status, 0, sizeof(status));
+    status[0] = src & 0xff;
+    status[1] = (src >> 8) & 0xff;
+    status[2] = dst & 0xff;
+    status[3] = (dst >> 8) & 0xff;
+    status[7] = (uint8_t)rssi;
+    mesh_client_hci_transport_process_data(transport, HCI_CONTROL_MESH_EVENT_ONOFF_STATUS, status, sizeof(status));
+}
+
+// Tx Complete reporting that the OnOff Get to the node failed
+static void route_tx_failed(uint8_t transport, uint16_t dst)
+{
+    uint8_t complete[13 + 5];
+
+    memset(complete, 0, sizeof(complete));
+    complete[13] = HCI_CONTROL_MESH_COMMAND_ONOFF_GET & 0xff;
+    complete[14] = (HCI_CONTROL_MESH_COMMAND_ONOFF_GET >> 8) & 0xff;
+    complete[15] = TX_STATUS_FAILED;
+    complete[16] = dst & 0xff;
+    complete[17] = (dst >> 8) & 0xff;
+    mesh_client_hci_transport_process_data(transport, HCI_CONTROL_MESH_EVENT_TX_COMPLETE, complete, sizeof(complete));
+}
+
+// SEQ Changed event received over the transport, returns 1 if it is reported
+static int route_seq_changed(uint8_t transport, uint16_t addr, uint32_t seq)
+{
+    uint8_t event[9];
+    int     events = route_seq_events;
+
+    memset(event, 0, sizeof(event));
+    event[0] = addr & 0xff;
+    event[1] = (addr >> 8) & 0xff;
+    event[2] = seq & 0xff;
+    event[3] = (seq >> 8) & 0xff;
+    event[4] = (seq >> 16) & 0xff;
+    event[5] = (seq >> 24) & 0xff;
+    mesh_client_hci_transport_process_data(transport, HCI_CONTROL_MESH_EVENT_CORE_SEQ_CHANGED, event, sizeof(event));
+    return route_seq_events != events;
+}
+
+static void route_check_selection(void)
+{
+    int first, second, third;
+
+    // devices of the additional transports are not configured yet, everything goes to the first one
+    route_check("unconfigured: model command transport", route_onoff_get(ROUTE_NODE), 0);
+    route_check("unconfigured: configuration transport", route_config_set(ROUTE_NODE), 0);
+
+    // configuring the device of a transport, the SEQ carries no address and is sent over the pinned transport
+    mesh_hci_transport_local_addr_set(0, ROUTE_ADDR_0);
+    mesh_hci_transport_local_addr_set(1, ROUTE_ADDR_1);
+    wiced_bt_mesh_core_set_seq(0, 100, WICED_FALSE);
+    route_check("local device 1: SEQ not pinned", route_last_transport, 0);
+    mesh_hci_transport_pin(1);
+    wiced_bt_mesh_core_set_seq(0, 100, WICED_FALSE);
+    route_check("local device 1: SEQ pinned", route_last_transport, 1);
+    route_check("local device 1: configuration of a node pinned", route_config_set(ROUTE_NODE), 1);
+    mesh_hci_transport_pin(-1);
+    mesh_hci_transport_local_addr_set(2, ROUTE_ADDR_2);
+
+    // configuration of the transport's own device goes to it, everything else to the first transport
+    route_check("configured: configuration of device 1", route_config_set(ROUTE_ADDR_1), 1);
+    route_check("configured: configuration of device 2", route_config_set(ROUTE_ADDR_2), 2);
+    route_check("configured: configuration of a node", route_config_set(ROUTE_NODE), 0);
+    route_check("configured: model command to device 2", route_onoff_get(ROUTE_ADDR_2), 2);
+
+    // idle transports share the model commands of the nodes not heard yet, round robin
+    first  = route_onoff_get(ROUTE_NODE);
+    second = route_onoff_get(ROUTE_NODE);
+    third  = route_onoff_get(ROUTE_GROUP);
+    route_check("not heard: three commands over three transports", (first != second) && (second != third) && (first != third), 1);
+
+    // the node is sent to over the transport that hears it best
+    route_onoff_status(1, ROUTE_NODE, ROUTE_ADDR_0, -70);
+    route_onoff_status(2, ROUTE_NODE, ROUTE_ADDR_0, -50);
+    route_check("heard: route to the best RSSI", route_onoff_get(ROUTE_NODE), 2);
+    route_check("heard: route kept", route_onoff_get(ROUTE_NODE), 2);
+
+    // a slightly better RSSI does not move the route, a much better one does
+    route_onoff_status(0, ROUTE_NODE, ROUTE_ADDR_0, -48);
+    route_check("hysteresis: small improvement ignored", route_onoff_get(ROUTE_NODE), 2);
+    route_onoff_status(0, ROUTE_NODE, ROUTE_ADDR_0, -40);
+    route_check("hysteresis: large improvement moves the route", route_onoff_get(ROUTE_NODE), 0);
+
+    // the route is forgotten when its transport fails to reach the node, a failure elsewhere is ignored
+    route_onoff_status(1, ROUTE_OTHER_NODE, ROUTE_ADDR_1, -60);
+    route_tx_failed(2, ROUTE_OTHER_NODE);
+    route_check("tx failed: failure of another transport ignored", route_onoff_get(ROUTE_OTHER_NODE), 1);
+    route_tx_failed(1, ROUTE_OTHER_NODE);
+    first  = route_onoff_get(ROUTE_OTHER_NODE);
+    second = route_onoff_get(ROUTE_OTHER_NODE);
+    route_check("tx failed: route dropped, commands spread again", first != second, 1);
+}
+
+static void route_check_seq(void)
+{
+    // SEQ of the device of an additional transport is stored with the address of that device
+    route_check("SEQ transport 1: reported", route_seq_changed(1, 0, 200), 1);
+    route_check("SEQ transport 1: address", route_seq_addr, ROUTE_ADDR_1);
+    route_check("SEQ transport 1: sequence number", (int)route_seq, 200);
+    route_check("SEQ transport 2: reported", route_seq_changed(2, 0, 300), 1);
+    route_check("SEQ transport 2: address", route_seq_addr, ROUTE_ADDR_2);
+
+    // replay protection entries are kept only from the first transport
+    route_check("SEQ transport 1: RPL entry dropped", route_seq_changed(1, ROUTE_NODE, 400), 0);
+    route_check("SEQ transport 0: RPL entry reported", route_seq_changed(0, ROUTE_NODE, 500), 1);
+    route_check("SEQ transport 0: RPL entry address", route_seq_addr, ROUTE_NODE);
+    route_check("SEQ transport 0: own SEQ reported", route_seq_changed(0, 0, 600), 1);
+    route_check("SEQ transport 0: own SEQ address", route_seq_addr, 0);
+
+    // the first device hears the other provisioners, their SEQ is stored from their own transport only
+    route_check("SEQ transport 0: device 1 entry dropped", route_seq_changed(0, ROUTE_ADDR_1, 700), 0);
+
+    // transport without a device address has nothing to map its SEQ to
+    mesh_hci_transport_local_addr_set(2, 0);
+    route_check("SEQ unconfigured transport: dropped", route_seq_changed(2, 0, 800), 0);
+
+    // closing the network forgets the routes, after reopening the node is not heard yet
+    route_onoff_status(1, ROUTE_NODE, ROUTE_ADDR_0, -10);
+    route_check("before close: route", route_onoff_get(ROUTE_NODE), 1);
+    mesh_hci_transport_local_addr_set(1, 0);
+    mesh_hci_transport_local_addr_set(0, 0);
+    route_check("closed: model command transport", route_onoff_get(ROUTE_NODE), 0);
+    mesh_hci_transport_local_addr_set(0, ROUTE_ADDR_0);
+    mesh_hci_transport_local_addr_set(1, ROUTE_ADDR_1);
+    route_check("reopened: route forgotten", route_onoff_get(ROUTE_NODE) != route_onoff_get(ROUTE_NODE), 1);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -v              print every checked value and trace library logs\n"
+            "  -h              this help\n",
+            prog);
+}
+
+int main(int argc, char **argv)
+{
+    mesh_client_event_pool_stats_t stats;
+    uint8_t transport;
+    int     opt, i;
+
+    while ((opt = getopt(argc, argv, "vh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'v': verbose = 1; break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    for (i = 1; i < 3; i++)
+    {
+        if ((mesh_client_hci_transport_add(route_transport_send, &transport) != MESH_CLIENT_SUCCESS) || (transport != i))
+        {
+            printf("FAIL: transport %d not added\n", i);
+            return 1;
+        }
+    }
+    route_check_selection();
+    route_check_seq();
+
+    mesh_client_event_pool_stats_get(&stats);
+    route_check("events released", stats.in_use, 0);
+
+    if (route_failed != 0)
+    {
+        printf("check: %d checks failed\n", route_failed);
+        return 1;
+    }
+    printf("check: transport selection, routes and SEQ mapping\n");
+    return 0;
+}
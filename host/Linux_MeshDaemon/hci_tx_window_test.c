@@ -0,0 +1,270 @@
+/*
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+*
+* Test of the HCI command flow control of the client library. Model commands are sent with a small window
+* and the Command Status events are fed back by hand. The test checks that the window limits the commands
+* passed to the transport, that each status returns one credit and sends the oldest queued command, and that
+* the credits of the commands lost in a device reset expire and the queue resyncs. The tool exits with 1 if
+* any check fails.
+*/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <getopt.h>
+#include <poll.h>
+
+#include "wiced_bt_ble.h"
+#include "wiced_mesh_client.h"
+#include "wiced_bt_mesh_models.h"
+#include "hci_control_api.h"
+#include "mesh_daemon.h"
+
+#define TX_WINDOW               4
+#define TX_CREDIT_TIMEOUT_MS    50
+#define TX_DST                  0x1234
+
+wiced_bt_mesh_event_t *wiced_bt_mesh_create_event(uint8_t element_idx, uint16_t company_id, uint16_t model_id, uint16_t dst, uint16_t app_key_idx);
+extern void wiced_hci_process_data(uint16_t opcode, uint8_t *p_buffer, uint16_t len);
+
+static uint32_t tx_sent;                /* commands passed to the transport */
+static uint8_t  tx_sent_dst_lsb[64];    /* low byte of the destination of each command, in the order sent */
+static int      tx_failed = 0;
+static int      verbose = 0;
+
+void Log(char *fmt, ...)
+{
+    va_list args;
+
+    if (!verbose)
+        return;
+
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+void ods(char *fmt, ...)
+{
+}
+
+uint8_t wiced_hci_send(uint16_t opcode, uint8_t *p_buffer, uint16_t length)
+{
+    if (tx_sent < sizeof(tx_sent_dst_lsb))
+        tx_sent_dst_lsb[tx_sent] = (length != 0) ? p_buffer[0] : 0;
+    tx_sent++;
+    return 1;
+}
+
+void wiced_bt_mesh_gatt_client_connection_state_changed(uint16_t conn_id, uint16_t mtu)
+{
+}
+
+void wiced_bt_mesh_remote_provisioning_connection_state_changed(uint16_t conn_id, uint16_t reason)
+{
+}
+
+static void tx_check(const char *what, uint32_t value, uint32_t expected)
+{
+    if (value == expected)
+    {
+        if (verbose)
+            printf("  %-40s %u\n", what, value);
+        return;
+    }
+    printf("FAIL: %s is %u, expected %u\n", what, value, expected);
+    tx_failed++;
+}
+
+// send the OnOff Get to the destination which low byte is the sequence number of the command
+static void tx_send(uint8_t seq)
+{
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_GENERIC_ONOFF_CLNT, (TX_DST & 0xff00) | seq, 0);
+
+    if (p_event != NULL)
+        wiced_bt_mesh_model_onoff_client_send_get(p_event);
+}
+
+static void tx_command_status(void)
+{
+    uint8_t status = 0;
+
+    wiced_hci_process_data(HCI_CONTROL_MESH_EVENT_COMMAND_STATUS, &status, 1);
+}
+
+static void tx_check_state(const char *step, uint32_t sent, uint16_t outstanding, uint32_t queue_depth)
+{
+    mesh_client_hci_tx_stats_t stats;
+    char what[80];
+
+    mesh_client_hci_tx_stats_get(&stats);
+
+    snprintf(what, sizeof(what), "%s: commands sent", step);
+    tx_check(what, tx_sent, sent);
+    snprintf(what, sizeof(what), "%s: outstanding", step);
+    tx_check(what, stats.outstanding, outstanding);
+    snprintf(what, sizeof(what), "%s: queue depth", step);
+    tx_check(what, stats.queue_depth, queue_depth);
+}
+
+// commands must reach the transport in the order they were sent
+static void tx_check_order(const char *step)
+{
+    char     what[80];
+    uint32_t i;
+
+    for (i = 0; (i < tx_sent) && (i < sizeof(tx_sent_dst_lsb)); i++)
+    {
+        if (tx_sent_dst_lsb[i] != (uint8_t)i)
+        {
+            snprintf(what, sizeof(what), "%s: command sent at %u", step, i);
+            tx_check(what, tx_sent_dst_lsb[i], i);
+            return;
+        }
+    }
+}
+
+// run the library timers until the credits of the lost commands expire
+static void tx_wait_credit_timeout(int fd)
+{
+    struct pollfd pfd = { fd, POLLIN, 0 };
+    int waited = 0;
+
+    while (waited < 4 * TX_CREDIT_TIMEOUT_MS)
+    {
+        if (poll(&pfd, 1, 10) > 0)
+            linux_timer_process();
+        waited += 10;
+    }
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -v              print every checked value and trace library logs\n"
+            "  -h              this help\n",
+            prog);
+}
+
+int main(int argc, char **argv)
+{
+    mesh_client_hci_tx_stats_t stats;
+    uint8_t seq = 0;
+    int     timer_fd, opt, i;
+
+    while ((opt = getopt(argc, argv, "vh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'v': verbose = 1; break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if ((timer_fd = linux_timer_init()) < 0)
+        return 1;
+
+    // commands sent before the flow control is enabled are passed through and not accounted
+    tx_send(seq++);
+    tx_check_state("disabled", 1, 0, 0);
+
+    if (mesh_client_hci_tx_configure(TX_WINDOW, TX_CREDIT_TIMEOUT_MS) != MESH_CLIENT_SUCCESS)
+    {
+        printf("FAIL: window %d not accepted\n", TX_WINDOW);
+        return 1;
+    }
+
+    // window full, the rest is queued
+    for (i = 0; i < TX_WINDOW + 6; i++)
+        tx_send(seq++);
+    tx_check_state("window full", 1 + TX_WINDOW, TX_WINDOW, 6);
+
+    // every status returns one credit and sends the oldest queued command
+    tx_command_status();
+    tx_check_state("one status", 2 + TX_WINDOW, TX_WINDOW, 5);
+    tx_command_status();
+    tx_command_status();
+    tx_check_state("three statuses", 4 + TX_WINDOW, TX_WINDOW, 3);
+
+    // the device resets and the statuses of the outstanding commands never come, the credits expire and
+    // the queue drains
+    tx_wait_credit_timeout(timer_fd);
+    tx_check_state("after reset", 7 + TX_WINDOW, 3, 0);
+    mesh_client_hci_tx_stats_get(&stats);
+    tx_check("after reset: credit timeouts", stats.credit_timeouts, TX_WINDOW);
+    tx_check("after reset: stall recorded", stats.max_stall_time_us >= TX_CREDIT_TIMEOUT_MS * 1000, 1);
+
+    // the restarted device reports the statuses of the new commands only, a status with no command
+    // outstanding does not create a credit
+    for (i = 0; i < 5; i++)
+        tx_command_status();
+    tx_check_state("resync", 7 + TX_WINDOW, 0, 0);
+    for (i = 0; i < TX_WINDOW + 1; i++)
+        tx_send(seq++);
+    tx_check_state("resync window full", 7 + 2 * TX_WINDOW, TX_WINDOW, 1);
+    tx_command_status();
+    tx_check_state("resync status", 8 + 2 * TX_WINDOW, TX_WINDOW, 0);
+
+    // disabling the window flushes nothing that is already sent, enabling it again starts from empty
+    mesh_client_hci_tx_configure(0, 0);
+    tx_send(seq++);
+    mesh_client_hci_tx_configure(2, 0);
+    tx_check_state("reenabled", 9 + 2 * TX_WINDOW, 0, 0);
+    for (i = 0; i < 3; i++)
+        tx_send(seq++);
+    tx_check_state("reenabled window full", 11 + 2 * TX_WINDOW, 2, 1);
+
+    // shrinking the window with commands queued keeps them queued until the credits return
+    mesh_client_hci_tx_configure(1, 0);
+    tx_check_state("shrunk", 11 + 2 * TX_WINDOW, 1, 1);
+    tx_command_status();
+    tx_check_state("shrunk status", 12 + 2 * TX_WINDOW, 1, 0);
+
+    tx_check_order("order");
+
+    if (tx_failed != 0)
+    {
+        printf("check: %d checks failed\n", tx_failed);
+        return 1;
+    }
+    printf("check: window, credit return and resync after reset\n");
+    return 0;
+}
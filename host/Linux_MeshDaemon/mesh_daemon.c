@@ -0,0 +1,1579 @@
+/*
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+*
+* Headless Linux host for the embedded mesh app. One epoll loop serves the UART connected to the
+* device, the timerfd that drives WICED timers and a Unix domain control socket. The mesh client
+* library is only ever called from the loop thread, so no locking is required.
+*
+* Control clients send one command per line, for example
+*     onoff "Dimmable Light (0002)" 1
+* Each command is answered with a line that starts with OK or ERR. Status reported by the mesh
+* devices is sent to all clients in lines that start with EVT.
+*
+* The daemon that owns the UART can also share it with other processes over a Unix domain or a
+* loopback TCP HCI socket. The HCI socket carries exactly the same packets as the UART. Commands from
+* the clients are sent to the device and events from the device are sent to every client that
+* has enabled the opcode group of the event, see HCI_DAEMON_COMMAND_SET_EVENT_FILTER. Another
+* instance of the daemon started with -c uses such a socket in place of the UART.
+*
+* With -B the packets sent to the UART are batched, all packets produced while the loop handles one
+* set of epoll events (or within -T microseconds) are written with a single write call.
+*
+* With -r all packets sent to and received from the device are recorded to a capture file which
+* can be fed through the mesh client library offline with hci_replay.
+*
+* Each -a adds the UART of another device running the same embedded app. The library configures
+* every device as a separate provisioner node of the network and spreads commands to the models
+* between them. Packets of the additional UARTs are not batched, shared or recorded.
+*/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#include "wiced_bt_ble.h"
+#include "wiced_timer.h"
+#include "wiced_mesh_client.h"
+#include "hci_control_api.h"
+#include "hci_framer.h"
+#include "mesh_daemon.h"
+
+#define DAEMON_DEFAULT_SOCKET       "/tmp/mesh_daemon.sock"
+#define DAEMON_DEFAULT_BAUD_RATE    115200
+#define DAEMON_DEFAULT_PROVISIONER  "mesh_daemon"
+
+#define DAEMON_MAX_CLIENTS          16
+#define DAEMON_MAX_EPOLL_EVENTS     16
+#define DAEMON_MAX_ARGS             12
+#define DAEMON_CLIENT_LINE_MAX      1024
+#define DAEMON_CLIENT_TX_MAX        0x40000     /* a client that falls this much behind on events is dropped */
+
+#define DAEMON_CMD_REPLIED          (-1)        /* command handler has already sent the reply */
+
+// Size of the UART receive ring, must be a power of 2 and hold the largest HCI packet (5 + 0xffff)
+#define HCI_RX_RING_SIZE            0x20000
+
+extern void wiced_hci_process_data(uint16_t opcode, uint8_t *p_buffer, uint16_t len);
+
+// receive ring of an HCI byte stream
+typedef hci_framer_t hci_rx_t;
+
+typedef struct
+{
+    daemon_source_t source;
+    uint8_t         is_hci;                 /* HCI socket client, otherwise control client */
+    uint32_t        tx_len;
+    char           *p_tx_buf;
+
+    // control client
+    uint16_t        rx_len;
+    char            rx_buf[DAEMON_CLIENT_LINE_MAX];
+
+    // HCI client
+    hci_rx_t        hci_rx;
+    uint8_t         event_filter[32];       /* bit per opcode group of the events sent to the client */
+    uint32_t        commands;
+    uint64_t        command_bytes;
+    uint32_t        events;
+    uint64_t        event_bytes;
+
+    void           *p_next_closed;
+} daemon_client_t;
+
+typedef struct
+{
+    const char *name;
+    int         min_args;           /* number of arguments after the command name */
+    int        (*p_handler)(daemon_client_t *p_client, int argc, char **argv);
+    const char *usage;
+} daemon_command_t;
+
+static int              epoll_fd = -1;
+static volatile int     daemon_running = 1;
+static daemon_source_t  uart_source;
+static daemon_source_t  timer_source;
+static daemon_source_t  listen_source;
+static daemon_source_t  hci_listen_source;
+static daemon_source_t  hci_tcp_listen_source;
+static daemon_source_t  signal_source;
+static daemon_source_t  uart_tx_timer_source;
+static daemon_client_t *daemon_clients[DAEMON_MAX_CLIENTS];
+static daemon_client_t *closed_clients = NULL;
+
+static hci_rx_t         uart_rx;
+static uart_tx_queue_t  uart_tx;
+static uint8_t          uart_is_socket = 0;
+
+// additional UARTs, each one is a separate HCI transport of the mesh client library
+typedef struct
+{
+    daemon_source_t source;
+    hci_rx_t        rx;
+    uart_tx_queue_t tx;
+    uint8_t         transport;
+    const char     *device;
+} extra_uart_t;
+
+static extra_uart_t     extra_uarts[MESH_CLIENT_HCI_MAX_TRANSPORTS - 1];
+static int              num_extra_uarts = 0;
+static uint8_t          hci_rx_packet[5 + 0xffff];
+
+// UART transmit batching, disabled if the threshold is 0
+static uint32_t         uart_tx_batch_threshold = 0;
+static uint32_t         uart_tx_batch_delay_us = 0;
+
+static const char      *socket_path = DAEMON_DEFAULT_SOCKET;
+static const char      *hci_socket_path = NULL;
+static const char      *provisioner_name = DAEMON_DEFAULT_PROVISIONER;
+static char             provisioner_uuid[33];
+static FILE            *log_fp = NULL;
+static int              verbose = 0;
+
+static void daemon_broadcast(const char *fmt, ...);
+
+/******************************************************************************
+ * Traces
+ ******************************************************************************/
+static void daemon_trace(const char *fmt, va_list args)
+{
+    struct timespec ts;
+    struct tm       tm;
+    FILE           *fp = (log_fp != NULL) ? log_fp : stderr;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    localtime_r(&ts.tv_sec, &tm);
+    fprintf(fp, "%02d-%02d-%04d %02d:%02d:%02d.%03ld: ", tm.tm_mon + 1, tm.tm_mday, tm.tm_year + 1900,
+            tm.tm_hour, tm.tm_min, tm.tm_sec, ts.tv_nsec / 1000000);
+    vfprintf(fp, fmt, args);
+    if ((fmt[0] == 0) || (fmt[strlen(fmt) - 1] != '\n'))
+        fputc('\n', fp);
+    fflush(fp);
+}
+
+void Log(char *fmt, ...)
+{
+    va_list args;
+
+    va_start(args, fmt);
+    daemon_trace(fmt, args);
+    va_end(args);
+}
+
+void ods(char *fmt, ...)
+{
+    va_list args;
+
+    if (!verbose)
+        return;
+
+    va_start(args, fmt);
+    daemon_trace(fmt, args);
+    va_end(args);
+}
+
+/******************************************************************************
+ * epoll helpers
+ ******************************************************************************/
+static int daemon_source_add(daemon_source_t *p_source, int fd, uint32_t events, daemon_source_handler_t p_handler)
+{
+    struct epoll_event ev;
+
+    p_source->fd        = fd;
+    p_source->p_handler = p_handler;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events   = events;
+    ev.data.ptr = p_source;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0)
+    {
+        Log("epoll_ctl add fd:%d failed: %s", fd, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+void daemon_source_modify(daemon_source_t *p_source, uint32_t events)
+{
+    struct epoll_event ev;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events   = events;
+    ev.data.ptr = p_source;
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, p_source->fd, &ev);
+}
+
+/******************************************************************************
+ * UART
+ ******************************************************************************/
+static speed_t uart_baud_to_speed(int baud_rate)
+{
+    switch (baud_rate)
+    {
+    case 9600:      return B9600;
+    case 19200:     return B19200;
+    case 38400:     return B38400;
+    case 57600:     return B57600;
+    case 115200:    return B115200;
+    case 230400:    return B230400;
+    case 460800:    return B460800;
+    case 921600:    return B921600;
+    case 1000000:   return B1000000;
+    case 1500000:   return B1500000;
+    case 2000000:   return B2000000;
+    case 3000000:   return B3000000;
+    case 4000000:   return B4000000;
+    }
+    return B0;
+}
+
+static int uart_open(const char *device, int baud_rate)
+{
+    struct termios tio;
+    speed_t        speed = uart_baud_to_speed(baud_rate);
+    int            fd;
+
+    if (speed == B0)
+    {
+        Log("Unsupported baud rate %d", baud_rate);
+        return -1;
+    }
+    if ((fd = open(device, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC)) < 0)
+    {
+        Log("Error opening %s: %s", device, strerror(errno));
+        return -1;
+    }
+    if (tcgetattr(fd, &tio) < 0)
+    {
+        Log("tcgetattr %s failed: %s", device, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    // raw 8N1 with hardware flow control, same as the Qt host
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD | CRTSCTS;
+    tio.c_cflag &= ~CSTOPB;
+    tio.c_cc[VMIN]  = 0;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    if (tcsetattr(fd, TCSANOW, &tio) < 0)
+    {
+        Log("tcsetattr %s failed: %s", device, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    tcflush(fd, TCIOFLUSH);
+
+    Log("Opened %s at speed: %d", device, baud_rate);
+    return fd;
+}
+
+static void uart_tx_timer_handler(daemon_source_t *p_source, uint32_t events)
+{
+    uint64_t expirations;
+
+    if (read(p_source->fd, &expirations, sizeof(expirations)) == sizeof(expirations))
+        uart_tx_flush();
+}
+
+uint8_t wiced_hci_send(uint16_t opcode, uint8_t *p_buffer, uint16_t length)
+{
+    uint8_t data[5 + 1024];
+    int     header = 0;
+
+    if ((uart_source.fd < 0) || (length > sizeof(data) - 5))
+        return 0;
+
+    data[header++] = HCI_WICED_PKT;
+    data[header++] = opcode & 0xff;
+    data[header++] = (opcode >> 8) & 0xff;
+    data[header++] = length & 0xff;
+    data[header++] = (length >> 8) & 0xff;
+
+    memcpy(&data[header], p_buffer, length);
+
+    return (uint8_t)uart_send(data, length + header);
+}
+
+static uint8_t extra_uart_send(uint8_t transport, uint16_t opcode, uint8_t *p_buffer, uint16_t length)
+{
+    uint8_t data[5 + 1024];
+    int     i;
+
+    if (length > sizeof(data) - 5)
+        return 0;
+
+    for (i = 0; i < num_extra_uarts; i++)
+    {
+        if (extra_uarts[i].transport == transport)
+            break;
+    }
+    if ((i == num_extra_uarts) || (extra_uarts[i].source.fd < 0))
+        return 0;
+
+    data[0] = HCI_WICED_PKT;
+    data[1] = opcode & 0xff;
+    data[2] = (opcode >> 8) & 0xff;
+    data[3] = length & 0xff;
+    data[4] = (length >> 8) & 0xff;
+    memcpy(&data[5], p_buffer, length);
+
+    return (uint8_t)uart_write(&extra_uarts[i].source, &extra_uarts[i].tx, data, length + 5);
+}
+
+static void hci_client_send_event(uint8_t *p_packet, uint32_t len);
+
+static void hci_process_packet(uint8_t *p_packet, uint32_t len)
+{
+    uint16_t opcode;
+    uint16_t data_len;
+
+    hci_capture_write(HCI_CAPTURE_DIR_DEVICE_TO_HOST, p_packet, len);
+    hci_client_send_event(p_packet, len);
+
+    // only WICED HCI packets carry mesh events, HCI events and ACL data are not used by this host
+    if (p_packet[0] != HCI_WICED_PKT)
+        return;
+
+    opcode   = p_packet[1] | (p_packet[2] << 8);
+    data_len = p_packet[3] | (p_packet[4] << 8);
+
+    if (opcode == HCI_CONTROL_EVENT_WICED_TRACE)
+    {
+        while ((data_len != 0) && ((p_packet[5 + data_len - 1] == '\n') || (p_packet[5 + data_len - 1] == '\r') || (p_packet[5 + data_len - 1] == 0)))
+            data_len--;
+        Log("%.*s", data_len, &p_packet[5]);
+    }
+    else if (opcode != HCI_CONTROL_EVENT_HCI_TRACE)
+    {
+        wiced_hci_process_data(opcode, &p_packet[5], data_len);
+    }
+}
+
+static int hci_rx_init(hci_rx_t *p_rx)
+{
+    uint8_t *p_ring = (uint8_t *)malloc(HCI_RX_RING_SIZE);
+
+    hci_framer_init(p_rx, p_ring, HCI_RX_RING_SIZE, 0);
+    return p_ring != NULL;
+}
+
+// Read whatever is available into the ring. Returns number of bytes read, 0 if nothing is available
+// and -1 if the stream is closed or failed.
+static int hci_rx_read(hci_rx_t *p_rx, int fd, int is_socket)
+{
+    uint32_t space;
+    uint8_t *p_space = hci_framer_space(p_rx, &space);
+    ssize_t  bytes;
+
+    bytes = read(fd, p_space, space);
+    if (bytes < 0)
+        return ((errno == EAGAIN) || (errno == EINTR)) ? 0 : -1;
+
+    // tty in non-canonical mode returns 0 when there is no data, a socket only when the peer is gone
+    if ((bytes == 0) && is_socket)
+        return -1;
+
+    hci_framer_commit(p_rx, (uint32_t)bytes);
+    return (int)bytes;
+}
+
+// Takes one complete HCI packet off the receive ring and copies it to p_packet, which holds the largest
+// packet. Returns length of the packet, or 0 if the ring holds only part of a packet. Unknown packet types
+// are returned one byte at a time so that the caller can skip them.
+static uint32_t hci_rx_frame(hci_rx_t *p_rx, uint8_t *p_packet)
+{
+    uint32_t offset, len;
+
+    if (hci_framer_frame(p_rx, p_packet, 5 + 0xffff, &offset, &len) != HCI_FRAMER_PACKET)
+        return 0;
+    return offset + len;
+}
+
+static void uart_handler(daemon_source_t *p_source, uint32_t events)
+{
+    uint32_t len;
+    int      bytes;
+
+    if (events & EPOLLOUT)
+        uart_tx_drain(p_source, &uart_tx);
+
+    // drain everything the driver has, framing as we go so that the ring never fills up
+    do
+    {
+        if ((bytes = hci_rx_read(&uart_rx, p_source->fd, uart_is_socket)) < 0)
+        {
+            Log("UART closed");
+            daemon_running = 0;
+            return;
+        }
+        while ((len = hci_rx_frame(&uart_rx, hci_rx_packet)) != 0)
+        {
+            if (len > 1)
+                hci_process_packet(hci_rx_packet, len);
+        }
+    } while (bytes > 0);
+
+    if (events & (EPOLLERR | EPOLLHUP))
+    {
+        Log("UART closed");
+        daemon_running = 0;
+    }
+}
+
+// The additional UARTs only carry mesh events to the library, the device is not shared with HCI clients
+static void extra_uart_handler(daemon_source_t *p_source, uint32_t events)
+{
+    extra_uart_t *p_uart = (extra_uart_t *)p_source;
+    uint32_t      len;
+    uint16_t      opcode, data_len;
+    int           bytes;
+
+    if (events & EPOLLOUT)
+        uart_tx_drain(p_source, &p_uart->tx);
+
+    do
+    {
+        if ((bytes = hci_rx_read(&p_uart->rx, p_source->fd, 0)) < 0)
+            break;
+        while ((len = hci_rx_frame(&p_uart->rx, hci_rx_packet)) != 0)
+        {
+            if ((len < 5) || (hci_rx_packet[0] != HCI_WICED_PKT))
+                continue;
+
+            opcode   = hci_rx_packet[1] | (hci_rx_packet[2] << 8);
+            data_len = hci_rx_packet[3] | (hci_rx_packet[4] << 8);
+
+            if (opcode == HCI_CONTROL_EVENT_WICED_TRACE)
+            {
+                while ((data_len != 0) && ((hci_rx_packet[5 + data_len - 1] == '\n') || (hci_rx_packet[5 + data_len - 1] == '\r') || (hci_rx_packet[5 + data_len - 1] == 0)))
+                    data_len--;
+                Log("[%d] %.*s", p_uart->transport, data_len, &hci_rx_packet[5]);
+            }
+            else if (opcode != HCI_CONTROL_EVENT_HCI_TRACE)
+            {
+                mesh_client_hci_transport_process_data(p_uart->transport, opcode, &hci_rx_packet[5], data_len);
+            }
+        }
+    } while (bytes > 0);
+
+    if ((bytes < 0) || (events & (EPOLLERR | EPOLLHUP)))
+    {
+        // the network keeps working over the other devices
+        Log("UART %s closed", p_uart->device);
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, p_source->fd, NULL);
+        close(p_source->fd);
+        p_source->fd = -1;
+        p_uart->tx.len = 0;
+    }
+}
+
+/******************************************************************************
+ * Control clients
+ ******************************************************************************/
+static void client_close(daemon_client_t *p_client)
+{
+    int i;
+
+    for (i = 0; i < DAEMON_MAX_CLIENTS; i++)
+    {
+        if (daemon_clients[i] == p_client)
+            daemon_clients[i] = NULL;
+    }
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, p_client->source.fd, NULL);
+    close(p_client->source.fd);
+
+    // events for the client may still be pending in the current epoll batch, free it after the batch
+    p_client->source.p_handler = NULL;
+    p_client->p_next_closed = closed_clients;
+    closed_clients = p_client;
+}
+
+static void client_free_closed(void)
+{
+    daemon_client_t *p_client;
+
+    while ((p_client = closed_clients) != NULL)
+    {
+        closed_clients = (daemon_client_t *)p_client->p_next_closed;
+        free(p_client->hci_rx.p_ring);
+        free(p_client->p_tx_buf);
+        free(p_client);
+    }
+}
+
+// Send as much of the pending output as the socket accepts, returns 0 if the client is gone
+static int client_flush(daemon_client_t *p_client)
+{
+    ssize_t sent;
+
+    while (p_client->tx_len)
+    {
+        sent = send(p_client->source.fd, p_client->p_tx_buf, p_client->tx_len, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (sent < 0)
+        {
+            if (errno == EAGAIN)
+                break;
+            if (errno == EINTR)
+                continue;
+            return 0;
+        }
+        p_client->tx_len -= (uint32_t)sent;
+        memmove(p_client->p_tx_buf, p_client->p_tx_buf + sent, p_client->tx_len);
+    }
+    daemon_source_modify(&p_client->source, p_client->tx_len ? EPOLLIN | EPOLLOUT : EPOLLIN);
+    return 1;
+}
+
+static void client_overflow(daemon_client_t *p_client)
+{
+    Log("%s client fd:%d is not reading, dropped", p_client->is_hci ? "HCI" : "control", p_client->source.fd);
+
+    // the output is lost anyway, do not let a slow client hold the loop
+    p_client->tx_len = 0;
+    shutdown(p_client->source.fd, SHUT_RDWR);
+}
+
+static void client_vprintf(daemon_client_t *p_client, const char *fmt, va_list args)
+{
+    int len;
+
+    len = vsnprintf(p_client->p_tx_buf + p_client->tx_len, DAEMON_CLIENT_TX_MAX - p_client->tx_len, fmt, args);
+    if ((len < 0) || (p_client->tx_len + len >= DAEMON_CLIENT_TX_MAX))
+    {
+        client_overflow(p_client);
+        return;
+    }
+    p_client->tx_len += len;
+}
+
+static void client_write(daemon_client_t *p_client, const uint8_t *p_data, uint32_t len)
+{
+    if (p_client->tx_len + len > DAEMON_CLIENT_TX_MAX)
+    {
+        client_overflow(p_client);
+        return;
+    }
+    memcpy(p_client->p_tx_buf + p_client->tx_len, p_data, len);
+    p_client->tx_len += len;
+}
+
+static void client_printf(daemon_client_t *p_client, const char *fmt, ...)
+{
+    va_list args;
+
+    va_start(args, fmt);
+    client_vprintf(p_client, fmt, args);
+    va_end(args);
+}
+
+static void daemon_broadcast(const char *fmt, ...)
+{
+    va_list args;
+    int     i;
+
+    for (i = 0; i < DAEMON_MAX_CLIENTS; i++)
+    {
+        if ((daemon_clients[i] == NULL) || daemon_clients[i]->is_hci)
+            continue;
+        va_start(args, fmt);
+        client_vprintf(daemon_clients[i], fmt, args);
+        va_end(args);
+        if (!client_flush(daemon_clients[i]))
+            client_close(daemon_clients[i]);
+    }
+}
+
+// Print a list of NUL separated names that ends with an empty name, and free it
+static int client_print_list(daemon_client_t *p_client, char *p_list)
+{
+    char *p;
+
+    if (p_list == NULL)
+    {
+        client_printf(p_client, "OK\n");
+        return DAEMON_CMD_REPLIED;
+    }
+    client_printf(p_client, "OK");
+    for (p = p_list; *p != 0; p += strlen(p) + 1)
+        client_printf(p_client, " \"%s\"", p);
+    client_printf(p_client, "\n");
+    free(p_list);
+    return DAEMON_CMD_REPLIED;
+}
+
+static int hex_to_uuid(const char *p_str, uint8_t *p_uuid)
+{
+    unsigned int byte;
+    int          i;
+
+    if (strlen(p_str) != 32)
+        return 0;
+    for (i = 0; i < 16; i++)
+    {
+        if (sscanf(&p_str[i * 2], "%2x", &byte) != 1)
+            return 0;
+        p_uuid[i] = (uint8_t)byte;
+    }
+    return 1;
+}
+
+/******************************************************************************
+ * Commands
+ ******************************************************************************/
+static void network_opened(uint8_t status)
+{
+    daemon_broadcast("EVT network_opened %d\n", status);
+}
+
+static int cmd_help(daemon_client_t *p_client, int argc, char **argv);
+
+static int cmd_networks(daemon_client_t *p_client, int argc, char **argv)
+{
+    return client_print_list(p_client, mesh_client_get_all_networks());
+}
+
+static int cmd_create(daemon_client_t *p_client, int argc, char **argv)
+{
+    return mesh_client_network_create(provisioner_name, provisioner_uuid, argv[1]);
+}
+
+static int cmd_open(daemon_client_t *p_client, int argc, char **argv)
+{
+    return mesh_client_network_open(provisioner_name, provisioner_uuid, argv[1], network_opened);
+}
+
+static int cmd_close(daemon_client_t *p_client, int argc, char **argv)
+{
+    mesh_client_network_close();
+    uart_tx_flush();
+    hci_capture_flush();
+    return MESH_CLIENT_SUCCESS;
+}
+
+static int cmd_groups(daemon_client_t *p_client, int argc, char **argv)
+{
+    return client_print_list(p_client, mesh_client_get_all_groups(argc > 1 ? argv[1] : NULL));
+}
+
+static int cmd_components(daemon_client_t *p_client, int argc, char **argv)
+{
+    return client_print_list(p_client, mesh_client_get_group_components(argv[1]));
+}
+
+static int cmd_group_create(daemon_client_t *p_client, int argc, char **argv)
+{
+    return mesh_client_group_create(argv[1], argc > 2 ? argv[2] : NULL);
+}
+
+static int cmd_scan(daemon_client_t *p_client, int argc, char **argv)
+{
+    return mesh_client_scan_unprovisioned(atoi(argv[1]), NULL);
+}
+
+static int cmd_provision(daemon_client_t *p_client, int argc, char **argv)
+{
+    uint8_t uuid[16];
+
+    if (!hex_to_uuid(argv[3], uuid))
+        return MESH_CLIENT_ERR_INVALID_ARGS;
+    return mesh_client_provision(argv[1], argv[2], uuid, argc > 4 ? (uint8_t)atoi(argv[4]) : 0);
+}
+
+static int cmd_reset(daemon_client_t *p_client, int argc, char **argv)
+{
+    return mesh_client_reset_device(argv[1]);
+}
+
+static int cmd_connect(daemon_client_t *p_client, int argc, char **argv)
+{
+    return mesh_client_connect_network(1, argc > 1 ? (uint8_t)atoi(argv[1]) : 10);
+}
+
+static int cmd_disconnect(daemon_client_t *p_client, int argc, char **argv)
+{
+    return mesh_client_disconnect_network();
+}
+
+static int cmd_onoff(daemon_client_t *p_client, int argc, char **argv)
+{
+    return mesh_client_on_off_set(argv[1], (uint8_t)atoi(argv[2]), argc > 3 ? atoi(argv[3]) : WICED_TRUE, DEFAULT_TRANSITION_TIME, 0);
+}
+
+static int cmd_onoff_get(daemon_client_t *p_client, int argc, char **argv)
+{
+    return mesh_client_on_off_get(argv[1]);
+}
+
+static int cmd_level(daemon_client_t *p_client, int argc, char **argv)
+{
+    return mesh_client_level_set(argv[1], (int16_t)atoi(argv[2]), WICED_TRUE, DEFAULT_TRANSITION_TIME, 0);
+}
+
+static int cmd_level_get(daemon_client_t *p_client, int argc, char **argv)
+{
+    return mesh_client_level_get(argv[1]);
+}
+
+static int cmd_lightness(daemon_client_t *p_client, int argc, char **argv)
+{
+    return mesh_client_lightness_set(argv[1], (uint16_t)atoi(argv[2]), WICED_TRUE, DEFAULT_TRANSITION_TIME, 0);
+}
+
+static int cmd_lightness_get(daemon_client_t *p_client, int argc, char **argv)
+{
+    return mesh_client_lightness_get(argv[1]);
+}
+
+static int cmd_hsl(daemon_client_t *p_client, int argc, char **argv)
+{
+    return mesh_client_hsl_set(argv[1], (uint16_t)atoi(argv[2]), (uint16_t)atoi(argv[3]), (uint16_t)atoi(argv[4]), WICED_TRUE, DEFAULT_TRANSITION_TIME, 0);
+}
+
+static int cmd_ctl(daemon_client_t *p_client, int argc, char **argv)
+{
+    return mesh_client_ctl_set(argv[1], (uint16_t)atoi(argv[2]), (uint16_t)atoi(argv[3]), (uint16_t)atoi(argv[4]), WICED_TRUE, DEFAULT_TRANSITION_TIME, 0);
+}
+
+static int cmd_sensor_get(daemon_client_t *p_client, int argc, char **argv)
+{
+    return mesh_client_sensor_get(argv[1], (int)strtol(argv[2], NULL, 0));
+}
+
+static int cmd_sensor_poll(daemon_client_t *p_client, int argc, char **argv)
+{
+    uint32_t period_ms = (uint32_t)strtoul(argv[3], NULL, 0);
+
+    if (period_ms == 0)
+        return mesh_client_sensor_poll_remove(argv[1], (int)strtol(argv[2], NULL, 0));
+    return mesh_client_sensor_poll_add(argv[1], (int)strtol(argv[2], NULL, 0), period_ms);
+}
+
+static int cmd_stats(daemon_client_t *p_client, int argc, char **argv)
+{
+    mesh_client_hci_event_stats_t   hci_stats[64];
+    mesh_client_event_pool_stats_t  pool_stats;
+    mesh_client_hci_tx_stats_t      tx_stats;
+    mesh_client_hci_transport_stats_t transport_stats;
+    linux_timer_stats_t             timer_stats;
+    uart_tx_stats_t                 uart_stats;
+    int                             num, i;
+
+    mesh_client_event_pool_stats_get(&pool_stats);
+    client_printf(p_client, "OK pool capacity:%u in_use:%u high_water_mark:%u hits:%u misses:%u\n",
+                  pool_stats.capacity, pool_stats.in_use, pool_stats.high_water_mark, pool_stats.hits, pool_stats.misses);
+
+    uart_tx_stats_get(&uart_stats);
+    client_printf(p_client, "OK uart writes:%u packets:%u bytes:%llu queued:%u max_queued:%u\n", uart_stats.writes, uart_stats.packets,
+                  (unsigned long long)uart_stats.bytes, uart_tx.len, uart_stats.max_queued);
+
+    mesh_client_hci_tx_stats_get(&tx_stats);
+    client_printf(p_client, "OK tx window:%u outstanding:%u queue_depth:%u max_queue_depth:%u sent:%u queued:%u credit_timeouts:%u stall_time_us:%llu max_stall_time_us:%u\n",
+                  tx_stats.window, tx_stats.outstanding, tx_stats.queue_depth, tx_stats.max_queue_depth, tx_stats.sent, tx_stats.queued,
+                  tx_stats.credit_timeouts, (unsigned long long)tx_stats.stall_time_us, tx_stats.max_stall_time_us);
+
+    for (i = 0; (num_extra_uarts != 0) && (mesh_client_hci_transport_stats_get((uint8_t)i, &transport_stats) == MESH_CLIENT_SUCCESS); i++)
+        client_printf(p_client, "OK transport:%d addr:%04x balanced:%u routed:%u outstanding:%u queue_depth:%u max_queue_depth:%u sent:%u queued:%u credit_timeouts:%u\n",
+                      i, transport_stats.addr, transport_stats.balanced, transport_stats.routed, transport_stats.tx.outstanding,
+                      transport_stats.tx.queue_depth, transport_stats.tx.max_queue_depth, transport_stats.tx.sent, transport_stats.tx.queued,
+                      transport_stats.tx.credit_timeouts);
+
+    linux_timer_stats_get(&timer_stats, 0);
+    client_printf(p_client, "OK timers fired:%llu late_avg_us:%llu late_max_us:%u late_1ms:%u late_2ms:%u late_5ms:%u late_10ms:%u late_50ms:%u late_more:%u\n",
+                  (unsigned long long)timer_stats.fired, (unsigned long long)(timer_stats.fired ? timer_stats.late_us_total / timer_stats.fired : 0),
+                  timer_stats.late_us_max, timer_stats.late_hist[0], timer_stats.late_hist[1], timer_stats.late_hist[2],
+                  timer_stats.late_hist[3], timer_stats.late_hist[4], timer_stats.late_hist[5]);
+
+    num = mesh_client_hci_event_stats_get_all(hci_stats, sizeof(hci_stats) / sizeof(hci_stats[0]));
+    for (i = 0; i < num; i++)
+        client_printf(p_client, "OK hci opcode:%04x count:%u bytes:%llu parse_time_us:%llu max_parse_time_us:%u\n",
+                      hci_stats[i].opcode, hci_stats[i].count, (unsigned long long)hci_stats[i].bytes,
+                      (unsigned long long)hci_stats[i].parse_time_us, hci_stats[i].max_parse_time_us);
+
+    for (i = 0; i < DAEMON_MAX_CLIENTS; i++)
+    {
+        if ((daemon_clients[i] != NULL) && daemon_clients[i]->is_hci)
+            client_printf(p_client, "OK hci_client fd:%d commands:%u command_bytes:%llu events:%u event_bytes:%llu\n",
+                          daemon_clients[i]->source.fd, daemon_clients[i]->commands, (unsigned long long)daemon_clients[i]->command_bytes,
+                          daemon_clients[i]->events, (unsigned long long)daemon_clients[i]->event_bytes);
+    }
+    client_printf(p_client, "OK\n");
+    return DAEMON_CMD_REPLIED;
+}
+
+static const daemon_command_t daemon_commands[] =
+{
+    { "help",           0, cmd_help,            "" },
+    { "networks",       0, cmd_networks,        "" },
+    { "create",         1, cmd_create,          "<mesh name>" },
+    { "open",           1, cmd_open,            "<mesh name>" },
+    { "close",          0, cmd_close,           "" },
+    { "groups",         0, cmd_groups,          "[group]" },
+    { "components",     1, cmd_components,      "<group>" },
+    { "group_create",   1, cmd_group_create,    "<group> [parent group]" },
+    { "scan",           1, cmd_scan,            "<1 start | 0 stop>" },
+    { "provision",      3, cmd_provision,       "<device name> <group> <uuid> [identify duration]" },
+    { "reset",          1, cmd_reset,           "<device name>" },
+    { "connect",        0, cmd_connect,         "[scan duration]" },
+    { "disconnect",     0, cmd_disconnect,      "" },
+    { "onoff",          2, cmd_onoff,           "<name> <0|1> [reliable]" },
+    { "onoff_get",      1, cmd_onoff_get,       "<name>" },
+    { "level",          2, cmd_level,           "<name> <level>" },
+    { "level_get",      1, cmd_level_get,       "<name>" },
+    { "lightness",      2, cmd_lightness,       "<name> <lightness>" },
+    { "lightness_get",  1, cmd_lightness_get,   "<name>" },
+    { "hsl",            4, cmd_hsl,             "<name> <lightness> <hue> <saturation>" },
+    { "ctl",            4, cmd_ctl,             "<name> <lightness> <temperature> <delta uv>" },
+    { "sensor_get",     2, cmd_sensor_get,      "<name> <property id>" },
+    { "sensor_poll",    3, cmd_sensor_poll,     "<name> <property id> <period ms, 0 to stop>" },
+    { "stats",          0, cmd_stats,           "" },
+};
+
+static int cmd_help(daemon_client_t *p_client, int argc, char **argv)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(daemon_commands) / sizeof(daemon_commands[0]); i++)
+        client_printf(p_client, "OK %s %s\n", daemon_commands[i].name, daemon_commands[i].usage);
+    client_printf(p_client, "OK\n");
+    return DAEMON_CMD_REPLIED;
+}
+
+// Split the line into arguments in place, double quotes group words with spaces into one argument
+static int client_split_args(char *p_line, char **argv)
+{
+    int argc = 0;
+
+    while (argc < DAEMON_MAX_ARGS)
+    {
+        while ((*p_line == ' ') || (*p_line == '\t'))
+            p_line++;
+        if (*p_line == 0)
+            break;
+
+        if (*p_line == '"')
+        {
+            argv[argc++] = ++p_line;
+            while ((*p_line != 0) && (*p_line != '"'))
+                p_line++;
+        }
+        else
+        {
+            argv[argc++] = p_line;
+            while ((*p_line != 0) && (*p_line != ' ') && (*p_line != '\t'))
+                p_line++;
+        }
+        if (*p_line != 0)
+            *p_line++ = 0;
+    }
+    return argc;
+}
+
+static void client_execute(daemon_client_t *p_client, char *p_line)
+{
+    char   *argv[DAEMON_MAX_ARGS];
+    int     argc, res;
+    size_t  i;
+
+    if ((argc = client_split_args(p_line, argv)) == 0)
+        return;
+
+    for (i = 0; i < sizeof(daemon_commands) / sizeof(daemon_commands[0]); i++)
+    {
+        if (strcmp(argv[0], daemon_commands[i].name) == 0)
+            break;
+    }
+    if (i == sizeof(daemon_commands) / sizeof(daemon_commands[0]))
+    {
+        client_printf(p_client, "ERR unknown command %s\n", argv[0]);
+        return;
+    }
+    if (argc - 1 < daemon_commands[i].min_args)
+    {
+        client_printf(p_client, "ERR usage: %s %s\n", daemon_commands[i].name, daemon_commands[i].usage);
+        return;
+    }
+
+    res = daemon_commands[i].p_handler(p_client, argc, argv);
+
+    if (res == DAEMON_CMD_REPLIED)
+        return;
+    if (res == MESH_CLIENT_SUCCESS)
+        client_printf(p_client, "OK\n");
+    else
+        client_printf(p_client, "ERR %d\n", res);
+}
+
+static void client_handler(daemon_source_t *p_source, uint32_t events)
+{
+    daemon_client_t *p_client = (daemon_client_t *)p_source;
+    ssize_t          bytes;
+    char            *p_line, *p_end;
+
+    if (events & EPOLLIN)
+    {
+        bytes = recv(p_source->fd, p_client->rx_buf + p_client->rx_len, sizeof(p_client->rx_buf) - 1 - p_client->rx_len, 0);
+        // 0 is the peer closing, errno is only meaningful when recv failed
+        if ((bytes == 0) || ((bytes < 0) && (errno != EAGAIN) && (errno != EINTR)))
+        {
+            client_close(p_client);
+            return;
+        }
+        if (bytes > 0)
+        {
+            p_client->rx_len += (uint16_t)bytes;
+            p_client->rx_buf[p_client->rx_len] = 0;
+
+            // execute every complete line, keep the partial one for the next read
+            p_line = p_client->rx_buf;
+            while ((p_end = strchr(p_line, '\n')) != NULL)
+            {
+                *p_end = 0;
+                if ((p_end > p_line) && (p_end[-1] == '\r'))
+                    p_end[-1] = 0;
+                client_execute(p_client, p_line);
+                p_line = p_end + 1;
+            }
+            p_client->rx_len -= (uint16_t)(p_line - p_client->rx_buf);
+            memmove(p_client->rx_buf, p_line, p_client->rx_len);
+
+            if (p_client->rx_len == sizeof(p_client->rx_buf) - 1)
+            {
+                client_printf(p_client, "ERR line too long\n");
+                p_client->rx_len = 0;
+            }
+        }
+    }
+    if ((events & (EPOLLERR | EPOLLHUP)) || !client_flush(p_client))
+        client_close(p_client);
+}
+
+// Send a packet received from the device to the HCI clients that have enabled its opcode group
+static void hci_client_send_event(uint8_t *p_packet, uint32_t len)
+{
+    daemon_client_t *p_client;
+    uint8_t          group;
+    int              i;
+
+    for (i = 0; i < DAEMON_MAX_CLIENTS; i++)
+    {
+        if (((p_client = daemon_clients[i]) == NULL) || !p_client->is_hci)
+            continue;
+
+        // filter applies to WICED HCI events, other packets go to everyone
+        if ((p_packet[0] == HCI_WICED_PKT) && (len >= 5))
+        {
+            group = p_packet[2];
+            if (!(p_client->event_filter[group >> 3] & (1 << (group & 7))))
+                continue;
+        }
+        client_write(p_client, p_packet, len);
+        p_client->events++;
+        p_client->event_bytes += len;
+
+        if (!client_flush(p_client))
+            client_close(p_client);
+    }
+}
+
+static void hci_client_handler(daemon_source_t *p_source, uint32_t events)
+{
+    static uint8_t   packet[5 + 0xffff];
+    daemon_client_t *p_client = (daemon_client_t *)p_source;
+    uint32_t         len;
+    uint16_t         opcode;
+    int              bytes;
+
+    if (events & EPOLLIN)
+    {
+        if ((bytes = hci_rx_read(&p_client->hci_rx, p_source->fd, 1)) < 0)
+        {
+            Log("HCI client fd:%d disconnected", p_source->fd);
+            client_close(p_client);
+            return;
+        }
+        while ((len = hci_rx_frame(&p_client->hci_rx, packet)) != 0)
+        {
+            if (len == 1)
+                continue;
+
+            opcode = (packet[0] == HCI_WICED_PKT) ? packet[1] | (packet[2] << 8) : 0;
+            if (opcode == HCI_DAEMON_COMMAND_SET_EVENT_FILTER)
+            {
+                memset(p_client->event_filter, 0, sizeof(p_client->event_filter));
+                memcpy(p_client->event_filter, &packet[5], (len - 5 < sizeof(p_client->event_filter)) ? len - 5 : sizeof(p_client->event_filter));
+                continue;
+            }
+
+            // packets are written whole, so commands of different clients never interleave on the UART
+            p_client->commands++;
+            p_client->command_bytes += len;
+            uart_send(packet, len);
+        }
+    }
+    if ((events & (EPOLLERR | EPOLLHUP)) || !client_flush(p_client))
+        client_close(p_client);
+}
+
+static void listen_handler(daemon_source_t *p_source, uint32_t events)
+{
+    daemon_client_t *p_client;
+    int              fd, i;
+
+    if ((fd = accept4(p_source->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) < 0)
+        return;
+
+    for (i = 0; i < DAEMON_MAX_CLIENTS; i++)
+    {
+        if (daemon_clients[i] == NULL)
+            break;
+    }
+    if ((i == DAEMON_MAX_CLIENTS) ||
+        ((p_client = (daemon_client_t *)calloc(1, sizeof(daemon_client_t))) == NULL))
+    {
+        Log("control client rejected, too many clients");
+        close(fd);
+        return;
+    }
+    p_client->is_hci = (p_source != &listen_source);
+    if (p_client->is_hci)
+    {
+        // all events are sent until the client sets the filter
+        memset(p_client->event_filter, 0xff, sizeof(p_client->event_filter));
+        if (p_source == &hci_tcp_listen_source)
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &(int){ 1 }, sizeof(int));
+    }
+    if (((p_client->p_tx_buf = (char *)malloc(DAEMON_CLIENT_TX_MAX)) == NULL) ||
+        (p_client->is_hci && !hci_rx_init(&p_client->hci_rx)) ||
+        (daemon_source_add(&p_client->source, fd, EPOLLIN, p_client->is_hci ? hci_client_handler : client_handler) < 0))
+    {
+        free(p_client->hci_rx.p_ring);
+        free(p_client->p_tx_buf);
+        free(p_client);
+        close(fd);
+        return;
+    }
+    daemon_clients[i] = p_client;
+    Log("%s client fd:%d connected", p_client->is_hci ? "HCI" : "control", fd);
+}
+
+static int unix_socket_listen(const char *path)
+{
+    struct sockaddr_un addr;
+    int                fd;
+
+    if ((fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0)
+    {
+        Log("socket failed: %s", strerror(errno));
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    unlink(path);
+
+    if ((bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) || (listen(fd, 4) < 0))
+    {
+        Log("socket %s failed: %s", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// HCI over TCP is for the processes on the same machine, listen on the loopback only
+static int tcp_socket_listen(int port)
+{
+    struct sockaddr_in addr;
+    int                fd;
+
+    if ((fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0)
+    {
+        Log("socket failed: %s", strerror(errno));
+        return -1;
+    }
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &(int){ 1 }, sizeof(int));
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons((uint16_t)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if ((bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) || (listen(fd, 4) < 0))
+    {
+        Log("HCI TCP port %d failed: %s", port, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Connect to the HCI socket of the daemon that owns the UART, a number is a loopback TCP port
+static int hci_socket_connect(const char *spec)
+{
+    struct sockaddr_un  addr_un;
+    struct sockaddr_in  addr_in;
+    char               *p_end;
+    long                port = strtol(spec, &p_end, 10);
+    int                 fd, res;
+
+    if ((*p_end == 0) && (port > 0) && (port < 0x10000))
+    {
+        memset(&addr_in, 0, sizeof(addr_in));
+        addr_in.sin_family      = AF_INET;
+        addr_in.sin_port        = htons((uint16_t)port);
+        addr_in.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if ((fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0)) < 0)
+            return -1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &(int){ 1 }, sizeof(int));
+        res = connect(fd, (struct sockaddr *)&addr_in, sizeof(addr_in));
+    }
+    else
+    {
+        memset(&addr_un, 0, sizeof(addr_un));
+        addr_un.sun_family = AF_UNIX;
+        strncpy(addr_un.sun_path, spec, sizeof(addr_un.sun_path) - 1);
+        if ((fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) < 0)
+            return -1;
+        res = connect(fd, (struct sockaddr *)&addr_un, sizeof(addr_un));
+    }
+    if (res < 0)
+    {
+        Log("Error connecting to HCI socket %s: %s", spec, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    Log("Connected to HCI socket %s", spec);
+    return fd;
+}
+
+// Ask the owner of the UART to send only events of the listed groups, e.g. "0x16,0x2d"
+static int hci_socket_set_event_filter(const char *groups)
+{
+    uint8_t filter[32];
+    char   *p_end;
+    long    group;
+
+    memset(filter, 0, sizeof(filter));
+    while (*groups != 0)
+    {
+        group = strtol(groups, &p_end, 0);
+        if ((p_end == groups) || (group < 0) || (group > 0xff))
+            return 0;
+        filter[group >> 3] |= 1 << (group & 7);
+        groups = (*p_end == ',') ? p_end + 1 : p_end;
+    }
+    return wiced_hci_send(HCI_DAEMON_COMMAND_SET_EVENT_FILTER, filter, sizeof(filter));
+}
+
+static void signal_handler(daemon_source_t *p_source, uint32_t events)
+{
+    struct signalfd_siginfo info;
+
+    if (read(p_source->fd, &info, sizeof(info)) == sizeof(info))
+    {
+        Log("signal %d, exiting", info.ssi_signo);
+        daemon_running = 0;
+    }
+}
+
+static void timer_handler(daemon_source_t *p_source, uint32_t events)
+{
+    linux_timer_process();
+}
+
+/******************************************************************************
+ * Mesh client library callbacks
+ ******************************************************************************/
+static void unprovisioned_device(uint8_t *p_uuid, uint16_t oob, uint8_t *name, uint8_t name_len)
+{
+    char uuid[33];
+    int  i;
+
+    for (i = 0; i < 16; i++)
+        sprintf(&uuid[i * 2], "%02x", p_uuid[i]);
+    daemon_broadcast("EVT unprovisioned %s %04x \"%.*s\"\n", uuid, oob, name_len, name != NULL ? (char *)name : "");
+}
+
+static void provision_status(uint8_t status, uint8_t *p_uuid)
+{
+    daemon_broadcast("EVT provision %d\n", status);
+}
+
+static void link_status(uint8_t is_connected, uint32_t conn_id, uint16_t addr, uint8_t is_over_gatt)
+{
+    daemon_broadcast("EVT link %d %u %04x %d\n", is_connected, conn_id, addr, is_over_gatt);
+}
+
+static void node_connect_status(uint8_t status, char *p_device_name)
+{
+    daemon_broadcast("EVT node \"%s\" %d\n", p_device_name, status);
+}
+
+static void database_changed(char *mesh_name)
+{
+    daemon_broadcast("EVT database \"%s\"\n", mesh_name);
+}
+
+static void onoff_status(const char *device_name, uint8_t target, uint8_t present, uint32_t remaining_time)
+{
+    daemon_broadcast("EVT onoff \"%s\" %d %d %u\n", device_name, present, target, remaining_time);
+}
+
+static void level_status(const char *device_name, int16_t target, int16_t present, uint32_t remaining_time)
+{
+    daemon_broadcast("EVT level \"%s\" %d %d %u\n", device_name, present, target, remaining_time);
+}
+
+static void lightness_status(const char *device_name, uint16_t target, uint16_t present, uint32_t remaining_time)
+{
+    daemon_broadcast("EVT lightness \"%s\" %u %u %u\n", device_name, present, target, remaining_time);
+}
+
+static void hsl_status(const char *device_name, uint16_t lightness, uint16_t hue, uint16_t saturation, uint32_t remaining_time)
+{
+    daemon_broadcast("EVT hsl \"%s\" %u %u %u %u\n", device_name, lightness, hue, saturation, remaining_time);
+}
+
+static void ctl_status(const char *device_name, uint16_t present_lightness, uint16_t present_temperature, uint16_t target_lightness, uint16_t target_temperature, uint32_t remaining_time)
+{
+    daemon_broadcast("EVT ctl \"%s\" %u %u %u %u %u\n", device_name, present_lightness, present_temperature, target_lightness, target_temperature, remaining_time);
+}
+
+static void sensor_status(const char *device_name, int property_id, uint8_t length, uint8_t *value)
+{
+    char hex[2 * 255 + 1];
+    int  i;
+
+    for (i = 0; i < length; i++)
+        sprintf(&hex[i * 2], "%02x", value[i]);
+    hex[i * 2] = 0;
+    daemon_broadcast("EVT sensor \"%s\" %04x %s\n", device_name, property_id, hex);
+}
+
+static mesh_client_init_t mesh_client_init_callbacks =
+{
+    unprovisioned_device,
+    provision_status,
+    link_status,
+    node_connect_status,
+    database_changed,
+    onoff_status,
+    level_status,
+    lightness_status,
+    hsl_status,
+    ctl_status,
+    sensor_status,
+};
+
+void wiced_bt_mesh_gatt_client_connection_state_changed(uint16_t conn_id, uint16_t mtu)
+{
+}
+
+void wiced_bt_mesh_remote_provisioning_connection_state_changed(uint16_t conn_id, uint16_t reason)
+{
+}
+
+/******************************************************************************
+ * main
+ ******************************************************************************/
+// Use machine id as the provisioner UUID so that the daemon is the same provisioner after restart
+static void provisioner_uuid_default(void)
+{
+    FILE *fp = fopen("/etc/machine-id", "r");
+    int   i;
+
+    if ((fp == NULL) || (fscanf(fp, "%32s", provisioner_uuid) != 1) || (strlen(provisioner_uuid) != 32))
+    {
+        srand((unsigned int)time(NULL));
+        for (i = 0; i < 16; i++)
+            sprintf(&provisioner_uuid[i * 2], "%02x", rand() & 0xff);
+        Log("No machine id, random provisioner UUID %s", provisioner_uuid);
+    }
+    if (fp != NULL)
+        fclose(fp);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s -d <device> | -c <path|port> [options]\n"
+                    "  -d <device>     UART connected to the embedded mesh app, e.g. /dev/ttyUSB0\n"
+                    "  -a <device>     UART of another device joined to the network as a separate provisioner node,\n"
+                    "                  commands to the models are spread between the devices, up to %d times\n"
+                    "  -b <baud>       UART baud rate, default %d\n"
+                    "  -c <path|port>  use the HCI socket of another daemon instead of the UART\n"
+                    "  -g <groups>     with -c, receive only events of the listed opcode groups, e.g. 0x00,0x16,0x2d\n"
+                    "  -H <path>       share the UART with other processes on the HCI Unix domain socket\n"
+                    "  -t <port>       share the UART with other processes on the HCI loopback TCP port\n"
+                    "  -w <window>     send up to window commands before the device reports their status\n"
+                    "  -B <bytes>      batch packets sent to the UART, write when the batch reaches the size (up to %d)\n"
+                    "  -T <usec>       with -B, write the batch at most usec after the first packet, by default\n"
+                    "                  the batch is written when the loop is done with the current events\n"
+                    "  -s <path>       control socket, default %s\n"
+                    "  -p <name>       provisioner name, default %s\n"
+                    "  -u <uuid>       provisioner UUID, 32 hex digits, default is the machine id\n"
+                    "  -r <file>       record HCI packets to the capture file\n"
+                    "  -l <file>       append traces to the file instead of stderr\n"
+                    "  -v              verbose library traces\n",
+            prog, MESH_CLIENT_HCI_MAX_TRANSPORTS - 1, DAEMON_DEFAULT_BAUD_RATE, UART_TX_BATCH_MAX, DAEMON_DEFAULT_SOCKET, DAEMON_DEFAULT_PROVISIONER);
+}
+
+int main(int argc, char **argv)
+{
+    struct epoll_event  events[DAEMON_MAX_EPOLL_EVENTS];
+    daemon_source_t    *p_source;
+    const char         *device = NULL;
+    const char         *hci_socket = NULL;
+    const char         *event_groups = NULL;
+    int                 hci_tcp_port = 0;
+    int                 tx_window = 0;
+    int                 baud_rate = DAEMON_DEFAULT_BAUD_RATE;
+    uint8_t             uuid[16];
+    sigset_t            mask;
+    int                 fd, num, i, opt;
+
+    while ((opt = getopt(argc, argv, "d:a:b:c:g:H:t:w:B:T:s:p:u:r:l:vh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'd': device = optarg;                  break;
+        case 'a':
+            if (num_extra_uarts == MESH_CLIENT_HCI_MAX_TRANSPORTS - 1)
+            {
+                fprintf(stderr, "Too many devices\n");
+                return 1;
+            }
+            extra_uarts[num_extra_uarts++].device = optarg;
+            break;
+        case 'b': baud_rate = atoi(optarg);         break;
+        case 'c': hci_socket = optarg;              break;
+        case 'g': event_groups = optarg;            break;
+        case 'H': hci_socket_path = optarg;         break;
+        case 't': hci_tcp_port = atoi(optarg);      break;
+        case 'w': tx_window = atoi(optarg);         break;
+        case 'B': uart_tx_batch_threshold = (uint32_t)atoi(optarg);    break;
+        case 'T': uart_tx_batch_delay_us = (uint32_t)atoi(optarg);     break;
+        case 's': socket_path = optarg;             break;
+        case 'p': provisioner_name = optarg;        break;
+        case 'u':
+            if (!hex_to_uuid(optarg, uuid))
+            {
+                fprintf(stderr, "UUID shall be 32 hex digits\n");
+                return 1;
+            }
+            strcpy(provisioner_uuid, optarg);
+            break;
+        case 'r':
+            if (!hci_capture_start(optarg))
+            {
+                perror(optarg);
+                return 1;
+            }
+            break;
+        case 'l':
+            if ((log_fp = fopen(optarg, "a")) == NULL)
+            {
+                perror(optarg);
+                return 1;
+            }
+            break;
+        case 'v': verbose = 1;                      break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (((device == NULL) == (hci_socket == NULL)) || (uart_tx_batch_threshold > UART_TX_BATCH_MAX))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+    if (provisioner_uuid[0] == 0)
+        provisioner_uuid_default();
+
+    uart_source.fd = -1;
+    if (!hci_rx_init(&uart_rx))
+        return 1;
+    if ((epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0)
+    {
+        perror("epoll_create1");
+        return 1;
+    }
+
+    // signals are delivered through the loop, so that the network is closed from the loop thread
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigprocmask(SIG_BLOCK, &mask, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    if (((fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC)) < 0) ||
+        (daemon_source_add(&signal_source, fd, EPOLLIN, signal_handler) < 0))
+        return 1;
+
+    if (((fd = linux_timer_init()) < 0) ||
+        (daemon_source_add(&timer_source, fd, EPOLLIN, timer_handler) < 0))
+        return 1;
+
+    uart_tx_timer_source.fd = -1;
+    if ((uart_tx_batch_threshold != 0) && (uart_tx_batch_delay_us != 0) &&
+        (((fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0) ||
+         (daemon_source_add(&uart_tx_timer_source, fd, EPOLLIN, uart_tx_timer_handler) < 0)))
+        return 1;
+    if (uart_tx_batch_threshold == 0)
+        uart_tx_batch_delay_us = 0;
+    uart_tx_batch_init(&uart_source, &uart_tx, uart_tx_batch_threshold, uart_tx_timer_source.fd, uart_tx_batch_delay_us);
+
+    uart_is_socket = (hci_socket != NULL);
+    if (((fd = (device != NULL) ? uart_open(device, baud_rate) : hci_socket_connect(hci_socket)) < 0) ||
+        (daemon_source_add(&uart_source, fd, EPOLLIN, uart_handler) < 0))
+        return 1;
+
+    if ((hci_socket != NULL) && (event_groups != NULL) && !hci_socket_set_event_filter(event_groups))
+    {
+        fprintf(stderr, "Bad list of opcode groups %s\n", event_groups);
+        return 1;
+    }
+
+    if (((fd = unix_socket_listen(socket_path)) < 0) ||
+        (daemon_source_add(&listen_source, fd, EPOLLIN, listen_handler) < 0))
+        return 1;
+
+    hci_listen_source.fd = hci_tcp_listen_source.fd = -1;
+    if ((hci_socket_path != NULL) &&
+        (((fd = unix_socket_listen(hci_socket_path)) < 0) ||
+         (daemon_source_add(&hci_listen_source, fd, EPOLLIN, listen_handler) < 0)))
+        return 1;
+
+    if ((hci_tcp_port != 0) &&
+        (((fd = tcp_socket_listen(hci_tcp_port)) < 0) ||
+         (daemon_source_add(&hci_tcp_listen_source, fd, EPOLLIN, listen_handler) < 0)))
+        return 1;
+
+    mesh_client_init(&mesh_client_init_callbacks);
+
+    for (i = 0; i < num_extra_uarts; i++)
+    {
+        if (!hci_rx_init(&extra_uarts[i].rx) ||
+            ((fd = uart_open(extra_uarts[i].device, baud_rate)) < 0) ||
+            (daemon_source_add(&extra_uarts[i].source, fd, EPOLLIN, extra_uart_handler) < 0) ||
+            (mesh_client_hci_transport_add(extra_uart_send, &extra_uarts[i].transport) != MESH_CLIENT_SUCCESS))
+            return 1;
+    }
+
+    if ((tx_window != 0) && (mesh_client_hci_tx_configure((uint16_t)tx_window, 0) != MESH_CLIENT_SUCCESS))
+    {
+        fprintf(stderr, "Bad command window %d\n", tx_window);
+        return 1;
+    }
+
+    Log("mesh daemon started, provisioner %s UUID %s, control socket %s", provisioner_name, provisioner_uuid, socket_path);
+
+    while (daemon_running)
+    {
+        num = epoll_wait(epoll_fd, events, DAEMON_MAX_EPOLL_EVENTS, -1);
+        if (num < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            Log("epoll_wait failed: %s", strerror(errno));
+            break;
+        }
+        for (i = 0; i < num && daemon_running; i++)
+        {
+            p_source = (daemon_source_t *)events[i].data.ptr;
+            if (p_source->p_handler != NULL)
+                p_source->p_handler(p_source, events[i].events);
+        }
+        if (uart_tx_batch_delay_us == 0)
+            uart_tx_flush();
+        client_free_closed();
+    }
+
+    mesh_client_network_close();
+    uart_tx_flush();
+    hci_capture_stop();
+
+    for (i = 0; i < DAEMON_MAX_CLIENTS; i++)
+    {
+        if (daemon_clients[i] != NULL)
+            client_close(daemon_clients[i]);
+    }
+    client_free_closed();
+    close(listen_source.fd);
+    unlink(socket_path);
+    if (hci_listen_source.fd >= 0)
+    {
+        close(hci_listen_source.fd);
+        unlink(hci_socket_path);
+    }
+    if (hci_tcp_listen_source.fd >= 0)
+        close(hci_tcp_listen_source.fd);
+    close(uart_source.fd);
+    for (i = 0; i < num_extra_uarts; i++)
+    {
+        if (extra_uarts[i].source.fd >= 0)
+            close(extra_uarts[i].source.fd);
+    }
+    if (uart_tx_timer_source.fd >= 0)
+        close(uart_tx_timer_source.fd);
+    close(timer_source.fd);
+    close(signal_source.fd);
+    close(epoll_fd);
+
+    if (log_fp != NULL)
+        fclose(log_fp);
+    return 0;
+}
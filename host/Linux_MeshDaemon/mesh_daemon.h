@@ -0,0 +1,186 @@
+/*
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+*
+* Headless Linux host definitions
+*/
+
+#ifndef MESH_DAEMON_H
+#define MESH_DAEMON_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "wiced_timer_linux.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Commands of this group are handled by the daemon that owns the UART and are not sent to the device.
+ */
+#define HCI_DAEMON_GROUP                        0xFE
+
+/*
+ * Sent by the HCI socket client to select the events it receives. The payload is a 32 byte bitmap,
+ * bit (group & 7) of byte (group >> 3) enables events of the opcode group. A new client receives all events.
+ */
+#define HCI_DAEMON_COMMAND_SET_EVENT_FILTER     ((HCI_DAEMON_GROUP << 8) | 0x01)
+
+/*
+ * HCI capture file. The file starts with HCI_CAPTURE_MAGIC followed by records, each record is
+ * an HCI_CAPTURE_RECORD_HEADER_LEN byte header and the packet exactly as sent over the UART, starting
+ * with the packet type. The header holds the time since the start of the capture in microseconds (8 bytes),
+ * the direction (1 byte) and the packet length (4 bytes), all little endian.
+ */
+#define HCI_CAPTURE_MAGIC                       "MESHHCI1"
+#define HCI_CAPTURE_MAGIC_LEN                   8
+#define HCI_CAPTURE_RECORD_HEADER_LEN           13
+
+#define HCI_CAPTURE_DIR_HOST_TO_DEVICE          0
+#define HCI_CAPTURE_DIR_DEVICE_TO_HOST          1
+
+typedef struct
+{
+    uint64_t time_us;
+    uint8_t  direction;
+    uint32_t len;
+} hci_capture_record_t;
+
+/*
+ * Create the capture file, returns 0 on failure. Packets are appended with hci_capture_write until
+ * hci_capture_stop is called.
+ */
+int hci_capture_start(const char *path);
+
+/*
+ * Append the packet to the capture file, does nothing if the capture is not started
+ */
+void hci_capture_write(uint8_t direction, const uint8_t *p_packet, uint32_t len);
+
+/*
+ * Write the buffered packets to the capture file, the capture continues
+ */
+void hci_capture_flush(void);
+
+void hci_capture_stop(void);
+
+/*
+ * Open the capture file for reading, returns NULL if the file can not be opened or is not a capture.
+ */
+FILE *hci_capture_open(const char *path);
+
+/*
+ * Read the next record to p_packet, returns 0 at the end of the file or if the packet is longer than max_len.
+ */
+int hci_capture_read(FILE *fp, hci_capture_record_t *p_record, uint8_t *p_packet, uint32_t max_len);
+
+/*
+ * Everything the daemon registers with epoll starts with the source, epoll_event.data.ptr points to it.
+ */
+typedef struct daemon_source_s daemon_source_t;
+typedef void (*daemon_source_handler_t)(daemon_source_t *p_source, uint32_t events);
+
+struct daemon_source_s
+{
+    int                     fd;
+    daemon_source_handler_t p_handler;
+};
+
+/*
+ * Change the epoll events of the source
+ */
+void daemon_source_modify(daemon_source_t *p_source, uint32_t events);
+
+/*
+ * UART transmit. The UART is non-blocking, bytes the driver does not take are queued behind the earlier
+ * writes and sent with uart_tx_drain when the UART reports EPOLLOUT, which is enabled while the queue
+ * is not empty.
+ */
+#define UART_TX_BATCH_MAX           0x4000
+#define UART_TX_QUEUE_MAX           0x40000     /* packets are dropped when the UART falls this much behind */
+
+typedef struct
+{
+    uint8_t    *p_buf;                      /* allocated the first time the driver is full */
+    uint32_t    len;
+    uint8_t     waiting;                    /* EPOLLOUT is enabled */
+} uart_tx_queue_t;
+
+typedef struct
+{
+    uint32_t writes;                        /* writes of the batch or of a single packet */
+    uint32_t packets;
+    uint64_t bytes;
+    uint32_t max_queued;                    /* most bytes waiting for EPOLLOUT in any queue */
+} uart_tx_stats_t;
+
+/*
+ * Write the buffer to the UART or queue it. Returns 0 if the UART failed or the queue is full.
+ */
+int uart_write(daemon_source_t *p_uart, uart_tx_queue_t *p_tx, const uint8_t *p_data, uint32_t len);
+
+/*
+ * Write the queued bytes, returns 0 if the UART failed
+ */
+int uart_tx_drain(daemon_source_t *p_uart, uart_tx_queue_t *p_tx);
+
+/*
+ * Set up batching of the packets sent with uart_send. Threshold 0 disables batching. If timer_fd is a
+ * timerfd, it is armed for delay_us when the first packet is added to the batch and the owner calls
+ * uart_tx_flush when it expires, otherwise the owner calls uart_tx_flush when it is done with the current events.
+ */
+void uart_tx_batch_init(daemon_source_t *p_uart, uart_tx_queue_t *p_tx, uint32_t threshold, int timer_fd, uint32_t delay_us);
+
+/*
+ * Send the packet to the UART, or add it to the batch. The batch is written when it reaches the threshold.
+ */
+int uart_send(const uint8_t *p_packet, uint32_t len);
+
+/*
+ * Write the batch, returns 0 if the UART failed
+ */
+int uart_tx_flush(void);
+
+void uart_tx_stats_get(uart_tx_stats_t *p_stats);
+
+void Log(char *fmt, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
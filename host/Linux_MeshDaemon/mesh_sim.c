@@ -0,0 +1,1673 @@
+/*
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+*
+* Simulated embedded mesh app for load testing the hosts without radios. The simulator opens a
+* pseudo-terminal and answers the WICED HCI mesh commands received on it the way the embedded
+* provisioner app does, with the same HCI_CONTROL_MESH_EVENT_XXX events. The host is started with
+* the slave side of the pty as its UART, for example
+*     mesh_sim -n 1000 -L 30 -x 2 -l /tmp/mesh_sim
+*     mesh_daemon -d /tmp/mesh_sim
+*
+* The mesh is made of the local device (configured by the host with Set Local Device) and a number of
+* virtual lights that start unprovisioned. The local device is a Remote Provisioning Server, scans report
+* every unprovisioned light, and the lights can be provisioned, configured and controlled with the
+* Generic OnOff, Generic Level and Light Lightness models, individually or through group subscriptions.
+* Replies of the lights are delayed by the configured latency and jitter and a configured percentage of
+* the transmissions is lost. Messages are retransmitted as requested by the host and when all transmissions
+* of an acknowledged message are lost the Tx Complete event reports the failure after the reply timeout of the
+* message, the same way the firmware does after giving up on retransmissions.
+*
+* With -r the simulator has several radios, each one a local device on its own pty, for hosts that drive more
+* than one device. Every radio hears the lights with a different RSSI. Scanning, provisioning and proxy are only
+* supported on the first radio.
+*
+* Statistics are printed on SIGUSR1 and on exit.
+*/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+
+#include "wiced_bt_ble.h"
+#include "wiced_bt_mesh_event.h"
+#include "wiced_bt_mesh_core.h"
+#include "wiced_bt_mesh_model_defs.h"
+#include "hci_control_api.h"
+
+#define SIM_DEFAULT_NODES               100
+#define SIM_DEFAULT_LATENCY_MS          20
+#define SIM_DEFAULT_JITTER_MS           10
+#define SIM_DEFAULT_PROVISION_MS        500
+#define SIM_DEFAULT_REPLY_TIMEOUT_MS    5000        /* used when the message does not set the reply timeout */
+#define SIM_LOCAL_LATENCY_US            1000        /* replies of the local device */
+#define SIM_SCAN_REPORT_INTERVAL_US     1000        /* time between two scan reports */
+#define SIM_MAX_NODES                   0x7000
+#define SIM_MAX_RADIOS                  8
+
+#define SIM_EVENT_MAX                   (5 + 128)   /* largest HCI event generated by the simulator */
+#define SIM_CMD_HEADER_LEN              11          /* see wiced_bt_mesh_format_hci_header */
+#define SIM_EVENT_HEADER_LEN            13          /* see wiced_bt_mesh_event_from_hci_header */
+#define SIM_NODE_MAX_GROUPS             8
+#define SIM_RX_BUF_SIZE                 (5 + 0xffff)
+#define SIM_TX_BUF_SIZE                 0x100000
+#define SIM_MAX_EPOLL_EVENTS            8
+
+// UUID of the virtual light with index n is SIM_UUID_PREFIX followed by n, big endian
+static const uint8_t sim_uuid_prefix[12] = { 0x51, 0x4d, 0x53, 0x49, 0x4d, 0x2d, 0x4c, 0x49, 0x47, 0x48, 0x54, 0x2d };
+
+typedef struct
+{
+    uint16_t addr;                              /* unicast address, 0 while the node is not provisioned */
+    uint8_t  onoff;
+    int16_t  level;
+    uint16_t lightness;
+    uint32_t def_trans_time;                    /* default transition time in milliseconds */
+    uint8_t  num_groups;
+    uint16_t groups[SIM_NODE_MAX_GROUPS];       /* subscriptions, same for all models */
+} sim_node_t;
+
+// parameters of the HCI header that precedes most mesh commands
+typedef struct
+{
+    uint16_t dst;
+    uint16_t app_key_idx;
+    uint8_t  element_idx;
+    uint8_t  reliable;
+    uint8_t  ttl;
+    uint8_t  retrans_cnt;
+    uint8_t  retrans_time;                      /* 50 millisecond units */
+    uint8_t  reply_timeout;                     /* 50 millisecond units */
+} sim_cmd_header_t;
+
+typedef struct sim_event_s
+{
+    uint64_t             due_us;
+    uint32_t             seq;                   /* keeps events due at the same time in the order they were queued */
+    uint32_t             scan_id;               /* scan the report belongs to, 0 for other events */
+    uint16_t             len;                   /* length of the HCI packet in data */
+    uint8_t              radio;                 /* radio the event is sent on */
+    uint8_t              data[SIM_EVENT_MAX];
+    struct sim_event_s  *p_next;                /* free list */
+} sim_event_t;
+
+/*
+ * Message handled by the nodes. The handler gets the parameters that follow the HCI header and returns
+ * the length of the status it wrote to p_reply, or -1 if the node does not support the message.
+ */
+typedef int (*sim_node_handler_t)(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply);
+
+#define SIM_CMD_FLAG_ACKED              0x01    /* always answered, otherwise only if sent as reliable */
+#define SIM_CMD_FLAG_UNICAST            0x02    /* can not be sent to a group */
+
+typedef struct
+{
+    uint16_t            hci_opcode;             /* HCI_CONTROL_MESH_COMMAND_XXX */
+    uint16_t            event_opcode;           /* HCI_CONTROL_MESH_EVENT_XXX of the status */
+    uint16_t            mesh_opcode;            /* opcode of the status message */
+    uint8_t             flags;                  /* SIM_CMD_FLAG_XXX */
+    uint8_t             min_len;                /* length of the parameters following the HCI header */
+    sim_node_handler_t  p_handler;
+} sim_model_cmd_t;
+
+// Commands handled by the local device itself, p_data points to the whole command payload
+typedef void (*sim_local_handler_t)(uint8_t *p_data, uint16_t len);
+
+typedef struct
+{
+    uint16_t            hci_opcode;
+    sim_local_handler_t p_handler;
+} sim_local_cmd_t;
+
+// Local device with its own pty
+typedef struct
+{
+    int         pty_fd;
+    int         pty_slave_fd;
+    char        link[256];
+    sim_node_t  local;
+    uint8_t     rx_buf[SIM_RX_BUF_SIZE];
+    uint32_t    rx_len;
+    uint8_t    *p_tx_buf;
+    uint32_t    tx_head;
+    uint32_t    tx_len;
+    int         tx_blocked;
+    uint64_t    commands;
+    uint64_t    events;
+} sim_radio_t;
+
+typedef struct
+{
+    uint64_t commands;
+    uint64_t command_bytes;
+    uint64_t events;
+    uint64_t event_bytes;
+    uint64_t lost;
+    uint64_t tx_failed;
+    uint64_t scan_reports;
+    uint64_t provisioned;
+    uint64_t unknown;
+    uint64_t writes;
+    uint32_t max_queue_depth;
+} sim_stats_t;
+
+static int              epoll_fd = -1;
+static int              timer_fd = -1;
+static int              signal_fd = -1;
+static volatile int     sim_running = 1;
+static int              verbose = 0;
+
+// nodes[0] is the local device, virtual lights are 1..num_nodes
+static sim_node_t      *sim_nodes;
+static uint32_t         sim_num_nodes = SIM_DEFAULT_NODES;
+static uint16_t         sim_addr_map[0x8000];   /* index of the node with the unicast address, 0 if none */
+static sim_node_t      *sim_local;             /* local device of the radio that received the command */
+static sim_radio_t      sim_radios[SIM_MAX_RADIOS];
+static uint32_t         sim_num_radios = 1;
+static uint8_t          sim_radio = 0;          /* radio that received the command */
+static uint16_t         sim_net_key_idx = 0;
+
+static uint32_t         sim_latency_us = SIM_DEFAULT_LATENCY_MS * 1000;
+static uint32_t         sim_jitter_us = SIM_DEFAULT_JITTER_MS * 1000;
+static uint32_t         sim_provision_us = SIM_DEFAULT_PROVISION_MS * 1000;
+static uint32_t         sim_loss_ppm = 0;       /* lost transmissions per million */
+static uint64_t         sim_random_state = 0x2545F4914F6CDD1DULL;
+
+// remote provisioning server of the local device
+static uint32_t         sim_scan_id = 0;        /* current scan, 0 if not scanning */
+static uint32_t         sim_scan_count = 0;
+static uint32_t         sim_prov_node = 0;      /* node on the provisioning link, 0 if there is no link */
+static uint16_t         sim_prov_addr = 0;
+static uint8_t          sim_prov_over_gatt = 0;
+
+// GATT proxy connection
+static uint32_t         sim_proxy_node = 0;     /* node the local device is connected to, 0 if not connected */
+static uint16_t         sim_proxy_filter_size = 0;
+
+// event queue, a binary heap ordered by the time the event is due
+static sim_event_t    **sim_queue;
+static uint32_t         sim_queue_len = 0;
+static uint32_t         sim_queue_size = 0;
+static sim_event_t     *sim_free_events = NULL;
+static uint32_t         sim_event_seq = 0;
+static uint64_t         sim_timer_due_us = 0;
+
+static sim_stats_t      sim_stats;
+
+/******************************************************************************
+ * Utilities
+ ******************************************************************************/
+static void sim_log(const char *fmt, ...)
+{
+    struct timespec ts;
+    va_list         args;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    fprintf(stderr, "%5ld.%03ld: ", (long)ts.tv_sec, ts.tv_nsec / 1000000);
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+static uint64_t sim_now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// xorshift64*, the simulation is repeatable for the same seed and the same host traffic
+static uint32_t sim_random(void)
+{
+    sim_random_state ^= sim_random_state >> 12;
+    sim_random_state ^= sim_random_state << 25;
+    sim_random_state ^= sim_random_state >> 27;
+    return (uint32_t)((sim_random_state * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+static int sim_lost(void)
+{
+    return (sim_loss_ppm != 0) && ((sim_random() % 1000000) < sim_loss_ppm);
+}
+
+static uint64_t sim_node_delay_us(const sim_node_t *p_node)
+{
+    if (p_node == sim_local)
+        return SIM_LOCAL_LATENCY_US;
+    return sim_latency_us + ((sim_jitter_us != 0) ? sim_random() % sim_jitter_us : 0);
+}
+
+static uint32_t sim_node_index(const sim_node_t *p_node)
+{
+    return (uint32_t)(p_node - sim_nodes);
+}
+
+static void sim_node_uuid(uint32_t index, uint8_t *p_uuid)
+{
+    memcpy(p_uuid, sim_uuid_prefix, sizeof(sim_uuid_prefix));
+    p_uuid[12] = (uint8_t)(index >> 24);
+    p_uuid[13] = (uint8_t)(index >> 16);
+    p_uuid[14] = (uint8_t)(index >> 8);
+    p_uuid[15] = (uint8_t)index;
+}
+
+// Returns index of the virtual light with the UUID, 0 if there is none
+static uint32_t sim_node_by_uuid(const uint8_t *p_uuid)
+{
+    uint32_t index;
+
+    if (memcmp(p_uuid, sim_uuid_prefix, sizeof(sim_uuid_prefix)) != 0)
+        return 0;
+    index = ((uint32_t)p_uuid[12] << 24) | ((uint32_t)p_uuid[13] << 16) | ((uint32_t)p_uuid[14] << 8) | p_uuid[15];
+    return ((index != 0) && (index <= sim_num_nodes)) ? index : 0;
+}
+
+static sim_node_t *sim_node_by_addr(uint16_t addr)
+{
+    if ((addr == 0) || (addr >= 0x8000) || (sim_addr_map[addr] == 0))
+        return NULL;
+    return &sim_nodes[sim_addr_map[addr]];
+}
+
+static void sim_node_set_addr(sim_node_t *p_node, uint16_t addr)
+{
+    // local devices are not in the address map, they are found through their radios
+    if (p_node == sim_local)
+    {
+        p_node->addr = addr;
+        return;
+    }
+    if ((p_node->addr != 0) && (sim_addr_map[p_node->addr] == sim_node_index(p_node)))
+        sim_addr_map[p_node->addr] = 0;
+
+    p_node->addr = addr;
+    if ((addr != 0) && (addr < 0x8000))
+        sim_addr_map[addr] = (uint16_t)sim_node_index(p_node);
+}
+
+static int sim_node_subscribed(const sim_node_t *p_node, uint16_t addr)
+{
+    int i;
+
+    for (i = 0; i < p_node->num_groups; i++)
+    {
+        if (p_node->groups[i] == addr)
+            return 1;
+    }
+    return 0;
+}
+
+static uint16_t sim_read16(const uint8_t *p)
+{
+    return p[0] | ((uint16_t)p[1] << 8);
+}
+
+static uint8_t *sim_write16(uint8_t *p, uint16_t value)
+{
+    *p++ = value & 0xff;
+    *p++ = (value >> 8) & 0xff;
+    return p;
+}
+
+static uint8_t *sim_write32(uint8_t *p, uint32_t value)
+{
+    p = sim_write16(p, (uint16_t)value);
+    return sim_write16(p, (uint16_t)(value >> 16));
+}
+
+/******************************************************************************
+ * Event queue
+ ******************************************************************************/
+static int sim_event_before(const sim_event_t *p_a, const sim_event_t *p_b)
+{
+    if (p_a->due_us != p_b->due_us)
+        return p_a->due_us < p_b->due_us;
+    return (int32_t)(p_a->seq - p_b->seq) < 0;
+}
+
+static void sim_timer_arm(void)
+{
+    struct itimerspec its;
+    uint64_t          due_us = (sim_queue_len != 0) ? sim_queue[0]->due_us : 0;
+
+    // while the pty is full the events wait for EPOLLOUT instead of the timer
+    if ((due_us != 0) && sim_radios[sim_queue[0]->radio].tx_blocked)
+        due_us = 0;
+
+    if (due_us == sim_timer_due_us)
+        return;
+    sim_timer_due_us = due_us;
+
+    memset(&its, 0, sizeof(its));
+    if (due_us != 0)
+    {
+        its.it_value.tv_sec  = due_us / 1000000;
+        its.it_value.tv_nsec = (due_us % 1000000) * 1000;
+        // zero disarms the timer, an event that is already due still needs to fire
+        if ((its.it_value.tv_sec == 0) && (its.it_value.tv_nsec == 0))
+            its.it_value.tv_nsec = 1;
+    }
+    timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+static sim_event_t *sim_event_alloc(void)
+{
+    sim_event_t *p_event = sim_free_events;
+
+    if (p_event != NULL)
+        sim_free_events = p_event->p_next;
+    else if ((p_event = (sim_event_t *)malloc(sizeof(sim_event_t))) == NULL)
+    {
+        sim_log("out of memory");
+        exit(1);
+    }
+    p_event->scan_id = 0;
+    p_event->len     = 0;
+    p_event->radio   = sim_radio;
+    return p_event;
+}
+
+static void sim_event_free(sim_event_t *p_event)
+{
+    p_event->p_next = sim_free_events;
+    sim_free_events = p_event;
+}
+
+static void sim_event_queue(sim_event_t *p_event, uint64_t delay_us)
+{
+    uint32_t     i, parent;
+    sim_event_t **p_new;
+
+    if (sim_queue_len == sim_queue_size)
+    {
+        uint32_t size = (sim_queue_size == 0) ? 1024 : sim_queue_size * 2;
+        if ((p_new = (sim_event_t **)realloc(sim_queue, size * sizeof(sim_event_t *))) == NULL)
+        {
+            sim_log("out of memory");
+            exit(1);
+        }
+        sim_queue      = p_new;
+        sim_queue_size = size;
+    }
+    p_event->due_us = sim_now_us() + delay_us;
+    p_event->seq    = sim_event_seq++;
+
+    for (i = sim_queue_len++; i != 0; i = parent)
+    {
+        parent = (i - 1) / 2;
+        if (!sim_event_before(p_event, sim_queue[parent]))
+            break;
+        sim_queue[i] = sim_queue[parent];
+    }
+    sim_queue[i] = p_event;
+
+    if (sim_queue_len > sim_stats.max_queue_depth)
+        sim_stats.max_queue_depth = sim_queue_len;
+}
+
+static sim_event_t *sim_event_pop(void)
+{
+    sim_event_t *p_top = sim_queue[0];
+    sim_event_t *p_last = sim_queue[--sim_queue_len];
+    uint32_t     i = 0, child;
+
+    while ((child = 2 * i + 1) < sim_queue_len)
+    {
+        if ((child + 1 < sim_queue_len) && sim_event_before(sim_queue[child + 1], sim_queue[child]))
+            child++;
+        if (!sim_event_before(sim_queue[child], p_last))
+            break;
+        sim_queue[i] = sim_queue[child];
+        i = child;
+    }
+    if (sim_queue_len != 0)
+        sim_queue[i] = p_last;
+    return p_top;
+}
+
+// Start an HCI event, returns pointer to the parameters
+static uint8_t *sim_event_start(sim_event_t *p_event, uint16_t opcode)
+{
+    p_event->data[0] = HCI_WICED_PKT;
+    sim_write16(&p_event->data[1], opcode);
+    return &p_event->data[5];
+}
+
+// With several radios each one is at its own distance from a light, the RSSI only varies a little
+static uint8_t sim_rssi(uint16_t src)
+{
+    sim_node_t *p_node = sim_node_by_addr(src);
+
+    if ((sim_num_radios == 1) || (p_node == NULL))
+        return (uint8_t)(-40 - (int)(sim_random() % 40));
+    return (uint8_t)(-40 - (int)((sim_node_index(p_node) * 37 + sim_radio * 53) % 40) - (int)(sim_random() % 3));
+}
+
+// Write the mesh event header that precedes the status of most mesh events
+static uint8_t *sim_event_mesh_header(uint8_t *p, uint16_t src, uint16_t dst, uint16_t app_key_idx, uint16_t company_id, uint16_t mesh_opcode)
+{
+    p = sim_write16(p, src);
+    p = sim_write16(p, dst);
+    p = sim_write16(p, app_key_idx);
+    *p++ = 0;                                   /* element index */
+    *p++ = sim_rssi(src);
+    *p++ = 0x3f;                                /* received ttl */
+    p = sim_write16(p, company_id);
+    return sim_write16(p, mesh_opcode);
+}
+
+static void sim_event_finish(sim_event_t *p_event, uint8_t *p_end, uint64_t delay_us)
+{
+    uint16_t param_len = (uint16_t)(p_end - &p_event->data[5]);
+
+    sim_write16(&p_event->data[3], param_len);
+    p_event->len = param_len + 5;
+    sim_event_queue(p_event, delay_us);
+}
+
+/******************************************************************************
+ * pty
+ ******************************************************************************/
+static void sim_trace_packet(const char *p_dir, const uint8_t *p_packet, uint32_t len)
+{
+    char     buf[3 * 32 + 1];
+    uint32_t i;
+
+    for (i = 0; (i < len - 5) && (i < 32); i++)
+        sprintf(&buf[3 * i], "%02x ", p_packet[5 + i]);
+    buf[3 * i] = 0;
+    sim_log("%s %04x len:%u %s%s", p_dir, sim_read16(&p_packet[1]), len - 5, buf, (len - 5 > 32) ? "..." : "");
+}
+
+static int sim_tx_flush(sim_radio_t *p_radio)
+{
+    ssize_t written;
+
+    while (p_radio->tx_len != 0)
+    {
+        written = write(p_radio->pty_fd, &p_radio->p_tx_buf[p_radio->tx_head], p_radio->tx_len);
+        if (written <= 0)
+        {
+            if ((written < 0) && (errno != EAGAIN) && (errno != EINTR))
+            {
+                sim_log("pty write failed: %s", strerror(errno));
+                p_radio->tx_head = p_radio->tx_len = 0;
+                return 1;
+            }
+            return 0;
+        }
+        sim_stats.writes++;
+        p_radio->tx_head += (uint32_t)written;
+        p_radio->tx_len  -= (uint32_t)written;
+    }
+    p_radio->tx_head = 0;
+    return 1;
+}
+
+static void sim_tx_set_blocked(sim_radio_t *p_radio, int blocked)
+{
+    struct epoll_event ev;
+
+    if (blocked == p_radio->tx_blocked)
+        return;
+    p_radio->tx_blocked = blocked;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events  = EPOLLIN | (blocked ? EPOLLOUT : 0);
+    ev.data.fd = p_radio->pty_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, p_radio->pty_fd, &ev);
+}
+
+static int sim_event_is_stale(const sim_event_t *p_event)
+{
+    // scan reports still in the queue when the scan is stopped are not sent
+    return (p_event->scan_id != 0) && (p_event->scan_id != sim_scan_id);
+}
+
+// Move the events that are due to the ptys. Events are appended to the tx buffer of the radio and written
+// with one write call. If the pty can not take them the rest stays in the queue until the host catches up.
+static void sim_send_due_events(void)
+{
+    uint64_t     now = sim_now_us();
+    sim_radio_t *p_radio;
+    sim_event_t *p_event;
+    uint32_t     i;
+
+    for (i = 0; i < sim_num_radios; i++)
+        sim_tx_set_blocked(&sim_radios[i], !sim_tx_flush(&sim_radios[i]));
+
+    while ((sim_queue_len != 0) && (sim_queue[0]->due_us <= now))
+    {
+        p_radio = &sim_radios[sim_queue[0]->radio];
+        if (p_radio->tx_blocked)
+            break;
+        if (p_radio->tx_head + p_radio->tx_len + SIM_EVENT_MAX > SIM_TX_BUF_SIZE)
+        {
+            if (!sim_tx_flush(p_radio))
+                break;
+        }
+        p_event = sim_event_pop();
+        if (!sim_event_is_stale(p_event))
+        {
+            if (verbose)
+                sim_trace_packet("EVT", p_event->data, p_event->len);
+
+            memcpy(&p_radio->p_tx_buf[p_radio->tx_head + p_radio->tx_len], p_event->data, p_event->len);
+            p_radio->tx_len += p_event->len;
+            p_radio->events++;
+            sim_stats.events++;
+            sim_stats.event_bytes += p_event->len;
+        }
+        sim_event_free(p_event);
+    }
+    for (i = 0; i < sim_num_radios; i++)
+        sim_tx_set_blocked(&sim_radios[i], !sim_tx_flush(&sim_radios[i]));
+    sim_timer_arm();
+}
+
+static int sim_pty_open(sim_radio_t *p_radio)
+{
+    struct termios tio;
+    const char    *p_name;
+
+    if ((p_radio->pty_fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC)) < 0)
+    {
+        sim_log("posix_openpt failed: %s", strerror(errno));
+        return 0;
+    }
+    if ((grantpt(p_radio->pty_fd) < 0) || (unlockpt(p_radio->pty_fd) < 0) || ((p_name = ptsname(p_radio->pty_fd)) == NULL))
+    {
+        sim_log("pty setup failed: %s", strerror(errno));
+        return 0;
+    }
+    // Keep the slave open so that the master does not report a hang up while no host is attached. The
+    // line discipline must not touch the binary HCI stream.
+    if ((p_radio->pty_slave_fd = open(p_name, O_RDWR | O_NOCTTY | O_CLOEXEC)) < 0)
+    {
+        sim_log("Error opening %s: %s", p_name, strerror(errno));
+        return 0;
+    }
+    if (tcgetattr(p_radio->pty_slave_fd, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        tcsetattr(p_radio->pty_slave_fd, TCSANOW, &tio);
+    }
+    if (p_radio->link[0] != 0)
+    {
+        unlink(p_radio->link);
+        if (symlink(p_name, p_radio->link) < 0)
+        {
+            sim_log("symlink %s failed: %s", p_radio->link, strerror(errno));
+            return 0;
+        }
+    }
+    printf("%s\n", (p_radio->link[0] != 0) ? p_radio->link : p_name);
+    fflush(stdout);
+    return 1;
+}
+
+/******************************************************************************
+ * Status of the nodes
+ ******************************************************************************/
+static void sim_tx_complete_failed(const sim_cmd_header_t *p_hdr, uint16_t hci_opcode)
+{
+    sim_event_t *p_event = sim_event_alloc();
+    uint8_t     *p = sim_event_start(p_event, HCI_CONTROL_MESH_EVENT_TX_COMPLETE);
+    uint64_t     timeout_us = (p_hdr->reply_timeout != 0) ? (uint64_t)p_hdr->reply_timeout * 50000 : SIM_DEFAULT_REPLY_TIMEOUT_MS * 1000;
+
+    p = sim_event_mesh_header(p, sim_local->addr, p_hdr->dst, p_hdr->app_key_idx, MESH_COMPANY_ID_BT_SIG, 0);
+    p = sim_write16(p, hci_opcode);
+    *p++ = TX_STATUS_FAILED;
+    p = sim_write16(p, p_hdr->dst);
+    sim_event_finish(p_event, p, timeout_us);
+
+    sim_stats.tx_failed++;
+}
+
+// Exchange of one message with one node: every transmission of the message or the status may be lost,
+// the message is retransmitted as requested in the header. If one of the transmissions gets through the
+// node handles the message and its status is queued with the latency of the node.
+static void sim_node_exchange(const sim_model_cmd_t *p_cmd, const sim_cmd_header_t *p_hdr, sim_node_t *p_node, const uint8_t *p_data, uint16_t len, int is_unicast)
+{
+    uint8_t      reply[SIM_EVENT_MAX - 5 - SIM_EVENT_HEADER_LEN];
+    uint16_t     src = p_node->addr;            /* node reset forgets the address */
+    int          reply_len;
+    int          acked = (p_cmd->flags & SIM_CMD_FLAG_ACKED) || p_hdr->reliable;
+    uint64_t     delay_us = sim_node_delay_us(p_node);
+    int          attempt;
+    sim_event_t *p_event;
+    uint8_t     *p;
+
+    if (p_node != sim_local)
+    {
+        for (attempt = 0; (attempt <= p_hdr->retrans_cnt) && sim_lost(); attempt++)
+            delay_us += (uint64_t)p_hdr->retrans_time * 50000;
+
+        if (attempt > p_hdr->retrans_cnt)
+        {
+            sim_stats.lost++;
+            if (is_unicast && acked)
+                sim_tx_complete_failed(p_hdr, p_cmd->hci_opcode);
+            return;
+        }
+    }
+    if ((reply_len = p_cmd->p_handler(p_node, p_hdr, p_data, len, reply)) < 0)
+    {
+        if (is_unicast && acked)
+            sim_tx_complete_failed(p_hdr, p_cmd->hci_opcode);
+        return;
+    }
+    if (!acked)
+        return;
+
+    p_event = sim_event_alloc();
+    p = sim_event_start(p_event, p_cmd->event_opcode);
+    p = sim_event_mesh_header(p, src, sim_local->addr, p_hdr->app_key_idx, MESH_COMPANY_ID_BT_SIG, p_cmd->mesh_opcode);
+    memcpy(p, reply, reply_len);
+    sim_event_finish(p_event, p + reply_len, delay_us);
+}
+
+static void sim_model_command(const sim_model_cmd_t *p_cmd, uint8_t *p_data, uint16_t len)
+{
+    sim_cmd_header_t hdr;
+    sim_node_t      *p_node;
+    uint32_t         i;
+
+    if (len < SIM_CMD_HEADER_LEN + p_cmd->min_len)
+        return;
+
+    hdr.dst           = sim_read16(&p_data[0]);
+    hdr.app_key_idx   = sim_read16(&p_data[2]);
+    hdr.element_idx   = p_data[4];
+    hdr.reliable      = p_data[5];
+    hdr.ttl           = p_data[7];
+    hdr.retrans_cnt   = p_data[8] & 0x7f;
+    hdr.retrans_time  = p_data[9];
+    hdr.reply_timeout = p_data[10];
+    p_data += SIM_CMD_HEADER_LEN;
+    len    -= SIM_CMD_HEADER_LEN;
+
+    if ((hdr.dst != 0) && (hdr.dst == sim_local->addr))
+    {
+        sim_node_exchange(p_cmd, &hdr, sim_local, p_data, len, 1);
+    }
+    else if ((hdr.dst != 0) && (hdr.dst < 0x8000))
+    {
+        if ((p_node = sim_node_by_addr(hdr.dst)) != NULL)
+            sim_node_exchange(p_cmd, &hdr, p_node, p_data, len, 1);
+        else if ((p_cmd->flags & SIM_CMD_FLAG_ACKED) || hdr.reliable)
+            sim_tx_complete_failed(&hdr, p_cmd->hci_opcode);
+    }
+    else if (!(p_cmd->flags & SIM_CMD_FLAG_UNICAST))
+    {
+        // every provisioned light subscribed to the group answers, all of them for the all nodes address
+        for (i = 1; i <= sim_num_nodes; i++)
+        {
+            p_node = &sim_nodes[i];
+            if ((p_node->addr != 0) && ((hdr.dst == 0xFFFF) || sim_node_subscribed(p_node, hdr.dst)))
+                sim_node_exchange(p_cmd, &hdr, p_node, p_data, len, 0);
+        }
+    }
+}
+
+/******************************************************************************
+ * Configuration server
+ ******************************************************************************/
+static int sim_composition_data_get(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    static const uint16_t light_models[] =
+    {
+        WICED_BT_MESH_CORE_MODEL_ID_CONFIG_SRV, WICED_BT_MESH_CORE_MODEL_ID_HEALTH_SRV,
+        WICED_BT_MESH_CORE_MODEL_ID_GENERIC_ONOFF_SRV, WICED_BT_MESH_CORE_MODEL_ID_GENERIC_LEVEL_SRV,
+        WICED_BT_MESH_CORE_MODEL_ID_GENERIC_DEFTT_SRV, WICED_BT_MESH_CORE_MODEL_ID_LIGHT_LIGHTNESS_SRV,
+        WICED_BT_MESH_CORE_MODEL_ID_LIGHT_LIGHTNESS_SETUP_SRV,
+    };
+    static const uint16_t local_models[] =
+    {
+        WICED_BT_MESH_CORE_MODEL_ID_CONFIG_SRV, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT,
+        WICED_BT_MESH_CORE_MODEL_ID_HEALTH_SRV, WICED_BT_MESH_CORE_MODEL_ID_REMOTE_PROVISION_SRV,
+        WICED_BT_MESH_CORE_MODEL_ID_REMOTE_PROVISION_CLNT, WICED_BT_MESH_CORE_MODEL_ID_GENERIC_ONOFF_CLNT,
+        WICED_BT_MESH_CORE_MODEL_ID_GENERIC_LEVEL_CLNT, WICED_BT_MESH_CORE_MODEL_ID_LIGHT_LIGHTNESS_CLNT,
+    };
+    const uint16_t *p_models = (p_node == sim_local) ? local_models : light_models;
+    uint8_t         num_models = (p_node == sim_local) ? sizeof(local_models) / sizeof(local_models[0]) : sizeof(light_models) / sizeof(light_models[0]);
+    uint8_t        *p = p_reply;
+    int             i;
+
+    *p++ = p_data[0];                           /* page */
+    p = sim_write16(p, MESH_COMPANY_ID_CYPRESS);
+    p = sim_write16(p, (p_node == sim_local) ? 0x3001 : 0x3016);    /* product id */
+    p = sim_write16(p, 0x0001);                 /* version */
+    p = sim_write16(p, 0x0100);                 /* replay protection list size */
+    p = sim_write16(p, (p_node == sim_local) ? 0 : 0x0003);         /* features: relay and proxy */
+    p = sim_write16(p, 0);                      /* location of the only element */
+    *p++ = num_models;
+    *p++ = 0;                                   /* vendor models */
+    for (i = 0; i < num_models; i++)
+        p = sim_write16(p, p_models[i]);
+    return (uint16_t)(p - p_reply);
+}
+
+static int sim_netkey_change(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    p_reply[0] = 0;
+    memcpy(&p_reply[1], p_data, 2);             /* net key index */
+    return 3;
+}
+
+static int sim_appkey_change(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    p_reply[0] = 0;
+    memcpy(&p_reply[1], p_data, 4);             /* net key and app key indexes */
+    return 5;
+}
+
+static int sim_key_refresh_phase_set(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    p_reply[0] = 0;
+    memcpy(&p_reply[1], p_data, 2);
+    p_reply[3] = (p_data[2] == 3) ? 0 : p_data[2];  /* transition 3 ends the procedure */
+    return 4;
+}
+
+static int sim_model_app_bind(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    p_reply[0] = 0;
+    memcpy(&p_reply[1], p_data, 8);             /* element, company, model, app key index */
+    return 9;
+}
+
+static int sim_model_sub_change(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply, int add, int remove_all)
+{
+    uint16_t addr = (len >= 8) ? sim_read16(&p_data[6]) : 0;
+    int      i;
+
+    if (remove_all)
+        p_node->num_groups = 0;
+
+    for (i = 0; i < p_node->num_groups; i++)
+    {
+        if (p_node->groups[i] == addr)
+            break;
+    }
+    if (!add && (i < p_node->num_groups))
+        p_node->groups[i] = p_node->groups[--p_node->num_groups];
+    else if (add && (i == p_node->num_groups) && (addr != 0))
+    {
+        if (p_node->num_groups == SIM_NODE_MAX_GROUPS)
+        {
+            p_reply[0] = 0x05;                  /* insufficient resources */
+            memcpy(&p_reply[1], p_data, 6);
+            sim_write16(&p_reply[7], addr);
+            return 9;
+        }
+        p_node->groups[p_node->num_groups++] = addr;
+    }
+    p_reply[0] = 0;
+    memcpy(&p_reply[1], p_data, 6);             /* element, company, model */
+    sim_write16(&p_reply[7], addr);
+    return 9;
+}
+
+static int sim_model_sub_add(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    return sim_model_sub_change(p_node, p_hdr, p_data, len, p_reply, 1, 0);
+}
+
+static int sim_model_sub_delete(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    return sim_model_sub_change(p_node, p_hdr, p_data, len, p_reply, 0, 0);
+}
+
+static int sim_model_sub_overwrite(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    return sim_model_sub_change(p_node, p_hdr, p_data, len, p_reply, 1, 1);
+}
+
+static int sim_model_sub_delete_all(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    return sim_model_sub_change(p_node, p_hdr, p_data, len, p_reply, 0, 1);
+}
+
+static int sim_model_pub_set(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    p_reply[0] = 0;
+    memcpy(&p_reply[1], p_data, 6);             /* element, company, model */
+    memcpy(&p_reply[7], &p_data[6], 2);         /* publish address, only non virtual addresses are used */
+    memcpy(&p_reply[9], &p_data[22], 11);       /* app key index, credentials, ttl, period, retransmit */
+    return 20;
+}
+
+static int sim_default_ttl_set(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    p_reply[0] = p_data[0];
+    p_reply[1] = p_hdr->ttl;
+    return 2;
+}
+
+// Relay, network transmit, friend, GATT proxy and beacon status repeat the state that was set
+static int sim_state_set(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    if (len > 4)
+        len = 4;
+    memcpy(p_reply, p_data, len);
+    return len;
+}
+
+static int sim_node_identity_set(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    p_reply[0] = 0;
+    memcpy(&p_reply[1], p_data, 3);             /* net key index, identity */
+    return 4;
+}
+
+static void sim_proxy_disconnected(uint64_t delay_us);
+
+static int sim_node_reset(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    if (p_node == sim_local)
+        return -1;
+
+    // the status is sent with the old address, Node Reset Status has no parameters
+    sim_node_set_addr(p_node, 0);
+    p_node->num_groups = 0;
+    if (sim_proxy_node == sim_node_index(p_node))
+        sim_proxy_disconnected(2 * sim_node_delay_us(p_node));
+    return 0;
+}
+
+/******************************************************************************
+ * Remote provisioning server of the local device
+ ******************************************************************************/
+static int sim_scan_capabilities_get(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    if (p_node != sim_local)
+        return -1;
+    p_reply[0] = 0xff;                          /* max scanned items */
+    p_reply[1] = 0;                             /* active scan is not supported */
+    return 2;
+}
+
+static void sim_scan_report(uint32_t index, uint64_t delay_us)
+{
+    sim_event_t *p_event = sim_event_alloc();
+    uint8_t     *p = sim_event_start(p_event, HCI_CONTROL_MESH_EVENT_PROVISION_SCAN_REPORT);
+    int          i;
+
+    p = sim_event_mesh_header(p, sim_local->addr, sim_local->addr, 0xFFFF, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CODE_REMOTE_PROVISIONING_SCAN_REPORT);
+    *p++ = (uint8_t)(-40 - (int)(sim_random() % 40));
+    sim_node_uuid(index, p);
+    p += 16;
+    p = sim_write16(p, 0);                      /* OOB information */
+    p = sim_write32(p, 0);                      /* URI hash */
+    for (i = 0; i < 4; i++)                     /* BD address, little endian */
+        *p++ = (uint8_t)(index >> (8 * i));
+    *p++ = 0x5a;
+    *p++ = 0x00;
+    p_event->scan_id = sim_scan_id;
+    sim_event_finish(p_event, p, delay_us);
+
+    sim_stats.scan_reports++;
+}
+
+static int sim_scan_start(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    uint32_t index, limit = p_data[0], reported = 0;
+    uint64_t delay_us = 2 * SIM_LOCAL_LATENCY_US;
+
+    if (p_node != sim_local)
+        return -1;
+
+    sim_scan_id = ++sim_scan_count;
+
+    // report the unprovisioned lights one by one, as their beacons are received
+    if (len >= 2 + 16)
+    {
+        if (((index = sim_node_by_uuid(&p_data[2])) != 0) && (sim_nodes[index].addr == 0))
+            sim_scan_report(index, delay_us);
+    }
+    else
+    {
+        for (index = 1; (index <= sim_num_nodes) && ((limit == 0) || (reported < limit)); index++)
+        {
+            if (sim_nodes[index].addr != 0)
+                continue;
+            sim_scan_report(index, delay_us);
+            delay_us += SIM_SCAN_REPORT_INTERVAL_US;
+            reported++;
+        }
+    }
+    p_reply[0] = 0;
+    p_reply[1] = (len >= 2 + 16) ? WICED_BT_MESH_REMOTE_PROVISIONING_SERVER_SINGLE_DEVICE_SCAN : WICED_BT_MESH_REMOTE_PROVISIONING_SERVER_MULTI_DEVICE_SCAN;
+    p_reply[2] = p_data[0];
+    p_reply[3] = p_data[1];
+    return 4;
+}
+
+static int sim_scan_stop(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    if (p_node != sim_local)
+        return -1;
+
+    sim_scan_id = 0;
+    memset(p_reply, 0, 4);
+    return 4;
+}
+
+static int sim_scan_extended_start(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    uint8_t  num_filters = p_data[0];
+    uint32_t index;
+    uint8_t *p = p_reply;
+    int      name_len;
+
+    if ((p_node != sim_local) || (len < 1 + num_filters + 16))
+        return -1;
+
+    // the extended report carries the name of the light, that is the only AD type the host asks for
+    index = sim_node_by_uuid(&p_data[1 + num_filters]);
+    *p++ = (index != 0) ? 0 : 1;
+    memcpy(p, &p_data[1 + num_filters], 16);
+    p += 16;
+    p = sim_write16(p, 0);
+    if (index != 0)
+    {
+        name_len = sprintf((char *)&p[2], "Sim Light %u", index);
+        p[0] = (uint8_t)(name_len + 1);
+        p[1] = BTM_BLE_ADVERT_TYPE_NAME_COMPLETE;
+        p += name_len + 2;
+    }
+    return (uint16_t)(p - p_reply);
+}
+
+static void sim_link_report(uint8_t status, uint8_t rpr_state, uint64_t delay_us)
+{
+    sim_event_t *p_event = sim_event_alloc();
+    uint8_t     *p = sim_event_start(p_event, HCI_CONTROL_MESH_EVENT_PROVISION_LINK_REPORT);
+
+    p = sim_event_mesh_header(p, sim_prov_addr, sim_local->addr, 0xFFFF, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CODE_REMOTE_PROVISIONING_LINK_REPORT);
+    *p++ = status;
+    *p++ = rpr_state;
+    *p++ = 0;                                   /* reason */
+    *p++ = sim_prov_over_gatt;
+    sim_event_finish(p_event, p, delay_us);
+}
+
+static void sim_provision_connect(uint8_t *p_data, uint16_t len)
+{
+    sim_event_t *p_event;
+    uint8_t     *p;
+    uint64_t     delay_us = sim_latency_us;
+
+    if (len < SIM_CMD_HEADER_LEN + 19)
+        return;
+
+    sim_prov_addr      = sim_read16(p_data);
+    sim_prov_over_gatt = p_data[SIM_CMD_HEADER_LEN + 18];
+    sim_prov_node      = sim_node_by_uuid(&p_data[SIM_CMD_HEADER_LEN]);
+
+    if ((sim_prov_node == 0) || (sim_nodes[sim_prov_node].addr != 0))
+    {
+        sim_prov_node = 0;
+        sim_link_report(WICED_BT_MESH_REMOTE_PROVISION_STATUS_OPEN_FAILED, WICED_BT_MESH_REMOTE_PROVISION_STATE_IDLE, 10 * delay_us);
+        return;
+    }
+    sim_link_report(WICED_BT_MESH_REMOTE_PROVISION_STATUS_SUCCESS, WICED_BT_MESH_REMOTE_PROVISION_STATE_LINK_ACTIVE, delay_us);
+
+    // provisioner sends the invite as soon as the link is open
+    p_event = sim_event_alloc();
+    p = sim_event_start(p_event, HCI_CONTROL_MESH_EVENT_PROVISION_DEVICE_CAPABILITIES);
+    p = sim_event_mesh_header(p, sim_prov_addr, sim_local->addr, 0xFFFF, MESH_COMPANY_ID_BT_SIG, 0);
+    p = sim_write16(p, sim_prov_addr);
+    *p++ = 1;                                   /* number of elements */
+    p = sim_write16(p, 0x0001);                 /* FIPS P-256 */
+    *p++ = 0;                                   /* public key type */
+    *p++ = 0;                                   /* static OOB type */
+    *p++ = 0;                                   /* output OOB size */
+    p = sim_write16(p, 0);
+    *p++ = 0;                                   /* input OOB size */
+    p = sim_write16(p, 0);
+    sim_event_finish(p_event, p, 2 * delay_us);
+}
+
+static void sim_provision_start(uint8_t *p_data, uint16_t len)
+{
+    sim_event_t *p_event;
+    sim_node_t  *p_node;
+    uint16_t     addr;
+    int          i;
+    uint8_t     *p;
+
+    if ((len < SIM_CMD_HEADER_LEN + 9) || (sim_prov_node == 0))
+        return;
+
+    p_node = &sim_nodes[sim_prov_node];
+    addr   = sim_read16(&p_data[SIM_CMD_HEADER_LEN]);
+    sim_net_key_idx = sim_read16(&p_data[SIM_CMD_HEADER_LEN + 2]);
+
+    sim_node_set_addr(p_node, addr);
+    p_node->num_groups = 0;
+    p_node->onoff      = 0;
+    p_node->level      = -32768;
+    p_node->lightness  = 0;
+    p_node->def_trans_time = 0;
+
+    p_event = sim_event_alloc();
+    p = sim_event_start(p_event, HCI_CONTROL_MESH_EVENT_PROVISION_END);
+    p = sim_event_mesh_header(p, sim_prov_addr, sim_local->addr, 0xFFFF, MESH_COMPANY_ID_BT_SIG, 0);
+    p = sim_write16(p, sim_prov_addr);
+    p = sim_write16(p, addr);
+    p = sim_write16(p, sim_net_key_idx);
+    *p++ = 0;                                   /* result */
+    for (i = 0; i < 16; i++)                    /* device key */
+        *p++ = (uint8_t)(sim_prov_node >> (8 * (i & 3))) ^ (uint8_t)(0xa5 + i);
+    sim_event_finish(p_event, p, sim_provision_us);
+
+    // provisioner closes the link after provisioning is complete
+    sim_link_report(WICED_BT_MESH_REMOTE_PROVISION_STATUS_CLOSED_BY_SERVER, WICED_BT_MESH_REMOTE_PROVISION_STATE_IDLE, sim_provision_us + sim_latency_us);
+    sim_prov_node = 0;
+    sim_stats.provisioned++;
+}
+
+static void sim_provision_disconnect(uint8_t *p_data, uint16_t len)
+{
+    if (len >= 2)
+        sim_prov_addr = sim_read16(p_data);
+    sim_prov_node = 0;
+    sim_link_report(WICED_BT_MESH_REMOTE_PROVISION_STATUS_CLOSED_BY_CLIENT, WICED_BT_MESH_REMOTE_PROVISION_STATE_IDLE, sim_latency_us);
+}
+
+/******************************************************************************
+ * GATT proxy client of the local device
+ ******************************************************************************/
+static void sim_proxy_connection_status(uint32_t index, uint8_t connected, uint64_t delay_us)
+{
+    sim_event_t *p_event = sim_event_alloc();
+    uint16_t     addr = (index != 0) ? sim_nodes[index].addr : 0;
+    uint8_t     *p = sim_event_start(p_event, HCI_CONTROL_MESH_EVENT_PROXY_CONNECTION_STATUS);
+
+    p = sim_event_mesh_header(p, addr, sim_local->addr, 0xFFFF, MESH_COMPANY_ID_BT_SIG, 0);
+    p = sim_write16(p, connected ? 1 : 0);      /* connection id */
+    p = sim_write16(p, addr);
+    *p++ = connected;
+    *p++ = 1;                                   /* over GATT */
+    sim_event_finish(p_event, p, delay_us);
+}
+
+static void sim_proxy_disconnected(uint64_t delay_us)
+{
+    sim_proxy_node = 0;
+    sim_proxy_connection_status(0, 0, delay_us);
+}
+
+static void sim_proxy_connect(uint8_t *p_data, uint16_t len)
+{
+    uint8_t     scan_duration = (len != 0) ? p_data[len - 1] : 0;
+    sim_node_t *p_node = NULL;
+    uint32_t    i;
+
+    if (len == 3)
+    {
+        // connect to the node advertising node identity
+        p_node = sim_node_by_addr(sim_read16(p_data));
+    }
+    else if (len == 1)
+    {
+        // connect to any proxy of the network
+        for (i = 1; (i <= sim_num_nodes) && (p_node == NULL); i++)
+        {
+            if (sim_nodes[i].addr != 0)
+                p_node = &sim_nodes[i];
+        }
+    }
+    if (p_node == NULL)
+    {
+        // nothing found during the scan
+        sim_proxy_disconnected((uint64_t)(scan_duration ? scan_duration : 1) * 1000000);
+        return;
+    }
+    sim_proxy_node        = sim_node_index(p_node);
+    sim_proxy_filter_size = 0;
+    sim_proxy_connection_status(sim_proxy_node, 1, 3 * sim_node_delay_us(p_node));
+}
+
+static void sim_proxy_disconnect(uint8_t *p_data, uint16_t len)
+{
+    sim_proxy_disconnected(sim_latency_us);
+}
+
+static void sim_proxy_filter_change(uint8_t *p_data, uint16_t len, int op)
+{
+    sim_event_t *p_event;
+    uint8_t     *p;
+    sim_node_t  *p_proxy;
+
+    if ((len < SIM_CMD_HEADER_LEN) || (sim_proxy_node == 0))
+        return;
+    p_proxy = &sim_nodes[sim_proxy_node];
+
+    len -= SIM_CMD_HEADER_LEN;
+    if (op == 0)
+        sim_proxy_filter_size = 0;
+    else if (op > 0)
+        sim_proxy_filter_size += len / 2;
+    else
+        sim_proxy_filter_size = (sim_proxy_filter_size > len / 2) ? sim_proxy_filter_size - len / 2 : 0;
+
+    p_event = sim_event_alloc();
+    p = sim_event_start(p_event, HCI_CONTROL_MESH_EVENT_PROXY_FILTER_STATUS);
+    p = sim_event_mesh_header(p, p_proxy->addr, sim_local->addr, 0xFFFF, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_CMD_SPECIAL_PROXY_FLT_STATUS);
+    *p++ = (op == 0) ? p_data[SIM_CMD_HEADER_LEN] : 0;  /* filter type */
+    p = sim_write16(p, sim_proxy_filter_size);
+    sim_event_finish(p_event, p, sim_node_delay_us(p_proxy));
+}
+
+static void sim_proxy_filter_type_set(uint8_t *p_data, uint16_t len)
+{
+    if (len > SIM_CMD_HEADER_LEN)
+        sim_proxy_filter_change(p_data, len, 0);
+}
+
+static void sim_proxy_filter_add(uint8_t *p_data, uint16_t len)
+{
+    sim_proxy_filter_change(p_data, len, 1);
+}
+
+static void sim_proxy_filter_delete(uint8_t *p_data, uint16_t len)
+{
+    sim_proxy_filter_change(p_data, len, -1);
+}
+
+/******************************************************************************
+ * Local device setup
+ ******************************************************************************/
+static void sim_set_local_device(uint8_t *p_data, uint16_t len)
+{
+    if (len < 2 + 16 + 16 + 2)
+        return;
+
+    sim_node_set_addr(sim_local, sim_read16(p_data));
+    sim_net_key_idx = sim_read16(&p_data[34]);
+    sim_log("Local device radio:%u addr:%04x net key index:%x", sim_radio, sim_local->addr, sim_net_key_idx);
+}
+
+/******************************************************************************
+ * Generic and light models
+ ******************************************************************************/
+// Default Transition Time status repeats the app key index and the element before the time
+static int sim_def_trans_time_status(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, uint8_t *p_reply)
+{
+    sim_write16(&p_reply[0], p_hdr->app_key_idx);
+    p_reply[2] = p_hdr->element_idx;
+    sim_write32(&p_reply[3], p_node->def_trans_time);
+    return 7;
+}
+
+static int sim_def_trans_time_get(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    return (p_node == sim_local) ? -1 : sim_def_trans_time_status(p_node, p_hdr, p_reply);
+}
+
+static int sim_def_trans_time_set(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    if (p_node == sim_local)
+        return -1;
+    p_node->def_trans_time = sim_read16(p_data) | ((uint32_t)sim_read16(&p_data[2]) << 16);
+    return sim_def_trans_time_status(p_node, p_hdr, p_reply);
+}
+
+static int sim_onoff_status(sim_node_t *p_node, uint8_t *p_reply)
+{
+    p_reply[0] = p_node->onoff;
+    p_reply[1] = p_node->onoff;
+    sim_write32(&p_reply[2], 0);
+    return 6;
+}
+
+static int sim_onoff_get(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    return (p_node == sim_local) ? -1 : sim_onoff_status(p_node, p_reply);
+}
+
+static int sim_onoff_set(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    if (p_node == sim_local)
+        return -1;
+    p_node->onoff = p_data[0] ? 1 : 0;
+    return sim_onoff_status(p_node, p_reply);
+}
+
+static int sim_level_status(sim_node_t *p_node, uint8_t *p_reply)
+{
+    sim_write16(&p_reply[0], (uint16_t)p_node->level);
+    sim_write16(&p_reply[2], (uint16_t)p_node->level);
+    sim_write32(&p_reply[4], 0);
+    return 8;
+}
+
+static int sim_level_get(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    return (p_node == sim_local) ? -1 : sim_level_status(p_node, p_reply);
+}
+
+// Level and Lightness of the light are bound, lightness = level + 32768
+static int sim_level_set(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    if (p_node == sim_local)
+        return -1;
+    p_node->level     = (int16_t)sim_read16(p_data);
+    p_node->lightness = (uint16_t)(p_node->level + 32768);
+    p_node->onoff     = (p_node->lightness != 0);
+    return sim_level_status(p_node, p_reply);
+}
+
+static int sim_lightness_status(sim_node_t *p_node, uint8_t *p_reply)
+{
+    sim_write16(&p_reply[0], p_node->lightness);
+    sim_write16(&p_reply[2], p_node->lightness);
+    sim_write32(&p_reply[4], 0);
+    return 8;
+}
+
+static int sim_lightness_get(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    return (p_node == sim_local) ? -1 : sim_lightness_status(p_node, p_reply);
+}
+
+static int sim_lightness_set(sim_node_t *p_node, const sim_cmd_header_t *p_hdr, const uint8_t *p_data, uint16_t len, uint8_t *p_reply)
+{
+    if (p_node == sim_local)
+        return -1;
+    p_node->lightness = sim_read16(p_data);
+    p_node->level     = (int16_t)(p_node->lightness - 32768);
+    p_node->onoff     = (p_node->lightness != 0);
+    return sim_lightness_status(p_node, p_reply);
+}
+
+/******************************************************************************
+ * Command dispatch
+ ******************************************************************************/
+static const sim_model_cmd_t sim_model_commands[] =
+{
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_COMPOSITION_DATA_GET, HCI_CONTROL_MESH_EVENT_COMPOSITION_DATA_STATUS, WICED_BT_MESH_CORE_CMD_DEVICE_COMPOS_DATA_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 1, sim_composition_data_get },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_NET_KEY_ADD, HCI_CONTROL_MESH_EVENT_NETKEY_STATUS, WICED_BT_MESH_CORE_CMD_NETKEY_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 2, sim_netkey_change },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_NET_KEY_UPDATE, HCI_CONTROL_MESH_EVENT_NETKEY_STATUS, WICED_BT_MESH_CORE_CMD_NETKEY_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 2, sim_netkey_change },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_NET_KEY_DELETE, HCI_CONTROL_MESH_EVENT_NETKEY_STATUS, WICED_BT_MESH_CORE_CMD_NETKEY_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 2, sim_netkey_change },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_APP_KEY_ADD, HCI_CONTROL_MESH_EVENT_APPKEY_STATUS, WICED_BT_MESH_CORE_CMD_APPKEY_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 4, sim_appkey_change },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_APP_KEY_UPDATE, HCI_CONTROL_MESH_EVENT_APPKEY_STATUS, WICED_BT_MESH_CORE_CMD_APPKEY_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 4, sim_appkey_change },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_APP_KEY_DELETE, HCI_CONTROL_MESH_EVENT_APPKEY_STATUS, WICED_BT_MESH_CORE_CMD_APPKEY_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 4, sim_appkey_change },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_KEY_REFRESH_PHASE_SET, HCI_CONTROL_MESH_EVENT_KEY_REFRESH_PHASE_STATUS, WICED_BT_MESH_CORE_CMD_CONFIG_KEY_REFRESH_PHASE_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 3, sim_key_refresh_phase_set },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_APP_BIND, HCI_CONTROL_MESH_EVENT_MODEL_APP_BIND_STATUS, WICED_BT_MESH_CORE_CMD_MODEL_APP_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 8, sim_model_app_bind },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_APP_UNBIND, HCI_CONTROL_MESH_EVENT_MODEL_APP_BIND_STATUS, WICED_BT_MESH_CORE_CMD_MODEL_APP_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 8, sim_model_app_bind },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_SUBSCRIPTION_ADD, HCI_CONTROL_MESH_EVENT_MODEL_SUBSCRIPTION_STATUS, WICED_BT_MESH_CORE_CMD_CONFIG_MODEL_SUBSCRIPTION_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 8, sim_model_sub_add },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_SUBSCRIPTION_DELETE, HCI_CONTROL_MESH_EVENT_MODEL_SUBSCRIPTION_STATUS, WICED_BT_MESH_CORE_CMD_CONFIG_MODEL_SUBSCRIPTION_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 8, sim_model_sub_delete },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_SUBSCRIPTION_OVERWRITE, HCI_CONTROL_MESH_EVENT_MODEL_SUBSCRIPTION_STATUS, WICED_BT_MESH_CORE_CMD_CONFIG_MODEL_SUBSCRIPTION_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 8, sim_model_sub_overwrite },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_SUBSCRIPTION_DELETE_ALL, HCI_CONTROL_MESH_EVENT_MODEL_SUBSCRIPTION_STATUS, WICED_BT_MESH_CORE_CMD_CONFIG_MODEL_SUBSCRIPTION_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 6, sim_model_sub_delete_all },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_PUBLICATION_SET, HCI_CONTROL_MESH_EVENT_MODEL_PUBLICATION_STATUS, WICED_BT_MESH_CORE_CMD_CONFIG_MODEL_PUBLICATION_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 33, sim_model_pub_set },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_DEFAULT_TTL_SET, HCI_CONTROL_MESH_EVENT_DEFAULT_TTL_STATUS, WICED_BT_MESH_CORE_CMD_CONFIG_DEFAULT_TTL_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 1, sim_default_ttl_set },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_RELAY_SET, HCI_CONTROL_MESH_EVENT_RELAY_STATUS, WICED_BT_MESH_CORE_CMD_CONFIG_RELAY_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 4, sim_state_set },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_NETWORK_TRANSMIT_SET, HCI_CONTROL_MESH_EVENT_NETWORK_TRANSMIT_PARAMS_STATUS, WICED_BT_MESH_CORE_CMD_CONFIG_NETWORK_TRANSMIT_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 3, sim_state_set },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_FRIEND_SET, HCI_CONTROL_MESH_EVENT_FRIEND_STATUS, WICED_BT_MESH_CORE_CMD_CONFIG_FRIEND_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 1, sim_state_set },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_GATT_PROXY_SET, HCI_CONTROL_MESH_EVENT_GATT_PROXY_STATUS, WICED_BT_MESH_CORE_CMD_CONFIG_GATT_PROXY_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 1, sim_state_set },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_BEACON_SET, HCI_CONTROL_MESH_EVENT_BEACON_STATUS, WICED_BT_MESH_CORE_CMD_CONFIG_BEACON_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 1, sim_state_set },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_NODE_IDENTITY_SET, HCI_CONTROL_MESH_EVENT_NODE_IDENTITY_STATUS, WICED_BT_MESH_CORE_CMD_NODE_IDENTITY_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 3, sim_node_identity_set },
+    { HCI_CONTROL_MESH_COMMAND_CONFIG_NODE_RESET, HCI_CONTROL_MESH_EVENT_NODE_RESET_STATUS, WICED_BT_MESH_CORE_CMD_NODE_RESET_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 0, sim_node_reset },
+    { HCI_CONTROL_MESH_COMMAND_PROVISION_SCAN_CAPABILITIES_GET, HCI_CONTROL_MESH_EVENT_PROVISION_SCAN_CAPABILITIES_STATUS, WICED_BT_MESH_CODE_REMOTE_PROVISIONING_SCAN_CAPABILITIES_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 0, sim_scan_capabilities_get },
+    { HCI_CONTROL_MESH_COMMAND_PROVISION_SCAN_START, HCI_CONTROL_MESH_EVENT_PROVISION_SCAN_STATUS, WICED_BT_MESH_CODE_REMOTE_PROVISIONING_SCAN_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 2, sim_scan_start },
+    { HCI_CONTROL_MESH_COMMAND_PROVISION_SCAN_STOP, HCI_CONTROL_MESH_EVENT_PROVISION_SCAN_STATUS, WICED_BT_MESH_CODE_REMOTE_PROVISIONING_SCAN_STATUS, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 0, sim_scan_stop },
+    { HCI_CONTROL_MESH_COMMAND_PROVISION_SCAN_EXTENDED_START, HCI_CONTROL_MESH_EVENT_PROVISION_SCAN_EXTENDED_REPORT, WICED_BT_MESH_CODE_REMOTE_PROVISIONING_SCAN_EXTENDED_REPORT, SIM_CMD_FLAG_ACKED | SIM_CMD_FLAG_UNICAST, 1, sim_scan_extended_start },
+    { HCI_CONTROL_MESH_COMMAND_DEF_TRANS_TIME_GET, HCI_CONTROL_MESH_EVENT_DEF_TRANS_TIME_STATUS, WICED_BT_MESH_OPCODE_GEN_DEFTRANSTIME_STATUS, SIM_CMD_FLAG_ACKED, 0, sim_def_trans_time_get },
+    { HCI_CONTROL_MESH_COMMAND_DEF_TRANS_TIME_SET, HCI_CONTROL_MESH_EVENT_DEF_TRANS_TIME_STATUS, WICED_BT_MESH_OPCODE_GEN_DEFTRANSTIME_STATUS, 0, 4, sim_def_trans_time_set },
+    { HCI_CONTROL_MESH_COMMAND_ONOFF_GET, HCI_CONTROL_MESH_EVENT_ONOFF_STATUS, WICED_BT_MESH_OPCODE_GEN_ONOFF_STATUS, SIM_CMD_FLAG_ACKED, 0, sim_onoff_get },
+    { HCI_CONTROL_MESH_COMMAND_ONOFF_SET, HCI_CONTROL_MESH_EVENT_ONOFF_STATUS, WICED_BT_MESH_OPCODE_GEN_ONOFF_STATUS, 0, 1, sim_onoff_set },
+    { HCI_CONTROL_MESH_COMMAND_LEVEL_GET, HCI_CONTROL_MESH_EVENT_LEVEL_STATUS, WICED_BT_MESH_OPCODE_GEN_LEVEL_STATUS, SIM_CMD_FLAG_ACKED, 0, sim_level_get },
+    { HCI_CONTROL_MESH_COMMAND_LEVEL_SET, HCI_CONTROL_MESH_EVENT_LEVEL_STATUS, WICED_BT_MESH_OPCODE_GEN_LEVEL_STATUS, 0, 2, sim_level_set },
+    { HCI_CONTROL_MESH_COMMAND_LIGHT_LIGHTNESS_GET, HCI_CONTROL_MESH_EVENT_LIGHT_LIGHTNESS_STATUS, WICED_BT_MESH_OPCODE_LIGHT_LIGHTNESS_STATUS, SIM_CMD_FLAG_ACKED, 0, sim_lightness_get },
+    { HCI_CONTROL_MESH_COMMAND_LIGHT_LIGHTNESS_SET, HCI_CONTROL_MESH_EVENT_LIGHT_LIGHTNESS_STATUS, WICED_BT_MESH_OPCODE_LIGHT_LIGHTNESS_STATUS, 0, 2, sim_lightness_set },
+};
+
+static const sim_local_cmd_t sim_local_commands[] =
+{
+    { HCI_CONTROL_MESH_COMMAND_SET_LOCAL_DEVICE, sim_set_local_device },
+    { HCI_CONTROL_MESH_COMMAND_PROVISION_CONNECT, sim_provision_connect },
+    { HCI_CONTROL_MESH_COMMAND_PROVISION_START, sim_provision_start },
+    { HCI_CONTROL_MESH_COMMAND_PROVISION_DISCONNECT, sim_provision_disconnect },
+    { HCI_CONTROL_MESH_COMMAND_PROXY_CONNECT, sim_proxy_connect },
+    { HCI_CONTROL_MESH_COMMAND_PROXY_DISCONNECT, sim_proxy_disconnect },
+    { HCI_CONTROL_MESH_COMMAND_PROXY_FILTER_TYPE_SET, sim_proxy_filter_type_set },
+    { HCI_CONTROL_MESH_COMMAND_PROXY_FILTER_ADDRESSES_ADD, sim_proxy_filter_add },
+    { HCI_CONTROL_MESH_COMMAND_PROXY_FILTER_ADDRESSES_DELETE, sim_proxy_filter_delete },
+};
+
+static void sim_command_status(void)
+{
+    sim_event_t *p_event = sim_event_alloc();
+    uint8_t     *p = sim_event_start(p_event, HCI_CONTROL_MESH_EVENT_COMMAND_STATUS);
+
+    *p++ = HCI_CONTROL_MESH_STATUS_SUCCESS;
+    sim_event_finish(p_event, p, 0);
+}
+
+static void sim_process_command(uint8_t *p_packet, uint32_t len)
+{
+    uint16_t opcode = sim_read16(&p_packet[1]);
+    uint16_t data_len = (uint16_t)(len - 5);
+    uint8_t *p_data = &p_packet[5];
+    size_t   i;
+
+    sim_stats.commands++;
+    sim_stats.command_bytes += len;
+    sim_radios[sim_radio].commands++;
+
+    if (verbose)
+        sim_trace_packet("CMD", p_packet, len);
+
+    // only mesh commands are answered, the firmware confirms each of them with the Command Status
+    if (((opcode >> 8) != HCI_CONTROL_GROUP_MESH) && ((opcode >> 8) != HCI_CONTROL_GROUP_MESH_MODELS))
+    {
+        sim_stats.unknown++;
+        return;
+    }
+    sim_command_status();
+
+    for (i = 0; i < sizeof(sim_local_commands) / sizeof(sim_local_commands[0]); i++)
+    {
+        if (sim_local_commands[i].hci_opcode == opcode)
+        {
+            sim_local_commands[i].p_handler(p_data, data_len);
+            return;
+        }
+    }
+    for (i = 0; i < sizeof(sim_model_commands) / sizeof(sim_model_commands[0]); i++)
+    {
+        if (sim_model_commands[i].hci_opcode == opcode)
+        {
+            sim_model_command(&sim_model_commands[i], p_data, data_len);
+            return;
+        }
+    }
+    sim_stats.unknown++;
+}
+
+/******************************************************************************
+ * Main loop
+ ******************************************************************************/
+static void sim_pty_read(sim_radio_t *p_radio)
+{
+    ssize_t  bytes;
+    uint32_t offset, len;
+
+    // commands are handled by the local device of the radio and the events go back on the same radio
+    sim_radio = (uint8_t)(p_radio - sim_radios);
+    sim_local = &p_radio->local;
+
+    while ((bytes = read(p_radio->pty_fd, &p_radio->rx_buf[p_radio->rx_len], sizeof(p_radio->rx_buf) - p_radio->rx_len)) > 0)
+    {
+        p_radio->rx_len += (uint32_t)bytes;
+
+        // hosts only send WICED HCI packets, anything else is skipped byte by byte
+        offset = 0;
+        while (offset < p_radio->rx_len)
+        {
+            if (p_radio->rx_buf[offset] != HCI_WICED_PKT)
+            {
+                offset++;
+                continue;
+            }
+            if (p_radio->rx_len - offset < 5)
+                break;
+            len = 5 + sim_read16(&p_radio->rx_buf[offset + 3]);
+            if (p_radio->rx_len - offset < len)
+                break;
+            sim_process_command(&p_radio->rx_buf[offset], len);
+            offset += len;
+        }
+        memmove(p_radio->rx_buf, &p_radio->rx_buf[offset], p_radio->rx_len - offset);
+        p_radio->rx_len -= offset;
+    }
+}
+
+static void sim_print_stats(void)
+{
+    uint32_t i, provisioned = 0;
+
+    for (i = 1; i <= sim_num_nodes; i++)
+    {
+        if (sim_nodes[i].addr != 0)
+            provisioned++;
+    }
+    sim_log("commands:%llu bytes:%llu unknown:%llu events:%llu bytes:%llu writes:%llu",
+            (unsigned long long)sim_stats.commands, (unsigned long long)sim_stats.command_bytes, (unsigned long long)sim_stats.unknown,
+            (unsigned long long)sim_stats.events, (unsigned long long)sim_stats.event_bytes, (unsigned long long)sim_stats.writes);
+    sim_log("lost:%llu tx_failed:%llu scan_reports:%llu provisioned:%llu nodes:%u/%u queue:%u max_queue:%u",
+            (unsigned long long)sim_stats.lost, (unsigned long long)sim_stats.tx_failed, (unsigned long long)sim_stats.scan_reports,
+            (unsigned long long)sim_stats.provisioned, provisioned, sim_num_nodes, sim_queue_len, sim_stats.max_queue_depth);
+    for (i = 0; (sim_num_radios > 1) && (i < sim_num_radios); i++)
+        sim_log("radio:%u addr:%04x commands:%llu events:%llu", i, sim_radios[i].local.addr,
+                (unsigned long long)sim_radios[i].commands, (unsigned long long)sim_radios[i].events);
+}
+
+static int sim_epoll_add(int fd, uint32_t events)
+{
+    struct epoll_event ev;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events  = events;
+    ev.data.fd = fd;
+    return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -n <count>      number of virtual lights (default %d)\n"
+            "  -L <ms>         latency of the replies (default %d)\n"
+            "  -j <ms>         random jitter added to the latency (default %d)\n"
+            "  -x <percent>    percentage of lost transmissions, fractions allowed (default 0)\n"
+            "  -P <ms>         time to provision a light (default %d)\n"
+            "  -s <seed>       seed of the random generator\n"
+            "  -r <count>      number of radios, each one a local device on its own pty (default 1, up to %d)\n"
+            "  -l <path>       create a symbolic link to the pty, <path>.<n> to the pty of radio n above 0\n"
+            "  -v              trace commands and events\n"
+            "  -h              this help\n"
+            "The slave side of the pty is printed on stdout, start the host with it as the UART.\n",
+            prog, SIM_DEFAULT_NODES, SIM_DEFAULT_LATENCY_MS, SIM_DEFAULT_JITTER_MS, SIM_DEFAULT_PROVISION_MS, SIM_MAX_RADIOS);
+}
+
+int main(int argc, char **argv)
+{
+    struct epoll_event       events[SIM_MAX_EPOLL_EVENTS];
+    struct signalfd_siginfo  si;
+    sigset_t                 mask;
+    const char              *p_link = NULL;
+    uint64_t                 expirations;
+    unsigned long            value;
+    sim_radio_t             *p_radio;
+    int                      opt, n, i, r;
+
+    while ((opt = getopt(argc, argv, "n:L:j:x:P:s:r:l:vh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            value = strtoul(optarg, NULL, 0);
+            if ((value == 0) || (value > SIM_MAX_NODES))
+            {
+                fprintf(stderr, "number of lights must be 1 to %d\n", SIM_MAX_NODES);
+                return 1;
+            }
+            sim_num_nodes = (uint32_t)value;
+            break;
+        case 'L': sim_latency_us = (uint32_t)strtoul(optarg, NULL, 0) * 1000; break;
+        case 'j': sim_jitter_us = (uint32_t)strtoul(optarg, NULL, 0) * 1000; break;
+        case 'x': sim_loss_ppm = (uint32_t)(strtod(optarg, NULL) * 10000); break;
+        case 'P': sim_provision_us = (uint32_t)strtoul(optarg, NULL, 0) * 1000; break;
+        case 's': sim_random_state = strtoull(optarg, NULL, 0) | 1; break;
+        case 'r':
+            value = strtoul(optarg, NULL, 0);
+            if ((value == 0) || (value > SIM_MAX_RADIOS))
+            {
+                fprintf(stderr, "number of radios must be 1 to %d\n", SIM_MAX_RADIOS);
+                return 1;
+            }
+            sim_num_radios = (uint32_t)value;
+            break;
+        case 'l': p_link = optarg; break;
+        case 'v': verbose = 1; break;
+        default:
+            usage(argv[0]);
+            return (opt == 'h') ? 0 : 1;
+        }
+    }
+    if (sim_loss_ppm > 1000000)
+        sim_loss_ppm = 1000000;
+
+    if ((sim_nodes = (sim_node_t *)calloc(sim_num_nodes + 1, sizeof(sim_node_t))) == NULL)
+    {
+        sim_log("out of memory");
+        return 1;
+    }
+    for (i = 1; i <= (int)sim_num_nodes; i++)
+        sim_nodes[i].level = -32768;
+    for (r = 0; r < (int)sim_num_radios; r++)
+    {
+        if ((sim_radios[r].p_tx_buf = (uint8_t *)malloc(SIM_TX_BUF_SIZE)) == NULL)
+        {
+            sim_log("out of memory");
+            return 1;
+        }
+        if ((p_link != NULL) && (r == 0))
+            snprintf(sim_radios[r].link, sizeof(sim_radios[r].link), "%s", p_link);
+        else if (p_link != NULL)
+            snprintf(sim_radios[r].link, sizeof(sim_radios[r].link), "%s.%d", p_link, r);
+    }
+    sim_local = &sim_radios[0].local;
+
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigaddset(&mask, SIGUSR1);
+    sigprocmask(SIG_BLOCK, &mask, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    if (((epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0) ||
+        ((timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0) ||
+        ((signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC)) < 0))
+    {
+        sim_log("setup failed: %s", strerror(errno));
+        return 1;
+    }
+    for (r = 0; r < (int)sim_num_radios; r++)
+    {
+        if (!sim_pty_open(&sim_radios[r]))
+            return 1;
+        if (sim_epoll_add(sim_radios[r].pty_fd, EPOLLIN) < 0)
+        {
+            sim_log("epoll_ctl failed: %s", strerror(errno));
+            return 1;
+        }
+    }
+    if ((sim_epoll_add(timer_fd, EPOLLIN) < 0) || (sim_epoll_add(signal_fd, EPOLLIN) < 0))
+    {
+        sim_log("epoll_ctl failed: %s", strerror(errno));
+        return 1;
+    }
+    sim_log("%u lights, latency:%u ms jitter:%u ms loss:%u.%04u%%", sim_num_nodes, sim_latency_us / 1000, sim_jitter_us / 1000,
+            sim_loss_ppm / 10000, sim_loss_ppm % 10000);
+
+    while (sim_running)
+    {
+        if ((n = epoll_wait(epoll_fd, events, SIM_MAX_EPOLL_EVENTS, -1)) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            sim_log("epoll_wait failed: %s", strerror(errno));
+            break;
+        }
+        for (i = 0; i < n; i++)
+        {
+            for (r = 0, p_radio = NULL; (r < (int)sim_num_radios) && (p_radio == NULL); r++)
+            {
+                if (events[i].data.fd == sim_radios[r].pty_fd)
+                    p_radio = &sim_radios[r];
+            }
+            if (p_radio != NULL)
+            {
+                if (events[i].events & EPOLLIN)
+                    sim_pty_read(p_radio);
+            }
+            else if (events[i].data.fd == timer_fd)
+            {
+                if (read(timer_fd, &expirations, sizeof(expirations)) == sizeof(expirations))
+                    sim_timer_due_us = 0;
+            }
+            else if (events[i].data.fd == signal_fd)
+            {
+                while (read(signal_fd, &si, sizeof(si)) == sizeof(si))
+                {
+                    if (si.ssi_signo == SIGUSR1)
+                        sim_print_stats();
+                    else
+                        sim_running = 0;
+                }
+            }
+        }
+        // Command Status and local replies are due immediately, they go out with this batch
+        sim_send_due_events();
+    }
+    sim_print_stats();
+
+    for (r = 0; r < (int)sim_num_radios; r++)
+    {
+        if (sim_radios[r].link[0] != 0)
+            unlink(sim_radios[r].link);
+    }
+    return 0;
+}
@@ -0,0 +1,193 @@
+/*
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+*
+* Benchmark of the timer wheel used by the host timer implementations. A number of timers stay running in
+* the background while other timers are started and stopped, the time per start/stop cycle is compared with
+* the sorted list the hosts used before. timer_wheel_test checks that both expire the same timers.
+*/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <getopt.h>
+
+#include "wiced_timer_wheel.h"
+
+#define BENCH_DEFAULT_CYCLES        100000
+#define BENCH_DEFAULT_BACKGROUND    5000
+#define BENCH_MAX_TIMEOUT_MS        60000
+
+typedef struct bench_timer
+{
+    wiced_timer_wheel_node_t node;          /* must be first */
+    struct bench_timer      *p_next;        /* sorted list */
+    uint64_t                 target_time;
+    int                      active;
+} bench_timer_t;
+
+static bench_timer_t       *bench_timers;
+static bench_timer_t       *list_head;
+static wiced_timer_wheel_t  wheel;
+static uint64_t             bench_random_state = 0x853c49e6748fea9bULL;
+
+static uint32_t bench_random(void)
+{
+    bench_random_state ^= bench_random_state >> 12;
+    bench_random_state ^= bench_random_state << 25;
+    bench_random_state ^= bench_random_state >> 27;
+    return (uint32_t)((bench_random_state * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/******************************************************
+ *          Sorted list, as the hosts used before
+ ******************************************************/
+static void list_start(bench_timer_t *p_timer, uint64_t target_time)
+{
+    bench_timer_t **pp = &list_head;
+
+    p_timer->target_time = target_time;
+    while ((*pp != NULL) && ((*pp)->target_time <= target_time))
+        pp = &(*pp)->p_next;
+    p_timer->p_next = *pp;
+    *pp = p_timer;
+    p_timer->active = 1;
+}
+
+static void list_stop(bench_timer_t *p_timer)
+{
+    bench_timer_t **pp = &list_head;
+
+    if (!p_timer->active)
+        return;
+    while ((*pp != NULL) && (*pp != p_timer))
+        pp = &(*pp)->p_next;
+    if (*pp != NULL)
+        *pp = p_timer->p_next;
+    p_timer->active = 0;
+}
+
+/******************************************************
+ *          Benchmark
+ ******************************************************/
+static double bench_run(int use_wheel, uint32_t cycles, uint32_t background)
+{
+    uint64_t start, i;
+    uint32_t t;
+
+    list_head = NULL;
+    wiced_timer_wheel_init(&wheel, 0);
+    memset(bench_timers, 0, (background + 1) * sizeof(bench_timer_t));
+
+    for (t = 0; t < background; t++)
+    {
+        if (use_wheel)
+            wiced_timer_wheel_add(&wheel, &bench_timers[t].node, 1 + bench_random() % BENCH_MAX_TIMEOUT_MS);
+        else
+            list_start(&bench_timers[t], 1 + bench_random() % BENCH_MAX_TIMEOUT_MS);
+    }
+
+    // a reply timer is started for every message and stopped when the status comes back
+    start = bench_now_ns();
+    for (i = 0; i < cycles; i++)
+    {
+        if (use_wheel)
+        {
+            wiced_timer_wheel_add(&wheel, &bench_timers[background].node, 1 + bench_random() % BENCH_MAX_TIMEOUT_MS);
+            wiced_timer_wheel_remove(&wheel, &bench_timers[background].node);
+        }
+        else
+        {
+            list_start(&bench_timers[background], 1 + bench_random() % BENCH_MAX_TIMEOUT_MS);
+            list_stop(&bench_timers[background]);
+        }
+    }
+    return (double)(bench_now_ns() - start) / cycles;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -n <cycles>     start/stop cycles (default %d)\n"
+            "  -b <timers>     timers running in the background (default %d)\n"
+            "  -s <seed>       random seed\n"
+            "  -h              this help\n",
+            prog, BENCH_DEFAULT_CYCLES, BENCH_DEFAULT_BACKGROUND);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t cycles = BENCH_DEFAULT_CYCLES;
+    uint32_t background = BENCH_DEFAULT_BACKGROUND;
+    double   ns_list, ns_wheel;
+    int      opt;
+
+    while ((opt = getopt(argc, argv, "n:b:s:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n': cycles = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'b': background = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 's': bench_random_state = strtoull(optarg, NULL, 0) | 1; break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if ((cycles == 0) || ((bench_timers = calloc(background + 1, sizeof(bench_timer_t))) == NULL))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    ns_list  = bench_run(0, cycles, background);
+    ns_wheel = bench_run(1, cycles, background);
+    printf("%u start/stop cycles with %u timers running\n", cycles, background);
+    printf("  sorted list: %10.1f ns per cycle\n", ns_list);
+    printf("  timer wheel: %10.1f ns per cycle\n", ns_wheel);
+    return 0;
+}
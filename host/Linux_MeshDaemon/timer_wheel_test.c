@@ -0,0 +1,324 @@
+/*
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+*
+* Test of the timer wheel used by the host timer implementations. A few fixed cases cover the boundaries
+* of the wheel levels, timers added in the past and the timeout limit. Then random starts, stops and clock
+* steps run on the wheel and on a sorted timer list with a virtual clock, and after every step both must
+* expire exactly the same timers at the same times, the wheel in the order of the expiration times. The
+* tool exits with 1 on the first mismatch.
+*/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <getopt.h>
+
+#include "wiced_timer_wheel.h"
+
+#define TEST_DEFAULT_STEPS          1000000
+#define TEST_DEFAULT_TIMERS         1000
+
+typedef struct test_timer
+{
+    wiced_timer_wheel_node_t node;          /* must be first */
+    struct test_timer       *p_next;        /* sorted list */
+    uint64_t                 target_time;
+    uint64_t                 expired_at;    /* time the wheel expired it, 0 if it did not */
+    int                      active;
+} test_timer_t;
+
+static test_timer_t        *test_timers;
+static test_timer_t        *list_head;
+static wiced_timer_wheel_t  wheel;
+static uint64_t             test_random_state = 0x853c49e6748fea9bULL;
+
+static uint32_t test_random(void)
+{
+    test_random_state ^= test_random_state >> 12;
+    test_random_state ^= test_random_state << 25;
+    test_random_state ^= test_random_state >> 27;
+    return (uint32_t)((test_random_state * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+/******************************************************
+ *          Sorted list, the reference
+ ******************************************************/
+static void list_start(test_timer_t *p_timer, uint64_t target_time)
+{
+    test_timer_t **pp = &list_head;
+
+    p_timer->target_time = target_time;
+    while ((*pp != NULL) && ((*pp)->target_time <= target_time))
+        pp = &(*pp)->p_next;
+    p_timer->p_next = *pp;
+    *pp = p_timer;
+    p_timer->active = 1;
+}
+
+static void list_stop(test_timer_t *p_timer)
+{
+    test_timer_t **pp = &list_head;
+
+    if (!p_timer->active)
+        return;
+    while ((*pp != NULL) && (*pp != p_timer))
+        pp = &(*pp)->p_next;
+    if (*pp != NULL)
+        *pp = p_timer->p_next;
+    p_timer->active = 0;
+}
+
+static test_timer_t *list_expire(uint64_t now)
+{
+    test_timer_t *p_timer = list_head;
+
+    if ((p_timer == NULL) || (p_timer->target_time > now))
+        return NULL;
+    list_head = p_timer->p_next;
+    p_timer->active = 0;
+    return p_timer;
+}
+
+/******************************************************
+ *          Fixed cases
+ ******************************************************/
+// Starts one timer at start + timeout, returns 1 if it expires exactly at expected and not a ms earlier
+static int test_single(uint64_t start, uint64_t timeout, uint64_t expected)
+{
+    wiced_timer_wheel_node_t node;
+    wiced_timer_wheel_node_t *p_node;
+    uint64_t                 now = start;
+
+    memset(&node, 0, sizeof(node));
+    wiced_timer_wheel_init(&wheel, start);
+    wiced_timer_wheel_add(&wheel, &node, start + timeout);
+
+    // follow the wheel the way the hosts do, from one next time to the next
+    while ((now = wiced_timer_wheel_next(&wheel)) < expected)
+    {
+        if ((p_node = wiced_timer_wheel_expire(&wheel, now)) != NULL)
+        {
+            printf("FAIL: timer of %llu ms started at %llu expired at %llu, expected %llu\n", (unsigned long long)timeout,
+                   (unsigned long long)start, (unsigned long long)now, (unsigned long long)expected);
+            return 0;
+        }
+    }
+    if ((now != expected) || (wiced_timer_wheel_expire(&wheel, now) != &node) || (wiced_timer_wheel_next(&wheel) != WICED_TIMER_WHEEL_NEVER))
+    {
+        printf("FAIL: timer of %llu ms started at %llu not expired at %llu, next %llu\n", (unsigned long long)timeout,
+               (unsigned long long)start, (unsigned long long)expected, (unsigned long long)now);
+        return 0;
+    }
+    return 1;
+}
+
+static int test_fixed(void)
+{
+    static const uint64_t timeouts[] = { 1, 2, 255, 256, 257, 511, 512, 16383, 16384, 16385, 1048575, 1048576,
+                                         1048577, 67108863, 67108864, 67108865, 1000000000, 0xFFFFFFFFULL };
+    static const uint64_t starts[] = { 0, 1, 255, 256, 1000, 16383, 123456789 };
+    wiced_timer_wheel_node_t node, other;
+    uint32_t i, j;
+
+    for (i = 0; i < sizeof(starts) / sizeof(starts[0]); i++)
+    {
+        for (j = 0; j < sizeof(timeouts) / sizeof(timeouts[0]); j++)
+        {
+            if (!test_single(starts[i], timeouts[j], starts[i] + timeouts[j]))
+                return 0;
+        }
+    }
+
+    // timeouts beyond 2^32 ms are cut to the limit
+    if (!test_single(1000, 0x100000000ULL + 5, 1000 + 0xFFFFFFFFULL))
+        return 0;
+
+    // a timer added in the past expires on the next call, removing a timer twice or one not added does nothing
+    memset(&node, 0, sizeof(node));
+    memset(&other, 0, sizeof(other));
+    wiced_timer_wheel_init(&wheel, 5000);
+    wiced_timer_wheel_add(&wheel, &node, 4000);
+    wiced_timer_wheel_remove(&wheel, &other);
+    if (wiced_timer_wheel_expire(&wheel, 5000) != &node)
+    {
+        printf("FAIL: timer added in the past did not expire\n");
+        return 0;
+    }
+    wiced_timer_wheel_add(&wheel, &node, 5100);
+    wiced_timer_wheel_remove(&wheel, &node);
+    wiced_timer_wheel_remove(&wheel, &node);
+    if ((wiced_timer_wheel_next(&wheel) != WICED_TIMER_WHEEL_NEVER) || (wiced_timer_wheel_expire(&wheel, 10000) != NULL))
+    {
+        printf("FAIL: removed timer still in the wheel\n");
+        return 0;
+    }
+    return 1;
+}
+
+/******************************************************
+ *          Random operations against the list
+ ******************************************************/
+static int test_random_ops(uint32_t steps, uint32_t num_timers)
+{
+    wiced_timer_wheel_node_t *p_node;
+    test_timer_t             *p_timer;
+    uint64_t                  now = 1000, last_expire;
+    uint32_t                  expired_wheel, expired_list, i, t, op;
+
+    list_head = NULL;
+    wiced_timer_wheel_init(&wheel, now);
+    memset(test_timers, 0, num_timers * sizeof(test_timer_t));
+
+    for (i = 0; i < steps; i++)
+    {
+        p_timer = &test_timers[test_random() % num_timers];
+        op = test_random() % 10;
+        if (op < 5)
+        {
+            // short, medium and very long timeouts to use all levels
+            switch (test_random() % 4)
+            {
+            case 0:  t = test_random() % 300; break;
+            case 1:  t = test_random() % 20000; break;
+            case 2:  t = test_random() % 2000000; break;
+            default: t = test_random() % 200000000; break;
+            }
+            list_stop(p_timer);
+            list_start(p_timer, now + t);
+            wiced_timer_wheel_remove(&wheel, &p_timer->node);
+            wiced_timer_wheel_add(&wheel, &p_timer->node, now + t);
+            continue;
+        }
+        if (op < 7)
+        {
+            list_stop(p_timer);
+            wiced_timer_wheel_remove(&wheel, &p_timer->node);
+            continue;
+        }
+
+        // the wheel must never ask to be called later than the first timer expires
+        if ((list_head != NULL) ? (wiced_timer_wheel_next(&wheel) > list_head->target_time) : (wiced_timer_wheel_next(&wheel) != WICED_TIMER_WHEEL_NEVER))
+        {
+            printf("FAIL: step %u next time %llu, first timer expires at %llu\n", i, (unsigned long long)wiced_timer_wheel_next(&wheel),
+                   (unsigned long long)((list_head != NULL) ? list_head->target_time : WICED_TIMER_WHEEL_NEVER));
+            return 0;
+        }
+
+        // jump to the next wheel event or a random time, whichever comes first
+        t = (test_random() % 4 == 0) ? test_random() % 50000000 : test_random() % 1000;
+        if ((wiced_timer_wheel_next(&wheel) != WICED_TIMER_WHEEL_NEVER) && (wiced_timer_wheel_next(&wheel) < now + t) && (test_random() & 1))
+            now = wiced_timer_wheel_next(&wheel);
+        else
+            now += t;
+
+        expired_wheel = expired_list = 0;
+        last_expire = 0;
+        while ((p_node = wiced_timer_wheel_expire(&wheel, now)) != NULL)
+        {
+            if ((p_node->expire > now) || (p_node->expire < last_expire))
+            {
+                printf("FAIL: step %u time %llu timer of %llu expired after one of %llu\n", i, (unsigned long long)now,
+                       (unsigned long long)p_node->expire, (unsigned long long)last_expire);
+                return 0;
+            }
+            last_expire = p_node->expire;
+            ((test_timer_t *)p_node)->expired_at = now;
+            expired_wheel++;
+        }
+        while ((p_timer = list_expire(now)) != NULL)
+        {
+            if ((p_timer->expired_at != now) || (p_timer->node.expire != p_timer->target_time))
+            {
+                printf("FAIL: step %u time %llu timer %u of %llu not expired by the wheel\n", i, (unsigned long long)now,
+                       (uint32_t)(p_timer - test_timers), (unsigned long long)p_timer->target_time);
+                return 0;
+            }
+            p_timer->expired_at = 0;
+            expired_list++;
+        }
+        if (expired_wheel != expired_list)
+        {
+            printf("FAIL: step %u time %llu wheel expired %u timers, list %u\n", i, (unsigned long long)now, expired_wheel, expired_list);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -n <steps>      random operations (default %d)\n"
+            "  -t <timers>     timers used by the operations (default %d)\n"
+            "  -s <seed>       random seed\n"
+            "  -h              this help\n",
+            prog, TEST_DEFAULT_STEPS, TEST_DEFAULT_TIMERS);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t steps = TEST_DEFAULT_STEPS;
+    uint32_t num_timers = TEST_DEFAULT_TIMERS;
+    int      opt;
+
+    while ((opt = getopt(argc, argv, "n:t:s:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n': steps = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 't': num_timers = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 's': test_random_state = strtoull(optarg, NULL, 0) | 1; break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if ((num_timers == 0) || ((test_timers = calloc(num_timers, sizeof(test_timer_t))) == NULL))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (!test_fixed())
+        return 1;
+    if (!test_random_ops(steps, num_timers))
+        return 1;
+    printf("check: wheel and list expired the same timers at the same times in %u steps\n", steps);
+    return 0;
+}
@@ -0,0 +1,196 @@
+/*
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+*
+* Transmit side of the UART: the queue that keeps the loop from waiting for the driver, and batching of
+* the packets sent to the first UART
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+#include "mesh_daemon.h"
+
+// batching of the first UART, disabled if the threshold is 0
+static daemon_source_t *p_uart_tx_source = NULL;
+static uart_tx_queue_t *p_uart_tx_queue = NULL;
+static uint8_t          uart_tx_batch[UART_TX_BATCH_MAX];
+static uint32_t         uart_tx_batch_len = 0;
+static uint32_t         uart_tx_batch_threshold = 0;
+static uint32_t         uart_tx_batch_delay_us = 0;
+static int              uart_tx_batch_timer_fd = -1;
+static uart_tx_stats_t  uart_tx_stats;
+
+// Write as much of the buffer as the non-blocking UART takes. Returns number of bytes written, -1 on error.
+static int uart_write_some(int fd, const uint8_t *p_data, uint32_t len)
+{
+    ssize_t  written;
+    uint32_t total = 0;
+
+    while (total < len)
+    {
+        written = write(fd, p_data + total, len - total);
+        if (written > 0)
+        {
+            total += (uint32_t)written;
+            continue;
+        }
+        if ((written < 0) && (errno == EINTR))
+            continue;
+        if ((written < 0) && (errno != EAGAIN))
+        {
+            Log("UART write failed: %s", strerror(errno));
+            return -1;
+        }
+        break;
+    }
+    return (int)total;
+}
+
+// Write the queued bytes, EPOLLOUT is enabled while some are left. Returns 0 if the UART failed.
+int uart_tx_drain(daemon_source_t *p_source, uart_tx_queue_t *p_tx)
+{
+    int written = 0;
+
+    if ((p_tx->len != 0) && ((written = uart_write_some(p_source->fd, p_tx->p_buf, p_tx->len)) > 0))
+    {
+        p_tx->len -= (uint32_t)written;
+        memmove(p_tx->p_buf, p_tx->p_buf + written, p_tx->len);
+    }
+    if (written < 0)
+        p_tx->len = 0;
+
+    if ((p_tx->len != 0) != p_tx->waiting)
+    {
+        p_tx->waiting = (p_tx->len != 0);
+        daemon_source_modify(p_source, p_tx->waiting ? EPOLLIN | EPOLLOUT : EPOLLIN);
+    }
+    return written >= 0;
+}
+
+// Write the buffer to the non-blocking UART. What the driver does not take is queued behind the earlier
+// writes and sent when the UART reports EPOLLOUT, the loop never waits for the UART.
+int uart_write(daemon_source_t *p_source, uart_tx_queue_t *p_tx, const uint8_t *p_data, uint32_t len)
+{
+    int written = 0;
+
+    if ((p_tx->len == 0) && ((written = uart_write_some(p_source->fd, p_data, len)) < 0))
+        return 0;
+    if ((uint32_t)written == len)
+        return 1;
+
+    p_data += written;
+    len    -= (uint32_t)written;
+    if ((p_tx->p_buf == NULL) && ((p_tx->p_buf = (uint8_t *)malloc(UART_TX_QUEUE_MAX)) == NULL))
+        return 0;
+    if (p_tx->len + len > UART_TX_QUEUE_MAX)
+    {
+        Log("UART TX queue full, %u bytes not sent", len);
+        return 0;
+    }
+    memcpy(p_tx->p_buf + p_tx->len, p_data, len);
+    p_tx->len += len;
+    if (p_tx->len > uart_tx_stats.max_queued)
+        uart_tx_stats.max_queued = p_tx->len;
+
+    return uart_tx_drain(p_source, p_tx);
+}
+
+int uart_tx_flush(void)
+{
+    struct itimerspec disarm = { { 0, 0 }, { 0, 0 } };
+    uint32_t          len = uart_tx_batch_len;
+
+    if (len == 0)
+        return 1;
+
+    uart_tx_batch_len = 0;
+    if (uart_tx_batch_timer_fd >= 0)
+        timerfd_settime(uart_tx_batch_timer_fd, 0, &disarm, NULL);
+
+    uart_tx_stats.writes++;
+    return uart_write(p_uart_tx_source, p_uart_tx_queue, uart_tx_batch, len);
+}
+
+// Send the packet to the UART, or add it to the batch. The batch is written when the threshold is reached,
+// after the delay, or when the loop is done with the current events if there is no delay.
+int uart_send(const uint8_t *p_packet, uint32_t len)
+{
+    struct itimerspec delay = { { 0, 0 }, { 0, 0 } };
+
+    uart_tx_stats.packets++;
+    uart_tx_stats.bytes += len;
+    hci_capture_write(HCI_CAPTURE_DIR_HOST_TO_DEVICE, p_packet, len);
+
+    if ((uart_tx_batch_threshold == 0) || (len > uart_tx_batch_threshold))
+    {
+        if (!uart_tx_flush())
+            return 0;
+        uart_tx_stats.writes++;
+        return uart_write(p_uart_tx_source, p_uart_tx_queue, p_packet, len);
+    }
+    if ((uart_tx_batch_len + len > uart_tx_batch_threshold) && !uart_tx_flush())
+        return 0;
+
+    if ((uart_tx_batch_len == 0) && (uart_tx_batch_timer_fd >= 0))
+    {
+        delay.it_value.tv_sec  = uart_tx_batch_delay_us / 1000000;
+        delay.it_value.tv_nsec = (uart_tx_batch_delay_us % 1000000) * 1000;
+        timerfd_settime(uart_tx_batch_timer_fd, 0, &delay, NULL);
+    }
+    memcpy(&uart_tx_batch[uart_tx_batch_len], p_packet, len);
+    uart_tx_batch_len += len;
+
+    return (uart_tx_batch_len < uart_tx_batch_threshold) ? 1 : uart_tx_flush();
+}
+
+void uart_tx_batch_init(daemon_source_t *p_uart, uart_tx_queue_t *p_tx, uint32_t threshold, int timer_fd, uint32_t delay_us)
+{
+    p_uart_tx_source        = p_uart;
+    p_uart_tx_queue         = p_tx;
+    uart_tx_batch_len       = 0;
+    uart_tx_batch_threshold = (threshold <= UART_TX_BATCH_MAX) ? threshold : UART_TX_BATCH_MAX;
+    uart_tx_batch_delay_us  = delay_us;
+    uart_tx_batch_timer_fd  = ((threshold != 0) && (delay_us != 0)) ? timer_fd : -1;
+}
+
+void uart_tx_stats_get(uart_tx_stats_t *p_stats)
+{
+    *p_stats = uart_tx_stats;
+}
@@ -0,0 +1,339 @@
+/*
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+*
+* Test of the UART transmit code of the daemon. Batching is checked over a SOCK_SEQPACKET socket pair,
+* where each write arrives as one record, so the test sees exactly which packets were coalesced into a
+* write. The queue is checked over a pipe shrunk to one page, so that the writes are partial and the rest
+* has to wait for EPOLLOUT. Every byte sent carries a running counter and the reader checks that all of
+* them arrive once and in order. The tool exits with 1 if any check fails.
+*/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+
+#include "mesh_daemon.h"
+
+#define TX_PIPE_SIZE        4096
+
+static daemon_source_t  tx_source;
+static uart_tx_queue_t  tx_queue;
+static int              tx_reader_fd = -1;
+static uint32_t         tx_modify_events = 0;
+static uint32_t         tx_modify_count = 0;
+static uint8_t          tx_next_byte = 0;       /* counter carried by the bytes sent */
+static uint8_t          tx_expect_byte = 0;     /* counter of the next byte the reader must see */
+static uint32_t         tx_max_queued = 0;
+static int              tx_failed = 0;
+static int              verbose = 0;
+
+void Log(char *fmt, ...)
+{
+    va_list args;
+
+    if (!verbose)
+        return;
+
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+void daemon_source_modify(daemon_source_t *p_source, uint32_t events)
+{
+    tx_modify_events = events;
+    tx_modify_count++;
+}
+
+static void tx_check(const char *step, const char *what, uint32_t value, uint32_t expected)
+{
+    if (value == expected)
+    {
+        if (verbose)
+            printf("  %-20s %-24s %u\n", step, what, value);
+        return;
+    }
+    printf("FAIL: %s: %s is %u, expected %u\n", step, what, value, expected);
+    tx_failed++;
+}
+
+static int tx_send(uint32_t len)
+{
+    uint8_t  packet[UART_TX_BATCH_MAX + 256];
+    uint32_t i;
+
+    for (i = 0; i < len; i++)
+        packet[i] = tx_next_byte++;
+    return uart_send(packet, len);
+}
+
+// check the counter of the received bytes, returns number of bytes that were out of order
+static uint32_t tx_check_bytes(const uint8_t *p_data, uint32_t len)
+{
+    uint32_t bad = 0, i;
+
+    for (i = 0; i < len; i++)
+    {
+        if (p_data[i] != tx_expect_byte)
+            bad++;
+        tx_expect_byte = p_data[i] + 1;
+    }
+    return bad;
+}
+
+// read every record waiting on the socket pair and compare the lengths with the expected writes
+static void tx_check_records(const char *step, const uint32_t *p_lens, int num)
+{
+    uint8_t  record[UART_TX_BATCH_MAX + 256];
+    uint32_t bad = 0;
+    ssize_t  len;
+    int      count = 0;
+    char     what[32];
+
+    while ((len = recv(tx_reader_fd, record, sizeof(record), MSG_DONTWAIT)) > 0)
+    {
+        if (count < num)
+        {
+            snprintf(what, sizeof(what), "write %d length", count);
+            tx_check(step, what, (uint32_t)len, p_lens[count]);
+        }
+        bad += tx_check_bytes(record, (uint32_t)len);
+        count++;
+    }
+    tx_check(step, "writes", count, num);
+    tx_check(step, "bytes out of order", bad, 0);
+}
+
+static void tx_check_batching(void)
+{
+    static const uint32_t not_batched[] = { 10, 10, 10 };
+    static const uint32_t one_batch[]   = { 30 };
+    static const uint32_t threshold[]   = { 40, 64 };
+    static const uint32_t large[]       = { 10, 100 };
+    static const uint32_t delayed[]     = { 10 };
+    struct itimerspec armed;
+    struct pollfd     pfd;
+    uart_tx_stats_t   stats;
+    uint64_t          expirations;
+    int               sv[2], timer_fd;
+
+    if ((socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK, 0, sv) < 0) ||
+        ((timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK)) < 0))
+    {
+        perror("socketpair");
+        exit(1);
+    }
+    tx_source.fd = sv[0];
+    tx_reader_fd = sv[1];
+
+    // without batching every packet is a write
+    uart_tx_batch_init(&tx_source, &tx_queue, 0, -1, 0);
+    tx_send(10);
+    tx_send(10);
+    tx_send(10);
+    tx_check_records("not batched", not_batched, 3);
+    uart_tx_stats_get(&stats);
+    tx_check("not batched", "writes counted", stats.writes, 3);
+    tx_check("not batched", "packets counted", stats.packets, 3);
+
+    // packets wait in the batch until it is flushed
+    uart_tx_batch_init(&tx_source, &tx_queue, 64, -1, 0);
+    tx_send(10);
+    tx_send(10);
+    tx_send(10);
+    tx_check_records("batched", NULL, 0);
+    uart_tx_flush();
+    tx_check_records("batched flush", one_batch, 1);
+
+    // a packet that does not fit writes the batch first, reaching the threshold writes it at once
+    tx_send(20);
+    tx_send(20);
+    tx_send(30);
+    tx_send(34);
+    tx_check_records("threshold", threshold, 2);
+
+    // a packet larger than the threshold is written on its own after the batch
+    tx_send(10);
+    tx_send(100);
+    tx_check_records("large packet", large, 2);
+
+    // with the delay the first packet arms the timer and the flush disarms it
+    uart_tx_batch_init(&tx_source, &tx_queue, 64, timer_fd, 2000);
+    tx_send(10);
+    tx_check_records("delay", NULL, 0);
+    timerfd_gettime(timer_fd, &armed);
+    tx_check("delay", "timer armed", (armed.it_value.tv_sec != 0) || (armed.it_value.tv_nsec != 0), 1);
+    pfd.fd = timer_fd;
+    pfd.events = POLLIN;
+    tx_check("delay", "timer expired", poll(&pfd, 1, 1000), 1);
+    if (read(timer_fd, &expirations, sizeof(expirations)) == sizeof(expirations))
+        uart_tx_flush();
+    tx_check_records("delay flush", delayed, 1);
+
+    tx_send(60);
+    tx_send(4);
+    timerfd_gettime(timer_fd, &armed);
+    tx_check("delay threshold", "timer armed", (armed.it_value.tv_sec != 0) || (armed.it_value.tv_nsec != 0), 0);
+
+    close(timer_fd);
+    close(sv[0]);
+    close(sv[1]);
+    tx_expect_byte = tx_next_byte;
+}
+
+// read what the pipe holds, returns number of bytes read
+static uint32_t tx_read_pipe(uint32_t max, uint32_t *p_bad)
+{
+    uint8_t  buf[TX_PIPE_SIZE];
+    uint32_t total = 0;
+    ssize_t  len;
+
+    while ((total < max) && ((len = read(tx_reader_fd, buf, (max - total < sizeof(buf)) ? max - total : sizeof(buf))) > 0))
+    {
+        *p_bad += tx_check_bytes(buf, (uint32_t)len);
+        total += (uint32_t)len;
+    }
+    return total;
+}
+
+static void tx_check_queue(void)
+{
+    uart_tx_stats_t stats;
+    uint32_t sent = 0, received = 0, bad = 0, rounds = 0;
+    int      fds[2], in_pipe, i, ok;
+
+    if (pipe2(fds, O_NONBLOCK) < 0)
+    {
+        perror("pipe2");
+        exit(1);
+    }
+    fcntl(fds[1], F_SETPIPE_SZ, TX_PIPE_SIZE);
+    tx_source.fd = fds[1];
+    tx_reader_fd = fds[0];
+    uart_tx_batch_init(&tx_source, &tx_queue, 0, -1, 0);
+
+    // the driver takes what fits in the pipe, the rest waits for EPOLLOUT
+    for (i = 0; i < 10; i++)
+    {
+        tx_send(1000);
+        sent += 1000;
+    }
+    ioctl(tx_reader_fd, FIONREAD, &in_pipe);
+    tx_check("partial write", "bytes written", in_pipe != 0, 1);
+    tx_check("partial write", "queued", tx_queue.len, sent - (uint32_t)in_pipe);
+    tx_check("partial write", "EPOLLOUT enabled", tx_queue.waiting && (tx_modify_events & EPOLLOUT), 1);
+    tx_max_queued = tx_queue.len;
+
+    // once something is queued a new packet goes behind it even if the driver has room again
+    received += tx_read_pipe(1500, &bad);
+    tx_send(1000);
+    sent += 1000;
+    ioctl(tx_reader_fd, FIONREAD, &in_pipe);
+    tx_check("behind the queue", "queued", tx_queue.len, sent - received - (uint32_t)in_pipe);
+    tx_check("behind the queue", "queue grew", tx_queue.len > tx_max_queued, 1);
+    if (tx_queue.len > tx_max_queued)
+        tx_max_queued = tx_queue.len;
+
+    // every EPOLLOUT writes more of the queue until it is empty
+    while ((tx_queue.len != 0) && (rounds++ < 100))
+    {
+        received += tx_read_pipe(TX_PIPE_SIZE, &bad);
+        uart_tx_drain(&tx_source, &tx_queue);
+    }
+    received += tx_read_pipe(sent, &bad);
+    tx_check("drained", "bytes received", received, sent);
+    tx_check("drained", "bytes out of order", bad, 0);
+    tx_check("drained", "EPOLLOUT disabled", tx_queue.waiting || (tx_modify_events & EPOLLOUT), 0);
+    uart_tx_stats_get(&stats);
+    tx_check("drained", "max queued", stats.max_queued, tx_max_queued);
+
+    // nothing is read, the packet that does not fit in the queue is refused
+    ok = 1;
+    for (i = 0; (i < (int)(UART_TX_QUEUE_MAX / 1000) + 10) && ok; i++)
+        ok = tx_send(1000);
+    tx_check("queue full", "packet refused", ok, 0);
+    tx_check("queue full", "queue within limit", tx_queue.len <= UART_TX_QUEUE_MAX, 1);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -v              print every checked value and trace logs\n"
+            "  -h              this help\n",
+            prog);
+}
+
+int main(int argc, char **argv)
+{
+    int opt;
+
+    while ((opt = getopt(argc, argv, "vh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'v': verbose = 1; break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    tx_check_batching();
+    tx_check_queue();
+
+    if (tx_failed != 0)
+    {
+        printf("check: %d checks failed\n", tx_failed);
+        return 1;
+    }
+    printf("check: batches coalesced and partial writes queued in order\n");
+    return 0;
+}
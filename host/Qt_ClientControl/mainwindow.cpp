@@ -83,6 +83,11 @@ extern "C"
 #include "wiced_mesh_client_dfu.h"
 #endif
 
+#ifdef WICED_TIMER_LINUX
+#include <QSocketNotifier>
+#include "wiced_timer_linux.h"
+#endif
+
 typedef unsigned int UINT32;
 #define wiced_bt_free_buffer free
 
@@ -432,6 +437,16 @@ MainWindow::MainWindow(QWidget *parent) :
     // g_dfu_timer = new QTimer(this);
     // connect(g_dfu_timer , SIGNAL(timeout()), this, SLOT(on_dfu_timer_timeout()));
 
+#ifdef WICED_TIMER_LINUX
+    // the timers are executed in the UI thread, the same as the HCI events
+    int timer_fd = linux_timer_init();
+    if (timer_fd >= 0)
+    {
+        QSocketNotifier *p_timer_notifier = new QSocketNotifier(timer_fd, QSocketNotifier::Read, this);
+        connect(p_timer_notifier, &QSocketNotifier::activated, this, [](){ linux_timer_process(); });
+    }
+#endif
+
     SetupCommPortUI();
     ui->cbOnOff->addItem("On");
     ui->cbOnOff->addItem("Off");
@@ -604,7 +619,7 @@ void ProcessScanReport(LPBYTE p_data, uint16_t len)
 
     str += QString::asprintf("OOB:%x URI hash:%x", oob, uri_hash);
     Log((char *)str.toStdString().c_str());
-    wiced_bt_free_buffer(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void MainWindow::ProcessData(DWORD opcode, LPBYTE p_data, DWORD len)
@@ -697,6 +712,15 @@ void MainWindow::closeEvent(QCloseEvent *event)
     m_settings.sync();
 
     CloseCommPort();
+
+#ifdef WICED_TIMER_LINUX
+    linux_timer_stats_t timer_stats;
+    linux_timer_stats_get(&timer_stats, 0);
+    Log("Timers fired:%llu late avg:%llu us max:%u us, <1ms:%u <2ms:%u <5ms:%u <10ms:%u <50ms:%u more:%u",
+        (unsigned long long)timer_stats.fired, (unsigned long long)(timer_stats.fired ? timer_stats.late_us_total / timer_stats.fired : 0),
+        timer_stats.late_us_max, timer_stats.late_hist[0], timer_stats.late_hist[1], timer_stats.late_hist[2],
+        timer_stats.late_hist[3], timer_stats.late_hist[4], timer_stats.late_hist[5]);
+#endif
     if (p_control_test_results)
     {
         free(p_control_test_results);
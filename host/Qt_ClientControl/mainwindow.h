@@ -48,6 +48,7 @@
 
 #include <QMutex>
 #include <QWaitCondition>
+#include "hci_framer.h"
 
 extern bool g_bUseBsa;
 
@@ -214,6 +215,9 @@ public:
 };
 
 
+// Size of the serial receive ring, must be a power of 2 and hold the largest packet accepted (5 + 1024)
+#define HCI_RX_RING_SIZE    4096
+
 class Worker : public QObject
 {
     Q_OBJECT
@@ -227,6 +231,12 @@ signals:
 public:
     DWORD ReadNewHciPacket(BYTE * pu8Buffer, int bufLen, int * pOffset);
     DWORD ReadPort(BYTE *lpBytes, DWORD dwLen);
+    DWORD ReadPortAvailable(BYTE *lpBytes, DWORD dwMax);
+
+private:
+    // received bytes not yet framed into HCI packets
+    BYTE         m_rxRing[HCI_RX_RING_SIZE];
+    hci_framer_t m_rxFramer;
 };
 
 #endif // MAINWINDOW_H
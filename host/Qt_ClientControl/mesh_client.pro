@@ -57,6 +57,7 @@ wiced {
     SOURCES += ../../../../libraries/mesh_client_lib/wiced_bt_mesh_db.c
     SOURCES += ../../../../libraries/mesh_client_lib/wiced_mesh_api.c
     SOURCES += ../../../../libraries/mesh_client_lib/meshdb.c
+    SOURCES += ../../../../libraries/mesh_client_lib/hci_framer.c
 
     DEFINES += PROVISION_SCAN_REPORT_INCLUDE_BDADDR
 
@@ -72,6 +73,7 @@ mtb_release {
     SOURCES += ../../mesh_client_lib/wiced_bt_mesh_db.c
     SOURCES += ../../mesh_client_lib/wiced_mesh_api.c
     SOURCES += ../../mesh_client_lib/meshdb.c
+    SOURCES += ../../mesh_client_lib/hci_framer.c
 
     DEFINES += PROVISION_SCAN_REPORT_INCLUDE_BDADDR
 
@@ -104,6 +106,7 @@ bsa {
     SOURCES += ../../../brcm/bsa/server/mesh/common/libraries/mesh_client_lib/wiced_bt_mesh_db.c
     SOURCES += ../../../brcm/bsa/server/mesh/common/libraries/mesh_client_lib/meshdb.c
     SOURCES += ../../../brcm/bsa/server/mesh/common/libraries/mesh_client_lib/wiced_mesh_client.c
+    SOURCES += ../../../brcm/bsa/server/mesh/common/libraries/mesh_client_lib/hci_framer.c
 
     BSA_PATH = ../../../brcm/bsa
 
@@ -145,6 +148,15 @@ unix {
     SOURCES += btspy_ux.c
 }
 
+# on Linux all wiced timers run from one timerfd in the UI thread instead of a QTimer object each
+mtb_release:unix:!macx {
+    SOURCES -= qtwicedtimer.cpp
+    HEADERS -= qtwicedtimer.h
+    SOURCES += ../../mesh_client_lib/wiced_timer_linux.c
+    SOURCES += ../../mesh_client_lib/wiced_timer_wheel.c
+    DEFINES += WICED_TIMER_LINUX
+}
+
 win32 {
     DEFINES += __windows__
     SOURCES += btspy_win32.c
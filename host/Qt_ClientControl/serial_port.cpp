@@ -243,75 +243,29 @@ void MainWindow::ClearPort()
 
 DWORD Worker::ReadNewHciPacket(BYTE * pu8Buffer, int bufLen, int * pOffset)
 {
-    int dwLen, len = 0, offset = 0;
+    uint32_t offset = 0, len = 0, space;
+    BYTE *p_space;
+    int dwLen, framed;
 
-    dwLen = ReadPort(pu8Buffer, 1);
-
-    if ((int)dwLen <= 0 || m_bClosing)
-        return (-1);
-
-    offset++;
-
-    switch (pu8Buffer[0])
+    // serve packets already in the ring, go to the port only when the next one is incomplete
+    while ((framed = hci_framer_frame(&m_rxFramer, pu8Buffer, (uint32_t)bufLen, &offset, &len)) == HCI_FRAMER_INCOMPLETE)
     {
-    case HCI_EVENT_PKT:
-    {
-        dwLen = ReadPort(&pu8Buffer[offset], 2);
-        if(dwLen == 2)
-        {
-            len = pu8Buffer[2];
-            offset += 2;
-            Log("HCI_EVENT_PKT len %d", len);
-        }
-        else
-            Log("error HCI_EVENT_PKT, needed 2 got %d", dwLen);
-    }
-        break;
+        p_space = hci_framer_space(&m_rxFramer, &space);
 
-    case HCI_ACL_DATA_PKT:
-    {
-        dwLen = ReadPort( &pu8Buffer[offset], 4);
-        if(dwLen == 4)
-        {
-            len = pu8Buffer[3] | (pu8Buffer[4] << 8);
-            offset += 4;
-            Log("HCI_ACL_DATA_PKT, len %d", len);
-        }
-        else
-            Log("error HCI_ACL_DATA_PKT needed 4 got %d", dwLen);
-    }
-        break;
+        dwLen = ReadPortAvailable(p_space, space);
 
-    case HCI_WICED_PKT:
-    {
-        dwLen = ReadPort(&pu8Buffer[offset], 4);
-        if(dwLen == 4)
-        {
-            len = pu8Buffer[3] | (pu8Buffer[4] << 8);
-            offset += 4;
-        }
-        else
-            Log("error HCI_WICED_PKT,  needed 4 got %d", dwLen);
-    }
-        break;
-    }
+        if (dwLen <= 0 || m_bClosing)
+            return (-1);
 
-    if(len > 1024)
-    {
-        Log("bad packet length %d", len);
-        return -1; // bad packet
+        hci_framer_commit(&m_rxFramer, dwLen);
     }
-
-    if (len)
+    if (framed != HCI_FRAMER_PACKET)
     {
-        DWORD lenRd = (len < (DWORD)(bufLen-offset)) ? len : (DWORD)(bufLen-offset);
-        dwLen = ReadPort( &pu8Buffer[offset], lenRd);
-        if(dwLen != lenRd)
-            Log("read error to read %d, read %d", lenRd, dwLen);
+        Log("bad packet length");
+        return (-1); // bad packet
     }
 
     *pOffset = offset;
-
     return len;
 }
 
@@ -322,6 +276,9 @@ void Worker::userial_read_thread()
     int           offset = 0, pktLen;
     int           packetType;
 
+    // drop anything left over from the previous connection, payloads over 1024 bytes are bad packets
+    hci_framer_init(&m_rxFramer, m_rxRing, sizeof(m_rxRing), 1024);
+
     // While the port is not closed, keep reading
     while (!m_bClosing)
     {
@@ -455,6 +412,38 @@ DWORD Worker::ReadPort(BYTE *lpBytes, DWORD dwLen)
     return dwTotalRead;
 }
 
+// Read whatever the serial port has received, waits until at least one byte is available
+DWORD Worker::ReadPortAvailable(BYTE *lpBytes, DWORD dwMax)
+{
+    qint64 dwRead;
+
+    if (!p_qt_serial_port)
+        return 0;
+
+    QMutex mutex;
+    while (!m_bClosing)
+    {
+        dwRead = p_qt_serial_port->read((char *)lpBytes, dwMax);
+
+        if (m_bClosing)
+            return 0;
+
+        if (dwRead < 0)
+        {
+            Log("Error in port read");
+            return -1;
+        }
+        if (dwRead > 0)
+            return (DWORD)dwRead;
+
+        //serial_read_wait is set when there is more data or when the serial port is closed
+        mutex.lock();
+        gMainWindow->serial_read_wait.wait(&mutex, 200);
+        mutex.unlock();
+    }
+    return 0;
+}
+
 void CloseCommPort()
 {
     if(p_qt_serial_port)
@@ -364,6 +364,9 @@ BOOL CClientControlApp::InitInstance( )
     TickCountInitValue = GetTickCount64() / 1000;
 #endif
 
+    // 1 traces every UART packet, N traces 1 in N packets, 0 disables the traces
+    DumpDataSetSampling(GetProfileInt(L"LightControl", L"TraceSample", 1));
+
     CClientDialog dlg(_T("Mesh Client Control"));
     m_pMainWnd = &dlg;
     dlg.DoModal();
@@ -639,6 +639,7 @@ void CConfig::ProcessScanCapabilitiesStatus(LPBYTE p_data, DWORD len)
     if (p_event == NULL)
         return;
     wsprintf(buf, L"Scan Info Status from %04x max items:%d", p_event->src, p_data[0]);
+    wiced_bt_mesh_release_event(p_event);
     m_trace->SetCurSel(m_trace->AddString(buf));
 }
 
@@ -649,6 +650,7 @@ void CConfig::ProcessScanStatus(LPBYTE p_data, DWORD len)
     if (p_event == NULL)
         return;
     wsprintf(buf, L"Scan Status from %04x status:%d state:%d max items:%d timeout:%d", p_event->src, p_data[0], p_data[1], p_data[2], p_data[3]);
+    wiced_bt_mesh_release_event(p_event);
     m_trace->SetCurSel(m_trace->AddString(buf));
 }
 
@@ -661,6 +663,7 @@ void CConfig::ProcessScanReport(LPBYTE p_data, DWORD len)
     WCHAR uuid[50] = { 0 };
     uint16_t provisioner_addr = p_event->src;
     int8_t   rssi = p_data[0];
+    wiced_bt_mesh_release_event(p_event);
     for (int i = 1; i < 17; i++)
         wsprintf(&uuid[wcslen(uuid)], L"%02x ", p_data[i]);
     SetDlgItemText(IDC_PROVISION_UUID, uuid);
@@ -683,6 +686,7 @@ void CConfig::ProcessExtendedScanReport(LPBYTE p_data, DWORD len)
         return;
     uint16_t provisioner_addr = p_event->src;
     uint8_t  status = p_data[0];
+    wiced_bt_mesh_release_event(p_event);
 
     wsprintf(buf, L"From %04x status:%d Unprovisioned Device UUID:", provisioner_addr, status);
     for (int i = 1; i < 17; i++)
@@ -722,7 +726,7 @@ void CConfig::ProcessProvisionEnd(LPBYTE p_data, DWORD len)
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_data, (uint16_t *)&len);
     if (p_event == NULL)
         return;
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
     WCHAR buf[80];
     USHORT provisioner_addr = p_data[0] + ((USHORT)p_data[1] << 8);
     USHORT addr = p_data[2] + ((USHORT)p_data[3] << 8);
@@ -750,7 +754,7 @@ void CConfig::ProcessProvisionLinkReport(LPBYTE p_data, DWORD len)
     WCHAR buf[160];
     wsprintf(buf, L"Provision: Link Report from:%04x status:%d remote provisioner state:%d reason:%d over_gatt:%d", p_event->src, p_data[0], p_data[1], p_data[2], p_data[3]);
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessProvisionDeviceCapabilities(LPBYTE p_data, DWORD len)
@@ -758,7 +762,7 @@ void CConfig::ProcessProvisionDeviceCapabilities(LPBYTE p_data, DWORD len)
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_data, (uint16_t *)&len);
     if (p_event == NULL)
         return;
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
     WCHAR buf[280];
     USHORT provisioner_addr = p_data[0] + ((USHORT)p_data[1] << 8);
     BYTE elements_num = p_data[2];
@@ -779,7 +783,7 @@ void CConfig::ProcessProvisionOobDataRequest(LPBYTE p_data, DWORD len)
     wiced_bt_mesh_event_t* p_event = wiced_bt_mesh_event_from_hci_header(&p_data, (uint16_t*)&len);
     if (p_event == NULL)
         return;
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
     WCHAR buf[280];
     USHORT provisioner_addr = p_data[0] + ((USHORT)p_data[1] << 8);
     BYTE static_oob_type = p_data[2];
@@ -874,7 +878,7 @@ void CConfig::ProcessProxyConnectionStatus(LPBYTE p_data, DWORD len)
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_data, (uint16_t *)&len);
     if (p_event == NULL)
         return;
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
     WCHAR buf[80];
     wsprintf(buf, L"Proxy connection status:%d", p_data[4]);
     m_trace->SetCurSel(m_trace->AddString(buf));
@@ -889,7 +893,7 @@ void CConfig::ProcessNodeResetStatus(LPBYTE p_data, DWORD len)
         return;
     wsprintf(buf, L"Node Reset Status from:%x", p_event->src);
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 BYTE GetNumElements(BYTE *p_data, USHORT len)
@@ -995,7 +999,7 @@ void CConfig::ProcessCompositionDataStatus(LPBYTE p_data, DWORD len)
             m_trace->SetCurSel(m_trace->AddString(buf));
         }
     }
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessFriendStatus(LPBYTE p_data, DWORD len)
@@ -1006,7 +1010,7 @@ void CConfig::ProcessFriendStatus(LPBYTE p_data, DWORD len)
         return;
     wsprintf(buf, L"Friend Status from:%x state:%d", p_event->src, p_data[0]);
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessKeyRefreshPhaseStatus(LPBYTE p_data, DWORD len)
@@ -1019,7 +1023,7 @@ void CConfig::ProcessKeyRefreshPhaseStatus(LPBYTE p_data, DWORD len)
     USHORT net_key_inx = p_data[1] + ((USHORT)p_data[2] << 8);
     wsprintf(buf, L"Key Refresh Phase Status from:%x Status:%d NetKeyIdx:%x state:%d", p_event->src, status, net_key_inx, p_data[3]);
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessGattProxyStatus(LPBYTE p_data, DWORD len)
@@ -1030,7 +1034,7 @@ void CConfig::ProcessGattProxyStatus(LPBYTE p_data, DWORD len)
         return;
     wsprintf(buf, L"GATT Proxy Status from:%x state:%d", p_event->src, p_data[0]);
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessRelayStatus(LPBYTE p_data, DWORD len)
@@ -1041,7 +1045,7 @@ void CConfig::ProcessRelayStatus(LPBYTE p_data, DWORD len)
         return;
     wsprintf(buf, L"Relay Status from:%x state:%d count:%d interval:%d", p_event->src, p_data[0], p_data[1], p_data[2] + ((USHORT)p_data[3] << 8));
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessDefaultTtlStatus(LPBYTE p_data, DWORD len)
@@ -1052,7 +1056,7 @@ void CConfig::ProcessDefaultTtlStatus(LPBYTE p_data, DWORD len)
         return;
     wsprintf(buf, L"Default TTL Status from:%x TTL:%d", p_event->src, p_data[0]);
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessNodeIdentityStatus(LPBYTE p_data, DWORD len)
@@ -1063,7 +1067,7 @@ void CConfig::ProcessNodeIdentityStatus(LPBYTE p_data, DWORD len)
         return;
     wsprintf(buf, L"Node Identity Status from:%x status:%d net key idx:%d identity:%d", p_event->src, p_data[0], p_data[1] + ((USHORT)p_data[2] << 8), p_data[3]);
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessBeaconStatus(LPBYTE p_data, DWORD len)
@@ -1074,7 +1078,7 @@ void CConfig::ProcessBeaconStatus(LPBYTE p_data, DWORD len)
         return;
     wsprintf(buf, L"Beacon Status from:%x state:%d\n", p_event->src, p_data[0]);
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessModelPublicationStatus(LPBYTE p_data, DWORD len)
@@ -1090,7 +1094,7 @@ void CConfig::ProcessModelPublicationStatus(LPBYTE p_data, DWORD len)
         p_data[13] + ((ULONG)p_data[14] << 8) + ((ULONG)p_data[15] << 16) + ((ULONG)p_data[16] << 24),
         p_data[17], p_data[18] + ((ULONG)p_data[19] << 8));
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessModelSubscriptionStatus(LPBYTE p_data, DWORD len)
@@ -1103,7 +1107,7 @@ void CConfig::ProcessModelSubscriptionStatus(LPBYTE p_data, DWORD len)
         p_data[3] + ((USHORT)p_data[4] << 8), (USHORT)p_data[5] + ((USHORT)p_data[6] << 8),
         p_data[7] + ((USHORT)p_data[8] << 8));
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessModelSubscriptionList(LPBYTE p_data, DWORD len)
@@ -1123,7 +1127,7 @@ void CConfig::ProcessModelSubscriptionList(LPBYTE p_data, DWORD len)
         len -= 2;
     }
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessNetKeyStatus(LPBYTE p_data, DWORD len)
@@ -1134,7 +1138,7 @@ void CConfig::ProcessNetKeyStatus(LPBYTE p_data, DWORD len)
         return;
     wsprintf(buf, L"NetKey Status from:%x status:%d NetKey Index:%x", p_event->src, p_data[0], p_data[1] + ((ULONG)p_data[2] << 8));
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessNetKeyList(LPBYTE p_data, DWORD len)
@@ -1151,7 +1155,7 @@ void CConfig::ProcessNetKeyList(LPBYTE p_data, DWORD len)
         len -= 2;
     }
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessAppKeyStatus(LPBYTE p_data, DWORD len)
@@ -1162,7 +1166,7 @@ void CConfig::ProcessAppKeyStatus(LPBYTE p_data, DWORD len)
         return;
     wsprintf(buf, L"AppKey Status from:%x status:%d NetKey Index:%x ApptKey Index:%x", p_event->src, p_data[0], p_data[1] + ((ULONG)p_data[2] << 8), p_data[3] + ((ULONG)p_data[4] << 8));
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessAppKeyList(LPBYTE p_data, DWORD len)
@@ -1181,7 +1185,7 @@ void CConfig::ProcessAppKeyList(LPBYTE p_data, DWORD len)
         len -= 2;
     }
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessModelAppStatus(LPBYTE p_data, DWORD len)
@@ -1194,7 +1198,7 @@ void CConfig::ProcessModelAppStatus(LPBYTE p_data, DWORD len)
         p_data[3] + ((USHORT)p_data[4] << 8), (USHORT)p_data[5] + ((USHORT)p_data[6] << 8),
         p_data[7] + ((ULONG)p_data[8] << 8));
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessModelAppList(LPBYTE p_data, DWORD len)
@@ -1214,7 +1218,7 @@ void CConfig::ProcessModelAppList(LPBYTE p_data, DWORD len)
         len -= 2;
     }
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessHearbeatSubscriptionStatus(LPBYTE p_data, DWORD len)
@@ -1228,7 +1232,7 @@ void CConfig::ProcessHearbeatSubscriptionStatus(LPBYTE p_data, DWORD len)
         p_data[5] + ((ULONG)p_data[6] << 8) + ((ULONG)p_data[7] << 16) + ((ULONG)p_data[8] << 24),
         p_data[9] + ((USHORT)p_data[10] << 8), p_data[11], p_data[12]);
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessHearbeatPublicationStatus(LPBYTE p_data, DWORD len)
@@ -1243,7 +1247,7 @@ void CConfig::ProcessHearbeatPublicationStatus(LPBYTE p_data, DWORD len)
         p_data[7] + ((USHORT)p_data[8] << 8), p_data[11],
         p_data[12], p_data[13], p_data[14], p_data[15], p_data[16], p_data[17] + ((USHORT)p_data[18] << 8));
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessNetworkTransmitParamsStatus(LPBYTE p_data, DWORD len)
@@ -1255,7 +1259,7 @@ void CConfig::ProcessNetworkTransmitParamsStatus(LPBYTE p_data, DWORD len)
     wsprintf(buf, L"Network Transmit Params Status from:%x count:%d interval:%d", p_event->src, p_data[0],
         p_data[1] + ((ULONG)p_data[2] << 8) + ((ULONG)p_data[3] << 16) + ((ULONG)p_data[4] << 24));
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessHealthCurrentStatus(LPBYTE p_data, DWORD len)
@@ -1275,7 +1279,7 @@ void CConfig::ProcessHealthCurrentStatus(LPBYTE p_data, DWORD len)
         len --;
     }
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessHealthFaultStatus(LPBYTE p_data, DWORD len)
@@ -1295,7 +1299,7 @@ void CConfig::ProcessHealthFaultStatus(LPBYTE p_data, DWORD len)
         len--;
     }
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessHealthPeriodStatus(LPBYTE p_data, DWORD len)
@@ -1307,7 +1311,7 @@ void CConfig::ProcessHealthPeriodStatus(LPBYTE p_data, DWORD len)
     USHORT app_key_idx = p_data[0] + ((USHORT)p_data[1] << 8);
     wsprintf(buf, L"Health Period Status from:%x AppKeyIdx:%x Divisor:%d", p_event->src, app_key_idx, p_data[2]);
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessHealthAttentionStatus(LPBYTE p_data, DWORD len)
@@ -1319,7 +1323,7 @@ void CConfig::ProcessHealthAttentionStatus(LPBYTE p_data, DWORD len)
     USHORT app_key_idx = p_data[0] + ((USHORT)p_data[1] << 8);
     wsprintf(buf, L"Health Attention Status from:%x AppKeyIdx:%x Timer:%d", p_event->src, app_key_idx, p_data[2]);
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessLpnPollTimeoutStatus(LPBYTE p_data, DWORD len)
@@ -1332,7 +1336,7 @@ void CConfig::ProcessLpnPollTimeoutStatus(LPBYTE p_data, DWORD len)
     USHORT poll_timeout = p_data[2] + ((ULONG)p_data[3] << 8) + ((ULONG)p_data[4] << 16) + ((ULONG)p_data[5] << 24);
     wsprintf(buf, L"LPN Poll Timeout Status from:%x Addr:%x PollTimeout:%d", p_event->src, lpn_addr, poll_timeout);
     m_trace->SetCurSel(m_trace->AddString(buf));
-    free(p_event);
+    wiced_bt_mesh_release_event(p_event);
 }
 
 void CConfig::ProcessProxyFilterStatus(LPBYTE p_data, DWORD len)
@@ -50,6 +50,41 @@ static bool isKp3 = FALSE;
 static int SOCK_PORT_NUM[] = { 12012, 12012, 12013 };
 extern int host_mode_instance;
 
+// Traces and coredumps of the UART traffic are formatted by a background thread. The threads that send and
+// receive only copy the raw bytes to a queue. Traces are dropped when only the reserved slots are left, a
+// coredump record takes a reserved slot or waits for the background thread to free one, it is never dropped.
+#define DUMP_QUEUE_SIZE             256             // must be a power of 2
+#define DUMP_COREDUMP_RESERVED      32              // slots only coredump records can use
+#define DUMP_MAX_DATA               260             // coredump events are 3 + 255 bytes
+
+#define DUMP_RECORD_DATA            0
+#define DUMP_RECORD_COREDUMP        1
+#define DUMP_RECORD_COREDUMP_END    2
+
+typedef struct
+{
+    BYTE        type;
+    const char* direction;                          // "Rcvd" or "Xmit"
+    UINT32      length;                             // length of the packet
+    UINT32      max_lines;
+    UINT32      data_len;                           // bytes of the packet in data
+    BYTE        data[DUMP_MAX_DATA];
+} DUMP_RECORD;
+
+static DUMP_RECORD      dump_queue[DUMP_QUEUE_SIZE];
+static DWORD            dump_queue_head = 0;        // free running
+static DWORD            dump_queue_tail = 0;
+static DWORD            dump_queue_dropped = 0;
+static CRITICAL_SECTION dump_queue_cs;
+static CONDITION_VARIABLE dump_queue_space;         // signalled when the background thread takes a record
+static HANDLE           dump_queue_event = NULL;
+static HANDLE           dump_thread = NULL;
+static INIT_ONCE        dump_init_once = INIT_ONCE_STATIC_INIT;
+static volatile LONG    dump_sample = 1;            // 0 disables the traces, N traces 1 in N packets
+static volatile LONG    dump_sample_count = 0;
+
+static void DumpCoredumpQueue(BYTE type, void* p, UINT32 length);
+
 //
 //Class ComHelper Implementation
 //
@@ -63,6 +98,10 @@ ComHelper::ComHelper(HWND hWnd) :
     memset(&m_OverlapWrite, 0, sizeof(m_OverlapWrite));
     m_ClientSocket = INVALID_SOCKET;
 
+    // no payload limit, the ring holds the largest HCI packet
+    m_rxRing = (LPBYTE)malloc(HCI_RX_RING_SIZE);
+    hci_framer_init(&m_rxFramer, m_rxRing, HCI_RX_RING_SIZE, 0);
+
     InitializeCriticalSection(&m_write_cs);
 }
 
@@ -70,6 +109,7 @@ ComHelper::~ComHelper()
 {
     ClosePort();
     DeleteCriticalSection(&m_write_cs);
+    free(m_rxRing);
 }
 
 DWORD WINAPI ReadThread(LPVOID lpdwThreadParam)
@@ -465,7 +505,6 @@ DWORD ComHelper::Read(LPBYTE lpBytes, DWORD dwLen)
 DWORD ComHelper::SendWicedCommand(UINT16 command, LPBYTE payload, DWORD len)
 {
     BYTE    data[1040];
-    char    descr[30];
     int     header = 0;
 
     data[header++] = HCI_WICED_PKT;
@@ -476,8 +515,8 @@ DWORD ComHelper::SendWicedCommand(UINT16 command, LPBYTE payload, DWORD len)
 
     memcpy(&data[header], payload, len);
 
-    sprintf_s(descr, sizeof(descr), "Xmit %3u bytes: ", len + header);
-    DumpData(descr, data, len + header, 1);
+    if (DumpDataSampled())
+        DumpDataQueue("Xmit", data, len + header, 1);
 
     DWORD written = Write(data, len + header);
 
@@ -552,43 +591,48 @@ DWORD ComHelper::Write(LPBYTE lpBytes, DWORD dwLen)
     return dwTotalWritten;
 }
 
-DWORD ComHelper::ReadNewHciPacket(BYTE* pu8Buffer, int bufLen, int* pOffset)
+//  read whatever the device has received, blocks until at least one byte is available
+//  Parameters:
+//  lpBytes - Pointer to the buffer
+//  dwMax   - size of the buffer
+//  Return:	Number of byte read from the device.
+//
+DWORD ComHelper::ReadAvailable(LPBYTE lpBytes, DWORD dwMax)
 {
-    DWORD dwLen, len = 0, offset = 0;
-
-    dwLen = Read(&pu8Buffer[offset], 1);
+    DWORD   dwErrors = 0;
+    COMSTAT comStat;
+    DWORD   dwRead;
 
-    if ( (dwLen == 0) || (m_bClosing) )
+    dwRead = Read(lpBytes, 1);
+    if ((dwRead == 0) || m_bClosing)
         return (0);
 
-    offset++;
+    // take everything the driver has already queued in the same pass
+    if (ClearCommError(m_handle, &dwErrors, &comStat) && (comStat.cbInQue != 0) && (dwMax > 1))
+        dwRead += Read(lpBytes + 1, min(comStat.cbInQue, dwMax - 1));
 
-    switch (pu8Buffer[0])
-    {
-    case HCI_EVENT_PKT:
-        Read(&pu8Buffer[offset], 2);
-        len = pu8Buffer[2];
-        offset += 2;
-        break;
+    return dwRead;
+}
 
-    case HCI_ACL_DATA_PKT:
-        Read(&pu8Buffer[offset], 4);
-        len = pu8Buffer[3] | (pu8Buffer[4] << 8);
-        offset += 4;
-        break;
+DWORD ComHelper::ReadNewHciPacket(BYTE* pu8Buffer, int bufLen, int* pOffset)
+{
+    DWORD   dwLen;
+    UINT32  offset = 0, len = 0, space;
+    BYTE*   p_space;
 
-    case HCI_WICED_PKT:
-        Read(&pu8Buffer[offset], 4);
-        len = pu8Buffer[3] | (pu8Buffer[4] << 8);
-        offset += 4;
-        break;
-    }
+    // serve packets already in the ring, go to the device only when the next one is incomplete
+    while (hci_framer_frame(&m_rxFramer, pu8Buffer, (UINT32)bufLen, &offset, &len) != HCI_FRAMER_PACKET)
+    {
+        p_space = hci_framer_space(&m_rxFramer, &space);
 
-    if (len)
-        Read(&pu8Buffer[offset], min(len, (DWORD)bufLen));
+        dwLen = ReadAvailable(p_space, space);
 
-    *pOffset = offset;
+        if ((dwLen == 0) || (m_bClosing))
+            return (0);
 
+        hci_framer_commit(&m_rxFramer, dwLen);
+    }
+    *pOffset = offset;
     return len;
 }
 
@@ -596,10 +640,12 @@ DWORD ComHelper::ReadWorker()
 {
     unsigned char au8Hdr[4096 + 6];
     int           offset = 0, pktLen;
-    char          descr[30];
     int           packetType;
     int           bytesToWrite = 0;
-    static FILE*  fp_coredump = NULL;
+    BOOL          coredump = FALSE;
+
+    // drop anything left over from the previous connection
+    hci_framer_reset(&m_rxFramer);
 
     while (1)
     {
@@ -611,13 +657,14 @@ DWORD ComHelper::ReadWorker()
         if (pktLen + offset == 0)
             continue;
 
-        sprintf_s(descr, sizeof(descr), "Rcvd %3u bytes: ", pktLen + offset);
-        DumpData(descr, au8Hdr, pktLen + offset, 1);
+        if (DumpDataSampled())
+            DumpDataQueue("Rcvd", au8Hdr, pktLen + offset, 1);
 
         packetType = au8Hdr[0];
-        if ((fp_coredump != NULL) && ((au8Hdr[0] != HCI_EVENT_PKT) || (au8Hdr[1] != 0xff) || (au8Hdr[2] != 0xf4)))
+        if (coredump && ((au8Hdr[0] != HCI_EVENT_PKT) || (au8Hdr[1] != 0xff) || (au8Hdr[2] != 0xf4)))
         {
-            fclose(fp_coredump);
+            DumpCoredumpQueue(DUMP_RECORD_COREDUMP_END, NULL, 0);
+            coredump = FALSE;
         }
 
         switch (packetType)
@@ -626,20 +673,8 @@ DWORD ComHelper::ReadWorker()
             // Save coredump in a file
             if ((au8Hdr[1] == 0xff) && (au8Hdr[2] == 0xf4))
             {
-                char buf[3 * 260];
-                if (fp_coredump == NULL)
-                {
-                    sprintf_s(buf, "c:\\temp\\mesh\\coredump%d.hex", host_mode_instance);
-                    fopen_s(&fp_coredump, buf, "w");
-                }
-                if (fp_coredump)
-                {
-                    sprintf_s(buf, sizeof(buf), "%02x %02x %02x ", au8Hdr[0], au8Hdr[1], au8Hdr[2]);
-                    for (int i = 0; i < au8Hdr[2]; i++)
-                        sprintf_s(&buf[9 + (3 * i)], sizeof(buf) - 9 - (3 * i), "%02x ", au8Hdr[3 + i]);
-                    strcat_s(buf, sizeof(buf), "\r");
-                    fputs(buf, fp_coredump);
-                }
+                DumpCoredumpQueue(DUMP_RECORD_COREDUMP, au8Hdr, pktLen + offset);
+                coredump = TRUE;
             }
             else
                 HandleHciEvent(au8Hdr, pktLen + offset);
@@ -664,6 +699,157 @@ DWORD ComHelper::ReadWorker()
     return 0;
 }
 
+// Formats the queued records, runs until the application exits
+static DWORD WINAPI DumpThread(LPVOID lpdwThreadParam)
+{
+    static DUMP_RECORD record;
+    char               descr[30];
+    char               buf[3 * DUMP_MAX_DATA + 2];
+    FILE*              fp_coredump = NULL;
+    DWORD              dropped;
+
+    while (1)
+    {
+        WaitForSingleObject(dump_queue_event, INFINITE);
+
+        while (1)
+        {
+            EnterCriticalSection(&dump_queue_cs);
+            if (dump_queue_tail == dump_queue_head)
+            {
+                LeaveCriticalSection(&dump_queue_cs);
+                break;
+            }
+            memcpy(&record, &dump_queue[dump_queue_tail & (DUMP_QUEUE_SIZE - 1)], sizeof(record));
+            dump_queue_tail++;
+            dropped = dump_queue_dropped;
+            dump_queue_dropped = 0;
+            LeaveCriticalSection(&dump_queue_cs);
+            WakeConditionVariable(&dump_queue_space);
+
+            if (dropped != 0)
+            {
+                sprintf_s(buf, sizeof(buf), "Trace queue full, %u records dropped\n", dropped);
+                OutputDebugStringA(buf);
+            }
+
+            switch (record.type)
+            {
+            case DUMP_RECORD_DATA:
+                sprintf_s(descr, sizeof(descr), "%s %3u bytes: ", record.direction, record.length);
+                DumpData(descr, record.data, record.data_len, record.max_lines);
+                break;
+
+            case DUMP_RECORD_COREDUMP:
+                if (fp_coredump == NULL)
+                {
+                    sprintf_s(buf, "c:\\temp\\mesh\\coredump%d.hex", host_mode_instance);
+                    fopen_s(&fp_coredump, buf, "w");
+                }
+                if (fp_coredump)
+                {
+                    for (UINT32 i = 0; i < record.data_len; i++)
+                        sprintf_s(&buf[3 * i], sizeof(buf) - (3 * i), "%02x ", record.data[i]);
+                    strcat_s(buf, sizeof(buf), "\r");
+                    fputs(buf, fp_coredump);
+                }
+                break;
+
+            case DUMP_RECORD_COREDUMP_END:
+                if (fp_coredump != NULL)
+                {
+                    fclose(fp_coredump);
+                    fp_coredump = NULL;
+                }
+                break;
+            }
+        }
+    }
+    return 0;
+}
+
+static BOOL CALLBACK DumpInit(PINIT_ONCE InitOnce, PVOID Parameter, PVOID* Context)
+{
+    InitializeCriticalSection(&dump_queue_cs);
+    InitializeConditionVariable(&dump_queue_space);
+    dump_queue_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+    dump_thread = CreateThread(NULL, 0, DumpThread, NULL, 0, NULL);
+    if (dump_thread != NULL)
+        SetThreadPriority(dump_thread, THREAD_PRIORITY_BELOW_NORMAL);
+    return TRUE;
+}
+
+static void DumpRecordQueue(BYTE type, const char* direction, void* p, UINT32 length, UINT32 data_len, UINT32 max_lines)
+{
+    DUMP_RECORD* p_record;
+
+    InitOnceExecuteOnce(&dump_init_once, DumpInit, NULL, NULL);
+
+    EnterCriticalSection(&dump_queue_cs);
+    if (type == DUMP_RECORD_DATA)
+    {
+        if (dump_queue_head - dump_queue_tail >= DUMP_QUEUE_SIZE - DUMP_COREDUMP_RESERVED)
+        {
+            dump_queue_dropped++;
+            LeaveCriticalSection(&dump_queue_cs);
+            return;
+        }
+    }
+    else
+    {
+        // the reader waits rather than losing part of the coredump
+        while ((dump_queue_head - dump_queue_tail == DUMP_QUEUE_SIZE) && (dump_thread != NULL))
+            SleepConditionVariableCS(&dump_queue_space, &dump_queue_cs, INFINITE);
+    }
+    if (dump_queue_head - dump_queue_tail == DUMP_QUEUE_SIZE)
+    {
+        // no background thread to empty the queue
+        dump_queue_dropped++;
+        LeaveCriticalSection(&dump_queue_cs);
+        return;
+    }
+    p_record = &dump_queue[dump_queue_head & (DUMP_QUEUE_SIZE - 1)];
+    p_record->type = type;
+    p_record->direction = direction;
+    p_record->length = length;
+    p_record->max_lines = max_lines;
+    p_record->data_len = min(data_len, (UINT32)DUMP_MAX_DATA);
+    if (p != NULL)
+        memcpy(p_record->data, p, p_record->data_len);
+    dump_queue_head++;
+    LeaveCriticalSection(&dump_queue_cs);
+
+    SetEvent(dump_queue_event);
+}
+
+// Coredumps are written whether the traces are enabled or not
+static void DumpCoredumpQueue(BYTE type, void* p, UINT32 length)
+{
+    DumpRecordQueue(type, NULL, p, length, length, 0);
+}
+
+// Set 1 to trace every packet, N to trace 1 in N packets and 0 to disable the traces
+void DumpDataSetSampling(UINT32 one_in_n)
+{
+    dump_sample = (LONG)one_in_n;
+}
+
+// Returns TRUE if the packet should be traced, the check is cheap when the traces are disabled
+BOOL DumpDataSampled()
+{
+    LONG sample = dump_sample;
+
+    if (sample <= 1)
+        return (sample == 1);
+    return ((InterlockedIncrement(&dump_sample_count) % sample) == 0);
+}
+
+// Queues the first max_lines lines of the packet, the trace is printed by the background thread
+void DumpDataQueue(const char* direction, void* p, UINT32 length, UINT32 max_lines)
+{
+    DumpRecordQueue(DUMP_RECORD_DATA, direction, p, length, min(length, 32 * max_lines), max_lines);
+}
+
 // prints data in ascii format to the std out
 void DumpData(char* description, void* p, UINT32 length, UINT32 max_lines)
 {
@@ -803,6 +989,12 @@ DWORD ComHelperHostMode::Read(LPBYTE lpBytes, DWORD dwLen)
     return (len);
 }
 
+// recv returns whatever is queued on the socket, stay below the garbage check in Read
+DWORD ComHelperHostMode::ReadAvailable(LPBYTE lpBytes, DWORD dwMax)
+{
+    return Read(lpBytes, min(dwMax, (DWORD)2000));
+}
+
 //  Write a number of bytes to Serial Bus Device
 //  Parameters:
 //  lpBytes Pointer to the buffer
@@ -33,10 +33,15 @@
 #ifndef CONTROL_COMM_H
 #define CONTROL_COMM_H
 
+#include "hci_framer.h"
+
 //**************************************************************************************************
 //*** Definitions for BTW Serial Bus
 //**************************************************************************************************
 
+// Size of the receive ring, must be a power of 2 and hold the largest HCI packet (5 + 0xffff)
+#define HCI_RX_RING_SIZE    0x20000
+
 // Helper class to print debug messages to Debug Console
 class DebugHelper
 {
@@ -67,6 +72,7 @@ public:
 
     // read data from device
     virtual DWORD Read(LPBYTE b, DWORD dwLen);
+    virtual DWORD ReadAvailable(LPBYTE b, DWORD dwMax);
     virtual DWORD ReadNewHciPacket(BYTE* pu8Buffer, int bufLen, int* pOffset);
     virtual DWORD ReadWorker();
 
@@ -93,6 +99,10 @@ protected:
     BOOL    m_RtsOn;
     int     m_comPort;
     CRITICAL_SECTION m_write_cs;
+
+    // received bytes not yet framed into HCI packets
+    LPBYTE       m_rxRing;
+    hci_framer_t m_rxFramer;
 };
 
 
@@ -109,10 +119,14 @@ public:
     virtual BOOL OpenPort(int port, int baudRate);
     virtual void ClosePort();
     virtual DWORD Read(LPBYTE b, DWORD dwLen);
+    virtual DWORD ReadAvailable(LPBYTE b, DWORD dwMax);
     virtual DWORD Write(LPBYTE b, DWORD dwLen);
     virtual BOOL IsOpened();
 };
 
 extern void DumpData(char* description, void* p, UINT32 length, UINT32 max_lines);
+extern void DumpDataQueue(const char* direction, void* p, UINT32 length, UINT32 max_lines);
+extern BOOL DumpDataSampled();
+extern void DumpDataSetSampling(UINT32 one_in_n);
 
 #endif
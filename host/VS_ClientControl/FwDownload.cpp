@@ -78,13 +78,65 @@ BYTE minidriver[] =
     0x4e, 0xfc, 0x04, 0x00, 0x00, 0x22, 0x00
 };
 
+// The download switches to the maximum baud rate as soon as the ROM answers the HCI Reset. The HCD file is
+// parsed into memory before the download starts, adjacent records are merged and sent in the largest Write RAM
+// commands the minidriver accepts with several commands outstanding.
+#define FW_DOWNLOAD_INITIAL_BAUD_RATE   115200
+#define FW_DOWNLOAD_MAX_BAUD_RATE       3000000
+#define FW_DOWNLOAD_MAX_WRITE_LEN       248     // 4 bytes of address and the data fit the 255 byte HCI command, 4 byte aligned
+#define FW_DOWNLOAD_WINDOW              4       // Write RAM commands sent before the first one is complete
+
+#define HCD_LAUNCH_COMMAND              0x4E
+#define HCD_WRITE_COMMAND               0x4C
+#define HCD_COMMAND_BYTE2               0xFC
+
+// Contiguous memory written by one or more records of the HCD file
+typedef struct
+{
+    ULONG   nAddr;
+    ULONG   nLen;
+    BYTE    *pData;
+} HCD_REGION;
+
+typedef struct
+{
+    HCD_REGION  *pRegions;
+    ULONG       nRegions;
+    ULONG       nRecords;       // records in the file
+    ULONG       nWrites;        // Write RAM commands needed for the regions
+    ULONG       nBytes;
+    BOOL        bLaunch;
+    ULONG       nLaunchAddr;
+    BYTE        *pData;         // data of all regions
+} HCD_IMAGE;
+
 BYTE    m_received_evt[261];
 DWORD   m_received_evt_len;
 HANDLE  m_hHciEvent = 0;
 HANDLE m_event;
 
+// Write RAM commands in flight, the events are counted by the read thread
+BOOL            m_bWritePipelined = FALSE;
+HANDLE          m_hWriteCredits = 0;
+volatile LONG   m_nWriteErrors = 0;
+ULONG           m_nWritesSent = 0;
+ULONG           m_nWritesComplete = 0;
+ULONG           m_arWriteAddr[FW_DOWNLOAD_WINDOW];
+ULONG           m_nFailedAddr = 0;
+
 void FwDownloadProcessEvent(LPBYTE p_data, DWORD len)
 {
+    BYTE arWriteComplete[] = { 0x04, 0x0E, 0x04, 0x01, 0x4C, 0xFC };
+
+    if (m_bWritePipelined && (len == sizeof(arWriteComplete) + 1) && (memcmp(p_data, arWriteComplete, sizeof(arWriteComplete)) == 0))
+    {
+        // commands complete in order, the address of the failed one is still in the window
+        if ((p_data[6] != 0) && (InterlockedIncrement(&m_nWriteErrors) == 1))
+            m_nFailedAddr = m_arWriteAddr[m_nWritesComplete % FW_DOWNLOAD_WINDOW];
+        m_nWritesComplete++;
+        ReleaseSemaphore(m_hWriteCredits, 1, NULL);
+        return;
+    }
     m_received_evt_len = len;
     memcpy(m_received_evt, p_data, len);
     SetEvent(m_hHciEvent);
@@ -162,127 +214,195 @@ BOOL SetBaudRate(int nBaudRate, bool update)
     return (TRUE);
 }
 
-BOOL SendHcdRecord(ULONG nAddr, ULONG nRecSize, BYTE * arDataBuffer)
+// Move the device and the COM port to the new baud rate, the port stays at the old rate if the device refuses
+BOOL SwitchBaudRate(int nBaudRate)
 {
-    BYTE arHciCommandTx[261] = { 0x01, 0x4C, 0xFC, 0x00 };
-    BYTE arBytesExpectedRx[] = { 0x04, 0x0E, 0x04, 0x01, 0x4C, 0xFC, 0x00 };
-
-    arHciCommandTx[3] = (BYTE)(4 + nRecSize);
-    arHciCommandTx[4] = (nAddr & 0xff);
-    arHciCommandTx[5] = (nAddr >> 8) & 0xff;
-    arHciCommandTx[6] = (nAddr >> 16) & 0xff;
-    arHciCommandTx[7] = (nAddr >> 24) & 0xff;
-    memcpy(&arHciCommandTx[8], arDataBuffer, nRecSize);
-
-    m_received_evt_len = 0;
-    ResetEvent(m_hHciEvent);
-    m_ComHelper->Write(arHciCommandTx, 4 + 4 + nRecSize);
-    if (WaitForSingleObject(m_hHciEvent, 1000) == WAIT_OBJECT_0)
-    {
-        if (m_received_evt_len == sizeof(arBytesExpectedRx))
-            if (memcmp(m_received_evt, arBytesExpectedRx, m_received_evt_len) == 0)
-                return TRUE;
-            else
-                OutputDebugString(L"Wrong bytes in the event\n");
-        else
-            OutputDebugString(L"Wrong length of the event\n");
-    }
-    else
-    {
-        OutputDebugString(L"Response timeout\n");
-    }
-    return FALSE;
+    if (!SendUpdateBaudRate(nBaudRate))
+        return FALSE;
+    SetBaudRate(nBaudRate, 1);
+    return TRUE;
 }
 
-BYTE *ReadNextMinidriverRecord(BYTE *pData, ULONG * nAddr, ULONG * nRecSize, UINT8 * arDataBuffer, BOOL * bIsLaunch)
+void HcdImageFree(HCD_IMAGE *pImage)
 {
-    const   int HCD_LAUNCH_COMMAND = 0x4E;
-    const   int HCD_WRITE_COMMAND = 0x4C;
-    const   int HCD_COMMAND_BYTE2 = 0xFC;
-
-    BYTE     arRecHeader[3];
-    BYTE     byRecLen;
-    BYTE     arAddress[4];
-
-    BYTE *pbuf = pData;
-
-    *bIsLaunch = FALSE;
+    free(pImage->pRegions);
+    free(pImage->pData);
+    memset(pImage, 0, sizeof(HCD_IMAGE));
+}
 
-    memcpy(arRecHeader, pbuf, 3);
-    pbuf += 3;
+// Parse the records of an HCD image up to the launch record. Records that continue where the previous one
+// ended are merged into one region.
+BOOL HcdImageParse(const BYTE *pHcd, ULONG nHcdLen, HCD_IMAGE *pImage)
+{
+    const BYTE *p = pHcd, *pEnd = pHcd + nHcdLen;
+    HCD_REGION *pRegion = NULL;
+    ULONG       nAddr, nRecSize;
 
-    byRecLen = arRecHeader[2];
+    memset(pImage, 0, sizeof(HCD_IMAGE));
 
-    if ((byRecLen < 4) || (arRecHeader[1] != HCD_COMMAND_BYTE2) ||
-        ((arRecHeader[0] != HCD_WRITE_COMMAND) && (arRecHeader[0] != HCD_LAUNCH_COMMAND)))
+    // every record has at least 7 bytes, the data is never larger than the file
+    pImage->pRegions = (HCD_REGION *)malloc((nHcdLen / 7 + 1) * sizeof(HCD_REGION));
+    pImage->pData = (BYTE *)malloc(nHcdLen + 1);
+    if ((pImage->pRegions == NULL) || (pImage->pData == NULL))
     {
-        Log(L"Wrong HCD file format trying to read the command information");
+        Log(L"Not enough memory for HCD file of %d bytes", nHcdLen);
+        HcdImageFree(pImage);
         return FALSE;
     }
 
-    memcpy(arAddress, pbuf, sizeof(arAddress));
-    pbuf += sizeof(arAddress);
-
-    *nAddr = arAddress[0] + (arAddress[1] << 8) + (arAddress[2] << 16) + (arAddress[3] << 24);
-
-    *bIsLaunch = (arRecHeader[0] == HCD_LAUNCH_COMMAND);
-
-    *nRecSize = byRecLen - 4;
-
-    if (*nRecSize > 0)
+    while (p < pEnd)
     {
-        memcpy(arDataBuffer, pbuf, *nRecSize);
-        pbuf += *nRecSize;
+        if ((pEnd - p < 7) || (p[2] < 4) || (p[1] != HCD_COMMAND_BYTE2) ||
+            ((p[0] != HCD_WRITE_COMMAND) && (p[0] != HCD_LAUNCH_COMMAND)))
+        {
+            Log(L"Wrong HCD file format trying to read the command information");
+            HcdImageFree(pImage);
+            return FALSE;
+        }
+        nAddr = p[3] + (p[4] << 8) + (p[5] << 16) + (p[6] << 24);
+        nRecSize = p[2] - 4;
+        if ((ULONG)(pEnd - p) < 7 + nRecSize)
+        {
+            Log(L"Not enough HCD data bytes in record");
+            HcdImageFree(pImage);
+            return FALSE;
+        }
+        pImage->nRecords++;
+
+        if (p[0] == HCD_LAUNCH_COMMAND)
+        {
+            pImage->bLaunch = TRUE;
+            pImage->nLaunchAddr = nAddr;
+            break;
+        }
+        if (nRecSize != 0)
+        {
+            if ((pRegion == NULL) || (pRegion->nAddr + pRegion->nLen != nAddr))
+            {
+                pRegion = &pImage->pRegions[pImage->nRegions++];
+                pRegion->nAddr = nAddr;
+                pRegion->nLen = 0;
+                pRegion->pData = &pImage->pData[pImage->nBytes];
+            }
+            memcpy(&pRegion->pData[pRegion->nLen], p + 7, nRecSize);
+            pRegion->nLen += nRecSize;
+            pImage->nBytes += nRecSize;
+        }
+        p += 7 + nRecSize;
     }
-    return pbuf;
+    for (ULONG i = 0; i < pImage->nRegions; i++)
+        pImage->nWrites += (pImage->pRegions[i].nLen + FW_DOWNLOAD_MAX_WRITE_LEN - 1) / FW_DOWNLOAD_MAX_WRITE_LEN;
+    return TRUE;
 }
 
-BOOL ReadNextHCDRecord(FILE * fHCD, ULONG * nAddr, ULONG * nRecSize, UINT8 * arDataBuffer, BOOL * bIsLaunch)
+BOOL HcdImageReadFile(char *sHCDFileName, HCD_IMAGE *pImage)
 {
-    const   int HCD_LAUNCH_COMMAND = 0x4E;
-    const   int HCD_WRITE_COMMAND = 0x4C;
-    const   int HCD_COMMAND_BYTE2 = 0xFC;
-
-    BYTE     arRecHeader[3];
-    BYTE     byRecLen;
-    BYTE     arAddress[4];
-
-    *bIsLaunch = FALSE;
-
-    if (fread(arRecHeader, 1, 3, fHCD) != 3)               // Unexpected EOF
-        return false;
-
-    byRecLen = arRecHeader[2];
+    FILE *fHCD = NULL;
+    BYTE *pHcd;
+    long  nHcdLen;
+    BOOL  res;
 
-    if ((byRecLen < 4) || (arRecHeader[1] != HCD_COMMAND_BYTE2) ||
-        ((arRecHeader[0] != HCD_WRITE_COMMAND) && (arRecHeader[0] != HCD_LAUNCH_COMMAND)))
+    fHCD = fopen(sHCDFileName, "rb");
+    if (fHCD == NULL)
     {
-        Log(L"Wrong HCD file format trying to read the command information");
+        Log(L"Failed to open HCD file %S", sHCDFileName);
         return FALSE;
     }
+    fseek(fHCD, 0, SEEK_END);
+    nHcdLen = ftell(fHCD);
+    fseek(fHCD, 0, SEEK_SET);
 
-    if (fread(arAddress, sizeof(arAddress), 1, fHCD) != 1)      // Unexpected EOF
+    if ((nHcdLen <= 0) || ((pHcd = (BYTE *)malloc(nHcdLen)) == NULL))
     {
-        Log(L"Wrong HCD file format trying to read 32-bit address");
+        Log(L"Failed to read HCD file %S", sHCDFileName);
+        fclose(fHCD);
         return FALSE;
     }
+    if (fread(pHcd, 1, nHcdLen, fHCD) != (size_t)nHcdLen)
+    {
+        Log(L"Failed to read HCD file %S", sHCDFileName);
+        res = FALSE;
+    }
+    else
+    {
+        res = HcdImageParse(pHcd, (ULONG)nHcdLen, pImage);
+    }
+    free(pHcd);
+    fclose(fHCD);
+    return res;
+}
 
-    *nAddr = arAddress[0] + (arAddress[1] << 8) + (arAddress[2] << 16) + (arAddress[3] << 24);
-
-    *bIsLaunch = (arRecHeader[0] == HCD_LAUNCH_COMMAND);
-
-    *nRecSize = byRecLen - 4;
-
-    if (*nRecSize > 0)
+// Send the regions of the image in Write RAM commands. Up to FW_DOWNLOAD_WINDOW commands are outstanding, the
+// read thread returns a credit for every command complete.
+BOOL SendHcdImage(HCD_IMAGE *pImage, ULONG *pFailedAddr)
+{
+    BYTE        arHciCommandTx[4 + 4 + FW_DOWNLOAD_MAX_WRITE_LEN] = { 0x01, 0x4C, 0xFC, 0x00 };
+    HCD_REGION  *pRegion;
+    ULONG       i, offset, nAddr, nLen;
+    ULONG       nCredits = 0;
+    BOOL        res = TRUE;
+
+    m_hWriteCredits = CreateSemaphore(NULL, FW_DOWNLOAD_WINDOW, FW_DOWNLOAD_WINDOW, NULL);
+    m_nWriteErrors = 0;
+    m_nWritesSent = 0;
+    m_nWritesComplete = 0;
+    m_bWritePipelined = TRUE;
+
+    for (i = 0; res && (i < pImage->nRegions); i++)
     {
-        if (fread(arDataBuffer, 1, *nRecSize, fHCD) != *nRecSize)   // Unexpected EOF
+        pRegion = &pImage->pRegions[i];
+        for (offset = 0; offset < pRegion->nLen; offset += nLen)
         {
-            Log(L"Not enough HCD data bytes in record");
-            return FALSE;
+            nAddr = pRegion->nAddr + offset;
+            nLen = min(pRegion->nLen - offset, (ULONG)FW_DOWNLOAD_MAX_WRITE_LEN);
+
+            if (WaitForSingleObject(m_hWriteCredits, 1000) != WAIT_OBJECT_0)
+            {
+                OutputDebugString(L"Response timeout\n");
+                *pFailedAddr = m_arWriteAddr[m_nWritesComplete % FW_DOWNLOAD_WINDOW];
+                res = FALSE;
+                break;
+            }
+            if (m_nWriteErrors != 0)
+            {
+                OutputDebugString(L"Wrong bytes in the event\n");
+                *pFailedAddr = m_nFailedAddr;
+                res = FALSE;
+                break;
+            }
+            arHciCommandTx[3] = (BYTE)(4 + nLen);
+            arHciCommandTx[4] = (nAddr & 0xff);
+            arHciCommandTx[5] = (nAddr >> 8) & 0xff;
+            arHciCommandTx[6] = (nAddr >> 16) & 0xff;
+            arHciCommandTx[7] = (nAddr >> 24) & 0xff;
+            memcpy(&arHciCommandTx[8], &pRegion->pData[offset], nLen);
+
+            m_arWriteAddr[m_nWritesSent++ % FW_DOWNLOAD_WINDOW] = nAddr;
+            m_ComHelper->Write(arHciCommandTx, 4 + 4 + nLen);
         }
     }
 
-    return TRUE;
+    // wait for the commands still outstanding
+    while (res && (nCredits < FW_DOWNLOAD_WINDOW))
+    {
+        if (WaitForSingleObject(m_hWriteCredits, 1000) != WAIT_OBJECT_0)
+        {
+            OutputDebugString(L"Response timeout\n");
+            *pFailedAddr = m_arWriteAddr[m_nWritesComplete % FW_DOWNLOAD_WINDOW];
+            res = FALSE;
+        }
+        nCredits++;
+    }
+    if (res && (m_nWriteErrors != 0))
+    {
+        OutputDebugString(L"Wrong bytes in the event\n");
+        *pFailedAddr = m_nFailedAddr;
+        res = FALSE;
+    }
+    m_bWritePipelined = FALSE;
+    CloseHandle(m_hWriteCredits);
+    m_hWriteCredits = 0;
+    return res;
 }
 
 BOOL SendLaunchRam(ULONG addr)
@@ -292,8 +412,8 @@ BOOL SendLaunchRam(ULONG addr)
 
     arHciCommandTx[4] = addr & 0xff;
     arHciCommandTx[5] = (addr >> 8) & 0xff;
-    arHciCommandTx[4] = (addr >> 16) & 0xff;
-    arHciCommandTx[4] = (addr >> 24) & 0xff;
+    arHciCommandTx[6] = (addr >> 16) & 0xff;
+    arHciCommandTx[7] = (addr >> 24) & 0xff;
     m_received_evt_len = 0;
     ResetEvent(m_hHciEvent);
     m_ComHelper->Write(arHciCommandTx, sizeof(arHciCommandTx));
@@ -308,90 +428,109 @@ BOOL SendLaunchRam(ULONG addr)
 // CLightControl message handlers
 int FwDownload(char *sHCDFileName)
 {
-    FILE *fHCD = NULL;
-    LONG  nVeryFirstAddress = 0;
+    HCD_IMAGE   minidriverImage, appImage;
+    ULONGLONG   startTime, minidriverTime, eraseTime, endTime;
+    ULONG       nFailedAddr = 0;
+    int         nBaudRate = FW_DOWNLOAD_INITIAL_BAUD_RATE;
 
-    m_hHciEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    startTime = GetTickCount64();
 
-    fHCD = fopen(sHCDFileName, "rb");
-    if (fHCD == NULL)
-    {
-        Log(L"Failed to open HCD file %s", sHCDFileName);
+    if (m_hHciEvent == 0)
+        m_hHciEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+    // parse everything before touching the device, a bad file does not leave it in the minidriver
+    if (!HcdImageReadFile(sHCDFileName, &appImage))
         return -1;
+
+    if (!HcdImageParse(minidriver, sizeof(minidriver), &minidriverImage) || !minidriverImage.bLaunch)
+    {
+        Log(L"Wrong minidriver image");
+        HcdImageFree(&appImage);
+        return -4;
     }
+    Log(L"HCD file %d bytes in %d records, %d regions, %d writes", appImage.nBytes, appImage.nRecords, appImage.nRegions, appImage.nWrites);
 
-    SetBaudRate(115200, 0);
+    SetBaudRate(FW_DOWNLOAD_INITIAL_BAUD_RATE, 0);
     if (!SendHciReset())
     {
-        SetBaudRate(3000000, 1);
+        SetBaudRate(FW_DOWNLOAD_MAX_BAUD_RATE, 1);
+        nBaudRate = FW_DOWNLOAD_MAX_BAUD_RATE;
         if (!SendHciReset())
         {
             Log(L"Failed to HCI Reset");
-            fclose(fHCD);
+            HcdImageFree(&minidriverImage);
+            HcdImageFree(&appImage);
             return -2;
         }
     }
-
     Log(L"HCI Reset success");
+
+    // the minidriver is downloaded at the maximum rate as well if the ROM can switch
+    if ((nBaudRate != FW_DOWNLOAD_MAX_BAUD_RATE) && SwitchBaudRate(FW_DOWNLOAD_MAX_BAUD_RATE))
+    {
+        nBaudRate = FW_DOWNLOAD_MAX_BAUD_RATE;
+        Log(L"Set Baud Rate %d success", nBaudRate);
+    }
+
     if (!SendDownloadMinidriver())
     {
         Log(L"Failed to send download minidriver");
-        fclose(fHCD);
+        HcdImageFree(&minidriverImage);
+        HcdImageFree(&appImage);
         return -3;
     }
     Log(L"Download minidriver start success, downloading minidriver...");
-    ULONG   nAddr, nRecSize;
-    BYTE    arDataBuffer[256];
-    BOOL    bIsLaunch = FALSE;
-    BYTE    *pMinidriver = minidriver;
-    while (((pMinidriver = ReadNextMinidriverRecord(pMinidriver, &nAddr, &nRecSize, arDataBuffer, &bIsLaunch)) != NULL) && !bIsLaunch)
+    if (!SendHcdImage(&minidriverImage, &nFailedAddr))
     {
-        if (!SendHcdRecord(nAddr, nRecSize, arDataBuffer))
-        {
-            Log(L"Failed to send hcd portion at %x. Clean and rebuild application. Unplug and plug back board. Retry.", nAddr);
-            fclose(fHCD);
-            return -4;
-        }
-        if (bIsLaunch)
-            break;
+        Log(L"Failed to send hcd portion at %x. Clean and rebuild application. Unplug and plug back board. Retry.", nFailedAddr);
+        HcdImageFree(&minidriverImage);
+        HcdImageFree(&appImage);
+        return -4;
     }
-    if (!SendLaunchRam(nAddr))
+    if (!SendLaunchRam(minidriverImage.nLaunchAddr))
     {
         Log(L"Failed to send launch RAM");
-        fclose(fHCD);
+        HcdImageFree(&minidriverImage);
+        HcdImageFree(&appImage);
         return -5;
     }
-    if (!SendUpdateBaudRate(3000000))
+    HcdImageFree(&minidriverImage);
+    minidriverTime = GetTickCount64();
+
+    // the minidriver starts at the rate of the ROM, make sure it runs at the maximum
+    if (!SwitchBaudRate(FW_DOWNLOAD_MAX_BAUD_RATE))
     {
-        Log(L"Failed to send update baud rate");
-        fclose(fHCD);
-        return -6;
+        if ((nBaudRate == FW_DOWNLOAD_INITIAL_BAUD_RATE) ||
+            !SetBaudRate(FW_DOWNLOAD_INITIAL_BAUD_RATE, 0) || !SwitchBaudRate(FW_DOWNLOAD_MAX_BAUD_RATE))
+        {
+            Log(L"Failed to send update baud rate");
+            HcdImageFree(&appImage);
+            return -6;
+        }
     }
     Log(L"Set Baud Rate success");
-    SetBaudRate(3000000, 1);
     Log(L"Download minidriver success, chip erase");
 
     if (!SendChipErase())
     {
         Log(L"Failed to Chip Erase");
-        fclose(fHCD);
+        HcdImageFree(&appImage);
         return -7;
     }
+    eraseTime = GetTickCount64();
 
     Log(L"Success, downloading application...");
 
-    while (ReadNextHCDRecord(fHCD, &nAddr, &nRecSize, arDataBuffer, &bIsLaunch))
+    if (!SendHcdImage(&appImage, &nFailedAddr))
     {
-        if (!SendHcdRecord(nAddr, nRecSize, arDataBuffer))
-        {
-            Log(L"Failed to send hcd portion at %x. Clean and rebuild application. Unplug and plug back board. Retry.", nAddr);
-            if (fHCD)
-                fclose(fHCD);
-            return -8;
-        }
-        if (bIsLaunch)
-            break;
+        Log(L"Failed to send hcd portion at %x. Clean and rebuild application. Unplug and plug back board. Retry.", nFailedAddr);
+        HcdImageFree(&appImage);
+        return -8;
     }
+    endTime = GetTickCount64();
+    Log(L"Download time %llu ms: minidriver %llu ms, erase %llu ms, application %llu ms (%d bytes)",
+        endTime - startTime, minidriverTime - startTime, eraseTime - minidriverTime, endTime - eraseTime, appImage.nBytes);
+    HcdImageFree(&appImage);
     Log(L"Download configuration success.  Close the COM port and power cycle the device.");
     return 0;
 }
@@ -82,7 +82,7 @@ typedef uint8_t  wiced_timer_type_t;/* (see #wiced_timer_type_e) */
  * Function prototype for the timer callbacks.
  *
  */
-#if defined  _WIN32 || defined WICEDX || defined __ANDROID__ || defined __APPLE__
+#if defined  _WIN32 || defined WICEDX || defined WICEDX_LINUX || defined __ANDROID__ || defined __APPLE__
 #define TIMER_PARAM_TYPE    void *
 #else
 #define TIMER_PARAM_TYPE   uint32_t
@@ -93,7 +93,7 @@ typedef void ( *wiced_timer_callback_t )( TIMER_PARAM_TYPE cb_params );
 /**
  * Defines the AIROC timer instance size
  */
-#if defined _WIN32 || defined WICEDX || defined __ANDROID__ || defined __APPLE__
+#if defined _WIN32 || defined WICEDX || defined WICEDX_LINUX || defined __ANDROID__ || defined __APPLE__
     #define WICED_TIMER_INSTANCE_SIZE_IN_WORDS      17
 #else
     #define WICED_TIMER_INSTANCE_SIZE_IN_WORDS      14
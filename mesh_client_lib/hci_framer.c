@@ -0,0 +1,123 @@
+/*
+* Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+*
+* Framer of the HCI packets received on a UART or socket byte stream
+*/
+
+#include <string.h>
+
+#include "hci_control_api.h"
+#include "hci_framer.h"
+
+#define HCI_FRAMER_BYTE(p, i)   (p)->p_ring[((p)->head + (i)) & ((p)->size - 1)]
+
+void hci_framer_init(hci_framer_t *p_framer, uint8_t *p_ring, uint32_t size, uint32_t max_payload)
+{
+    p_framer->p_ring      = p_ring;
+    p_framer->size        = size;
+    p_framer->max_payload = max_payload;
+    p_framer->head        = 0;
+    p_framer->tail        = 0;
+}
+
+void hci_framer_reset(hci_framer_t *p_framer)
+{
+    p_framer->head = p_framer->tail = 0;
+}
+
+uint8_t *hci_framer_space(hci_framer_t *p_framer, uint32_t *p_len)
+{
+    uint32_t used = p_framer->tail - p_framer->head;
+    uint32_t pos  = p_framer->tail & (p_framer->size - 1);
+
+    // free space up to the end of the ring, the next read wraps around
+    *p_len = (p_framer->size - used < p_framer->size - pos) ? p_framer->size - used : p_framer->size - pos;
+    return &p_framer->p_ring[pos];
+}
+
+void hci_framer_commit(hci_framer_t *p_framer, uint32_t len)
+{
+    p_framer->tail += len;
+}
+
+int hci_framer_frame(hci_framer_t *p_framer, uint8_t *p_packet, uint32_t max_len, uint32_t *p_offset, uint32_t *p_len)
+{
+    uint32_t avail = p_framer->tail - p_framer->head;
+    uint32_t offset, len = 0, copy, pos, first;
+
+    if (avail == 0)
+        return HCI_FRAMER_INCOMPLETE;
+
+    switch (HCI_FRAMER_BYTE(p_framer, 0))
+    {
+    case HCI_EVENT_PKT:
+        offset = 3;
+        if (avail < offset)
+            return HCI_FRAMER_INCOMPLETE;
+        len = HCI_FRAMER_BYTE(p_framer, 2);
+        break;
+
+    case HCI_ACL_DATA_PKT:
+    case HCI_WICED_PKT:
+        offset = 5;
+        if (avail < offset)
+            return HCI_FRAMER_INCOMPLETE;
+        len = HCI_FRAMER_BYTE(p_framer, 3) | (HCI_FRAMER_BYTE(p_framer, 4) << 8);
+        break;
+
+    default:
+        // unknown packet type, pass the byte up and resync on the next one
+        offset = 1;
+        break;
+    }
+
+    if ((p_framer->max_payload != 0) && (len > p_framer->max_payload))
+        return HCI_FRAMER_BAD_PACKET;
+
+    if (avail < offset + len)
+        return HCI_FRAMER_INCOMPLETE;
+
+    // copy as much as the caller can take, but always consume the whole packet
+    copy  = (offset + len < max_len) ? offset + len : max_len;
+    pos   = p_framer->head & (p_framer->size - 1);
+    first = (copy < p_framer->size - pos) ? copy : p_framer->size - pos;
+    memcpy(p_packet, &p_framer->p_ring[pos], first);
+    memcpy(&p_packet[first], p_framer->p_ring, copy - first);
+    p_framer->head += offset + len;
+
+    *p_offset = offset;
+    *p_len    = len;
+    return HCI_FRAMER_PACKET;
+}
@@ -0,0 +1,95 @@
+/*
+* Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+* hci_framer.h : Framer of the HCI packets received on a UART or socket byte stream
+*
+* The reader appends whatever the transport returns to a receive ring and takes complete HCI event, ACL and
+* WICED packets off it, a partial packet stays in the ring until the rest of it is received. Bytes that do
+* not start a known packet type are returned one at a time so that the reader can resync. Used by the Linux
+* daemon and the Qt and Windows client controls. The framer does not lock, the caller serializes access.
+*/
+#ifndef HCI_FRAMER__H
+#define HCI_FRAMER__H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define HCI_FRAMER_INCOMPLETE   0       /* the ring holds only part of the next packet */
+#define HCI_FRAMER_PACKET       1       /* packet taken off the ring */
+#define HCI_FRAMER_BAD_PACKET   (-1)    /* payload longer than the limit, the stream is out of sync */
+
+/* Receive ring, head and tail are free running */
+typedef struct
+{
+    uint8_t    *p_ring;
+    uint32_t    size;                   /* must be a power of 2 and hold the largest packet accepted */
+    uint32_t    max_payload;            /* longer payloads are bad packets, 0 for no limit */
+    uint32_t    head;
+    uint32_t    tail;
+} hci_framer_t;
+
+/*
+ * Initialize an empty framer on the ring of size bytes
+ */
+void hci_framer_init(hci_framer_t *p_framer, uint8_t *p_ring, uint32_t size, uint32_t max_payload);
+
+/*
+ * Drop everything in the ring, for example when the port is reopened
+ */
+void hci_framer_reset(hci_framer_t *p_framer);
+
+/*
+ * Return where the next read from the transport goes, and in p_len how many bytes it can take.
+ * The bytes read are added with hci_framer_commit.
+ */
+uint8_t *hci_framer_space(hci_framer_t *p_framer, uint32_t *p_len);
+
+void hci_framer_commit(hci_framer_t *p_framer, uint32_t len);
+
+/*
+ * Take the next complete packet off the ring and copy up to max_len bytes of it to p_packet. A packet longer
+ * than max_len is truncated but consumed in full. Returns HCI_FRAMER_PACKET with the length of the packet type
+ * and header in p_offset and the length of the payload in p_len, HCI_FRAMER_INCOMPLETE or HCI_FRAMER_BAD_PACKET.
+ */
+int hci_framer_frame(hci_framer_t *p_framer, uint8_t *p_packet, uint32_t max_len, uint32_t *p_offset, uint32_t *p_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HCI_FRAMER__H */
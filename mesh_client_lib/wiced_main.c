@@ -34,11 +34,16 @@
 /** @file
 *
 * WICED functions implementation for host/peer applications
+*
+* The timers are kept in a hashed hierarchical timer wheel, starting and stopping a timer takes constant
+* time. A single thread sleeps until the next time the wheel has work and runs the expired callbacks. The
+* time comes from the performance counter, which is monotonic and does not wrap.
 */
 
 #include <windows.h>
 
 #include "wiced_timer.h"
+#include "wiced_timer_wheel.h"
 
 typedef void (TIMER_CBACK)(void *p_tle);
 extern void execute_timer_callback(TIMER_CBACK *p_callback, TIMER_PARAM_TYPE arg);
@@ -47,17 +52,19 @@ extern void execute_timer_callback(TIMER_CBACK *p_callback, TIMER_PARAM_TYPE arg
 
 typedef struct _tle
 {
-    struct _tle  *p_next;
+    wiced_timer_wheel_node_t node;      /* must be first */
     TIMER_CBACK  *p_cback;
     UINT16        flags;                /* Flags for timer*/
     UINT16        type;
-    UINT32        interval;             /* Periodical time out inteval, in 1 us unit */
+    UINT32        interval;             /* Periodical time out inteval, in ms */
     TIMER_PARAM_TYPE arg;               /* parameter for expiration function */
-    UINT64        target_time;          /* Target time for timer expire, in us */
 } TIMER_LIST_ENT;
 
-static TIMER_LIST_ENT *pOsTimerHead = NULL;
-static UINT64       absTimeHi = 0;
+typedef char timer_list_ent_fits_wiced_timer[(sizeof(TIMER_LIST_ENT) <= sizeof(wiced_timer_t)) ? 1 : -1];
+
+static wiced_timer_wheel_t timerWheel;
+static UINT64       wakeTime = WICED_TIMER_WHEEL_NEVER;  /* time the timer thread wakes up, in ms */
+static LARGE_INTEGER counterFreq;
 static void timerThread(void *arg);
 static HANDLE   sleepHandle;
 
@@ -65,6 +72,14 @@ extern void ods(char * fmt_str, ...);
 
 extern CRITICAL_SECTION cs;
 
+static UINT64 timerNowMs(void)
+{
+    LARGE_INTEGER counter;
+
+    QueryPerformanceCounter(&counter);
+    return (counter.QuadPart / counterFreq.QuadPart) * 1000 + (counter.QuadPart % counterFreq.QuadPart) * 1000 / counterFreq.QuadPart;
+}
+
 wiced_result_t wiced_init_timer(wiced_timer_t* p_timer, wiced_timer_callback_t TimerCb, TIMER_PARAM_TYPE cBackparam, wiced_timer_type_t type)
 {
     TIMER_LIST_ENT *p = (TIMER_LIST_ENT *)p_timer;
@@ -89,8 +104,8 @@ wiced_result_t wiced_deinit_timer(wiced_timer_t* p)
 wiced_result_t wiced_start_timer(wiced_timer_t* wt, uint32_t timeout)
 {
     TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)wt;
-    TIMER_LIST_ENT  *p_cur, *p_prev;
-    UINT32          cur_tc, expire_tc;
+    UINT64          expire;
+    BOOL            wake;
 
     // This could be done more elegantly in a final product...
     static BOOL threadStarted = FALSE;
@@ -99,6 +114,9 @@ wiced_result_t wiced_start_timer(wiced_timer_t* wt, uint32_t timeout)
         DWORD   thread_address;
         threadStarted = TRUE;
 
+        QueryPerformanceFrequency(&counterFreq);
+        wiced_timer_wheel_init(&timerWheel, timerNowMs());
+
         sleepHandle = CreateEvent (NULL, FALSE, FALSE, NULL);
 
         CreateThread(0, 0, (LPTHREAD_START_ROUTINE)timerThread, (LPVOID)1, 0, &thread_address);
@@ -115,60 +133,26 @@ wiced_result_t wiced_start_timer(wiced_timer_t* wt, uint32_t timeout)
     // ods("wiced_start_timer:%x timeout:%d\n", p_timer, timeout);
 
     // Make sure that we are not starting the same timer twice.
-    wiced_stop_timer(wt);
+    if (p_timer->flags & TIMER_ACTIVE)
+        wiced_timer_wheel_remove(&timerWheel, &p_timer->node);
 
     p_timer->interval = timeout;
 
     if (p_timer->type == WICED_SECONDS_TIMER || p_timer->type == WICED_SECONDS_PERIODIC_TIMER)
-        timeout *= 1000;
-
-    cur_tc = GetTickCount();
-    expire_tc = cur_tc + timeout;   // interval is in milliseconds, convert to ms
-
-    p_timer->target_time = absTimeHi + expire_tc;
-
-    // Check for rollover of the 32-bit tick count
-    if (expire_tc < cur_tc)
-        p_timer->target_time += 0x100000000;
-
-    // Put the timer in the appropriate place
-    if ((pOsTimerHead == NULL) || (pOsTimerHead->target_time > p_timer->target_time))
-    {
-        // New timer goes at start of list
-        p_timer->p_next = pOsTimerHead;
-        pOsTimerHead = p_timer;
-    }
+        expire = timerNowMs() + (UINT64)timeout * 1000;
     else
-    {
-        p_prev = pOsTimerHead;
-        p_cur = p_prev->p_next;
-
-        for (; ; )
-        {
-            if (p_cur == NULL)
-            {
-                // New timer goes at end of list
-                p_prev->p_next = p_timer;
-                p_timer->p_next = NULL;
-                break;
-            }
-            if (p_cur->target_time > p_timer->target_time)
-            {
-                // New timer goes in the middle of the list
-                p_prev->p_next  = p_timer;
-                p_timer->p_next = p_cur;
-                break;
-            }
-            p_prev = p_cur;
-            p_cur = p_prev->p_next;
-        }
-    }
+        expire = timerNowMs() + timeout;
 
+    wiced_timer_wheel_add(&timerWheel, &p_timer->node, expire);
     p_timer->flags |= TIMER_ACTIVE;
 
+    // the thread only has to wake up if the timer is due before it does
+    wake = (expire < wakeTime);
+
     LeaveCriticalSection(&cs);
 
-    SetEvent (sleepHandle);
+    if (wake)
+        SetEvent (sleepHandle);
 
     return WICED_BT_SUCCESS;
 }
@@ -176,34 +160,18 @@ wiced_result_t wiced_start_timer(wiced_timer_t* wt, uint32_t timeout)
 wiced_result_t wiced_stop_timer(wiced_timer_t* wt)
 {
     TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)wt;
-    TIMER_LIST_ENT *pt;
 
     // ods("wiced_stop_timer:%x\n", p_timer);
 
     EnterCriticalSection(&cs);
 
+    // a thread that wakes up for a stopped timer finds nothing expired and goes back to sleep
+    if (p_timer->flags & TIMER_ACTIVE)
+        wiced_timer_wheel_remove(&timerWheel, &p_timer->node);
     p_timer->flags &= ~TIMER_ACTIVE;
 
-    if (p_timer == pOsTimerHead)
-    {
-        pOsTimerHead = pOsTimerHead->p_next;
-        LeaveCriticalSection(&cs);
-        SetEvent (sleepHandle);
-        return WICED_BT_SUCCESS;
-    }
-
-    /* Find timer in the queue */
-    for (pt = pOsTimerHead; pt != NULL; pt = pt->p_next)
-        if (pt->p_next == p_timer)
-            break;
-
-    if (pt != NULL)
-        pt->p_next = p_timer->p_next;
-
     LeaveCriticalSection(&cs);
 
-    SetEvent (sleepHandle);
-
     return WICED_BT_SUCCESS;
 }
 
@@ -218,58 +186,38 @@ wiced_bool_t wiced_is_timer_in_use(wiced_timer_t *p)
 
 static void timerThread(void *arg)
 {
-    UINT32          last_tc, cur_tc, sleep_time;
-    UINT64          cur_absTime;
+    UINT64          now, next;
     TIMER_LIST_ENT  *pTimer;
 
     SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
 
     for ( ; ; )
     {
-        last_tc = GetTickCount();
-        cur_absTime = absTimeHi + last_tc;
-
-        if (pOsTimerHead != NULL)
-        {
-            if (pOsTimerHead->target_time < cur_absTime)
-                sleep_time = 0;
-            else
-                sleep_time = (UINT32)(pOsTimerHead->target_time - cur_absTime);
-        }
-        else
-            sleep_time = 60000;        // 1 minute is small enough to detect rollovers
-
-        if (sleep_time != 0)
-            WaitForSingleObject (sleepHandle, sleep_time);
-
         EnterCriticalSection(&cs);
 
-        cur_tc = GetTickCount();
-
-        // Check for rollover - this assumes no timer is more than 49 days
-        if (cur_tc < last_tc)
-            absTimeHi += 0x100000000;
-
-        cur_absTime = absTimeHi + cur_tc;
-
-        // Check if the first timer on the list has expired
-        if ((pOsTimerHead != NULL) && (pOsTimerHead->target_time <= cur_absTime))
+        now = timerNowMs();
+        pTimer = (TIMER_LIST_ENT *)wiced_timer_wheel_expire(&timerWheel, now);
+        if (pTimer != NULL)
         {
-            pTimer = pOsTimerHead;
+            pTimer->flags &= ~TIMER_ACTIVE;
 
             // Check for periodic timer
             if ((pTimer->type == WICED_SECONDS_PERIODIC_TIMER) || (pTimer->type == WICED_MILLI_SECONDS_PERIODIC_TIMER))
                 wiced_start_timer ((wiced_timer_t *)pTimer, pTimer->interval);
-            else
-                wiced_stop_timer ((wiced_timer_t *)pTimer);
 
             LeaveCriticalSection(&cs);
 
             execute_timer_callback(pTimer->p_cback, pTimer->arg);
+            continue;
         }
-        else
-        {
-            LeaveCriticalSection(&cs);
-        }
+
+        next = wiced_timer_wheel_next(&timerWheel);
+        wakeTime = next;
+
+        LeaveCriticalSection(&cs);
+
+        // an hour is short enough for the wait, the wheel can be far ahead
+        if (next > now)
+            WaitForSingleObject (sleepHandle, (next - now > 3600000) ? 3600000 : (DWORD)(next - now));
     }
 }
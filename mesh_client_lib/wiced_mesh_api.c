@@ -35,6 +35,12 @@
 #include <string.h>
 #include <memory.h>
 #include <stdlib.h>
+#include <stddef.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
 #include "wiced_memory.h"
 #include "wiced_mesh_client.h"
 #include "hci_control_api.h"
@@ -143,2070 +149,2065 @@ static void process_fw_update_metadata_status(uint8_t* p_buffer, uint16_t len);
 
 extern void mesh_provision_process_event(uint16_t event, wiced_bt_mesh_event_t *p_event, void *p_data);
 
-void wiced_hci_process_data(uint16_t opcode, uint8_t *p_buffer, uint16_t len)
-{
-#ifdef MIBLE
-    extern void mible_wiced_set_event(void);
-    if ((opcode != HCI_CONTROL_MESH_EVENT_COMMAND_STATUS) && (opcode != HCI_CONTROL_MESH_EVENT_TX_COMPLETE))
-        mible_wiced_set_event();
-#endif
-
-    switch (opcode)
-    {
-    case HCI_CONTROL_MESH_EVENT_COMMAND_STATUS:
-        process_provision_command_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_TX_COMPLETE:
-        process_tx_complete(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_CORE_SEQ_CHANGED:
-        process_core_seq_changed(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_RAW_MODEL_DATA:
-        process_core_raw_model_data(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_PROVISION_SCAN_CAPABILITIES_STATUS:
-        process_provision_scan_capabilities_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_PROVISION_SCAN_STATUS:
-        process_provision_scan_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_PROVISION_SCAN_REPORT:
-        process_provision_scan_report(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_PROVISION_SCAN_EXTENDED_REPORT:
-        process_provision_scan_extended_report(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_NODE_RESET_STATUS:
-        process_node_reset_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_PROVISION_END:
-        process_provision_end(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_PROXY_CONNECTION_STATUS:
-        process_proxy_connection_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_PROVISION_LINK_REPORT:
-        process_provision_link_report(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_PROVISION_DEVICE_CAPABILITIES:
-        process_provision_device_capabilities(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_PROVISION_OOB_DATA:
-        process_provision_oob_data(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_COMPOSITION_DATA_STATUS:
-        process_composition_data_status(p_buffer, len);
-        break;
+/*
+ * HCI event dispatch table.
+ * Events are routed by opcode group (high byte) and code (low byte). Each group that has at least one
+ * handler owns a block of 256 entries, the two mesh groups are allocated statically, blocks for other
+ * groups are allocated when the application registers the first handler in that group.
+ * Each entry keeps counters so the application can find out which events dominate the traffic.
+ */
+#define MESH_HCI_EVENT_GROUP_SIZE       256
+
+typedef struct
+{
+    mesh_client_hci_event_handler_t p_handler;
+    uint32_t                        count;
+    uint32_t                        max_parse_time_us;
+    uint64_t                        bytes;
+    uint64_t                        parse_time_us;
+} mesh_hci_event_entry_t;
+
+typedef struct
+{
+    uint16_t                        opcode;
+    mesh_client_hci_event_handler_t p_handler;
+} mesh_hci_event_default_t;
+
+static const mesh_hci_event_default_t mesh_hci_event_defaults[] =
+{
+    { HCI_CONTROL_MESH_EVENT_COMMAND_STATUS, process_provision_command_status },
+    { HCI_CONTROL_MESH_EVENT_TX_COMPLETE, process_tx_complete },
+    { HCI_CONTROL_MESH_EVENT_CORE_SEQ_CHANGED, process_core_seq_changed },
+    { HCI_CONTROL_MESH_EVENT_RAW_MODEL_DATA, process_core_raw_model_data },
+    { HCI_CONTROL_MESH_EVENT_PROVISION_SCAN_CAPABILITIES_STATUS, process_provision_scan_capabilities_status },
+    { HCI_CONTROL_MESH_EVENT_PROVISION_SCAN_STATUS, process_provision_scan_status },
+    { HCI_CONTROL_MESH_EVENT_PROVISION_SCAN_REPORT, process_provision_scan_report },
+    { HCI_CONTROL_MESH_EVENT_PROVISION_SCAN_EXTENDED_REPORT, process_provision_scan_extended_report },
+    { HCI_CONTROL_MESH_EVENT_NODE_RESET_STATUS, process_node_reset_status },
+    { HCI_CONTROL_MESH_EVENT_PROVISION_END, process_provision_end },
+    { HCI_CONTROL_MESH_EVENT_PROXY_CONNECTION_STATUS, process_proxy_connection_status },
+    { HCI_CONTROL_MESH_EVENT_PROVISION_LINK_REPORT, process_provision_link_report },
+    { HCI_CONTROL_MESH_EVENT_PROVISION_DEVICE_CAPABILITIES, process_provision_device_capabilities },
+    { HCI_CONTROL_MESH_EVENT_PROVISION_OOB_DATA, process_provision_oob_data },
+    { HCI_CONTROL_MESH_EVENT_COMPOSITION_DATA_STATUS, process_composition_data_status },
 #ifdef LARGE_COMPOSITION_DATA_SUPPORTED
-    case HCI_CONTROL_MESH_EVENT_LARGE_COMPOS_DATA_STATUS:
-        process_large_compos_data_status(p_buffer, len);
-        break;
+    { HCI_CONTROL_MESH_EVENT_LARGE_COMPOS_DATA_STATUS, process_large_compos_data_status },
 #endif
-    case HCI_CONTROL_MESH_EVENT_NETKEY_STATUS:
-        process_net_key_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_APPKEY_STATUS:
-        process_app_key_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_KEY_REFRESH_PHASE_STATUS:
-        process_key_refresh_phase_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_MODEL_APP_BIND_STATUS:
-        process_model_app_bind_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_MODEL_SUBSCRIPTION_STATUS:
-        process_model_sub_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_MODEL_PUBLICATION_STATUS:
-        process_model_pub_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_NETWORK_TRANSMIT_PARAMS_STATUS:
-        process_net_transmit_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_DEFAULT_TTL_STATUS:
-        process_default_ttl_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_RELAY_STATUS:
-        process_relay_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_FRIEND_STATUS:
-        process_friend_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_GATT_PROXY_STATUS:
-        process_gatt_proxy_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_BEACON_STATUS:
-        process_beacon_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_NODE_IDENTITY_STATUS:
-        process_node_identity_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_PROXY_FILTER_STATUS:
-        process_proxy_filter_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_DEF_TRANS_TIME_STATUS:
-        process_def_trans_time_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_ONOFF_STATUS:
-        process_on_off_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_LEVEL_STATUS:
-        process_level_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_LIGHT_LIGHTNESS_STATUS:
-        process_lightness_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_LIGHT_HSL_STATUS:
-        process_hsl_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_LIGHT_CTL_STATUS:
-        process_ctl_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_SENSOR_DESCRIPTOR_STATUS:
-        process_sensor_descriptor_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_SENSOR_SETTINGS_STATUS:
-        process_sensor_settings_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_SENSOR_CADENCE_STATUS:
-        process_sensor_cadence_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_SENSOR_STATUS:
-        process_sensor_data_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_PROPERTIES_STATUS:
-        process_properties_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_PROPERTY_STATUS:
-        process_property_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_VENDOR_DATA:
-        process_vendor_data(p_buffer, len);
-        break;
+    { HCI_CONTROL_MESH_EVENT_NETKEY_STATUS, process_net_key_status },
+    { HCI_CONTROL_MESH_EVENT_APPKEY_STATUS, process_app_key_status },
+    { HCI_CONTROL_MESH_EVENT_KEY_REFRESH_PHASE_STATUS, process_key_refresh_phase_status },
+    { HCI_CONTROL_MESH_EVENT_MODEL_APP_BIND_STATUS, process_model_app_bind_status },
+    { HCI_CONTROL_MESH_EVENT_MODEL_SUBSCRIPTION_STATUS, process_model_sub_status },
+    { HCI_CONTROL_MESH_EVENT_MODEL_PUBLICATION_STATUS, process_model_pub_status },
+    { HCI_CONTROL_MESH_EVENT_NETWORK_TRANSMIT_PARAMS_STATUS, process_net_transmit_status },
+    { HCI_CONTROL_MESH_EVENT_DEFAULT_TTL_STATUS, process_default_ttl_status },
+    { HCI_CONTROL_MESH_EVENT_RELAY_STATUS, process_relay_status },
+    { HCI_CONTROL_MESH_EVENT_FRIEND_STATUS, process_friend_status },
+    { HCI_CONTROL_MESH_EVENT_GATT_PROXY_STATUS, process_gatt_proxy_status },
+    { HCI_CONTROL_MESH_EVENT_BEACON_STATUS, process_beacon_status },
+    { HCI_CONTROL_MESH_EVENT_NODE_IDENTITY_STATUS, process_node_identity_status },
+    { HCI_CONTROL_MESH_EVENT_PROXY_FILTER_STATUS, process_proxy_filter_status },
+    { HCI_CONTROL_MESH_EVENT_DEF_TRANS_TIME_STATUS, process_def_trans_time_status },
+    { HCI_CONTROL_MESH_EVENT_ONOFF_STATUS, process_on_off_status },
+    { HCI_CONTROL_MESH_EVENT_LEVEL_STATUS, process_level_status },
+    { HCI_CONTROL_MESH_EVENT_LIGHT_LIGHTNESS_STATUS, process_lightness_status },
+    { HCI_CONTROL_MESH_EVENT_LIGHT_HSL_STATUS, process_hsl_status },
+    { HCI_CONTROL_MESH_EVENT_LIGHT_CTL_STATUS, process_ctl_status },
+    { HCI_CONTROL_MESH_EVENT_SENSOR_DESCRIPTOR_STATUS, process_sensor_descriptor_status },
+    { HCI_CONTROL_MESH_EVENT_SENSOR_SETTINGS_STATUS, process_sensor_settings_status },
+    { HCI_CONTROL_MESH_EVENT_SENSOR_CADENCE_STATUS, process_sensor_cadence_status },
+    { HCI_CONTROL_MESH_EVENT_SENSOR_STATUS, process_sensor_data_status },
+    { HCI_CONTROL_MESH_EVENT_PROPERTIES_STATUS, process_properties_status },
+    { HCI_CONTROL_MESH_EVENT_PROPERTY_STATUS, process_property_status },
+    { HCI_CONTROL_MESH_EVENT_VENDOR_DATA, process_vendor_data },
 #if defined(CERTIFICATE_BASED_PROVISIONING_SUPPORTED)
-    case HCI_CONTROL_MESH_EVENT_PROVISION_RECORD_LIST:
-        process_provision_record_list(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_PROVISION_RECORD_RESPONSE:
-        process_provision_record_response(p_buffer, len);
-        break;
+    { HCI_CONTROL_MESH_EVENT_PROVISION_RECORD_LIST, process_provision_record_list },
+    { HCI_CONTROL_MESH_EVENT_PROVISION_RECORD_RESPONSE, process_provision_record_response },
 #endif
 #ifdef OPCODES_AGGREGATOR_SUPPORTED
-    case HCI_CONTROL_MESH_EVENT_OPCODES_AGGREGATOR_ADD_STATUS:
-        process_opcodes_aggregator_add_status(p_buffer, len);
-        break;
+    { HCI_CONTROL_MESH_EVENT_OPCODES_AGGREGATOR_ADD_STATUS, process_opcodes_aggregator_add_status },
 #endif
 #ifdef PRIVATE_PROXY_SUPPORTED
-    case HCI_CONTROL_MESH_EVENT_PRIVATE_BEACON_STATUS:
-        process_private_beacon_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_PRIVATE_GATT_PROXY_STATUS:
-        process_private_gatt_proxy_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_ON_DEMAND_PRIVATE_PROXY_STATUS:
-        process_on_demand_private_proxy_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_PRIVATE_NODE_IDENTITY_STATUS:
-        process_private_node_identity_status(p_buffer, len);
-        break;
+    { HCI_CONTROL_MESH_EVENT_PRIVATE_BEACON_STATUS, process_private_beacon_status },
+    { HCI_CONTROL_MESH_EVENT_PRIVATE_GATT_PROXY_STATUS, process_private_gatt_proxy_status },
+    { HCI_CONTROL_MESH_EVENT_ON_DEMAND_PRIVATE_PROXY_STATUS, process_on_demand_private_proxy_status },
+    { HCI_CONTROL_MESH_EVENT_PRIVATE_NODE_IDENTITY_STATUS, process_private_node_identity_status },
 #endif
 #ifdef MESH_DFU_ENABLED
-    case HCI_CONTROL_MESH_EVENT_FW_DISTRIBUTION_STATUS:
-        process_fw_distribution_status(p_buffer, len);
-        break;
-    case HCI_CONTROL_MESH_EVENT_FW_UPDATE_METADATA_STATUS:
-        process_fw_update_metadata_status(p_buffer, len);
-        break;
+    { HCI_CONTROL_MESH_EVENT_FW_DISTRIBUTION_STATUS, process_fw_distribution_status },
+    { HCI_CONTROL_MESH_EVENT_FW_UPDATE_METADATA_STATUS, process_fw_update_metadata_status },
+#endif
+};
+
+static mesh_hci_event_entry_t mesh_hci_event_group_mesh[MESH_HCI_EVENT_GROUP_SIZE];
+static mesh_hci_event_entry_t mesh_hci_event_group_mesh_models[MESH_HCI_EVENT_GROUP_SIZE];
+static mesh_hci_event_entry_t *mesh_hci_event_groups[256];
+static wiced_bool_t mesh_hci_event_table_initialized = WICED_FALSE;
+
+static uint64_t mesh_hci_event_time_us(void)
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+
+    if (frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000 + (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
 #endif
-    default:
-        Log("Rcvd Unknown Op Code: 0x%04x", opcode);
-        break;
-    }
 }
 
-void process_provision_command_status(uint8_t *p_buffer, uint16_t len)
+static void mesh_hci_event_table_init(void)
 {
-    mesh_provision_process_event(WICED_BT_MESH_COMMAND_STATUS, NULL, NULL);
+    int i;
+
+    mesh_hci_event_groups[HCI_CONTROL_GROUP_MESH] = mesh_hci_event_group_mesh;
+    mesh_hci_event_groups[HCI_CONTROL_GROUP_MESH_MODELS] = mesh_hci_event_group_mesh_models;
+
+    for (i = 0; i < (int)(sizeof(mesh_hci_event_defaults) / sizeof(mesh_hci_event_defaults[0])); i++)
+        mesh_hci_event_groups[mesh_hci_event_defaults[i].opcode >> 8][mesh_hci_event_defaults[i].opcode & 0xff].p_handler = mesh_hci_event_defaults[i].p_handler;
+
+    mesh_hci_event_table_initialized = WICED_TRUE;
 }
 
-void process_core_seq_changed(uint8_t *p_buffer, uint16_t len)
+static mesh_hci_event_entry_t *mesh_hci_event_entry(uint16_t opcode)
 {
-    wiced_bt_mesh_core_state_seq_t data;
-    data.addr = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
-    data.seq = p_buffer[2] + ((uint32_t)p_buffer[3] << 8) + ((uint32_t)p_buffer[4] << 16) + ((uint32_t)p_buffer[5] << 24);
-    data.previous_iv_idx = p_buffer[6];
-    data.rpl_entry_idx = p_buffer[7] + ((uint16_t)p_buffer[8] << 8);
-    mesh_provision_process_event(WICED_BT_MESH_SEQ_CHANGED, NULL, &data);
+    mesh_hci_event_entry_t *p_group;
+
+    if (!mesh_hci_event_table_initialized)
+        mesh_hci_event_table_init();
+
+    p_group = mesh_hci_event_groups[opcode >> 8];
+    return (p_group == NULL) ? NULL : &p_group[opcode & 0xff];
 }
 
-void process_core_raw_model_data(uint8_t *p_buffer, uint16_t len)
+int mesh_client_hci_event_handler_register(uint16_t opcode, mesh_client_hci_event_handler_t p_handler)
 {
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
-        return;
+    mesh_hci_event_entry_t *p_entry = mesh_hci_event_entry(opcode);
+    int i;
 
-    if ((p_buffer[0] & (MESH_APP_PAYLOAD_OP_LONG | MESH_APP_PAYLOAD_OP_MANUF_SPECIFIC)) == (MESH_APP_PAYLOAD_OP_LONG | MESH_APP_PAYLOAD_OP_MANUF_SPECIFIC))
+    if (p_entry == NULL)
     {
-        p_event->opcode = p_buffer[0] & ~(MESH_APP_PAYLOAD_OP_LONG | MESH_APP_PAYLOAD_OP_MANUF_SPECIFIC);
-        p_event->company_id = (p_buffer[1] << 8) + p_buffer[2];
-        p_buffer += 3;
-        len -= 3;
+        if (p_handler == NULL)
+            return MESH_CLIENT_SUCCESS;
+
+        if ((mesh_hci_event_groups[opcode >> 8] = (mesh_hci_event_entry_t *)wiced_bt_get_buffer(MESH_HCI_EVENT_GROUP_SIZE * sizeof(mesh_hci_event_entry_t))) == NULL)
+            return MESH_CLIENT_ERR_NO_MEMORY;
+
+        memset(mesh_hci_event_groups[opcode >> 8], 0, MESH_HCI_EVENT_GROUP_SIZE * sizeof(mesh_hci_event_entry_t));
+        p_entry = &mesh_hci_event_groups[opcode >> 8][opcode & 0xff];
     }
-    else
+    // NULL handler restores the library processing of the event, if there is one
+    if (p_handler == NULL)
     {
-        p_event->company_id = MESH_COMPANY_ID_BT_SIG;
-        p_event->opcode = (p_buffer[0] << 8) + p_buffer[1];
-        p_buffer += 2;
-        len -= 2;
+        for (i = 0; i < (int)(sizeof(mesh_hci_event_defaults) / sizeof(mesh_hci_event_defaults[0])); i++)
+        {
+            if (mesh_hci_event_defaults[i].opcode == opcode)
+            {
+                p_handler = mesh_hci_event_defaults[i].p_handler;
+                break;
+            }
+        }
     }
-    p_event->data_len = len;
-
-    mesh_provision_process_event(WICED_BT_MESH_RAW_MODEL_DATA, p_event, p_buffer);
+    p_entry->p_handler = p_handler;
+    return MESH_CLIENT_SUCCESS;
 }
 
-void process_provision_scan_capabilities_status(uint8_t *p_buffer, uint16_t len)
+static void mesh_hci_event_stats_fill(uint16_t opcode, mesh_hci_event_entry_t *p_entry, mesh_client_hci_event_stats_t *p_stats)
 {
-    wiced_bt_mesh_provision_scan_capabilities_status_data_t data;
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
-        return;
-
-    data.max_scanned_items = p_buffer[0];
-    mesh_provision_process_event(WICED_BT_MESH_PROVISION_SCAN_CAPABILITIES_STATUS, p_event, &data);
+    p_stats->opcode            = opcode;
+    p_stats->count             = p_entry->count;
+    p_stats->bytes             = p_entry->bytes;
+    p_stats->parse_time_us     = p_entry->parse_time_us;
+    p_stats->max_parse_time_us = p_entry->max_parse_time_us;
 }
 
-void process_provision_scan_status(uint8_t *p_buffer, uint16_t len)
+int mesh_client_hci_event_stats_get(uint16_t opcode, mesh_client_hci_event_stats_t *p_stats)
 {
-    wiced_bt_mesh_provision_scan_status_data_t data;
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
-        return;
+    mesh_hci_event_entry_t *p_entry = mesh_hci_event_entry(opcode);
 
-    data.status = p_buffer[0];
-    data.state = p_buffer[1];
-    data.scanned_items_limit = p_buffer[2];
-    data.timeout = p_buffer[3];
-    mesh_provision_process_event(WICED_BT_MESH_PROVISION_SCAN_STATUS, p_event, &data);
+    if (p_stats == NULL)
+        return MESH_CLIENT_ERR_INVALID_ARGS;
+    if (p_entry == NULL)
+        return MESH_CLIENT_ERR_NOT_FOUND;
+
+    mesh_hci_event_stats_fill(opcode, p_entry, p_stats);
+    return MESH_CLIENT_SUCCESS;
 }
 
-void process_provision_scan_report(uint8_t *p_buffer, uint16_t len)
+int mesh_client_hci_event_stats_get_all(mesh_client_hci_event_stats_t *p_stats, int max_entries)
 {
-#ifdef PROVISION_SCAN_REPORT_INCLUDE_BDADDR
-    int i;
-#endif
-    wiced_bt_mesh_provision_scan_report_data_t data;
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
-        return;
+    mesh_hci_event_entry_t *p_group;
+    int group, code, num_entries = 0;
 
-    data.rssi = p_buffer[0];
-    memcpy(data.uuid, &p_buffer[1], 16);
-    data.oob = p_buffer[17] + (p_buffer[18] << 8);
-    data.uri_hash = p_buffer[19] + ((uint32_t)p_buffer[20] << 8) + ((uint32_t)p_buffer[21] << 16) + ((uint32_t)p_buffer[22] << 24);
-#ifdef PROVISION_SCAN_REPORT_INCLUDE_BDADDR
-    for (i = 0; i < BD_ADDR_LEN; i++)
-        data.bdaddr[5 - i] = p_buffer[23 + i];
-#endif
-    mesh_provision_process_event(WICED_BT_MESH_PROVISION_SCAN_REPORT, p_event, &data);
+    if (!mesh_hci_event_table_initialized)
+        mesh_hci_event_table_init();
+
+    for (group = 0; group < 256; group++)
+    {
+        if ((p_group = mesh_hci_event_groups[group]) == NULL)
+            continue;
+
+        for (code = 0; code < MESH_HCI_EVENT_GROUP_SIZE; code++)
+        {
+            if (p_group[code].count == 0)
+                continue;
+            if (num_entries == max_entries)
+                return num_entries;
+            mesh_hci_event_stats_fill((uint16_t)((group << 8) | code), &p_group[code], &p_stats[num_entries++]);
+        }
+    }
+    return num_entries;
 }
 
-void process_provision_scan_extended_report(uint8_t *p_buffer, uint16_t len)
+void mesh_client_hci_event_stats_reset(void)
 {
-    wiced_bt_mesh_provision_scan_extended_report_data_t data;
-    uint8_t *p_adv_data, *p;
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
-        return;
+    int group, code;
 
-    memset(&data, 0, sizeof(data));
-    data.status = p_buffer[0];
-    memcpy(data.uuid, &p_buffer[1], 16);
-    if (len >= 19)
+    for (group = 0; group < 256; group++)
     {
-        data.oob = p_buffer[17] + (p_buffer[18] << 8);
-        len -= 19;
-        p = data.adv_data;
-        p_adv_data = &p_buffer[19];
-        while (len > 0)
-        {
-            if (*p_adv_data == 0)
-                break;
+        if (mesh_hci_event_groups[group] == NULL)
+            continue;
 
-            if ((*p_adv_data + 1 > len) || ((p + *p_adv_data + 1) > (data.adv_data + sizeof(data.adv_data))))
-            {
-                Log("bad adv data:");
-                break;
-            }
-            memcpy(p, p_adv_data, *p_adv_data + 1);
-            p += *p_adv_data + 1;
-            len -= (*p_adv_data + 1);
-            p_adv_data += *p_adv_data + 1;
+        for (code = 0; code < MESH_HCI_EVENT_GROUP_SIZE; code++)
+        {
+            mesh_hci_event_groups[group][code].count = 0;
+            mesh_hci_event_groups[group][code].bytes = 0;
+            mesh_hci_event_groups[group][code].parse_time_us = 0;
+            mesh_hci_event_groups[group][code].max_parse_time_us = 0;
         }
     }
-    mesh_provision_process_event(WICED_BT_MESH_PROVISION_SCAN_EXTENDED_REPORT, p_event, &data);
 }
 
-void process_provision_end(uint8_t *p_buffer, uint16_t len)
+/*
+ * HCI command flow control.
+ * The device reports completion of each command with the Command Status event. When the window is configured,
+ * at most window commands are sent without the status, the following commands are queued and sent when the
+ * credits are returned. If the status is lost, the credit is returned after the credit timeout, so the queue
+ * can not stall forever. With the window 0 (default) commands are passed to the transport as is.
+ * Each HCI transport has its own window and queue, the window size and the credit timeout are the same for all.
+ */
+#define MESH_HCI_TX_WINDOW_MAX                  32
+#define MESH_HCI_TX_DEFAULT_CREDIT_TIMEOUT_MS   1000
+
+typedef struct mesh_hci_tx_entry
+{
+    struct mesh_hci_tx_entry *p_next;
+    uint16_t                 opcode;
+    uint16_t                 length;
+    uint8_t                  data[1];
+} mesh_hci_tx_entry_t;
+
+typedef struct
+{
+    mesh_client_hci_transport_send_t p_send;    // NULL for the first transport, which uses wiced_hci_send
+    uint16_t            local_addr;             // unicast address of the device, 0 until it is configured
+    uint16_t            outstanding;            // number of commands sent without the status
+    uint16_t            oldest;                 // index of the oldest outstanding command in send_time_us
+    uint64_t            send_time_us[MESH_HCI_TX_WINDOW_MAX];
+    mesh_hci_tx_entry_t *p_first;
+    mesh_hci_tx_entry_t *p_last;
+    uint32_t            queue_depth;
+    uint32_t            max_queue_depth;
+    uint32_t            sent;
+    uint32_t            queued;
+    uint32_t            credit_timeouts;
+    uint64_t            stall_start_us;
+    uint64_t            stall_time_us;
+    uint32_t            max_stall_time_us;
+    uint32_t            balanced;
+    uint32_t            routed;
+    wiced_bool_t        timer_initialized;
+    wiced_timer_t       timer;
+} mesh_hci_tx_cb_t;
+
+static mesh_hci_tx_cb_t mesh_hci_tx_cb[MESH_CLIENT_HCI_MAX_TRANSPORTS];
+static uint8_t          mesh_hci_num_transports = 1;
+static uint16_t         mesh_hci_tx_window = 0;         // 0 if the flow control is disabled
+static uint32_t         mesh_hci_tx_credit_timeout_ms = MESH_HCI_TX_DEFAULT_CREDIT_TIMEOUT_MS;
+
+static uint8_t mesh_hci_tx_transmit(mesh_hci_tx_cb_t *p_tx, uint16_t opcode, uint8_t *p_buffer, uint16_t length)
+{
+    if (mesh_hci_tx_window != 0)
+    {
+        p_tx->send_time_us[(p_tx->oldest + p_tx->outstanding) % MESH_HCI_TX_WINDOW_MAX] = mesh_hci_event_time_us();
+        p_tx->outstanding++;
+    }
+    p_tx->sent++;
+    if (p_tx->p_send != NULL)
+        return p_tx->p_send((uint8_t)(p_tx - mesh_hci_tx_cb), opcode, p_buffer, length);
+    return wiced_hci_send(opcode, p_buffer, length);
+}
+
+static void mesh_hci_tx_credit_return(mesh_hci_tx_cb_t *p_tx)
 {
-    wiced_bt_mesh_provision_status_data_t data;
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
+    if (p_tx->outstanding == 0)
         return;
-
-    data.provisioner_addr = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
-    data.addr             = p_buffer[2] + ((uint16_t)p_buffer[3] << 8);
-    data.net_key_idx      = p_buffer[4] + ((uint16_t)p_buffer[5] << 8);
-    data.result           = p_buffer[6];
-    memcpy(data.dev_key, &p_buffer[7], 16);
-    mesh_provision_process_event(WICED_BT_MESH_PROVISION_END, p_event, &data);
+    p_tx->oldest = (p_tx->oldest + 1) % MESH_HCI_TX_WINDOW_MAX;
+    p_tx->outstanding--;
 }
 
-void process_proxy_connection_status(uint8_t *p_buffer, uint16_t len)
+/*
+ * Return credits of the commands which did not receive the status within the credit timeout.
+ * Returns number of milliseconds until the next credit expires, or 0 if there are no outstanding commands.
+ */
+static uint32_t mesh_hci_tx_expire_credits(mesh_hci_tx_cb_t *p_tx, uint64_t now)
 {
-    wiced_bt_mesh_connect_status_data_t data;
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
-        return;
+    uint64_t elapsed_us;
 
-    data.provisioner_addr = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
-    data.addr             = p_buffer[2] + ((uint16_t)p_buffer[3] << 8);
-    data.connected        = p_buffer[4];
-    data.over_gatt        = p_buffer[5];
-    mesh_provision_process_event(WICED_BT_MESH_PROXY_CONNECTION_STATUS, p_event, &data);
+    while (p_tx->outstanding != 0)
+    {
+        elapsed_us = now - p_tx->send_time_us[p_tx->oldest];
+        if (elapsed_us < (uint64_t)mesh_hci_tx_credit_timeout_ms * 1000)
+            return mesh_hci_tx_credit_timeout_ms - (uint32_t)(elapsed_us / 1000);
+
+        mesh_hci_tx_credit_return(p_tx);
+        p_tx->credit_timeouts++;
+    }
+    return 0;
 }
 
-void process_provision_link_report(uint8_t *p_buffer, uint16_t len)
+static void mesh_hci_tx_stall_end(mesh_hci_tx_cb_t *p_tx, uint64_t now)
 {
-    wiced_bt_mesh_provision_link_report_data_t data;
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
-        return;
+    uint32_t stall_time = (uint32_t)(now - p_tx->stall_start_us);
 
-    data.link_status = p_buffer[0];
-    data.rpr_state = p_buffer[1];
-    data.reason = p_buffer[2];
-    data.over_gatt = p_buffer[3];
-    mesh_provision_process_event(WICED_BT_MESH_PROVISION_LINK_REPORT, p_event, &data);
+    p_tx->stall_time_us += stall_time;
+    if (stall_time > p_tx->max_stall_time_us)
+        p_tx->max_stall_time_us = stall_time;
+    p_tx->stall_start_us = 0;
 }
 
-void process_provision_device_capabilities(uint8_t *p_buffer, uint16_t len)
+/*
+ * Send queued commands while there are credits available. If the queue is still not empty,
+ * start the timer to recheck it when the oldest credit expires.
+ */
+static void mesh_hci_tx_drain(mesh_hci_tx_cb_t *p_tx)
 {
-    wiced_bt_mesh_provision_device_capabilities_data_t data;
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
-        return;
+    mesh_hci_tx_entry_t *p_entry;
+    uint64_t now = mesh_hci_event_time_us();
 
-    data.provisioner_addr  = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
-    data.elements_num      = p_buffer[2];
-    data.algorithms        = p_buffer[3] + ((uint16_t)p_buffer[4] << 8);
-    data.pub_key_type      = p_buffer[5];
-    data.static_oob_type   = p_buffer[6];
-    data.output_oob_size   = p_buffer[7];
-    data.output_oob_action = p_buffer[8] + ((uint16_t)p_buffer[9] << 8);
-    data.input_oob_size    = p_buffer[10];
-    data.input_oob_action  = p_buffer[11] + ((uint16_t)p_buffer[12] << 8);
-    mesh_provision_process_event(WICED_BT_MESH_PROVISION_DEVICE_CAPABILITIES, p_event, &data);
+    mesh_hci_tx_expire_credits(p_tx, now);
+
+    while ((p_tx->p_first != NULL) && ((mesh_hci_tx_window == 0) || (p_tx->outstanding < mesh_hci_tx_window)))
+    {
+        p_entry = p_tx->p_first;
+        if ((p_tx->p_first = p_entry->p_next) == NULL)
+            p_tx->p_last = NULL;
+        p_tx->queue_depth--;
+
+        mesh_hci_tx_transmit(p_tx, p_entry->opcode, p_entry->data, p_entry->length);
+        wiced_bt_free_buffer(p_entry);
+    }
+    if (p_tx->p_first != NULL)
+        wiced_start_timer(&p_tx->timer, mesh_hci_tx_expire_credits(p_tx, now));
+    else if (p_tx->stall_start_us != 0)
+        mesh_hci_tx_stall_end(p_tx, now);
 }
 
-void process_provision_oob_data(uint8_t *p_buffer, uint16_t len)
+static void mesh_hci_tx_timer_cb(TIMER_PARAM_TYPE arg)
 {
-    wiced_bt_mesh_provision_device_oob_request_data_t data;
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
-        return;
+    mesh_hci_tx_drain((mesh_hci_tx_cb_t *)arg);
+}
 
-    data.provisioner_addr = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
-    data.type = p_buffer[2];
-    data.size = p_buffer[3];
-    data.action = p_buffer[4];
-    mesh_provision_process_event(WICED_BT_MESH_PROVISION_GET_OOB_DATA, p_event, &data);
+static void mesh_hci_tx_timer_init(mesh_hci_tx_cb_t *p_tx)
+{
+    if (!p_tx->timer_initialized)
+    {
+        wiced_init_timer(&p_tx->timer, mesh_hci_tx_timer_cb, (TIMER_PARAM_TYPE)p_tx, WICED_MILLI_SECONDS_TIMER);
+        p_tx->timer_initialized = WICED_TRUE;
+    }
 }
 
-#if defined(CERTIFICATE_BASED_PROVISIONING_SUPPORTED)
-void process_provision_record_list(uint8_t *p_buffer, uint16_t len)
+/*
+ * Multiple HCI transports.
+ * Each additional transport is a device configured as a separate provisioner node of the same network. Commands
+ * to the model servers (HCI_CONTROL_GROUP_MESH_MODELS) can be sent from any of them and are spread between the
+ * transports. Everything else, provisioning, configuration, proxy and vendor data, goes to the first transport,
+ * except for the commands which configure the device of the additional transport itself.
+ * A node is sent to over the transport that hears it with the best RSSI, unless that transport has noticeably
+ * more commands in flight than the least loaded one. Nodes not heard yet, groups and virtual addresses go to the
+ * least loaded transport.
+ */
+#define MESH_HCI_ROUTE_NUM_ENTRIES      0x7FFF      // one entry per unicast address
+#define MESH_HCI_ROUTE_RSSI_HYSTERESIS  3           // switch to the other transport if it hears the node that much better
+#define MESH_HCI_ROUTE_LOAD_SLACK       4           // commands the preferred transport may have above the least loaded
+
+typedef struct
 {
-    wiced_bt_mesh_core_provisioning_list_t data;
-    wiced_bt_mesh_event_t* p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
-        return;
+    uint8_t transport;                              // transport index + 1, 0 if the node has not been heard
+    int8_t  rssi;
+} mesh_hci_route_t;
 
-    data.extensions = p_buffer[0] + (uint16_t)(p_buffer[1] << 8);
-    data.list_size = (len - sizeof(uint16_t))/sizeof(uint16_t);
-    for (uint8_t i = 0; i < data.list_size; ++i)
-    {
-        data.list[i] = p_buffer[sizeof(uint16_t) + 2*i] + (uint16_t)(p_buffer[sizeof(uint16_t) + 2*i + 1] << 8);
-    }
-    mesh_provision_process_event(WICED_BT_MESH_DEVICE_PROVISIONING_RECORD_LIST, p_event, &data);
+static mesh_hci_route_t *mesh_hci_route_table = NULL;
+static int               mesh_hci_tx_pinned = -1;
+static int               mesh_hci_rx_transport = 0;
+static uint8_t           mesh_hci_next_transport = 0;
+
+static uint32_t mesh_hci_tx_load(mesh_hci_tx_cb_t *p_tx)
+{
+    return p_tx->outstanding + p_tx->queue_depth;
 }
-void process_provision_record_response(uint8_t *p_buffer, uint16_t len)
+
+static int mesh_hci_transport_by_addr(uint16_t addr)
 {
-    wiced_bt_mesh_core_provisioning_record_t data;
-    wiced_bt_mesh_event_t* p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
-        return;
+    int i;
 
-    data.status = p_buffer[0];
-    data.u.response.record_id = p_buffer[1] + (uint16_t)(p_buffer[2] << 8);
-    data.u.response.fragment_offset = p_buffer[3] + (uint16_t)(p_buffer[4] << 8);
-    data.u.response.total_length = p_buffer[5] + (uint16_t)(p_buffer[6] << 8);
-    data.size = len - sizeof(data.status) - sizeof(data.u.response);
-    for (uint8_t i = 0; i < data.size; ++i)
+    for (i = 0; i < mesh_hci_num_transports; i++)
     {
-        data.data[i] = p_buffer[sizeof(data.status) + sizeof(data.u.response) + i];
+        if ((mesh_hci_tx_cb[i].local_addr != 0) && (mesh_hci_tx_cb[i].local_addr == addr))
+            return i;
     }
-
-    mesh_provision_process_event(WICED_BT_MESH_DEVICE_PROVISIONING_RECORD_RESP, p_event, &data);
+    return -1;
 }
-#endif
 
-#ifdef MESH_DFU_ENABLED
-void process_fw_distribution_status(uint8_t *p_buffer, uint16_t len)
+/*
+ * Select the transport for the model command sent to dst. Only transports that have been configured are used,
+ * the ties are broken round robin so that the idle transports share the traffic.
+ */
+static int mesh_hci_transport_balance(uint16_t dst)
 {
-    wiced_bt_mesh_fw_distribution_status_data_t *p_data;
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    uint16_t num_nodes;
-
-    if (p_event == NULL)
-        return;
+    mesh_hci_route_t *p_route;
+    uint32_t load, min_load = 0xFFFFFFFF;
+    int i, t, best = 0;
 
-    num_nodes = p_buffer[5] + ((uint16_t)p_buffer[6] << 8);
-    p_data = (wiced_bt_mesh_fw_distribution_status_data_t*)wiced_bt_get_buffer(sizeof(wiced_bt_mesh_fw_distribution_status_data_t) + (num_nodes - 1) * sizeof(wiced_bt_mesh_fw_distribution_details_t));
-    if (!p_data)
+    for (i = 0; i < mesh_hci_num_transports; i++)
     {
-        wiced_bt_mesh_release_event(p_event);
-        return;
+        t = (mesh_hci_next_transport + i) % mesh_hci_num_transports;
+        if ((t != 0) && (mesh_hci_tx_cb[t].local_addr == 0))
+            continue;
+        if ((load = mesh_hci_tx_load(&mesh_hci_tx_cb[t])) < min_load)
+        {
+            min_load = load;
+            best = t;
+        }
     }
+    mesh_hci_next_transport = (uint8_t)((best + 1) % mesh_hci_num_transports);
 
-    p_data->state = p_buffer[0];
-    p_data->list_size = p_buffer[1] + ((uint16_t)p_buffer[2] << 8);
-    p_data->node_index = p_buffer[3] + ((uint16_t)p_buffer[4] << 8);
-    p_data->num_nodes = num_nodes;
-    for (int i = 0; i < p_data->num_nodes; i++)
+    if ((dst != 0) && ((dst & 0x8000) == 0))
     {
-        uint8_t *p = &p_buffer[7] + i * 4;
-        p_data->node[i].unicast_address = p[0] + ((uint16_t)p[1] << 8);
-        p_data->node[i].phase = p[2];
-        p_data->node[i].progress = p[3];
+        p_route = &mesh_hci_route_table[dst - 1];
+        t = p_route->transport - 1;
+        if ((p_route->transport != 0) && (mesh_hci_tx_cb[t].local_addr != 0) && (mesh_hci_tx_load(&mesh_hci_tx_cb[t]) <= min_load + MESH_HCI_ROUTE_LOAD_SLACK))
+        {
+            best = t;
+            mesh_hci_tx_cb[best].routed++;
+        }
     }
-
-    mesh_provision_process_event(WICED_BT_MESH_FW_DISTRIBUTION_STATUS, p_event, p_data);
-    wiced_bt_free_buffer(p_data);
+    mesh_hci_tx_cb[best].balanced++;
+    return best;
 }
 
-void process_fw_update_metadata_status(uint8_t *p_buffer, uint16_t len)
+static mesh_hci_tx_cb_t *mesh_hci_transport_select(uint16_t opcode, uint8_t *p_buffer, uint16_t length)
 {
-    wiced_bt_mesh_dfu_metadata_status_data_t data;
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
-        return;
+    uint16_t dst;
+    int t;
 
-    data.status = p_buffer[0];
-    data.add_info = p_buffer[1];
-    data.index = p_buffer[2];
+    if (mesh_hci_num_transports == 1)
+        return &mesh_hci_tx_cb[0];
+    if (mesh_hci_tx_pinned >= 0)
+        return &mesh_hci_tx_cb[mesh_hci_tx_pinned];
 
-    mesh_provision_process_event(WICED_BT_MESH_FW_UPDATE_METADATA_STATUS, p_event, &data);
+    // local device commands carry the address of the device first, configuration and model commands start
+    // with the HCI header and carry the destination first
+    if ((opcode == HCI_CONTROL_MESH_COMMAND_SET_LOCAL_DEVICE) || (opcode == HCI_CONTROL_MESH_COMMAND_SET_DEVICE_KEY) ||
+        ((opcode >= HCI_CONTROL_MESH_COMMAND_CONFIG_NODE_RESET) && (opcode <= HCI_CONTROL_MESH_COMMAND_CONFIG_KEY_REFRESH_PHASE_SET)) ||
+        ((opcode >> 8) == HCI_CONTROL_GROUP_MESH_MODELS))
+    {
+        if (length < 2)
+            return &mesh_hci_tx_cb[0];
+        dst = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
+        if ((t = mesh_hci_transport_by_addr(dst)) >= 0)
+            return &mesh_hci_tx_cb[t];
+        if ((opcode >> 8) == HCI_CONTROL_GROUP_MESH_MODELS)
+            return &mesh_hci_tx_cb[mesh_hci_transport_balance(dst)];
+    }
+    return &mesh_hci_tx_cb[0];
 }
-#endif
 
-void process_tx_complete(uint8_t *p_buffer, uint16_t len)
+/*
+ * Send the HCI command to the device, or queue it if the device has no room for it yet.
+ * Returns the transport status, or TRUE if the command has been queued.
+ */
+static uint8_t mesh_hci_send(uint16_t opcode, uint8_t *p_buffer, uint16_t length)
 {
-    uint16_t hci_opcode;
+    mesh_hci_tx_cb_t    *p_tx = mesh_hci_transport_select(opcode, p_buffer, length);
+    mesh_hci_tx_entry_t *p_entry;
 
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
-        return;
+    if (mesh_hci_tx_window == 0)
+        return mesh_hci_tx_transmit(p_tx, opcode, p_buffer, length);
 
-    hci_opcode = p_buffer[0] + (p_buffer[1] << 8);
-    p_event->status.tx_flag = p_buffer[2];
-    p_event->dst = p_buffer[3] + (p_buffer[4] << 8);
-    if (p_event->status.tx_flag == TX_STATUS_FAILED)
+    mesh_hci_tx_expire_credits(p_tx, mesh_hci_event_time_us());
+
+    if ((p_tx->p_first == NULL) && (p_tx->outstanding < mesh_hci_tx_window))
+        return mesh_hci_tx_transmit(p_tx, opcode, p_buffer, length);
+
+    if ((p_entry = (mesh_hci_tx_entry_t *)wiced_bt_get_buffer((uint16_t)(sizeof(mesh_hci_tx_entry_t) + length))) == NULL)
     {
-        Log("Node unreachable: opcode:%x addr:%x", hci_opcode, p_event->dst);
+        Log("HCI TX queue no memory opcode:%04x", opcode);
+        return mesh_hci_tx_transmit(p_tx, opcode, p_buffer, length);
     }
-    else
+    p_entry->p_next = NULL;
+    p_entry->opcode = opcode;
+    p_entry->length = length;
+    if (length != 0)
+        memcpy(p_entry->data, p_buffer, length);
+
+    p_tx->queued++;
+    if (++p_tx->queue_depth > p_tx->max_queue_depth)
+        p_tx->max_queue_depth = p_tx->queue_depth;
+
+    if (p_tx->p_last != NULL)
     {
-        // Log("Mesh Tx Complete: opcode:%x addr:%x", hci_opcode, addr);
+        p_tx->p_last->p_next = p_entry;
+        p_tx->p_last = p_entry;
+        return TRUE;
     }
-    mesh_provision_process_event(WICED_BT_MESH_TX_COMPLETE, p_event, NULL);
+    // first queued command starts the stall, the timer makes sure the queue is rechecked when the credit expires
+    p_tx->p_first = p_tx->p_last = p_entry;
+    p_tx->stall_start_us = mesh_hci_event_time_us();
+    wiced_start_timer(&p_tx->timer, mesh_hci_tx_expire_credits(p_tx, p_tx->stall_start_us));
+    return TRUE;
 }
 
-void process_node_reset_status(uint8_t *p_buffer, uint16_t len)
+int mesh_client_hci_tx_configure(uint16_t window, uint32_t credit_timeout_ms)
 {
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event)
+    mesh_hci_tx_cb_t *p_tx;
+    int i;
+
+    if (window > MESH_HCI_TX_WINDOW_MAX)
+        return MESH_CLIENT_ERR_INVALID_ARGS;
+
+    for (i = 0; i < mesh_hci_num_transports; i++)
     {
-        mesh_provision_process_event(WICED_BT_MESH_CONFIG_NODE_RESET_STATUS, p_event, NULL);
+        p_tx = &mesh_hci_tx_cb[i];
+        mesh_hci_tx_timer_init(p_tx);
+
+        // commands sent before the flow control is enabled are not accounted
+        if (mesh_hci_tx_window == 0)
+        {
+            p_tx->outstanding = 0;
+            p_tx->oldest = 0;
+        }
+        // shrinking the window keeps the newest outstanding commands
+        while (p_tx->outstanding > window)
+            mesh_hci_tx_credit_return(p_tx);
     }
+    mesh_hci_tx_window = window;
+    if (credit_timeout_ms != 0)
+        mesh_hci_tx_credit_timeout_ms = credit_timeout_ms;
+
+    for (i = 0; i < mesh_hci_num_transports; i++)
+    {
+        if (mesh_hci_tx_cb[i].p_first != NULL)
+            mesh_hci_tx_drain(&mesh_hci_tx_cb[i]);
+    }
+    return MESH_CLIENT_SUCCESS;
 }
 
-void process_composition_data_status(uint8_t *p_buffer, uint16_t len)
+static void mesh_hci_tx_stats_fill(mesh_hci_tx_cb_t *p_tx, mesh_client_hci_tx_stats_t *p_stats)
 {
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
-        return;
+    p_stats->window            = mesh_hci_tx_window;
+    p_stats->outstanding       = p_tx->outstanding;
+    p_stats->queue_depth       = p_tx->queue_depth;
+    p_stats->max_queue_depth   = p_tx->max_queue_depth;
+    p_stats->sent              = p_tx->sent;
+    p_stats->queued            = p_tx->queued;
+    p_stats->credit_timeouts   = p_tx->credit_timeouts;
+    p_stats->stall_time_us     = p_tx->stall_time_us;
+    p_stats->max_stall_time_us = p_tx->max_stall_time_us;
+    // include the stall in progress
+    if (p_tx->stall_start_us != 0)
+        p_stats->stall_time_us += mesh_hci_event_time_us() - p_tx->stall_start_us;
+}
 
-    wiced_bt_mesh_config_composition_data_status_data_t *p_comp_data = (wiced_bt_mesh_config_composition_data_status_data_t *)wiced_bt_get_buffer(sizeof(wiced_bt_mesh_config_composition_data_status_data_t) + len - 1);
-    if (p_comp_data == NULL)
+void mesh_client_hci_tx_stats_get(mesh_client_hci_tx_stats_t *p_stats)
+{
+    mesh_hci_tx_stats_fill(&mesh_hci_tx_cb[0], p_stats);
+}
+
+int mesh_client_hci_transport_add(mesh_client_hci_transport_send_t p_send, uint8_t *p_transport)
+{
+    mesh_hci_tx_cb_t *p_tx;
+
+    if (p_send == NULL)
+        return MESH_CLIENT_ERR_INVALID_ARGS;
+    if (mesh_hci_num_transports == MESH_CLIENT_HCI_MAX_TRANSPORTS)
+        return MESH_CLIENT_ERR_NO_MEMORY;
+    // the devices are configured when the network is opened
+    if (mesh_hci_tx_cb[0].local_addr != 0)
+        return MESH_CLIENT_ERR_INVALID_STATE;
+
+    if (mesh_hci_route_table == NULL)
     {
-        wiced_bt_mesh_release_event(p_event);
-        return;
+        if ((mesh_hci_route_table = (mesh_hci_route_t *)wiced_bt_get_buffer(sizeof(mesh_hci_route_t) * MESH_HCI_ROUTE_NUM_ENTRIES)) == NULL)
+            return MESH_CLIENT_ERR_NO_MEMORY;
+        memset(mesh_hci_route_table, 0, sizeof(mesh_hci_route_t) * MESH_HCI_ROUTE_NUM_ENTRIES);
     }
-    p_comp_data->page_number = p_buffer[0];
-    p_comp_data->data_len    = len - 1;
-    memcpy(p_comp_data->data, &p_buffer[1], len - 1);
+    p_tx = &mesh_hci_tx_cb[mesh_hci_num_transports];
+    memset(p_tx, 0, sizeof(mesh_hci_tx_cb_t));
+    p_tx->p_send = p_send;
+    mesh_hci_tx_timer_init(p_tx);
 
-    mesh_provision_process_event(WICED_BT_MESH_CONFIG_COMPOSITION_DATA_STATUS, p_event, p_comp_data);
+    *p_transport = mesh_hci_num_transports++;
+    return MESH_CLIENT_SUCCESS;
 }
 
-#ifdef LARGE_COMPOSITION_DATA_SUPPORTED
-void process_large_compos_data_status(uint8_t *p_buffer, uint16_t len)
+int mesh_client_hci_transport_stats_get(uint8_t transport, mesh_client_hci_transport_stats_t *p_stats)
 {
-    wiced_bt_mesh_config_large_compos_data_status_data_t data;
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
-        return;
+    if (transport >= mesh_hci_num_transports)
+        return MESH_CLIENT_ERR_NOT_FOUND;
 
-    STREAM_TO_UINT8(data.page, p_buffer);
-    STREAM_TO_UINT16(data.offset, p_buffer);
-    STREAM_TO_UINT16(data.total_size, p_buffer);
-    data.data_len = len - 5;
-    data.p_data = p_buffer;
+    p_stats->addr     = mesh_hci_tx_cb[transport].local_addr;
+    p_stats->balanced = mesh_hci_tx_cb[transport].balanced;
+    p_stats->routed   = mesh_hci_tx_cb[transport].routed;
+    mesh_hci_tx_stats_fill(&mesh_hci_tx_cb[transport], &p_stats->tx);
+    return MESH_CLIENT_SUCCESS;
+}
 
-    mesh_provision_process_event(WICED_BT_MESH_CONFIG_LARGE_COMPOS_DATA_STATUS, p_event, &data);
+uint8_t mesh_hci_transport_num(void)
+{
+    return mesh_hci_num_transports;
 }
-#endif
 
-void process_net_key_status(uint8_t *p_buffer, uint16_t len)
+/*
+ * Set the address of the device of the transport. Commands configuring that address are sent to the transport,
+ * and the transport is used for the model commands while the address is not 0. Clearing the address of the
+ * first transport forgets all the routes, the network is being closed.
+ */
+void mesh_hci_transport_local_addr_set(uint8_t transport, uint16_t addr)
 {
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
+    if (transport >= mesh_hci_num_transports)
         return;
 
-    wiced_bt_mesh_config_netkey_status_data_t data;
-
-    data.status = p_buffer[0];
-    data.net_key_idx = p_buffer[1] + ((uint16_t)p_buffer[2] << 8);
+    mesh_hci_tx_cb[transport].local_addr = addr;
+    if ((transport == 0) && (addr == 0) && (mesh_hci_route_table != NULL))
+        memset(mesh_hci_route_table, 0, sizeof(mesh_hci_route_t) * MESH_HCI_ROUTE_NUM_ENTRIES);
+}
 
-    mesh_provision_process_event(WICED_BT_MESH_CONFIG_NETKEY_STATUS, p_event, &data);
+/*
+ * Send all following commands to the transport, -1 restores the normal selection. Used for commands that
+ * do not carry the address of the local device, like the sequence number of the device.
+ */
+void mesh_hci_transport_pin(int transport)
+{
+    mesh_hci_tx_pinned = ((transport >= 0) && (transport < mesh_hci_num_transports)) ? transport : -1;
 }
 
-void process_key_refresh_phase_status(uint8_t *p_buffer, uint16_t len)
+/*
+ * Learn which transport hears the node best from the RSSI of the messages received from it, and forget the route
+ * when the transport fails to deliver a message to the node.
+ */
+static void mesh_hci_route_update(int transport, uint16_t opcode, uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
-        return;
+    mesh_hci_route_t *p_route;
+    uint16_t addr;
+    int8_t   rssi;
 
-    wiced_bt_mesh_config_key_refresh_phase_status_data_t data;
+    if (opcode == HCI_CONTROL_MESH_EVENT_TX_COMPLETE)
+    {
+        // event header, HCI opcode of the command, tx flag and destination
+        if (len < 13 + 5)
+            return;
+        addr = p_buffer[16] + ((uint16_t)p_buffer[17] << 8);
+        if ((p_buffer[15] != TX_STATUS_FAILED) || (addr == 0) || (addr & 0x8000))
+            return;
+        p_route = &mesh_hci_route_table[addr - 1];
+        if (p_route->transport == transport + 1)
+            p_route->transport = 0;
+        return;
+    }
+    if (((opcode >> 8) != HCI_CONTROL_GROUP_MESH_MODELS) || (len < 13))
+        return;
 
-    data.status = p_buffer[0];
-    data.net_key_idx = p_buffer[1] + ((uint16_t)p_buffer[2] << 8);
-    data.phase = p_buffer[3];
+    addr = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
+    rssi = (int8_t)p_buffer[7];
+    if ((addr == 0) || (addr & 0x8000) || (mesh_hci_transport_by_addr(addr) >= 0))
+        return;
 
-    mesh_provision_process_event(WICED_BT_MESH_CONFIG_KEY_REFRESH_PHASE_STATUS, p_event, &data);
+    p_route = &mesh_hci_route_table[addr - 1];
+    if ((p_route->transport == 0) || (p_route->transport == transport + 1))
+    {
+        p_route->transport = (uint8_t)(transport + 1);
+        p_route->rssi = rssi;
+    }
+    else if (rssi >= p_route->rssi + MESH_HCI_ROUTE_RSSI_HYSTERESIS)
+    {
+        p_route->transport = (uint8_t)(transport + 1);
+        p_route->rssi = rssi;
+    }
 }
 
-void process_app_key_status(uint8_t *p_buffer, uint16_t len)
+static void mesh_hci_event_dispatch(uint16_t opcode, uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
-        return;
+    mesh_hci_event_entry_t *p_entry;
+    uint64_t start_time;
+    uint32_t parse_time;
 
-    wiced_bt_mesh_config_appkey_status_data_t data;
+#ifdef MIBLE
+    extern void mible_wiced_set_event(void);
+    if ((opcode != HCI_CONTROL_MESH_EVENT_COMMAND_STATUS) && (opcode != HCI_CONTROL_MESH_EVENT_TX_COMPLETE))
+        mible_wiced_set_event();
+#endif
 
-    data.status = p_buffer[0];
-    data.net_key_idx = p_buffer[1] + ((uint16_t)p_buffer[2] << 8);
-    data.app_key_idx = p_buffer[3] + ((uint16_t)p_buffer[4] << 8);
+    if ((p_entry = mesh_hci_event_entry(opcode)) == NULL)
+    {
+        Log("Rcvd Unknown Op Code: 0x%04x", opcode);
+        return;
+    }
+    p_entry->count++;
+    p_entry->bytes += len;
 
-    mesh_provision_process_event(WICED_BT_MESH_CONFIG_APPKEY_STATUS, p_event, &data);
+    if (p_entry->p_handler == NULL)
+    {
+        Log("Rcvd Unknown Op Code: 0x%04x", opcode);
+        return;
+    }
+    start_time = mesh_hci_event_time_us();
+    p_entry->p_handler(p_buffer, len);
+    parse_time = (uint32_t)(mesh_hci_event_time_us() - start_time);
+
+    p_entry->parse_time_us += parse_time;
+    if (parse_time > p_entry->max_parse_time_us)
+        p_entry->max_parse_time_us = parse_time;
 }
 
-void process_model_app_bind_status(uint8_t *p_buffer, uint16_t len)
+void mesh_client_hci_transport_process_data(uint8_t transport, uint16_t opcode, uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
+    if (transport >= mesh_hci_num_transports)
         return;
 
-    wiced_bt_mesh_config_model_app_bind_status_data_t data;
+    if (mesh_hci_num_transports > 1)
+    {
+        mesh_hci_route_update(transport, opcode, p_buffer, len);
 
-    data.status         = p_buffer[0];
-    data.element_addr   = p_buffer[1] + ((uint16_t)p_buffer[2] << 8);
-    data.company_id     = p_buffer[3] + ((uint32_t)p_buffer[4] << 8);
-    data.model_id       = p_buffer[5] + ((uint32_t)p_buffer[6] << 8);
-    data.app_key_idx    = p_buffer[7] + ((uint16_t)p_buffer[8] << 8);
+        // a publication to a group is received by every transport subscribed to it, report it once
+        if ((transport != 0) && ((opcode >> 8) == HCI_CONTROL_GROUP_MESH_MODELS) && (len >= 4) && (p_buffer[3] & 0x80))
+            return;
+    }
+    mesh_hci_rx_transport = transport;
+    mesh_hci_event_dispatch(opcode, p_buffer, len);
+    mesh_hci_rx_transport = 0;
+}
 
-    mesh_provision_process_event(WICED_BT_MESH_CONFIG_MODEL_APP_BIND_STATUS, p_event, &data);
+void wiced_hci_process_data(uint16_t opcode, uint8_t *p_buffer, uint16_t len)
+{
+    mesh_client_hci_transport_process_data(0, opcode, p_buffer, len);
 }
 
-void process_model_sub_status(uint8_t *p_buffer, uint16_t len)
+void process_provision_command_status(uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
-        return;
+    mesh_hci_tx_cb_t *p_tx = &mesh_hci_tx_cb[mesh_hci_rx_transport];
 
-    wiced_bt_mesh_config_model_subscription_status_data_t data;
+    if (mesh_hci_tx_window != 0)
+    {
+        mesh_hci_tx_credit_return(p_tx);
+        if (p_tx->p_first != NULL)
+            mesh_hci_tx_drain(p_tx);
+    }
+    mesh_provision_process_event(WICED_BT_MESH_COMMAND_STATUS, NULL, NULL);
+}
 
-    data.status = p_buffer[0];
-    data.element_addr = p_buffer[1] + ((uint16_t)p_buffer[2] << 8);
-    data.company_id = p_buffer[3] + ((uint32_t)p_buffer[4] << 8);
-    data.model_id = p_buffer[5] + ((uint32_t)p_buffer[6] << 8);
-    data.addr = p_buffer[7] + ((uint16_t)p_buffer[8] << 8);
+void process_core_seq_changed(uint8_t *p_buffer, uint16_t len)
+{
+    wiced_bt_mesh_core_state_seq_t data;
+    data.addr = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
+    data.seq = p_buffer[2] + ((uint32_t)p_buffer[3] << 8) + ((uint32_t)p_buffer[4] << 16) + ((uint32_t)p_buffer[5] << 24);
+    data.previous_iv_idx = p_buffer[6];
+    data.rpl_entry_idx = p_buffer[7] + ((uint16_t)p_buffer[8] << 8);
 
-    mesh_provision_process_event(WICED_BT_MESH_CONFIG_MODEL_SUBSCRIPTION_STATUS, p_event, &data);
+    // the sequence number of an additional transport is stored with its address, the replay protection list
+    // is kept by each device, only the one of the first transport is stored
+    if (mesh_hci_rx_transport != 0)
+    {
+        if ((data.addr != 0) || (mesh_hci_tx_cb[mesh_hci_rx_transport].local_addr == 0))
+            return;
+        data.addr = mesh_hci_tx_cb[mesh_hci_rx_transport].local_addr;
+    }
+    else if ((data.addr != 0) && (mesh_hci_transport_by_addr(data.addr) > 0))
+    {
+        return;
+    }
+    mesh_provision_process_event(WICED_BT_MESH_SEQ_CHANGED, NULL, &data);
 }
 
-void process_model_pub_status(uint8_t *p_buffer, uint16_t len)
+void process_core_raw_model_data(uint8_t *p_buffer, uint16_t len)
 {
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    wiced_bt_mesh_config_model_publication_status_data_t data;
-
-    data.status = p_buffer[0];
-    data.element_addr = p_buffer[1] + ((uint16_t)p_buffer[2] << 8);
-    data.company_id = p_buffer[3] + ((uint32_t)p_buffer[4] << 8);
-    data.model_id = p_buffer[5] + ((uint32_t)p_buffer[6] << 8);
-    data.publish_addr = p_buffer[7] + ((uint16_t)p_buffer[8] << 8);
-    data.app_key_idx = p_buffer[9] + ((uint16_t)p_buffer[10] << 8);
-    data.credential_flag = p_buffer[11];
-    data.publish_ttl = p_buffer[12];
-    data.publish_period = p_buffer[13] + ((uint32_t)p_buffer[14] << 8) + ((uint32_t)p_buffer[15] << 16) + ((uint32_t)p_buffer[16] << 24);
-    data.publish_retransmit_count = p_buffer[17];
-    data.publish_retransmit_interval = p_buffer[18] + ((uint16_t)p_buffer[19] << 8);
+    if ((p_buffer[0] & (MESH_APP_PAYLOAD_OP_LONG | MESH_APP_PAYLOAD_OP_MANUF_SPECIFIC)) == (MESH_APP_PAYLOAD_OP_LONG | MESH_APP_PAYLOAD_OP_MANUF_SPECIFIC))
+    {
+        p_event->opcode = p_buffer[0] & ~(MESH_APP_PAYLOAD_OP_LONG | MESH_APP_PAYLOAD_OP_MANUF_SPECIFIC);
+        p_event->company_id = (p_buffer[1] << 8) + p_buffer[2];
+        p_buffer += 3;
+        len -= 3;
+    }
+    else
+    {
+        p_event->company_id = MESH_COMPANY_ID_BT_SIG;
+        p_event->opcode = (p_buffer[0] << 8) + p_buffer[1];
+        p_buffer += 2;
+        len -= 2;
+    }
+    p_event->data_len = len;
 
-    mesh_provision_process_event(WICED_BT_MESH_CONFIG_MODEL_PUBLICATION_STATUS, p_event, &data);
+    mesh_provision_process_event(WICED_BT_MESH_RAW_MODEL_DATA, p_event, p_buffer);
 }
 
-void process_net_transmit_status(uint8_t *p_buffer, uint16_t len)
+void process_provision_scan_capabilities_status(uint8_t *p_buffer, uint16_t len)
 {
+    wiced_bt_mesh_provision_scan_capabilities_status_data_t data;
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    wiced_bt_mesh_config_network_transmit_status_data_t data;
-
-    data.count = p_buffer[0];
-    data.interval = p_buffer[1] + ((uint16_t)p_buffer[2] << 8);
-
-    mesh_provision_process_event(WICED_BT_MESH_CONFIG_NETWORK_TRANSMIT_STATUS, p_event, &data);
+    data.max_scanned_items = p_buffer[0];
+    mesh_provision_process_event(WICED_BT_MESH_PROVISION_SCAN_CAPABILITIES_STATUS, p_event, &data);
 }
 
-void process_default_ttl_status(uint8_t *p_buffer, uint16_t len)
+void process_provision_scan_status(uint8_t *p_buffer, uint16_t len)
 {
+    wiced_bt_mesh_provision_scan_status_data_t data;
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    wiced_bt_mesh_config_default_ttl_status_data_t data;
-
-    data.ttl = p_buffer[0];
-    data.received_ttl = p_buffer[1];
-
-    mesh_provision_process_event(WICED_BT_MESH_CONFIG_DEFAULT_TTL_STATUS, p_event, &data);
+    data.status = p_buffer[0];
+    data.state = p_buffer[1];
+    data.scanned_items_limit = p_buffer[2];
+    data.timeout = p_buffer[3];
+    mesh_provision_process_event(WICED_BT_MESH_PROVISION_SCAN_STATUS, p_event, &data);
 }
 
-void process_relay_status(uint8_t *p_buffer, uint16_t len)
+void process_provision_scan_report(uint8_t *p_buffer, uint16_t len)
 {
+#ifdef PROVISION_SCAN_REPORT_INCLUDE_BDADDR
+    int i;
+#endif
+    wiced_bt_mesh_provision_scan_report_data_t data;
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    wiced_bt_mesh_config_relay_status_data_t data;
-
-    data.state = p_buffer[0];
-    data.retransmit_count = p_buffer[1];
-    data.retransmit_interval = p_buffer[2] + ((uint16_t)p_buffer[3] << 8);
-
-    mesh_provision_process_event(WICED_BT_MESH_CONFIG_RELAY_STATUS, p_event, &data);
+    data.rssi = p_buffer[0];
+    memcpy(data.uuid, &p_buffer[1], 16);
+    data.oob = p_buffer[17] + (p_buffer[18] << 8);
+    data.uri_hash = p_buffer[19] + ((uint32_t)p_buffer[20] << 8) + ((uint32_t)p_buffer[21] << 16) + ((uint32_t)p_buffer[22] << 24);
+#ifdef PROVISION_SCAN_REPORT_INCLUDE_BDADDR
+    for (i = 0; i < BD_ADDR_LEN; i++)
+        data.bdaddr[5 - i] = p_buffer[23 + i];
+#endif
+    mesh_provision_process_event(WICED_BT_MESH_PROVISION_SCAN_REPORT, p_event, &data);
 }
 
-void process_friend_status(uint8_t *p_buffer, uint16_t len)
+void process_provision_scan_extended_report(uint8_t *p_buffer, uint16_t len)
 {
+    wiced_bt_mesh_provision_scan_extended_report_data_t data;
+    uint8_t *p_adv_data, *p;
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    wiced_bt_mesh_config_friend_status_data_t data;
-
-    data.state = p_buffer[0];
+    memset(&data, 0, sizeof(data));
+    data.status = p_buffer[0];
+    memcpy(data.uuid, &p_buffer[1], 16);
+    if (len >= 19)
+    {
+        data.oob = p_buffer[17] + (p_buffer[18] << 8);
+        len -= 19;
+        p = data.adv_data;
+        p_adv_data = &p_buffer[19];
+        while (len > 0)
+        {
+            if (*p_adv_data == 0)
+                break;
 
-    mesh_provision_process_event(WICED_BT_MESH_CONFIG_FRIEND_STATUS, p_event, &data);
+            if ((*p_adv_data + 1 > len) || ((p + *p_adv_data + 1) > (data.adv_data + sizeof(data.adv_data))))
+            {
+                Log("bad adv data:");
+                break;
+            }
+            memcpy(p, p_adv_data, *p_adv_data + 1);
+            p += *p_adv_data + 1;
+            len -= (*p_adv_data + 1);
+            p_adv_data += *p_adv_data + 1;
+        }
+    }
+    mesh_provision_process_event(WICED_BT_MESH_PROVISION_SCAN_EXTENDED_REPORT, p_event, &data);
 }
 
-void process_gatt_proxy_status(uint8_t *p_buffer, uint16_t len)
+void process_provision_end(uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_config_gatt_proxy_status_data_t data;
+    wiced_bt_mesh_provision_status_data_t data;
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    data.state = p_buffer[0];
-
-    mesh_provision_process_event(WICED_BT_MESH_CONFIG_GATT_PROXY_STATUS, p_event, &data);
+    data.provisioner_addr = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
+    data.addr             = p_buffer[2] + ((uint16_t)p_buffer[3] << 8);
+    data.net_key_idx      = p_buffer[4] + ((uint16_t)p_buffer[5] << 8);
+    data.result           = p_buffer[6];
+    memcpy(data.dev_key, &p_buffer[7], 16);
+    mesh_provision_process_event(WICED_BT_MESH_PROVISION_END, p_event, &data);
 }
 
-void process_beacon_status(uint8_t *p_buffer, uint16_t len)
+void process_proxy_connection_status(uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_config_beacon_status_data_t data;
+    wiced_bt_mesh_connect_status_data_t data;
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    data.state = p_buffer[0];
-
-    mesh_provision_process_event(WICED_BT_MESH_CONFIG_BEACON_STATUS, p_event, &data);
+    data.provisioner_addr = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
+    data.addr             = p_buffer[2] + ((uint16_t)p_buffer[3] << 8);
+    data.connected        = p_buffer[4];
+    data.over_gatt        = p_buffer[5];
+    mesh_provision_process_event(WICED_BT_MESH_PROXY_CONNECTION_STATUS, p_event, &data);
 }
 
-void process_node_identity_status(uint8_t *p_buffer, uint16_t len)
+void process_provision_link_report(uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_config_node_identity_status_data_t data;
+    wiced_bt_mesh_provision_link_report_data_t data;
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    data.status = p_buffer[0];
-    data.net_key_idx = p_buffer[1] + (p_buffer[2] << 8);
-    data.identity = p_buffer[3];
-
-    mesh_provision_process_event(WICED_BT_MESH_CONFIG_NODE_IDENTITY_STATUS, p_event, &data);
+    data.link_status = p_buffer[0];
+    data.rpr_state = p_buffer[1];
+    data.reason = p_buffer[2];
+    data.over_gatt = p_buffer[3];
+    mesh_provision_process_event(WICED_BT_MESH_PROVISION_LINK_REPORT, p_event, &data);
 }
 
-#ifdef PRIVATE_PROXY_SUPPORTED
-void process_private_gatt_proxy_status(uint8_t *p_buffer, uint16_t len)
+void process_provision_device_capabilities(uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_config_private_gatt_proxy_status_data_t data;
+    wiced_bt_mesh_provision_device_capabilities_data_t data;
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    data.state = p_buffer[0];
-
-    mesh_provision_process_event(WICED_BT_MESH_CONFIG_PRIVATE_GATT_PROXY_STATUS, p_event, &data);
+    data.provisioner_addr  = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
+    data.elements_num      = p_buffer[2];
+    data.algorithms        = p_buffer[3] + ((uint16_t)p_buffer[4] << 8);
+    data.pub_key_type      = p_buffer[5];
+    data.static_oob_type   = p_buffer[6];
+    data.output_oob_size   = p_buffer[7];
+    data.output_oob_action = p_buffer[8] + ((uint16_t)p_buffer[9] << 8);
+    data.input_oob_size    = p_buffer[10];
+    data.input_oob_action  = p_buffer[11] + ((uint16_t)p_buffer[12] << 8);
+    mesh_provision_process_event(WICED_BT_MESH_PROVISION_DEVICE_CAPABILITIES, p_event, &data);
 }
 
-void process_private_beacon_status(uint8_t *p_buffer, uint16_t len)
+void process_provision_oob_data(uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_config_private_beacon_status_data_t data;
+    wiced_bt_mesh_provision_device_oob_request_data_t data;
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    data.state = p_buffer[0];
-    data.random_update_interval = p_buffer[1];
-
-    mesh_provision_process_event(WICED_BT_MESH_CONFIG_PRIVATE_BEACON_STATUS, p_event, &data);
+    data.provisioner_addr = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
+    data.type = p_buffer[2];
+    data.size = p_buffer[3];
+    data.action = p_buffer[4];
+    mesh_provision_process_event(WICED_BT_MESH_PROVISION_GET_OOB_DATA, p_event, &data);
 }
 
-void process_private_node_identity_status(uint8_t *p_buffer, uint16_t len)
+#if defined(CERTIFICATE_BASED_PROVISIONING_SUPPORTED)
+void process_provision_record_list(uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_config_private_node_identity_status_data_t data;
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    wiced_bt_mesh_core_provisioning_list_t data;
+    wiced_bt_mesh_event_t* p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
+
+    data.extensions = p_buffer[0] + (uint16_t)(p_buffer[1] << 8);
+    data.list_size = (len - sizeof(uint16_t))/sizeof(uint16_t);
+    for (uint8_t i = 0; i < data.list_size; ++i)
+    {
+        data.list[i] = p_buffer[sizeof(uint16_t) + 2*i] + (uint16_t)(p_buffer[sizeof(uint16_t) + 2*i + 1] << 8);
+    }
+    mesh_provision_process_event(WICED_BT_MESH_DEVICE_PROVISIONING_RECORD_LIST, p_event, &data);
+}
+void process_provision_record_response(uint8_t *p_buffer, uint16_t len)
+{
+    wiced_bt_mesh_core_provisioning_record_t data;
+    wiced_bt_mesh_event_t* p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
     data.status = p_buffer[0];
-    data.net_key_idx = p_buffer[1] + (p_buffer[2] << 8);
-    data.identity = p_buffer[3];
+    data.u.response.record_id = p_buffer[1] + (uint16_t)(p_buffer[2] << 8);
+    data.u.response.fragment_offset = p_buffer[3] + (uint16_t)(p_buffer[4] << 8);
+    data.u.response.total_length = p_buffer[5] + (uint16_t)(p_buffer[6] << 8);
+    data.size = len - sizeof(data.status) - sizeof(data.u.response);
+    for (uint8_t i = 0; i < data.size; ++i)
+    {
+        data.data[i] = p_buffer[sizeof(data.status) + sizeof(data.u.response) + i];
+    }
 
-    mesh_provision_process_event(WICED_BT_MESH_CONFIG_PRIVATE_NODE_IDENTITY_STATUS, p_event, &data);
+    mesh_provision_process_event(WICED_BT_MESH_DEVICE_PROVISIONING_RECORD_RESP, p_event, &data);
 }
+#endif
 
-void process_on_demand_private_proxy_status(uint8_t *p_buffer, uint16_t len)
+#ifdef MESH_DFU_ENABLED
+void process_fw_distribution_status(uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_config_on_demand_private_proxy_status_data_t data;
+    wiced_bt_mesh_fw_distribution_status_data_t *p_data;
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    uint16_t num_nodes;
+
     if (p_event == NULL)
         return;
 
-    data.state = p_buffer[0];
+    num_nodes = p_buffer[5] + ((uint16_t)p_buffer[6] << 8);
+    p_data = (wiced_bt_mesh_fw_distribution_status_data_t*)wiced_bt_get_buffer(sizeof(wiced_bt_mesh_fw_distribution_status_data_t) + (num_nodes - 1) * sizeof(wiced_bt_mesh_fw_distribution_details_t));
+    if (!p_data)
+    {
+        wiced_bt_mesh_release_event(p_event);
+        return;
+    }
 
-    mesh_provision_process_event(WICED_BT_MESH_CONFIG_ON_DEMAND_PRIVATE_PROXY_STATUS, p_event, &data);
+    p_data->state = p_buffer[0];
+    p_data->list_size = p_buffer[1] + ((uint16_t)p_buffer[2] << 8);
+    p_data->node_index = p_buffer[3] + ((uint16_t)p_buffer[4] << 8);
+    p_data->num_nodes = num_nodes;
+    for (int i = 0; i < p_data->num_nodes; i++)
+    {
+        uint8_t *p = &p_buffer[7] + i * 4;
+        p_data->node[i].unicast_address = p[0] + ((uint16_t)p[1] << 8);
+        p_data->node[i].phase = p[2];
+        p_data->node[i].progress = p[3];
+    }
+
+    mesh_provision_process_event(WICED_BT_MESH_FW_DISTRIBUTION_STATUS, p_event, p_data);
+    wiced_bt_free_buffer(p_data);
 }
-#endif
 
-void process_proxy_filter_status(uint8_t *p_buffer, uint16_t len)
+void process_fw_update_metadata_status(uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_proxy_filter_status_data_t data;
+    wiced_bt_mesh_dfu_metadata_status_data_t data;
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    data.type = p_buffer[0];
-    data.list_size = p_buffer[1] + (p_buffer[2] << 8);
+    data.status = p_buffer[0];
+    data.add_info = p_buffer[1];
+    data.index = p_buffer[2];
 
-    mesh_provision_process_event(WICED_BT_MESH_PROXY_FILTER_STATUS, p_event, &data);
+    mesh_provision_process_event(WICED_BT_MESH_FW_UPDATE_METADATA_STATUS, p_event, &data);
 }
+#endif
 
-void process_def_trans_time_status(uint8_t *p_buffer, uint16_t len)
+void process_tx_complete(uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_default_transition_time_data_t data;
+    uint16_t hci_opcode;
+
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event != NULL)
+    if (p_event == NULL)
+        return;
+
+    hci_opcode = p_buffer[0] + (p_buffer[1] << 8);
+    p_event->status.tx_flag = p_buffer[2];
+    p_event->dst = p_buffer[3] + (p_buffer[4] << 8);
+    if (p_event->status.tx_flag == TX_STATUS_FAILED)
     {
-        p_event->app_key_idx = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
-        p_event->element_idx = p_buffer[2];
-        data.time = p_buffer[3] + ((uint32_t)p_buffer[4] << 8) + ((uint32_t)p_buffer[5] << 16) + ((uint32_t)p_buffer[6] << 24);
+        Log("Node unreachable: opcode:%x addr:%x", hci_opcode, p_event->dst);
+    }
+    else
+    {
+        // Log("Mesh Tx Complete: opcode:%x addr:%x", hci_opcode, addr);
+    }
+    mesh_provision_process_event(WICED_BT_MESH_TX_COMPLETE, p_event, NULL);
+}
 
-        mesh_provision_process_event(WICED_BT_MESH_DEFAULT_TRANSITION_TIME_STATUS, p_event, &data);
+void process_node_reset_status(uint8_t *p_buffer, uint16_t len)
+{
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event)
+    {
+        mesh_provision_process_event(WICED_BT_MESH_CONFIG_NODE_RESET_STATUS, p_event, NULL);
     }
 }
 
-void process_on_off_status(uint8_t *p_buffer, uint16_t len)
+void process_composition_data_status(uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_onoff_status_data_t data;
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    data.present_onoff = p_buffer[0];
-    data.target_onoff = p_buffer[1];
-    data.remaining_time = p_buffer[2] + ((uint32_t)p_buffer[3] << 8) + ((uint32_t)p_buffer[4] << 16) + ((uint32_t)p_buffer[5] << 24);
+    wiced_bt_mesh_config_composition_data_status_data_t *p_comp_data = (wiced_bt_mesh_config_composition_data_status_data_t *)wiced_bt_get_buffer(sizeof(wiced_bt_mesh_config_composition_data_status_data_t) + len - 1);
+    if (p_comp_data == NULL)
+    {
+        wiced_bt_mesh_release_event(p_event);
+        return;
+    }
+    p_comp_data->page_number = p_buffer[0];
+    p_comp_data->data_len    = len - 1;
+    memcpy(p_comp_data->data, &p_buffer[1], len - 1);
 
-    mesh_provision_process_event(WICED_BT_MESH_ONOFF_STATUS, p_event, &data);
+    mesh_provision_process_event(WICED_BT_MESH_CONFIG_COMPOSITION_DATA_STATUS, p_event, p_comp_data);
 }
 
-void process_level_status(uint8_t *p_buffer, uint16_t len)
+#ifdef LARGE_COMPOSITION_DATA_SUPPORTED
+void process_large_compos_data_status(uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_level_status_data_t data;
+    wiced_bt_mesh_config_large_compos_data_status_data_t data;
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    data.present_level = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);;
-    data.target_level = p_buffer[2] + ((uint16_t)p_buffer[3] << 8);
-    data.remaining_time = p_buffer[4] + ((uint32_t)p_buffer[5] << 8) + ((uint32_t)p_buffer[6] << 16) + ((uint32_t)p_buffer[7] << 24);
+    STREAM_TO_UINT8(data.page, p_buffer);
+    STREAM_TO_UINT16(data.offset, p_buffer);
+    STREAM_TO_UINT16(data.total_size, p_buffer);
+    data.data_len = len - 5;
+    data.p_data = p_buffer;
 
-    mesh_provision_process_event(WICED_BT_MESH_LEVEL_STATUS, p_event, &data);
+    mesh_provision_process_event(WICED_BT_MESH_CONFIG_LARGE_COMPOS_DATA_STATUS, p_event, &data);
 }
+#endif
 
-void process_lightness_status(uint8_t *p_buffer, uint16_t len)
+void process_net_key_status(uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_light_lightness_status_data_t data;
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    data.present = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);;
-    data.target = p_buffer[2] + ((uint16_t)p_buffer[3] << 8);
-    data.remaining_time = p_buffer[4] + ((uint32_t)p_buffer[5] << 8) + ((uint32_t)p_buffer[6] << 16) + ((uint32_t)p_buffer[7] << 24);
+    wiced_bt_mesh_config_netkey_status_data_t data;
 
-    mesh_provision_process_event(WICED_BT_MESH_LIGHT_LIGHTNESS_STATUS, p_event, &data);
+    data.status = p_buffer[0];
+    data.net_key_idx = p_buffer[1] + ((uint16_t)p_buffer[2] << 8);
+
+    mesh_provision_process_event(WICED_BT_MESH_CONFIG_NETKEY_STATUS, p_event, &data);
 }
 
-void process_hsl_status(uint8_t *p_buffer, uint16_t len)
+void process_key_refresh_phase_status(uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_light_hsl_status_data_t data;
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    data.present.lightness = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);;
-    data.present.hue = p_buffer[2] + ((uint16_t)p_buffer[3] << 8);
-    data.present.saturation = p_buffer[4] + ((uint16_t)p_buffer[5] << 8);
-    data.remaining_time = p_buffer[6] + ((uint32_t)p_buffer[7] << 8) + ((uint32_t)p_buffer[8] << 16) + ((uint32_t)p_buffer[9] << 24);
+    wiced_bt_mesh_config_key_refresh_phase_status_data_t data;
 
-    mesh_provision_process_event(WICED_BT_MESH_LIGHT_HSL_STATUS, p_event, &data);
+    data.status = p_buffer[0];
+    data.net_key_idx = p_buffer[1] + ((uint16_t)p_buffer[2] << 8);
+    data.phase = p_buffer[3];
+
+    mesh_provision_process_event(WICED_BT_MESH_CONFIG_KEY_REFRESH_PHASE_STATUS, p_event, &data);
 }
 
-void process_ctl_status(uint8_t *p_buffer, uint16_t len)
+void process_app_key_status(uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_light_ctl_status_data_t data;
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    data.present.lightness = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);;
-    data.present.temperature = p_buffer[2] + ((uint16_t)p_buffer[3] << 8);
-    data.target.lightness = p_buffer[4] + ((uint16_t)p_buffer[5] << 8);
-    data.target.temperature = p_buffer[6] + ((uint16_t)p_buffer[7] << 8);
-    data.remaining_time = p_buffer[8] + ((uint32_t)p_buffer[9] << 8) + ((uint32_t)p_buffer[10] << 16) + ((uint32_t)p_buffer[11] << 24);
+    wiced_bt_mesh_config_appkey_status_data_t data;
 
-    mesh_provision_process_event(WICED_BT_MESH_LIGHT_CTL_STATUS, p_event, &data);
+    data.status = p_buffer[0];
+    data.net_key_idx = p_buffer[1] + ((uint16_t)p_buffer[2] << 8);
+    data.app_key_idx = p_buffer[3] + ((uint16_t)p_buffer[4] << 8);
+
+    mesh_provision_process_event(WICED_BT_MESH_CONFIG_APPKEY_STATUS, p_event, &data);
 }
 
-void process_sensor_descriptor_status(uint8_t *p_buffer, uint16_t len)
+void process_model_app_bind_status(uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_sensor_descriptor_status_data_t data = { 0 };
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    while (len >= 9)
-    {
-        data.descriptor_list[data.num_descriptors].property_id = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);;
-        data.descriptor_list[data.num_descriptors].positive_tolerance = p_buffer[2] + ((uint16_t)p_buffer[3] << 8);
-        data.descriptor_list[data.num_descriptors].negative_tolerance = p_buffer[4] + ((uint16_t)p_buffer[5] << 8);
-        data.descriptor_list[data.num_descriptors].sampling_function = p_buffer[6];
-        data.descriptor_list[data.num_descriptors].measurement_period = p_buffer[7];
-        data.descriptor_list[data.num_descriptors].update_interval = p_buffer[8];
-        data.num_descriptors++;
-        len -= 9;
-    }
-    mesh_provision_process_event(WICED_BT_MESH_SENSOR_DESCRIPTOR_STATUS, p_event, &data);
+    wiced_bt_mesh_config_model_app_bind_status_data_t data;
+
+    data.status         = p_buffer[0];
+    data.element_addr   = p_buffer[1] + ((uint16_t)p_buffer[2] << 8);
+    data.company_id     = p_buffer[3] + ((uint32_t)p_buffer[4] << 8);
+    data.model_id       = p_buffer[5] + ((uint32_t)p_buffer[6] << 8);
+    data.app_key_idx    = p_buffer[7] + ((uint16_t)p_buffer[8] << 8);
+
+    mesh_provision_process_event(WICED_BT_MESH_CONFIG_MODEL_APP_BIND_STATUS, p_event, &data);
 }
 
-void process_sensor_settings_status(uint8_t *p_buffer, uint16_t len)
+void process_model_sub_status(uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_sensor_settings_status_data_t data = { 0 };
-    int i = 0;
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    data.property_id = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
-    while (len >= 4)
-    {
-        len -= 2;
-        p_buffer += 2;
-        data.setting_property_id_list[i++] = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
-    }
-    mesh_provision_process_event(WICED_BT_MESH_SENSOR_SETTINGS_STATUS, p_event, &data);
+    wiced_bt_mesh_config_model_subscription_status_data_t data;
+
+    data.status = p_buffer[0];
+    data.element_addr = p_buffer[1] + ((uint16_t)p_buffer[2] << 8);
+    data.company_id = p_buffer[3] + ((uint32_t)p_buffer[4] << 8);
+    data.model_id = p_buffer[5] + ((uint32_t)p_buffer[6] << 8);
+    data.addr = p_buffer[7] + ((uint16_t)p_buffer[8] << 8);
+
+    mesh_provision_process_event(WICED_BT_MESH_CONFIG_MODEL_SUBSCRIPTION_STATUS, p_event, &data);
 }
 
-void process_sensor_cadence_status(uint8_t *p_buffer, uint16_t len)
+void process_model_pub_status(uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_sensor_cadence_status_data_t data = { 0 };
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    data.property_id = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
-    if (len > 2)
-    {
-        data.cadence_data.fast_cadence_period_divisor = p_buffer[2] + ((uint16_t)p_buffer[3] << 8);
-        data.cadence_data.trigger_type       = p_buffer[4];
-        data.cadence_data.trigger_delta_down = p_buffer[5]  + ((uint32_t)p_buffer[6] << 8)  + ((uint32_t)p_buffer[7] << 16)  + ((uint32_t)p_buffer[8] << 24);
-        data.cadence_data.trigger_delta_up   = p_buffer[9] + ((uint32_t)p_buffer[10] << 8) + ((uint32_t)p_buffer[11] << 16) + ((uint32_t)p_buffer[12] << 24);
-        data.cadence_data.min_interval       = p_buffer[13] + ((uint32_t)p_buffer[14] << 8) + ((uint32_t)p_buffer[15] << 16) + ((uint32_t)p_buffer[16] << 24);
-        data.cadence_data.fast_cadence_low   = p_buffer[17] + ((uint32_t)p_buffer[18] << 8) + ((uint32_t)p_buffer[19] << 16) + ((uint32_t)p_buffer[20] << 24);
-        data.cadence_data.fast_cadence_high  = p_buffer[21] + ((uint32_t)p_buffer[22] << 8) + ((uint32_t)p_buffer[23] << 16) + ((uint32_t)p_buffer[24] << 24);
-    }
-    mesh_provision_process_event(WICED_BT_MESH_SENSOR_CADENCE_STATUS, p_event, &data);
+    wiced_bt_mesh_config_model_publication_status_data_t data;
+
+    data.status = p_buffer[0];
+    data.element_addr = p_buffer[1] + ((uint16_t)p_buffer[2] << 8);
+    data.company_id = p_buffer[3] + ((uint32_t)p_buffer[4] << 8);
+    data.model_id = p_buffer[5] + ((uint32_t)p_buffer[6] << 8);
+    data.publish_addr = p_buffer[7] + ((uint16_t)p_buffer[8] << 8);
+    data.app_key_idx = p_buffer[9] + ((uint16_t)p_buffer[10] << 8);
+    data.credential_flag = p_buffer[11];
+    data.publish_ttl = p_buffer[12];
+    data.publish_period = p_buffer[13] + ((uint32_t)p_buffer[14] << 8) + ((uint32_t)p_buffer[15] << 16) + ((uint32_t)p_buffer[16] << 24);
+    data.publish_retransmit_count = p_buffer[17];
+    data.publish_retransmit_interval = p_buffer[18] + ((uint16_t)p_buffer[19] << 8);
+
+    mesh_provision_process_event(WICED_BT_MESH_CONFIG_MODEL_PUBLICATION_STATUS, p_event, &data);
 }
 
-void process_sensor_data_status(uint8_t *p_buffer, uint16_t len)
+void process_net_transmit_status(uint8_t *p_buffer, uint16_t len)
 {
-    wiced_bt_mesh_sensor_status_data_t data = { 0 };
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    data.property_id = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
-    data.prop_value_len = p_buffer[2];
-    memcpy(data.raw_value, p_buffer + 3, data.prop_value_len);
+    wiced_bt_mesh_config_network_transmit_status_data_t data;
 
-    mesh_provision_process_event(WICED_BT_MESH_SENSOR_STATUS, p_event, &data);
+    data.count = p_buffer[0];
+    data.interval = p_buffer[1] + ((uint16_t)p_buffer[2] << 8);
+
+    mesh_provision_process_event(WICED_BT_MESH_CONFIG_NETWORK_TRANSMIT_STATUS, p_event, &data);
 }
 
-void process_properties_status(uint8_t *p_buffer, uint16_t len)
+void process_default_ttl_status(uint8_t *p_buffer, uint16_t len)
 {
-    uint16_t event = 0;
-    int i = 0;
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    if (len < 1)
-    {
-        wiced_bt_mesh_release_event(p_event);
-        return;
-    }
-    uint16_t num_props = (len - 1) / 2;
-    wiced_bt_mesh_properties_status_data_t *p_data = (wiced_bt_mesh_properties_status_data_t *)wiced_bt_get_buffer(sizeof(wiced_bt_mesh_properties_status_data_t) + len - 2);
-    if (p_data == NULL)
-    {
-        wiced_bt_mesh_release_event(p_event);
-        return;
-    }
-    p_data->type = p_buffer[0];
-    p_data->properties_num = (len - 1) / 2;
-    p_buffer++;
-    for (i = 0; i < p_data->properties_num; i++)
-    {
-        p_data->id[i] = p_buffer[0] + (p_buffer[1] << 8);
-        p_buffer += 2;
-    }
-    if (p_data->type == WICED_BT_MESH_PROPERTY_TYPE_ADMIN)
-        event = WICED_BT_MESH_ADMIN_PROPERTIES_STATUS;
-    else if (p_data->type == WICED_BT_MESH_PROPERTY_TYPE_CLIENT)
-        event = WICED_BT_MESH_CLIENT_PROPERTIES_STATUS;
-    else if (p_data->type == WICED_BT_MESH_PROPERTY_TYPE_MANUFACTURER)
-        event = WICED_BT_MESH_MANUF_PROPERTIES_STATUS;
-    else
-        event = WICED_BT_MESH_USER_PROPERTIES_STATUS;
-    mesh_provision_process_event(WICED_BT_MESH_MANUF_PROPERTIES_STATUS, p_event, p_data);
-    wiced_bt_free_buffer(p_data);
+    wiced_bt_mesh_config_default_ttl_status_data_t data;
+
+    data.ttl = p_buffer[0];
+    data.received_ttl = p_buffer[1];
+
+    mesh_provision_process_event(WICED_BT_MESH_CONFIG_DEFAULT_TTL_STATUS, p_event, &data);
 }
 
-void process_property_status(uint8_t *p_buffer, uint16_t len)
+void process_relay_status(uint8_t *p_buffer, uint16_t len)
 {
-    uint16_t event = 0;
     wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
     if (p_event == NULL)
         return;
 
-    if (len < 4)
-    {
-        wiced_bt_mesh_release_event(p_event);
-        return;
-    }
+    wiced_bt_mesh_config_relay_status_data_t data;
 
-    wiced_bt_mesh_property_status_data_t* p_data = (wiced_bt_mesh_property_status_data_t*)wiced_bt_get_buffer(sizeof(wiced_bt_mesh_property_status_data_t) + len - 5);
-    if (p_data == NULL)
-    {
-        wiced_bt_mesh_release_event(p_event);
+    data.state = p_buffer[0];
+    data.retransmit_count = p_buffer[1];
+    data.retransmit_interval = p_buffer[2] + ((uint16_t)p_buffer[3] << 8);
+
+    mesh_provision_process_event(WICED_BT_MESH_CONFIG_RELAY_STATUS, p_event, &data);
+}
+
+void process_friend_status(uint8_t *p_buffer, uint16_t len)
+{
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
         return;
-    }
-    p_data->type = p_buffer[0];
-    p_data->access = p_buffer[1];
-    p_data->id = p_buffer[2] + (p_buffer[3] << 8);
-    memcpy(p_data->value, &p_buffer[4], len - 4);
-    if (p_data->type == WICED_BT_MESH_PROPERTY_TYPE_ADMIN)
-        event = WICED_BT_MESH_ADMIN_PROPERTY_STATUS;
-    else if (p_data->type == WICED_BT_MESH_PROPERTY_TYPE_MANUFACTURER)
-        event = WICED_BT_MESH_MANUF_PROPERTY_STATUS;
-    else
-        event = WICED_BT_MESH_USER_PROPERTY_STATUS;
-    mesh_provision_process_event(event, p_event, p_data);
-    wiced_bt_free_buffer(p_data);
-}
-
-void process_vendor_data(uint8_t *p_buffer, uint16_t len)
-{
-    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
-    if (p_event == NULL)
-        return;
-
-    p_event->data_len = len;
-    mesh_provision_process_event(WICED_BT_MESH_VENDOR_DATA, p_event, p_buffer);
-}
-
-wiced_bool_t wiced_bt_mesh_provision_connect(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_provision_connect_data_t *p_data, uint8_t use_gatt)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-    int i;
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    for (i = 0; i < sizeof(p_data->uuid); i++)
-        *p++ = p_data->uuid[i];
-    *p++ = p_data->identify_duration;
-    *p++ = p_data->procedure;
-    *p++ = use_gatt;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_PROVISION_CONNECT, buffer, (uint16_t)(p - buffer));
-}
-
-wiced_bool_t wiced_bt_mesh_provision_start(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_provision_start_data_t *p_data)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    *p++ = (uint8_t)p_data->addr;
-    *p++ = (uint8_t)(p_data->addr >> 8);
-    *p++ = (uint8_t)p_data->net_key_idx;
-    *p++ = (uint8_t)(p_data->net_key_idx >> 8);
-    *p++ = p_data->algorithm;
-    *p++ = p_data->public_key_type;
-    *p++ = p_data->auth_method;
-    *p++ = p_data->auth_action;
-    *p++ = p_data->auth_size;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_PROVISION_START, buffer, (uint16_t)(p - buffer));
-}
-
-wiced_bool_t wiced_bt_mesh_provision_client_set_oob(wiced_bt_mesh_event_t *p_event, uint8_t* p_oob, uint32_t len)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    memcpy(p, p_oob, len);
-    p += len;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_PROVISION_OOB_VALUE, buffer, (uint16_t)(p - buffer));
-}
-
-wiced_bool_t wiced_bt_mesh_provision_disconnect(wiced_bt_mesh_event_t *p_event)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_PROVISION_DISCONNECT, buffer, (uint16_t)(p - buffer));
-}
-
-#if defined(CERTIFICATE_BASED_PROVISIONING_SUPPORTED)
-/**
- * @brief send invite  to the peer device
- *
- * @param p_event   mesh event
- * @return wiced_bool_t
- */
-wiced_bool_t wiced_bt_mesh_provision_send_invite(wiced_bt_mesh_event_t* p_event)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_PROVISION_SEND_INVITE, buffer, (uint16_t)(p - buffer));
-}
-
-/**
- * @brief retrieve provisioning records from the peer device
- *
- * @param p_event   mesh event
- * @param p_data    pointer to the paramenter describing record fragment to retrieve
- * @return wiced_bool_t
- */
-wiced_bool_t wiced_bt_mesh_provision_retrieve_record(wiced_bt_mesh_event_t* p_event, wiced_bt_mesh_provision_device_record_fragment_data_t*  p_data)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    UINT16_TO_BE_STREAM(p, p_data->record_id);
-    UINT16_TO_BE_STREAM(p, p_data->fragment_offset);
-    UINT16_TO_BE_STREAM(p, p_data->total_length);
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_PROVISION_RETRIEVE_RECORD, buffer, (uint16_t)(p - buffer));
-}
-#endif
-
-wiced_bool_t wiced_bt_mesh_client_proxy_connect(wiced_bt_mesh_proxy_connect_data_t *p_connect)
-{
-    uint8_t buffer[128];
-    uint8_t *p = buffer;
-    int i;
-    if (p_connect->connect_type == CONNECT_TYPE_NODE_ID)
-    {
-        *p++ = p_connect->node_id & 0xff;
-        *p++ = (p_connect->node_id >> 8) & 0xff;
-    }
-    else if (p_connect->connect_type == CONNECT_TYPE_BDADDR)
-    {
-        for (i = 0; i < 6; i++)
-            *p++ = p_connect->bd_addr[5 - i];
-        *p++ = p_connect->bd_addr_type;
-    }
-    *p++ = p_connect->scan_duration;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_PROXY_CONNECT, buffer, (uint16_t)(p - buffer));
-}
-
-wiced_bool_t wiced_bt_mesh_client_proxy_disconnect(void)
-{
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_PROXY_DISCONNECT, NULL, 0);
-}
-
-wiced_result_t wiced_bt_mesh_core_send(wiced_bt_mesh_event_t *p_event, const uint8_t* params, uint16_t params_len, wiced_bt_mesh_core_send_complete_callback_t complete_callback)
-{
-    uint8_t buffer[512];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    if (p == NULL)
-    {
-        wiced_bt_mesh_release_event(p_event);
-        return WICED_FALSE;
-    }
-#define MESH_APP_PAYLOAD_OP_LONG              0x80
-#define MESH_APP_PAYLOAD_OP_MANUF_SPECIFIC    0x40
-    if (p_event->company_id != MESH_COMPANY_ID_BT_SIG)
-    {
-        *p++ = (p_event->opcode | MESH_APP_PAYLOAD_OP_LONG | MESH_APP_PAYLOAD_OP_MANUF_SPECIFIC) & 0xff;
-        *p++ = (p_event->company_id >> 8) & 0xff;
-        *p++ = p_event->company_id & 0xff;
-    }
-    else
-    {
-        *p++ = (p_event->opcode >> 8) & 0xff;
-        *p++ = p_event->opcode & 0xff;
-    }
-    memcpy(p, params, params_len);
-    p += params_len;
-
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_RAW_MODEL_DATA, buffer, (uint16_t)(p - buffer));
-    wiced_bt_mesh_release_event(p_event);
-    return WICED_BT_SUCCESS;
-}
-
-void wiced_bt_mesh_provision_set_dev_key(wiced_bt_mesh_set_dev_key_data_t *p_data)
-{
-    uint8_t buffer[128];
-    uint8_t *p = buffer;
-    *p++ = p_data->dst & 0xff;
-    *p++ = (p_data->dst >> 8) & 0xff;
-    memcpy(p, p_data->dev_key, 16);
-    p += 16;
-    *p++ = p_data->net_key_idx & 0xff;
-    *p++ = (p_data->net_key_idx >> 8) & 0xff;
-
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_SET_DEVICE_KEY, buffer, (uint16_t)(p - buffer));
-}
-
-void wiced_bt_mesh_adv_tx_power_set(uint8_t adv_tx_power)
-{
-    uint8_t buffer[260] = {0};
-    uint8_t *p = buffer;
-    p[0] = adv_tx_power;
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_SET_ADV_TX_POWER, buffer, 1);
-}
-
-void wiced_bt_mesh_add_vendor_model(wiced_bt_mesh_add_vendor_model_data_t *p_data)
-{
-    uint8_t buffer[260] = {0};
-    uint8_t *p = buffer;
-    *p++ = p_data->company_id & 0xff;
-    *p++ = (p_data->company_id >> 8) & 0xff;
-    *p++ = p_data->model_id & 0xff;
-    *p++ = (p_data->model_id >> 8) & 0xff;
-    if (p_data->num_opcodes > WICED_BT_MESH_MAX_VENDOR_MODEL_OPCODES)
-        p_data->num_opcodes = WICED_BT_MESH_MAX_VENDOR_MODEL_OPCODES;
-    *p++ = p_data->num_opcodes;
-    memcpy(p, p_data->opcode, p_data->num_opcodes * 3); // vendor model opcodes are 3-bytes long
-    p += p_data->num_opcodes * 3;
-
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_ADD, buffer, (uint16_t)(p - buffer));
-}
-
-wiced_bool_t wiced_bt_mesh_config_composition_data_get(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_composition_data_get_data_t *p_get)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    if (p == NULL)
-    {
-        wiced_bt_mesh_release_event(p_event);
-        return WICED_FALSE;
-    }
-
-    *p++ = p_get->page_number;
-
-    Log("Composition Data Get addr:0x%04x page_number:%x", p_event->dst, p_get->page_number);
-
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_COMPOSITION_DATA_GET, buffer, (uint16_t)(p - buffer));
-    wiced_bt_mesh_release_event(p_event);
-    return WICED_TRUE;
-}
-
-#ifdef LARGE_COMPOSITION_DATA_SUPPORTED
-wiced_bool_t wiced_bt_mesh_config_large_compos_data_get(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_large_compos_data_get_data_t *p_get)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    if (p == NULL)
-    {
-        wiced_bt_mesh_release_event(p_event);
-        return WICED_FALSE;
-    }
-
-    UINT8_TO_STREAM(p, p_get->page);
-    UINT16_TO_STREAM(p, p_get->offset);
-
-    Log("Large Composition Data Get addr:0x%04x page_number:%d offset:%d", p_event->dst, p_get->page, p_get->offset);
-
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_LARGE_COMPOS_DATA_GET, buffer, (uint16_t)(p - buffer));
-    wiced_bt_mesh_release_event(p_event);
-    return WICED_TRUE;
-}
-#endif
-
-wiced_bool_t wiced_bt_mesh_config_netkey_change(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_netkey_change_data_t *p_data)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    *p++ = p_data->net_key_idx & 0xff;
-    *p++ = (p_data->net_key_idx >> 8) & 0xff;
-
-    if (p_data->operation == OPERATION_DELETE)
-    {
-        wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_NET_KEY_DELETE, buffer, (uint16_t)(p - buffer));
-    }
-    else
-    {
-        memcpy(p, p_data->net_key, 16);
-        p += 16;
-        wiced_hci_send(p_data->operation == OPERATION_ADD ? HCI_CONTROL_MESH_COMMAND_CONFIG_NET_KEY_ADD : HCI_CONTROL_MESH_COMMAND_CONFIG_NET_KEY_UPDATE, buffer, (uint16_t)(p - buffer));
-    }
-    return WICED_TRUE;
-}
-
-wiced_bool_t wiced_bt_mesh_config_key_refresh_phase_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_key_refresh_phase_set_data_t *p_set)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    if (p == NULL)
-    {
-        wiced_bt_mesh_release_event(p_event);
-        return WICED_FALSE;
-    }
-    *p++ = p_set->net_key_idx & 0xff;
-    *p++ = (p_set->net_key_idx >> 8) & 0xff;
-    *p++ = p_set->transition;
-
-    Log("Key refresh addr:%04x net_key_idx:%x phase:%x", p_event->dst, p_set->net_key_idx, p_set->transition);
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_KEY_REFRESH_PHASE_SET, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
-}
-
-wiced_bool_t wiced_bt_mesh_config_appkey_change(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_appkey_change_data_t *p_data)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    if (p == NULL)
-    {
-        wiced_bt_mesh_release_event(p_event);
-        return WICED_FALSE;
-    }
-    *p++ = p_data->net_key_idx & 0xff;
-    *p++ = (p_data->net_key_idx >> 8) & 0xff;
-    *p++ = p_data->app_key_idx & 0xff;
-    *p++ = (p_data->app_key_idx >> 8) & 0xff;
-
-    if (p_data->operation == OPERATION_DELETE)
-    {
-        Log("AppKey Delete addr:%04x net_key_idx:%x app_key_idx:%x", p_event->dst, p_data->net_key_idx, p_data->app_key_idx);
-        wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_APP_KEY_DELETE, buffer, (uint16_t)(p - buffer));
-    }
-    else
-    {
-        memcpy(p, p_data->app_key, 16);
-        p += 16;
-        Log("AppKey %s addr:%04x net_key_idx:%x app_key_idx:%x", p_data->operation == OPERATION_ADD ? "Add" : "Update", p_event->dst, p_data->net_key_idx, p_data->app_key_idx);
-        wiced_hci_send(p_data->operation == OPERATION_ADD ? HCI_CONTROL_MESH_COMMAND_CONFIG_APP_KEY_ADD : HCI_CONTROL_MESH_COMMAND_CONFIG_APP_KEY_UPDATE, buffer, (uint16_t)(p - buffer));
-    }
-    return WICED_TRUE;
-}
-
-wiced_bool_t wiced_bt_mesh_config_model_app_bind(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_model_app_bind_data_t *p_data)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    *p++ = p_data->element_addr & 0xff;
-    *p++ = (p_data->element_addr >> 8) & 0xff;
-    *p++ = p_data->company_id & 0xff;
-    *p++ = (p_data->company_id >> 8) & 0xff;
-    *p++ = p_data->model_id & 0xff;
-    *p++ = (p_data->model_id >> 8) & 0xff;
-    *p++ = p_data->app_key_idx & 0xff;
-    *p++ = (p_data->app_key_idx >> 8) & 0xff;
-
-    wiced_hci_send(p_data->operation == OPERATION_BIND ? HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_APP_BIND : HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_APP_UNBIND, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
-}
-
-wiced_bool_t wiced_bt_mesh_provision_local_device_set(wiced_bt_mesh_local_device_set_data_t *p_data)
-{
-    uint8_t buffer[128];
-    uint8_t *p = buffer;
-    *p++ = p_data->addr & 0xff;
-    *p++ = (p_data->addr >> 8) & 0xff;
-    memcpy(p, p_data->dev_key, 16);
-    p += 16;
-    memcpy(p, p_data->network_key, 16);
-    p += 16;
-    *p++ = p_data->net_key_idx & 0xff;
-    *p++ = (p_data->net_key_idx >> 8) & 0xff;
-    *p++ = p_data->iv_idx & 0xff;
-    *p++ = (p_data->iv_idx >> 8) & 0xff;
-    *p++ = (p_data->iv_idx >> 16) & 0xff;
-    *p++ = (p_data->iv_idx >> 24) & 0xff;
-    *p++ = p_data->key_refresh;
-    *p++ = p_data->iv_update;
-    *p++ = p_data->model_level_access;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_SET_LOCAL_DEVICE, buffer, (uint16_t)(p - buffer));
-}
-
-wiced_bool_t wiced_bt_mesh_config_model_publication_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_model_publication_set_data_t *p_set)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    *p++ = p_set->element_addr & 0xff;
-    *p++ = (p_set->element_addr >> 8) & 0xff;
-    *p++ = p_set->company_id & 0xff;
-    *p++ = (p_set->company_id >> 8) & 0xff;
-    *p++ = p_set->model_id & 0xff;
-    *p++ = (p_set->model_id >> 8) & 0xff;
-    memcpy(p, p_set->publish_addr, 16);
-    p += 16;
-    *p++ = p_set->app_key_idx & 0xff;
-    *p++ = (p_set->app_key_idx >> 8) & 0xff;
-    *p++ = p_set->credential_flag;
-    *p++ = p_set->publish_ttl;
-    *p++ = p_set->publish_period & 0xff;
-    *p++ = (p_set->publish_period >> 8) & 0xff;
-    *p++ = (p_set->publish_period >> 16) & 0xff;
-    *p++ = (p_set->publish_period >> 24) & 0xff;
-    *p++ = p_set->publish_retransmit_count;
-    *p++ = p_set->publish_retransmit_interval & 0xff;
-    *p++ = (p_set->publish_retransmit_interval >> 8) & 0xff;
-
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_PUBLICATION_SET, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
-}
-
-wiced_bool_t wiced_bt_mesh_config_model_subscription_change(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_model_subscription_change_data_t *p_data)
-{
-    uint16_t hci_opcode = 0;
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    if (p == NULL)
-    {
-        wiced_bt_mesh_release_event(p_event);
-        return WICED_FALSE;
-    }
-    *p++ = p_data->element_addr & 0xff;
-    *p++ = (p_data->element_addr >> 8) & 0xff;
-    *p++ = p_data->company_id & 0xff;
-    *p++ = (p_data->company_id >> 8) & 0xff;
-    *p++ = p_data->model_id & 0xff;
-    *p++ = (p_data->model_id >> 8) & 0xff;
-    memcpy(p, p_data->addr, 16);
-    switch (p_data->operation)
-    {
-    case OPERATION_ADD:
-        Log("Model Sub Add addr:%04x elem:%x model:%x addr:%04x", p_event->dst, p_data->element_addr, p_data->model_id, p_data->addr[0] + (p_data->addr[1] << 8));
-        hci_opcode = HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_SUBSCRIPTION_ADD;
-        p += 16;
-        break;
-    case OPERATION_OVERWRITE:
-        Log("Model Sub Overwrite addr:%04x elem:%x model:%x addr:%04x", p_event->dst, p_data->element_addr, p_data->model_id, p_data->addr[0] + (p_data->addr[1] << 8));
-        hci_opcode = HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_SUBSCRIPTION_OVERWRITE;
-        p += 16;
-        break;
-    case OPERATION_DELETE:
-        Log("Model Sub Delete addr:%04x elem:%x model:%x addr:%04x", p_event->dst, p_data->element_addr, p_data->model_id, p_data->addr[0] + (p_data->addr[1] << 8));
-        hci_opcode = HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_SUBSCRIPTION_DELETE;
-        p += 16;
-        break;
-    case OPERATION_DELETE_ALL:
-        Log("Model Sub DeleteAll addr:%04x elem:%x model:%x", p_event->dst, p_data->element_addr, p_data->model_id);
-        hci_opcode = HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_SUBSCRIPTION_DELETE_ALL;
-        break;
-    }
-    wiced_hci_send(hci_opcode, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
-}
-
-wiced_bool_t wiced_bt_mesh_config_network_transmit_params_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_network_transmit_set_data_t *p_data)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    *p++ = p_data->count;
-    *p++ = p_data->interval & 0xff;
-    *p++ = (p_data->interval >> 8) & 0xff;
-
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_NETWORK_TRANSMIT_SET, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
-}
-
-wiced_bool_t wiced_bt_mesh_config_default_ttl_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_default_ttl_set_data_t *p_data)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    *p++ = p_data->ttl;
-
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_DEFAULT_TTL_SET, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
-}
-
-wiced_bool_t wiced_bt_mesh_config_relay_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_relay_set_data_t *p_data)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    *p++ = p_data->state;
-    *p++ = p_data->retransmit_count;
-    *p++ = p_data->retransmit_interval & 0xff;
-    *p++ = (p_data->retransmit_interval >> 8) & 0xff;
-
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_RELAY_SET, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
-}
-
-wiced_bool_t wiced_bt_mesh_config_friend_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_friend_set_data_t *p_data)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    *p++ = p_data->state;
-
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_FRIEND_SET, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
-}
 
-wiced_bool_t wiced_bt_mesh_config_gatt_proxy_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_gatt_proxy_set_data_t *p_data)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    *p++ = p_data->state;
-
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_GATT_PROXY_SET, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
-}
-
-wiced_bool_t wiced_bt_mesh_config_beacon_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_beacon_set_data_t *p_data)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    *p++ = p_data->state;
-
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_BEACON_SET, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
-}
-
-wiced_bool_t wiced_bt_mesh_config_node_reset(wiced_bt_mesh_event_t *p_event)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_NODE_RESET, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
-}
-
-wiced_bool_t wiced_bt_mesh_health_attention_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_health_attention_set_data_t *p_set)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    *p++ = p_set->timer;
-
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_HEALTH_ATTENTION_SET, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
-}
-
-wiced_bool_t wiced_bt_mesh_config_node_identity_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_node_identity_set_data_t *p_set)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    *p++ = p_set->net_key_idx & 0xff;
-    *p++ = (p_set->net_key_idx >> 8) & 0xff;
-    *p++ = p_set->identity;
-
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_NODE_IDENTITY_SET, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
-}
-
-#ifdef PRIVATE_PROXY_SUPPORTED
-wiced_bool_t wiced_bt_mesh_config_private_gatt_proxy_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_private_gatt_proxy_set_data_t *p_data)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    *p++ = p_data->state;
-
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_PRIVATE_GATT_PROXY_SET, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
-}
-
-wiced_bool_t wiced_bt_mesh_config_private_beacon_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_private_beacon_set_data_t *p_data)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    if (p == NULL)
-        return WICED_FALSE;
-
-    *p++ = p_data->state;
-    *p++ = p_data->random_update_interval;
-
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_PRIVATE_BEACON_SET, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
-}
-
-wiced_bool_t wiced_bt_mesh_config_private_node_identity_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_private_node_identity_set_data_t *p_set)
-{
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_FALSE;
+    wiced_bt_mesh_config_friend_status_data_t data;
 
-    *p++ = p_set->net_key_idx & 0xff;
-    *p++ = (p_set->net_key_idx >> 8) & 0xff;
-    *p++ = p_set->identity;
+    data.state = p_buffer[0];
 
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_PRIVATE_NODE_IDENTITY_SET, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
+    mesh_provision_process_event(WICED_BT_MESH_CONFIG_FRIEND_STATUS, p_event, &data);
 }
 
-wiced_bool_t wiced_bt_mesh_config_on_demand_private_proxy_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_on_demand_private_proxy_set_data_t *p_data)
+void process_gatt_proxy_status(uint8_t *p_buffer, uint16_t len)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    if (p == NULL)
-        return WICED_FALSE;
+    wiced_bt_mesh_config_gatt_proxy_status_data_t data;
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
 
-    *p++ = p_data->state;
+    data.state = p_buffer[0];
 
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_ON_DEMAND_PRIVATE_PROXY_SET, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
+    mesh_provision_process_event(WICED_BT_MESH_CONFIG_GATT_PROXY_STATUS, p_event, &data);
 }
-#endif
 
-wiced_bool_t wiced_bt_mesh_lpn_poll_timeout_get(wiced_bt_mesh_event_t* p_event, wiced_bt_mesh_lpn_poll_timeout_get_data_t* p_get)
+void process_beacon_status(uint8_t *p_buffer, uint16_t len)
 {
-    uint8_t buffer[128];
-    uint8_t* p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    if (p == NULL)
-        return WICED_FALSE;
+    wiced_bt_mesh_config_beacon_status_data_t data;
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
 
-    *p++ = p_get->lpn_addr & 0xff;
-    *p++ = (p_get->lpn_addr >> 8) & 0xff;
+    data.state = p_buffer[0];
 
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_LPN_POLL_TIMEOUT_GET, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
+    mesh_provision_process_event(WICED_BT_MESH_CONFIG_BEACON_STATUS, p_event, &data);
 }
 
-
-wiced_bool_t wiced_bt_mesh_proxy_filter_change_addr(wiced_bt_mesh_event_t *p_event, wiced_bool_t is_add, wiced_bt_mesh_proxy_filter_change_addr_data_t *p_addr)
+void process_node_identity_status(uint8_t *p_buffer, uint16_t len)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-    int i;
+    wiced_bt_mesh_config_node_identity_status_data_t data;
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
 
-    if ((p == NULL) || (p_addr->addr_num > sizeof(buffer) / 2))
-        return WICED_FALSE;
+    data.status = p_buffer[0];
+    data.net_key_idx = p_buffer[1] + (p_buffer[2] << 8);
+    data.identity = p_buffer[3];
 
-    for (i = 0; i < p_addr->addr_num; i++)
-    {
-        *p++ = p_addr->addr[i] & 0xff;
-        *p++ = (p_addr->addr[i] >> 8) & 0xff;
-    }
-    wiced_hci_send(is_add ? HCI_CONTROL_MESH_COMMAND_PROXY_FILTER_ADDRESSES_ADD : HCI_CONTROL_MESH_COMMAND_PROXY_FILTER_ADDRESSES_DELETE, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
+    mesh_provision_process_event(WICED_BT_MESH_CONFIG_NODE_IDENTITY_STATUS, p_event, &data);
 }
 
-wiced_bool_t wiced_bt_mesh_provision_scan_capabilities_get(wiced_bt_mesh_event_t *p_event)
+#ifdef PRIVATE_PROXY_SUPPORTED
+void process_private_gatt_proxy_status(uint8_t *p_buffer, uint16_t len)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
+    wiced_bt_mesh_config_private_gatt_proxy_status_data_t data;
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
 
-    if (p == NULL)
-        return WICED_FALSE;
+    data.state = p_buffer[0];
 
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_PROVISION_SCAN_CAPABILITIES_GET, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
+    mesh_provision_process_event(WICED_BT_MESH_CONFIG_PRIVATE_GATT_PROXY_STATUS, p_event, &data);
 }
 
-wiced_bool_t wiced_bt_mesh_provision_scan_get(wiced_bt_mesh_event_t *p_event)
+void process_private_beacon_status(uint8_t *p_buffer, uint16_t len)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
+    wiced_bt_mesh_config_private_beacon_status_data_t data;
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
 
-    if (p == NULL)
-        return WICED_FALSE;
+    data.state = p_buffer[0];
+    data.random_update_interval = p_buffer[1];
 
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_PROVISION_SCAN_GET, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
+    mesh_provision_process_event(WICED_BT_MESH_CONFIG_PRIVATE_BEACON_STATUS, p_event, &data);
 }
 
-/*
-* Send Remote Provisioning Scan Start to Remote Provisioning Server
-*/
-wiced_bool_t wiced_bt_mesh_provision_scan_start(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_provision_scan_start_data_t *p_data)
+void process_private_node_identity_status(uint8_t *p_buffer, uint16_t len)
 {
-    uint8_t  buffer[35];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
+    wiced_bt_mesh_config_private_node_identity_status_data_t data;
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
 
-    if (p == NULL)
-        return WICED_FALSE;
+    data.status = p_buffer[0];
+    data.net_key_idx = p_buffer[1] + (p_buffer[2] << 8);
+    data.identity = p_buffer[3];
 
-    *p++ = p_data->scanned_items_limit;
-    *p++ = p_data->timeout;
-    if (p_data->scan_single_uuid)
-    {
-        memcpy(p, p_data->uuid, MESH_DEVICE_UUID_LEN);
-        p += MESH_DEVICE_UUID_LEN;
-    }
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_PROVISION_SCAN_START, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
+    mesh_provision_process_event(WICED_BT_MESH_CONFIG_PRIVATE_NODE_IDENTITY_STATUS, p_event, &data);
 }
 
-/*
-* Send Remote Provisioning Scan Stop to Remote Provisioning Server
-*/
-wiced_bool_t wiced_bt_mesh_provision_scan_stop(wiced_bt_mesh_event_t *p_event)
+void process_on_demand_private_proxy_status(uint8_t *p_buffer, uint16_t len)
 {
-    uint8_t  buffer[30];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
+    wiced_bt_mesh_config_on_demand_private_proxy_status_data_t data;
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
 
-    if (p == NULL)
-        return WICED_FALSE;
+    data.state = p_buffer[0];
 
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_PROVISION_SCAN_STOP, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
+    mesh_provision_process_event(WICED_BT_MESH_CONFIG_ON_DEMAND_PRIVATE_PROXY_STATUS, p_event, &data);
 }
+#endif
 
-/*
- * Send Remote Provisioning Scan Extended Scan Start to Remote Provisioning Server
- */
-wiced_bool_t wiced_bt_mesh_provision_scan_extended_start(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_provision_scan_extended_start_t *p_data)
+void process_proxy_filter_status(uint8_t *p_buffer, uint16_t len)
 {
-    int i;
-    uint8_t  buffer[50];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    wiced_bt_mesh_proxy_filter_status_data_t data;
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
 
-    wiced_bt_mesh_release_event(p_event);
+    data.type = p_buffer[0];
+    data.list_size = p_buffer[1] + (p_buffer[2] << 8);
 
-    if (p == NULL)
-        return WICED_FALSE;
+    mesh_provision_process_event(WICED_BT_MESH_PROXY_FILTER_STATUS, p_event, &data);
+}
 
-    UINT8_TO_STREAM(p, p_data->num_ad_filters);
-    for (i = 0; i < p_data->num_ad_filters && i < WICED_BT_MESH_AD_FILTER_TYPES_MAX; i++)
-    {
-        UINT8_TO_STREAM(p, p_data->ad_filter_types[i]);
-    }
-    if (p_data->uuid_present)
+void process_def_trans_time_status(uint8_t *p_buffer, uint16_t len)
+{
+    wiced_bt_mesh_default_transition_time_data_t data;
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event != NULL)
     {
-        memcpy(p, p_data->uuid, sizeof(p_data->uuid));
-        p += sizeof(p_data->uuid);
-        UINT8_TO_STREAM(p, p_data->timeout);
+        p_event->app_key_idx = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
+        p_event->element_idx = p_buffer[2];
+        data.time = p_buffer[3] + ((uint32_t)p_buffer[4] << 8) + ((uint32_t)p_buffer[5] << 16) + ((uint32_t)p_buffer[6] << 24);
+
+        mesh_provision_process_event(WICED_BT_MESH_DEFAULT_TRANSITION_TIME_STATUS, p_event, &data);
     }
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_PROVISION_SCAN_EXTENDED_START, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
 }
 
-#ifdef OPCODES_AGGREGATOR_SUPPORTED
-static wiced_bt_mesh_agg_item_add_callback_t p_mesh_agg_item_add_callback = NULL;
-
-wiced_bool_t wiced_bt_mesh_opcodes_aggregator_start(uint16_t dst_addr, uint8_t dst_elem_idx, uint16_t app_key_idx, wiced_bool_t is_command, uint16_t element_addr, wiced_bt_mesh_agg_item_add_callback_t p_callback)
+void process_on_off_status(uint8_t *p_buffer, uint16_t len)
 {
-    uint8_t buffer[20], *p = buffer;
-
-    UINT16_TO_STREAM(p, dst_addr);
-    UINT8_TO_STREAM(p, dst_elem_idx);
-    UINT16_TO_STREAM(p, app_key_idx);
-    UINT8_TO_STREAM(p, is_command);
-    UINT16_TO_STREAM(p, element_addr);
+    wiced_bt_mesh_onoff_status_data_t data;
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
 
-    p_mesh_agg_item_add_callback = p_callback;
+    data.present_onoff = p_buffer[0];
+    data.target_onoff = p_buffer[1];
+    data.remaining_time = p_buffer[2] + ((uint32_t)p_buffer[3] << 8) + ((uint32_t)p_buffer[4] << 16) + ((uint32_t)p_buffer[5] << 24);
 
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_OPCODES_AGGREGATOR_START, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
+    mesh_provision_process_event(WICED_BT_MESH_ONOFF_STATUS, p_event, &data);
 }
 
-wiced_bool_t wiced_bt_mesh_opcodes_aggregator_finish_and_send(uint8_t status)
+void process_level_status(uint8_t *p_buffer, uint16_t len)
 {
-    uint8_t buffer[20], *p = buffer;
-
-    UINT8_TO_STREAM(p, status);
+    wiced_bt_mesh_level_status_data_t data;
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
 
-    p_mesh_agg_item_add_callback = NULL;
+    data.present_level = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);;
+    data.target_level = p_buffer[2] + ((uint16_t)p_buffer[3] << 8);
+    data.remaining_time = p_buffer[4] + ((uint32_t)p_buffer[5] << 8) + ((uint32_t)p_buffer[6] << 16) + ((uint32_t)p_buffer[7] << 24);
 
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_OPCODES_AGGREGATOR_FINISH, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
+    mesh_provision_process_event(WICED_BT_MESH_LEVEL_STATUS, p_event, &data);
 }
 
-void process_opcodes_aggregator_add_status(uint8_t *p_buffer, uint16_t len)
+void process_lightness_status(uint8_t *p_buffer, uint16_t len)
 {
-    if (!p_buffer || len != 1)
+    wiced_bt_mesh_light_lightness_status_data_t data;
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
         return;
 
-    if (p_mesh_agg_item_add_callback)
-        p_mesh_agg_item_add_callback(*p_buffer);
+    data.present = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);;
+    data.target = p_buffer[2] + ((uint16_t)p_buffer[3] << 8);
+    data.remaining_time = p_buffer[4] + ((uint32_t)p_buffer[5] << 8) + ((uint32_t)p_buffer[6] << 16) + ((uint32_t)p_buffer[7] << 24);
+
+    mesh_provision_process_event(WICED_BT_MESH_LIGHT_LIGHTNESS_STATUS, p_event, &data);
 }
-#endif
 
-#ifdef MESH_DFU_ENABLED
-/*
-* Application can call this function to check node metadata.
-*/
-wiced_bool_t wiced_bt_mesh_dfu_metadata_check(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_dfu_metadata_check_data_t *p_data, wiced_bt_mesh_fw_provider_callback_t *p_callback)
+void process_hsl_status(uint8_t *p_buffer, uint16_t len)
 {
-    uint8_t  buffer[300];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_FALSE;
+    wiced_bt_mesh_light_hsl_status_data_t data;
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
 
-    UINT8_TO_STREAM(p, p_data->index);
-    memcpy(p, p_data->metadata.data, p_data->metadata.len);
-    p += p_data->metadata.len;
+    data.present.lightness = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);;
+    data.present.hue = p_buffer[2] + ((uint16_t)p_buffer[3] << 8);
+    data.present.saturation = p_buffer[4] + ((uint16_t)p_buffer[5] << 8);
+    data.remaining_time = p_buffer[6] + ((uint32_t)p_buffer[7] << 8) + ((uint32_t)p_buffer[8] << 16) + ((uint32_t)p_buffer[9] << 24);
 
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_FW_UPDATE_METADATA_CHECK, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
+    mesh_provision_process_event(WICED_BT_MESH_LIGHT_HSL_STATUS, p_event, &data);
 }
 
-/*
- * The application can call this function to start firmware distribution procedure.
- */
-wiced_bool_t wiced_bt_mesh_fw_provider_start(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_fw_distribution_start_data_t *p_data, wiced_bt_mesh_fw_provider_callback_t *p_callback)
+void process_ctl_status(uint8_t *p_buffer, uint16_t len)
 {
-    uint8_t buffer[1024];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    wiced_bt_mesh_light_ctl_status_data_t data;
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
 
-    wiced_bt_mesh_release_event(p_event);
+    data.present.lightness = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);;
+    data.present.temperature = p_buffer[2] + ((uint16_t)p_buffer[3] << 8);
+    data.target.lightness = p_buffer[4] + ((uint16_t)p_buffer[5] << 8);
+    data.target.temperature = p_buffer[6] + ((uint16_t)p_buffer[7] << 8);
+    data.remaining_time = p_buffer[8] + ((uint32_t)p_buffer[9] << 8) + ((uint32_t)p_buffer[10] << 16) + ((uint32_t)p_buffer[11] << 24);
 
-    if (p == NULL)
-        return WICED_FALSE;
+    mesh_provision_process_event(WICED_BT_MESH_LIGHT_CTL_STATUS, p_event, &data);
+}
 
-    UINT8_TO_STREAM(p, p_data->firmware_id.fw_id_len);
-    memcpy(p, p_data->firmware_id.fw_id, p_data->firmware_id.fw_id_len);
-    p += p_data->firmware_id.fw_id_len;
-    UINT8_TO_STREAM(p, p_data->metadata.len);
-    memcpy(p, p_data->metadata.data, p_data->metadata.len);
-    p += p_data->metadata.len;
-    UINT32_TO_STREAM(p, p_data->firmware_size);
-    UINT16_TO_STREAM(p, p_data->proxy_addr);
-    UINT16_TO_STREAM(p, p_data->group_addr);
-    UINT16_TO_STREAM(p, p_data->group_size);
-    for (int i = 0; i < p_data->group_size; i++)
+void process_sensor_descriptor_status(uint8_t *p_buffer, uint16_t len)
+{
+    wiced_bt_mesh_sensor_descriptor_status_data_t data = { 0 };
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
+
+    while (len >= 9)
     {
-        UINT16_TO_STREAM(p, p_data->update_nodes[i].addr);
-        UINT8_TO_STREAM(p, p_data->update_nodes[i].low_power);
+        data.descriptor_list[data.num_descriptors].property_id = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);;
+        data.descriptor_list[data.num_descriptors].positive_tolerance = p_buffer[2] + ((uint16_t)p_buffer[3] << 8);
+        data.descriptor_list[data.num_descriptors].negative_tolerance = p_buffer[4] + ((uint16_t)p_buffer[5] << 8);
+        data.descriptor_list[data.num_descriptors].sampling_function = p_buffer[6];
+        data.descriptor_list[data.num_descriptors].measurement_period = p_buffer[7];
+        data.descriptor_list[data.num_descriptors].update_interval = p_buffer[8];
+        data.num_descriptors++;
+        len -= 9;
     }
-
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_FW_DISTRIBUTION_START, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
+    mesh_provision_process_event(WICED_BT_MESH_SENSOR_DESCRIPTOR_STATUS, p_event, &data);
 }
 
-/*
-* The application can call this function to suspend firmware distribution procedure.
-*/
-wiced_bool_t wiced_bt_mesh_fw_provider_suspend(wiced_bt_mesh_event_t *p_event)
+void process_sensor_settings_status(uint8_t *p_buffer, uint16_t len)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    wiced_bt_mesh_sensor_settings_status_data_t data = { 0 };
+    int i = 0;
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
 
-    wiced_bt_mesh_release_event(p_event);
+    data.property_id = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
+    while (len >= 4)
+    {
+        len -= 2;
+        p_buffer += 2;
+        data.setting_property_id_list[i++] = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
+    }
+    mesh_provision_process_event(WICED_BT_MESH_SENSOR_SETTINGS_STATUS, p_event, &data);
+}
 
-    if (p == NULL)
-        return WICED_FALSE;
+void process_sensor_cadence_status(uint8_t *p_buffer, uint16_t len)
+{
+    wiced_bt_mesh_sensor_cadence_status_data_t data = { 0 };
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
 
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_FW_DISTRIBUTION_SUSPEND, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
+    data.property_id = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
+    if (len > 2)
+    {
+        data.cadence_data.fast_cadence_period_divisor = p_buffer[2] + ((uint16_t)p_buffer[3] << 8);
+        data.cadence_data.trigger_type       = p_buffer[4];
+        data.cadence_data.trigger_delta_down = p_buffer[5]  + ((uint32_t)p_buffer[6] << 8)  + ((uint32_t)p_buffer[7] << 16)  + ((uint32_t)p_buffer[8] << 24);
+        data.cadence_data.trigger_delta_up   = p_buffer[9] + ((uint32_t)p_buffer[10] << 8) + ((uint32_t)p_buffer[11] << 16) + ((uint32_t)p_buffer[12] << 24);
+        data.cadence_data.min_interval       = p_buffer[13] + ((uint32_t)p_buffer[14] << 8) + ((uint32_t)p_buffer[15] << 16) + ((uint32_t)p_buffer[16] << 24);
+        data.cadence_data.fast_cadence_low   = p_buffer[17] + ((uint32_t)p_buffer[18] << 8) + ((uint32_t)p_buffer[19] << 16) + ((uint32_t)p_buffer[20] << 24);
+        data.cadence_data.fast_cadence_high  = p_buffer[21] + ((uint32_t)p_buffer[22] << 8) + ((uint32_t)p_buffer[23] << 16) + ((uint32_t)p_buffer[24] << 24);
+    }
+    mesh_provision_process_event(WICED_BT_MESH_SENSOR_CADENCE_STATUS, p_event, &data);
 }
 
-/*
-* The application can call this function to resume firmware distribution procedure.
-*/
-wiced_bool_t wiced_bt_mesh_fw_provider_resume(wiced_bt_mesh_event_t *p_event)
+void process_sensor_data_status(uint8_t *p_buffer, uint16_t len)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
+    wiced_bt_mesh_sensor_status_data_t data = { 0 };
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
 
-    if (p == NULL)
-        return WICED_FALSE;
+    data.property_id = p_buffer[0] + ((uint16_t)p_buffer[1] << 8);
+    data.prop_value_len = p_buffer[2];
+    memcpy(data.raw_value, p_buffer + 3, data.prop_value_len);
 
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_FW_DISTRIBUTION_RESUME, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
+    mesh_provision_process_event(WICED_BT_MESH_SENSOR_STATUS, p_event, &data);
 }
 
-/*
-* The application can call this function to terminate firmware distribution procedure.
-*/
-wiced_bool_t wiced_bt_mesh_fw_provider_stop(wiced_bt_mesh_event_t *p_event)
+void process_properties_status(uint8_t *p_buffer, uint16_t len)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_FALSE;
+    uint16_t event = 0;
+    int i = 0;
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
 
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_FW_DISTRIBUTION_STOP, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
+    if (len < 1)
+    {
+        wiced_bt_mesh_release_event(p_event);
+        return;
+    }
+    uint16_t num_props = (len - 1) / 2;
+    wiced_bt_mesh_properties_status_data_t *p_data = (wiced_bt_mesh_properties_status_data_t *)wiced_bt_get_buffer(sizeof(wiced_bt_mesh_properties_status_data_t) + len - 2);
+    if (p_data == NULL)
+    {
+        wiced_bt_mesh_release_event(p_event);
+        return;
+    }
+    p_data->type = p_buffer[0];
+    p_data->properties_num = (len - 1) / 2;
+    p_buffer++;
+    for (i = 0; i < p_data->properties_num; i++)
+    {
+        p_data->id[i] = p_buffer[0] + (p_buffer[1] << 8);
+        p_buffer += 2;
+    }
+    if (p_data->type == WICED_BT_MESH_PROPERTY_TYPE_ADMIN)
+        event = WICED_BT_MESH_ADMIN_PROPERTIES_STATUS;
+    else if (p_data->type == WICED_BT_MESH_PROPERTY_TYPE_CLIENT)
+        event = WICED_BT_MESH_CLIENT_PROPERTIES_STATUS;
+    else if (p_data->type == WICED_BT_MESH_PROPERTY_TYPE_MANUFACTURER)
+        event = WICED_BT_MESH_MANUF_PROPERTIES_STATUS;
+    else
+        event = WICED_BT_MESH_USER_PROPERTIES_STATUS;
+    mesh_provision_process_event(WICED_BT_MESH_MANUF_PROPERTIES_STATUS, p_event, p_data);
+    wiced_bt_free_buffer(p_data);
 }
 
-/*
-* The application can call this function to get the state of the current firmware distribution process.
-* The function may register a callback which will be executed when reply from the distributor is received.
-*/
-wiced_bool_t wiced_bt_mesh_fw_provider_get_status(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_fw_provider_callback_t *p_callback)
+void process_property_status(uint8_t *p_buffer, uint16_t len)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
+    uint16_t event = 0;
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
 
-    if (p == NULL)
-        return WICED_FALSE;
+    if (len < 4)
+    {
+        wiced_bt_mesh_release_event(p_event);
+        return;
+    }
 
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_FW_DISTRIBUTION_GET_STATUS, buffer, (uint16_t)(p - buffer));
-    return WICED_TRUE;
+    wiced_bt_mesh_property_status_data_t* p_data = (wiced_bt_mesh_property_status_data_t*)wiced_bt_get_buffer(sizeof(wiced_bt_mesh_property_status_data_t) + len - 5);
+    if (p_data == NULL)
+    {
+        wiced_bt_mesh_release_event(p_event);
+        return;
+    }
+    p_data->type = p_buffer[0];
+    p_data->access = p_buffer[1];
+    p_data->id = p_buffer[2] + (p_buffer[3] << 8);
+    memcpy(p_data->value, &p_buffer[4], len - 4);
+    if (p_data->type == WICED_BT_MESH_PROPERTY_TYPE_ADMIN)
+        event = WICED_BT_MESH_ADMIN_PROPERTY_STATUS;
+    else if (p_data->type == WICED_BT_MESH_PROPERTY_TYPE_MANUFACTURER)
+        event = WICED_BT_MESH_MANUF_PROPERTY_STATUS;
+    else
+        event = WICED_BT_MESH_USER_PROPERTY_STATUS;
+    mesh_provision_process_event(event, p_event, p_data);
+    wiced_bt_free_buffer(p_data);
 }
 
-/*
- * Process finish event received from OTA client
- */
-void wiced_bt_mesh_fw_provider_ota_finish(uint8_t status)
+void process_vendor_data(uint8_t *p_buffer, uint16_t len)
 {
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_event_from_hci_header(&p_buffer, &len);
+    if (p_event == NULL)
+        return;
+
+    p_event->data_len = len;
+    mesh_provision_process_event(WICED_BT_MESH_VENDOR_DATA, p_event, p_buffer);
 }
-#endif
 
 /*
- * Encrypt or decrypts and authenticates data
+ * Table driven HCI command encoder.
+ *
+ * Most of the commands sent to the embedded app consist of the standard HCI
+ * header followed by a fixed set of little endian fields copied from the
+ * request structure. Instead of serializing each command by hand, such
+ * command is described by the list of its fields below and by a descriptor,
+ * and a single function formats the header and sends the command from a
+ * buffer on the caller's stack. Each field list expands to an encoder
+ * function writing the fields in the order listed, so that the fields are
+ * copied by straight line code, as fast as the hand written serializers.
+ * Commands with variable or computed layouts are still serialized by hand.
  */
-uint16_t wiced_bt_mesh_core_crypt(wiced_bool_t encrypt, const uint8_t *p_in_data, uint16_t in_data_len, uint8_t *p_out_buf, uint16_t out_buf_len)
-{
-    return out_buf_len;
-}
+#define MESH_HCI_TX_BUFFER_SIZE             128
 
+#define MESH_HCI_CMD_FLAG_RELEASE_EVENT     0x01 /* release mesh event after formatting the HCI header */
 
-wiced_result_t wiced_bt_mesh_model_default_transition_time_client_send_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_default_transition_time_data_t* p_data)
+/* Writes the fields of the request to p, returns pointer to the byte after the last field */
+typedef uint8_t *(*mesh_hci_encode_t)(const void *p_data, uint8_t *p);
+
+typedef struct
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    uint16_t            hci_opcode;     /* HCI_CONTROL_MESH_COMMAND_XXX */
+    uint8_t             flags;          /* MESH_HCI_CMD_FLAG_XXX */
+    mesh_hci_encode_t   p_encode;       /* encoder of the fields following the HCI header, NULL if none */
+} mesh_hci_cmd_desc_t;
 
-    if (p == NULL)
-        return WICED_BT_BADARG;
+/* Field list of the request structure type, defines encoder mesh_hci_encode_<name> */
+#define MESH_HCI_FIELDS(name, type) \
+    static uint8_t *mesh_hci_encode_##name(const void *p_data, uint8_t *p) \
+    { \
+        const type *p_req = (const type *)p_data;
+#define MESH_HCI_FIELDS_END \
+        return p; \
+    }
 
-    *p++ = p_data->time & 0xff;
-    *p++ = (p_data->time >> 8) & 0xff;
-    *p++ = (p_data->time >> 16) & 0xff;
-    *p++ = (p_data->time >> 24) & 0xff;
+/* Unsigned integer sent little endian in wire_len bytes (up to 8), the conditions are constant */
+#define MESH_HCI_UINT(member, wire_len) \
+    { \
+        uint64_t value = (uint64_t)p_req->member; \
+        *p++ = (uint8_t)value; \
+        if ((wire_len) > 1) *p++ = (uint8_t)(value >> 8); \
+        if ((wire_len) > 2) *p++ = (uint8_t)(value >> 16); \
+        if ((wire_len) > 3) *p++ = (uint8_t)(value >> 24); \
+        if ((wire_len) > 4) *p++ = (uint8_t)(value >> 32); \
+        if ((wire_len) > 5) *p++ = (uint8_t)(value >> 40); \
+        if ((wire_len) > 6) *p++ = (uint8_t)(value >> 48); \
+        if ((wire_len) > 7) *p++ = (uint8_t)(value >> 56); \
+    }
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_DEF_TRANS_TIME_SET, buffer, (uint16_t)(p - buffer)) ? WICED_BT_SUCCESS : WICED_BT_ERROR;
-}
+/* Byte array copied as is */
+#define MESH_HCI_BYTES(member) \
+    memcpy(p, p_req->member, sizeof(p_req->member)); \
+    p += sizeof(p_req->member);
+
+#define MESH_HCI_CMD(opcode, flags, fields)     { opcode, flags, mesh_hci_encode_##fields }
+#define MESH_HCI_CMD_NO_PARAMS(opcode, flags)   { opcode, flags, NULL }
+
+/* Configuration client commands */
+MESH_HCI_FIELDS(model_publication_set, wiced_bt_mesh_config_model_publication_set_data_t)
+    MESH_HCI_UINT(element_addr, 2)
+    MESH_HCI_UINT(company_id, 2)
+    MESH_HCI_UINT(model_id, 2)
+    MESH_HCI_BYTES(publish_addr)
+    MESH_HCI_UINT(app_key_idx, 2)
+    MESH_HCI_UINT(credential_flag, 1)
+    MESH_HCI_UINT(publish_ttl, 1)
+    MESH_HCI_UINT(publish_period, 4)
+    MESH_HCI_UINT(publish_retransmit_count, 1)
+    MESH_HCI_UINT(publish_retransmit_interval, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(network_transmit_set, wiced_bt_mesh_config_network_transmit_set_data_t)
+    MESH_HCI_UINT(count, 1)
+    MESH_HCI_UINT(interval, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(default_ttl_set, wiced_bt_mesh_config_default_ttl_set_data_t)
+    MESH_HCI_UINT(ttl, 1)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(relay_set, wiced_bt_mesh_config_relay_set_data_t)
+    MESH_HCI_UINT(state, 1)
+    MESH_HCI_UINT(retransmit_count, 1)
+    MESH_HCI_UINT(retransmit_interval, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(friend_set, wiced_bt_mesh_config_friend_set_data_t)
+    MESH_HCI_UINT(state, 1)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(gatt_proxy_set, wiced_bt_mesh_config_gatt_proxy_set_data_t)
+    MESH_HCI_UINT(state, 1)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(beacon_set, wiced_bt_mesh_config_beacon_set_data_t)
+    MESH_HCI_UINT(state, 1)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(health_attention_set, wiced_bt_mesh_health_attention_set_data_t)
+    MESH_HCI_UINT(timer, 1)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(node_identity_set, wiced_bt_mesh_config_node_identity_set_data_t)
+    MESH_HCI_UINT(net_key_idx, 2)
+    MESH_HCI_UINT(identity, 1)
+MESH_HCI_FIELDS_END
+#ifdef PRIVATE_PROXY_SUPPORTED
+MESH_HCI_FIELDS(private_gatt_proxy_set, wiced_bt_mesh_config_private_gatt_proxy_set_data_t)
+    MESH_HCI_UINT(state, 1)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(private_beacon_set, wiced_bt_mesh_config_private_beacon_set_data_t)
+    MESH_HCI_UINT(state, 1)
+    MESH_HCI_UINT(random_update_interval, 1)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(private_node_identity_set, wiced_bt_mesh_config_private_node_identity_set_data_t)
+    MESH_HCI_UINT(net_key_idx, 2)
+    MESH_HCI_UINT(identity, 1)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(on_demand_private_proxy_set, wiced_bt_mesh_config_on_demand_private_proxy_set_data_t)
+    MESH_HCI_UINT(state, 1)
+MESH_HCI_FIELDS_END
+#endif
+MESH_HCI_FIELDS(lpn_poll_timeout_get, wiced_bt_mesh_lpn_poll_timeout_get_data_t)
+    MESH_HCI_UINT(lpn_addr, 2)
+MESH_HCI_FIELDS_END
+
+/* Model client commands */
+MESH_HCI_FIELDS(onoff_set, wiced_bt_mesh_onoff_set_data_t)
+    MESH_HCI_UINT(onoff, 1)
+    MESH_HCI_UINT(transition_time, 4)
+    MESH_HCI_UINT(delay, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(properties_get, wiced_bt_mesh_properties_get_data_t)
+    MESH_HCI_UINT(type, 1)
+    MESH_HCI_UINT(starting_id, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(property_get, wiced_bt_mesh_property_get_data_t)
+    MESH_HCI_UINT(type, 1)
+    MESH_HCI_UINT(id, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(light_lc_mode_set, wiced_bt_mesh_light_lc_mode_set_data_t)
+    MESH_HCI_UINT(mode, 1)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(light_lc_occupancy_mode_set, wiced_bt_mesh_light_lc_occupancy_mode_set_data_t)
+    MESH_HCI_UINT(mode, 1)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(light_lc_light_onoff_set, wiced_bt_mesh_light_lc_light_onoff_set_data_t)
+    MESH_HCI_UINT(light_onoff, 1)
+    MESH_HCI_UINT(transition_time, 4)
+    MESH_HCI_UINT(delay, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(light_lc_property_get, wiced_bt_mesh_light_lc_property_get_data_t)
+    MESH_HCI_UINT(id, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(light_xyl_set, wiced_bt_mesh_light_xyl_set_t)
+    MESH_HCI_UINT(target.lightness, 2)
+    MESH_HCI_UINT(target.x, 2)
+    MESH_HCI_UINT(target.y, 2)
+    MESH_HCI_UINT(transition_time, 4)
+    MESH_HCI_UINT(delay, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(light_xyl_range_set, wiced_bt_mesh_light_xyl_range_set_data_t)
+    MESH_HCI_UINT(x_min, 2)
+    MESH_HCI_UINT(x_max, 2)
+    MESH_HCI_UINT(y_min, 2)
+    MESH_HCI_UINT(y_max, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(light_xyl_default_set, wiced_bt_mesh_light_xyl_default_data_t)
+    MESH_HCI_UINT(default_status.lightness, 2)
+    MESH_HCI_UINT(default_status.x, 2)
+    MESH_HCI_UINT(default_status.y, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(location_global_set, wiced_bt_mesh_location_global_data_t)
+    MESH_HCI_UINT(global_latitude, 4)
+    MESH_HCI_UINT(global_longitude, 4)
+    MESH_HCI_UINT(global_altitude, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(location_local_set, wiced_bt_mesh_location_local_data_t)
+    MESH_HCI_UINT(local_north, 2)
+    MESH_HCI_UINT(local_east, 2)
+    MESH_HCI_UINT(local_altitude, 2)
+    MESH_HCI_UINT(floor_number, 1)
+    MESH_HCI_UINT(is_mobile, 1)
+    MESH_HCI_UINT(update_time, 1)
+    MESH_HCI_UINT(precision, 1)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(power_level_set, wiced_bt_mesh_power_level_set_level_t)
+    MESH_HCI_UINT(level, 2)
+    MESH_HCI_UINT(transition_time, 4)
+    MESH_HCI_UINT(delay, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(power_level_default_set, wiced_bt_mesh_power_default_data_t)
+    MESH_HCI_UINT(power, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(power_level_range_set, wiced_bt_mesh_power_level_range_set_data_t)
+    MESH_HCI_UINT(power_min, 2)
+    MESH_HCI_UINT(power_max, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(onpowerup_set, wiced_bt_mesh_power_onoff_data_t)
+    MESH_HCI_UINT(on_power_up, 1)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(scheduler_action_get, wiced_bt_mesh_scheduler_action_get_t)
+    MESH_HCI_UINT(action_number, 1)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(scheduler_action_set, wiced_bt_mesh_scheduler_action_data_t)
+    MESH_HCI_UINT(action_number, 1)
+    MESH_HCI_UINT(year, 1)
+    MESH_HCI_UINT(month, 2)
+    MESH_HCI_UINT(day, 1)
+    MESH_HCI_UINT(hour, 1)
+    MESH_HCI_UINT(minute, 1)
+    MESH_HCI_UINT(second, 1)
+    MESH_HCI_UINT(day_of_week, 1)
+    MESH_HCI_UINT(action, 1)
+    MESH_HCI_UINT(transition_time, 4)
+    MESH_HCI_UINT(scene_number, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(time_zone_set, wiced_bt_mesh_time_zone_set_t)
+    MESH_HCI_UINT(time_zone_offset_new, 1)
+    MESH_HCI_UINT(tai_of_zone_change, 5)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(time_role_set, wiced_bt_mesh_time_role_msg_t)
+    MESH_HCI_UINT(role, 1)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(level_set, wiced_bt_mesh_level_set_level_t)
+    MESH_HCI_UINT(level, 2)
+    MESH_HCI_UINT(transition_time, 4)
+    MESH_HCI_UINT(delay, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(level_delta_set, wiced_bt_mesh_level_set_delta_t)
+    MESH_HCI_UINT(delta, 4)
+    MESH_HCI_UINT(continuation, 1)
+    MESH_HCI_UINT(transition_time, 4)
+    MESH_HCI_UINT(delay, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(level_move_set, wiced_bt_mesh_level_set_move_t)
+    MESH_HCI_UINT(delta, 2)
+    MESH_HCI_UINT(continuation, 1)
+    MESH_HCI_UINT(transition_time, 4)
+    MESH_HCI_UINT(delay, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(light_lightness_set, wiced_bt_mesh_light_lightness_actual_set_t)
+    MESH_HCI_UINT(lightness_actual, 2)
+    MESH_HCI_UINT(transition_time, 4)
+    MESH_HCI_UINT(delay, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(light_hsl_set, wiced_bt_mesh_light_hsl_set_t)
+    MESH_HCI_UINT(target.lightness, 2)
+    MESH_HCI_UINT(target.hue, 2)
+    MESH_HCI_UINT(target.saturation, 2)
+    MESH_HCI_UINT(transition_time, 4)
+    MESH_HCI_UINT(delay, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(light_hsl_hue_set, wiced_bt_mesh_light_hsl_hue_set_t)
+    MESH_HCI_UINT(level, 2)
+    MESH_HCI_UINT(transition_time, 4)
+    MESH_HCI_UINT(delay, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(light_hsl_saturation_set, wiced_bt_mesh_light_hsl_saturation_set_t)
+    MESH_HCI_UINT(level, 2)
+    MESH_HCI_UINT(transition_time, 4)
+    MESH_HCI_UINT(delay, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(light_hsl_default_set, wiced_bt_mesh_light_hsl_default_data_t)
+    MESH_HCI_UINT(default_status.lightness, 2)
+    MESH_HCI_UINT(default_status.hue, 2)
+    MESH_HCI_UINT(default_status.saturation, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(light_hsl_range_set, wiced_bt_mesh_light_hsl_range_set_data_t)
+    MESH_HCI_UINT(hue_min, 2)
+    MESH_HCI_UINT(hue_max, 2)
+    MESH_HCI_UINT(saturation_min, 2)
+    MESH_HCI_UINT(saturation_max, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(light_ctl_set, wiced_bt_mesh_light_ctl_set_t)
+    MESH_HCI_UINT(target.lightness, 2)
+    MESH_HCI_UINT(target.temperature, 2)
+    MESH_HCI_UINT(target.delta_uv, 2)
+    MESH_HCI_UINT(transition_time, 4)
+    MESH_HCI_UINT(delay, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(sensor_property_id, wiced_bt_mesh_sensor_get_t)
+    MESH_HCI_UINT(property_id, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(sensor_setting_get, wiced_bt_mesh_sensor_setting_get_data_t)
+    MESH_HCI_UINT(property_id, 2)
+    MESH_HCI_UINT(setting_property_id, 2)
+MESH_HCI_FIELDS_END
+MESH_HCI_FIELDS(sensor_cadence_set, wiced_bt_mesh_sensor_cadence_set_data_t)
+    MESH_HCI_UINT(property_id, 2)
+    MESH_HCI_UINT(prop_value_len, 1)
+    MESH_HCI_UINT(cadence_data.fast_cadence_period_divisor, 2)
+    MESH_HCI_UINT(cadence_data.trigger_type, 1)
+    MESH_HCI_UINT(cadence_data.trigger_delta_down, 4)
+    MESH_HCI_UINT(cadence_data.trigger_delta_up, 4)
+    MESH_HCI_UINT(cadence_data.min_interval, 4)
+    MESH_HCI_UINT(cadence_data.fast_cadence_low, 4)
+    MESH_HCI_UINT(cadence_data.fast_cadence_high, 4)
+MESH_HCI_FIELDS_END
+
+/* Configuration client command descriptors */
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_model_publication_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_PUBLICATION_SET, 0, model_publication_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_network_transmit_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_CONFIG_NETWORK_TRANSMIT_SET, 0, network_transmit_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_default_ttl_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_CONFIG_DEFAULT_TTL_SET, 0, default_ttl_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_relay_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_CONFIG_RELAY_SET, 0, relay_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_friend_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_CONFIG_FRIEND_SET, 0, friend_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_gatt_proxy_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_CONFIG_GATT_PROXY_SET, 0, gatt_proxy_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_beacon_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_CONFIG_BEACON_SET, 0, beacon_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_node_reset = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_CONFIG_NODE_RESET, 0);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_health_attention_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_HEALTH_ATTENTION_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, health_attention_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_node_identity_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_CONFIG_NODE_IDENTITY_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, node_identity_set);
+#ifdef PRIVATE_PROXY_SUPPORTED
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_private_gatt_proxy_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_CONFIG_PRIVATE_GATT_PROXY_SET, 0, private_gatt_proxy_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_private_beacon_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_CONFIG_PRIVATE_BEACON_SET, 0, private_beacon_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_private_node_identity_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_CONFIG_PRIVATE_NODE_IDENTITY_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, private_node_identity_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_on_demand_private_proxy_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_CONFIG_ON_DEMAND_PRIVATE_PROXY_SET, 0, on_demand_private_proxy_set);
+#endif
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_lpn_poll_timeout_get = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_CONFIG_LPN_POLL_TIMEOUT_GET, 0, lpn_poll_timeout_get);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_provision_scan_capabilities_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_PROVISION_SCAN_CAPABILITIES_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_provision_scan_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_PROVISION_SCAN_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_provision_scan_stop = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_PROVISION_SCAN_STOP, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+
+/* Model client command descriptors */
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_onoff_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_ONOFF_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_onoff_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_ONOFF_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, onoff_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_battery_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_BATTERY_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_properties_get = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_PROPERTIES_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, properties_get);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_property_get = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_PROPERTY_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, property_get);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_lc_mode_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_LIGHT_LC_MODE_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_lc_mode_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_LIGHT_LC_MODE_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, light_lc_mode_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_lc_occupancy_mode_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_LIGHT_LC_OCCUPANCY_MODE_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_lc_occupancy_mode_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_LIGHT_LC_OCCUPANCY_MODE_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, light_lc_occupancy_mode_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_lc_light_onoff_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_LIGHT_LC_ONOFF_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_lc_light_onoff_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_LIGHT_LC_ONOFF_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, light_lc_light_onoff_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_lc_property_get = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_LIGHT_LC_PROPERTY_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, light_lc_property_get);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_xyl_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_xyl_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, light_xyl_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_xyl_target_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_TARGET_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_xyl_range_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_RANGE_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_xyl_range_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_RANGE_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, light_xyl_range_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_xyl_default_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_DEFAULT_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_xyl_default_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_DEFAULT_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, light_xyl_default_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_location_global_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_LOCATION_GLOBAL_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_location_local_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_LOCATION_LOCAL_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_location_global_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_LOCATION_GLOBAL_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, location_global_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_location_local_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_LOCATION_LOCAL_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, location_local_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_power_level_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_power_level_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, power_level_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_power_level_last_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_LAST_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_power_level_default_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_DEFAULT_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_power_level_default_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_DEFAULT_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, power_level_default_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_power_level_range_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_RANGE_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_power_level_range_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_RANGE_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, power_level_range_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_onpowerup_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_ONPOWERUP_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_onpowerup_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_ONPOWERUP_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, onpowerup_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_scheduler_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_SCHEDULER_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_scheduler_action_get = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_SCHEDULER_ACTION_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, scheduler_action_get);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_scheduler_action_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_SCHEDULER_ACTION_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, scheduler_action_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_time_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_TIME_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_time_zone_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_TIME_ZONE_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_time_zone_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_TIME_ZONE_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, time_zone_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_time_tai_utc_delta_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_time_role_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_TIME_ROLE_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_time_role_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_TIME_ROLE_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, time_role_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_level_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_LEVEL_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_level_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_LEVEL_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, level_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_level_delta_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_LEVEL_DELTA_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, level_delta_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_level_move_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_LEVEL_MOVE_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, level_move_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_lightness_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_LIGHT_LIGHTNESS_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_lightness_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_LIGHT_LIGHTNESS_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, light_lightness_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_hsl_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_hsl_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, light_hsl_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_hsl_hue_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_HUE_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_hsl_hue_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_HUE_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, light_hsl_hue_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_hsl_saturation_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_SATURATION_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_hsl_saturation_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_SATURATION_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, light_hsl_saturation_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_hsl_target_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_TARGET_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_hsl_default_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_DEFAULT_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_hsl_default_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_DEFAULT_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, light_hsl_default_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_hsl_range_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_RANGE_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_hsl_range_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_RANGE_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, light_hsl_range_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_ctl_get = MESH_HCI_CMD_NO_PARAMS(HCI_CONTROL_MESH_COMMAND_LIGHT_CTL_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_light_ctl_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_LIGHT_CTL_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, light_ctl_set);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_sensor_setting_get = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_SENSOR_SETTING_GET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, sensor_setting_get);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_sensor_settings_get = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_SENSOR_SETTINGS_GET, 0, sensor_property_id);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_sensor_cadence_get = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_SENSOR_CADENCE_GET, 0, sensor_property_id);
+static const mesh_hci_cmd_desc_t mesh_hci_cmd_sensor_cadence_set = MESH_HCI_CMD(HCI_CONTROL_MESH_COMMAND_SENSOR_CADENCE_SET, MESH_HCI_CMD_FLAG_RELEASE_EVENT, sensor_cadence_set);
 
-wiced_result_t wiced_bt_mesh_model_onoff_client_send_get(wiced_bt_mesh_event_t *p_event)
+/*
+ * Format and send model client command described by the command descriptor
+ */
+static wiced_result_t mesh_hci_send_model_command(wiced_bt_mesh_event_t *p_event, const mesh_hci_cmd_desc_t *p_desc, const void *p_data)
 {
-    uint8_t buffer[128];
+    // on the stack, a command can be sent from a callback while another one is being encoded
+    uint8_t buffer[MESH_HCI_TX_BUFFER_SIZE];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
 
-    wiced_bt_mesh_release_event(p_event);
+    if (p_desc->flags & MESH_HCI_CMD_FLAG_RELEASE_EVENT)
+        wiced_bt_mesh_release_event(p_event);
 
     if (p == NULL)
         return WICED_BT_BADARG;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_ONOFF_GET, buffer, (uint16_t)(p - buffer));
+    if (p_desc->p_encode != NULL)
+        p = p_desc->p_encode(p_data, p);
+
+    return mesh_hci_send(p_desc->hci_opcode, buffer, (uint16_t)(p - buffer));
 }
 
-wiced_result_t wiced_bt_mesh_model_onoff_client_send_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_onoff_set_data_t *p_data)
+/*
+ * Format and send configuration client command described by the command descriptor
+ */
+static wiced_bool_t mesh_hci_send_config_command(wiced_bt_mesh_event_t *p_event, const mesh_hci_cmd_desc_t *p_desc, const void *p_data)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
-
-    *p++ = p_data->onoff;
-    *p++ = p_data->transition_time & 0xff;
-    *p++ = (p_data->transition_time >> 8) & 0xff;
-    *p++ = (p_data->transition_time >> 16) & 0xff;
-    *p++ = (p_data->transition_time >> 24) & 0xff;
-    *p++ = p_data->delay & 0xff;
-    *p++ = (p_data->delay >> 8) & 0xff;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_ONOFF_SET, buffer, (uint16_t)(p - buffer));
+    return (mesh_hci_send_model_command(p_event, p_desc, p_data) == WICED_BT_BADARG) ? WICED_FALSE : WICED_TRUE;
 }
 
-wiced_result_t wiced_bt_mesh_battery_client_send_get(wiced_bt_mesh_event_t *p_event)
+wiced_bool_t wiced_bt_mesh_provision_connect(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_provision_connect_data_t *p_data, uint8_t use_gatt)
 {
     uint8_t buffer[128];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    int i;
 
     wiced_bt_mesh_release_event(p_event);
 
     if (p == NULL)
-        return WICED_BT_BADARG;
+        return WICED_FALSE;
+
+    for (i = 0; i < sizeof(p_data->uuid); i++)
+        *p++ = p_data->uuid[i];
+    *p++ = p_data->identify_duration;
+    *p++ = p_data->procedure;
+    *p++ = use_gatt;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_BATTERY_GET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send(HCI_CONTROL_MESH_COMMAND_PROVISION_CONNECT, buffer, (uint16_t)(p - buffer));
 }
 
-wiced_result_t wiced_bt_mesh_model_property_client_send_properties_get(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_properties_get_data_t *p_data)
+wiced_bool_t wiced_bt_mesh_provision_start(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_provision_start_data_t *p_data)
 {
     uint8_t buffer[128];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
@@ -2214,16 +2215,22 @@ wiced_result_t wiced_bt_mesh_model_property_client_send_properties_get(wiced_bt_
     wiced_bt_mesh_release_event(p_event);
 
     if (p == NULL)
-        return WICED_BT_BADARG;
+        return WICED_FALSE;
 
-    *p++ = p_data->type;
-    *p++ = p_data->starting_id & 0xff;
-    *p++ = (p_data->starting_id >> 8) & 0xff;
+    *p++ = (uint8_t)p_data->addr;
+    *p++ = (uint8_t)(p_data->addr >> 8);
+    *p++ = (uint8_t)p_data->net_key_idx;
+    *p++ = (uint8_t)(p_data->net_key_idx >> 8);
+    *p++ = p_data->algorithm;
+    *p++ = p_data->public_key_type;
+    *p++ = p_data->auth_method;
+    *p++ = p_data->auth_action;
+    *p++ = p_data->auth_size;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_PROPERTIES_GET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send(HCI_CONTROL_MESH_COMMAND_PROVISION_START, buffer, (uint16_t)(p - buffer));
 }
 
-wiced_result_t wiced_bt_mesh_model_property_client_send_property_get(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_property_get_data_t *p_data)
+wiced_bool_t wiced_bt_mesh_provision_client_set_oob(wiced_bt_mesh_event_t *p_event, uint8_t* p_oob, uint32_t len)
 {
     uint8_t buffer[128];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
@@ -2231,16 +2238,15 @@ wiced_result_t wiced_bt_mesh_model_property_client_send_property_get(wiced_bt_me
     wiced_bt_mesh_release_event(p_event);
 
     if (p == NULL)
-        return WICED_BT_BADARG;
+        return WICED_FALSE;
 
-    *p++ = p_data->type;
-    *p++ = p_data->id & 0xff;
-    *p++ = (p_data->id >> 8) & 0xff;
+    memcpy(p, p_oob, len);
+    p += len;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_PROPERTY_GET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send(HCI_CONTROL_MESH_COMMAND_PROVISION_OOB_VALUE, buffer, (uint16_t)(p - buffer));
 }
 
-wiced_result_t wiced_bt_mesh_model_property_client_send_property_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_property_set_data_t *p_data)
+wiced_bool_t wiced_bt_mesh_provision_disconnect(wiced_bt_mesh_event_t *p_event)
 {
     uint8_t buffer[128];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
@@ -2248,22 +2254,19 @@ wiced_result_t wiced_bt_mesh_model_property_client_send_property_set(wiced_bt_me
     wiced_bt_mesh_release_event(p_event);
 
     if (p == NULL)
-        return WICED_BT_BADARG;
-
-    *p++ = p_data->type;
-    *p++ = p_data->id & 0xff;
-    *p++ = (p_data->id >> 8) & 0xff;
-    *p++ = p_data->access;
-    *p++ = p_data->len & 0xff;
-    *p++ = (p_data->len >> 8) & 0xff;
-
-    memcpy(p, p_data->value, p_data->len);
-    p += p_data->len;
+        return WICED_FALSE;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_PROPERTY_SET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send(HCI_CONTROL_MESH_COMMAND_PROVISION_DISCONNECT, buffer, (uint16_t)(p - buffer));
 }
 
-wiced_result_t wiced_bt_mesh_model_light_lc_client_send_mode_get(wiced_bt_mesh_event_t *p_event)
+#if defined(CERTIFICATE_BASED_PROVISIONING_SUPPORTED)
+/**
+ * @brief send invite  to the peer device
+ *
+ * @param p_event   mesh event
+ * @return wiced_bool_t
+ */
+wiced_bool_t wiced_bt_mesh_provision_send_invite(wiced_bt_mesh_event_t* p_event)
 {
     uint8_t buffer[128];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
@@ -2271,12 +2274,19 @@ wiced_result_t wiced_bt_mesh_model_light_lc_client_send_mode_get(wiced_bt_mesh_e
     wiced_bt_mesh_release_event(p_event);
 
     if (p == NULL)
-        return WICED_BT_BADARG;
+        return WICED_FALSE;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_LC_MODE_GET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send(HCI_CONTROL_MESH_COMMAND_PROVISION_SEND_INVITE, buffer, (uint16_t)(p - buffer));
 }
 
-wiced_result_t wiced_bt_mesh_model_light_lc_client_send_mode_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_lc_mode_set_data_t *p_data)
+/**
+ * @brief retrieve provisioning records from the peer device
+ *
+ * @param p_event   mesh event
+ * @param p_data    pointer to the paramenter describing record fragment to retrieve
+ * @return wiced_bool_t
+ */
+wiced_bool_t wiced_bt_mesh_provision_retrieve_record(wiced_bt_mesh_event_t* p_event, wiced_bt_mesh_provision_device_record_fragment_data_t*  p_data)
 {
     uint8_t buffer[128];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
@@ -2284,383 +2294,582 @@ wiced_result_t wiced_bt_mesh_model_light_lc_client_send_mode_set(wiced_bt_mesh_e
     wiced_bt_mesh_release_event(p_event);
 
     if (p == NULL)
-        return WICED_BT_BADARG;
-
-    *p++ = p_data->mode;
+        return WICED_FALSE;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_LC_MODE_SET, buffer, (uint16_t)(p - buffer));
+    UINT16_TO_BE_STREAM(p, p_data->record_id);
+    UINT16_TO_BE_STREAM(p, p_data->fragment_offset);
+    UINT16_TO_BE_STREAM(p, p_data->total_length);
+    return mesh_hci_send(HCI_CONTROL_MESH_COMMAND_PROVISION_RETRIEVE_RECORD, buffer, (uint16_t)(p - buffer));
 }
+#endif
 
-wiced_result_t wiced_bt_mesh_model_light_lc_client_send_occupancy_mode_get(wiced_bt_mesh_event_t *p_event)
+wiced_bool_t wiced_bt_mesh_client_proxy_connect(wiced_bt_mesh_proxy_connect_data_t *p_connect)
 {
     uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    uint8_t *p = buffer;
+    int i;
+    if (p_connect->connect_type == CONNECT_TYPE_NODE_ID)
+    {
+        *p++ = p_connect->node_id & 0xff;
+        *p++ = (p_connect->node_id >> 8) & 0xff;
+    }
+    else if (p_connect->connect_type == CONNECT_TYPE_BDADDR)
+    {
+        for (i = 0; i < 6; i++)
+            *p++ = p_connect->bd_addr[5 - i];
+        *p++ = p_connect->bd_addr_type;
+    }
+    *p++ = p_connect->scan_duration;
 
-    wiced_bt_mesh_release_event(p_event);
+    return mesh_hci_send(HCI_CONTROL_MESH_COMMAND_PROXY_CONNECT, buffer, (uint16_t)(p - buffer));
+}
+
+wiced_bool_t wiced_bt_mesh_client_proxy_disconnect(void)
+{
+    return mesh_hci_send(HCI_CONTROL_MESH_COMMAND_PROXY_DISCONNECT, NULL, 0);
+}
+
+wiced_result_t wiced_bt_mesh_core_send(wiced_bt_mesh_event_t *p_event, const uint8_t* params, uint16_t params_len, wiced_bt_mesh_core_send_complete_callback_t complete_callback)
+{
+    uint8_t buffer[512];
+    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
 
     if (p == NULL)
-        return WICED_BT_BADARG;
+    {
+        wiced_bt_mesh_release_event(p_event);
+        return WICED_FALSE;
+    }
+#define MESH_APP_PAYLOAD_OP_LONG              0x80
+#define MESH_APP_PAYLOAD_OP_MANUF_SPECIFIC    0x40
+    if (p_event->company_id != MESH_COMPANY_ID_BT_SIG)
+    {
+        *p++ = (p_event->opcode | MESH_APP_PAYLOAD_OP_LONG | MESH_APP_PAYLOAD_OP_MANUF_SPECIFIC) & 0xff;
+        *p++ = (p_event->company_id >> 8) & 0xff;
+        *p++ = p_event->company_id & 0xff;
+    }
+    else
+    {
+        *p++ = (p_event->opcode >> 8) & 0xff;
+        *p++ = p_event->opcode & 0xff;
+    }
+    memcpy(p, params, params_len);
+    p += params_len;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_LC_OCCUPANCY_MODE_GET, buffer, (uint16_t)(p - buffer));
+    mesh_hci_send(HCI_CONTROL_MESH_COMMAND_RAW_MODEL_DATA, buffer, (uint16_t)(p - buffer));
+    wiced_bt_mesh_release_event(p_event);
+    return WICED_BT_SUCCESS;
 }
 
-wiced_result_t wiced_bt_mesh_model_light_lc_client_send_occupancy_mode_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_lc_occupancy_mode_set_data_t *p_data)
+void wiced_bt_mesh_provision_set_dev_key(wiced_bt_mesh_set_dev_key_data_t *p_data)
 {
     uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    uint8_t *p = buffer;
+    *p++ = p_data->dst & 0xff;
+    *p++ = (p_data->dst >> 8) & 0xff;
+    memcpy(p, p_data->dev_key, 16);
+    p += 16;
+    *p++ = p_data->net_key_idx & 0xff;
+    *p++ = (p_data->net_key_idx >> 8) & 0xff;
 
-    wiced_bt_mesh_release_event(p_event);
+    mesh_hci_send(HCI_CONTROL_MESH_COMMAND_SET_DEVICE_KEY, buffer, (uint16_t)(p - buffer));
+}
 
-    if (p == NULL)
-        return WICED_BT_BADARG;
+void wiced_bt_mesh_adv_tx_power_set(uint8_t adv_tx_power)
+{
+    uint8_t buffer[260] = {0};
+    uint8_t *p = buffer;
+    p[0] = adv_tx_power;
+    mesh_hci_send(HCI_CONTROL_MESH_COMMAND_SET_ADV_TX_POWER, buffer, 1);
+}
 
-    *p++ = p_data->mode;
+void wiced_bt_mesh_add_vendor_model(wiced_bt_mesh_add_vendor_model_data_t *p_data)
+{
+    uint8_t buffer[260] = {0};
+    uint8_t *p = buffer;
+    *p++ = p_data->company_id & 0xff;
+    *p++ = (p_data->company_id >> 8) & 0xff;
+    *p++ = p_data->model_id & 0xff;
+    *p++ = (p_data->model_id >> 8) & 0xff;
+    if (p_data->num_opcodes > WICED_BT_MESH_MAX_VENDOR_MODEL_OPCODES)
+        p_data->num_opcodes = WICED_BT_MESH_MAX_VENDOR_MODEL_OPCODES;
+    *p++ = p_data->num_opcodes;
+    memcpy(p, p_data->opcode, p_data->num_opcodes * 3); // vendor model opcodes are 3-bytes long
+    p += p_data->num_opcodes * 3;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_LC_OCCUPANCY_MODE_SET, buffer, (uint16_t)(p - buffer));
+    mesh_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_ADD, buffer, (uint16_t)(p - buffer));
 }
 
-wiced_result_t wiced_bt_mesh_model_light_lc_client_send_light_onoff_get(wiced_bt_mesh_event_t *p_event)
+wiced_bool_t wiced_bt_mesh_config_composition_data_get(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_composition_data_get_data_t *p_get)
 {
     uint8_t buffer[128];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
 
-    wiced_bt_mesh_release_event(p_event);
-
     if (p == NULL)
-        return WICED_BT_BADARG;
+    {
+        wiced_bt_mesh_release_event(p_event);
+        return WICED_FALSE;
+    }
+
+    *p++ = p_get->page_number;
+
+    Log("Composition Data Get addr:0x%04x page_number:%x", p_event->dst, p_get->page_number);
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_LC_ONOFF_GET, buffer, (uint16_t)(p - buffer));
+    mesh_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_COMPOSITION_DATA_GET, buffer, (uint16_t)(p - buffer));
+    wiced_bt_mesh_release_event(p_event);
+    return WICED_TRUE;
 }
 
-wiced_result_t wiced_bt_mesh_model_light_lc_client_send_light_onoff_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_lc_light_onoff_set_data_t *p_data)
+#ifdef LARGE_COMPOSITION_DATA_SUPPORTED
+wiced_bool_t wiced_bt_mesh_config_large_compos_data_get(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_large_compos_data_get_data_t *p_get)
 {
     uint8_t buffer[128];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
 
-    wiced_bt_mesh_release_event(p_event);
-
     if (p == NULL)
-        return WICED_BT_BADARG;
+    {
+        wiced_bt_mesh_release_event(p_event);
+        return WICED_FALSE;
+    }
+
+    UINT8_TO_STREAM(p, p_get->page);
+    UINT16_TO_STREAM(p, p_get->offset);
 
-    *p++ = p_data->light_onoff;
-    *p++ = p_data->transition_time & 0xff;
-    *p++ = (p_data->transition_time >> 8) & 0xff;
-    *p++ = (p_data->transition_time >> 16) & 0xff;
-    *p++ = (p_data->transition_time >> 24) & 0xff;
-    *p++ = p_data->delay & 0xff;
-    *p++ = (p_data->delay >> 8) & 0xff;
+    Log("Large Composition Data Get addr:0x%04x page_number:%d offset:%d", p_event->dst, p_get->page, p_get->offset);
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_LC_ONOFF_SET, buffer, (uint16_t)(p - buffer));
+    mesh_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_LARGE_COMPOS_DATA_GET, buffer, (uint16_t)(p - buffer));
+    wiced_bt_mesh_release_event(p_event);
+    return WICED_TRUE;
 }
+#endif
 
-wiced_result_t wiced_bt_mesh_model_light_lc_client_send_property_get(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_lc_property_get_data_t *p_data)
+wiced_bool_t wiced_bt_mesh_config_netkey_change(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_netkey_change_data_t *p_data)
 {
     uint8_t buffer[128];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
 
-    wiced_bt_mesh_release_event(p_event);
-
     if (p == NULL)
-        return WICED_BT_BADARG;
+        return WICED_FALSE;
 
-    *p++ = p_data->id & 0xff;
-    *p++ = (p_data->id >> 8) & 0xff;
+    *p++ = p_data->net_key_idx & 0xff;
+    *p++ = (p_data->net_key_idx >> 8) & 0xff;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_LC_PROPERTY_GET, buffer, (uint16_t)(p - buffer));
+    if (p_data->operation == OPERATION_DELETE)
+    {
+        mesh_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_NET_KEY_DELETE, buffer, (uint16_t)(p - buffer));
+    }
+    else
+    {
+        memcpy(p, p_data->net_key, 16);
+        p += 16;
+        mesh_hci_send(p_data->operation == OPERATION_ADD ? HCI_CONTROL_MESH_COMMAND_CONFIG_NET_KEY_ADD : HCI_CONTROL_MESH_COMMAND_CONFIG_NET_KEY_UPDATE, buffer, (uint16_t)(p - buffer));
+    }
+    return WICED_TRUE;
 }
 
-wiced_result_t wiced_bt_mesh_model_light_lc_client_send_property_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_lc_property_set_data_t *p_data)
+wiced_bool_t wiced_bt_mesh_config_key_refresh_phase_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_key_refresh_phase_set_data_t *p_set)
 {
     uint8_t buffer[128];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
 
-    wiced_bt_mesh_release_event(p_event);
-
     if (p == NULL)
-        return WICED_BT_BADARG;
-
-    *p++ = p_data->id & 0xff;
-    *p++ = (p_data->id >> 8) & 0xff;
-    *p++ = p_data->len & 0xff;
-    *p++ = (p_data->len >> 8) & 0xff;
-    memcpy(p, p_data->value, p_data->len);
-    p += p_data->len;
+    {
+        wiced_bt_mesh_release_event(p_event);
+        return WICED_FALSE;
+    }
+    *p++ = p_set->net_key_idx & 0xff;
+    *p++ = (p_set->net_key_idx >> 8) & 0xff;
+    *p++ = p_set->transition;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_LC_PROPERTY_SET, buffer, (uint16_t)(p - buffer));
+    Log("Key refresh addr:%04x net_key_idx:%x phase:%x", p_event->dst, p_set->net_key_idx, p_set->transition);
+    mesh_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_KEY_REFRESH_PHASE_SET, buffer, (uint16_t)(p - buffer));
+    return WICED_TRUE;
 }
 
-wiced_result_t wiced_bt_mesh_model_light_xyl_client_send_get(wiced_bt_mesh_event_t *p_event)
+wiced_bool_t wiced_bt_mesh_config_appkey_change(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_appkey_change_data_t *p_data)
 {
     uint8_t buffer[128];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
 
-    wiced_bt_mesh_release_event(p_event);
-
     if (p == NULL)
-        return WICED_BT_BADARG;
+    {
+        wiced_bt_mesh_release_event(p_event);
+        return WICED_FALSE;
+    }
+    *p++ = p_data->net_key_idx & 0xff;
+    *p++ = (p_data->net_key_idx >> 8) & 0xff;
+    *p++ = p_data->app_key_idx & 0xff;
+    *p++ = (p_data->app_key_idx >> 8) & 0xff;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_GET, buffer, (uint16_t)(p - buffer));
+    if (p_data->operation == OPERATION_DELETE)
+    {
+        Log("AppKey Delete addr:%04x net_key_idx:%x app_key_idx:%x", p_event->dst, p_data->net_key_idx, p_data->app_key_idx);
+        mesh_hci_send(HCI_CONTROL_MESH_COMMAND_CONFIG_APP_KEY_DELETE, buffer, (uint16_t)(p - buffer));
+    }
+    else
+    {
+        memcpy(p, p_data->app_key, 16);
+        p += 16;
+        Log("AppKey %s addr:%04x net_key_idx:%x app_key_idx:%x", p_data->operation == OPERATION_ADD ? "Add" : "Update", p_event->dst, p_data->net_key_idx, p_data->app_key_idx);
+        mesh_hci_send(p_data->operation == OPERATION_ADD ? HCI_CONTROL_MESH_COMMAND_CONFIG_APP_KEY_ADD : HCI_CONTROL_MESH_COMMAND_CONFIG_APP_KEY_UPDATE, buffer, (uint16_t)(p - buffer));
+    }
+    return WICED_TRUE;
 }
 
-wiced_result_t wiced_bt_mesh_model_light_xyl_client_send_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_xyl_set_t *p_data)
+wiced_bool_t wiced_bt_mesh_config_model_app_bind(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_model_app_bind_data_t *p_data)
 {
     uint8_t buffer[128];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
 
-    wiced_bt_mesh_release_event(p_event);
-
     if (p == NULL)
-        return WICED_BT_BADARG;
+        return WICED_FALSE;
 
-    *p++ = p_data->target.lightness & 0xff;
-    *p++ = (p_data->target.lightness >> 8) & 0xff;
-    *p++ = p_data->target.x & 0xff;
-    *p++ = (p_data->target.x >> 8) & 0xff;
-    *p++ = p_data->target.y & 0xff;
-    *p++ = (p_data->target.y >> 8) & 0xff;
-    *p++ = p_data->transition_time & 0xff;
-    *p++ = (p_data->transition_time >> 8) & 0xff;
-    *p++ = (p_data->transition_time >> 16) & 0xff;
-    *p++ = (p_data->transition_time >> 24) & 0xff;
-    *p++ = p_data->delay & 0xff;
-    *p++ = (p_data->delay >> 8) & 0xff;
+    *p++ = p_data->element_addr & 0xff;
+    *p++ = (p_data->element_addr >> 8) & 0xff;
+    *p++ = p_data->company_id & 0xff;
+    *p++ = (p_data->company_id >> 8) & 0xff;
+    *p++ = p_data->model_id & 0xff;
+    *p++ = (p_data->model_id >> 8) & 0xff;
+    *p++ = p_data->app_key_idx & 0xff;
+    *p++ = (p_data->app_key_idx >> 8) & 0xff;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_SET, buffer, (uint16_t)(p - buffer));
+    mesh_hci_send(p_data->operation == OPERATION_BIND ? HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_APP_BIND : HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_APP_UNBIND, buffer, (uint16_t)(p - buffer));
+    return WICED_TRUE;
 }
 
-wiced_result_t wiced_bt_mesh_model_light_xyl_client_send_target_get(wiced_bt_mesh_event_t *p_event)
+wiced_bool_t wiced_bt_mesh_provision_local_device_set(wiced_bt_mesh_local_device_set_data_t *p_data)
 {
     uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
+    uint8_t *p = buffer;
+    *p++ = p_data->addr & 0xff;
+    *p++ = (p_data->addr >> 8) & 0xff;
+    memcpy(p, p_data->dev_key, 16);
+    p += 16;
+    memcpy(p, p_data->network_key, 16);
+    p += 16;
+    *p++ = p_data->net_key_idx & 0xff;
+    *p++ = (p_data->net_key_idx >> 8) & 0xff;
+    *p++ = p_data->iv_idx & 0xff;
+    *p++ = (p_data->iv_idx >> 8) & 0xff;
+    *p++ = (p_data->iv_idx >> 16) & 0xff;
+    *p++ = (p_data->iv_idx >> 24) & 0xff;
+    *p++ = p_data->key_refresh;
+    *p++ = p_data->iv_update;
+    *p++ = p_data->model_level_access;
 
-    if (p == NULL)
-        return WICED_BT_BADARG;
+    return mesh_hci_send(HCI_CONTROL_MESH_COMMAND_SET_LOCAL_DEVICE, buffer, (uint16_t)(p - buffer));
+}
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_TARGET_GET, buffer, (uint16_t)(p - buffer));
+wiced_bool_t wiced_bt_mesh_config_model_publication_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_model_publication_set_data_t *p_set)
+{
+    return mesh_hci_send_config_command(p_event, &mesh_hci_cmd_model_publication_set, p_set);
 }
 
-wiced_result_t wiced_bt_mesh_model_light_xyl_client_send_range_get(wiced_bt_mesh_event_t *p_event)
+wiced_bool_t wiced_bt_mesh_config_model_subscription_change(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_model_subscription_change_data_t *p_data)
 {
+    uint16_t hci_opcode = 0;
     uint8_t buffer[128];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
 
-    wiced_bt_mesh_release_event(p_event);
-
     if (p == NULL)
-        return WICED_BT_BADARG;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_RANGE_GET, buffer, (uint16_t)(p - buffer));
+    {
+        wiced_bt_mesh_release_event(p_event);
+        return WICED_FALSE;
+    }
+    *p++ = p_data->element_addr & 0xff;
+    *p++ = (p_data->element_addr >> 8) & 0xff;
+    *p++ = p_data->company_id & 0xff;
+    *p++ = (p_data->company_id >> 8) & 0xff;
+    *p++ = p_data->model_id & 0xff;
+    *p++ = (p_data->model_id >> 8) & 0xff;
+    memcpy(p, p_data->addr, 16);
+    switch (p_data->operation)
+    {
+    case OPERATION_ADD:
+        Log("Model Sub Add addr:%04x elem:%x model:%x addr:%04x", p_event->dst, p_data->element_addr, p_data->model_id, p_data->addr[0] + (p_data->addr[1] << 8));
+        hci_opcode = HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_SUBSCRIPTION_ADD;
+        p += 16;
+        break;
+    case OPERATION_OVERWRITE:
+        Log("Model Sub Overwrite addr:%04x elem:%x model:%x addr:%04x", p_event->dst, p_data->element_addr, p_data->model_id, p_data->addr[0] + (p_data->addr[1] << 8));
+        hci_opcode = HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_SUBSCRIPTION_OVERWRITE;
+        p += 16;
+        break;
+    case OPERATION_DELETE:
+        Log("Model Sub Delete addr:%04x elem:%x model:%x addr:%04x", p_event->dst, p_data->element_addr, p_data->model_id, p_data->addr[0] + (p_data->addr[1] << 8));
+        hci_opcode = HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_SUBSCRIPTION_DELETE;
+        p += 16;
+        break;
+    case OPERATION_DELETE_ALL:
+        Log("Model Sub DeleteAll addr:%04x elem:%x model:%x", p_event->dst, p_data->element_addr, p_data->model_id);
+        hci_opcode = HCI_CONTROL_MESH_COMMAND_CONFIG_MODEL_SUBSCRIPTION_DELETE_ALL;
+        break;
+    }
+    mesh_hci_send(hci_opcode, buffer, (uint16_t)(p - buffer));
+    return WICED_TRUE;
 }
 
-wiced_result_t wiced_bt_mesh_model_light_xyl_client_send_range_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_xyl_range_set_data_t *p_data)
+wiced_bool_t wiced_bt_mesh_config_network_transmit_params_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_network_transmit_set_data_t *p_data)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    return mesh_hci_send_config_command(p_event, &mesh_hci_cmd_network_transmit_set, p_data);
+}
 
-    wiced_bt_mesh_release_event(p_event);
+wiced_bool_t wiced_bt_mesh_config_default_ttl_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_default_ttl_set_data_t *p_data)
+{
+    return mesh_hci_send_config_command(p_event, &mesh_hci_cmd_default_ttl_set, p_data);
+}
 
-    if (p == NULL)
-        return WICED_BT_BADARG;
+wiced_bool_t wiced_bt_mesh_config_relay_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_relay_set_data_t *p_data)
+{
+    return mesh_hci_send_config_command(p_event, &mesh_hci_cmd_relay_set, p_data);
+}
 
-    *p++ = p_data->x_min & 0xff;
-    *p++ = (p_data->x_min >> 8) & 0xff;
-    *p++ = p_data->x_max & 0xff;
-    *p++ = (p_data->x_max >> 8) & 0xff;
-    *p++ = p_data->y_min & 0xff;
-    *p++ = (p_data->y_min >> 8) & 0xff;
-    *p++ = p_data->y_max & 0xff;
-    *p++ = (p_data->y_max >> 8) & 0xff;
+wiced_bool_t wiced_bt_mesh_config_friend_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_friend_set_data_t *p_data)
+{
+    return mesh_hci_send_config_command(p_event, &mesh_hci_cmd_friend_set, p_data);
+}
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_RANGE_SET, buffer, (uint16_t)(p - buffer));
+wiced_bool_t wiced_bt_mesh_config_gatt_proxy_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_gatt_proxy_set_data_t *p_data)
+{
+    return mesh_hci_send_config_command(p_event, &mesh_hci_cmd_gatt_proxy_set, p_data);
 }
 
-wiced_result_t wiced_bt_mesh_model_light_xyl_client_send_default_get(wiced_bt_mesh_event_t *p_event)
+wiced_bool_t wiced_bt_mesh_config_beacon_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_beacon_set_data_t *p_data)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    return mesh_hci_send_config_command(p_event, &mesh_hci_cmd_beacon_set, p_data);
+}
 
-    wiced_bt_mesh_release_event(p_event);
+wiced_bool_t wiced_bt_mesh_config_node_reset(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_config_command(p_event, &mesh_hci_cmd_node_reset, NULL);
+}
 
-    if (p == NULL)
-        return WICED_BT_BADARG;
+wiced_bool_t wiced_bt_mesh_health_attention_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_health_attention_set_data_t *p_set)
+{
+    return mesh_hci_send_config_command(p_event, &mesh_hci_cmd_health_attention_set, p_set);
+}
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_DEFAULT_GET, buffer, (uint16_t)(p - buffer));
+wiced_bool_t wiced_bt_mesh_config_node_identity_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_node_identity_set_data_t *p_set)
+{
+    return mesh_hci_send_config_command(p_event, &mesh_hci_cmd_node_identity_set, p_set);
 }
 
-wiced_result_t wiced_bt_mesh_model_light_xyl_client_send_default_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_xyl_default_data_t *p_data)
+#ifdef PRIVATE_PROXY_SUPPORTED
+wiced_bool_t wiced_bt_mesh_config_private_gatt_proxy_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_private_gatt_proxy_set_data_t *p_data)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    return mesh_hci_send_config_command(p_event, &mesh_hci_cmd_private_gatt_proxy_set, p_data);
+}
 
-    wiced_bt_mesh_release_event(p_event);
+wiced_bool_t wiced_bt_mesh_config_private_beacon_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_private_beacon_set_data_t *p_data)
+{
+    return mesh_hci_send_config_command(p_event, &mesh_hci_cmd_private_beacon_set, p_data);
+}
 
-    if (p == NULL)
-        return WICED_BT_BADARG;
+wiced_bool_t wiced_bt_mesh_config_private_node_identity_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_private_node_identity_set_data_t *p_set)
+{
+    return mesh_hci_send_config_command(p_event, &mesh_hci_cmd_private_node_identity_set, p_set);
+}
 
-    *p++ = p_data->default_status.lightness & 0xff;
-    *p++ = (p_data->default_status.lightness >> 8) & 0xff;
-    *p++ = p_data->default_status.x & 0xff;
-    *p++ = (p_data->default_status.x >> 8) & 0xff;
-    *p++ = p_data->default_status.y & 0xff;
-    *p++ = (p_data->default_status.y >> 8) & 0xff;
+wiced_bool_t wiced_bt_mesh_config_on_demand_private_proxy_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_config_on_demand_private_proxy_set_data_t *p_data)
+{
+    return mesh_hci_send_config_command(p_event, &mesh_hci_cmd_on_demand_private_proxy_set, p_data);
+}
+#endif
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_XYL_DEFAULT_SET, buffer, (uint16_t)(p - buffer));
+wiced_bool_t wiced_bt_mesh_lpn_poll_timeout_get(wiced_bt_mesh_event_t* p_event, wiced_bt_mesh_lpn_poll_timeout_get_data_t* p_get)
+{
+    return mesh_hci_send_config_command(p_event, &mesh_hci_cmd_lpn_poll_timeout_get, p_get);
 }
 
-wiced_result_t wiced_bt_mesh_model_location_client_send_global_get(wiced_bt_mesh_event_t *p_event)
+
+wiced_bool_t wiced_bt_mesh_proxy_filter_change_addr(wiced_bt_mesh_event_t *p_event, wiced_bool_t is_add, wiced_bt_mesh_proxy_filter_change_addr_data_t *p_addr)
 {
     uint8_t buffer[128];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    int i;
 
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
+    if ((p == NULL) || (p_addr->addr_num > sizeof(buffer) / 2))
+        return WICED_FALSE;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LOCATION_GLOBAL_GET, buffer, (uint16_t)(p - buffer));
+    for (i = 0; i < p_addr->addr_num; i++)
+    {
+        *p++ = p_addr->addr[i] & 0xff;
+        *p++ = (p_addr->addr[i] >> 8) & 0xff;
+    }
+    mesh_hci_send(is_add ? HCI_CONTROL_MESH_COMMAND_PROXY_FILTER_ADDRESSES_ADD : HCI_CONTROL_MESH_COMMAND_PROXY_FILTER_ADDRESSES_DELETE, buffer, (uint16_t)(p - buffer));
+    return WICED_TRUE;
 }
 
-wiced_result_t wiced_bt_mesh_model_location_client_send_local_get(wiced_bt_mesh_event_t *p_event)
+wiced_bool_t wiced_bt_mesh_provision_scan_capabilities_get(wiced_bt_mesh_event_t *p_event)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
+    return mesh_hci_send_config_command(p_event, &mesh_hci_cmd_provision_scan_capabilities_get, NULL);
+}
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LOCATION_LOCAL_GET, buffer, (uint16_t)(p - buffer));
+wiced_bool_t wiced_bt_mesh_provision_scan_get(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_config_command(p_event, &mesh_hci_cmd_provision_scan_get, NULL);
 }
 
-wiced_result_t wiced_bt_mesh_model_location_client_send_global_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_location_global_data_t *p_data)
+/*
+* Send Remote Provisioning Scan Start to Remote Provisioning Server
+*/
+wiced_bool_t wiced_bt_mesh_provision_scan_start(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_provision_scan_start_data_t *p_data)
 {
-    uint8_t buffer[128];
+    uint8_t  buffer[35];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
 
     wiced_bt_mesh_release_event(p_event);
 
     if (p == NULL)
-        return WICED_BT_BADARG;
+        return WICED_FALSE;
 
-    *p++ = p_data->global_latitude & 0xff;
-    *p++ = (p_data->global_latitude >> 8) & 0xff;
-    *p++ = (p_data->global_latitude >> 16) & 0xff;
-    *p++ = (p_data->global_latitude >> 24) & 0xff;
-    *p++ = p_data->global_longitude & 0xff;
-    *p++ = (p_data->global_longitude >> 8) & 0xff;
-    *p++ = (p_data->global_longitude >> 16) & 0xff;
-    *p++ = (p_data->global_longitude >> 24) & 0xff;
-    *p++ = p_data->global_altitude & 0xff;
-    *p++ = (p_data->global_altitude >> 8) & 0xff;
+    *p++ = p_data->scanned_items_limit;
+    *p++ = p_data->timeout;
+    if (p_data->scan_single_uuid)
+    {
+        memcpy(p, p_data->uuid, MESH_DEVICE_UUID_LEN);
+        p += MESH_DEVICE_UUID_LEN;
+    }
+    mesh_hci_send(HCI_CONTROL_MESH_COMMAND_PROVISION_SCAN_START, buffer, (uint16_t)(p - buffer));
+    return WICED_TRUE;
+}
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LOCATION_GLOBAL_SET, buffer, (uint16_t)(p - buffer));
+/*
+* Send Remote Provisioning Scan Stop to Remote Provisioning Server
+*/
+wiced_bool_t wiced_bt_mesh_provision_scan_stop(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_config_command(p_event, &mesh_hci_cmd_provision_scan_stop, NULL);
 }
 
-wiced_result_t wiced_bt_mesh_model_location_client_send_local_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_location_local_data_t *p_data)
+/*
+ * Send Remote Provisioning Scan Extended Scan Start to Remote Provisioning Server
+ */
+wiced_bool_t wiced_bt_mesh_provision_scan_extended_start(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_provision_scan_extended_start_t *p_data)
 {
-    uint8_t buffer[128];
+    int i;
+    uint8_t  buffer[50];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
 
     wiced_bt_mesh_release_event(p_event);
 
     if (p == NULL)
-        return WICED_BT_BADARG;
-
-    *p++ = p_data->local_north & 0xff;
-    *p++ = (p_data->local_north >> 8) & 0xff;
-    *p++ = p_data->local_east & 0xff;
-    *p++ = (p_data->local_east >> 8) & 0xff;
-    *p++ = p_data->local_altitude & 0xff;
-    *p++ = (p_data->local_altitude >> 8) & 0xff;
-    *p++ = p_data->floor_number;
-    *p++ = p_data->is_mobile;
-    *p++ = p_data->update_time;
-    *p++ = p_data->precision;
+        return WICED_FALSE;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LOCATION_LOCAL_SET, buffer, (uint16_t)(p - buffer));
+    UINT8_TO_STREAM(p, p_data->num_ad_filters);
+    for (i = 0; i < p_data->num_ad_filters && i < WICED_BT_MESH_AD_FILTER_TYPES_MAX; i++)
+    {
+        UINT8_TO_STREAM(p, p_data->ad_filter_types[i]);
+    }
+    if (p_data->uuid_present)
+    {
+        memcpy(p, p_data->uuid, sizeof(p_data->uuid));
+        p += sizeof(p_data->uuid);
+        UINT8_TO_STREAM(p, p_data->timeout);
+    }
+    mesh_hci_send(HCI_CONTROL_MESH_COMMAND_PROVISION_SCAN_EXTENDED_START, buffer, (uint16_t)(p - buffer));
+    return WICED_TRUE;
 }
 
-wiced_result_t wiced_bt_mesh_model_power_level_client_send_get(wiced_bt_mesh_event_t *p_event)
+#ifdef OPCODES_AGGREGATOR_SUPPORTED
+static wiced_bt_mesh_agg_item_add_callback_t p_mesh_agg_item_add_callback = NULL;
+
+wiced_bool_t wiced_bt_mesh_opcodes_aggregator_start(uint16_t dst_addr, uint8_t dst_elem_idx, uint16_t app_key_idx, wiced_bool_t is_command, uint16_t element_addr, wiced_bt_mesh_agg_item_add_callback_t p_callback)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    uint8_t buffer[20], *p = buffer;
 
-    wiced_bt_mesh_release_event(p_event);
+    UINT16_TO_STREAM(p, dst_addr);
+    UINT8_TO_STREAM(p, dst_elem_idx);
+    UINT16_TO_STREAM(p, app_key_idx);
+    UINT8_TO_STREAM(p, is_command);
+    UINT16_TO_STREAM(p, element_addr);
 
-    if (p == NULL)
-        return WICED_BT_BADARG;
+    p_mesh_agg_item_add_callback = p_callback;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_GET, buffer, (uint16_t)(p - buffer));
+    mesh_hci_send(HCI_CONTROL_MESH_COMMAND_OPCODES_AGGREGATOR_START, buffer, (uint16_t)(p - buffer));
+    return WICED_TRUE;
 }
 
-wiced_result_t wiced_bt_mesh_model_power_level_client_send_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_power_level_set_level_t *p_data)
+wiced_bool_t wiced_bt_mesh_opcodes_aggregator_finish_and_send(uint8_t status)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
+    uint8_t buffer[20], *p = buffer;
 
-    if (p == NULL)
-        return WICED_BT_BADARG;
+    UINT8_TO_STREAM(p, status);
 
-    *p++ = p_data->level & 0xff;
-    *p++ = (p_data->level >> 8) & 0xff;
-    *p++ = p_data->transition_time & 0xff;
-    *p++ = (p_data->transition_time >> 8) & 0xff;
-    *p++ = (p_data->transition_time >> 16) & 0xff;
-    *p++ = (p_data->transition_time >> 24) & 0xff;
-    *p++ = p_data->delay & 0xff;
-    *p++ = (p_data->delay >> 8) & 0xff;
+    p_mesh_agg_item_add_callback = NULL;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_SET, buffer, (uint16_t)(p - buffer));
+    mesh_hci_send(HCI_CONTROL_MESH_COMMAND_OPCODES_AGGREGATOR_FINISH, buffer, (uint16_t)(p - buffer));
+    return WICED_TRUE;
 }
 
-wiced_result_t wiced_bt_mesh_model_power_level_client_send_last_get(wiced_bt_mesh_event_t *p_event)
+void process_opcodes_aggregator_add_status(uint8_t *p_buffer, uint16_t len)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
+    if (!p_buffer || len != 1)
+        return;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_LAST_GET, buffer, (uint16_t)(p - buffer));
+    if (p_mesh_agg_item_add_callback)
+        p_mesh_agg_item_add_callback(*p_buffer);
 }
+#endif
 
-wiced_result_t wiced_bt_mesh_model_power_level_client_send_default_get(wiced_bt_mesh_event_t *p_event)
+#ifdef MESH_DFU_ENABLED
+/*
+* Application can call this function to check node metadata.
+*/
+wiced_bool_t wiced_bt_mesh_dfu_metadata_check(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_dfu_metadata_check_data_t *p_data, wiced_bt_mesh_fw_provider_callback_t *p_callback)
 {
-    uint8_t buffer[128];
+    uint8_t  buffer[300];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
 
     wiced_bt_mesh_release_event(p_event);
 
     if (p == NULL)
-        return WICED_BT_BADARG;
+        return WICED_FALSE;
+
+    UINT8_TO_STREAM(p, p_data->index);
+    memcpy(p, p_data->metadata.data, p_data->metadata.len);
+    p += p_data->metadata.len;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_DEFAULT_GET, buffer, (uint16_t)(p - buffer));
+    mesh_hci_send(HCI_CONTROL_MESH_COMMAND_FW_UPDATE_METADATA_CHECK, buffer, (uint16_t)(p - buffer));
+    return WICED_TRUE;
 }
 
-wiced_result_t wiced_bt_mesh_model_power_level_client_send_default_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_power_default_data_t *p_data)
+/*
+ * The application can call this function to start firmware distribution procedure.
+ */
+wiced_bool_t wiced_bt_mesh_fw_provider_start(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_fw_distribution_start_data_t *p_data, wiced_bt_mesh_fw_provider_callback_t *p_callback)
 {
-    uint8_t buffer[128];
+    uint8_t buffer[1024];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
 
     wiced_bt_mesh_release_event(p_event);
 
     if (p == NULL)
-        return WICED_BT_BADARG;
+        return WICED_FALSE;
 
-    *p++ = p_data->power & 0xff;
-    *p++ = (p_data->power >> 8) & 0xff;
+    UINT8_TO_STREAM(p, p_data->firmware_id.fw_id_len);
+    memcpy(p, p_data->firmware_id.fw_id, p_data->firmware_id.fw_id_len);
+    p += p_data->firmware_id.fw_id_len;
+    UINT8_TO_STREAM(p, p_data->metadata.len);
+    memcpy(p, p_data->metadata.data, p_data->metadata.len);
+    p += p_data->metadata.len;
+    UINT32_TO_STREAM(p, p_data->firmware_size);
+    UINT16_TO_STREAM(p, p_data->proxy_addr);
+    UINT16_TO_STREAM(p, p_data->group_addr);
+    UINT16_TO_STREAM(p, p_data->group_size);
+    for (int i = 0; i < p_data->group_size; i++)
+    {
+        UINT16_TO_STREAM(p, p_data->update_nodes[i].addr);
+        UINT8_TO_STREAM(p, p_data->update_nodes[i].low_power);
+    }
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_DEFAULT_SET, buffer, (uint16_t)(p - buffer));
+    mesh_hci_send(HCI_CONTROL_MESH_COMMAND_FW_DISTRIBUTION_START, buffer, (uint16_t)(p - buffer));
+    return WICED_TRUE;
 }
 
-wiced_result_t wiced_bt_mesh_model_power_level_client_send_range_get(wiced_bt_mesh_event_t *p_event)
+/*
+* The application can call this function to suspend firmware distribution procedure.
+*/
+wiced_bool_t wiced_bt_mesh_fw_provider_suspend(wiced_bt_mesh_event_t *p_event)
 {
     uint8_t buffer[128];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
@@ -2668,12 +2877,16 @@ wiced_result_t wiced_bt_mesh_model_power_level_client_send_range_get(wiced_bt_me
     wiced_bt_mesh_release_event(p_event);
 
     if (p == NULL)
-        return WICED_BT_BADARG;
+        return WICED_FALSE;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_RANGE_GET, buffer, (uint16_t)(p - buffer));
+    mesh_hci_send(HCI_CONTROL_MESH_COMMAND_FW_DISTRIBUTION_SUSPEND, buffer, (uint16_t)(p - buffer));
+    return WICED_TRUE;
 }
 
-wiced_result_t wiced_bt_mesh_model_power_level_client_send_range_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_power_level_range_set_data_t *p_data)
+/*
+* The application can call this function to resume firmware distribution procedure.
+*/
+wiced_bool_t wiced_bt_mesh_fw_provider_resume(wiced_bt_mesh_event_t *p_event)
 {
     uint8_t buffer[128];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
@@ -2681,17 +2894,16 @@ wiced_result_t wiced_bt_mesh_model_power_level_client_send_range_set(wiced_bt_me
     wiced_bt_mesh_release_event(p_event);
 
     if (p == NULL)
-        return WICED_BT_BADARG;
-
-    *p++ = p_data->power_min & 0xff;
-    *p++ = (p_data->power_min >> 8) & 0xff;
-    *p++ = p_data->power_max & 0xff;
-    *p++ = (p_data->power_max >> 8) & 0xff;
+        return WICED_FALSE;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_POWER_LEVEL_RANGE_SET, buffer, (uint16_t)(p - buffer));
+    mesh_hci_send(HCI_CONTROL_MESH_COMMAND_FW_DISTRIBUTION_RESUME, buffer, (uint16_t)(p - buffer));
+    return WICED_TRUE;
 }
 
-wiced_result_t  wiced_bt_mesh_model_power_onoff_client_send_onpowerup_get(wiced_bt_mesh_event_t *p_event)
+/*
+* The application can call this function to terminate firmware distribution procedure.
+*/
+wiced_bool_t wiced_bt_mesh_fw_provider_stop(wiced_bt_mesh_event_t *p_event)
 {
     uint8_t buffer[128];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
@@ -2699,12 +2911,17 @@ wiced_result_t  wiced_bt_mesh_model_power_onoff_client_send_onpowerup_get(wiced_
     wiced_bt_mesh_release_event(p_event);
 
     if (p == NULL)
-        return WICED_BT_BADARG;
+        return WICED_FALSE;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_ONPOWERUP_GET, buffer, (uint16_t)(p - buffer));
+    mesh_hci_send(HCI_CONTROL_MESH_COMMAND_FW_DISTRIBUTION_STOP, buffer, (uint16_t)(p - buffer));
+    return WICED_TRUE;
 }
 
-wiced_result_t wiced_bt_mesh_model_power_onoff_client_send_onpowerup_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_power_onoff_data_t *p_data)
+/*
+* The application can call this function to get the state of the current firmware distribution process.
+* The function may register a callback which will be executed when reply from the distributor is received.
+*/
+wiced_bool_t wiced_bt_mesh_fw_provider_get_status(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_fw_provider_callback_t *p_callback)
 {
     uint8_t buffer[128];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
@@ -2712,88 +2929,73 @@ wiced_result_t wiced_bt_mesh_model_power_onoff_client_send_onpowerup_set(wiced_b
     wiced_bt_mesh_release_event(p_event);
 
     if (p == NULL)
-        return WICED_BT_BADARG;
-
-    *p++ = p_data->on_power_up;
+        return WICED_FALSE;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_ONPOWERUP_SET, buffer, (uint16_t)(p - buffer));
+    mesh_hci_send(HCI_CONTROL_MESH_COMMAND_FW_DISTRIBUTION_GET_STATUS, buffer, (uint16_t)(p - buffer));
+    return WICED_TRUE;
 }
 
-wiced_result_t wiced_bt_mesh_model_scheduler_client_send_get(wiced_bt_mesh_event_t *p_event)
+/*
+ * Process finish event received from OTA client
+ */
+void wiced_bt_mesh_fw_provider_ota_finish(uint8_t status)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
+}
+#endif
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_SCHEDULER_GET, buffer, (uint16_t)(p - buffer));
+/*
+ * Encrypt or decrypts and authenticates data
+ */
+uint16_t wiced_bt_mesh_core_crypt(wiced_bool_t encrypt, const uint8_t *p_in_data, uint16_t in_data_len, uint8_t *p_out_buf, uint16_t out_buf_len)
+{
+    return out_buf_len;
 }
 
-wiced_result_t wiced_bt_mesh_model_scheduler_client_send_action_get(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_scheduler_action_get_t *p_data)
+
+wiced_result_t wiced_bt_mesh_model_default_transition_time_client_send_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_default_transition_time_data_t* p_data)
 {
     uint8_t buffer[128];
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
 
-    wiced_bt_mesh_release_event(p_event);
-
     if (p == NULL)
         return WICED_BT_BADARG;
 
-    *p++ = p_data->action_number;
+    *p++ = p_data->time & 0xff;
+    *p++ = (p_data->time >> 8) & 0xff;
+    *p++ = (p_data->time >> 16) & 0xff;
+    *p++ = (p_data->time >> 24) & 0xff;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_SCHEDULER_ACTION_GET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send(HCI_CONTROL_MESH_COMMAND_DEF_TRANS_TIME_SET, buffer, (uint16_t)(p - buffer)) ? WICED_BT_SUCCESS : WICED_BT_ERROR;
 }
 
-wiced_result_t wiced_bt_mesh_model_scheduler_client_send_action_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_scheduler_action_data_t *p_data)
+wiced_result_t wiced_bt_mesh_model_onoff_client_send_get(wiced_bt_mesh_event_t *p_event)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
-
-    *p++ = p_data->action_number;
-    *p++ = p_data->year;
-    *p++ = p_data->month & 0xff;
-    *p++ = (p_data->month >> 8) & 0xff;
-    *p++ = p_data->day;
-    *p++ = p_data->hour;
-    *p++ = p_data->minute;
-    *p++ = p_data->second;
-    *p++ = p_data->day_of_week;
-    *p++ = p_data->action;
-    *p++ = p_data->transition_time & 0xff;
-    *p++ = (p_data->transition_time >> 8) & 0xff;
-    *p++ = (p_data->transition_time >> 16) & 0xff;
-    *p++ = (p_data->transition_time >> 24) & 0xff;
-    *p++ = p_data->scene_number & 0xff;
-    *p++ = (p_data->scene_number >> 8) & 0xff;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_SCHEDULER_ACTION_SET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_onoff_get, NULL);
 }
 
-wiced_result_t wiced_bt_mesh_model_time_client_time_get_send(wiced_bt_mesh_event_t *p_event)
+wiced_result_t wiced_bt_mesh_model_onoff_client_send_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_onoff_set_data_t *p_data)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_onoff_set, p_data);
+}
 
-    wiced_bt_mesh_release_event(p_event);
+wiced_result_t wiced_bt_mesh_battery_client_send_get(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_battery_get, NULL);
+}
 
-    if (p == NULL)
-        return WICED_BT_BADARG;
+wiced_result_t wiced_bt_mesh_model_property_client_send_properties_get(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_properties_get_data_t *p_data)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_properties_get, p_data);
+}
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_TIME_GET, buffer, (uint16_t)(p - buffer));
+wiced_result_t wiced_bt_mesh_model_property_client_send_property_get(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_property_get_data_t *p_data)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_property_get, p_data);
 }
 
-wiced_result_t wiced_bt_mesh_model_time_client_time_set_send(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_time_state_msg_t *p_data)
+wiced_result_t wiced_bt_mesh_model_property_client_send_property_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_property_set_data_t *p_data)
 {
     uint8_t buffer[128];
-    uint16_t auth_delta;
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
 
     wiced_bt_mesh_release_event(p_event);
@@ -2801,64 +3003,57 @@ wiced_result_t wiced_bt_mesh_model_time_client_time_set_send(wiced_bt_mesh_event
     if (p == NULL)
         return WICED_BT_BADARG;
 
-    UINT40_TO_STREAM(p, p_data->tai_seconds);
-    UINT8_TO_STREAM(p, p_data->subsecond);
-    UINT8_TO_STREAM(p, p_data->uncertainty);
-    auth_delta = p_data->tai_utc_delta_current << 1;
-    auth_delta = auth_delta | (uint16_t)(p_data->time_authority ? 1 : 0 );
-    UINT16_TO_STREAM(p, auth_delta);
-    UINT8_TO_STREAM(p, p_data->time_zone_offset_current);
+    *p++ = p_data->type;
+    *p++ = p_data->id & 0xff;
+    *p++ = (p_data->id >> 8) & 0xff;
+    *p++ = p_data->access;
+    *p++ = p_data->len & 0xff;
+    *p++ = (p_data->len >> 8) & 0xff;
+
+    memcpy(p, p_data->value, p_data->len);
+    p += p_data->len;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_TIME_SET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send(HCI_CONTROL_MESH_COMMAND_PROPERTY_SET, buffer, (uint16_t)(p - buffer));
 }
 
-wiced_result_t wiced_bt_mesh_model_time_client_time_zone_get_send(wiced_bt_mesh_event_t *p_event)
+wiced_result_t wiced_bt_mesh_model_light_lc_client_send_mode_get(wiced_bt_mesh_event_t *p_event)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_TIME_ZONE_GET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_lc_mode_get, NULL);
 }
 
-wiced_result_t wiced_bt_mesh_model_time_client_time_zone_set_send(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_time_zone_set_t *p_data)
+wiced_result_t wiced_bt_mesh_model_light_lc_client_send_mode_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_lc_mode_set_data_t *p_data)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
-
-    UINT8_TO_STREAM(p, p_data->time_zone_offset_new);
-    UINT40_TO_STREAM(p, p_data->tai_of_zone_change);
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_lc_mode_set, p_data);
+}
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_TIME_ZONE_SET, buffer, (uint16_t)(p - buffer));
+wiced_result_t wiced_bt_mesh_model_light_lc_client_send_occupancy_mode_get(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_lc_occupancy_mode_get, NULL);
 }
 
-wiced_result_t wiced_bt_mesh_model_time_client_tai_utc_delta_get_send(wiced_bt_mesh_event_t *p_event)
+wiced_result_t wiced_bt_mesh_model_light_lc_client_send_occupancy_mode_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_lc_occupancy_mode_set_data_t *p_data)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_lc_occupancy_mode_set, p_data);
+}
 
-    wiced_bt_mesh_release_event(p_event);
+wiced_result_t wiced_bt_mesh_model_light_lc_client_send_light_onoff_get(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_lc_light_onoff_get, NULL);
+}
 
-    if (p == NULL)
-        return WICED_BT_BADARG;
+wiced_result_t wiced_bt_mesh_model_light_lc_client_send_light_onoff_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_lc_light_onoff_set_data_t *p_data)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_lc_light_onoff_set, p_data);
+}
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_GET, buffer, (uint16_t)(p - buffer));
+wiced_result_t wiced_bt_mesh_model_light_lc_client_send_property_get(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_lc_property_get_data_t *p_data)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_lc_property_get, p_data);
 }
 
-wiced_result_t wiced_bt_mesh_model_time_client_tai_utc_delta_set_send(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_time_tai_utc_delta_set_t *p_data)
+wiced_result_t wiced_bt_mesh_model_light_lc_client_send_property_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_lc_property_set_data_t *p_data)
 {
     uint8_t buffer[128];
-    uint16_t delta_new;
-
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
 
     wiced_bt_mesh_release_event(p_event);
@@ -2866,104 +3061,140 @@ wiced_result_t wiced_bt_mesh_model_time_client_tai_utc_delta_set_send(wiced_bt_m
     if (p == NULL)
         return WICED_BT_BADARG;
 
-    delta_new = p_data->tai_utc_delta_new & (~(1 << 15));
-    UINT16_TO_STREAM(p, delta_new);
-    UINT40_TO_STREAM(p, p_data->tai_of_delta_change);
+    *p++ = p_data->id & 0xff;
+    *p++ = (p_data->id >> 8) & 0xff;
+    *p++ = p_data->len & 0xff;
+    *p++ = (p_data->len >> 8) & 0xff;
+    memcpy(p, p_data->value, p_data->len);
+    p += p_data->len;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_SET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_LC_PROPERTY_SET, buffer, (uint16_t)(p - buffer));
 }
 
-wiced_result_t wiced_bt_mesh_model_time_client_time_role_get_send(wiced_bt_mesh_event_t *p_event)
+wiced_result_t wiced_bt_mesh_model_light_xyl_client_send_get(wiced_bt_mesh_event_t *p_event)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_xyl_get, NULL);
+}
 
-    wiced_bt_mesh_release_event(p_event);
+wiced_result_t wiced_bt_mesh_model_light_xyl_client_send_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_xyl_set_t *p_data)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_xyl_set, p_data);
+}
 
-    if (p == NULL)
-        return WICED_BT_BADARG;
+wiced_result_t wiced_bt_mesh_model_light_xyl_client_send_target_get(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_xyl_target_get, NULL);
+}
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_TIME_ROLE_GET, buffer, (uint16_t)(p - buffer));
+wiced_result_t wiced_bt_mesh_model_light_xyl_client_send_range_get(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_xyl_range_get, NULL);
 }
 
-wiced_result_t wiced_bt_mesh_model_time_client_time_role_set_send(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_time_role_msg_t *p_data)
+wiced_result_t wiced_bt_mesh_model_light_xyl_client_send_range_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_xyl_range_set_data_t *p_data)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_xyl_range_set, p_data);
+}
 
-    wiced_bt_mesh_release_event(p_event);
+wiced_result_t wiced_bt_mesh_model_light_xyl_client_send_default_get(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_xyl_default_get, NULL);
+}
 
-    if (p == NULL)
-        return WICED_BT_BADARG;
+wiced_result_t wiced_bt_mesh_model_light_xyl_client_send_default_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_xyl_default_data_t *p_data)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_xyl_default_set, p_data);
+}
 
-    UINT8_TO_STREAM(p, p_data->role);
+wiced_result_t wiced_bt_mesh_model_location_client_send_global_get(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_location_global_get, NULL);
+}
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_TIME_ROLE_SET, buffer, (uint16_t)(p - buffer));
+wiced_result_t wiced_bt_mesh_model_location_client_send_local_get(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_location_local_get, NULL);
 }
 
-wiced_result_t wiced_bt_mesh_model_level_client_send_get(wiced_bt_mesh_event_t *p_event)
+wiced_result_t wiced_bt_mesh_model_location_client_send_global_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_location_global_data_t *p_data)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_location_global_set, p_data);
+}
 
-    wiced_bt_mesh_release_event(p_event);
+wiced_result_t wiced_bt_mesh_model_location_client_send_local_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_location_local_data_t *p_data)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_location_local_set, p_data);
+}
 
-    if (p == NULL)
-        return WICED_BT_BADARG;
+wiced_result_t wiced_bt_mesh_model_power_level_client_send_get(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_power_level_get, NULL);
+}
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LEVEL_GET, buffer, (uint16_t)(p - buffer));
+wiced_result_t wiced_bt_mesh_model_power_level_client_send_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_power_level_set_level_t *p_data)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_power_level_set, p_data);
 }
 
-wiced_result_t wiced_bt_mesh_model_level_client_send_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_level_set_level_t *p_data)
+wiced_result_t wiced_bt_mesh_model_power_level_client_send_last_get(wiced_bt_mesh_event_t *p_event)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_power_level_last_get, NULL);
+}
 
-    wiced_bt_mesh_release_event(p_event);
+wiced_result_t wiced_bt_mesh_model_power_level_client_send_default_get(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_power_level_default_get, NULL);
+}
 
-    if (p == NULL)
-        return WICED_BT_BADARG;
+wiced_result_t wiced_bt_mesh_model_power_level_client_send_default_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_power_default_data_t *p_data)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_power_level_default_set, p_data);
+}
 
-    *p++ = p_data->level & 0xff;
-    *p++ = (p_data->level >> 8) & 0xff;
-    *p++ = p_data->transition_time & 0xff;
-    *p++ = (p_data->transition_time >> 8) & 0xff;
-    *p++ = (p_data->transition_time >> 16) & 0xff;
-    *p++ = (p_data->transition_time >> 24) & 0xff;
-    *p++ = p_data->delay & 0xff;
-    *p++ = (p_data->delay >> 8) & 0xff;
+wiced_result_t wiced_bt_mesh_model_power_level_client_send_range_get(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_power_level_range_get, NULL);
+}
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LEVEL_SET, buffer, (uint16_t)(p - buffer));
+wiced_result_t wiced_bt_mesh_model_power_level_client_send_range_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_power_level_range_set_data_t *p_data)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_power_level_range_set, p_data);
 }
 
-wiced_result_t wiced_bt_mesh_model_level_client_send_delta_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_level_set_delta_t* p_data)
+wiced_result_t wiced_bt_mesh_model_power_onoff_client_send_onpowerup_get(wiced_bt_mesh_event_t *p_event)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_onpowerup_get, NULL);
+}
 
-    wiced_bt_mesh_release_event(p_event);
+wiced_result_t wiced_bt_mesh_model_power_onoff_client_send_onpowerup_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_power_onoff_data_t *p_data)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_onpowerup_set, p_data);
+}
 
-    if (p == NULL)
-        return WICED_BT_BADARG;
+wiced_result_t wiced_bt_mesh_model_scheduler_client_send_get(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_scheduler_get, NULL);
+}
+
+wiced_result_t wiced_bt_mesh_model_scheduler_client_send_action_get(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_scheduler_action_get_t *p_data)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_scheduler_action_get, p_data);
+}
 
-    *p++ = p_data->delta & 0xff;
-    *p++ = (p_data->delta >> 8) & 0xff;
-    *p++ = (p_data->delta >> 16) & 0xff;
-    *p++ = (p_data->delta >> 24) & 0xff;
-    *p++ = p_data->continuation;
-    *p++ = p_data->transition_time & 0xff;
-    *p++ = (p_data->transition_time >> 8) & 0xff;
-    *p++ = (p_data->transition_time >> 16) & 0xff;
-    *p++ = (p_data->transition_time >> 24) & 0xff;
-    *p++ = p_data->delay & 0xff;
-    *p++ = (p_data->delay >> 8) & 0xff;
+wiced_result_t wiced_bt_mesh_model_scheduler_client_send_action_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_scheduler_action_data_t *p_data)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_scheduler_action_set, p_data);
+}
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LEVEL_DELTA_SET, buffer, (uint16_t)(p - buffer));
+wiced_result_t wiced_bt_mesh_model_time_client_time_get_send(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_time_get, NULL);
 }
 
-wiced_result_t wiced_bt_mesh_model_level_client_send_move_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_level_set_move_t* p_data)
+wiced_result_t wiced_bt_mesh_model_time_client_time_set_send(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_time_state_msg_t *p_data)
 {
     uint8_t buffer[128];
+    uint16_t auth_delta;
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
 
     wiced_bt_mesh_release_event(p_event);
@@ -2971,35 +3202,37 @@ wiced_result_t wiced_bt_mesh_model_level_client_send_move_set(wiced_bt_mesh_even
     if (p == NULL)
         return WICED_BT_BADARG;
 
-    *p++ = p_data->delta & 0xff;
-    *p++ = (p_data->delta >> 8) & 0xff;
-    *p++ = p_data->continuation;
-    *p++ = p_data->transition_time & 0xff;
-    *p++ = (p_data->transition_time >> 8) & 0xff;
-    *p++ = (p_data->transition_time >> 16) & 0xff;
-    *p++ = (p_data->transition_time >> 24) & 0xff;
-    *p++ = p_data->delay & 0xff;
-    *p++ = (p_data->delay >> 8) & 0xff;
+    UINT40_TO_STREAM(p, p_data->tai_seconds);
+    UINT8_TO_STREAM(p, p_data->subsecond);
+    UINT8_TO_STREAM(p, p_data->uncertainty);
+    auth_delta = p_data->tai_utc_delta_current << 1;
+    auth_delta = auth_delta | (uint16_t)(p_data->time_authority ? 1 : 0 );
+    UINT16_TO_STREAM(p, auth_delta);
+    UINT8_TO_STREAM(p, p_data->time_zone_offset_current);
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LEVEL_MOVE_SET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send(HCI_CONTROL_MESH_COMMAND_TIME_SET, buffer, (uint16_t)(p - buffer));
 }
 
-wiced_result_t wiced_bt_mesh_model_light_lightness_client_send_get(wiced_bt_mesh_event_t *p_event)
+wiced_result_t wiced_bt_mesh_model_time_client_time_zone_get_send(wiced_bt_mesh_event_t *p_event)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_time_zone_get, NULL);
+}
 
-    if (p == NULL)
-        return WICED_BT_BADARG;
+wiced_result_t wiced_bt_mesh_model_time_client_time_zone_set_send(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_time_zone_set_t *p_data)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_time_zone_set, p_data);
+}
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_LIGHTNESS_GET, buffer, (uint16_t)(p - buffer));
+wiced_result_t wiced_bt_mesh_model_time_client_tai_utc_delta_get_send(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_time_tai_utc_delta_get, NULL);
 }
 
-wiced_result_t wiced_bt_mesh_model_light_lightness_client_send_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_lightness_actual_set_t* p_data)
+wiced_result_t wiced_bt_mesh_model_time_client_tai_utc_delta_set_send(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_time_tai_utc_delta_set_t *p_data)
 {
     uint8_t buffer[128];
+    uint16_t delta_new;
+
     uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
 
     wiced_bt_mesh_release_event(p_event);
@@ -3007,245 +3240,116 @@ wiced_result_t wiced_bt_mesh_model_light_lightness_client_send_set(wiced_bt_mesh
     if (p == NULL)
         return WICED_BT_BADARG;
 
-    *p++ = p_data->lightness_actual & 0xff;
-    *p++ = (p_data->lightness_actual >> 8) & 0xff;
-    *p++ = p_data->transition_time & 0xff;
-    *p++ = (p_data->transition_time >> 8) & 0xff;
-    *p++ = (p_data->transition_time >> 16) & 0xff;
-    *p++ = (p_data->transition_time >> 24) & 0xff;
-    *p++ = p_data->delay & 0xff;
-    *p++ = (p_data->delay >> 8) & 0xff;
+    delta_new = p_data->tai_utc_delta_new & (~(1 << 15));
+    UINT16_TO_STREAM(p, delta_new);
+    UINT40_TO_STREAM(p, p_data->tai_of_delta_change);
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_LIGHTNESS_SET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send(HCI_CONTROL_MESH_COMMAND_TIME_TAI_UTC_DELTA_SET, buffer, (uint16_t)(p - buffer));
 }
 
-wiced_result_t wiced_bt_mesh_model_light_hsl_client_send_get(wiced_bt_mesh_event_t *p_event)
+wiced_result_t wiced_bt_mesh_model_time_client_time_role_get_send(wiced_bt_mesh_event_t *p_event)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_time_role_get, NULL);
+}
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_GET, buffer, (uint16_t)(p - buffer));
+wiced_result_t wiced_bt_mesh_model_time_client_time_role_set_send(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_time_role_msg_t *p_data)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_time_role_set, p_data);
 }
 
-wiced_result_t wiced_bt_mesh_model_light_hsl_client_send_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_hsl_set_t* p_data)
+wiced_result_t wiced_bt_mesh_model_level_client_send_get(wiced_bt_mesh_event_t *p_event)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_level_get, NULL);
+}
 
-    wiced_bt_mesh_release_event(p_event);
+wiced_result_t wiced_bt_mesh_model_level_client_send_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_level_set_level_t *p_data)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_level_set, p_data);
+}
 
-    if (p == NULL)
-        return WICED_BT_BADARG;
+wiced_result_t wiced_bt_mesh_model_level_client_send_delta_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_level_set_delta_t* p_data)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_level_delta_set, p_data);
+}
 
-    *p++ = p_data->target.lightness & 0xff;
-    *p++ = (p_data->target.lightness >> 8) & 0xff;
-    *p++ = p_data->target.hue & 0xff;
-    *p++ = (p_data->target.hue >> 8) & 0xff;
-    *p++ = p_data->target.saturation & 0xff;
-    *p++ = (p_data->target.saturation >> 8) & 0xff;
-    *p++ = p_data->transition_time & 0xff;
-    *p++ = (p_data->transition_time >> 8) & 0xff;
-    *p++ = (p_data->transition_time >> 16) & 0xff;
-    *p++ = (p_data->transition_time >> 24) & 0xff;
-    *p++ = p_data->delay & 0xff;
-    *p++ = (p_data->delay >> 8) & 0xff;
+wiced_result_t wiced_bt_mesh_model_level_client_send_move_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_level_set_move_t* p_data)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_level_move_set, p_data);
+}
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_SET, buffer, (uint16_t)(p - buffer));
+wiced_result_t wiced_bt_mesh_model_light_lightness_client_send_get(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_lightness_get, NULL);
 }
 
-wiced_result_t wiced_bt_mesh_model_light_hsl_client_send_hue_get(wiced_bt_mesh_event_t *p_event)
+wiced_result_t wiced_bt_mesh_model_light_lightness_client_send_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_lightness_actual_set_t* p_data)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_lightness_set, p_data);
+}
 
-    wiced_bt_mesh_release_event(p_event);
+wiced_result_t wiced_bt_mesh_model_light_hsl_client_send_get(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_hsl_get, NULL);
+}
 
-    if (p == NULL)
-        return WICED_BT_BADARG;
+wiced_result_t wiced_bt_mesh_model_light_hsl_client_send_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_hsl_set_t* p_data)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_hsl_set, p_data);
+}
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_HUE_GET, buffer, (uint16_t)(p - buffer));
+wiced_result_t wiced_bt_mesh_model_light_hsl_client_send_hue_get(wiced_bt_mesh_event_t *p_event)
+{
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_hsl_hue_get, NULL);
 }
 
 wiced_result_t wiced_bt_mesh_model_light_hsl_client_send_hue_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_hsl_hue_set_t* p_data)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
-
-    *p++ = p_data->level & 0xff;
-    *p++ = (p_data->level >> 8) & 0xff;
-    *p++ = p_data->transition_time & 0xff;
-    *p++ = (p_data->transition_time >> 8) & 0xff;
-    *p++ = (p_data->transition_time >> 16) & 0xff;
-    *p++ = (p_data->transition_time >> 24) & 0xff;
-    *p++ = p_data->delay & 0xff;
-    *p++ = (p_data->delay >> 8) & 0xff;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_HUE_SET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_hsl_hue_set, p_data);
 }
 
 wiced_result_t wiced_bt_mesh_model_light_hsl_client_send_saturation_get(wiced_bt_mesh_event_t *p_event)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_SATURATION_GET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_hsl_saturation_get, NULL);
 }
 
 wiced_result_t wiced_bt_mesh_model_light_hsl_client_send_saturation_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_hsl_saturation_set_t* p_data)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
-
-    *p++ = p_data->level & 0xff;
-    *p++ = (p_data->level >> 8) & 0xff;
-    *p++ = p_data->transition_time & 0xff;
-    *p++ = (p_data->transition_time >> 8) & 0xff;
-    *p++ = (p_data->transition_time >> 16) & 0xff;
-    *p++ = (p_data->transition_time >> 24) & 0xff;
-    *p++ = p_data->delay & 0xff;
-    *p++ = (p_data->delay >> 8) & 0xff;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_SATURATION_SET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_hsl_saturation_set, p_data);
 }
 
 wiced_result_t wiced_bt_mesh_model_light_hsl_client_send_target_get(wiced_bt_mesh_event_t *p_event)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_TARGET_GET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_hsl_target_get, NULL);
 }
 
 wiced_result_t wiced_bt_mesh_model_light_hsl_client_send_default_get(wiced_bt_mesh_event_t *p_event)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_DEFAULT_GET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_hsl_default_get, NULL);
 }
 
 wiced_result_t wiced_bt_mesh_model_light_hsl_client_send_default_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_hsl_default_data_t* p_data)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
-
-    *p++ = p_data->default_status.lightness & 0xff;
-    *p++ = (p_data->default_status.lightness >> 8) & 0xff;
-    *p++ = p_data->default_status.hue & 0xff;
-    *p++ = (p_data->default_status.hue >> 8) & 0xff;
-    *p++ = p_data->default_status.saturation & 0xff;
-    *p++ = (p_data->default_status.saturation >> 8) & 0xff;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_DEFAULT_SET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_hsl_default_set, p_data);
 }
 
 wiced_result_t wiced_bt_mesh_model_light_hsl_client_send_range_get(wiced_bt_mesh_event_t *p_event)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_RANGE_GET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_hsl_range_get, NULL);
 }
 
 wiced_result_t wiced_bt_mesh_model_light_hsl_client_send_range_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_hsl_range_set_data_t* p_data)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
-
-    *p++ = p_data->hue_min & 0xff;
-    *p++ = (p_data->hue_min >> 8) & 0xff;
-    *p++ = p_data->hue_max & 0xff;
-    *p++ = (p_data->hue_max >> 8) & 0xff;
-    *p++ = p_data->saturation_min & 0xff;
-    *p++ = (p_data->saturation_min >> 8) & 0xff;
-    *p++ = p_data->saturation_max & 0xff;
-    *p++ = (p_data->saturation_min >> 8) & 0xff;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_HSL_RANGE_SET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_hsl_range_set, p_data);
 }
 
 wiced_result_t wiced_bt_mesh_model_light_ctl_client_send_get(wiced_bt_mesh_event_t *p_event)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_CTL_GET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_ctl_get, NULL);
 }
 
 wiced_result_t wiced_bt_mesh_model_light_ctl_client_send_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_light_ctl_set_t* p_data)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
-
-    *p++ = p_data->target.lightness & 0xff;
-    *p++ = (p_data->target.lightness >> 8) & 0xff;
-    *p++ = p_data->target.temperature & 0xff;
-    *p++ = (p_data->target.temperature >> 8) & 0xff;
-    *p++ = p_data->target.delta_uv & 0xff;
-    *p++ = (p_data->target.delta_uv >> 8) & 0xff;
-    *p++ = p_data->transition_time & 0xff;
-    *p++ = (p_data->transition_time >> 8) & 0xff;
-    *p++ = (p_data->transition_time >> 16) & 0xff;
-    *p++ = (p_data->transition_time >> 24) & 0xff;
-    *p++ = p_data->delay & 0xff;
-    *p++ = (p_data->delay >> 8) & 0xff;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_LIGHT_CTL_SET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_light_ctl_set, p_data);
 }
 
 wiced_result_t wiced_bt_mesh_model_sensor_client_descriptor_send_get(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_sensor_get_t *desc_get_data)
@@ -3264,7 +3368,7 @@ wiced_result_t wiced_bt_mesh_model_sensor_client_descriptor_send_get(wiced_bt_me
         *p++ = desc_get_data->property_id & 0xff;
         *p++ = (desc_get_data->property_id >> 8) & 0xff;
     }
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_SENSOR_DESCRIPTOR_GET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send(HCI_CONTROL_MESH_COMMAND_SENSOR_DESCRIPTOR_GET, buffer, (uint16_t)(p - buffer));
 }
 
 wiced_result_t wiced_bt_mesh_model_sensor_client_sensor_send_get(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_sensor_get_t *sensor_get)
@@ -3282,7 +3386,7 @@ wiced_result_t wiced_bt_mesh_model_sensor_client_sensor_send_get(wiced_bt_mesh_e
         *p++ = sensor_get->property_id & 0xff;
         *p++ = (sensor_get->property_id >> 8) & 0xff;
     }
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_SENSOR_GET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send(HCI_CONTROL_MESH_COMMAND_SENSOR_GET, buffer, (uint16_t)(p - buffer));
 }
 
 wiced_result_t wiced_bt_mesh_model_sensor_client_sensor_column_send_get(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_sensor_column_get_data_t *column_data)
@@ -3300,7 +3404,7 @@ wiced_result_t wiced_bt_mesh_model_sensor_client_sensor_column_send_get(wiced_bt
     memcpy(p, column_data->raw_valuex, column_data->prop_value_len);
     p += column_data->prop_value_len;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_SENSOR_COLUMN_GET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send(HCI_CONTROL_MESH_COMMAND_SENSOR_COLUMN_GET, buffer, (uint16_t)(p - buffer));
 }
 
 wiced_result_t wiced_bt_mesh_model_sensor_client_sensor_series_send_get(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_sensor_series_get_data_t *series_data)
@@ -3324,25 +3428,12 @@ wiced_result_t wiced_bt_mesh_model_sensor_client_sensor_series_send_get(wiced_bt
         memcpy(p, series_data->raw_valuex2, len);
         p += len;
     }
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_SENSOR_SERIES_GET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send(HCI_CONTROL_MESH_COMMAND_SENSOR_SERIES_GET, buffer, (uint16_t)(p - buffer));
 }
 
 wiced_result_t wiced_bt_mesh_model_sensor_client_sensor_setting_send_get(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_sensor_setting_get_data_t *setting_data)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
-
-    *p++ = setting_data->property_id & 0xff;
-    *p++ = (setting_data->property_id >> 8) & 0xff;
-    *p++ = setting_data->setting_property_id & 0xff;
-    *p++ = (setting_data->setting_property_id >> 8) & 0xff;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_SENSOR_SETTING_GET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_sensor_setting_get, setting_data);
 }
 
 wiced_result_t wiced_bt_mesh_model_sensor_client_sensor_setting_send_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_sensor_setting_set_data_t *setting_data)
@@ -3362,88 +3453,22 @@ wiced_result_t wiced_bt_mesh_model_sensor_client_sensor_setting_send_set(wiced_b
     memcpy(p, setting_data->setting_raw_val, setting_data->prop_value_len);
     p += setting_data->prop_value_len;
 
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_SENSOR_SETTING_SET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send(HCI_CONTROL_MESH_COMMAND_SENSOR_SETTING_SET, buffer, (uint16_t)(p - buffer));
 }
 
 wiced_result_t wiced_bt_mesh_model_sensor_client_sensor_settings_send_get(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_sensor_get_t *settings_data)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    // cannot release buffer here, because it may be  a part of pending operation
-    // wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
-
-    *p++ = settings_data->property_id & 0xff;
-    *p++ = (settings_data->property_id >> 8) & 0xff;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_SENSOR_SETTINGS_GET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_sensor_settings_get, settings_data);
 }
 
 wiced_result_t wiced_bt_mesh_model_sensor_client_sensor_cadence_send_get(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_sensor_get_t *cadence_get)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    // cannot release buffer here, because it may be  a part of pending operation
-    // wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
-
-    *p++ = cadence_get->property_id & 0xff;
-    *p++ = (cadence_get->property_id >> 8) & 0xff;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_SENSOR_CADENCE_GET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_sensor_cadence_get, cadence_get);
 }
 
 wiced_result_t wiced_bt_mesh_model_sensor_client_sensor_cadence_send_set(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_sensor_cadence_set_data_t *cadence_set)
 {
-    uint8_t buffer[128];
-    uint8_t *p = wiced_bt_mesh_hci_header_from_event(p_event, buffer, sizeof(buffer));
-
-    wiced_bt_mesh_release_event(p_event);
-
-    if (p == NULL)
-        return WICED_BT_BADARG;
-
-    *p++ = cadence_set->property_id & 0xff;
-    *p++ = (cadence_set->property_id >> 8) & 0xff;
-    *p++ = cadence_set->prop_value_len & 0xff;
-    *p++ = cadence_set->cadence_data.fast_cadence_period_divisor & 0xff;
-    *p++ = (cadence_set->cadence_data.fast_cadence_period_divisor >> 8) & 0xff;
-    *p++ = cadence_set->cadence_data.trigger_type;
-
-    //fill status trigger delta up and down values
-    *p++ = cadence_set->cadence_data.trigger_delta_down & 0xff;
-    *p++ = (cadence_set->cadence_data.trigger_delta_down >> 8) & 0xff;
-    *p++ = (cadence_set->cadence_data.trigger_delta_down >> 16) & 0xff;
-    *p++ = (cadence_set->cadence_data.trigger_delta_down >> 24) & 0xff;
-
-    *p++ = cadence_set->cadence_data.trigger_delta_up & 0xff;
-    *p++ = (cadence_set->cadence_data.trigger_delta_up >> 8) & 0xff;
-    *p++ = (cadence_set->cadence_data.trigger_delta_up >> 16) & 0xff;
-    *p++ = (cadence_set->cadence_data.trigger_delta_up >> 24) & 0xff;
-
-    *p++ = cadence_set->cadence_data.min_interval & 0xff;
-    *p++ = (cadence_set->cadence_data.min_interval >> 8) & 0xff;
-    *p++ = (cadence_set->cadence_data.min_interval >> 16) & 0xff;
-    *p++ = (cadence_set->cadence_data.min_interval >> 24) & 0xff;
-
-    //fill status fast cadence high and low value
-    *p++ = cadence_set->cadence_data.fast_cadence_low & 0xff;
-    *p++ = (cadence_set->cadence_data.fast_cadence_low >> 8) & 0xff;
-    *p++ = (cadence_set->cadence_data.fast_cadence_low >> 16) & 0xff;
-    *p++ = (cadence_set->cadence_data.fast_cadence_low >> 24) & 0xff;
-
-    *p++ = cadence_set->cadence_data.fast_cadence_high & 0xff;
-    *p++ = (cadence_set->cadence_data.fast_cadence_high >> 8) & 0xff;
-    *p++ = (cadence_set->cadence_data.fast_cadence_high >> 16) & 0xff;
-    *p++ = (cadence_set->cadence_data.fast_cadence_high >> 24) & 0xff;
-
-    return wiced_hci_send(HCI_CONTROL_MESH_COMMAND_SENSOR_CADENCE_SET, buffer, (uint16_t)(p - buffer));
+    return mesh_hci_send_model_command(p_event, &mesh_hci_cmd_sensor_cadence_set, cadence_set);
 }
 
 wiced_result_t wiced_bt_mesh_client_vendor_data(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len)
@@ -3470,7 +3495,7 @@ wiced_result_t wiced_bt_mesh_client_vendor_data(wiced_bt_mesh_event_t *p_event,
     memcpy(p, p_data, data_len);
     p += data_len;
 
-    res = wiced_hci_send(HCI_CONTROL_MESH_COMMAND_VENDOR_DATA, buffer, (uint16_t)(p - buffer));
+    res = mesh_hci_send(HCI_CONTROL_MESH_COMMAND_VENDOR_DATA, buffer, (uint16_t)(p - buffer));
     wiced_bt_mesh_release_event(p_event);
     return res;
 }
@@ -3488,7 +3513,7 @@ wiced_bool_t wiced_bt_mesh_core_set_seq(uint16_t addr, uint32_t seq, wiced_bool_
     *p++ = addr & 0xff;
     *p++ = (addr >> 8) & 0xff;
 
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CORE_SET_SEQ, buffer, (uint16_t)(p - buffer));
+    mesh_hci_send(HCI_CONTROL_MESH_COMMAND_CORE_SET_SEQ, buffer, (uint16_t)(p - buffer));
     return 1;
 }
 
@@ -3499,7 +3524,7 @@ wiced_bool_t wiced_bt_mesh_core_del_seq(uint16_t addr)
     *p++ = addr & 0xff;
     *p++ = (addr >> 8) & 0xff;
 
-    wiced_hci_send(HCI_CONTROL_MESH_COMMAND_CORE_DEL_SEQ, buffer, (uint16_t)(p - buffer));
+    mesh_hci_send(HCI_CONTROL_MESH_COMMAND_CORE_DEL_SEQ, buffer, (uint16_t)(p - buffer));
     return 1;
 }
 
@@ -3529,10 +3554,143 @@ uint8_t *wiced_bt_mesh_hci_header_from_event(wiced_bt_mesh_event_t *p_event, uin
     return wiced_bt_mesh_format_hci_header(p_event->dst, p_event->app_key_idx, p_event->element_idx, p_event->reply, p_event->send_segmented, p_event->ttl, p_event->retrans_cnt, p_event->retrans_time, p_event->reply_timeout, p_buffer, len);
 }
 
+/*
+ * Mesh event pool.
+ * Events are created and released for every message in both directions. To keep the allocator out of the
+ * way the events are taken from a fixed size free list. The list head packs the index of the first free
+ * entry (plus 1, 0 means the list is empty) in the low 32 bits and a modification tag in the high 32 bits,
+ * so that allocation and release can be done with a single compare and swap from any thread without
+ * suffering from ABA problem. When the pool is exhausted the event is allocated from the heap.
+ */
+#ifndef MESH_EVENT_POOL_DEFAULT_CAPACITY
+#define MESH_EVENT_POOL_DEFAULT_CAPACITY    32
+#endif
+
+#ifdef _WIN32
+#define MESH_ATOMIC_LOAD64(p)               (uint64_t)InterlockedCompareExchange64((volatile LONG64 *)(p), 0, 0)
+#define MESH_ATOMIC_CAS64(p, old, new)      (InterlockedCompareExchange64((volatile LONG64 *)(p), (LONG64)(new), (LONG64)(old)) == (LONG64)(old))
+#define MESH_ATOMIC_CAS32(p, old, new)      (InterlockedCompareExchange((volatile LONG *)(p), (LONG)(new), (LONG)(old)) == (LONG)(old))
+#define MESH_ATOMIC_CAS_PTR(p, old, new)    (InterlockedCompareExchangePointer((PVOID volatile *)(p), (PVOID)(new), (PVOID)(old)) == (PVOID)(old))
+#define MESH_ATOMIC_INC32(p)                (uint32_t)InterlockedIncrement((volatile LONG *)(p))
+#define MESH_ATOMIC_DEC32(p)                (uint32_t)InterlockedDecrement((volatile LONG *)(p))
+#else
+#define MESH_ATOMIC_LOAD64(p)               __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define MESH_ATOMIC_CAS64(p, old, new)      __sync_bool_compare_and_swap((p), (old), (new))
+#define MESH_ATOMIC_CAS32(p, old, new)      __sync_bool_compare_and_swap((p), (old), (new))
+#define MESH_ATOMIC_CAS_PTR(p, old, new)    __sync_bool_compare_and_swap((p), (old), (new))
+#define MESH_ATOMIC_INC32(p)                __sync_add_and_fetch((p), 1)
+#define MESH_ATOMIC_DEC32(p)                __sync_sub_and_fetch((p), 1)
+#endif
+
+typedef union
+{
+    wiced_bt_mesh_event_t   event;
+    uint32_t                next;           // index of the next free entry plus 1, valid while entry is free
+} mesh_event_pool_entry_t;
+
+static mesh_event_pool_entry_t * volatile mesh_event_pool = NULL;
+static uint32_t mesh_event_pool_capacity = MESH_EVENT_POOL_DEFAULT_CAPACITY;
+static volatile uint64_t mesh_event_pool_head = 0;
+static volatile uint32_t mesh_event_pool_in_use = 0;
+static volatile uint32_t mesh_event_pool_high_water_mark = 0;
+static volatile uint32_t mesh_event_pool_hits = 0;
+static volatile uint32_t mesh_event_pool_misses = 0;
+
+int mesh_client_event_pool_set_capacity(uint16_t capacity)
+{
+    if (mesh_event_pool != NULL)
+        return MESH_CLIENT_ERR_INVALID_STATE;
+
+    mesh_event_pool_capacity = capacity;
+    return MESH_CLIENT_SUCCESS;
+}
+
+void mesh_client_event_pool_stats_get(mesh_client_event_pool_stats_t *p_stats)
+{
+    p_stats->capacity        = (mesh_event_pool != NULL) ? mesh_event_pool_capacity : 0;
+    p_stats->in_use          = mesh_event_pool_in_use;
+    p_stats->high_water_mark = mesh_event_pool_high_water_mark;
+    p_stats->hits            = mesh_event_pool_hits;
+    p_stats->misses          = mesh_event_pool_misses;
+}
+
+static wiced_bool_t mesh_event_pool_create(void)
+{
+    mesh_event_pool_entry_t *p_pool;
+    uint32_t i;
+
+    if (mesh_event_pool_capacity == 0)
+        return WICED_FALSE;
+
+    if ((p_pool = (mesh_event_pool_entry_t *)malloc(mesh_event_pool_capacity * sizeof(mesh_event_pool_entry_t))) == NULL)
+        return WICED_FALSE;
+
+    for (i = 0; i < mesh_event_pool_capacity; i++)
+        p_pool[i].next = (i + 1 < mesh_event_pool_capacity) ? i + 2 : 0;
+
+    // another thread could have created the pool at the same time, the list head is set by the winner
+    if (!MESH_ATOMIC_CAS_PTR(&mesh_event_pool, NULL, p_pool))
+    {
+        free(p_pool);
+        return WICED_TRUE;
+    }
+    mesh_event_pool_head = 1;
+    return WICED_TRUE;
+}
+
+static wiced_bt_mesh_event_t *mesh_event_pool_alloc(void)
+{
+    mesh_event_pool_entry_t *p_entry;
+    uint64_t head, new_head;
+    uint32_t in_use, high_water_mark;
+
+    if ((mesh_event_pool != NULL) || mesh_event_pool_create())
+    {
+        head = MESH_ATOMIC_LOAD64(&mesh_event_pool_head);
+        while ((uint32_t)head != 0)
+        {
+            p_entry  = &mesh_event_pool[(uint32_t)head - 1];
+            new_head = ((head & 0xFFFFFFFF00000000ULL) + 0x100000000ULL) | p_entry->next;
+            if (MESH_ATOMIC_CAS64(&mesh_event_pool_head, head, new_head))
+            {
+                MESH_ATOMIC_INC32(&mesh_event_pool_hits);
+                in_use = MESH_ATOMIC_INC32(&mesh_event_pool_in_use);
+                high_water_mark = mesh_event_pool_high_water_mark;
+                while ((in_use > high_water_mark) && !MESH_ATOMIC_CAS32(&mesh_event_pool_high_water_mark, high_water_mark, in_use))
+                    high_water_mark = mesh_event_pool_high_water_mark;
+                return &p_entry->event;
+            }
+            head = MESH_ATOMIC_LOAD64(&mesh_event_pool_head);
+        }
+    }
+    MESH_ATOMIC_INC32(&mesh_event_pool_misses);
+    return (wiced_bt_mesh_event_t *)wiced_bt_get_buffer(sizeof(wiced_bt_mesh_event_t));
+}
+
+static void mesh_event_pool_free(wiced_bt_mesh_event_t *p_event)
+{
+    mesh_event_pool_entry_t *p_entry = (mesh_event_pool_entry_t *)p_event;
+    uint64_t head, new_head;
+
+    if ((mesh_event_pool == NULL) || (p_entry < mesh_event_pool) || (p_entry >= mesh_event_pool + mesh_event_pool_capacity))
+    {
+        wiced_bt_free_buffer(p_event);
+        return;
+    }
+    // in_use is decremented before the entry is returned to the list, so it never exceeds the capacity
+    MESH_ATOMIC_DEC32(&mesh_event_pool_in_use);
+    do
+    {
+        head = MESH_ATOMIC_LOAD64(&mesh_event_pool_head);
+        p_entry->next = (uint32_t)head;
+        new_head = ((head & 0xFFFFFFFF00000000ULL) + 0x100000000ULL) | (uint32_t)(p_entry - mesh_event_pool + 1);
+    } while (!MESH_ATOMIC_CAS64(&mesh_event_pool_head, head, new_head));
+}
+
 wiced_bt_mesh_event_t *wiced_bt_mesh_event_from_hci_header(uint8_t **p_buffer, uint16_t *len)
 {
     uint8_t *p = *p_buffer;
-    wiced_bt_mesh_event_t *p_event = (wiced_bt_mesh_event_t *)wiced_bt_get_buffer(sizeof(wiced_bt_mesh_event_t));
+    wiced_bt_mesh_event_t *p_event = mesh_event_pool_alloc();
     if (p_event != NULL)
     {
         memset(p_event, 0, sizeof(wiced_bt_mesh_event_t));
@@ -3556,10 +3714,10 @@ wiced_bt_mesh_event_t *wiced_bt_mesh_event_from_hci_header(uint8_t **p_buffer, u
 */
 wiced_bt_mesh_event_t *wiced_bt_mesh_create_event(uint8_t element_idx, uint16_t company_id, uint16_t model_id, uint16_t dst, uint16_t app_key_idx)
 {
-    wiced_bt_mesh_event_t *p_event = (wiced_bt_mesh_event_t*)wiced_bt_get_buffer(sizeof(wiced_bt_mesh_event_t));
+    wiced_bt_mesh_event_t *p_event = mesh_event_pool_alloc();
     if (p_event == NULL)
     {
-        Log("create_unsolicited_event: wiced_bt_get_buffer failed\n");
+        Log("create_unsolicited_event: mesh_event_pool_alloc failed\n");
         return NULL;
     }
     memset(p_event, 0, sizeof(wiced_bt_mesh_event_t));
@@ -3580,7 +3738,7 @@ wiced_bt_mesh_event_t *wiced_bt_mesh_create_event(uint8_t element_idx, uint16_t
         else if (!foundation_find_appkey_(app_key_idx, &p_event->app_key_idx, NULL, NULL))
         {
             Log("create_unsolicited_event: no app_key_idx:%x\n", app_key_idx);
-            wiced_bt_free_buffer(p_event);
+            mesh_event_pool_free(p_event);
             return NULL;
         }
 #endif
@@ -3596,7 +3754,7 @@ wiced_bt_mesh_event_t *wiced_bt_mesh_create_event(uint8_t element_idx, uint16_t
         if (wiced_bt_mesh_core_get_publication(p_event))
 #endif
         {
-            wiced_bt_free_buffer(p_event);
+            mesh_event_pool_free(p_event);
             return NULL;
         }
     }
@@ -3611,7 +3769,7 @@ wiced_bt_mesh_event_t *wiced_bt_mesh_create_event(uint8_t element_idx, uint16_t
 */
 void wiced_bt_mesh_release_event(wiced_bt_mesh_event_t *p_event)
 {
-    wiced_bt_free_buffer(p_event);
+    mesh_event_pool_free(p_event);
 }
 
 wiced_bt_mesh_event_t *mesh_configure_create_event(uint16_t dst, wiced_bool_t retransmit)
@@ -375,6 +375,8 @@ typedef struct
     uint16_t    unicast_addr;       // local device unicast address
     uint16_t    company_id;         // Local device company ID
     uint8_t     dev_key[16];        // local device key
+    uint16_t    transport_addr[MESH_CLIENT_HCI_MAX_TRANSPORTS]; // unicast addresses of the devices of the HCI transports
+    uint8_t     local_transport;    // HCI transport of the local device being configured
     unprovisioned_report_t *p_first_unprovisioned;// address of the first unprovisioned report
     uint8_t     uuid[16];           // device being provisioned
     uint8_t     oob_data[16];       // Static OOB data to be used during provisioning
@@ -462,14 +464,60 @@ typedef struct
 
 mesh_provision_cb_t provision_cb = { 0 };
 
+/*
+ * Sensor poll scheduler. Each entry polls one property of a sensor with the configured period. A new entry is
+ * placed in the largest gap between the polls already scheduled, and each poll is randomly shifted by up to jitter_percent of the period, so that
+ * sensors with the same period are not polled at the same time. All polls share the budget of messages per
+ * second. A poll is skipped if the sensor has published the property (for example due to the cadence) within
+ * the last period.
+ */
+#define SENSOR_POLL_TICK_MS                     100
+#define SENSOR_POLL_DEFAULT_MAX_MSGS_PER_SEC    10
+#define SENSOR_POLL_DEFAULT_JITTER_PERCENT      10
+#define SENSOR_POLL_REPLY_TIMEOUT_TICKS         (3000 / SENSOR_POLL_TICK_MS)    // reply timeout of mesh_create_control_event
+
+typedef struct mesh_sensor_poll_entry_t
+{
+    struct mesh_sensor_poll_entry_t *p_next;
+    uint16_t    element_addr;
+    uint16_t    property_id;
+    uint32_t    period;                 // poll period in ticks
+    uint32_t    next_poll;              // tick of the next poll without jitter
+    uint32_t    due;                    // tick when the poll is executed, next_poll shifted by jitter
+    uint32_t    last_publication;       // tick when unsolicited status has been received
+    uint32_t    reply_deadline;         // tick when the pending reply is not expected anymore
+    uint8_t     publication_received;
+    uint8_t     reply_pending;
+} mesh_sensor_poll_entry_t;
+
+typedef struct
+{
+    mesh_sensor_poll_entry_t *p_first;
+    wiced_timer_t timer;
+    uint8_t     timer_started;
+    uint8_t     jitter_percent;
+    uint16_t    max_msgs_per_sec;
+    uint32_t    tick;
+    uint32_t    budget;                 // available budget in 1/1000 of the message
+    mesh_client_sensor_poll_stats_t stats;
+} mesh_sensor_poll_cb_t;
+
+static mesh_sensor_poll_cb_t sensor_poll_cb = { NULL, { { 0 } }, 0, SENSOR_POLL_DEFAULT_JITTER_PERCENT, SENSOR_POLL_DEFAULT_MAX_MSGS_PER_SEC };
+
+uint32_t wiced_hal_rand_gen_num(void);
+static void sensor_poll_timer_cb(TIMER_PARAM_TYPE arg);
+static void sensor_poll_process_status(uint16_t element_addr, uint16_t property_id);
+static void sensor_poll_stop(void);
+
 static void start_next_op(mesh_provision_cb_t *p_cb);
 static void clean_pending_op_queue(uint16_t addr);
 static uint8_t configure_local_device(uint16_t unicast_addr, uint8_t phase, uint16_t net_key_idx, uint8_t *p_net_key);
-static void configure_queue_local_device_operations(mesh_provision_cb_t *p_cb);
+static void configure_queue_local_device_operations(mesh_provision_cb_t *p_cb, uint16_t local_addr);
+static wiced_bool_t configure_next_local_transport(mesh_provision_cb_t *p_cb);
 static void configure_queue_remote_device_operations(mesh_provision_cb_t *p_cb);
 static void configure_pending_operation_queue(mesh_provision_cb_t *p_cb, pending_operation_t *p_op);
 static void app_key_add(mesh_provision_cb_t* p_cb, uint16_t addr, wiced_bt_mesh_db_net_key_t* net_key, wiced_bt_mesh_db_app_key_t* app_key);
-static void model_app_bind(mesh_provision_cb_t* p_cb, wiced_bool_t is_local, uint16_t addr, uint16_t company_id, uint16_t model_id, uint16_t app_key_idx);
+static void model_app_bind(mesh_provision_cb_t* p_cb, uint16_t local_addr, uint16_t addr, uint16_t company_id, uint16_t model_id, uint16_t app_key_idx);
 static pending_operation_t *configure_pending_operation_dequeue(mesh_provision_cb_t *p_cb);
 static pending_operation_t* configure_pending_operation_remove_from_queue(mesh_provision_cb_t* p_cb, pending_operation_t* p_op);
 static void configure_execute_pending_operation(mesh_provision_cb_t *p_cb);
@@ -595,7 +643,7 @@ uint16_t *get_group_list(uint16_t addr);
 wiced_bool_t is_core_model(uint16_t company_id, uint16_t model_id);
 wiced_bool_t is_secondary_element(uint16_t element_idx);
 wiced_bool_t is_provisioner(wiced_bt_mesh_db_node_t *p_node);
-static void download_rpl_list(void);
+static void download_rpl_list(uint16_t own_addr);
 static void rand128(uint8_t *p_array);
 static uint16_t rand16();
 static wiced_bool_t model_needs_sub(uint16_t model_id, wiced_bt_mesh_db_model_id_t *p_models_array);
@@ -620,6 +668,9 @@ extern uint8_t mesh_core_create_proxy_solicitation_service_data(uint8_t net_key_
 extern wiced_bool_t mesh_advertising_start(uint16_t company_id, uint16_t service_id, uint8_t *data, int data_len);
 extern void mesh_advertising_stop(void);
 extern wiced_bool_t mesh_adv_publish_start(void);
+extern uint8_t mesh_hci_transport_num(void);
+extern void mesh_hci_transport_local_addr_set(uint8_t transport, uint16_t addr);
+extern void mesh_hci_transport_pin(int transport);
 
 wiced_bt_mesh_db_mesh_t *p_mesh_db = NULL;
 
@@ -937,6 +988,27 @@ int mesh_client_network_open(const char *provisioner_name, const char *provision
             return MESH_CLIENT_ERR_NO_MEMORY;
         p_mesh_db->unicast_addr = node->unicast_address;
     }
+    // device of each additional HCI transport is a provisioner of its own, with UUID derived from the UUID of the first one
+    memset(provision_cb.transport_addr, 0, sizeof(provision_cb.transport_addr));
+    for (i = 1; i < mesh_hci_transport_num(); i++)
+    {
+        char name[80];
+        uuid[15] ^= (uint8_t)i;
+        if ((provisioner = wiced_bt_mesh_db_provisioner_get_by_uuid(p_mesh_db, uuid)) == NULL)
+        {
+            snprintf(name, sizeof(name), "%s %d", provisioner_name, i);
+            rand128(dev_key);
+            provision_cb.transport_addr[i] = wiced_bt_mesh_db_provisioner_add(p_mesh_db, name, uuid, dev_key);
+            save = WICED_TRUE;
+        }
+        else
+        {
+            wiced_bt_mesh_db_node_t *node = mesh_find_node_by_uuid(p_mesh_db, provisioner->uuid);
+            if (node != NULL)
+                provision_cb.transport_addr[i] = node->unicast_address;
+        }
+        uuid[15] ^= (uint8_t)i;
+    }
     /*
     for (int i = 0; i < sizeof(group_name) / sizeof(group_name[0]); i++)
     {
@@ -1058,9 +1130,14 @@ char *mesh_client_network_export(char *mesh_name)
 void mesh_client_network_close(void)
 {
     mesh_provision_cb_t *p_cb = &provision_cb;
+    int i;
 
     provision_cb.network_opened = WICED_FALSE;
 
+    for (i = 0; i < mesh_hci_transport_num(); i++)
+        mesh_hci_transport_local_addr_set((uint8_t)i, 0);
+    memset(p_cb->transport_addr, 0, sizeof(p_cb->transport_addr));
+
     if (p_mesh_db != NULL)
     {
         // after application deinit, we will not receive link status
@@ -1086,6 +1163,7 @@ void mesh_client_network_close(void)
         p_mesh_db = NULL;
     }
     clean_pending_op_queue(0);
+    sensor_poll_stop();
     mesh_lpn_key_refresh_block_t* p_lpn_kr;
     while (p_cb->p_lpn_kr_first != NULL)
     {
@@ -1370,7 +1448,7 @@ void download_iv(uint32_t *p_iv_idx, uint8_t *p_iv_update)
     fclose(fp);
 }
 
-void download_rpl_list(void)
+void download_rpl_list(uint16_t own_addr)
 {
     FILE *            fp;
     mesh_client_seq_t entry;
@@ -1390,11 +1468,12 @@ void download_rpl_list(void)
         // Read all SEQ records passing them to the mesh core
         while (fread(&entry, 1, sizeof(entry), fp) == sizeof(entry))
         {
-            // Don't send RPL entries. Send only own SEQ.
-            if (entry.addr != 0)
+            // Don't send RPL entries. Send only own SEQ, which is stored with address 0 for the first HCI transport
+            // and with the device address for the others.
+            if (entry.addr != own_addr)
                 continue;
             seq = entry.seq[0] + (((uint32_t)entry.seq[1]) << 8) + (((uint32_t)entry.seq[2]) << 16);
-            wiced_bt_mesh_core_set_seq(entry.addr, seq, entry.previous_iv_idx != 0 ? WICED_TRUE : WICED_FALSE);
+            wiced_bt_mesh_core_set_seq(0, seq, entry.previous_iv_idx != 0 ? WICED_TRUE : WICED_FALSE);
         }
     }
     fclose(fp);
@@ -1580,6 +1659,9 @@ uint8_t configure_local_device(uint16_t unicast_addr, uint8_t phase, uint16_t ne
 
     memcpy(p_cb->dev_key, node->device_key, sizeof(p_cb->dev_key));
     p_cb->unicast_addr = unicast_addr;
+    p_cb->transport_addr[0] = unicast_addr;
+    p_cb->local_transport = 0;
+    mesh_hci_transport_local_addr_set(0, unicast_addr);
 
     wiced_bt_mesh_local_device_set_data_t set;
     memset(&set, 0, sizeof(set));
@@ -1596,12 +1678,60 @@ uint8_t configure_local_device(uint16_t unicast_addr, uint8_t phase, uint16_t ne
 
     wiced_bt_mesh_provision_local_device_set(&set);
 
-    download_rpl_list();
+    download_rpl_list(0);
 
     mesh_configure_composition_data_get(p_cb, OPERATION_LOCAL);
     return MESH_CLIENT_SUCCESS;
 }
 
+/*
+ * Configure the device of the next additional HCI transport. The device runs the same application as the local
+ * device of the first transport, so it is configured using the same composition data. Returns WICED_FALSE when
+ * devices of all transports are configured.
+ */
+wiced_bool_t configure_next_local_transport(mesh_provision_cb_t *p_cb)
+{
+    wiced_bt_mesh_db_net_key_t *p_net_key = wiced_bt_mesh_db_net_key_get(p_mesh_db, 0);
+    wiced_bt_mesh_local_device_set_data_t set;
+    wiced_bt_mesh_db_node_t *node;
+    uint16_t addr;
+
+    while ((p_net_key != NULL) && (++p_cb->local_transport < mesh_hci_transport_num()))
+    {
+        addr = p_cb->transport_addr[p_cb->local_transport];
+        if ((addr == 0) || ((node = wiced_bt_mesh_db_node_get_by_addr(p_mesh_db, addr)) == NULL))
+            continue;
+
+        memset(&set, 0, sizeof(set));
+        set.addr = addr;
+        memcpy(set.dev_key, node->device_key, 16);
+        memcpy(set.network_key, p_net_key->phase == WICED_BT_MESH_KEY_REFRESH_PHASE_NORMAL ? p_net_key->key : p_net_key->old_key, 16);
+        set.net_key_idx = p_net_key->index;
+
+        download_iv(&set.iv_idx, &set.iv_update);
+
+        Log("Set Local Device transport:%d addr:0x%04x net_key_idx:%04x iv_idx:%d", p_cb->local_transport, set.addr, set.net_key_idx, set.iv_idx);
+
+        // SEQ is set without the address, make sure it goes to the device of the transport
+        mesh_hci_transport_local_addr_set(p_cb->local_transport, addr);
+        mesh_hci_transport_pin(p_cb->local_transport);
+        wiced_bt_mesh_provision_local_device_set(&set);
+        download_rpl_list(addr);
+        mesh_hci_transport_pin(-1);
+
+        if (!wiced_bt_mesh_db_node_check_composition_data(p_mesh_db, addr, p_cb->p_local_composition_data->data, p_cb->p_local_composition_data->data_len))
+        {
+            wiced_bt_mesh_db_node_set_composition_data(p_mesh_db, addr, p_cb->p_local_composition_data->data, p_cb->p_local_composition_data->data_len);
+            wiced_bt_mesh_db_store(p_mesh_db);
+            p_cb->store_config = WICED_TRUE;
+        }
+        configure_queue_local_device_operations(p_cb, addr);
+        configure_execute_pending_operation(p_cb);
+        return WICED_TRUE;
+    }
+    return WICED_FALSE;
+}
+
 char *mesh_client_get_all_networks(void)
 {
     return wiced_bt_mesh_db_get_all_networks();
@@ -5326,7 +5456,7 @@ void mesh_configure_composition_data_status(mesh_provision_cb_t *p_cb, wiced_bt_
             wiced_bt_mesh_db_node_set_composition_data(p_mesh_db, p_event->src, p_data->data, p_data->data_len);
             wiced_bt_mesh_db_store(p_mesh_db);
         }
-        configure_queue_local_device_operations(p_cb);
+        configure_queue_local_device_operations(p_cb, p_cb->unicast_addr);
         configure_execute_pending_operation(p_cb);
         return;
     }
@@ -6922,9 +7052,278 @@ void mesh_process_sensor_status(wiced_bt_mesh_event_t* p_event, void* p)
     {
         provision_cb.p_sensor_status(wiced_bt_mesh_db_get_element_name(p_mesh_db, p_event->src), p_data->property_id, p_data->prop_value_len, p_data->raw_value);
     }
+    sensor_poll_process_status(p_event->src, p_data->property_id);
     wiced_bt_mesh_release_event(p_event);
 }
 
+/*
+ * Calculate tick of the next poll of the entry, shifting the nominal time by random jitter
+ */
+static void sensor_poll_set_due(mesh_sensor_poll_entry_t *p_entry)
+{
+    uint32_t jitter = p_entry->period * sensor_poll_cb.jitter_percent / 100;
+
+    p_entry->due = p_entry->next_poll;
+    if (jitter != 0)
+        p_entry->due = p_entry->next_poll - jitter + (wiced_hal_rand_gen_num() % (2 * jitter + 1));
+}
+
+/*
+ * Phase of the next poll of the entry within the period, counted from the next tick
+ */
+static uint32_t sensor_poll_phase(mesh_sensor_poll_entry_t *p_entry, uint32_t period)
+{
+    int32_t delta = (int32_t)(p_entry->next_poll - (sensor_poll_cb.tick + 1)) % (int32_t)period;
+
+    return (delta < 0) ? (uint32_t)(delta + (int32_t)period) : (uint32_t)delta;
+}
+
+/*
+ * Schedule the first poll of the entry in the middle of the largest gap between the polls of the other entries,
+ * projected on the period of the entry. The other entries keep their schedule, so that adding or removing an
+ * entry does not delay or advance the polls already planned.
+ */
+static void sensor_poll_place(mesh_sensor_poll_entry_t *p_entry)
+{
+    mesh_sensor_poll_entry_t *p_from, *p_to;
+    uint32_t from, gap, best_from = 0, best_gap = 0;
+
+    for (p_from = sensor_poll_cb.p_first; p_from != NULL; p_from = p_from->p_next)
+    {
+        if (p_from == p_entry)
+            continue;
+
+        // the gap after an entry ends at the closest following poll with another phase, or at its own next poll
+        from = sensor_poll_phase(p_from, p_entry->period);
+        gap = p_entry->period;
+        for (p_to = sensor_poll_cb.p_first; p_to != NULL; p_to = p_to->p_next)
+        {
+            if ((p_to != p_entry) && (p_to != p_from))
+            {
+                uint32_t distance = (sensor_poll_phase(p_to, p_entry->period) + p_entry->period - from) % p_entry->period;
+                if ((distance != 0) && (distance < gap))
+                    gap = distance;
+            }
+        }
+        if (gap > best_gap)
+        {
+            best_gap  = gap;
+            best_from = from;
+        }
+    }
+    p_entry->next_poll = sensor_poll_cb.tick + 1;
+    if (best_gap != 0)
+        p_entry->next_poll += (best_from + best_gap / 2) % p_entry->period;
+    sensor_poll_set_due(p_entry);
+}
+
+int mesh_client_sensor_poll_add(const char *device_name, int property_id, uint32_t period_ms)
+{
+    mesh_sensor_poll_entry_t *p_entry;
+    uint16_t addr = get_device_addr(device_name);
+
+    if (p_mesh_db == NULL)
+    {
+        Log("Network closed\n");
+        return MESH_CLIENT_ERR_NETWORK_CLOSED;
+    }
+    if (addr == 0)
+    {
+        Log("device not found in DB\n");
+        return MESH_CLIENT_ERR_NOT_FOUND;
+    }
+    if (!is_model_present(addr, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_SENSOR_SRV))
+    {
+        Log("sensor model not present\n");
+        return MESH_CLIENT_ERR_METHOD_NOT_AVAIL;
+    }
+    if (period_ms < SENSOR_POLL_TICK_MS)
+        return MESH_CLIENT_ERR_INVALID_ARGS;
+
+    for (p_entry = sensor_poll_cb.p_first; p_entry != NULL; p_entry = p_entry->p_next)
+    {
+        if ((p_entry->element_addr == addr) && (p_entry->property_id == (uint16_t)property_id))
+            break;
+    }
+    if (p_entry == NULL)
+    {
+        if ((p_entry = (mesh_sensor_poll_entry_t *)wiced_bt_get_buffer(sizeof(mesh_sensor_poll_entry_t))) == NULL)
+            return MESH_CLIENT_ERR_NO_MEMORY;
+
+        memset(p_entry, 0, sizeof(mesh_sensor_poll_entry_t));
+        p_entry->element_addr = addr;
+        p_entry->property_id  = (uint16_t)property_id;
+        p_entry->p_next       = sensor_poll_cb.p_first;
+        sensor_poll_cb.p_first = p_entry;
+    }
+    p_entry->period = period_ms / SENSOR_POLL_TICK_MS;
+
+    Log("Sensor poll add addr:%04x property:%04x period:%d ms\n", addr, property_id, period_ms);
+
+    sensor_poll_place(p_entry);
+
+    if (!sensor_poll_cb.timer_started)
+    {
+        sensor_poll_cb.budget = 0;
+        wiced_init_timer(&sensor_poll_cb.timer, sensor_poll_timer_cb, NULL, WICED_MILLI_SECONDS_PERIODIC_TIMER);
+        wiced_start_timer(&sensor_poll_cb.timer, SENSOR_POLL_TICK_MS);
+        sensor_poll_cb.timer_started = WICED_TRUE;
+    }
+    return MESH_CLIENT_SUCCESS;
+}
+
+int mesh_client_sensor_poll_remove(const char *device_name, int property_id)
+{
+    mesh_sensor_poll_entry_t *p_entry, *p_prev = NULL;
+    uint16_t addr = get_device_addr(device_name);
+
+    for (p_entry = sensor_poll_cb.p_first; p_entry != NULL; p_prev = p_entry, p_entry = p_entry->p_next)
+    {
+        if ((p_entry->element_addr == addr) && (p_entry->property_id == (uint16_t)property_id))
+            break;
+    }
+    if (p_entry == NULL)
+        return MESH_CLIENT_ERR_NOT_FOUND;
+
+    if (p_prev == NULL)
+        sensor_poll_cb.p_first = p_entry->p_next;
+    else
+        p_prev->p_next = p_entry->p_next;
+    wiced_bt_free_buffer(p_entry);
+
+    if (sensor_poll_cb.p_first == NULL)
+        sensor_poll_stop();
+
+    return MESH_CLIENT_SUCCESS;
+}
+
+void mesh_client_sensor_poll_configure(uint16_t max_msgs_per_sec, uint8_t jitter_percent)
+{
+    sensor_poll_cb.max_msgs_per_sec = max_msgs_per_sec;
+    sensor_poll_cb.jitter_percent   = (jitter_percent > 50) ? 50 : jitter_percent;
+}
+
+void mesh_client_sensor_poll_stats_get(mesh_client_sensor_poll_stats_t *p_stats)
+{
+    *p_stats = sensor_poll_cb.stats;
+}
+
+/*
+ * Stop polling and release all entries
+ */
+static void sensor_poll_stop(void)
+{
+    mesh_sensor_poll_entry_t *p_entry;
+
+    while ((p_entry = sensor_poll_cb.p_first) != NULL)
+    {
+        sensor_poll_cb.p_first = p_entry->p_next;
+        wiced_bt_free_buffer(p_entry);
+    }
+    if (sensor_poll_cb.timer_started)
+    {
+        wiced_stop_timer(&sensor_poll_cb.timer);
+        wiced_deinit_timer(&sensor_poll_cb.timer);
+        sensor_poll_cb.timer_started = WICED_FALSE;
+    }
+}
+
+static void sensor_poll_timer_cb(TIMER_PARAM_TYPE arg)
+{
+    mesh_sensor_poll_entry_t *p_entry, *p_oldest;
+    uint32_t max_budget = (uint32_t)sensor_poll_cb.max_msgs_per_sec * SENSOR_POLL_TICK_MS;
+
+    sensor_poll_cb.tick++;
+
+    // refill the budget, do not allow to accumulate more than one tick worth of messages to avoid bursts
+    if (max_budget < 1000)
+        max_budget = 1000;
+    sensor_poll_cb.budget += (uint32_t)sensor_poll_cb.max_msgs_per_sec * SENSOR_POLL_TICK_MS;
+    if (sensor_poll_cb.budget > max_budget)
+        sensor_poll_cb.budget = max_budget;
+
+    // a reply which has not arrived in time is lost, the next status is a publication
+    for (p_entry = sensor_poll_cb.p_first; p_entry != NULL; p_entry = p_entry->p_next)
+    {
+        if (p_entry->reply_pending && ((int32_t)(sensor_poll_cb.tick - p_entry->reply_deadline) >= 0))
+        {
+            p_entry->reply_pending = WICED_FALSE;
+            sensor_poll_cb.stats.reply_timeouts++;
+        }
+    }
+
+    if ((p_mesh_db == NULL) || !mesh_client_is_proxy_connected())
+        return;
+
+    for (;;)
+    {
+        // find the entry which has been waiting for the longest time
+        p_oldest = NULL;
+        for (p_entry = sensor_poll_cb.p_first; p_entry != NULL; p_entry = p_entry->p_next)
+        {
+            if ((int32_t)(sensor_poll_cb.tick - p_entry->due) < 0)
+                continue;
+
+            if ((p_oldest == NULL) || ((int32_t)(p_entry->due - p_oldest->due) < 0))
+                p_oldest = p_entry;
+        }
+        if (p_oldest == NULL)
+            break;
+
+        // skip the poll if the sensor published the value during the last period
+        if (p_oldest->publication_received && ((sensor_poll_cb.tick - p_oldest->last_publication) < p_oldest->period))
+        {
+            sensor_poll_cb.stats.skipped++;
+        }
+        else
+        {
+            if (sensor_poll_cb.budget < 1000)
+            {
+                sensor_poll_cb.stats.deferred++;
+                break;
+            }
+            sensor_poll_cb.budget -= 1000;
+
+            p_oldest->reply_pending = (mesh_client_sensor_get(get_component_name(p_oldest->element_addr), p_oldest->property_id) == MESH_CLIENT_SUCCESS);
+            p_oldest->reply_deadline = sensor_poll_cb.tick + SENSOR_POLL_REPLY_TIMEOUT_TICKS;
+            sensor_poll_cb.stats.polls++;
+        }
+        // next poll is scheduled from the nominal time so that jitter and delays do not accumulate
+        do
+        {
+            p_oldest->next_poll += p_oldest->period;
+        } while ((int32_t)(sensor_poll_cb.tick - p_oldest->next_poll) >= 0);
+        sensor_poll_set_due(p_oldest);
+    }
+}
+
+/*
+ * Sensor status received. The first status within the reply timeout after the poll is considered to be the reply,
+ * others are publications.
+ */
+static void sensor_poll_process_status(uint16_t element_addr, uint16_t property_id)
+{
+    mesh_sensor_poll_entry_t *p_entry;
+
+    for (p_entry = sensor_poll_cb.p_first; p_entry != NULL; p_entry = p_entry->p_next)
+    {
+        if ((p_entry->element_addr != element_addr) || ((p_entry->property_id != property_id) && (p_entry->property_id != 0)))
+            continue;
+
+        if (p_entry->reply_pending)
+        {
+            p_entry->reply_pending = WICED_FALSE;
+            sensor_poll_cb.stats.replies++;
+        }
+        else
+        {
+            p_entry->publication_received = WICED_TRUE;
+            p_entry->last_publication = sensor_poll_cb.tick;
+            sensor_poll_cb.stats.publications++;
+        }
+    }
+}
+
 
 void mesh_configure_disconnecting_link_status(mesh_provision_cb_t *p_cb, wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_connect_status_data_t *p_data)
 {
@@ -7443,7 +7842,7 @@ void configure_pending_operation_lpn_queue(mesh_provision_cb_t* p_cb, pending_op
 /*
  * this function schedules all operations required to configure local device
  */
-void configure_queue_local_device_operations(mesh_provision_cb_t *p_cb)
+void configure_queue_local_device_operations(mesh_provision_cb_t *p_cb, uint16_t local_addr)
 {
     uint32_t i, j;
     uint8_t element_idx = 0;
@@ -7464,7 +7863,7 @@ void configure_queue_local_device_operations(mesh_provision_cb_t *p_cb)
             if ((p_op = (pending_operation_t *)wiced_bt_get_buffer(sizeof(pending_operation_t))) != NULL)
             {
                 p_op->operation = CONFIG_OPERATION_NET_KEY_UPDATE;
-                p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, p_cb->unicast_addr, 0xFFFF);
+                p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, local_addr, 0xFFFF);
                 p_op->uu.net_key_change.operation = OPERATION_ADD;
                 p_op->uu.net_key_change.net_key_idx = net_key->index;
                 memcpy(p_op->uu.net_key_change.net_key, net_key->phase == WICED_BT_MESH_KEY_REFRESH_PHASE_NORMAL ? net_key->key : net_key->old_key, sizeof(net_key->key));
@@ -7476,7 +7875,7 @@ void configure_queue_local_device_operations(mesh_provision_cb_t *p_cb)
             if ((p_op = (pending_operation_t *)wiced_bt_get_buffer(sizeof(pending_operation_t))) != NULL)
             {
                 p_op->operation = CONFIG_OPERATION_NET_KEY_UPDATE;
-                p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, p_cb->unicast_addr, 0xFFFF);
+                p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, local_addr, 0xFFFF);
                 p_op->uu.net_key_change.operation = OPERATION_UPDATE;
                 p_op->uu.net_key_change.net_key_idx = net_key->index;
                 memcpy(p_op->uu.net_key_change.net_key, net_key->key, sizeof(net_key->key));
@@ -7487,7 +7886,7 @@ void configure_queue_local_device_operations(mesh_provision_cb_t *p_cb)
                 if ((p_op = (pending_operation_t *)wiced_bt_get_buffer(sizeof(pending_operation_t))) != NULL)
                 {
                     p_op->operation = CONFIG_OPERATION_KR_PHASE_SET;
-                    p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, p_cb->unicast_addr, 0xFFFF);
+                    p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, local_addr, 0xFFFF);
                     p_op->uu.kr_phase_set.net_key_idx = net_key->index;
                     p_op->uu.kr_phase_set.transition = net_key->phase;
                     configure_pending_operation_queue(p_cb, p_op);
@@ -7509,7 +7908,7 @@ void configure_queue_local_device_operations(mesh_provision_cb_t *p_cb)
         if ((p_op = (pending_operation_t *)wiced_bt_get_buffer(sizeof(pending_operation_t))) != NULL)
         {
             p_op->operation = CONFIG_OPERATION_APP_KEY_UPDATE;
-            p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, p_cb->unicast_addr, 0xFFFF);
+            p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, local_addr, 0xFFFF);
             p_op->uu.app_key_change.operation = OPERATION_ADD;
             p_op->uu.app_key_change.app_key_idx = app_key->index;
             p_op->uu.app_key_change.net_key_idx = app_key->bound_net_key_index;
@@ -7521,7 +7920,7 @@ void configure_queue_local_device_operations(mesh_provision_cb_t *p_cb)
                 if ((p_op = (pending_operation_t *)wiced_bt_get_buffer(sizeof(pending_operation_t))) != NULL)
                 {
                     p_op->operation = CONFIG_OPERATION_APP_KEY_UPDATE;
-                    p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, p_cb->unicast_addr, 0xFFFF);
+                    p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, local_addr, 0xFFFF);
                     p_op->uu.app_key_change.operation = OPERATION_UPDATE;
                     p_op->uu.app_key_change.app_key_idx = app_key->index;
                     p_op->uu.app_key_change.net_key_idx = app_key->bound_net_key_index;
@@ -7556,7 +7955,7 @@ void configure_queue_local_device_operations(mesh_provision_cb_t *p_cb)
                     (model_id != WICED_BT_MESH_CORE_MODEL_ID_REMOTE_PROVISION_SRV) &&
                     (model_id != WICED_BT_MESH_CORE_MODEL_ID_REMOTE_PROVISION_CLNT))
                 {
-                    model_app_bind(p_cb, WICED_TRUE, p_cb->unicast_addr + element_idx, MESH_COMPANY_ID_BT_SIG, model_id, app_key->index);
+                    model_app_bind(p_cb, local_addr, local_addr + element_idx, MESH_COMPANY_ID_BT_SIG, model_id, app_key->index);
 
 #if SUBSCRIBE_LOCAL_MODELS_TO_ALL_GROUPS
                     // subscribe all client models to receive all messages for all groups.  When a device is provisioned
@@ -7567,9 +7966,9 @@ void configure_queue_local_device_operations(mesh_provision_cb_t *p_cb)
                         {
                             memset(p_op, 0, sizeof(pending_operation_t));
                             p_op->operation = CONFIG_OPERATION_MODEL_SUBSCRIBE;
-                            p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, p_cb->unicast_addr, 0xFFFF);
+                            p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, local_addr, 0xFFFF);
                             p_op->uu.model_sub.operation = OPERATION_ADD;
-                            p_op->uu.model_sub.element_addr = p_cb->unicast_addr + element_idx;
+                            p_op->uu.model_sub.element_addr = local_addr + element_idx;
                             p_op->uu.model_sub.company_id = MESH_COMPANY_ID_BT_SIG;
                             p_op->uu.model_sub.model_id = model_id;
                             p_op->uu.model_sub.addr[0] = p_mesh_db->group[k].addr & 0xff;
@@ -7584,7 +7983,7 @@ void configure_queue_local_device_operations(mesh_provision_cb_t *p_cb)
             }
             for (j = 0; j < num_vs_models; j++)
             {
-                model_app_bind(p_cb, WICED_TRUE, p_cb->unicast_addr + element_idx, p_comp_data[0] + (p_comp_data[1] << 8), p_comp_data[2] + (p_comp_data[3] << 8), app_key->index);
+                model_app_bind(p_cb, local_addr, local_addr + element_idx, p_comp_data[0] + (p_comp_data[1] << 8), p_comp_data[2] + (p_comp_data[3] << 8), app_key->index);
 
                 p_comp_data += 4;
                 comp_data_len -= 4;
@@ -7597,7 +7996,7 @@ void configure_queue_local_device_operations(mesh_provision_cb_t *p_cb)
     {
         // wiced_bt_mesh_config_network_transmit_set_data_t
         p_op->operation = CONFIG_OPERATION_NET_TRANSMIT_SET;
-        p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, p_cb->unicast_addr, 0xFFFF);
+        p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, local_addr, 0xFFFF);
         p_op->uu.net_transmit_set.count = LOCAL_DEVICE_NET_TRANSMIT_COUNT;
         p_op->uu.net_transmit_set.interval = LOCAL_DEVICE_NET_TRANSMIT_INTERVAL;
         configure_pending_operation_queue(p_cb, p_op);
@@ -7606,7 +8005,7 @@ void configure_queue_local_device_operations(mesh_provision_cb_t *p_cb)
     {
         //wiced_bt_mesh_config_default_ttl_set_data_t
         p_op->operation = CONFIG_OPERATION_DEFAULT_TTL_SET;
-        p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, p_cb->unicast_addr, 0xFFFF);
+        p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, local_addr, 0xFFFF);
         p_op->uu.default_ttl_set.ttl = LOCAL_DEVICE_TTL;
         configure_pending_operation_queue(p_cb, p_op);
     }
@@ -7614,7 +8013,7 @@ void configure_queue_local_device_operations(mesh_provision_cb_t *p_cb)
         ((p_op = (pending_operation_t *)wiced_bt_get_buffer(sizeof(pending_operation_t))) != NULL))
     {
         p_op->operation = CONFIG_OPERATION_RELAY_SET;
-        p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, p_cb->unicast_addr, 0xFFFF);
+        p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, local_addr, 0xFFFF);
         p_op->uu.relay_set.state = 0;
         p_op->uu.relay_set.retransmit_count = 0;
         p_op->uu.relay_set.retransmit_interval = 0;
@@ -7625,7 +8024,7 @@ void configure_queue_local_device_operations(mesh_provision_cb_t *p_cb)
     {
         //wiced_bt_mesh_config_gatt_proxy_set_data_t
         p_op->operation = CONFIG_OPERATION_PROXY_SET;
-        p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, p_cb->unicast_addr, 0xFFFF);
+        p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, local_addr, 0xFFFF);
         p_op->uu.proxy_set.state = 0;
         configure_pending_operation_queue(p_cb, p_op);
     }
@@ -7634,14 +8033,14 @@ void configure_queue_local_device_operations(mesh_provision_cb_t *p_cb)
     {
         //wiced_bt_mesh_config_friend_set_data_t
         p_op->operation = CONFIG_OPERATION_FRIEND_SET;
-        p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, p_cb->unicast_addr, 0xFFFF);
+        p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, local_addr, 0xFFFF);
         p_op->uu.friend_set.state = 0;
         configure_pending_operation_queue(p_cb, p_op);
     }
     if ((p_op = (pending_operation_t *)wiced_bt_get_buffer(sizeof(pending_operation_t))) != NULL)
     {
         p_op->operation = CONFIG_OPERATION_NET_BEACON_SET;
-        p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, p_cb->unicast_addr, 0xFFFF);
+        p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, local_addr, 0xFFFF);
         p_op->uu.beacon_set.state = 0;
         configure_pending_operation_queue(p_cb, p_op);
     }
@@ -7677,7 +8076,7 @@ void app_key_add(mesh_provision_cb_t *p_cb, uint16_t addr, wiced_bt_mesh_db_net_
     }
 }
 
-void model_app_bind(mesh_provision_cb_t* p_cb, wiced_bool_t is_local,  uint16_t addr, uint16_t company_id, uint16_t model_id, uint16_t app_key_idx)
+void model_app_bind(mesh_provision_cb_t* p_cb, uint16_t local_addr, uint16_t addr, uint16_t company_id, uint16_t model_id, uint16_t app_key_idx)
 {
     pending_operation_t* p_op;
 
@@ -7686,8 +8085,8 @@ void model_app_bind(mesh_provision_cb_t* p_cb, wiced_bool_t is_local,  uint16_t
 
     p_op->operation = CONFIG_OPERATION_MODEL_APP_BIND;
     p_op->uu.app_key_bind.operation = OPERATION_BIND;
-    if (is_local)
-        p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, p_cb->unicast_addr, 0xFFFF);
+    if (local_addr != 0)
+        p_op->p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_CONFIG_CLNT, local_addr, 0xFFFF);
     else
         p_op->p_event = mesh_client_configure_create_event(p_cb->addr);
     p_op->uu.app_key_bind.element_addr = addr;
@@ -7822,7 +8221,7 @@ void configure_queue_remote_device_operations(mesh_provision_cb_t *p_cb)
                     app_key_add(p_cb, p_cb->addr, net_key, app_key);
                 }
                 app_key = wiced_bt_mesh_db_app_key_get_by_name(p_mesh_db, "Generic");
-                model_app_bind(p_cb, WICED_FALSE, p_cb->addr + element_idx, MESH_COMPANY_ID_BT_SIG, model_id, app_key->index);
+                model_app_bind(p_cb, 0, p_cb->addr + element_idx, MESH_COMPANY_ID_BT_SIG, model_id, app_key->index);
             }
             if ((p_model_elem = model_needs_default_sub(MESH_COMPANY_ID_BT_SIG, model_id)) != NULL)
             {
@@ -7853,12 +8252,12 @@ void configure_queue_remote_device_operations(mesh_provision_cb_t *p_cb)
 #endif
                 {
                     app_key = wiced_bt_mesh_db_app_key_get_by_name(p_mesh_db, "Generic");
-                    model_app_bind(p_cb, WICED_FALSE, p_cb->addr + element_idx, MESH_COMPANY_ID_BT_SIG, model_id, app_key->index);
+                    model_app_bind(p_cb, 0, p_cb->addr + element_idx, MESH_COMPANY_ID_BT_SIG, model_id, app_key->index);
                 }
 #ifdef USE_SETUP_APPKEY
                 {
                     app_key_setup = wiced_bt_mesh_db_app_key_get_by_name(p_mesh_db, "Setup");
-                    model_app_bind(p_cb, WICED_FALSE, p_cb->addr + element_idx, MESH_COMPANY_ID_BT_SIG, model_id, app_key_setup->index);
+                    model_app_bind(p_cb, 0, p_cb->addr + element_idx, MESH_COMPANY_ID_BT_SIG, model_id, app_key_setup->index);
                 }
 #endif
                 if ((p_group_list != NULL) && model_needs_sub(model_id, p_models_array))
@@ -7890,7 +8289,7 @@ void configure_queue_remote_device_operations(mesh_provision_cb_t *p_cb)
                     app_key_add(p_cb, p_cb->addr, net_key, app_key);
                 }
                 app_key = wiced_bt_mesh_db_app_key_get_by_name(p_mesh_db, "Generic");
-                model_app_bind(p_cb, WICED_FALSE, p_cb->addr + element_idx, MESH_COMPANY_ID_BT_SIG, model_id, app_key->index);
+                model_app_bind(p_cb, 0, p_cb->addr + element_idx, MESH_COMPANY_ID_BT_SIG, model_id, app_key->index);
 
                 // if this a client model (for example a switch we need to configure publication.  We also
                 // configure publication for top level servers of the device.  For example a color bulb will be configured
@@ -7992,7 +8391,7 @@ void configure_queue_remote_device_operations(mesh_provision_cb_t *p_cb)
                 if (company_id != p_cb->company_id)
                     continue;
 
-                model_app_bind(p_cb, WICED_FALSE, p_cb->addr + element_idx, company_id, model_id, p_app_key->index);
+                model_app_bind(p_cb, 0, p_cb->addr + element_idx, company_id, model_id, p_app_key->index);
                 if (p_group_list != NULL)
                 {
                     for (k = 0; p_group_list[k] != 0; k++)
@@ -8190,6 +8589,8 @@ void configure_queue_remote_device_operations(mesh_provision_cb_t *p_cb)
 
 void configure_execute_pending_operation(mesh_provision_cb_t *p_cb)
 {
+    int i;
+
     if (p_cb->p_first != NULL)
     {
         if (wiced_start_timer(&p_cb->op_timer, 1) != WICED_BT_SUCCESS)
@@ -8199,12 +8600,20 @@ void configure_execute_pending_operation(mesh_provision_cb_t *p_cb)
     {
         if (p_cb->p_local_composition_data)
         {
+            // devices of the additional HCI transports are configured after the local device
+            if (configure_next_local_transport(p_cb))
+                return;
+
             wiced_bt_free_buffer(p_cb->p_local_composition_data);
             p_cb->p_local_composition_data = NULL;
 
             if (p_cb->store_config)
             {
-                wiced_bt_mesh_db_node_config_complete(p_mesh_db, p_cb->unicast_addr, WICED_TRUE);
+                for (i = 0; i < mesh_hci_transport_num(); i++)
+                {
+                    if (p_cb->transport_addr[i] != 0)
+                        wiced_bt_mesh_db_node_config_complete(p_mesh_db, p_cb->transport_addr[i], WICED_TRUE);
+                }
                 wiced_bt_mesh_db_store(p_mesh_db);
 
                 if (p_cb->p_database_changed)
@@ -9487,6 +9896,266 @@ uint16_t *mesh_get_group_list(uint16_t group_addr, uint16_t company_id, uint16_t
     return group_list;
 }
 
+/*
+ * Address plan.
+ * When a command is sent to a set of components and groups, the targets are expanded to the list of elements with
+ * the model, and the groups from the database are checked to find the cheapest way to reach all of them.
+ * The cost of a plan is the number of messages sent plus the number of status replies expected.
+ * A group is used to reach the targets only if it saves at least one message or reply compared to sending
+ * a unicast message to each of the targets covered by the group. Groups that contain elements which are not
+ * targets are only considered for messages that do not change the state (MESH_CLIENT_ADDRESS_PLAN_FLAG_GET),
+ * and replies from the extra elements are counted in the cost. Besides the groups from the database, the whole
+ * network (all-nodes address, which is selected by the network name) is also a candidate.
+ */
+#ifndef MESH_CLIENT_ADDRESS_PLAN_MESSAGE_COST
+#define MESH_CLIENT_ADDRESS_PLAN_MESSAGE_COST   1
+#endif
+#ifndef MESH_CLIENT_ADDRESS_PLAN_REPLY_COST
+#define MESH_CLIENT_ADDRESS_PLAN_REPLY_COST     1
+#endif
+
+/*
+ * Fills the list of elements with specified model which are subscribed to the group. Same as mesh_get_group_list,
+ * but uses the buffer provided by the caller and does not trace empty groups. Address 0xFFFF means all elements.
+ * Blocked nodes do not have the current keys, so their elements are neither targets nor expected to reply.
+ */
+static uint16_t address_plan_get_group_members(uint16_t group_addr, uint16_t company_id, uint16_t model_id, uint16_t *p_members)
+{
+    wiced_bt_mesh_db_element_t *p_element;
+    int node_idx, element_idx, model_idx, sub_idx;
+    uint16_t num_members = 0;
+    wiced_bool_t has_model, is_subscribed;
+
+    for (node_idx = 0; node_idx < p_mesh_db->num_nodes; node_idx++)
+    {
+        if (p_mesh_db->node[node_idx].blocked)
+            continue;
+
+        for (element_idx = 0; element_idx < p_mesh_db->node[node_idx].num_elements; element_idx++)
+        {
+            p_element = &p_mesh_db->node[node_idx].element[element_idx];
+            has_model = WICED_FALSE;
+            is_subscribed = (group_addr == 0xFFFF);
+
+            for (model_idx = 0; model_idx < p_element->num_models; model_idx++)
+            {
+                if ((p_element->model[model_idx].model.company_id == company_id) && (p_element->model[model_idx].model.id == model_id))
+                    has_model = WICED_TRUE;
+
+                for (sub_idx = 0; !is_subscribed && (sub_idx < p_element->model[model_idx].num_subs); sub_idx++)
+                {
+                    if (p_element->model[model_idx].sub[sub_idx].u.address == group_addr)
+                        is_subscribed = WICED_TRUE;
+                }
+            }
+            if (has_model && is_subscribed)
+                p_members[num_members++] = p_mesh_db->node[node_idx].unicast_address + element_idx;
+        }
+    }
+    return num_members;
+}
+
+static wiced_bool_t address_plan_add_target(uint16_t *p_targets, uint16_t *num_targets, uint16_t addr)
+{
+    uint16_t i;
+
+    for (i = 0; i < *num_targets; i++)
+    {
+        if (p_targets[i] == addr)
+            return WICED_FALSE;
+    }
+    p_targets[(*num_targets)++] = addr;
+    return WICED_TRUE;
+}
+
+int mesh_client_address_plan_get(const char **p_names, uint16_t num_names, uint16_t company_id, uint16_t model_id, uint8_t flags, mesh_client_address_plan_t *p_plan)
+{
+    uint16_t *p_targets, *p_members;
+    uint8_t *p_covered;
+    uint16_t max_elements = 0, num_targets = 0, num_members, num_covered, best_group, best_covered = 0, best_members = 0;
+    uint32_t unicast_cost, group_cost, best_saving;
+    uint32_t reply_cost = (flags & MESH_CLIENT_ADDRESS_PLAN_FLAG_RELIABLE) ? MESH_CLIENT_ADDRESS_PLAN_REPLY_COST : 0;
+    uint16_t addr;
+    int i, j, k;
+
+    memset(p_plan, 0, sizeof(mesh_client_address_plan_t));
+
+    if (p_mesh_db == NULL)
+    {
+        Log("Network closed\n");
+        return MESH_CLIENT_ERR_NETWORK_CLOSED;
+    }
+    if ((p_names == NULL) || (num_names == 0))
+        return MESH_CLIENT_ERR_INVALID_ARGS;
+
+    for (i = 0; i < p_mesh_db->num_nodes; i++)
+        max_elements += p_mesh_db->node[i].num_elements;
+
+    if (max_elements == 0)
+        return MESH_CLIENT_ERR_NOT_FOUND;
+
+    p_targets = (uint16_t *)wiced_bt_get_buffer(2 * max_elements * sizeof(uint16_t) + max_elements);
+    p_plan->entry = (mesh_client_address_plan_entry_t *)wiced_bt_get_buffer(max_elements * sizeof(mesh_client_address_plan_entry_t));
+    if ((p_targets == NULL) || (p_plan->entry == NULL))
+    {
+        wiced_bt_free_buffer(p_targets);
+        wiced_bt_free_buffer(p_plan->entry);
+        p_plan->entry = NULL;
+        return MESH_CLIENT_ERR_NO_MEMORY;
+    }
+    p_members = &p_targets[max_elements];
+    p_covered = (uint8_t *)&p_members[max_elements];
+
+    // expand components and groups to the list of target elements
+    for (i = 0; i < num_names; i++)
+    {
+        if ((addr = get_device_addr(p_names[i])) != 0)
+        {
+            if (!is_model_present(addr, company_id, model_id))
+            {
+                Log("model %04x:%04x not present on %s\n", company_id, model_id, p_names[i]);
+                continue;
+            }
+            address_plan_add_target(p_targets, &num_targets, addr);
+        }
+        else if ((addr = get_group_addr(p_names[i])) != 0)
+        {
+            num_members = address_plan_get_group_members(addr, company_id, model_id, p_members);
+            for (j = 0; j < num_members; j++)
+                address_plan_add_target(p_targets, &num_targets, p_members[j]);
+        }
+        else
+        {
+            Log("%s not found in DB\n", p_names[i]);
+        }
+    }
+    if (num_targets == 0)
+    {
+        wiced_bt_free_buffer(p_targets);
+        wiced_bt_free_buffer(p_plan->entry);
+        p_plan->entry = NULL;
+        return MESH_CLIENT_ERR_METHOD_NOT_AVAIL;
+    }
+    memset(p_covered, 0, num_targets);
+    p_plan->num_targets = (uint16_t)num_targets;
+    p_plan->unicast_cost = num_targets * (MESH_CLIENT_ADDRESS_PLAN_MESSAGE_COST + reply_cost);
+
+    // greedily take the group which saves the most until no group can save anything
+    for (;;)
+    {
+        best_group = 0xFFFF;
+        best_saving = 0;
+
+        for (i = 0; i <= p_mesh_db->num_groups; i++)
+        {
+            addr = (i == p_mesh_db->num_groups) ? 0xFFFF : p_mesh_db->group[i].addr.u.address;
+            num_members = address_plan_get_group_members(addr, company_id, model_id, p_members);
+            if (num_members < 2)
+                continue;
+
+            num_covered = 0;
+            for (j = 0; j < num_members; j++)
+            {
+                for (k = 0; k < num_targets; k++)
+                {
+                    if ((p_targets[k] == p_members[j]) && !p_covered[k])
+                    {
+                        num_covered++;
+                        break;
+                    }
+                }
+            }
+            // a group which reaches an element that is not a target, or is already covered, can only be used for Get
+            if ((num_covered < num_members) && !(flags & MESH_CLIENT_ADDRESS_PLAN_FLAG_GET))
+                continue;
+
+            unicast_cost = num_covered * (MESH_CLIENT_ADDRESS_PLAN_MESSAGE_COST + reply_cost);
+            group_cost = MESH_CLIENT_ADDRESS_PLAN_MESSAGE_COST + num_members * reply_cost;
+            if ((unicast_cost > group_cost) && (unicast_cost - group_cost > best_saving))
+            {
+                best_saving  = unicast_cost - group_cost;
+                best_group   = (uint16_t)i;
+                best_covered = num_covered;
+                best_members = num_members;
+            }
+        }
+        if (best_group == 0xFFFF)
+            break;
+
+        addr = (best_group == p_mesh_db->num_groups) ? 0xFFFF : p_mesh_db->group[best_group].addr.u.address;
+        num_members = address_plan_get_group_members(addr, company_id, model_id, p_members);
+        for (j = 0; j < num_members; j++)
+        {
+            for (k = 0; k < num_targets; k++)
+            {
+                if (p_targets[k] == p_members[j])
+                    p_covered[k] = 1;
+            }
+        }
+        p_plan->entry[p_plan->num_entries].dst = addr;
+        p_plan->entry[p_plan->num_entries].num_targets = best_covered;
+        p_plan->entry[p_plan->num_entries].name = (best_group == p_mesh_db->num_groups) ? p_mesh_db->name : p_mesh_db->group[best_group].name;
+        p_plan->num_entries++;
+        p_plan->num_groups++;
+        p_plan->num_replies += (uint16_t)(reply_cost ? best_members : 0);
+    }
+
+    // the rest of the targets are reached by unicast
+    for (k = 0; k < num_targets; k++)
+    {
+        if (p_covered[k])
+            continue;
+
+        p_plan->entry[p_plan->num_entries].dst = p_targets[k];
+        p_plan->entry[p_plan->num_entries].num_targets = 1;
+        p_plan->entry[p_plan->num_entries].name = get_component_name(p_targets[k]);
+        p_plan->num_entries++;
+        p_plan->num_replies += (uint16_t)(reply_cost ? 1 : 0);
+    }
+    p_plan->num_messages = p_plan->num_entries;
+    p_plan->cost = p_plan->num_messages * MESH_CLIENT_ADDRESS_PLAN_MESSAGE_COST + p_plan->num_replies * MESH_CLIENT_ADDRESS_PLAN_REPLY_COST;
+
+    if (p_plan->num_groups == 0)
+        p_plan->type = MESH_CLIENT_ADDRESS_PLAN_UNICAST;
+    else if (p_plan->num_groups == p_plan->num_entries)
+        p_plan->type = MESH_CLIENT_ADDRESS_PLAN_GROUP;
+    else
+        p_plan->type = MESH_CLIENT_ADDRESS_PLAN_MIXED;
+
+    Log("Address plan type:%d targets:%d messages:%d replies:%d cost:%d unicast cost:%d\n", p_plan->type, p_plan->num_targets, p_plan->num_messages, p_plan->num_replies, p_plan->cost, p_plan->unicast_cost);
+
+    wiced_bt_free_buffer(p_targets);
+    return MESH_CLIENT_SUCCESS;
+}
+
+void mesh_client_address_plan_free(mesh_client_address_plan_t *p_plan)
+{
+    wiced_bt_free_buffer(p_plan->entry);
+    p_plan->entry = NULL;
+    p_plan->num_entries = 0;
+}
+
+int mesh_client_address_plan_dispatch(const char **p_names, uint16_t num_names, uint16_t company_id, uint16_t model_id, uint8_t flags,
+                                      mesh_client_address_plan_send_t p_send, mesh_client_address_plan_t *p_plan)
+{
+    int i, res, status;
+
+    if (p_send == NULL)
+        return MESH_CLIENT_ERR_INVALID_ARGS;
+
+    if ((status = mesh_client_address_plan_get(p_names, num_names, company_id, model_id, flags, p_plan)) != MESH_CLIENT_SUCCESS)
+        return status;
+
+    // send to all destinations even if one fails, and return the first error
+    for (i = 0; i < p_plan->num_entries; i++)
+    {
+        Log("Address plan send to %s addr:%04x targets:%d\n", p_plan->entry[i].name, p_plan->entry[i].dst, p_plan->entry[i].num_targets);
+        if (((res = p_send(p_plan->entry[i].name, p_plan->entry[i].dst)) != MESH_CLIENT_SUCCESS) && (status == MESH_CLIENT_SUCCESS))
+            status = res;
+    }
+    return status;
+}
+
 /*
  * Identify method sends a message to a device or a group of device to identify itself for a certain duration.
  */
@@ -10515,7 +11184,7 @@ int mesh_client_add_vendor_model(uint16_t company_id, uint16_t model_id, uint8_t
 #else
     app_key = wiced_bt_mesh_db_app_key_get_by_name(p_mesh_db, "Generic");
 #endif
-    model_app_bind(p_cb, WICED_TRUE, p_cb->unicast_addr, company_id, model_id, app_key->index);
+    model_app_bind(p_cb, p_cb->unicast_addr, p_cb->unicast_addr, company_id, model_id, app_key->index);
     configure_execute_pending_operation(p_cb);
     return MESH_CLIENT_SUCCESS;
     UNUSED_VARIABLE(data_len);
@@ -597,6 +597,40 @@ int *mesh_client_sensor_property_list_get(const char *device_name);
  */
 int mesh_client_sensor_get(const char *device_name, int property_id);
 
+/*
+ * Periodically poll the sensor property (0 for all properties). Polls of all sensors are spread over time and
+ * limited by the budget configured with mesh_client_sensor_poll_configure. The poll is skipped if the sensor
+ * already publishes the property at least once per period. If the sensor property is already polled, the
+ * period is updated. The values are reported through the sensor status callback.
+ */
+int mesh_client_sensor_poll_add(const char *device_name, int property_id, uint32_t period_ms);
+
+/*
+ * Stop polling the sensor property
+ */
+int mesh_client_sensor_poll_remove(const char *device_name, int property_id);
+
+/*
+ * Set maximum number of sensor polls per second and the random jitter of each poll in percents of its period (up to 50).
+ * By default 10 polls per second are allowed with 10 percent jitter.
+ */
+void mesh_client_sensor_poll_configure(uint16_t max_msgs_per_sec, uint8_t jitter_percent);
+
+typedef struct
+{
+    uint32_t polls;                 /* number of Sensor Get messages sent */
+    uint32_t replies;               /* number of Sensor Status messages received in reply to the poll */
+    uint32_t publications;          /* number of Sensor Status messages received without the poll */
+    uint32_t skipped;               /* number of polls skipped because the sensor published the value */
+    uint32_t deferred;              /* number of times polls were delayed because the budget was exhausted */
+    uint32_t reply_timeouts;        /* number of polls not replied within the reply timeout */
+} mesh_client_sensor_poll_stats_t;
+
+/*
+ * Get sensor poll scheduler statistics
+ */
+void mesh_client_sensor_poll_stats_get(mesh_client_sensor_poll_stats_t *p_stats);
+
 /*
  * LC Mode status callback is executed as a result of the Get/Set operation
  */
@@ -660,6 +694,189 @@ int mesh_client_light_lc_on_off_set(const char* p_name, uint8_t on_off, wiced_bo
  */
 int mesh_client_listen_for_app_group_broadcasts(char *control_method, char *group_name, wiced_bool_t start_listen);
 
+/*
+ * Address plan describes how a command for a set of components and groups is sent. Targets can be reached
+ * by a group address, by a unicast address of each element, or by a mix of both, whichever requires less
+ * messages and status replies.
+ */
+#define MESH_CLIENT_ADDRESS_PLAN_UNICAST        0
+#define MESH_CLIENT_ADDRESS_PLAN_GROUP          1
+#define MESH_CLIENT_ADDRESS_PLAN_MIXED          2
+
+#define MESH_CLIENT_ADDRESS_PLAN_FLAG_RELIABLE  0x01    /* every element that receives the message sends a status reply */
+#define MESH_CLIENT_ADDRESS_PLAN_FLAG_GET       0x02    /* message does not change the state, it can reach elements which are not targets */
+
+typedef struct
+{
+    uint16_t    dst;                /* group or unicast address */
+    uint16_t    num_targets;        /* number of target elements reached by the message */
+    const char *name;               /* group or component name to be used with mesh_client_xxx functions */
+} mesh_client_address_plan_entry_t;
+
+typedef struct
+{
+    uint8_t     type;               /* MESH_CLIENT_ADDRESS_PLAN_UNICAST, _GROUP or _MIXED */
+    uint16_t    num_targets;        /* number of distinct target elements */
+    uint16_t    num_groups;         /* number of entries that use group address */
+    uint16_t    num_messages;       /* number of messages to be sent */
+    uint16_t    num_replies;        /* number of status replies expected */
+    uint32_t    cost;               /* cost of the plan */
+    uint32_t    unicast_cost;       /* cost if each target is sent a unicast message */
+    uint16_t    num_entries;
+    mesh_client_address_plan_entry_t *entry;
+} mesh_client_address_plan_t;
+
+/*
+ * Find the cheapest way to send a message for the model to all components and groups in the p_names list.
+ * The company_id and model_id identify the server model that should receive the message. The flags are
+ * a combination of MESH_CLIENT_ADDRESS_PLAN_FLAG_XXX. On success, the application shall release the plan
+ * with mesh_client_address_plan_free.
+ */
+int mesh_client_address_plan_get(const char **p_names, uint16_t num_names, uint16_t company_id, uint16_t model_id, uint8_t flags, mesh_client_address_plan_t *p_plan);
+
+/*
+ * Release the list of the plan entries.
+ */
+void mesh_client_address_plan_free(mesh_client_address_plan_t *p_plan);
+
+/*
+ * Send callback is executed for each entry of the address plan. The callback is expected to call one of
+ * the mesh_client_xxx_set/get functions with the name, for example mesh_client_on_off_set.
+ */
+typedef int(*mesh_client_address_plan_send_t)(const char *p_name, uint16_t dst);
+
+/*
+ * Get the address plan and execute the send callback for each of its entries. Returns the first error reported
+ * by the callback. The plan is returned for the application to check how the message was sent, and shall be
+ * released with mesh_client_address_plan_free.
+ */
+int mesh_client_address_plan_dispatch(const char **p_names, uint16_t num_names, uint16_t company_id, uint16_t model_id, uint8_t flags,
+                                      mesh_client_address_plan_send_t p_send, mesh_client_address_plan_t *p_plan);
+
+/*
+ * HCI event handler is executed by wiced_hci_process_data with the payload of the HCI event.
+ */
+typedef void(*mesh_client_hci_event_handler_t)(uint8_t *p_data, uint16_t len);
+
+/*
+ * Register a handler for the HCI event opcode. The handler replaces the library processing of the event, or adds
+ * processing for an opcode the library does not know about. Passing NULL handler restores the library processing.
+ */
+int mesh_client_hci_event_handler_register(uint16_t opcode, mesh_client_hci_event_handler_t p_handler);
+
+/*
+ * Statistics collected by wiced_hci_process_data for each received HCI event opcode.
+ */
+typedef struct
+{
+    uint16_t opcode;
+    uint32_t count;                 /* number of events received */
+    uint64_t bytes;                 /* total length of the events payload */
+    uint64_t parse_time_us;         /* cumulative time spent in the event handler, in microseconds */
+    uint32_t max_parse_time_us;     /* longest time spent in the event handler, in microseconds */
+} mesh_client_hci_event_stats_t;
+
+/*
+ * Get statistics for one HCI event opcode. Returns MESH_CLIENT_ERR_NOT_FOUND if the opcode group is not dispatched.
+ */
+int mesh_client_hci_event_stats_get(uint16_t opcode, mesh_client_hci_event_stats_t *p_stats);
+
+/*
+ * Fill up to max_entries statistics of all opcodes that have been received at least once. Returns number of entries filled.
+ */
+int mesh_client_hci_event_stats_get_all(mesh_client_hci_event_stats_t *p_stats, int max_entries);
+
+/*
+ * Clear statistics of all opcodes.
+ */
+void mesh_client_hci_event_stats_reset(void);
+
+/*
+ * Configure HCI command flow control. Up to window commands are sent to the device before the Command Status
+ * is received for the oldest of them, the following commands are queued by the library. The window is normally
+ * set to the number of command buffers reported by the device. The credit of a command that did not receive the
+ * status is returned after credit_timeout_ms (0 keeps current timeout, 1000 ms by default). Window 0 (default)
+ * disables flow control, maximum window is 32.
+ */
+int mesh_client_hci_tx_configure(uint16_t window, uint32_t credit_timeout_ms);
+
+typedef struct
+{
+    uint16_t window;                /* configured window, 0 if flow control is disabled */
+    uint16_t outstanding;           /* number of commands sent to the device that did not receive the status */
+    uint32_t queue_depth;           /* number of commands currently queued */
+    uint32_t max_queue_depth;       /* maximum number of commands queued at the same time */
+    uint32_t sent;                  /* number of commands sent to the device */
+    uint32_t queued;                /* number of commands that could not be sent immediately */
+    uint32_t credit_timeouts;       /* number of credits returned because the status was not received in time */
+    uint64_t stall_time_us;         /* cumulative time the queue was not empty, in microseconds */
+    uint32_t max_stall_time_us;     /* longest time the queue was not empty, in microseconds */
+} mesh_client_hci_tx_stats_t;
+
+/*
+ * Get HCI command flow control statistics of the first HCI transport.
+ */
+void mesh_client_hci_tx_stats_get(mesh_client_hci_tx_stats_t *p_stats);
+
+/*
+ * Additional HCI transports. Each transport is a device that the library configures as a separate provisioner
+ * node of the same network when the network is opened, so transports have to be added before that. Commands to
+ * the models of the network nodes are spread between the transports, preferring the one that receives the node
+ * with the best RSSI unless it is busier than the others. Provisioning, configuration and proxy commands are
+ * always sent over the first transport, which uses wiced_hci_send and wiced_hci_process_data. Events received
+ * from the additional transport are passed to mesh_client_hci_transport_process_data.
+ */
+#define MESH_CLIENT_HCI_MAX_TRANSPORTS  8
+
+typedef uint8_t (*mesh_client_hci_transport_send_t)(uint8_t transport, uint16_t opcode, uint8_t *p_data, uint16_t len);
+
+/*
+ * Add HCI transport. On success the index of the transport is returned in p_transport.
+ */
+int mesh_client_hci_transport_add(mesh_client_hci_transport_send_t p_send, uint8_t *p_transport);
+
+/*
+ * Process HCI event received from the transport. Transport 0 is the same as wiced_hci_process_data.
+ */
+void mesh_client_hci_transport_process_data(uint8_t transport, uint16_t opcode, uint8_t *p_data, uint16_t len);
+
+typedef struct
+{
+    uint16_t addr;                  /* unicast address of the device, 0 if it is not configured */
+    uint32_t balanced;              /* number of model commands sent over the transport */
+    uint32_t routed;                /* number of the model commands sent to a node with a known route */
+    mesh_client_hci_tx_stats_t tx;  /* flow control statistics of the transport */
+} mesh_client_hci_transport_stats_t;
+
+/*
+ * Get statistics of the HCI transport. Returns MESH_CLIENT_ERR_NOT_FOUND if the transport does not exist.
+ */
+int mesh_client_hci_transport_stats_get(uint8_t transport, mesh_client_hci_transport_stats_t *p_stats);
+
+/*
+ * Statistics of the mesh event pool. Events for the messages sent and received are taken from the pool,
+ * misses count events that were allocated from the heap because the pool was exhausted.
+ */
+typedef struct
+{
+    uint32_t capacity;              /* number of events in the pool, 0 if the pool has not been created yet */
+    uint32_t in_use;                /* number of pool events currently allocated */
+    uint32_t high_water_mark;       /* maximum number of pool events allocated at the same time */
+    uint32_t hits;                  /* number of events allocated from the pool */
+    uint32_t misses;                /* number of events allocated from the heap */
+} mesh_client_event_pool_stats_t;
+
+/*
+ * Set number of events in the mesh event pool. The pool is created on the first use, and the capacity can only
+ * be changed before that. Capacity 0 disables the pool.
+ */
+int mesh_client_event_pool_set_capacity(uint16_t capacity);
+
+/*
+ * Get mesh event pool statistics.
+ */
+void mesh_client_event_pool_stats_get(mesh_client_event_pool_stats_t *p_stats);
+
 typedef struct
 {
     mesh_client_unprovisioned_device_t unprovisioned_device_callback;
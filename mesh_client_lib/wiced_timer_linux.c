@@ -0,0 +1,260 @@
+/*
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+*
+* WICED timers implementation for Linux hosts. The timers are kept in a hashed hierarchical timer wheel and
+* a single timerfd is armed for the next time the wheel has work. The host adds the timerfd to its poll or
+* epoll loop, or to the event loop of its UI toolkit, so that the timers are executed in the same thread as
+* the HCI processing and never race with it.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/timerfd.h>
+
+#include "wiced.h"
+#include "wiced_timer.h"
+#include "wiced_timer_wheel.h"
+#include "wiced_timer_linux.h"
+
+extern void Log(char *fmt, ...);
+
+#define TIMER_ACTIVE          0x0001
+
+typedef struct _tle
+{
+    wiced_timer_wheel_node_t node;          /* must be first */
+    wiced_timer_callback_t   p_cback;
+    uint16_t                 flags;         /* Flags for timer*/
+    uint16_t                 type;
+    uint32_t                 interval;      /* Periodical time out inteval, in ms */
+    TIMER_PARAM_TYPE         arg;           /* parameter for expiration function */
+} TIMER_LIST_ENT;
+
+typedef char timer_list_ent_fits_wiced_timer[(sizeof(TIMER_LIST_ENT) <= sizeof(wiced_timer_t)) ? 1 : -1];
+
+static wiced_timer_wheel_t timer_wheel;
+static uint64_t            timer_armed = WICED_TIMER_WHEEL_NEVER;
+static int                 timer_fd = -1;
+static linux_timer_stats_t timer_stats;
+
+// Upper bounds of the lateness histogram buckets in us, the last bucket has the rest
+static const uint32_t timer_late_bucket_us[LINUX_TIMER_LATE_BUCKETS - 1] = { 1000, 2000, 5000, 10000, 50000 };
+
+uint64_t linux_timer_now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static uint64_t linux_timer_now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Count how late the timer runs, the time from its expiration until the callback is called
+static void linux_timer_stats_update(uint64_t expire_ms)
+{
+    uint64_t now_us = linux_timer_now_us();
+    uint32_t late_us = (now_us > expire_ms * 1000) ? (uint32_t)(now_us - expire_ms * 1000) : 0;
+    int      i;
+
+    for (i = 0; i < LINUX_TIMER_LATE_BUCKETS - 1; i++)
+    {
+        if (late_us < timer_late_bucket_us[i])
+            break;
+    }
+    timer_stats.late_hist[i]++;
+    timer_stats.fired++;
+    timer_stats.late_us_total += late_us;
+    if (late_us > timer_stats.late_us_max)
+        timer_stats.late_us_max = late_us;
+}
+
+// Arm the timerfd for the next time the wheel has work, or disarm it if the wheel is empty
+static void linux_timer_rearm(void)
+{
+    struct itimerspec its;
+    uint64_t          next = wiced_timer_wheel_next(&timer_wheel);
+
+    if (next == timer_armed)
+        return;
+    timer_armed = next;
+
+    memset(&its, 0, sizeof(its));
+    if (next != WICED_TIMER_WHEEL_NEVER)
+    {
+        // zero it_value disarms the timer, expire at least 1ns from the epoch instead
+        its.it_value.tv_sec  = next / 1000;
+        its.it_value.tv_nsec = (next % 1000) * 1000000 + 1;
+    }
+    timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+static uint64_t linux_timer_expire_time(TIMER_LIST_ENT *p_timer, uint64_t now)
+{
+    if ((p_timer->type == WICED_SECONDS_TIMER) || (p_timer->type == WICED_SECONDS_PERIODIC_TIMER))
+        return now + p_timer->interval * 1000ULL;
+    return now + p_timer->interval;
+}
+
+int linux_timer_init(void)
+{
+    wiced_timer_wheel_init(&timer_wheel, linux_timer_now_ms());
+
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer_fd < 0)
+        perror("timerfd_create");
+    return timer_fd;
+}
+
+void linux_timer_process(void)
+{
+    uint64_t        expirations;
+    uint64_t        now;
+    TIMER_LIST_ENT *p_timer;
+
+    // clear readable state of the timerfd
+    if (read(timer_fd, &expirations, sizeof(expirations)) < 0)
+        expirations = 0;
+
+    now = linux_timer_now_ms();
+    timer_armed = WICED_TIMER_WHEEL_NEVER;
+
+    // callbacks can start and stop any timer, take expired timers off the wheel one at a time
+    while ((p_timer = (TIMER_LIST_ENT *)wiced_timer_wheel_expire(&timer_wheel, now)) != NULL)
+    {
+        p_timer->flags &= ~TIMER_ACTIVE;
+        linux_timer_stats_update(p_timer->node.expire);
+
+        if ((p_timer->type == WICED_SECONDS_PERIODIC_TIMER) || (p_timer->type == WICED_MILLI_SECONDS_PERIODIC_TIMER))
+        {
+            expirations = linux_timer_expire_time(p_timer, p_timer->node.expire);
+
+            // do not try to catch up if the loop was blocked for longer than the period
+            if (expirations <= now)
+                expirations = now + 1;
+            wiced_timer_wheel_add(&timer_wheel, &p_timer->node, expirations);
+            p_timer->flags |= TIMER_ACTIVE;
+        }
+        if (p_timer->p_cback)
+            p_timer->p_cback(p_timer->arg);
+    }
+    linux_timer_rearm();
+}
+
+void linux_timer_stats_get(linux_timer_stats_t *p_stats, int reset)
+{
+    *p_stats = timer_stats;
+    if (reset)
+        memset(&timer_stats, 0, sizeof(timer_stats));
+}
+
+wiced_result_t wiced_init_timer(wiced_timer_t* p_timer, wiced_timer_callback_t TimerCb, TIMER_PARAM_TYPE cBackparam, wiced_timer_type_t type)
+{
+    TIMER_LIST_ENT *p = (TIMER_LIST_ENT *)p_timer;
+
+    // a timer can be initialized again while it is running
+    if (p->flags & TIMER_ACTIVE)
+        wiced_stop_timer(p_timer);
+
+    memset(p_timer, 0, sizeof(TIMER_LIST_ENT));
+    p->p_cback  = TimerCb;
+    p->arg      = cBackparam;
+    p->type     = type;
+
+    return WICED_BT_SUCCESS;
+}
+
+wiced_result_t wiced_deinit_timer(wiced_timer_t* p_timer)
+{
+    return wiced_stop_timer(p_timer);
+}
+
+wiced_result_t wiced_start_timer(wiced_timer_t* wt, uint32_t timeout)
+{
+    TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)wt;
+
+    if (!p_timer->p_cback)
+    {
+        Log("wiced_start_timer timer not initialized");
+        return WICED_BT_ERROR;
+    }
+
+    // Make sure that we are not starting the same timer twice.
+    if (p_timer->flags & TIMER_ACTIVE)
+        wiced_timer_wheel_remove(&timer_wheel, &p_timer->node);
+
+    p_timer->interval = timeout;
+    wiced_timer_wheel_add(&timer_wheel, &p_timer->node, linux_timer_expire_time(p_timer, linux_timer_now_ms()));
+    p_timer->flags |= TIMER_ACTIVE;
+
+    // the timerfd only has to move if the timer is due before it fires
+    if (p_timer->node.expire < timer_armed)
+        linux_timer_rearm();
+
+    return WICED_BT_SUCCESS;
+}
+
+wiced_result_t wiced_stop_timer(wiced_timer_t* wt)
+{
+    TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)wt;
+
+    if (!(p_timer->flags & TIMER_ACTIVE))
+        return WICED_BT_SUCCESS;
+
+    p_timer->flags &= ~TIMER_ACTIVE;
+
+    // a timerfd that fires early finds nothing expired and rearms itself
+    wiced_timer_wheel_remove(&timer_wheel, &p_timer->node);
+
+    return WICED_BT_SUCCESS;
+}
+
+wiced_bool_t wiced_is_timer_in_use(wiced_timer_t *p)
+{
+    TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)p;
+
+    if (p_timer->flags & TIMER_ACTIVE)
+        return WICED_TRUE;
+    else
+        return WICED_FALSE;
+}
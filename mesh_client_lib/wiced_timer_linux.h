@@ -0,0 +1,88 @@
+/*
+* Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+* wiced_timer_linux.h : WICED timers for Linux hosts
+*
+* All WICED timers are driven by one timerfd. The host adds the descriptor to its poll or epoll loop and calls
+* linux_timer_process in the thread that runs the mesh client library when the descriptor becomes readable.
+*/
+#ifndef WICED_TIMER_LINUX__H
+#define WICED_TIMER_LINUX__H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Create the timerfd that drives all WICED timers. Returns the descriptor, -1 on failure.
+ */
+int linux_timer_init(void);
+
+/*
+ * Execute callbacks of all expired timers and rearm the timerfd for the next one.
+ */
+void linux_timer_process(void);
+
+/*
+ * Current time of the monotonic clock in milliseconds
+ */
+uint64_t linux_timer_now_ms(void);
+
+/*
+ * How late the timer callbacks run after the expiration time. The histogram buckets count callbacks that
+ * were less than 1, 2, 5, 10 and 50 ms late, the last one the rest.
+ */
+#define LINUX_TIMER_LATE_BUCKETS    6
+
+typedef struct
+{
+    uint64_t fired;                                 /* timer callbacks executed */
+    uint64_t late_us_total;
+    uint32_t late_us_max;
+    uint32_t late_hist[LINUX_TIMER_LATE_BUCKETS];
+} linux_timer_stats_t;
+
+/*
+ * Copy the statistics, and clear them if reset is not 0
+ */
+void linux_timer_stats_get(linux_timer_stats_t *p_stats, int reset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WICED_TIMER_LINUX__H */
@@ -0,0 +1,248 @@
+/*
+* Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+*
+* Hashed hierarchical timer wheel used by the host timer implementations
+*/
+
+#include <stddef.h>
+
+#include "wiced_timer_wheel.h"
+
+#define WHEEL_L0_MASK       (WICED_TIMER_WHEEL_L0_SIZE - 1)
+#define WHEEL_LN_MASK       (WICED_TIMER_WHEEL_LN_SIZE - 1)
+#define WHEEL_MAX_TIMEOUT   0xFFFFFFFFULL
+
+static void wheel_list_init(wiced_timer_wheel_node_t *p_head)
+{
+    p_head->p_next = p_head;
+    p_head->p_prev = p_head;
+}
+
+static void wheel_list_append(wiced_timer_wheel_node_t *p_head, wiced_timer_wheel_node_t *p_node)
+{
+    p_node->p_next         = p_head;
+    p_node->p_prev         = p_head->p_prev;
+    p_head->p_prev->p_next = p_node;
+    p_head->p_prev         = p_node;
+}
+
+static void wheel_list_unlink(wiced_timer_wheel_node_t *p_node)
+{
+    p_node->p_prev->p_next = p_node->p_next;
+    p_node->p_next->p_prev = p_node->p_prev;
+    p_node->p_next = NULL;
+    p_node->p_prev = NULL;
+}
+
+// Put the node in the slot for its expiration time, the level depends on how far it is from now
+static void wheel_insert(wiced_timer_wheel_t *p_wheel, wiced_timer_wheel_node_t *p_node)
+{
+    uint64_t delta = p_node->expire - p_wheel->now;
+    uint32_t shift = WICED_TIMER_WHEEL_L0_BITS;
+    int      level;
+
+    if (p_node->expire <= p_wheel->now)
+    {
+        wheel_list_append(&p_wheel->expired, p_node);
+        return;
+    }
+    if (delta < WICED_TIMER_WHEEL_L0_SIZE)
+    {
+        wheel_list_append(&p_wheel->level0[p_node->expire & WHEEL_L0_MASK], p_node);
+        return;
+    }
+    for (level = 0; level < WICED_TIMER_WHEEL_LEVELS - 1; level++, shift += WICED_TIMER_WHEEL_LN_BITS)
+    {
+        if (delta < (1ULL << (shift + WICED_TIMER_WHEEL_LN_BITS)))
+            break;
+    }
+    wheel_list_append(&p_wheel->levels[level][(p_node->expire >> shift) & WHEEL_LN_MASK], p_node);
+}
+
+// Move the timers of a slot one level down, they are due before the slot comes around again
+static void wheel_cascade(wiced_timer_wheel_t *p_wheel, wiced_timer_wheel_node_t *p_slot)
+{
+    wiced_timer_wheel_node_t *p_node;
+
+    while (p_slot->p_next != p_slot)
+    {
+        p_node = p_slot->p_next;
+        wheel_list_unlink(p_node);
+        wheel_insert(p_wheel, p_node);
+    }
+}
+
+// Process the ms the wheel has just moved to
+static void wheel_tick(wiced_timer_wheel_t *p_wheel)
+{
+    wiced_timer_wheel_node_t *p_slot;
+    uint32_t                  shift = WICED_TIMER_WHEEL_L0_BITS;
+    uint32_t                  index;
+    int                       level;
+
+    // every time the first level wraps the next slot of the level above moves down, and so on
+    if ((p_wheel->now & WHEEL_L0_MASK) == 0)
+    {
+        for (level = 0; level < WICED_TIMER_WHEEL_LEVELS; level++, shift += WICED_TIMER_WHEEL_LN_BITS)
+        {
+            index = (uint32_t)(p_wheel->now >> shift) & WHEEL_LN_MASK;
+            wheel_cascade(p_wheel, &p_wheel->levels[level][index]);
+            if (index != 0)
+                break;
+        }
+    }
+
+    // all timers in the slot expire now, splice the slot to the end of the expired list
+    p_slot = &p_wheel->level0[p_wheel->now & WHEEL_L0_MASK];
+    if (p_slot->p_next != p_slot)
+    {
+        p_slot->p_next->p_prev          = p_wheel->expired.p_prev;
+        p_wheel->expired.p_prev->p_next = p_slot->p_next;
+        p_slot->p_prev->p_next          = &p_wheel->expired;
+        p_wheel->expired.p_prev         = p_slot->p_prev;
+        wheel_list_init(p_slot);
+    }
+}
+
+// Returns the next ms after now when a slot of the wheel has work to do
+static uint64_t wheel_next_tick(wiced_timer_wheel_t *p_wheel)
+{
+    uint64_t next = WICED_TIMER_WHEEL_NEVER;
+    uint64_t base;
+    uint32_t shift = WICED_TIMER_WHEEL_L0_BITS;
+    uint32_t index, d;
+    int      level;
+
+    if (p_wheel->count == 0)
+        return WICED_TIMER_WHEEL_NEVER;
+
+    index = (uint32_t)p_wheel->now & WHEEL_L0_MASK;
+    for (d = 1; d < WICED_TIMER_WHEEL_L0_SIZE; d++)
+    {
+        if (p_wheel->level0[(index + d) & WHEEL_L0_MASK].p_next != &p_wheel->level0[(index + d) & WHEEL_L0_MASK])
+        {
+            next = p_wheel->now + d;
+            break;
+        }
+    }
+
+    // the slots of the upper levels have work when the time reaches the start of the slot
+    for (level = 0; level < WICED_TIMER_WHEEL_LEVELS; level++, shift += WICED_TIMER_WHEEL_LN_BITS)
+    {
+        base  = p_wheel->now >> shift;
+        index = (uint32_t)base & WHEEL_LN_MASK;
+        for (d = 1; d <= WICED_TIMER_WHEEL_LN_SIZE; d++)
+        {
+            if (p_wheel->levels[level][(index + d) & WHEEL_LN_MASK].p_next != &p_wheel->levels[level][(index + d) & WHEEL_LN_MASK])
+            {
+                if (((base + d) << shift) < next)
+                    next = (base + d) << shift;
+                break;
+            }
+        }
+    }
+    return next;
+}
+
+void wiced_timer_wheel_init(wiced_timer_wheel_t *p_wheel, uint64_t now)
+{
+    int level, i;
+
+    p_wheel->now   = now;
+    p_wheel->count = 0;
+    wheel_list_init(&p_wheel->expired);
+    for (i = 0; i < WICED_TIMER_WHEEL_L0_SIZE; i++)
+        wheel_list_init(&p_wheel->level0[i]);
+    for (level = 0; level < WICED_TIMER_WHEEL_LEVELS; level++)
+    {
+        for (i = 0; i < WICED_TIMER_WHEEL_LN_SIZE; i++)
+            wheel_list_init(&p_wheel->levels[level][i]);
+    }
+}
+
+void wiced_timer_wheel_add(wiced_timer_wheel_t *p_wheel, wiced_timer_wheel_node_t *p_node, uint64_t expire)
+{
+    // the upper level covers 2^32 ms from now, about 49 days
+    if ((expire > p_wheel->now) && (expire - p_wheel->now > WHEEL_MAX_TIMEOUT))
+        expire = p_wheel->now + WHEEL_MAX_TIMEOUT;
+
+    p_node->expire = expire;
+    wheel_insert(p_wheel, p_node);
+    p_wheel->count++;
+}
+
+void wiced_timer_wheel_remove(wiced_timer_wheel_t *p_wheel, wiced_timer_wheel_node_t *p_node)
+{
+    if (p_node->p_next == NULL)
+        return;
+
+    wheel_list_unlink(p_node);
+    p_wheel->count--;
+}
+
+uint64_t wiced_timer_wheel_next(wiced_timer_wheel_t *p_wheel)
+{
+    if (p_wheel->expired.p_next != &p_wheel->expired)
+        return p_wheel->now;
+
+    return wheel_next_tick(p_wheel);
+}
+
+wiced_timer_wheel_node_t *wiced_timer_wheel_expire(wiced_timer_wheel_t *p_wheel, uint64_t now)
+{
+    wiced_timer_wheel_node_t *p_node;
+    uint64_t                  next;
+
+    // slots that are empty are skipped, the wheel jumps to the next slot with work
+    while ((p_wheel->expired.p_next == &p_wheel->expired) && (p_wheel->now < now))
+    {
+        next = wheel_next_tick(p_wheel);
+        if (next > now)
+        {
+            p_wheel->now = now;
+            break;
+        }
+        p_wheel->now = next;
+        wheel_tick(p_wheel);
+    }
+
+    p_node = p_wheel->expired.p_next;
+    if (p_node == &p_wheel->expired)
+        return NULL;
+
+    wheel_list_unlink(p_node);
+    p_wheel->count--;
+    return p_node;
+}
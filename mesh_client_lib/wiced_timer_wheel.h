@@ -0,0 +1,108 @@
+/*
+* Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+* wiced_timer_wheel.h : Hashed hierarchical timer wheel used by the host timer implementations
+*
+* The wheel has a resolution of 1 ms. Timers are kept in 256 slots for the next 256 ms and in four levels of
+* 64 slots for longer timeouts, a timer moves to a lower level when the time reaches its slot. Adding,
+* removing and expiring a timer takes constant time. The wheel does not lock, the caller serializes access.
+*/
+#ifndef WICED_TIMER_WHEEL__H
+#define WICED_TIMER_WHEEL__H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define WICED_TIMER_WHEEL_L0_BITS       8
+#define WICED_TIMER_WHEEL_LN_BITS       6
+#define WICED_TIMER_WHEEL_LEVELS        4       /* levels above the first one, they cover 2^32 ms */
+#define WICED_TIMER_WHEEL_L0_SIZE       (1 << WICED_TIMER_WHEEL_L0_BITS)
+#define WICED_TIMER_WHEEL_LN_SIZE       (1 << WICED_TIMER_WHEEL_LN_BITS)
+
+#define WICED_TIMER_WHEEL_NEVER         0xFFFFFFFFFFFFFFFFULL
+
+/* Entry embedded in the timer. The entry is not in the wheel when p_next is NULL. */
+typedef struct wiced_timer_wheel_node
+{
+    struct wiced_timer_wheel_node *p_next;
+    struct wiced_timer_wheel_node *p_prev;
+    uint64_t                       expire;  /* expiration time in ms */
+} wiced_timer_wheel_node_t;
+
+typedef struct
+{
+    uint64_t                 now;           /* last ms processed by the wheel */
+    uint32_t                 count;         /* timers in the wheel, including the expired ones */
+    wiced_timer_wheel_node_t expired;       /* timers that are due but not taken yet */
+    wiced_timer_wheel_node_t level0[WICED_TIMER_WHEEL_L0_SIZE];
+    wiced_timer_wheel_node_t levels[WICED_TIMER_WHEEL_LEVELS][WICED_TIMER_WHEEL_LN_SIZE];
+} wiced_timer_wheel_t;
+
+/*
+ * Initialize an empty wheel that starts at the time now in ms.
+ */
+void wiced_timer_wheel_init(wiced_timer_wheel_t *p_wheel, uint64_t now);
+
+/*
+ * Add the timer to expire at the time expire in ms. Times in the past expire on the next call to
+ * wiced_timer_wheel_expire. The node must not be in the wheel.
+ */
+void wiced_timer_wheel_add(wiced_timer_wheel_t *p_wheel, wiced_timer_wheel_node_t *p_node, uint64_t expire);
+
+/*
+ * Remove the timer from the wheel. Does nothing if the node is not in the wheel.
+ */
+void wiced_timer_wheel_remove(wiced_timer_wheel_t *p_wheel, wiced_timer_wheel_node_t *p_node);
+
+/*
+ * Return the next time the wheel has to be called, WICED_TIMER_WHEEL_NEVER if it is empty. The time can be
+ * earlier than the first expiration when timers move to a lower level.
+ */
+uint64_t wiced_timer_wheel_next(wiced_timer_wheel_t *p_wheel);
+
+/*
+ * Take the next timer that expired at or before the time now, NULL if there is none. The timer is removed
+ * from the wheel. Timers come out in the order of their expiration times, with 1 ms resolution.
+ */
+wiced_timer_wheel_node_t *wiced_timer_wheel_expire(wiced_timer_wheel_t *p_wheel, uint64_t now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WICED_TIMER_WHEEL__H */
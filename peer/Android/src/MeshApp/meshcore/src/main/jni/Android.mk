@@ -66,10 +66,12 @@ MY_CPP_LIST += $(wildcard $(LOCAL_PATH)/mesh_libs/ccm.cpp)
 MY_CPP_LIST += $(wildcard $(LOCAL_PATH)/mesh_libs/p_256_ecc_pp.c)
 MY_CPP_LIST += $(wildcard $(LOCAL_PATH)/mesh_libs/p_256_curvepara.c)
 MY_CPP_LIST += $(wildcard $(LOCAL_PATH)/mesh_libs/p_256_multprecision.c)
+MY_CPP_LIST += $(wildcard $(LOCAL_PATH)/mesh_libs/ecdh_pool.c)
 MY_CPP_LIST += $(wildcard $(LOCAL_PATH)/mesh_libs/sha2.c)
 MY_CPP_LIST += $(wildcard $(MESH_CLIENT_LIB_PATH)/meshdb.c)
 MY_CPP_LIST += $(wildcard $(MESH_CLIENT_LIB_PATH)/wiced_bt_mesh_db.c)
 MY_CPP_LIST += $(wildcard $(MESH_CLIENT_LIB_PATH)/wiced_mesh_client.c)
+MY_CPP_LIST += $(wildcard $(MESH_CLIENT_LIB_PATH)/wiced_timer_wheel.c)
 ifeq ($(MESH_DFU_SUPPORT), TRUE)
 LOCAL_CFLAGS += -DMESH_DFU_ENABLED
 MY_CPP_LIST += $(wildcard $(LOCAL_PATH)/mesh_libs/mesh_fw_provider.c)
@@ -63,6 +63,7 @@ static void mesh_control_message_handler(uint16_t event, wiced_bt_mesh_event_t *
 static void mesh_sensor_message_handler(uint16_t event, wiced_bt_mesh_event_t* p_event, void* p_data);
 static void mesh_core_state_changed(wiced_bt_mesh_core_state_type_t type, wiced_bt_mesh_core_state_t *p_state);
 extern void mesh_provision_process_event(uint16_t event, wiced_bt_mesh_event_t *p_event, void *p_data);
+extern void hmac_sha256_cache_invalidate(void);
 
 extern void proxy_gatt_send_cb(uint32_t conn_id, uint32_t ref_data, const uint8_t *packet, uint32_t packet_len);
 static uint32_t mesh_nvram_access(wiced_bool_t write, int inx, uint8_t* value, uint16_t len, wiced_result_t *p_result);
@@ -246,9 +247,28 @@ void mesh_app_aes_encrypt(uint8_t* in_data, uint8_t* out_data, uint8_t* key)
     aes_encrypt(in_data, out_data, aes);
 }
 
+// key pair pool implemented in the ecdh_pool.c module of the mesh_libs
+void ecdh_pool_start(uint32_t size);
+void ecdh_pool_stop(void);
+void ecdh_pool_arm(void);
+wiced_bool_t ecdh_pool_take_priv_key(uint32_t *priv_key, uint32_t length);
+
+// Number of provisioning key pairs kept ready in the background, 0 disables the pool
+#ifndef MESH_APP_ECDH_POOL_SIZE
+#define MESH_APP_ECDH_POOL_SIZE     2
+#endif
+
+// The private key of the first provisioning key generation after the pool is armed
+// comes from the key pair pool when it has one ready, see ecdh_pool_take_priv_key
+void mesh_app_rand_gen_num_array(uint32_t* randNumberArrayPtr, uint32_t length)
+{
+    if (!ecdh_pool_take_priv_key(randNumberArrayPtr, length))
+        wiced_hal_rand_gen_num_array(randNumberArrayPtr, length);
+}
+
 wiced_bt_mesh_core_hal_api_t mesh_app_hal_api =
 {
-    .rand_gen_num_array = wiced_hal_rand_gen_num_array,
+    .rand_gen_num_array = mesh_app_rand_gen_num_array,
     .get_pseudo_rand_number = wiced_hal_get_pseudo_rand_number,
     .rand_gen_num = wiced_hal_rand_gen_num,
     .wdog_reset_system = wiced_hal_wdog_reset_system,
@@ -322,12 +342,15 @@ void mesh_application_init(void)
         wiced_bt_mesh_remote_provisioning_server_init();
         wiced_bt_mesh_core_start();
     }
+    // the core stays initialized, the pool is stopped on every deinit
+    ecdh_pool_start(MESH_APP_ECDH_POOL_SIZE);
     mesh_app_init(WICED_TRUE);
 
 }
 void mesh_application_deinit(void)
 {
     mesh_app_init(WICED_FALSE);
+    ecdh_pool_stop();
 }
 
 /*
@@ -422,6 +445,13 @@ void mesh_app_init(wiced_bool_t is_provisioned)
 void mesh_provision_message_handler(uint16_t event, wiced_bt_mesh_event_t *p_event, void *p_data)
 {
     WICED_BT_TRACE("provision message:%d\n", event);
+    // the provisioning HMAC keys are not used after the session, the next session
+    // starts with a key generation
+    if (event == WICED_BT_MESH_PROVISION_END)
+    {
+        hmac_sha256_cache_invalidate();
+        ecdh_pool_arm();
+    }
     mesh_provision_process_event(event, p_event, p_data);
 }
 
@@ -104,6 +104,25 @@ extern "C"
         const aes_context ctx[1]);
 #endif
 
+#if defined( AES_ENC_PREKEYED )
+
+    /*  aes_encrypt runs the fastest implementation available on the CPU,
+        the key schedule in aes_context is the same for all of them.  The
+        byte and table versions always exist, the hardware version uses
+        AES-NI on x86 or the ARMv8 crypto extensions on AArch64 when the
+        CPU has them.  aes_select_impl forces one version, it is meant for
+        tests and returns non zero if the version is not available.
+        */
+
+#define AES_IMPL_BYTE       0   /* 8-bit operations on the cipher state  */
+#define AES_IMPL_TABLE      1   /* 32-bit T-table lookups                */
+#define AES_IMPL_HW         2   /* AES instructions of the CPU           */
+
+    return_type aes_select_impl(int impl);
+
+    int aes_get_impl(void);
+#endif
+
 #if defined( AES_DEC_PREKEYED )
 
     return_type aes_decrypt(const unsigned char in[N_BLOCK],
@@ -0,0 +1,248 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+*
+* Pool of P-256 key pairs for back-to-back provisioning.
+*
+* The core creates the provisioning key pair by asking the HAL for 8 random words and
+* passing them to ecdh_create_pub_key(), which multiplies G by them. With the pool
+* running, the HAL hands out the private key of a pair computed in the background and
+* the multiplication of G by that key returns the stored public key. Only the first
+* 8-word request after start or ecdh_pool_arm() is served, so other random requests
+* of the core do not burn pairs. Every pair is handed out once and wiped.
+*/
+
+#include "bt_target.h"
+#include "wiced_bt_app_common.h"
+
+#if SMP_LE_SC_INCLUDED == WICED_TRUE
+
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "ecdh_pool.h"
+
+#define ECDH_POOL_THREAD_NICE   10      // ANDROID_PRIORITY_BACKGROUND
+
+typedef struct
+{
+    uint32_t priv_key[KEY_LENGTH_DWORDS_P256];  // as the HAL hands it out
+    DWORD n[KEY_LENGTH_DWORDS_P256];            // as ecdh_create_pub_key() passes it
+    Point q;                                    // n*G
+} ecdh_pool_pair_t;
+
+extern void wiced_hal_rand_gen_num_array(uint32_t* randNumberArrayPtr, uint32_t length);
+
+static ecdh_pool_pair_t ecdh_pool[ECDH_POOL_MAX_SIZE];
+static uint32_t         ecdh_pool_size = 0;         // 0 when stopped
+static uint32_t         ecdh_pool_count = 0;
+static ecdh_pool_pair_t ecdh_pool_pending;
+static wiced_bool_t     ecdh_pool_pending_valid = WICED_FALSE;
+static wiced_bool_t     ecdh_pool_armed = WICED_FALSE;
+static uint32_t         ecdh_pool_hits = 0;
+static uint32_t         ecdh_pool_misses = 0;
+static pthread_t        ecdh_pool_thread;
+static pthread_mutex_t  ecdh_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   ecdh_pool_cond = PTHREAD_COND_INITIALIZER;
+
+static void ecdh_pool_wipe(void *p, size_t len)
+{
+    volatile uint8_t *v = (volatile uint8_t *)p;
+
+    while(len--)
+        *v++ = 0;
+}
+
+static void *ecdh_pool_thread_func(void *arg)
+{
+    ecdh_pool_pair_t pair;
+
+    setpriority(PRIO_PROCESS, gettid(), ECDH_POOL_THREAD_NICE);
+
+    pthread_mutex_lock(&ecdh_pool_mutex);
+    while(ecdh_pool_size)
+    {
+        if(ecdh_pool_count >= ecdh_pool_size)
+        {
+            pthread_cond_wait(&ecdh_pool_cond, &ecdh_pool_mutex);
+            continue;
+        }
+        pthread_mutex_unlock(&ecdh_pool_mutex);
+
+        // the same bytes the core would get, read as ecdh_create_pub_key() reads them
+        wiced_hal_rand_gen_num_array(pair.priv_key, KEY_LENGTH_DWORDS_P256);
+        mpConvFromOctets(pair.n, KEY_LENGTH_DWORDS_P256, (const unsigned char *)pair.priv_key, sizeof(pair.priv_key));
+        ECC_PM_Comb(&pair.q, pair.n);
+
+        pthread_mutex_lock(&ecdh_pool_mutex);
+        if(ecdh_pool_count < ecdh_pool_size)
+            ecdh_pool[ecdh_pool_count++] = pair;
+        ecdh_pool_wipe(&pair, sizeof(pair));
+    }
+    pthread_mutex_unlock(&ecdh_pool_mutex);
+
+    return NULL;
+}
+
+void ecdh_pool_start(uint32_t size)
+{
+    if(size > ECDH_POOL_MAX_SIZE)
+        size = ECDH_POOL_MAX_SIZE;
+
+    pthread_mutex_lock(&ecdh_pool_mutex);
+    if((size == 0) || (ecdh_pool_size != 0))
+    {
+        pthread_mutex_unlock(&ecdh_pool_mutex);
+        return;
+    }
+    ecdh_pool_size = size;
+    ecdh_pool_armed = WICED_TRUE;
+    pthread_mutex_unlock(&ecdh_pool_mutex);
+
+    // the worker may run before the core initializes the curve
+    p_256_init_curve(KEY_LENGTH_DWORDS_P256);
+
+    if(pthread_create(&ecdh_pool_thread, NULL, ecdh_pool_thread_func, NULL) != 0)
+    {
+        pthread_mutex_lock(&ecdh_pool_mutex);
+        ecdh_pool_size = 0;
+        pthread_mutex_unlock(&ecdh_pool_mutex);
+        return;
+    }
+    pthread_setname_np(ecdh_pool_thread, "EcdhPool");
+}
+
+void ecdh_pool_stop(void)
+{
+    pthread_mutex_lock(&ecdh_pool_mutex);
+    if(ecdh_pool_size == 0)
+    {
+        pthread_mutex_unlock(&ecdh_pool_mutex);
+        return;
+    }
+    ecdh_pool_size = 0;
+    pthread_cond_signal(&ecdh_pool_cond);
+    pthread_mutex_unlock(&ecdh_pool_mutex);
+
+    pthread_join(ecdh_pool_thread, NULL);
+
+    pthread_mutex_lock(&ecdh_pool_mutex);
+    ecdh_pool_wipe(ecdh_pool, sizeof(ecdh_pool));
+    ecdh_pool_wipe(&ecdh_pool_pending, sizeof(ecdh_pool_pending));
+    ecdh_pool_count = 0;
+    ecdh_pool_pending_valid = WICED_FALSE;
+    ecdh_pool_armed = WICED_FALSE;
+    pthread_mutex_unlock(&ecdh_pool_mutex);
+}
+
+wiced_bool_t ecdh_pool_take_priv_key(uint32_t *priv_key, uint32_t length)
+{
+    wiced_bool_t taken = WICED_FALSE;
+
+    if(length != KEY_LENGTH_DWORDS_P256)
+        return WICED_FALSE;
+
+    pthread_mutex_lock(&ecdh_pool_mutex);
+    if(ecdh_pool_size && ecdh_pool_armed)
+    {
+        // served or not, this request was the key generation of the session
+        ecdh_pool_armed = WICED_FALSE;
+
+        // a key handed out before and never multiplied is not a key anymore
+        ecdh_pool_wipe(&ecdh_pool_pending, sizeof(ecdh_pool_pending));
+        ecdh_pool_pending_valid = WICED_FALSE;
+
+        if(ecdh_pool_count)
+        {
+            ecdh_pool_count--;
+            ecdh_pool_pending = ecdh_pool[ecdh_pool_count];
+            ecdh_pool_wipe(&ecdh_pool[ecdh_pool_count], sizeof(ecdh_pool_pair_t));
+            ecdh_pool_pending_valid = WICED_TRUE;
+            memcpy(priv_key, ecdh_pool_pending.priv_key, sizeof(ecdh_pool_pending.priv_key));
+            ecdh_pool_hits++;
+            taken = WICED_TRUE;
+            pthread_cond_signal(&ecdh_pool_cond);
+        }
+        else
+        {
+            ecdh_pool_misses++;
+        }
+    }
+    pthread_mutex_unlock(&ecdh_pool_mutex);
+
+    return taken;
+}
+
+void ecdh_pool_arm(void)
+{
+    pthread_mutex_lock(&ecdh_pool_mutex);
+    ecdh_pool_armed = WICED_TRUE;
+    pthread_mutex_unlock(&ecdh_pool_mutex);
+}
+
+wiced_bool_t ecdh_pool_take_pub_key(Point *q, const DWORD *n)
+{
+    wiced_bool_t taken = WICED_FALSE;
+    DWORD diff = 0;
+    int i;
+
+    pthread_mutex_lock(&ecdh_pool_mutex);
+    if(ecdh_pool_pending_valid)
+    {
+        for(i=0; i<KEY_LENGTH_DWORDS_P256; i++)
+            diff |= ecdh_pool_pending.n[i] ^ n[i];
+
+        if(diff == 0)
+        {
+            *q = ecdh_pool_pending.q;
+            ecdh_pool_wipe(&ecdh_pool_pending, sizeof(ecdh_pool_pending));
+            ecdh_pool_pending_valid = WICED_FALSE;
+            taken = WICED_TRUE;
+        }
+    }
+    pthread_mutex_unlock(&ecdh_pool_mutex);
+
+    return taken;
+}
+
+void ecdh_pool_get_counters(uint32_t *p_hits, uint32_t *p_misses)
+{
+    pthread_mutex_lock(&ecdh_pool_mutex);
+    *p_hits = ecdh_pool_hits;
+    *p_misses = ecdh_pool_misses;
+    pthread_mutex_unlock(&ecdh_pool_mutex);
+}
+
+#endif
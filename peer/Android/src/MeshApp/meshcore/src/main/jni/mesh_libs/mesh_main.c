@@ -41,6 +41,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include "mesh_main.h"
+#include "aes_cmac.h"
 #include <wiced_bt_ble.h>
 #include <wiced_timer.h>
 #include <android/log.h>
@@ -104,6 +105,7 @@ extern wiced_bool_t mesh_bt_gatt_le_disconnect(uint32_t conn_id);
 extern uint32_t restart_timer(uint32_t timeout, uint32_t timer_id);
 uint32_t SetTimer(uint32_t timer, uint32_t timeout);
 extern void mesh_provision_process_event(uint16_t event, wiced_bt_mesh_event_t *p_event, void *p_data);
+extern void hmac_sha256_cache_invalidate(void);
 
 void EnterCriticalSection();
 void LeaveCriticalSection();
@@ -630,10 +632,22 @@ void Logn(uint8_t* data, int len)
 
 void mesh_core_state_changed(wiced_bt_mesh_core_state_type_t type, wiced_bt_mesh_core_state_t *p_state)
 {
+    unsigned int hits, misses;
+
     if (type == WICED_BT_MESH_CORE_STATE_TYPE_SEQ)
         mesh_provision_process_event(WICED_BT_MESH_SEQ_CHANGED, NULL, &p_state->seq);
     else if(type == WICED_BT_MESH_CORE_STATE_IV)
         mesh_provision_process_event(WICED_BT_MESH_IV_CHANGED, NULL, &p_state->iv);
+    else if ((type == WICED_BT_MESH_CORE_STATE_NET_KEY_UPDATE) || (type == WICED_BT_MESH_CORE_STATE_NET_KEY_DELETE) ||
+             (type == WICED_BT_MESH_CORE_STATE_APP_KEY_UPDATE) || (type == WICED_BT_MESH_CORE_STATE_APP_KEY_DELETE) ||
+             (type == WICED_BT_MESH_CORE_STATE_KR) || (type == WICED_BT_MESH_CORE_STATE_NODE_STATE))
+    {
+        // keys derived from the old keys are not used anymore
+        aes_cmac_cache_get_counters(&hits, &misses);
+        Log("cmac cache invalidated state:%d hits:%u misses:%u\n", type, hits, misses);
+        aes_cmac_cache_invalidate();
+        hmac_sha256_cache_invalidate();
+    }
 }
 
 
@@ -36,6 +36,8 @@
 * simple pairing algorithms implementation
 */
 
+// #define P_256_UNIT_TEST
+
 #include "bt_target.h"
 #include "wiced_bt_app_common.h"
 
@@ -43,11 +45,17 @@
 
 #include "p_256_multprecision.h"
 #include "p_256_ecc_pp.h"
+#include "ecdh_pool.h"
+#ifdef P_256_UNIT_TEST
+// the unit test builds from the three p_256 files alone, without the key pair pool
+#define ecdh_pool_take_pub_key(q, n)    WICED_FALSE
+#endif
 //#include <stdlib.h>
 #include <stdio.h>
 //???#include "p_256_timer.h"
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 #include <mesh_main.h>
 //???#include "p_256_bt_rtos.h"
 
@@ -217,8 +225,9 @@ void ECC_NAF(uint8_t *naf, uint32_t *NumNAF, DWORD *k, uint32_t keyLength)
     *NumNAF=i;
 }
 
-// Binary NAF for point multiplication
-void ECC_PM_B_NAF(Point *q, Point *p, DWORD *n, uint32_t keyLength)
+// Binary NAF for point multiplication. Not constant time and destroys n, kept
+// as the reference for P-192 and for tests.
+void ECC_PM_B_NAF_Ref(Point *q, Point *p, DWORD *n, uint32_t keyLength)
 {
     int i;
     uint32_t sign;
@@ -275,7 +284,7 @@ void ECC_PM_B_NAF(Point *q, Point *p, DWORD *n, uint32_t keyLength)
     }
 
 
-    MP_InvMod(minus_p.x, q->z, keyLength);
+    MP_InvMod_Ref(minus_p.x, q->z, keyLength);
 
     MP_MersennsSquaMod(q->z, minus_p.x, keyLength);
     MP_MersennsMultMod(q->x, q->x, q->z, keyLength);
@@ -285,6 +294,391 @@ void ECC_PM_B_NAF(Point *q, Point *p, DWORD *n, uint32_t keyLength)
     MP_MersennsMultMod(q->y, q->y, q->z, keyLength);
 }
 
+/* Jacobian point with coordinates in Montgomery form, z=0 is infinity */
+typedef struct
+{
+    FE x;
+    FE y;
+    FE z;
+} FE_Point;
+
+// r=2p, a=-3 (dbl-2001-b)
+static void ECC_FE_Double(FE_Point *r, const FE_Point *p)
+{
+    FE delta, gamma, beta, alpha, t1, t2;
+
+    FE_Sqr(delta, p->z);                // delta=z1^2
+    FE_Sqr(gamma, p->y);                // gamma=y1^2
+    FE_Mul(beta, p->x, gamma);          // beta=x1*gamma
+
+    FE_Sub(t1, p->x, delta);
+    FE_Add(t2, p->x, delta);
+    FE_Mul(alpha, t1, t2);
+    FE_Add(t1, alpha, alpha);
+    FE_Add(alpha, t1, alpha);           // alpha=3*(x1-delta)*(x1+delta)
+
+    FE_Add(t1, p->y, p->z);
+    FE_Sqr(t1, t1);
+    FE_Sub(t1, t1, gamma);
+    FE_Sub(r->z, t1, delta);            // z3=(y1+z1)^2-gamma-delta
+
+    FE_Add(beta, beta, beta);
+    FE_Add(beta, beta, beta);           // beta=4*beta
+    FE_Sqr(t1, alpha);
+    FE_Add(t2, beta, beta);
+    FE_Sub(r->x, t1, t2);               // x3=alpha^2-8*beta
+
+    FE_Sub(t1, beta, r->x);
+    FE_Mul(t1, alpha, t1);
+    FE_Sqr(gamma, gamma);
+    FE_Add(gamma, gamma, gamma);
+    FE_Add(gamma, gamma, gamma);
+    FE_Add(gamma, gamma, gamma);
+    FE_Sub(r->y, t1, gamma);            // y3=alpha*(4*beta-x3)-8*gamma^2
+}
+
+// r=p+q. Either point may be infinity without branching on it. p=q only
+// happens for scalars of the order size and falls back to doubling.
+static void ECC_FE_Add(FE_Point *r, const FE_Point *p, const FE_Point *q)
+{
+    FE z1z1, z2z2, u1, u2, s1, s2, h, rr, hh, hhh, v;
+    FE_Point t;
+    FE_LIMB p_inf, q_inf;
+
+    p_inf = FE_IsZero(p->z);
+    q_inf = FE_IsZero(q->z);
+
+    FE_Sqr(z1z1, p->z);
+    FE_Sqr(z2z2, q->z);
+    FE_Mul(u1, p->x, z2z2);             // u1=x1*z2^2
+    FE_Mul(u2, q->x, z1z1);             // u2=x2*z1^2
+    FE_Mul(s1, p->y, q->z);
+    FE_Mul(s1, s1, z2z2);               // s1=y1*z2^3
+    FE_Mul(s2, q->y, p->z);
+    FE_Mul(s2, s2, z1z1);               // s2=y2*z1^3
+
+    FE_Sub(h, u2, u1);
+    FE_Sub(rr, s2, s1);
+
+    if(FE_IsZero(h) & FE_IsZero(rr) & ~p_inf & ~q_inf)
+    {
+        ECC_FE_Double(r, p);
+        return;
+    }
+
+    FE_Sqr(hh, h);
+    FE_Mul(hhh, hh, h);
+    FE_Mul(v, u1, hh);
+
+    FE_Sqr(t.x, rr);
+    FE_Sub(t.x, t.x, hhh);
+    FE_Sub(t.x, t.x, v);
+    FE_Sub(t.x, t.x, v);                // x3=r^2-h^3-2*u1*h^2
+
+    FE_Sub(t.y, v, t.x);
+    FE_Mul(t.y, rr, t.y);
+    FE_Mul(s1, s1, hhh);
+    FE_Sub(t.y, t.y, s1);               // y3=r*(u1*h^2-x3)-s1*h^3
+
+    FE_Mul(t.z, p->z, q->z);
+    FE_Mul(t.z, t.z, h);                // z3=z1*z2*h
+
+    FE_Cmov(t.x, q->x, p_inf);
+    FE_Cmov(t.y, q->y, p_inf);
+    FE_Cmov(t.z, q->z, p_inf);
+    FE_Cmov(t.x, p->x, q_inf);
+    FE_Cmov(t.y, p->y, q_inf);
+    FE_Cmov(t.z, p->z, q_inf);
+
+    *r = t;
+}
+
+// x,y=p in affine, 0,0 for infinity
+static void ECC_FE_ToAffine(FE x, FE y, const FE_Point *p)
+{
+    FE zinv, zinv2;
+
+    FE_Inv(zinv, p->z);
+    FE_Sqr(zinv2, zinv);
+    FE_Mul(x, p->x, zinv2);
+    FE_Mul(zinv2, zinv2, zinv);
+    FE_Mul(y, p->y, zinv2);
+}
+
+// q=p in affine, z=1, or z=0 for infinity
+static void ECC_FE_ToPoint(Point *q, const FE_Point *p)
+{
+    FE x, y;
+
+    ECC_FE_ToAffine(x, y, p);
+    FE_ToMP(q->x, x);
+    FE_ToMP(q->y, y);
+    MP_Init(q->z, KEY_LENGTH_DWORDS_P256);
+    q->z[0] = (DWORD)(~FE_IsZero(p->z) & 1);
+}
+
+// r=table[index-1], infinity for index 0, reading every entry
+static void ECC_FE_Select(FE_Point *r, const FE_Point *table, uint32_t num, uint32_t index)
+{
+    FE_LIMB mask, d;
+    uint32_t i;
+
+    BT_MEMSET(r, 0, sizeof(FE_Point));
+
+    for(i=0; i<num; i++)
+    {
+        d = (FE_LIMB)((i + 1) ^ index);
+        mask = ((d | (0 - d)) >> (FE_LIMB_BITS - 1)) - 1;
+
+        FE_Cmov(r->x, table[i].x, mask);
+        FE_Cmov(r->y, table[i].y, mask);
+        FE_Cmov(r->z, table[i].z, mask);
+    }
+}
+
+// Bits bit-1 .. bit+4 of n, the lowest one is 0 for bit 0
+static uint32_t ECC_Window(const DWORD *n, int bit)
+{
+    uint32_t w, pos;
+
+    if(bit == 0)
+        return (n[0] << 1) & 0x3F;
+
+    pos = bit - 1;
+    w = n[pos >> 5] >> (pos & 0x1F);
+    if((pos & 0x1F) > 26 && (pos >> 5) < KEY_LENGTH_DWORDS_P256 - 1)
+        w |= n[(pos >> 5) + 1] << (32 - (pos & 0x1F));
+
+    return w & 0x3F;
+}
+
+// Signed digit of a 5 bit Booth window: (|digit| << 1) | sign
+static uint32_t ECC_BoothRecode(uint32_t w)
+{
+    uint32_t s, d;
+
+    s = ~((w >> 5) - 1);
+    d = (1 << 6) - w - 1;
+    d = (d & s) | (w & ~s);
+    d = (d >> 1) + (d & 1);
+
+    return (d << 1) + (s & 1);
+}
+
+// Point multiplication with signed 5 bit windows (n = sum d_i*2^(5i), |d_i|<=16).
+// The table lookups, additions and doublings do not depend on the scalar.
+void ECC_PM_B_NAF(Point *q, Point *p, DWORD *n, uint32_t keyLength)
+{
+    FE_Point table[16];
+    FE_Point r, t;
+    FE neg, zero = { 0 };
+    uint32_t digit;
+    int bit, i;
+
+    if(keyLength != KEY_LENGTH_DWORDS_P256)
+    {
+        ECC_PM_B_NAF_Ref(q, p, n, keyLength);
+        return;
+    }
+
+    MP_Init(p->z, keyLength);
+    p->z[0]=1;
+
+    // key generation, the base point is public
+    if((MP_CMP(p->x, curve_p256.G.x, keyLength) == 0) && (MP_CMP(p->y, curve_p256.G.y, keyLength) == 0))
+    {
+        if(!ecdh_pool_take_pub_key(q, n))
+            ECC_PM_Comb(q, n);
+        return;
+    }
+
+    // table[i]=(i+1)p
+    FE_FromMP(table[0].x, p->x);
+    FE_FromMP(table[0].y, p->y);
+    FE_FromMP(table[0].z, p->z);
+    ECC_FE_Double(&table[1], &table[0]);
+    for(i=2; i<16; i++)
+        ECC_FE_Add(&table[i], &table[i-1], &table[0]);
+
+    for(bit=255; ; bit-=5)
+    {
+        digit = ECC_BoothRecode(ECC_Window(n, bit));
+
+        ECC_FE_Select(&t, table, 16, digit >> 1);
+        FE_Sub(neg, zero, t.y);
+        FE_Cmov(t.y, neg, 0 - (FE_LIMB)(digit & 1));
+
+        if(bit == 255)
+            r = t;
+        else
+            ECC_FE_Add(&r, &r, &t);
+
+        if(bit == 0)
+            break;
+
+        for(i=0; i<5; i++)
+            ECC_FE_Double(&r, &r);
+    }
+
+    ECC_FE_ToPoint(q, &r);
+}
+
+/* Fixed base comb for G: bit i+COMB_SPACING*t of the scalar is tooth t of column i,
+   comb_table[j-1] = sum of 2^(COMB_SPACING*t)*G over the teeth set in j. */
+#define COMB_TEETH      6
+#define COMB_SPACING    43
+#define COMB_SIZE       ((1 << COMB_TEETH) - 1)
+
+typedef struct
+{
+    FE x;
+    FE y;
+} FE_Affine;
+
+static FE_Affine comb_table[COMB_SIZE];
+static FE comb_one;
+static pthread_once_t comb_once = PTHREAD_ONCE_INIT;
+
+// r=p+q with q affine, q_inf all ones when q is infinity (madd-2004-hmv)
+static void ECC_FE_MixedAdd(FE_Point *r, const FE_Point *p, const FE_Affine *q, FE_LIMB q_inf)
+{
+    FE z1z1, u2, s2, h, rr, hh, hhh, v;
+    FE_Point t;
+    FE_LIMB p_inf;
+
+    p_inf = FE_IsZero(p->z);
+
+    FE_Sqr(z1z1, p->z);
+    FE_Mul(u2, q->x, z1z1);             // u2=x2*z1^2
+    FE_Mul(s2, q->y, p->z);
+    FE_Mul(s2, s2, z1z1);               // s2=y2*z1^3
+
+    FE_Sub(h, u2, p->x);
+    FE_Sub(rr, s2, p->y);
+
+    if(FE_IsZero(h) & FE_IsZero(rr) & ~p_inf & ~q_inf)
+    {
+        ECC_FE_Double(r, p);
+        return;
+    }
+
+    FE_Sqr(hh, h);
+    FE_Mul(hhh, hh, h);
+    FE_Mul(v, p->x, hh);
+
+    FE_Sqr(t.x, rr);
+    FE_Sub(t.x, t.x, hhh);
+    FE_Sub(t.x, t.x, v);
+    FE_Sub(t.x, t.x, v);                // x3=r^2-h^3-2*x1*h^2
+
+    FE_Sub(t.y, v, t.x);
+    FE_Mul(t.y, rr, t.y);
+    FE_Mul(hhh, p->y, hhh);
+    FE_Sub(t.y, t.y, hhh);              // y3=r*(x1*h^2-x3)-y1*h^3
+
+    FE_Mul(t.z, p->z, h);               // z3=z1*h
+
+    FE_Cmov(t.x, q->x, p_inf);
+    FE_Cmov(t.y, q->y, p_inf);
+    FE_Cmov(t.z, comb_one, p_inf);
+    FE_Cmov(t.x, p->x, q_inf);
+    FE_Cmov(t.y, p->y, q_inf);
+    FE_Cmov(t.z, p->z, q_inf);
+
+    *r = t;
+}
+
+// Runs once on the public base point, no need for constant time here
+static void ECC_CombInit(void)
+{
+    FE_Point teeth[COMB_TEETH];
+    FE_Point t;
+    DWORD one[KEY_LENGTH_DWORDS_P256];
+    int i, j, top;
+
+    MP_Init(one, KEY_LENGTH_DWORDS_P256);
+    one[0] = 1;
+    FE_FromMP(comb_one, one);
+
+    FE_FromMP(teeth[0].x, curve_p256.G.x);
+    FE_FromMP(teeth[0].y, curve_p256.G.y);
+    BT_MEMCPY(teeth[0].z, comb_one, sizeof(FE));
+    for(i=1; i<COMB_TEETH; i++)
+    {
+        teeth[i] = teeth[i-1];
+        for(j=0; j<COMB_SPACING; j++)
+            ECC_FE_Double(&teeth[i], &teeth[i]);
+    }
+
+    for(j=1; j<=COMB_SIZE; j++)
+    {
+        for(top=COMB_TEETH-1; !(j & (1 << top)); top--)
+            ;
+
+        // the lower teeth of j are already in the table
+        if(j == (1 << top))
+            t = teeth[top];
+        else
+            ECC_FE_MixedAdd(&t, &teeth[top], &comb_table[(j ^ (1 << top)) - 1], 0);
+
+        ECC_FE_ToAffine(comb_table[j-1].x, comb_table[j-1].y, &t);
+    }
+}
+
+// r=comb_table[index-1] reading every entry, the caller handles index 0
+static void ECC_CombSelect(FE_Affine *r, uint32_t index)
+{
+    FE_LIMB mask, d;
+    uint32_t i, j;
+
+    BT_MEMSET(r, 0, sizeof(FE_Affine));
+
+    // the table is large, keep the masking inline
+    for(i=0; i<COMB_SIZE; i++)
+    {
+        d = (FE_LIMB)((i + 1) ^ index);
+        mask = ((d | (0 - d)) >> (FE_LIMB_BITS - 1)) - 1;
+
+        for(j=0; j<FE_LIMBS; j++)
+        {
+            r->x[j] |= comb_table[i].x[j] & mask;
+            r->y[j] |= comb_table[i].y[j] & mask;
+        }
+    }
+}
+
+// q=n*G with COMB_SPACING doublings and mixed additions, constant time in n
+void ECC_PM_Comb(Point *q, DWORD *n)
+{
+    FE_Point r;
+    FE_Affine t;
+    FE_LIMB d;
+    uint32_t index, pos;
+    int col, tooth;
+
+    pthread_once(&comb_once, ECC_CombInit);
+
+    BT_MEMSET(&r, 0, sizeof(r));
+
+    for(col=COMB_SPACING-1; col>=0; col--)
+    {
+        ECC_FE_Double(&r, &r);
+
+        index = 0;
+        for(tooth=0; tooth<COMB_TEETH; tooth++)
+        {
+            pos = tooth * COMB_SPACING + col;
+            if(pos < 256)
+                index |= ((n[pos >> 5] >> (pos & 0x1F)) & 1) << tooth;
+        }
+
+        ECC_CombSelect(&t, index);
+        d = (FE_LIMB)index;
+        ECC_FE_MixedAdd(&r, &r, &t, ((d | (0 - d)) >> (FE_LIMB_BITS - 1)) - 1);
+    }
+
+    ECC_FE_ToPoint(q, &r);
+}
 
 #define OCTETS_PER_DIGIT    sizeof(unsigned int)
 #define BITS_PER_DIGIT 32
@@ -363,4 +757,214 @@ int mpConvFromHex(DWORD *a, int ndigits, const char *s)
         return n;
 }
 
+#ifdef P_256_UNIT_TEST
+#include <time.h>
+
+static const DWORD test_order[KEY_LENGTH_DWORDS_P256] = {
+    0xfc632551, 0xf3b9cac2, 0xa7179e84, 0xbce6faad, 0xffffffff, 0xffffffff, 0x00000000, 0xffffffff
+};
+
+/* k*G computed independently with affine arithmetic */
+static const DWORD test_k[KEY_LENGTH_DWORDS_P256] = {
+    0x505530ba, 0xa3caa219, 0xc60829a5, 0x7e8803b5, 0x73502b03, 0x97502ed4, 0x0d72cd64, 0x529aa067
+};
+static const DWORD test_kx[KEY_LENGTH_DWORDS_P256] = {
+    0xe16500cc, 0xcf0d6cf5, 0x204796ec, 0x84dbc966, 0x4da87581, 0x9dc7dfc0, 0xf23d3f1b, 0xf465e43f
+};
+static const DWORD test_ky[KEY_LENGTH_DWORDS_P256] = {
+    0xd8ecb279, 0xa8a155ca, 0xca6b4d43, 0x01c2b010, 0x164e33c2, 0xeeefc424, 0xbcbbd899, 0x0201d048
+};
+
+static uint32_t test_rand(void)
+{
+    static uint32_t x = 0x12345678;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+static int test_cmp(const char *name, DWORD *a, const DWORD *b)
+{
+    if(memcmp(a, b, KEY_LENGTH_DWORDS_P256 * sizeof(DWORD)) == 0)
+        return 0;
+    printf("%s FAILED\n", name);
+    return 1;
+}
+
+// y^2 = x^3 - 3x + b
+static int test_on_curve(Point *q)
+{
+    DWORD l[KEY_LENGTH_DWORDS_P256], r[KEY_LENGTH_DWORDS_P256], t[KEY_LENGTH_DWORDS_P256];
+
+    MP_MersennsSquaMod(l, q->y, KEY_LENGTH_DWORDS_P256);
+    MP_MersennsSquaMod(r, q->x, KEY_LENGTH_DWORDS_P256);
+    MP_MersennsMultMod(r, r, q->x, KEY_LENGTH_DWORDS_P256);
+    MP_AddMod(t, q->x, q->x, KEY_LENGTH_DWORDS_P256);
+    MP_AddMod(t, t, q->x, KEY_LENGTH_DWORDS_P256);
+    MP_SubMod(r, r, t, KEY_LENGTH_DWORDS_P256);
+    MP_AddMod(r, r, curve_p256.b, KEY_LENGTH_DWORDS_P256);
+
+    return MP_CMP(l, r, KEY_LENGTH_DWORDS_P256) == 0;
+}
+
+// new and reference multiplication agree and land on the curve
+static int test_mult(Point *p, DWORD *k)
+{
+    Point q, q_ref, base;
+    DWORD n[KEY_LENGTH_DWORDS_P256];
+    int failed = 0;
+
+    base = *p;
+    MP_Copy(n, k, KEY_LENGTH_DWORDS_P256);
+    ECC_PM_B_NAF(&q, &base, n, KEY_LENGTH_DWORDS_P256);
+    failed |= test_cmp("scalar unchanged", n, k);
+
+    base = *p;
+    MP_Copy(n, k, KEY_LENGTH_DWORDS_P256);
+    ECC_PM_B_NAF_Ref(&q_ref, &base, n, KEY_LENGTH_DWORDS_P256);
+
+    failed |= test_cmp("ECC_PM_B_NAF x", q.x, q_ref.x);
+    failed |= test_cmp("ECC_PM_B_NAF y", q.y, q_ref.y);
+    if(!MP_isZero(q.x, KEY_LENGTH_DWORDS_P256) && !test_on_curve(&q))
+    {
+        printf("point on curve FAILED\n");
+        failed = 1;
+    }
+    return failed;
+}
+
+int main()
+{
+    Point g, q, r, s;
+    DWORD k[KEY_LENGTH_DWORDS_P256], a[KEY_LENGTH_DWORDS_P256], b[KEY_LENGTH_DWORDS_P256];
+    DWORD inv[KEY_LENGTH_DWORDS_P256], inv_ref[KEY_LENGTH_DWORDS_P256];
+    clock_t start;
+    int i, j, failed = 0;
+
+    p_256_init_curve(KEY_LENGTH_DWORDS_P256);
+    g = curve_p256.G;
+
+    printf("FE_LIMB_BITS %d\n", FE_LIMB_BITS);
+
+    // the first multiplication of G builds the comb table
+    start = clock();
+    MP_Copy(k, (DWORD *)test_k, KEY_LENGTH_DWORDS_P256);
+    q = g;
+    ECC_PM_B_NAF(&r, &q, k, KEY_LENGTH_DWORDS_P256);
+    printf("comb table       %8.1f us\n", (double)(clock() - start) * 1000000 / CLOCKS_PER_SEC);
+
+    // known answer
+    MP_Copy(k, (DWORD *)test_k, KEY_LENGTH_DWORDS_P256);
+    q = g;
+    ECC_PM_B_NAF(&r, &q, k, KEY_LENGTH_DWORDS_P256);
+    failed |= test_cmp("k*G x", r.x, test_kx);
+    failed |= test_cmp("k*G y", r.y, test_ky);
+
+    // small scalars, every digit of the first windows, and around the order
+    for(i=0; i<70; i++)
+    {
+        MP_Init(k, KEY_LENGTH_DWORDS_P256);
+        k[0] = i;
+        failed |= test_mult(&g, k);
+    }
+    for(i=0; i<=40; i++)
+    {
+        MP_Init(a, KEY_LENGTH_DWORDS_P256);
+        a[0] = i;
+        MP_Sub(k, (DWORD *)test_order, a, KEY_LENGTH_DWORDS_P256);
+        failed |= test_mult(&g, k);
+    }
+    MP_Copy(k, (DWORD *)test_order, KEY_LENGTH_DWORDS_P256);
+    q = g;
+    ECC_PM_B_NAF(&r, &q, k, KEY_LENGTH_DWORDS_P256);
+    if(!MP_isZero(r.x, KEY_LENGTH_DWORDS_P256) || !MP_isZero(r.z, KEY_LENGTH_DWORDS_P256))
+    {
+        printf("n*G FAILED\n");
+        failed = 1;
+    }
+
+    // the reference overruns a scalar of all ones, compare with the reduced one
+    for(i=0; i<KEY_LENGTH_DWORDS_P256; i++)
+        k[i] = 0xffffffff;
+    q = g;
+    ECC_PM_B_NAF(&r, &q, k, KEY_LENGTH_DWORDS_P256);
+    MP_Sub(k, k, (DWORD *)test_order, KEY_LENGTH_DWORDS_P256);
+    failed |= test_mult(&g, k);
+    q = g;
+    ECC_PM_B_NAF(&s, &q, k, KEY_LENGTH_DWORDS_P256);
+    failed |= test_cmp("(2^256-1)*G", r.x, s.x);
+
+    // random scalars on G and on a random point
+    for(i=0; i<200; i++)
+    {
+        for(j=0; j<KEY_LENGTH_DWORDS_P256; j++)
+            k[j] = test_rand();
+        failed |= test_mult(&g, k);
+    }
+    for(j=0; j<KEY_LENGTH_DWORDS_P256; j++)
+        k[j] = test_rand();
+    q = g;
+    ECC_PM_B_NAF(&r, &q, k, KEY_LENGTH_DWORDS_P256);
+    for(i=0; i<100; i++)
+    {
+        for(j=0; j<KEY_LENGTH_DWORDS_P256; j++)
+            k[j] = test_rand();
+        failed |= test_mult(&r, k);
+    }
+
+    // Fermat inversion against the binary one
+    for(i=0; i<1000; i++)
+    {
+        for(j=0; j<KEY_LENGTH_DWORDS_P256; j++)
+            a[j] = test_rand();
+        if(MP_CMP(a, curve_p256.p, KEY_LENGTH_DWORDS_P256) >= 0)
+            MP_Sub(a, a, curve_p256.p, KEY_LENGTH_DWORDS_P256);
+        if(i < 2)
+        {
+            MP_Init(a, KEY_LENGTH_DWORDS_P256);
+            a[0] = i;
+        }
+
+        MP_InvMod(inv, a, KEY_LENGTH_DWORDS_P256);
+        MP_Copy(b, a, KEY_LENGTH_DWORDS_P256);
+        MP_InvMod_Ref(inv_ref, b, KEY_LENGTH_DWORDS_P256);
+        failed |= test_cmp("MP_InvMod", inv, inv_ref);
+    }
+
+    // r is a point other than G from above
+    start = clock();
+    for(i=0; i<100; i++)
+    {
+        q = g;
+        MP_Copy(k, (DWORD *)test_k, KEY_LENGTH_DWORDS_P256);
+        ECC_PM_B_NAF(&s, &q, k, KEY_LENGTH_DWORDS_P256);
+    }
+    printf("keygen           %8.1f us\n", (double)(clock() - start) * 1000000 / CLOCKS_PER_SEC / 100);
+
+    start = clock();
+    for(i=0; i<100; i++)
+    {
+        q = r;
+        MP_Copy(k, (DWORD *)test_k, KEY_LENGTH_DWORDS_P256);
+        ECC_PM_B_NAF(&s, &q, k, KEY_LENGTH_DWORDS_P256);
+    }
+    printf("ECDH             %8.1f us\n", (double)(clock() - start) * 1000000 / CLOCKS_PER_SEC / 100);
+
+    start = clock();
+    for(i=0; i<100; i++)
+    {
+        q = g;
+        MP_Copy(k, (DWORD *)test_k, KEY_LENGTH_DWORDS_P256);
+        ECC_PM_B_NAF_Ref(&s, &q, k, KEY_LENGTH_DWORDS_P256);
+    }
+    printf("ECC_PM_B_NAF_Ref %8.1f us\n", (double)(clock() - start) * 1000000 / CLOCKS_PER_SEC / 100);
+
+    printf("%s\n", failed ? "FAILED" : "PASSED");
+
+    return failed;
+}
+#endif
+
 #endif
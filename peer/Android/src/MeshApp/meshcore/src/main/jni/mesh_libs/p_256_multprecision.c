@@ -639,7 +639,8 @@ void MP_FastMod_P256(DWORD *c, DWORD *a)
 
 }
 
-void MP_InvMod(DWORD *aminus, DWORD *u, uint32_t keyLength)
+// Binary extended Euclid, kept as the reference for P-192 and for tests
+void MP_InvMod_Ref(DWORD *aminus, DWORD *u, uint32_t keyLength)
 {
     DWORD v[KEY_LENGTH_DWORDS_P256];
     DWORD A[KEY_LENGTH_DWORDS_P256+1], C[KEY_LENGTH_DWORDS_P256+1];
@@ -705,4 +706,232 @@ void MP_InvMod(DWORD *aminus, DWORD *u, uint32_t keyLength)
         MP_Copy(aminus, C, keyLength);
 }
 
+// Fermat inversion in constant time, a^(p-2) mod p
+void MP_InvMod(DWORD *aminus, DWORD *a, uint32_t keyLength)
+{
+    FE t;
+
+    if(keyLength != KEY_LENGTH_DWORDS_P256)
+    {
+        MP_InvMod_Ref(aminus, a, keyLength);
+        return;
+    }
+
+    FE_FromMP(t, a);
+    FE_Inv(t, t);
+    FE_ToMP(aminus, t);
+}
+
+/* P-256 field in Montgomery form, R=2^256. The limb size only changes how
+   the constants are packed. */
+#if FE_LIMB_BITS == 64
+#define FE_C(hi, lo)    (((FE_LIMB)(hi) << 32) | (FE_LIMB)(lo))
+#else
+#define FE_C(hi, lo)    (FE_LIMB)(lo), (FE_LIMB)(hi)
+#endif
+
+static const FE fe_p    = { FE_C(0xFFFFFFFF, 0xFFFFFFFF), FE_C(0x00000000, 0xFFFFFFFF),
+                            FE_C(0x00000000, 0x00000000), FE_C(0xFFFFFFFF, 0x00000001) };
+static const FE fe_rr   = { FE_C(0x00000000, 0x00000003), FE_C(0xFFFFFFFB, 0xFFFFFFFF),
+                            FE_C(0xFFFFFFFF, 0xFFFFFFFE), FE_C(0x00000004, 0xFFFFFFFD) };
+static const FE fe_one  = { 1 };
+
+// c = t or t-p, t < 2p, top is the limb above t
+static void fe_reduce_once(FE c, const FE_LIMB *t, FE_LIMB top)
+{
+    FE s;
+    FE_DLIMB uv;
+    FE_LIMB borrow, mask;
+    int i;
+
+    borrow = 0;
+    for(i=0; i<FE_LIMBS; i++)
+    {
+        uv = (FE_DLIMB)t[i] - fe_p[i] - borrow;
+        s[i] = (FE_LIMB)uv;
+        borrow = (FE_LIMB)(uv >> FE_LIMB_BITS) & 1;
+    }
+    uv = (FE_DLIMB)top - borrow;
+    mask = 0 - ((FE_LIMB)(uv >> FE_LIMB_BITS) & 1);     // t < p, keep t
+
+    for(i=0; i<FE_LIMBS; i++)
+        c[i] = (t[i] & mask) | (s[i] & ~mask);
+}
+
+void FE_Mul(FE c, const FE a, const FE b)
+{
+    FE_LIMB t[FE_LIMBS+2];
+    FE_DLIMB uv;
+    FE_LIMB carry, m;
+    int i, j;
+
+    for(i=0; i<FE_LIMBS+2; i++)
+        t[i] = 0;
+
+    for(i=0; i<FE_LIMBS; i++)
+    {
+        // t += a*b[i]
+        carry = 0;
+        for(j=0; j<FE_LIMBS; j++)
+        {
+            uv = (FE_DLIMB)a[j] * b[i] + t[j] + carry;
+            t[j] = (FE_LIMB)uv;
+            carry = (FE_LIMB)(uv >> FE_LIMB_BITS);
+        }
+        uv = (FE_DLIMB)t[FE_LIMBS] + carry;
+        t[FE_LIMBS] = (FE_LIMB)uv;
+        t[FE_LIMBS+1] = (FE_LIMB)(uv >> FE_LIMB_BITS);
+
+        // t = (t + m*p) / 2^FE_LIMB_BITS, p = -1 mod 2^FE_LIMB_BITS so m is t[0]
+        m = t[0];
+        uv = (FE_DLIMB)m * fe_p[0] + t[0];
+        carry = (FE_LIMB)(uv >> FE_LIMB_BITS);
+        for(j=1; j<FE_LIMBS; j++)
+        {
+            uv = (FE_DLIMB)m * fe_p[j] + t[j] + carry;
+            t[j-1] = (FE_LIMB)uv;
+            carry = (FE_LIMB)(uv >> FE_LIMB_BITS);
+        }
+        uv = (FE_DLIMB)t[FE_LIMBS] + carry;
+        t[FE_LIMBS-1] = (FE_LIMB)uv;
+        t[FE_LIMBS] = t[FE_LIMBS+1] + (FE_LIMB)(uv >> FE_LIMB_BITS);
+    }
+
+    fe_reduce_once(c, t, t[FE_LIMBS]);
+}
+
+void FE_Sqr(FE c, const FE a)
+{
+    FE_Mul(c, a, a);
+}
+
+void FE_Add(FE c, const FE a, const FE b)
+{
+    FE t;
+    FE_DLIMB uv;
+    FE_LIMB carry;
+    int i;
+
+    carry = 0;
+    for(i=0; i<FE_LIMBS; i++)
+    {
+        uv = (FE_DLIMB)a[i] + b[i] + carry;
+        t[i] = (FE_LIMB)uv;
+        carry = (FE_LIMB)(uv >> FE_LIMB_BITS);
+    }
+
+    fe_reduce_once(c, t, carry);
+}
+
+void FE_Sub(FE c, const FE a, const FE b)
+{
+    FE_DLIMB uv;
+    FE_LIMB borrow, mask;
+    int i;
+
+    borrow = 0;
+    for(i=0; i<FE_LIMBS; i++)
+    {
+        uv = (FE_DLIMB)a[i] - b[i] - borrow;
+        c[i] = (FE_LIMB)uv;
+        borrow = (FE_LIMB)(uv >> FE_LIMB_BITS) & 1;
+    }
+
+    // add p back if a < b
+    mask = 0 - borrow;
+    borrow = 0;
+    for(i=0; i<FE_LIMBS; i++)
+    {
+        uv = (FE_DLIMB)c[i] + (fe_p[i] & mask) + borrow;
+        c[i] = (FE_LIMB)uv;
+        borrow = (FE_LIMB)(uv >> FE_LIMB_BITS);
+    }
+}
+
+// c = a^(2^n) * b
+static void fe_sqr_mul(FE c, const FE a, int n, const FE b)
+{
+    FE t;
+    int i;
+
+    FE_Sqr(t, a);
+    for(i=1; i<n; i++)
+        FE_Sqr(t, t);
+    FE_Mul(c, t, b);
+}
+
+// p-2 = ffffffff 00000001 00000000 00000000 00000000 ffffffff ffffffff fffffffd,
+// 255 squarings and 12 multiplications. xN stands for a^(2^N-1).
+void FE_Inv(FE c, const FE a)
+{
+    FE x2, x3, x6, x12, x15, x30, x32, t;
+
+    fe_sqr_mul(x2, a, 1, a);
+    fe_sqr_mul(x3, x2, 1, a);
+    fe_sqr_mul(x6, x3, 3, x3);
+    fe_sqr_mul(x12, x6, 6, x6);
+    fe_sqr_mul(x15, x12, 3, x3);
+    fe_sqr_mul(x30, x15, 15, x15);
+    fe_sqr_mul(x32, x30, 2, x2);
+
+    fe_sqr_mul(t, x32, 32, a);          // ffffffff 00000001
+    fe_sqr_mul(t, t, 96 + 32, x32);     // 96 zero bits, then ffffffff
+    fe_sqr_mul(t, t, 32, x32);
+    fe_sqr_mul(t, t, 30, x30);
+    fe_sqr_mul(c, t, 2, a);             // ...fffffffd
+}
+
+void FE_Cmov(FE c, const FE a, FE_LIMB mask)
+{
+    int i;
+
+    for(i=0; i<FE_LIMBS; i++)
+        c[i] = (c[i] & ~mask) | (a[i] & mask);
+}
+
+FE_LIMB FE_IsZero(const FE a)
+{
+    FE_LIMB d;
+    int i;
+
+    d = 0;
+    for(i=0; i<FE_LIMBS; i++)
+        d |= a[i];
+
+    return ((d | (0 - d)) >> (FE_LIMB_BITS - 1)) - 1;
+}
+
+void FE_FromMP(FE c, const DWORD *a)
+{
+    FE t;
+    int i;
+
+    for(i=0; i<FE_LIMBS; i++)
+#if FE_LIMB_BITS == 64
+        t[i] = (FE_LIMB)a[2*i] | ((FE_LIMB)a[2*i+1] << 32);
+#else
+        t[i] = a[i];
+#endif
+
+    FE_Mul(c, t, fe_rr);
+}
+
+void FE_ToMP(DWORD *c, const FE a)
+{
+    FE t;
+    int i;
+
+    FE_Mul(t, a, fe_one);
+
+    for(i=0; i<FE_LIMBS; i++)
+    {
+#if FE_LIMB_BITS == 64
+        c[2*i] = (DWORD)t[i];
+        c[2*i+1] = (DWORD)(t[i] >> 32);
+#else
+        c[i] = t[i];
+#endif
+    }
+}
+
 #endif
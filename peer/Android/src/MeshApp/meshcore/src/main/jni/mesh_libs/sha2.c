@@ -48,10 +48,38 @@ For more information, please refer to <https://unlicense.org>
 //  IMPORTS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// #define SHA256_UNIT_TEST
+
 //#include "sha256.h"
 #include "sha2.h"
 #include <memory.h>
 
+// The hardware transforms need compiler support for the SHA instructions, they are
+// enabled for their functions only and used when the CPU has them.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SHA256_HW_X86
+#define SHA256_HW_TARGET __attribute__((target("sha,sse4.1")))
+#include <cpuid.h>
+#include <immintrin.h>
+#ifndef bit_SHA
+#define bit_SHA (1 << 29)
+#endif
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#define SHA256_HW_ARMV8
+#define SHA256_HW_TARGET
+#include <arm_neon.h>
+#elif defined(__aarch64__) && defined(__clang__) && (__clang_major__ >= 13)
+#define SHA256_HW_ARMV8
+#define SHA256_HW_TARGET __attribute__((target("sha2")))
+#include <arm_neon.h>
+#endif
+#if defined(SHA256_HW_ARMV8) && !defined(__APPLE__)
+#include <sys/auxv.h>
+#ifndef HWCAP_SHA2
+#define HWCAP_SHA2 (1 << 6)
+#endif
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  MACROS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -129,11 +157,11 @@ static const uint32_t K[64] = {
   h = t0 + t1;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-//  TransformFunction
+//  TransformPortable
 //
-//  Compress 512-bits
+//  Compress 512-bits, Blocks times
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-static void TransformFunction(Sha256Context* Context, uint8_t const* Buffer) {
+static void TransformPortable(uint32_t* State, uint8_t const* Buffer, uint32_t Blocks) {
   uint32_t S[8];
   uint32_t W[64];
   uint32_t t0;
@@ -141,45 +169,221 @@ static void TransformFunction(Sha256Context* Context, uint8_t const* Buffer) {
   uint32_t t;
   int i;
 
-  // Copy state into S
-  for (i = 0; i < 8; i++) {
-    S[i] = Context->state[i];
+  for (; Blocks > 0; Blocks--, Buffer += BLOCK_SIZE) {
+    // Copy state into S
+    for (i = 0; i < 8; i++) {
+      S[i] = State[i];
+    }
+
+    // Copy the state into 512-bits into W[0..15]
+    for (i = 0; i < 16; i++) {
+      LOAD32H(W[i], Buffer + (4 * i));
+    }
+
+    // Fill W[16..63]
+    for (i = 16; i < 64; i++) {
+      W[i] = Gamma1(W[i - 2]) + W[i - 7] + Gamma0(W[i - 15]) + W[i - 16];
+    }
+
+    // Compress
+    for (i = 0; i < 64; i++) {
+      Sha256Round(S[0], S[1], S[2], S[3], S[4], S[5], S[6], S[7], i);
+      t = S[7];
+      S[7] = S[6];
+      S[6] = S[5];
+      S[5] = S[4];
+      S[4] = S[3];
+      S[3] = S[2];
+      S[2] = S[1];
+      S[1] = S[0];
+      S[0] = t;
+    }
+
+    // Feedback
+    for (i = 0; i < 8; i++) {
+      State[i] = State[i] + S[i];
+    }
   }
+}
+
+#if defined(SHA256_HW_X86)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TransformHw
+//
+//  Compress 512-bits, Blocks times, with the SHA extensions. SHA256RNDS2 keeps the state as
+//  ABEF and CDGH and does two rounds, the message words W[i..i+3] are in one register.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+SHA256_HW_TARGET static void TransformHw(uint32_t* State, uint8_t const* Buffer, uint32_t Blocks) {
+  const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+  __m128i abef, cdgh, abef_save, cdgh_save, msg, tmp;
+  __m128i W[4];
+  int i;
 
-  // Copy the state into 512-bits into W[0..15]
-  for (i = 0; i < 16; i++) {
-    LOAD32H(W[i], Buffer + (4 * i));
+  tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&State[0]), 0xB1);   // CDAB
+  cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&State[4]), 0x1B);  // EFGH
+  abef = _mm_alignr_epi8(tmp, cdgh, 8);
+  cdgh = _mm_blend_epi16(cdgh, tmp, 0xF0);
+
+  for (; Blocks > 0; Blocks--, Buffer += BLOCK_SIZE) {
+    abef_save = abef;
+    cdgh_save = cdgh;
+
+    for (i = 0; i < 4; i++) {
+      W[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(Buffer + 16 * i)), mask);
+    }
+
+    // Four rounds per step, the schedule computes the words of step i + 4 from the last four
+    for (i = 0; i < 16; i++) {
+      msg = _mm_add_epi32(W[i & 3], _mm_loadu_si128((const __m128i*)&K[4 * i]));
+      cdgh = _mm_sha256rnds2_epu32(cdgh, abef, msg);
+      abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(msg, 0x0E));
+      if (i < 12) {
+        tmp = _mm_add_epi32(_mm_sha256msg1_epu32(W[i & 3], W[(i + 1) & 3]),
+                            _mm_alignr_epi8(W[(i + 3) & 3], W[(i + 2) & 3], 4));
+        W[i & 3] = _mm_sha256msg2_epu32(tmp, W[(i + 3) & 3]);
+      }
+    }
+
+    abef = _mm_add_epi32(abef, abef_save);
+    cdgh = _mm_add_epi32(cdgh, cdgh_save);
   }
 
-  // Fill W[16..63]
-  for (i = 16; i < 64; i++) {
-    W[i] = Gamma1(W[i - 2]) + W[i - 7] + Gamma0(W[i - 15]) + W[i - 16];
+  tmp = _mm_shuffle_epi32(abef, 0x1B);   // FEBA
+  cdgh = _mm_shuffle_epi32(cdgh, 0xB1);  // DCHG
+  _mm_storeu_si128((__m128i*)&State[0], _mm_blend_epi16(tmp, cdgh, 0xF0));
+  _mm_storeu_si128((__m128i*)&State[4], _mm_alignr_epi8(cdgh, tmp, 8));
+}
+
+static int Sha256HwAvailable(void) {
+  unsigned int eax, ebx, ecx, edx;
+
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSE4_1)) {
+    return 0;
   }
+  if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+    return 0;
+  }
+  return (ebx & bit_SHA) != 0;
+}
+
+#elif defined(SHA256_HW_ARMV8)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TransformHw
+//
+//  Compress 512-bits, Blocks times, with the ARMv8 SHA2 instructions. SHA256H and SHA256H2
+//  do four rounds on the ABCD and EFGH halves of the state.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+SHA256_HW_TARGET static void TransformHw(uint32_t* State, uint8_t const* Buffer, uint32_t Blocks) {
+  uint32x4_t abcd = vld1q_u32(&State[0]);
+  uint32x4_t efgh = vld1q_u32(&State[4]);
+  uint32x4_t abcd_save, efgh_save, msg, tmp;
+  uint32x4_t W[4];
+  int i;
+
+  for (; Blocks > 0; Blocks--, Buffer += BLOCK_SIZE) {
+    abcd_save = abcd;
+    efgh_save = efgh;
 
-  // Compress
-  for (i = 0; i < 64; i++) {
-    Sha256Round(S[0], S[1], S[2], S[3], S[4], S[5], S[6], S[7], i);
-    t = S[7];
-    S[7] = S[6];
-    S[6] = S[5];
-    S[5] = S[4];
-    S[4] = S[3];
-    S[3] = S[2];
-    S[2] = S[1];
-    S[1] = S[0];
-    S[0] = t;
+    for (i = 0; i < 4; i++) {
+      W[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(Buffer + 16 * i)));
+    }
+
+    // Four rounds per step, the schedule computes the words of step i + 4 from the last four
+    for (i = 0; i < 16; i++) {
+      msg = vaddq_u32(W[i & 3], vld1q_u32(&K[4 * i]));
+      if (i < 12) {
+        W[i & 3] = vsha256su1q_u32(vsha256su0q_u32(W[i & 3], W[(i + 1) & 3]), W[(i + 2) & 3], W[(i + 3) & 3]);
+      }
+      tmp = abcd;
+      abcd = vsha256hq_u32(abcd, efgh, msg);
+      efgh = vsha256h2q_u32(efgh, tmp, msg);
+    }
+
+    abcd = vaddq_u32(abcd, abcd_save);
+    efgh = vaddq_u32(efgh, efgh_save);
   }
 
-  // Feedback
-  for (i = 0; i < 8; i++) {
-    Context->state[i] = Context->state[i] + S[i];
+  vst1q_u32(&State[0], abcd);
+  vst1q_u32(&State[4], efgh);
+}
+
+static int Sha256HwAvailable(void) {
+#if defined(__APPLE__)
+  return 1;
+#else
+  return (getauxval(AT_HWCAP) & HWCAP_SHA2) != 0;
+#endif
+}
+
+#else
+
+#define TransformHw TransformPortable
+
+static int Sha256HwAvailable(void) {
+  return 0;
+}
+
+#endif
+
+typedef void (*Sha256TransformFn)(uint32_t* State, uint8_t const* Buffer, uint32_t Blocks);
+
+// Written once on the first use, all threads pick the same version
+static Sha256TransformFn Sha256Transform = 0;
+static int Sha256Impl = -1;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TransformFunction
+//
+//  Compress 512-bits, Blocks times, with the selected transform
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static void TransformFunction(Sha256Context* Context, uint8_t const* Buffer, uint32_t Blocks) {
+  if (!Sha256Transform) {
+    Sha256GetImpl();
   }
+  Sha256Transform(Context->state, Buffer, Blocks);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  PUBLIC FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha256SelectImpl
+//
+//  Forces one version of the transform. Returns non zero if the version is not available.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int Sha256SelectImpl(int Impl) {
+  switch (Impl) {
+    case SHA256_IMPL_PORTABLE:
+      Sha256Transform = TransformPortable;
+      break;
+    case SHA256_IMPL_HW:
+      if (!Sha256HwAvailable()) {
+        return -1;
+      }
+      Sha256Transform = TransformHw;
+      break;
+    default:
+      return -1;
+  }
+  Sha256Impl = Impl;
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha256GetImpl
+//
+//  Returns the version of the transform in use, the first call picks the fastest one.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int Sha256GetImpl(void) {
+  if (Sha256Impl < 0 && Sha256SelectImpl(SHA256_IMPL_HW) != 0) {
+    Sha256SelectImpl(SHA256_IMPL_PORTABLE);
+  }
+  return Sha256Impl;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  Sha256Initialise
 //
@@ -218,10 +422,11 @@ void Sha256Update(Sha256Context* Context,  // [in out]
 
   while (BufferSize > 0) {
     if (Context->curlen == 0 && BufferSize >= BLOCK_SIZE) {
-      TransformFunction(Context, (uint8_t*)Buffer);
-      Context->length += BLOCK_SIZE * 8;
-      Buffer = (uint8_t*)Buffer + BLOCK_SIZE;
-      BufferSize -= BLOCK_SIZE;
+      n = BufferSize / BLOCK_SIZE;
+      TransformFunction(Context, (uint8_t*)Buffer, n);
+      Context->length += (uint64_t)n * BLOCK_SIZE * 8;
+      Buffer = (uint8_t*)Buffer + n * BLOCK_SIZE;
+      BufferSize -= n * BLOCK_SIZE;
     } else {
       n = MIN(BufferSize, (BLOCK_SIZE - Context->curlen));
       memcpy(Context->buf + Context->curlen, Buffer, (size_t)n);
@@ -229,7 +434,7 @@ void Sha256Update(Sha256Context* Context,  // [in out]
       Buffer = (uint8_t*)Buffer + n;
       BufferSize -= n;
       if (Context->curlen == BLOCK_SIZE) {
-        TransformFunction(Context, Context->buf);
+        TransformFunction(Context, Context->buf, 1);
         Context->length += 8 * BLOCK_SIZE;
         Context->curlen = 0;
       }
@@ -266,7 +471,7 @@ void Sha256Finalise(Sha256Context* Context,  // [in out]
     while (Context->curlen < 64) {
       Context->buf[Context->curlen++] = (uint8_t)0;
     }
-    TransformFunction(Context, Context->buf);
+    TransformFunction(Context, Context->buf, 1);
     Context->curlen = 0;
   }
 
@@ -277,7 +482,7 @@ void Sha256Finalise(Sha256Context* Context,  // [in out]
 
   // Store length
   STORE64H(Context->length, Context->buf + 56);
-  TransformFunction(Context, Context->buf);
+  TransformFunction(Context, Context->buf, 1);
 
   // Copy output
   for (i = 0; i < 8; i++) {
@@ -312,43 +517,51 @@ void Sha256Calculate(void const* Buffer,   // [in]
 
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 
 #define SHA256_BLOCK_SIZE 64
 
 /* LOCAL FUNCTIONS */
 
-// Concatenate X & Y, return hash.
-static void* H(const void* x,
-               const size_t xlen,
-               const void* y,
-               const size_t ylen,
-               void* out,
-               const size_t outlen);
-
 // Wrapper for sha256
 static void* sha256(const void* data,
                     const size_t datalen,
                     void* out,
                     const size_t outlen);
 
-// Declared in hmac_sha256.h
-size_t hmac_sha256(const void* key,
-                   const size_t keylen,
-                   const void* data,
-                   const size_t datalen,
-                   void* out,
-                   const size_t outlen) {
+// The provisioning confirmation and authentication run several MACs with the
+// same few keys, the midstates of the last keys used are kept until
+// hmac_sha256_cache_invalidate wipes them at the end of the provisioning.
+#define HMAC_SHA256_KEY_CACHE_SIZE 4
+
+typedef struct {
+  HmacSha256Context ctx;
+  uint8_t key[SHA256_BLOCK_SIZE];
+  size_t keylen;  // 0 if the entry is empty
+} hmac_key_cache_entry_t;
+
+static hmac_key_cache_entry_t hmac_key_cache[HMAC_SHA256_KEY_CACHE_SIZE];
+static int hmac_key_cache_next;
+static unsigned int hmac_key_cache_generation;
+static pthread_mutex_t hmac_key_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// The barrier keeps the compiler from dropping the memset of a buffer that
+// is not read again
+static void hmac_wipe(void* p, size_t len) {
+  memset(p, 0, len);
+  __asm__ __volatile__("" : : "r"(p) : "memory");
+}
+
+// Declared in sha2.h
+void hmac_sha256_init(HmacSha256Context* ctx,
+                      const void* key,
+                      const size_t keylen) {
   uint8_t k[SHA256_BLOCK_SIZE];
   uint8_t k_ipad[SHA256_BLOCK_SIZE];
   uint8_t k_opad[SHA256_BLOCK_SIZE];
-  uint8_t ihash[SHA256_HASH_SIZE];
-  uint8_t ohash[SHA256_HASH_SIZE];
-  size_t sz;
   int i;
 
   memset(k, 0, sizeof(k));
-  memset(k_ipad, 0x36, SHA256_BLOCK_SIZE);
-  memset(k_opad, 0x5c, SHA256_BLOCK_SIZE);
 
   if (keylen > SHA256_BLOCK_SIZE) {
     // If the key is larger than the hash algorithm's
@@ -359,36 +572,119 @@ size_t hmac_sha256(const void* key,
   }
 
   for (i = 0; i < SHA256_BLOCK_SIZE; i++) {
-    k_ipad[i] ^= k[i];
-    k_opad[i] ^= k[i];
+    k_ipad[i] = k[i] ^ 0x36;
+    k_opad[i] = k[i] ^ 0x5c;
   }
 
+  // Both pads are exactly one block, the states after them are all that
+  // the MACs of later messages need from the key.
+  Sha256Initialise(&ctx->inner);
+  Sha256Update(&ctx->inner, k_ipad, sizeof(k_ipad));
+  Sha256Initialise(&ctx->outer);
+  Sha256Update(&ctx->outer, k_opad, sizeof(k_opad));
+  ctx->running = ctx->inner;
+
+  hmac_wipe(k, sizeof(k));
+  hmac_wipe(k_ipad, sizeof(k_ipad));
+  hmac_wipe(k_opad, sizeof(k_opad));
+}
+
+// Declared in sha2.h
+void hmac_sha256_update(HmacSha256Context* ctx,
+                        const void* data,
+                        const size_t datalen) {
+  Sha256Update(&ctx->running, data, (uint32_t)datalen);
+}
+
+// Declared in sha2.h
+size_t hmac_sha256_final(HmacSha256Context* ctx,
+                         void* out,
+                         const size_t outlen) {
+  Sha256Context octx;
+  SHA256_HASH ihash;
+  SHA256_HASH ohash;
+  size_t sz;
+
   // Perform HMAC algorithm: ( https://tools.ietf.org/html/rfc2104 )
   //      `H(K XOR opad, H(K XOR ipad, data))`
-  H(k_ipad, sizeof(k_ipad), data, datalen, ihash, sizeof(ihash));
-  H(k_opad, sizeof(k_opad), ihash, sizeof(ihash), ohash, sizeof(ohash));
+  Sha256Finalise(&ctx->running, &ihash);
+  octx = ctx->outer;
+  Sha256Update(&octx, ihash.bytes, sizeof(ihash.bytes));
+  Sha256Finalise(&octx, &ohash);
+
+  // ready for the next message with the same key
+  ctx->running = ctx->inner;
 
   sz = (outlen == 0 || outlen > SHA256_HASH_SIZE) ? SHA256_HASH_SIZE : outlen;
-  memcpy(out, ohash, sz);
+  memcpy(out, ohash.bytes, sz);
+  hmac_wipe(&ihash, sizeof(ihash));
+  hmac_wipe(&ohash, sizeof(ohash));
   return sz;
 }
 
-static void* H(const void* x,
-               const size_t xlen,
-               const void* y,
-               const size_t ylen,
-               void* out,
-               const size_t outlen) {
-  void* result;
-  size_t buflen = (xlen + ylen);
-  uint8_t* buf = (uint8_t*)malloc(buflen);
-
-  memcpy(buf, x, xlen);
-  memcpy(buf + xlen, y, ylen);
-  result = sha256(buf, buflen, out, outlen);
-
-  free(buf);
-  return result;
+// Declared in sha2.h
+void hmac_sha256_cache_invalidate(void) {
+  pthread_mutex_lock(&hmac_key_cache_mutex);
+  hmac_wipe(hmac_key_cache, sizeof(hmac_key_cache));
+  hmac_key_cache_next = 0;
+  hmac_key_cache_generation++;
+  pthread_mutex_unlock(&hmac_key_cache_mutex);
+}
+
+// Declared in hmac_sha256.h
+size_t hmac_sha256(const void* key,
+                   const size_t keylen,
+                   const void* data,
+                   const size_t datalen,
+                   void* out,
+                   const size_t outlen) {
+  HmacSha256Context ctx;
+  unsigned int generation;
+  size_t sz;
+  int i, found = -1;
+
+  // Longer keys are digested first, like an empty key they are not kept
+  if (keylen > SHA256_BLOCK_SIZE || keylen == 0) {
+    hmac_sha256_init(&ctx, key, keylen);
+    hmac_sha256_update(&ctx, data, datalen);
+    sz = hmac_sha256_final(&ctx, out, outlen);
+    hmac_wipe(&ctx, sizeof(ctx));
+    return sz;
+  }
+
+  // the MAC is computed on a copy of the keyed context without the mutex
+  pthread_mutex_lock(&hmac_key_cache_mutex);
+  for (i = 0; i < HMAC_SHA256_KEY_CACHE_SIZE; i++) {
+    if (hmac_key_cache[i].keylen == keylen &&
+        memcmp(hmac_key_cache[i].key, key, keylen) == 0) {
+      ctx = hmac_key_cache[i].ctx;
+      found = i;
+      break;
+    }
+  }
+  generation = hmac_key_cache_generation;
+  pthread_mutex_unlock(&hmac_key_cache_mutex);
+
+  if (found < 0) {
+    hmac_sha256_init(&ctx, key, keylen);
+  }
+  hmac_sha256_update(&ctx, data, datalen);
+  sz = hmac_sha256_final(&ctx, out, outlen);
+
+  // an invalidate while the MAC was computed drops the new key
+  if (found < 0) {
+    pthread_mutex_lock(&hmac_key_cache_mutex);
+    if (generation == hmac_key_cache_generation) {
+      i = hmac_key_cache_next;
+      hmac_key_cache_next = (hmac_key_cache_next + 1) % HMAC_SHA256_KEY_CACHE_SIZE;
+      hmac_key_cache[i].ctx = ctx;
+      memcpy(hmac_key_cache[i].key, key, keylen);
+      hmac_key_cache[i].keylen = keylen;
+    }
+    pthread_mutex_unlock(&hmac_key_cache_mutex);
+  }
+  hmac_wipe(&ctx, sizeof(ctx));
+  return sz;
 }
 
 static void* sha256(const void* data,
@@ -406,3 +702,202 @@ static void* sha256(const void* data,
   sz = (outlen > SHA256_HASH_SIZE) ? SHA256_HASH_SIZE : outlen;
   return memcpy(out, hash.bytes, sz);
 }
+
+#ifdef SHA256_UNIT_TEST
+#include <time.h>
+
+static void from_hex(const char* hex, uint8_t* bytes) {
+  unsigned int b;
+
+  while (hex[0] && hex[1] && sscanf(hex, "%2x", &b) == 1) {
+    *bytes++ = (uint8_t)b;
+    hex += 2;
+  }
+}
+
+static int check(const char* name, const uint8_t* bytes, const char* expected) {
+  uint8_t e[SHA256_HASH_SIZE];
+
+  from_hex(expected, e);
+  if (memcmp(bytes, e, strlen(expected) / 2) != 0) {
+    printf("%s FAILED\n", name);
+    return 1;
+  }
+  return 0;
+}
+
+static double now_ns(void) {
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+int main() {
+  // FIPS 180-2 examples
+  static const struct {
+    const char* data;
+    const char* hash;
+  } sha_kat[] = {
+      {"abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"},
+      {"", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"},
+      {"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+       "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"},
+  };
+  static const char* million_a = "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0";
+  // RFC 4231 test cases 1 to 7, case 5 checks a truncated MAC
+  static const char* hmac_kat[7] = {
+      "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7",
+      "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843",
+      "773ea91e36800e46854db8ebd09181a72959098b3ef8c122d9635514ced565fe",
+      "82558a389a443c0ea4cc819899f2083a85f0faa3e578f8077a2e3ff46729665b",
+      "a3b6167473100ee06e0c796c2955552b",
+      "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54",
+      "9b09ffa71b942fcb27635fbcd5b0e944bfdc63644f0713938a7f51535c3a35e2",
+  };
+  static const char* impl_name[2] = {"portable", "hardware"};
+  static uint8_t key[7][131], data[7][160], big[1000000];
+  static size_t keylen[7], datalen[7];
+  static uint8_t ref[301][SHA256_HASH_SIZE];
+  Sha256Context ctx;
+  SHA256_HASH hash;
+  HmacSha256Context hctx;
+  uint8_t mac[SHA256_HASH_SIZE], mac2[SHA256_HASH_SIZE];
+  double t0, block_ns[2] = {0, 0};
+  int failed = 0, impl, i, j, n;
+
+  memset(key[0], 0x0b, keylen[0] = 20);
+  memcpy(data[0], "Hi There", datalen[0] = 8);
+  memcpy(key[1], "Jefe", keylen[1] = 4);
+  memcpy(data[1], "what do ya want for nothing?", datalen[1] = 28);
+  memset(key[2], 0xaa, keylen[2] = 20);
+  memset(data[2], 0xdd, datalen[2] = 50);
+  for (i = 0; i < 25; i++) key[3][i] = (uint8_t)(i + 1);
+  keylen[3] = 25;
+  memset(data[3], 0xcd, datalen[3] = 50);
+  memset(key[4], 0x0c, keylen[4] = 20);
+  memcpy(data[4], "Test With Truncation", datalen[4] = 20);
+  memset(key[5], 0xaa, keylen[5] = 131);
+  memcpy(data[5], "Test Using Larger Than Block-Size Key - Hash Key First", datalen[5] = 54);
+  memset(key[6], 0xaa, keylen[6] = 131);
+  memcpy(data[6],
+         "This is a test using a larger than block-size key and a larger than block-size data. "
+         "The key needs to be hashed before being used by the HMAC algorithm.",
+         datalen[6] = 152);
+
+  for (impl = SHA256_IMPL_PORTABLE; impl <= SHA256_IMPL_HW; impl++) {
+    if (Sha256SelectImpl(impl) != 0) {
+      printf("\n%s transform not available\n", impl_name[impl]);
+      continue;
+    }
+    printf("\n%s transform\n", impl_name[impl]);
+
+    for (i = 0; i < (int)(sizeof(sha_kat) / sizeof(sha_kat[0])); i++) {
+      Sha256Calculate(sha_kat[i].data, (uint32_t)strlen(sha_kat[i].data), &hash);
+      failed |= check("Sha256Calculate", hash.bytes, sha_kat[i].hash);
+    }
+
+    // one call takes the multi block path, pieces of 1000 bytes go through the buffer
+    memset(big, 'a', sizeof(big));
+    Sha256Calculate(big, sizeof(big), &hash);
+    failed |= check("Sha256Calculate million a", hash.bytes, million_a);
+    Sha256Initialise(&ctx);
+    for (i = 0; i < 1000; i++) {
+      Sha256Update(&ctx, big, 1000);
+    }
+    Sha256Finalise(&ctx, &hash);
+    failed |= check("Sha256Update million a", hash.bytes, million_a);
+
+    for (i = 0; i < 7; i++) {
+      n = (i == 4) ? 16 : SHA256_HASH_SIZE;
+      if (hmac_sha256(key[i], keylen[i], data[i], datalen[i], mac, n) != (size_t)n) {
+        printf("hmac_sha256 length FAILED\n");
+        failed = 1;
+      }
+      failed |= check("hmac_sha256", mac, hmac_kat[i]);
+
+      // a context serves any number of messages
+      hmac_sha256_init(&hctx, key[i], keylen[i]);
+      for (j = 0; j < 2; j++) {
+        hmac_sha256_update(&hctx, data[i], 5);
+        hmac_sha256_update(&hctx, data[i] + 5, datalen[i] - 5);
+        hmac_sha256_final(&hctx, mac, n);
+        failed |= check("hmac_sha256_final", mac, hmac_kat[i]);
+      }
+    }
+
+    // all transforms give the same hash for every length up to a few blocks
+    for (i = 0; i <= 300; i++) {
+      for (j = 0; j < i; j++) big[j] = (uint8_t)(j * 7 + i);
+      Sha256Calculate(big, i, &hash);
+      if (impl == SHA256_IMPL_PORTABLE) {
+        memcpy(ref[i], hash.bytes, SHA256_HASH_SIZE);
+      } else if (memcmp(ref[i], hash.bytes, SHA256_HASH_SIZE) != 0) {
+        printf("Sha256Calculate %d bytes differs from portable FAILED\n", i);
+        failed = 1;
+      }
+    }
+
+    t0 = now_ns();
+    for (i = 0; i < 16; i++) {
+      Sha256Calculate(big, 65536, &hash);
+    }
+    block_ns[impl] = (now_ns() - t0) / (16 * 1024);
+    printf("%.1f ns per block\n", block_ns[impl]);
+  }
+  Sha256SelectImpl(SHA256_IMPL_PORTABLE);
+  Sha256GetImpl();
+
+  // more keys than the per thread cache keeps, each MAC must still use its own key
+  for (n = 0; n < 3; n++) {
+    for (i = 0; i < 7; i++) {
+      hmac_sha256(key[i], keylen[i], data[(i + n) % 7], datalen[(i + n) % 7], mac, 0);
+      hmac_sha256_init(&hctx, key[i], keylen[i]);
+      hmac_sha256_update(&hctx, data[(i + n) % 7], datalen[(i + n) % 7]);
+      hmac_sha256_final(&hctx, mac2, 0);
+      if (memcmp(mac, mac2, SHA256_HASH_SIZE) != 0) {
+        printf("hmac_sha256 key cache FAILED\n");
+        failed = 1;
+      }
+    }
+  }
+
+  // an invalidate wipes every kept key and context, the next MACs set them up again
+  hmac_sha256_cache_invalidate();
+  for (i = 0; i < (int)sizeof(hmac_key_cache); i++) {
+    if (((uint8_t*)hmac_key_cache)[i] != 0) {
+      printf("hmac_sha256_cache_invalidate wipe FAILED\n");
+      failed = 1;
+      break;
+    }
+  }
+  for (i = 0; i < 7; i++) {
+    n = (i == 4) ? 16 : SHA256_HASH_SIZE;
+    hmac_sha256(key[i], keylen[i], data[i], datalen[i], mac, n);
+    failed |= check("hmac_sha256 after invalidate", mac, hmac_kat[i]);
+  }
+
+  // the provisioning authentication MACs 145 bytes with a 32 byte key
+  for (impl = SHA256_IMPL_PORTABLE; impl <= SHA256_IMPL_HW; impl++) {
+    if (Sha256SelectImpl(impl) != 0) {
+      continue;
+    }
+    t0 = now_ns();
+    for (i = 0; i < 10000; i++) {
+      hmac_sha256_init(&hctx, big, 32);
+      hmac_sha256_update(&hctx, big + 32, 145);
+      hmac_sha256_final(&hctx, mac, 0);
+    }
+    printf("%s: %.0f ns per HMAC with the key setup, ", impl_name[impl], (now_ns() - t0) / 10000);
+    t0 = now_ns();
+    for (i = 0; i < 10000; i++) {
+      hmac_sha256(big, 32, big + 32, 145, mac, 0);
+    }
+    printf("%.0f ns with cached midstates\n", (now_ns() - t0) / 10000);
+  }
+
+  printf("--------------------------------------------------\n");
+  printf("%s\n", failed ? "FAILED" : "PASSED");
+  return failed;
+}
+#endif
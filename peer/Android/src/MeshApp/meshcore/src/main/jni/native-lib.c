@@ -44,7 +44,10 @@
 #include <sys/stat.h>
 #include <time.h>
 #include <pthread.h>
+#include <errno.h>
+#include <sys/timerfd.h>
 #include <p_256_types.h>
+#include "wiced_timer_wheel.h"
 
 #ifdef MESH_DFU_ENABLED
 #include "wiced_bt_mesh_dfu.h"
@@ -84,8 +87,6 @@ static jmethodID meshClientDfuStatusCb;
 static jmethodID meshClientLinkStatusCb;
 static jmethodID meshClientNetworkOpenedCb;
 static jmethodID meshClientComponentInfoCb;
-static jmethodID startTimercb;
-static jmethodID stopTimercb;
 static jmethodID sensorStatuscb;
 static jmethodID vendorStatusCb;
 static jmethodID lightLcModeStatusCb;
@@ -101,6 +102,8 @@ extern void mesh_client_advert_report(uint8_t *bd_addr, uint8_t addr_type, int8_
 extern void MeshTimerFunc(long timer_id);
 
 extern pthread_mutex_t cs;
+extern void EnterCriticalSection();
+extern void LeaveCriticalSection();
 
 static void create_prov_uuid(void);
 #ifdef MESH_DFU_ENABLED
@@ -128,7 +131,32 @@ typedef struct
 
 device_config_params_t DeviceConfig = { 1, 1, 1, 1, 3, 100, 8, 3, 100, 0, 8, 0, 0, 500 };
 
-static uint32_t timer_id = 1;
+/*
+ * The mesh library timers run in a native thread. The timers are kept in a timer wheel and the thread waits
+ * on a timerfd armed for the next expiration, then calls MeshTimerFunc with the critical section held like
+ * the calls that come from Java. Ids given to the library are the entry index plus a generation count.
+ */
+#define NATIVE_TIMER_INDEX_BITS     16
+#define NATIVE_TIMER_INDEX_MASK     ((1 << NATIVE_TIMER_INDEX_BITS) - 1)
+#define NATIVE_TIMER_GROW           32
+
+typedef struct native_timer
+{
+    wiced_timer_wheel_node_t node;          /* must be first */
+    struct native_timer     *p_free;        /* next entry in the free list */
+    uint32_t                 id;            /* id of the started timer, 0 when the entry is free */
+    uint16_t                 index;         /* position in native_timers */
+    uint16_t                 generation;
+    uint16_t                 type;
+} native_timer_t;
+
+static native_timer_t     **native_timers = NULL;
+static uint32_t             native_timer_count = 0;
+static native_timer_t      *native_timer_free = NULL;
+static wiced_timer_wheel_t  native_timer_wheel;
+static uint64_t             native_timer_armed = WICED_TIMER_WHEEL_NEVER;
+static int                  native_timer_fd = -1;
+static pthread_t            native_timer_thread;
 static char* dfu_firmware_file;
 
 
@@ -1171,12 +1199,6 @@ Java_com_cypress_le_mesh_meshcore_MeshNativeHelper_meshClientHslSet(JNIEnv *env,
     return return_val;
 }
 
-JNIEXPORT void JNICALL
-Java_com_cypress_le_mesh_meshcore_MeshNativeHelper_timerCallback(JNIEnv *env, jclass type,
-                                                                 jlong timerid) {
-    MeshTimerFunc(timerid);
-}
-
 JNIEXPORT jint JNICALL
 Java_com_cypress_le_mesh_meshcore_MeshNativeHelper_meshClientSetDeviceConfig(JNIEnv *env,
                                                                              jclass type,
@@ -1379,35 +1401,202 @@ void proxy_gatt_send_cb(uint32_t conn_id, uint32_t ref_data, const uint8_t *pack
     (*env)->CallStaticVoidMethod(env, cls2, meshGattProxySendCb,data, lengthx);
 }
 
+// Current time in ms on the clock used by the timerfd
+static uint64_t native_timer_now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// Arm the timerfd for the next time the wheel has work, or disarm it if the wheel is empty
+static void native_timer_rearm(void)
+{
+    struct itimerspec its;
+    uint64_t          next = wiced_timer_wheel_next(&native_timer_wheel);
+
+    if (next == native_timer_armed)
+        return;
+    native_timer_armed = next;
+
+    memset(&its, 0, sizeof(its));
+    if (next != WICED_TIMER_WHEEL_NEVER)
+    {
+        // zero it_value disarms the timer, expire at least 1ns from the epoch instead
+        its.it_value.tv_sec  = next / 1000;
+        its.it_value.tv_nsec = (next % 1000) * 1000000 + 1;
+    }
+    timerfd_settime(native_timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+static native_timer_t *native_timer_find(uint32_t id)
+{
+    uint32_t index = id & NATIVE_TIMER_INDEX_MASK;
+
+    if ((index == 0) || (index > native_timer_count) || (native_timers[index - 1]->id != id))
+        return NULL;
+    return native_timers[index - 1];
+}
+
+static native_timer_t *native_timer_alloc(void)
+{
+    native_timer_t  *p_timer;
+    native_timer_t **p_table;
+    uint32_t         i;
+
+    if (native_timer_free == NULL)
+    {
+        if (native_timer_count + NATIVE_TIMER_GROW > NATIVE_TIMER_INDEX_MASK)
+            return NULL;
+        p_table = (native_timer_t **)realloc(native_timers, (native_timer_count + NATIVE_TIMER_GROW) * sizeof(native_timer_t *));
+        if (p_table == NULL)
+            return NULL;
+        native_timers = p_table;
+
+        // entries never move, the wheel links them by address
+        p_timer = (native_timer_t *)calloc(NATIVE_TIMER_GROW, sizeof(native_timer_t));
+        if (p_timer == NULL)
+            return NULL;
+        for (i = 0; i < NATIVE_TIMER_GROW; i++, p_timer++)
+        {
+            p_timer->index = native_timer_count;
+            native_timers[native_timer_count++] = p_timer;
+            p_timer->p_free = native_timer_free;
+            native_timer_free = p_timer;
+        }
+    }
+    p_timer = native_timer_free;
+    native_timer_free = p_timer->p_free;
+    p_timer->p_free = NULL;
+    p_timer->id = ((uint32_t)p_timer->generation << NATIVE_TIMER_INDEX_BITS) | (p_timer->index + 1);
+    return p_timer;
+}
+
+// Stale ids of a released entry do not match it anymore
+static void native_timer_release(native_timer_t *p_timer)
+{
+    wiced_timer_wheel_remove(&native_timer_wheel, &p_timer->node);
+    p_timer->id = 0;
+    p_timer->generation++;
+    p_timer->p_free = native_timer_free;
+    native_timer_free = p_timer;
+}
+
+static void *native_timer_thread_func(void *arg)
+{
+    uint64_t        expirations;
+    uint64_t        now;
+    uint32_t        id;
+    native_timer_t *p_timer;
+
+    while (1)
+    {
+        if (read(native_timer_fd, &expirations, sizeof(expirations)) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            Log("native timer read failed:%d\n", errno);
+            break;
+        }
+        EnterCriticalSection();
+        now = native_timer_now_ms();
+        native_timer_armed = WICED_TIMER_WHEEL_NEVER;
+
+        // callbacks can start and stop any timer, take expired timers off the wheel one at a time
+        while ((p_timer = (native_timer_t *)wiced_timer_wheel_expire(&native_timer_wheel, now)) != NULL)
+        {
+            id = p_timer->id;
+
+            // one shot timers are done, MeshTimerFunc restarts the periodic ones
+            if ((p_timer->type != WICED_SECONDS_PERIODIC_TIMER) && (p_timer->type != WICED_MILLI_SECONDS_PERIODIC_TIMER))
+                native_timer_release(p_timer);
+            MeshTimerFunc(id);
+        }
+        native_timer_rearm();
+        LeaveCriticalSection();
+    }
+    return NULL;
+}
+
+static wiced_bool_t native_timer_init(void)
+{
+    if (native_timer_fd >= 0)
+        return WICED_TRUE;
+
+    wiced_timer_wheel_init(&native_timer_wheel, native_timer_now_ms());
+
+    native_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (native_timer_fd < 0)
+    {
+        Log("timerfd_create failed:%d\n", errno);
+        return WICED_FALSE;
+    }
+    if (pthread_create(&native_timer_thread, NULL, native_timer_thread_func, NULL) != 0)
+    {
+        Log("native timer thread failed\n");
+        close(native_timer_fd);
+        native_timer_fd = -1;
+        return WICED_FALSE;
+    }
+    pthread_setname_np(native_timer_thread, "MeshTimer");
+    return WICED_TRUE;
+}
+
 uint32_t start_timer(uint32_t timeout, uint16_t type) {
-    JNIEnv *env = AttachJava();
-    jstring deviceName;
-    uint32_t curr_timerid = timer_id;
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
-    jint time = timeout;
-    Log("start_timer timer_id:%x\n",curr_timerid);
-    (*env)->CallStaticVoidMethod(env, cls2, startTimercb, curr_timerid, time, type);
-    timer_id++;
-    if (timer_id == 0) {
-        timer_id = 1;
+    native_timer_t *p_timer;
+    uint32_t        curr_timerid = 0;
+
+    EnterCriticalSection();
+    if (native_timer_init() && ((p_timer = native_timer_alloc()) != NULL))
+    {
+        p_timer->type = type;
+        wiced_timer_wheel_add(&native_timer_wheel, &p_timer->node, native_timer_now_ms() + timeout);
+        native_timer_rearm();
+        curr_timerid = p_timer->id;
     }
+    LeaveCriticalSection();
+    Log("start_timer timer_id:%x\n",curr_timerid);
     return curr_timerid;
 }
 
 uint32_t restart_timer(uint32_t timeout, uint32_t timerId ) {
+    native_timer_t *p_timer;
+    uint64_t        now;
+    uint64_t        expire;
+
     Log("restart_timer timer_id:%x timeout:%d\n", timerId, timeout);
-    JNIEnv *env = AttachJava();
-    jstring deviceName;
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
-    jint time = timeout;
-    (*env)->CallStaticVoidMethod(env, cls2, startTimercb, timerId, time);
+    EnterCriticalSection();
+    if ((p_timer = native_timer_find(timerId)) != NULL)
+    {
+        now = native_timer_now_ms();
+
+        // a periodic timer that just expired continues from its expiration time so that it does not drift
+        if (p_timer->node.p_next != NULL)
+        {
+            wiced_timer_wheel_remove(&native_timer_wheel, &p_timer->node);
+            expire = now + timeout;
+        }
+        else
+        {
+            expire = p_timer->node.expire + timeout;
+            if (expire <= now)
+                expire = now + timeout;
+        }
+        wiced_timer_wheel_add(&native_timer_wheel, &p_timer->node, expire);
+        native_timer_rearm();
+    }
+    LeaveCriticalSection();
+    return timerId;
 }
 void stop_timer(uint32_t timerId){
+    native_timer_t *p_timer;
+
     Log("stop_timer timer_id:%x\n",timerId);
-    JNIEnv *env = AttachJava();
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
-    jint time_id = timerId;
-    (*env)->CallStaticVoidMethod(env, cls2, stopTimercb, time_id);
+    EnterCriticalSection();
+    if ((p_timer = native_timer_find(timerId)) != NULL)
+        native_timer_release(p_timer);
+    LeaveCriticalSection();
 }
 
 JNIEXPORT jint JNICALL
@@ -2507,12 +2696,6 @@ JNI_OnLoad(JavaVM *vm, void *reserved)
     meshClientComponentInfoCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientComponentInfoCallback", "(BLjava/lang/String;Ljava/lang/String;)V");
     if(meshClientComponentInfoCb == NULL) Log("meshClientComponentInfoCallback is null");
 
-    startTimercb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "startTimercb", "(II)V");
-    if(startTimercb == NULL) Log("startTimercb is null");
-
-    stopTimercb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "stopTimercb", "(I)V");
-    if(stopTimercb == NULL) Log("stopTimercb is null");
-
     sensorStatuscb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientSensorStatusCb", "(Ljava/lang/String;I[B)V");
     if(sensorStatuscb == NULL) Log("sensorStatuscb is null");
 
@@ -240,6 +240,9 @@ unsigned char aes_set_key(const unsigned char key[],
 unsigned char aes_encrypt(const unsigned char in[N_BLOCK],
     unsigned char out[N_BLOCK],
     const aes_context ctx[1]);
+void aes_cmac_cache_invalidate(void);
+void aes_cmac_cache_get_counters(unsigned int *p_hits, unsigned int *p_misses);
+void hmac_sha256_cache_invalidate(void);
 
 // AES encryption function
 void mesh_app_aes_encrypt(uint8_t* in_data, uint8_t* out_data, uint8_t* key)
@@ -249,9 +252,28 @@ void mesh_app_aes_encrypt(uint8_t* in_data, uint8_t* out_data, uint8_t* key)
     aes_encrypt(in_data, out_data, aes);
 }
 
+// key pair pool implemented in the ecdh_pool.c module of the mesh_libs
+void ecdh_pool_start(uint32_t size);
+void ecdh_pool_stop(void);
+void ecdh_pool_arm(void);
+wiced_bool_t ecdh_pool_take_priv_key(uint32_t *priv_key, uint32_t length);
+
+// Number of provisioning key pairs kept ready in the background, 0 disables the pool
+#ifndef MESH_APP_ECDH_POOL_SIZE
+#define MESH_APP_ECDH_POOL_SIZE     2
+#endif
+
+// The private key of the first provisioning key generation after the pool is armed
+// comes from the key pair pool when it has one ready, see ecdh_pool_take_priv_key
+void mesh_app_rand_gen_num_array(uint32_t* randNumberArrayPtr, uint32_t length)
+{
+    if (!ecdh_pool_take_priv_key(randNumberArrayPtr, length))
+        wiced_hal_rand_gen_num_array(randNumberArrayPtr, length);
+}
+
 wiced_bt_mesh_core_hal_api_t mesh_app_hal_api =
 {
-    .rand_gen_num_array = wiced_hal_rand_gen_num_array,
+    .rand_gen_num_array = mesh_app_rand_gen_num_array,
     .get_pseudo_rand_number = wiced_hal_get_pseudo_rand_number,
     .rand_gen_num = wiced_hal_rand_gen_num,
     .wdog_reset_system = wiced_hal_wdog_reset_system,
@@ -296,12 +318,15 @@ void mesh_application_init(void)
         wiced_bt_mesh_core_init(&init);
         wiced_bt_mesh_remote_provisioning_server_init();
         wiced_bt_mesh_core_start();
+
+        ecdh_pool_start(MESH_APP_ECDH_POOL_SIZE);
     }
     mesh_app_init(WICED_TRUE);
 }
 void mesh_application_deinit(void)
 {
     mesh_app_init(WICED_FALSE);
+    ecdh_pool_stop();
     core_initialized = 0;
 }
 
@@ -396,6 +421,13 @@ void mesh_app_init(wiced_bool_t is_provisioned)
 void mesh_provision_message_handler(uint16_t event, wiced_bt_mesh_event_t *p_event, void *p_data)
 {
     WICED_BT_TRACE("provision message:%d\n", event);
+    // the provisioning HMAC keys are not used after the session, the next session
+    // starts with a key generation
+    if (event == WICED_BT_MESH_PROVISION_END)
+    {
+        hmac_sha256_cache_invalidate();
+        ecdh_pool_arm();
+    }
     mesh_provision_process_event(event, p_event, p_data);
 }
 
@@ -589,10 +621,22 @@ wiced_bool_t wiced_ota_fw_upgrade_set_transfer_mode(wiced_bool_t transfer_only,
 
 void mesh_core_state_changed(wiced_bt_mesh_core_state_type_t type, wiced_bt_mesh_core_state_t *p_state)
 {
+    unsigned int hits, misses;
+
     if (type == WICED_BT_MESH_CORE_STATE_TYPE_SEQ)
         mesh_provision_process_event(WICED_BT_MESH_SEQ_CHANGED, NULL, &p_state->seq);
     else if(type == WICED_BT_MESH_CORE_STATE_IV)
         mesh_provision_process_event(WICED_BT_MESH_IV_CHANGED, NULL, &p_state->iv);
+    else if ((type == WICED_BT_MESH_CORE_STATE_NET_KEY_UPDATE) || (type == WICED_BT_MESH_CORE_STATE_NET_KEY_DELETE) ||
+             (type == WICED_BT_MESH_CORE_STATE_APP_KEY_UPDATE) || (type == WICED_BT_MESH_CORE_STATE_APP_KEY_DELETE) ||
+             (type == WICED_BT_MESH_CORE_STATE_KR) || (type == WICED_BT_MESH_CORE_STATE_NODE_STATE))
+    {
+        // keys derived from the old keys are not used anymore
+        aes_cmac_cache_get_counters(&hits, &misses);
+        WICED_BT_TRACE("cmac cache invalidated state:%d hits:%u misses:%u\n", type, hits, misses);
+        aes_cmac_cache_invalidate();
+        hmac_sha256_cache_invalidate();
+    }
 }
 
 wiced_bool_t vendor_data_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len)
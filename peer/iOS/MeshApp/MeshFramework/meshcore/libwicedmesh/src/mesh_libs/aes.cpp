@@ -66,6 +66,30 @@
 
 #include "aes.h"
 
+/*  The hardware version needs compiler support for the AES instructions,
+    they are enabled for its functions only and used when the CPU has them.
+*/
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#  define AES_HW_X86
+#  define AES_HW_TARGET __attribute__((target("aes,sse2")))
+#  include <cpuid.h>
+#  include <wmmintrin.h>
+#elif defined( __aarch64__ ) && ( defined( __ARM_FEATURE_CRYPTO ) || defined( __ARM_FEATURE_AES ) )
+#  define AES_HW_ARMV8
+#  define AES_HW_TARGET
+#  include <arm_neon.h>
+#elif defined( __aarch64__ ) && defined( __clang__ ) && ( __clang_major__ >= 13 )
+#  define AES_HW_ARMV8
+#  define AES_HW_TARGET __attribute__((target("aes")))
+#  include <arm_neon.h>
+#endif
+#if defined( AES_HW_ARMV8 ) && !defined( __APPLE__ )
+#  include <sys/auxv.h>
+#  ifndef HWCAP_AES
+#    define HWCAP_AES   (1 << 3)
+#  endif
+#endif
+
 #if defined( HAVE_UINT_32T )
 /* for iOS platform, int always takes 4 bytes. */
 #  if defined(__APPLE__) || defined(__ANDROID__)
@@ -563,32 +587,204 @@ return_type aes_set_key( const unsigned char key[], length_type keylen, aes_cont
 
 #if defined( AES_ENC_PREKEYED )
 
-/*  Encrypt a single block of 16 bytes */
+/*  Encrypt a single block of 16 bytes with 8-bit operations */
 
-return_type aes_encrypt( const unsigned char in[N_BLOCK], unsigned char  out[N_BLOCK], const aes_context ctx[1] )
+static void aes_encrypt_byte( const unsigned char in[N_BLOCK], unsigned char  out[N_BLOCK], const aes_context ctx[1] )
 {
-    if( ctx->rnd )
-    {
-        uint_8t s1[N_BLOCK], r;
-        copy_and_key( s1, in, ctx->ksch );
+    uint_8t s1[N_BLOCK], r;
+    copy_and_key( s1, in, ctx->ksch );
 
-        for( r = 1 ; r < ctx->rnd ; ++r )
+    for( r = 1 ; r < ctx->rnd ; ++r )
 #if defined( VERSION_1 )
-        {
-            mix_sub_columns( s1 );
-            add_round_key( s1, ctx->ksch + r * N_BLOCK);
-        }
+    {
+        mix_sub_columns( s1 );
+        add_round_key( s1, ctx->ksch + r * N_BLOCK);
+    }
 #else
-        {   uint_8t s2[N_BLOCK];
-            mix_sub_columns( s2, s1 );
-            copy_and_key( s1, s2, ctx->ksch + r * N_BLOCK);
-        }
+    {   uint_8t s2[N_BLOCK];
+        mix_sub_columns( s2, s1 );
+        copy_and_key( s1, s2, ctx->ksch + r * N_BLOCK);
+    }
 #endif
-        shift_sub_rows( s1 );
-        copy_and_key( out, s1, ctx->ksch + r * N_BLOCK );
+    shift_sub_rows( s1 );
+    copy_and_key( out, s1, ctx->ksch + r * N_BLOCK );
+}
+
+/*  The T-tables combine the byte substitution, the row shift and the
+    column mix of one round, a round is then sixteen lookups on 32-bit
+    columns.  The columns are kept in big endian order so that the tables
+    do not depend on the byte order of the CPU.
+*/
+
+#if defined( USE_TABLES )
+
+#define t_0(p)  (((uint_32t)f2(p) << 24) | ((uint_32t)(p) << 16) | ((uint_32t)(p) << 8) | (uint_32t)f3(p))
+#define t_1(p)  (((uint_32t)f3(p) << 24) | ((uint_32t)f2(p) << 16) | ((uint_32t)(p) << 8) | (uint_32t)(p))
+#define t_2(p)  (((uint_32t)(p) << 24) | ((uint_32t)f3(p) << 16) | ((uint_32t)f2(p) << 8) | (uint_32t)(p))
+#define t_3(p)  (((uint_32t)(p) << 24) | ((uint_32t)(p) << 16) | ((uint_32t)f3(p) << 8) | (uint_32t)f2(p))
+
+static const uint_32t t_fn[4][256] = { sb_data(t_0), sb_data(t_1), sb_data(t_2), sb_data(t_3) };
+
+#define load_col(p)     (((uint_32t)(p)[0] << 24) | ((uint_32t)(p)[1] << 16) | ((uint_32t)(p)[2] << 8) | (uint_32t)(p)[3])
+#define store_col(p, v) ((p)[0] = (uint_8t)((v) >> 24), (p)[1] = (uint_8t)((v) >> 16), \
+                         (p)[2] = (uint_8t)((v) >> 8), (p)[3] = (uint_8t)(v))
+
+#define fwd_rnd(s0, s1, s2, s3, k) \
+    (t_fn[0][(s0) >> 24] ^ t_fn[1][((s1) >> 16) & 0xff] ^ t_fn[2][((s2) >> 8) & 0xff] ^ t_fn[3][(s3) & 0xff] ^ load_col(k))
+
+#define fwd_lrnd(s0, s1, s2, s3, k) \
+    ((((uint_32t)sbox[(s0) >> 24]) << 24) ^ (((uint_32t)sbox[((s1) >> 16) & 0xff]) << 16) ^ \
+     (((uint_32t)sbox[((s2) >> 8) & 0xff]) << 8) ^ (uint_32t)sbox[(s3) & 0xff] ^ load_col(k))
+
+/*  Encrypt a single block of 16 bytes with 32-bit table lookups */
+
+static void aes_encrypt_table( const unsigned char in[N_BLOCK], unsigned char  out[N_BLOCK], const aes_context ctx[1] )
+{
+    const uint_8t *k = ctx->ksch;
+    uint_32t s0, s1, s2, s3, t0, t1, t2, t3;
+    uint_8t r;
+
+    s0 = load_col(in +  0) ^ load_col(k +  0);
+    s1 = load_col(in +  4) ^ load_col(k +  4);
+    s2 = load_col(in +  8) ^ load_col(k +  8);
+    s3 = load_col(in + 12) ^ load_col(k + 12);
+
+    for( r = 1 ; r < ctx->rnd ; ++r )
+    {
+        k += N_BLOCK;
+        t0 = fwd_rnd(s0, s1, s2, s3, k +  0);
+        t1 = fwd_rnd(s1, s2, s3, s0, k +  4);
+        t2 = fwd_rnd(s2, s3, s0, s1, k +  8);
+        t3 = fwd_rnd(s3, s0, s1, s2, k + 12);
+        s0 = t0; s1 = t1; s2 = t2; s3 = t3;
     }
-    else
+
+    k += N_BLOCK;
+    t0 = fwd_lrnd(s0, s1, s2, s3, k +  0);
+    t1 = fwd_lrnd(s1, s2, s3, s0, k +  4);
+    t2 = fwd_lrnd(s2, s3, s0, s1, k +  8);
+    t3 = fwd_lrnd(s3, s0, s1, s2, k + 12);
+    store_col(out +  0, t0);
+    store_col(out +  4, t1);
+    store_col(out +  8, t2);
+    store_col(out + 12, t3);
+}
+
+#else
+#  define aes_encrypt_table aes_encrypt_byte
+#endif
+
+/*  The hardware versions use the key schedule as it is, both AES-NI and
+    the ARMv8 instructions take the round keys in the byte order of the
+    specification.
+*/
+
+#if defined( AES_HW_X86 )
+
+AES_HW_TARGET static void aes_encrypt_hw( const unsigned char in[N_BLOCK], unsigned char  out[N_BLOCK], const aes_context ctx[1] )
+{
+    __m128i s = _mm_loadu_si128((const __m128i *)in);
+    uint_8t r;
+
+    s = _mm_xor_si128(s, _mm_loadu_si128((const __m128i *)ctx->ksch));
+    for( r = 1 ; r < ctx->rnd ; ++r )
+        s = _mm_aesenc_si128(s, _mm_loadu_si128((const __m128i *)(ctx->ksch + r * N_BLOCK)));
+    s = _mm_aesenclast_si128(s, _mm_loadu_si128((const __m128i *)(ctx->ksch + r * N_BLOCK)));
+    _mm_storeu_si128((__m128i *)out, s);
+}
+
+static int aes_hw_available( void )
+{
+    unsigned int eax, ebx, ecx, edx;
+
+    if( !__get_cpuid(1, &eax, &ebx, &ecx, &edx) )
+        return 0;
+    return (ecx & bit_AES) != 0;
+}
+
+#elif defined( AES_HW_ARMV8 )
+
+/*  AESE does the key addition before the substitution, the last round key
+    is added separately.
+*/
+
+AES_HW_TARGET static void aes_encrypt_hw( const unsigned char in[N_BLOCK], unsigned char  out[N_BLOCK], const aes_context ctx[1] )
+{
+    uint8x16_t s = vld1q_u8(in);
+    uint_8t r;
+
+    for( r = 0 ; r < ctx->rnd - 1 ; ++r )
+        s = vaesmcq_u8(vaeseq_u8(s, vld1q_u8(ctx->ksch + r * N_BLOCK)));
+    s = vaeseq_u8(s, vld1q_u8(ctx->ksch + r * N_BLOCK));
+    s = veorq_u8(s, vld1q_u8(ctx->ksch + (r + 1) * N_BLOCK));
+    vst1q_u8(out, s);
+}
+
+static int aes_hw_available( void )
+{
+#if defined( __APPLE__ )
+    return 1;
+#else
+    return (getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+#endif
+}
+
+#else
+
+#  define aes_encrypt_hw aes_encrypt_table
+
+static int aes_hw_available( void )
+{
+    return 0;
+}
+
+#endif
+
+typedef void (*aes_encrypt_fn)( const unsigned char in[N_BLOCK], unsigned char out[N_BLOCK], const aes_context ctx[1] );
+
+/*  Written once on the first use, all threads pick the same version */
+
+static aes_encrypt_fn aes_encrypt_block = 0;
+static int aes_impl = -1;
+
+return_type aes_select_impl( int impl )
+{
+    switch( impl )
+    {
+    case AES_IMPL_BYTE:
+        aes_encrypt_block = aes_encrypt_byte;
+        break;
+    case AES_IMPL_TABLE:
+        aes_encrypt_block = aes_encrypt_table;
+        break;
+    case AES_IMPL_HW:
+        if( !aes_hw_available() )
+            return (return_type)-1;
+        aes_encrypt_block = aes_encrypt_hw;
+        break;
+    default:
+        return (return_type)-1;
+    }
+    aes_impl = impl;
+    return 0;
+}
+
+int aes_get_impl( void )
+{
+    if( aes_impl < 0 && aes_select_impl( AES_IMPL_HW ) != 0 )
+        aes_select_impl( AES_IMPL_TABLE );
+    return aes_impl;
+}
+
+/*  Encrypt a single block of 16 bytes */
+
+return_type aes_encrypt( const unsigned char in[N_BLOCK], unsigned char  out[N_BLOCK], const aes_context ctx[1] )
+{
+    if( !ctx->rnd )
         return (return_type)-1;
+    if( !aes_encrypt_block )
+        aes_get_impl();
+    aes_encrypt_block( in, out, ctx );
     return 0;
 }
 
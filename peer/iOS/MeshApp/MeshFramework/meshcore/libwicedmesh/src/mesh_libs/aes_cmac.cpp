@@ -40,6 +40,8 @@
 
 // #define AES_CMAC_UNIT_TEST
 
+#include <string.h>
+#include <pthread.h>
 #include "aes_cmac.h"
 #include "aes.h"
 
@@ -73,50 +75,14 @@ typedef unsigned  char UINT8;
 
   /* Basic Functions */
 
-#if 0
-void AES_128(unsigned char *key, unsigned char *text, unsigned char *outText  )
+// The key is expanded once per MAC, aes_encrypt picks the fastest AES
+// implementation of the CPU.
+static void AES_128(const aes_context ctx[1], unsigned char *text, unsigned char *outText  )
 {
-    aes_encrypt_128( text, outText, key,key);
+    aes_encrypt( text, outText, ctx );
 }
-#else
-static void AES_128(unsigned char *key, unsigned char *text, unsigned char *outText  )
-{
-    UINT8 k[16];
-    UINT8 t[16];
-    int i;
-
-    for(i=0; i< 16;i++)
-    {
-#if 0
-        // fill the key and text backward. The aes encrypt uses big endian.
-        t[15-i] = text[i];
-        k[15-i] = key[i];
-#else
-        t[i] = text[i];
-        k[i] = key[i];
-#endif
-    }
-
-
-    // software AES. This function is big endian.
-    aes_encrypt_128( t, outText, k,k);
-
-#if 0
-    // swap the output also.
-    for(i=0; i< 16/2;i++)
-    {
-        int tmp = outText[i];
-        // fill the key and text backward. The aes encrypt uses big endian.
-        outText[i] = outText[15-i];
-        outText[15-i] = tmp;
-    }
-#endif
-}
-#endif
-
-
 
-static  void xor_128(unsigned char *a, unsigned char *b, unsigned char *out)
+static  void xor_128(const unsigned char *a, const unsigned char *b, unsigned char *out)
 {
     int i;
     for (i=0;i<16; i++)
@@ -126,19 +92,6 @@ static  void xor_128(unsigned char *a, unsigned char *b, unsigned char *out)
 }
 
 #ifdef AES_CMAC_UNIT_TEST
-static  void print_hex(char *str, unsigned char *buf, int len)
-{
-    int     i;
-
-    for ( i=0; i<len; i++ ) {
-        if ( (i % 16) == 0 && i != 0 ) printf(str);
-        printf("%02x", buf[i]);
-        if ( (i % 4) == 3 ) printf(" ");
-        if ( (i % 16) == 15 ) printf("\n");
-    }
-    if ( (i % 16) != 0 ) printf("\n");
-}
-
 static void print128(unsigned char *bytes)
 {
     int         j;
@@ -147,15 +100,6 @@ static void print128(unsigned char *bytes)
         if ( (j%4) == 3 ) printf(" ");
     }
 }
-
-static  void print96(unsigned char *bytes)
-{
-    int         j;
-    for (j=0; j<12;j++) {
-        printf("%02x",bytes[j]);
-        if ( (j%4) == 3 ) printf(" ");
-    }
-}
 #endif
 
   /* AES-CMAC Generation Function */
@@ -173,7 +117,7 @@ static  void leftshift_onebit(unsigned char *input,unsigned char *output)
     return;
 }
 
-static void generate_subkey(unsigned char *key, unsigned char *K1,
+static void generate_subkey(const aes_context ctx[1], unsigned char *K1,
         unsigned char *K2)
 {
     unsigned char L[16];
@@ -183,7 +127,7 @@ static void generate_subkey(unsigned char *key, unsigned char *K1,
 
     for ( i=0; i<16; i++ ) Z[i] = 0;
 
-    AES_128(key,Z,L);
+    AES_128(ctx,Z,L);
 
     if ( (L[0] & 0x80) == 0 ) { /* If MSB(L) = 0, then K1 = L << 1 */
         leftshift_onebit(L,K1);
@@ -203,7 +147,7 @@ static void generate_subkey(unsigned char *key, unsigned char *K1,
     return;
 }
 
-static void padding ( unsigned char *lastb, unsigned char *pad, int length )
+static void padding ( const unsigned char *lastb, unsigned char *pad, int length )
 {
     int j;
 
@@ -219,52 +163,312 @@ static void padding ( unsigned char *lastb, unsigned char *pad, int length )
     }
 }
 
-void AES_CMAC ( unsigned char *key, unsigned char *input, int length,
-                                                          unsigned char *mac )
+void aes_cmac_init( cmac_ctx *ctx, const unsigned char *key )
 {
-    unsigned char       X[16],Y[16], M_last[16], padded[16];
-    unsigned char       K1[16], K2[16];
-    int         n, i, flag;
-    generate_subkey(key,K1,K2);
-
-    n = (length+15) / 16;       /* n is number of rounds */
+    aes_set_key(key, 16, ctx->aes);
+    generate_subkey(ctx->aes, ctx->K1, ctx->K2);
+    memset(ctx->X, 0, sizeof(ctx->X));
+    ctx->M_len = 0;
+}
 
-    if ( n == 0 ) {
-        n = 1;
-        flag = 0;
-    } else {
-        if ( (length%16) == 0 ) { /* last block is a complete block */
-            flag = 1;
-        } else { /* last block is not complete block */
-            flag = 0;
+void aes_cmac_update( cmac_ctx *ctx, const unsigned char *input, int length )
+{
+    unsigned char       Y[16];
+    int         n;
+
+    // the last block of the message is kept for aes_cmac_final, a block is
+    // processed only when more data follows it
+    while ( length > 0 ) {
+        if ( ctx->M_len == 16 ) {
+            xor_128(ctx->X,ctx->M,Y);       /* Y := Mi (+) X  */
+            AES_128(ctx->aes,Y,ctx->X);     /* X := AES-128(KEY, Y); */
+            ctx->M_len = 0;
+        }
+        if ( ctx->M_len == 0 ) {
+            while ( length > 16 ) {
+                xor_128(ctx->X,input,Y);
+                AES_128(ctx->aes,Y,ctx->X);
+                input += 16;
+                length -= 16;
+            }
         }
+        n = 16 - ctx->M_len;
+        if ( n > length )
+            n = length;
+        memcpy(&ctx->M[ctx->M_len], input, n);
+        ctx->M_len += n;
+        input += n;
+        length -= n;
     }
+}
+
+void aes_cmac_final( cmac_ctx *ctx, unsigned char *mac )
+{
+    unsigned char       Y[16], M_last[16], padded[16];
 
-    if ( flag ) { /* last block is complete block */
-        xor_128(&input[16*(n-1)],K1,M_last);
+    if ( ctx->M_len == 16 ) { /* last block is complete block */
+        xor_128(ctx->M,ctx->K1,M_last);
     } else {
-        padding(&input[16*(n-1)],padded,length%16);
-        xor_128(padded,K2,M_last);
+        padding(ctx->M,padded,ctx->M_len);
+        xor_128(padded,ctx->K2,M_last);
     }
 
-    for ( i=0; i<16; i++ ) X[i] = 0;
-    for ( i=0; i<n-1; i++ ) {
-        xor_128(X,&input[16*i],Y); /* Y := Mi (+) X  */
-        AES_128(key,Y,X);      /* X := AES-128(KEY, Y); */
+    xor_128(ctx->X,M_last,Y);
+    AES_128(ctx->aes,Y,mac);
+
+    memset(ctx->X, 0, sizeof(ctx->X));
+    ctx->M_len = 0;
+}
+
+// Only the mesh key derivations are cached. Their first MAC is keyed with
+// a fixed salt s1("smk2") ... s1("vtad") over a network, application or
+// label key, the following ones are keyed with the result T of that MAC.
+// Provisioning keys come from per session salts and are never kept, that
+// includes the ConfirmationKey, the ECDH secret and the AuthValue.
+static const char *cmac_salt_tags[] = { "smk2", "smk3", "smk4", "nkik", "nkbk", "nkpk", "vtad" };
+#define CMAC_SALT_NUM       (sizeof(cmac_salt_tags) / sizeof(cmac_salt_tags[0]))
+#define CMAC_DERIVED_SIZE   64  // T keys of the derivations, a power of 2
+
+typedef struct
+{
+    unsigned char   key[16];
+    unsigned char   input[AES_CMAC_CACHE_MAX_INPUT];
+    unsigned char   mac[16];
+    int             length;         // -1 if the entry is empty
+} cmac_cache_entry_t;
+
+static cmac_cache_entry_t   cmac_cache[AES_CMAC_CACHE_SIZE];
+static unsigned char        cmac_salts[CMAC_SALT_NUM][16];
+static unsigned char        cmac_derived[CMAC_DERIVED_SIZE][16];
+static unsigned char        cmac_derived_valid[CMAC_DERIVED_SIZE];
+static int                  cmac_cache_ready;
+static unsigned int         cmac_cache_generation;
+static unsigned int         cmac_cache_hits;
+static unsigned int         cmac_cache_misses;
+static pthread_mutex_t      cmac_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Derivations call CMAC several times with one key, k2 for example uses the
+// key T for three MACs in a row. The context of the last derivation key is
+// shared by all threads so that an invalidate can wipe it.
+static cmac_ctx             cmac_last_ctx;
+static unsigned char        cmac_last_key[16];
+static int                  cmac_last_valid;
+
+// The barrier keeps the compiler from dropping the memset of a buffer
+// that is not read again
+static void cmac_wipe( void *p, size_t len )
+{
+    memset(p, 0, len);
+    __asm__ __volatile__("" : : "r"(p) : "memory");
+}
+
+static unsigned int cmac_fnv( unsigned int h, const unsigned char *data, int length )
+{
+    int i;
+
+    for ( i = 0; i < length; i++ )
+        h = (h ^ data[i]) * 16777619u;
+    return h;
+}
+
+// FNV-1a of the key and the message selects the entry, an entry is
+// replaced by the next message that maps to it
+static unsigned int cmac_cache_index( const unsigned char *key, const unsigned char *input, int length )
+{
+    unsigned int h = cmac_fnv(cmac_fnv(2166136261u, key, 16), input, length);
+
+    h ^= (unsigned int)length;
+    return (h ^ (h >> 16)) & (AES_CMAC_CACHE_SIZE - 1);
+}
+
+static unsigned int cmac_derived_index( const unsigned char *key )
+{
+    unsigned int h = cmac_fnv(2166136261u, key, 16);
+
+    return (h ^ (h >> 16)) & (CMAC_DERIVED_SIZE - 1);
+}
+
+static int cmac_is_salt( const unsigned char *key )
+{
+    unsigned int i;
+
+    for ( i = 0; i < CMAC_SALT_NUM; i++ )
+        if ( memcmp(cmac_salts[i], key, 16) == 0 )
+            return 1;
+    return 0;
+}
+
+static int cmac_salt_of_tag( const unsigned char *key, const unsigned char *input, unsigned char *mac )
+{
+    static const unsigned char zero[16] = { 0 };
+    unsigned int i;
+
+    if ( memcmp(key, zero, 16) != 0 )
+        return 0;
+    for ( i = 0; i < CMAC_SALT_NUM; i++ ) {
+        if ( memcmp(cmac_salt_tags[i], input, 4) == 0 ) {
+            memcpy(mac, cmac_salts[i], 16);
+            return 1;
+        }
     }
+    return 0;
+}
+
+// Called with the mutex held, the salts are computed on the first use
+static int cmac_is_derived( const unsigned char *key )
+{
+    unsigned int i = cmac_derived_index(key);
 
-    xor_128(X,M_last,Y);
-    AES_128(key,Y,X);
+    return cmac_derived_valid[i] && memcmp(cmac_derived[i], key, 16) == 0;
+}
 
-    for ( i=0; i<16; i++ ) {
-        mac[i] = X[i];
+static void cmac_cache_reset( void )
+{
+    static const unsigned char zero[16] = { 0 };
+    cmac_ctx    ctx;
+    unsigned int i;
+
+    cmac_wipe(cmac_cache, sizeof(cmac_cache));
+    for ( i = 0; i < AES_CMAC_CACHE_SIZE; i++ )
+        cmac_cache[i].length = -1;
+    cmac_wipe(cmac_derived, sizeof(cmac_derived));
+    cmac_wipe(cmac_derived_valid, sizeof(cmac_derived_valid));
+    cmac_wipe(&cmac_last_ctx, sizeof(cmac_last_ctx));
+    cmac_wipe(cmac_last_key, sizeof(cmac_last_key));
+    cmac_last_valid = 0;
+    cmac_cache_generation++;
+
+    if ( !cmac_cache_ready ) {
+        aes_cmac_init(&ctx, zero);
+        for ( i = 0; i < CMAC_SALT_NUM; i++ ) {
+            aes_cmac_update(&ctx, (const unsigned char *)cmac_salt_tags[i], (int)strlen(cmac_salt_tags[i]));
+            aes_cmac_final(&ctx, cmac_salts[i]);
+        }
+        cmac_cache_ready = 1;
     }
 }
 
+void aes_cmac_cache_invalidate( void )
+{
+    pthread_mutex_lock(&cmac_cache_mutex);
+    cmac_cache_reset();
+    pthread_mutex_unlock(&cmac_cache_mutex);
+}
+
+void aes_cmac_cache_get_counters( unsigned int *p_hits, unsigned int *p_misses )
+{
+    pthread_mutex_lock(&cmac_cache_mutex);
+    *p_hits = cmac_cache_hits;
+    *p_misses = cmac_cache_misses;
+    pthread_mutex_unlock(&cmac_cache_mutex);
+}
+
+// A MAC keyed with a salt gives the key T of the next steps of the derivation
+static void cmac_cache_add_derived( const unsigned char *mac )
+{
+    unsigned int i = cmac_derived_index(mac);
+
+    memcpy(cmac_derived[i], mac, 16);
+    cmac_derived_valid[i] = 1;
+}
+
+void AES_CMAC ( unsigned char *key, unsigned char *input, int length,
+                                                          unsigned char *mac )
+{
+    cmac_cache_entry_t *p_entry = NULL;
+    cmac_ctx            ctx;
+    unsigned int        generation;
+    int                 salt, allowed, keyed = 0;
+
+    pthread_mutex_lock(&cmac_cache_mutex);
+    if ( !cmac_cache_ready )
+        cmac_cache_reset();
+    // s1 of a salt tag, the key is all zeros
+    if ( length == 4 && cmac_salt_of_tag(key, input, mac) ) {
+        pthread_mutex_unlock(&cmac_cache_mutex);
+        return;
+    }
+    salt = cmac_is_salt(key);
+    allowed = salt || cmac_is_derived(key);
+    if ( allowed && length <= AES_CMAC_CACHE_MAX_INPUT ) {
+        p_entry = &cmac_cache[cmac_cache_index(key, input, length)];
+        if ( p_entry->length == length && memcmp(p_entry->key, key, 16) == 0 && memcmp(p_entry->input, input, length) == 0 ) {
+            memcpy(mac, p_entry->mac, 16);
+            if ( salt )
+                cmac_cache_add_derived(mac);
+            cmac_cache_hits++;
+            pthread_mutex_unlock(&cmac_cache_mutex);
+            return;
+        }
+        cmac_cache_misses++;
+    }
+    // the MAC is computed on a copy of the key context without the mutex
+    if ( allowed && cmac_last_valid && memcmp(cmac_last_key, key, 16) == 0 ) {
+        ctx = cmac_last_ctx;
+        keyed = 1;
+    }
+    generation = cmac_cache_generation;
+    pthread_mutex_unlock(&cmac_cache_mutex);
+
+    if ( !keyed )
+        aes_cmac_init(&ctx, key);
+    aes_cmac_update(&ctx, input, length);
+    aes_cmac_final(&ctx, mac);
+
+    if ( allowed ) {
+        // an invalidate while the MAC was computed drops the results
+        pthread_mutex_lock(&cmac_cache_mutex);
+        if ( generation == cmac_cache_generation ) {
+            if ( p_entry ) {
+                memcpy(p_entry->key, key, 16);
+                memcpy(p_entry->input, input, length);
+                memcpy(p_entry->mac, mac, 16);
+                p_entry->length = length;
+            }
+            if ( salt )
+                cmac_cache_add_derived(mac);
+            if ( !keyed ) {
+                cmac_last_ctx = ctx;
+                memcpy(cmac_last_key, key, 16);
+                cmac_last_valid = 1;
+            }
+        }
+        pthread_mutex_unlock(&cmac_cache_mutex);
+    }
+    cmac_wipe(&ctx, sizeof(ctx));
+}
+
 #ifdef AES_CMAC_UNIT_TEST
+static int check128(const char *name, unsigned char *bytes, const unsigned char *expected)
+{
+    int         j;
+    for (j=0; j<16;j++) {
+        if (bytes[j] != expected[j]) {
+            printf("%s FAILED\n", name);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* k2 with P = 0x00, T1 gives the NID, T2 the EncryptionKey, T3 the PrivacyKey */
+static void k2(unsigned char *N, unsigned char *T1, unsigned char *T2, unsigned char *T3)
+{
+    unsigned char zero[16] = { 0 }, salt[16], T[16], buf[18];
+
+    AES_CMAC(zero, (unsigned char *)"smk2", 4, salt);
+    AES_CMAC(salt, N, 16, T);
+    buf[0] = 0x00; buf[1] = 0x01;
+    AES_CMAC(T, buf, 2, T1);
+    memcpy(buf, T1, 16); buf[16] = 0x00; buf[17] = 0x02;
+    AES_CMAC(T, buf, 18, T2);
+    memcpy(buf, T2, 16); buf[16] = 0x00; buf[17] = 0x03;
+    AES_CMAC(T, buf, 18, T3);
+}
+
 int main()
 {
-    unsigned char L[16], K1[16], K2[16], T[16], TT[12];
+    unsigned char L[16], K1[16], K2[16], T[16], T1[16], T2[16];
     unsigned char M[64] = {
         0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
         0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
@@ -279,41 +483,125 @@ int main()
         0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
         0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
     };
+    /* SP800-38B and RFC 4493 values for the key and messages above */
+    static const unsigned char kat_L[16] = {
+        0x7d, 0xf7, 0x6b, 0x0c, 0x1a, 0xb8, 0x99, 0xb3,
+        0x3e, 0x42, 0xf0, 0x47, 0xb9, 0x1b, 0x54, 0x6f
+    };
+    static const unsigned char kat_K1[16] = {
+        0xfb, 0xee, 0xd6, 0x18, 0x35, 0x71, 0x33, 0x66,
+        0x7c, 0x85, 0xe0, 0x8f, 0x72, 0x36, 0xa8, 0xde
+    };
+    static const unsigned char kat_K2[16] = {
+        0xf7, 0xdd, 0xac, 0x30, 0x6a, 0xe2, 0x66, 0xcc,
+        0xf9, 0x0b, 0xc1, 0x1e, 0xe4, 0x6d, 0x51, 0x3b
+    };
+    static const int kat_len[4] = { 0, 16, 40, 64 };
+    static const unsigned char kat_mac[4][16] = {
+        { 0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28, 0x7f, 0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67, 0x46 },
+        { 0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44, 0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c },
+        { 0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30, 0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8, 0x27 },
+        { 0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92, 0xfc, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3c, 0xfe }
+    };
+    static unsigned char kat_N[16] = {
+        0xf7, 0xa2, 0xa4, 0x4f, 0x8e, 0x8a, 0x80, 0x29,
+        0x06, 0x4f, 0x17, 0x3d, 0xdc, 0x1e, 0x2b, 0x00
+    };
+    static const unsigned char kat_enc[16] = {
+        0x9f, 0x58, 0x91, 0x81, 0xa0, 0xf5, 0x0d, 0xe7,
+        0x3c, 0x80, 0x70, 0xc7, 0xa6, 0xd2, 0x7f, 0x46
+    };
+    static const unsigned char kat_priv[16] = {
+        0x4c, 0x71, 0x5b, 0xd4, 0xa6, 0x4b, 0x93, 0x8f,
+        0x99, 0xb4, 0x53, 0x35, 0x16, 0x53, 0x12, 0x4f
+    };
+    static const char *impl_name[3] = { "byte", "table", "hw" };
+    aes_context ctx[1];
+    cmac_ctx cmac;
+    int impl, i, step, pos, failed = 0;
+    unsigned int hits, misses, hits2, misses2;
 
     printf("--------------------------------------------------\n");
     printf("K              "); print128(key); printf("\n");
+    aes_set_key(key, 16, ctx);
 
-    printf("\nSubkey Generation\n");
-    AES_128(key,const_Zero,L);
-    printf("AES_128(key,0) "); print128(L); printf("\n");
-    generate_subkey(key,K1,K2);
-
-    printf("K1             "); print128(K1); printf("\n");
-    printf("K2             "); print128(K2); printf("\n");
+    for (impl = AES_IMPL_BYTE; impl <= AES_IMPL_HW; impl++) {
+        if (aes_select_impl(impl) != 0) {
+            printf("\n%s: not available\n", impl_name[impl]);
+            continue;
+        }
+        printf("\n%s\n", impl_name[impl]);
+
+        AES_128(ctx,const_Zero,L);
+        printf("AES_128(key,0) "); print128(L); printf("\n");
+        failed |= check128("AES_128(key,0)", L, kat_L);
+        generate_subkey(ctx,K1,K2);
+        printf("K1             "); print128(K1); printf("\n");
+        printf("K2             "); print128(K2); printf("\n");
+        failed |= check128("K1", K1, kat_K1);
+        failed |= check128("K2", K2, kat_K2);
+
+        for (i = 0; i < 4; i++) {
+            AES_CMAC(key,M,kat_len[i],T);
+            printf("AES_CMAC %2d    ", kat_len[i]); print128(T); printf("\n");
+            failed |= check128("AES_CMAC", T, kat_mac[i]);
+        }
 
-    printf("\nExample 1: len = 0\n");
-    printf("M              "); printf("<empty string>\n");
+        /* the same messages fed to one context in pieces of every size */
+        aes_cmac_init(&cmac, key);
+        for (i = 0; i < 4; i++) {
+            for (step = 1; step <= kat_len[i] + 1; step++) {
+                for (pos = 0; pos < kat_len[i]; pos += step)
+                    aes_cmac_update(&cmac, &M[pos], (kat_len[i] - pos < step) ? kat_len[i] - pos : step);
+                aes_cmac_final(&cmac, T);
+                failed |= check128("aes_cmac_update", T, kat_mac[i]);
+            }
+        }
+    }
 
-    AES_CMAC(key,M,0,T);
-    printf("AES_CMAC       "); print128(T); printf("\n");
+    /* k2 of the Mesh Profile sample 8.1.3 is a chain of cacheable MACs */
+    aes_cmac_cache_invalidate();
+    aes_cmac_cache_get_counters(&hits, &misses);
+    k2(kat_N, T, T1, T2);
+    failed |= check128("k2 EncryptionKey", T1, kat_enc);
+    failed |= check128("k2 PrivacyKey", T2, kat_priv);
+    if ((T[15] & 0x7f) != 0x7f) {
+        printf("k2 NID FAILED\n");
+        failed = 1;
+    }
+    k2(kat_N, T, T1, T2);
+    failed |= check128("cached k2 EncryptionKey", T1, kat_enc);
+    aes_cmac_cache_get_counters(&hits2, &misses2);
+    printf("cache hits %u misses %u\n", hits2 - hits, misses2 - misses);
+    if (hits2 - hits != 4 || misses2 - misses != 4) {
+        printf("cache counters FAILED\n");
+        failed = 1;
+    }
 
-    printf("\nExample 2: len = 16\n");
-    printf("M              "); print_hex("                ",M,16);
+    /* a key that is not a derivation key is never kept */
+    AES_CMAC(key,M,16,T);
     AES_CMAC(key,M,16,T);
-    printf("AES_CMAC       "); print128(T); printf("\n");
-    printf("\nExample 3: len = 40\n");
-    printf("M              "); print_hex("               ",M,40);
-    AES_CMAC(key,M,40,T);
-    printf("AES_CMAC       "); print128(T); printf("\n");
+    failed |= check128("uncached AES_CMAC", T, kat_mac[1]);
+    aes_cmac_cache_get_counters(&hits, &misses);
+    if (hits != hits2 || misses != misses2) {
+        printf("AES_CMAC with a session key was cached FAILED\n");
+        failed = 1;
+    }
 
-    printf("\nExample 4: len = 64\n");
-    printf("M              "); print_hex("               ",M,64);
-    AES_CMAC(key,M,64,T);
-    printf("AES_CMAC       "); print128(T); printf("\n");
+    /* an invalidated cache computes the derivation again */
+    aes_cmac_cache_invalidate();
+    k2(kat_N, T, T1, T2);
+    failed |= check128("k2 after invalidate", T1, kat_enc);
+    aes_cmac_cache_get_counters(&hits2, &misses2);
+    if (hits2 != hits || misses2 != misses + 4) {
+        printf("cache counters after invalidate FAILED\n");
+        failed = 1;
+    }
 
     printf("--------------------------------------------------\n");
+    printf("%s\n", failed ? "FAILED" : "PASSED");
 
-    return 0;
+    return failed;
 }
 
 #endif
@@ -39,15 +39,53 @@
 #ifndef _AES_CMAC_H_
 #define _AES_CMAC_H_
 
+#include "aes.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 // This function takes input in Big endian format. Its output is also in
-// big endian format. "length" is in unit of bytes.
+// big endian format. "length" is in unit of bytes. The context of the
+// last key derivation key is kept, a MAC with the same key only encrypts
+// the message blocks.
 void AES_CMAC( unsigned char *key, unsigned char *input, int length,
                   unsigned char *mac );
 
+// CMAC context with the expanded key and the K1/K2 subkeys. The key is set
+// once with aes_cmac_init, then any number of messages are authenticated
+// with aes_cmac_update and aes_cmac_final.
+typedef struct
+{
+    aes_context   aes[1];       // key schedule
+    unsigned char K1[16];       // subkey for a complete last block
+    unsigned char K2[16];       // subkey for a padded last block
+    unsigned char X[16];        // CBC state of the current message
+    unsigned char M[16];        // message bytes not processed yet
+    int           M_len;
+} cmac_ctx;
+
+void aes_cmac_init( cmac_ctx *ctx, const unsigned char *key );
+
+void aes_cmac_update( cmac_ctx *ctx, const unsigned char *input, int length );
+
+// Writes the MAC of the message and starts a new message with the same key
+void aes_cmac_final( cmac_ctx *ctx, unsigned char *mac );
+
+// AES_CMAC keeps the MACs of short messages of the mesh key derivations.
+// k2, k3, k4, the identity and beacon keys and virtual addresses are
+// chains of MACs keyed with a fixed salt and then with its result, they
+// give the same results every time a network is opened or switched to.
+// MACs with any other key, such as the provisioning ConfirmationKey or
+// the k1 salts of the ECDH secret, are never kept. Invalidate the cache
+// when keys are updated or deleted, it wipes all the kept key material.
+#define AES_CMAC_CACHE_SIZE         256 // entries, a power of 2
+#define AES_CMAC_CACHE_MAX_INPUT    32  // longer messages are not cached
+
+void aes_cmac_cache_invalidate( void );
+
+void aes_cmac_cache_get_counters( unsigned int *p_hits, unsigned int *p_misses );
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,75 @@
+/*
+* Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*/
+
+/** @file
+*
+* Pool of P-256 key pairs generated in the background for provisioning
+*/
+
+#ifndef ECDH_POOL_H
+#define ECDH_POOL_H
+
+#include "p_256_ecc_pp.h"
+
+#define ECDH_POOL_MAX_SIZE  8
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Starts a low priority thread keeping size key pairs ready, size 0 leaves the pool off */
+void ecdh_pool_start(uint32_t size);
+void ecdh_pool_stop(void);
+
+/* Fills a request for KEY_LENGTH_DWORDS_P256 random words with the private key of a
+   pooled pair. Only the first such request after ecdh_pool_start or ecdh_pool_arm is
+   served, that is the key generation of the next provisioning. Random numbers of the
+   same size later in the session, such as a 32 byte ProvisioningRandom, do not use up
+   a pair. Returns WICED_FALSE if the pool is off, empty or not armed or the length
+   differs. */
+wiced_bool_t ecdh_pool_take_priv_key(uint32_t *priv_key, uint32_t length);
+
+/* Call when a provisioning ends, the next provisioning starts with a key generation */
+void ecdh_pool_arm(void);
+
+/* Sets q=n*G if n is the private key handed out last. The pair is wiped either way
+   once a new private key is requested. */
+wiced_bool_t ecdh_pool_take_pub_key(Point *q, const DWORD *n);
+
+void ecdh_pool_get_counters(uint32_t *p_hits, uint32_t *p_misses);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ECDH_POOL_H */
@@ -79,6 +79,9 @@ extern EC curve;
 extern EC curve_p256;
 
 void ECC_PM_B_NAF(Point *q, Point *p, DWORD *n, uint32_t keyLength);
+void ECC_PM_B_NAF_Ref(Point *q, Point *p, DWORD *n, uint32_t keyLength);
+void ECC_PM_Comb(Point *q, DWORD *n);
+int mpConvFromOctets(DWORD *a, int ndigits, const unsigned char *c, int nbytes);
 
 #define ECC_PM(q, p, n, keyLength)  ECC_PM_B_NAF(q, p, n, keyLength)
 
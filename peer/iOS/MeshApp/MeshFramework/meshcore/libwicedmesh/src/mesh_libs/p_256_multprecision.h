@@ -49,6 +49,21 @@
 
 #define KEY_LENGTH_DWORDS_P192 6
 #define KEY_LENGTH_DWORDS_P256 8
+
+/* P-256 field elements in Montgomery form, used by the point multiplication.
+   64-bit limbs where the compiler has a 128-bit product, 32-bit otherwise. */
+#if defined(__SIZEOF_INT128__)
+typedef uint64_t            FE_LIMB;
+typedef unsigned __int128   FE_DLIMB;
+#define FE_LIMB_BITS        64
+#else
+typedef uint32_t            FE_LIMB;
+typedef uint64_t            FE_DLIMB;
+#define FE_LIMB_BITS        32
+#endif
+#define FE_LIMBS            (256 / FE_LIMB_BITS)
+
+typedef FE_LIMB FE[FE_LIMBS];
 /* Arithmetic Operations */
 
 
@@ -64,6 +79,7 @@ uint32_t MP_DWORDBits (DWORD a);
 uint32_t MP_MostSignDWORDs(DWORD *a, uint32_t keyLength);
 uint32_t MP_MostSignBits(DWORD *a, uint32_t keyLength);
 void MP_InvMod(DWORD *aminus, DWORD *a, uint32_t keyLength);
+void MP_InvMod_Ref(DWORD *aminus, DWORD *a, uint32_t keyLength);    // binary inversion, destroys a
 
 DWORD MP_Add(DWORD *c, DWORD *a, DWORD *b, uint32_t keyLength);           // c=a+b
 void MP_AddMod(DWORD *c, DWORD *a, DWORD *b, uint32_t keyLength);
@@ -80,6 +96,17 @@ void MP_Mult(DWORD *c, DWORD *a, DWORD *b, uint32_t keyLength);
 void MP_FastMod(DWORD *c, DWORD *a);
 void MP_FastMod_P256(DWORD *c, DWORD *a);
 
+/* Constant time P-256 field arithmetic, all values in [0, p) */
+void FE_FromMP(FE c, const DWORD *a);                   // c=a*R mod p
+void FE_ToMP(DWORD *c, const FE a);                     // c=a/R mod p
+void FE_Mul(FE c, const FE a, const FE b);              // c=a*b/R mod p
+void FE_Sqr(FE c, const FE a);                          // c=a*a/R mod p
+void FE_Add(FE c, const FE a, const FE b);              // c=(a+b) mod p
+void FE_Sub(FE c, const FE a, const FE b);              // c=(a-b) mod p
+void FE_Inv(FE c, const FE a);                          // c=1/a, 0 for a=0
+void FE_Cmov(FE c, const FE a, FE_LIMB mask);           // c=a if mask is all ones
+FE_LIMB FE_IsZero(const FE a);                          // all ones if a=0, 0 otherwise
+
 #ifdef __cplusplus
 }
 #endif
@@ -70,6 +70,22 @@ typedef struct {
 //  PUBLIC FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha256SelectImpl / Sha256GetImpl
+//
+//  The hash runs the fastest transform available on the CPU. The portable version always
+//  exists, the hardware version uses the SHA extensions on x86 or the ARMv8 SHA2
+//  instructions on AArch64 when the CPU has them. Sha256SelectImpl forces one version, it
+//  is meant for tests and returns non zero if the version is not available.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#define SHA256_IMPL_PORTABLE 0  // 32-bit operations in C
+#define SHA256_IMPL_HW 1        // SHA instructions of the CPU
+
+int Sha256SelectImpl(int Impl  // [in]
+);
+
+int Sha256GetImpl(void);
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  Sha256Initialise
 //
@@ -126,6 +142,33 @@ extern "C" {
 
 #include <stddef.h>
 
+// Keyed HMAC state, the states after the inner and outer pad blocks are
+// computed once per key and every message starts from them.
+typedef struct {
+  Sha256Context inner;
+  Sha256Context outer;
+  Sha256Context running;  // inner hash of the current message
+} HmacSha256Context;
+
+// Prepares `ctx` for MACs with the key. It can be used for any number of
+// messages, each one is hmac_sha256_update calls and a hmac_sha256_final.
+void hmac_sha256_init(HmacSha256Context* ctx,
+                      const void* key,
+                      const size_t keylen);
+
+void hmac_sha256_update(HmacSha256Context* ctx,
+                        const void* data,
+                        const size_t datalen);
+
+// Returns the number of bytes written to `out`, like hmac_sha256
+size_t hmac_sha256_final(HmacSha256Context* ctx,
+                         void* out,
+                         const size_t outlen);
+
+// hmac_sha256 keeps the contexts of the last few keys. Call this when the
+// provisioning ends or the keys change, it wipes them.
+void hmac_sha256_cache_invalidate(void);
+
 size_t  // Returns the number of bytes written to `out`
 hmac_sha256(
     // [in]: The key and its length.